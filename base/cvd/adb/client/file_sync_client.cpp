@@ -28,10 +28,12 @@
 #include <unistd.h>
 #include <utime.h>
 
+#include <algorithm>
 #include <chrono>
 #include <deque>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <variant>
@@ -50,6 +52,7 @@
 #include "sysdeps/stat.h"
 
 #include "client/commandline.h"
+#include "client/sync_send_pipeline.h"
 
 #include <android-base/file.h>
 #include <android-base/strings.h>
@@ -732,6 +735,58 @@ class SyncConnection {
         return WriteOrDie(lpath, rpath, &msg.data, sizeof(msg.data));
     }
 
+    // Same as SendLargeFile, except that `file` has been read and compressed ahead of time by
+    // `pipeline`, and only the ready-made packets are written here.
+    bool SendLargeFilePipelined(const std::string& path, mode_t mode, const std::string& lpath,
+                                const std::string& rpath, unsigned mtime, uint64_t total_size,
+                                SyncSendPipeline& pipeline, SyncSendPipeline::File& file,
+                                bool dry_run) {
+        if (dry_run && !HaveSendRecv2DryRunSend()) {
+            Error("dry-run not supported by the device");
+            return false;
+        }
+
+        // Wait for the first chunk so that a file that can't be read fails before anything is
+        // sent for it.
+        std::string error;
+        std::optional<SyncSendPipeline::Chunk> chunk = file.Next(&error);
+        if (!error.empty()) {
+            Error("%s", error.c_str());
+            return false;
+        }
+
+        if (!SendSend2(path, mode, file.compression(), dry_run)) {
+            Error("failed to send ID_SEND_V2 message '%s': %s", path.c_str(), strerror(errno));
+            return false;
+        }
+
+        uint64_t bytes_copied = 0;
+        syncsendbuf sbuf;
+        sbuf.id = ID_DATA;
+        for (; chunk; chunk = file.Next(&error)) {
+            sbuf.size = chunk->data.size();
+            memcpy(sbuf.data, chunk->data.data(), chunk->data.size());
+            auto write_start = std::chrono::steady_clock::now();
+            WriteOrDie(lpath, rpath, &sbuf, sizeof(SyncRequest) + chunk->data.size());
+            pipeline.RecordWrite(sizeof(SyncRequest) + chunk->data.size(),
+                                 std::chrono::steady_clock::now() - write_start);
+
+            RecordBytesTransferred(chunk->input_bytes);
+            bytes_copied += chunk->input_bytes;
+            ReportProgress(rpath, bytes_copied, total_size);
+        }
+        if (!error.empty()) {
+            Error("%s", error.c_str());
+            return false;
+        }
+
+        syncmsg msg;
+        msg.data.id = ID_DONE;
+        msg.data.size = mtime;
+        RecordFileSent(lpath, rpath);
+        return WriteOrDie(lpath, rpath, &msg.data, sizeof(msg.data));
+    }
+
     bool SendLargeFileLegacy(const std::string& path, mode_t mode, const std::string& lpath,
                              const std::string& rpath, unsigned mtime) {
         std::string path_and_mode = android::base::StringPrintf("%s,%d", path.c_str(), mode);
@@ -1046,13 +1101,23 @@ static bool sync_stat_fallback(SyncConnection& sc, const std::string& path, stru
     return true;
 }
 
+// If `pipeline` is set, large files are sent through it. `prepared` is this file if it has already
+// been submitted to `pipeline`, and is abandoned if it is not sent in full.
 static bool sync_send(SyncConnection& sc, const std::string& lpath, const std::string& rpath,
                       unsigned mtime, mode_t mode, bool sync, CompressionType compression,
-                      bool dry_run) {
+                      bool dry_run, SyncSendPipeline* pipeline = nullptr,
+                      std::shared_ptr<SyncSendPipeline::File> prepared = nullptr) {
+    auto abandon_prepared = [pipeline, &prepared]() {
+        if (prepared) {
+            pipeline->Abandon(*prepared);
+        }
+    };
+
     if (sync) {
         struct stat st;
         if (sync_lstat(sc, rpath, &st)) {
             if (st.st_mtime == static_cast<time_t>(mtime)) {
+                abandon_prepared();
                 sc.RecordFilesSkipped(1);
                 return true;
             }
@@ -1079,9 +1144,19 @@ static bool sync_send(SyncConnection& sc, const std::string& lpath, const std::s
     struct stat st;
     if (stat(lpath.c_str(), &st) == -1) {
         sc.Error("failed to stat local file '%s': %s", lpath.c_str(), strerror(errno));
+        abandon_prepared();
         return false;
     }
-    if (st.st_size < SYNC_DATA_MAX) {
+    if (prepared || (pipeline && st.st_size >= SYNC_DATA_MAX)) {
+        if (!prepared) {
+            prepared = pipeline->Submit(lpath);
+        }
+        if (!sc.SendLargeFilePipelined(rpath, mode, lpath, rpath, mtime, st.st_size, *pipeline,
+                                       *prepared, dry_run)) {
+            abandon_prepared();
+            return false;
+        }
+    } else if (st.st_size < SYNC_DATA_MAX) {
         std::string data;
         if (!android::base::ReadFileToString(lpath, &data, true)) {
             sc.Error("failed to read all of '%s': %s", lpath.c_str(), strerror(errno));
@@ -1424,13 +1499,49 @@ static bool copy_local_dir_remote(SyncConnection& sc, std::string lpath, std::st
 
     sc.ComputeExpectedTotalBytes(file_list);
 
+    // Large files are read and compressed a few files ahead of the one being sent.
+    auto is_pipelined = [](const copyinfo& ci) {
+        return !ci.skip && S_ISREG(ci.mode) && ci.size >= SYNC_DATA_MAX;
+    };
+    size_t pipelined_files = 0;
+    uint64_t pipelined_bytes = 0;
+    for (const copyinfo& ci : file_list) {
+        if (is_pipelined(ci)) {
+            pipelined_files++;
+            pipelined_bytes += ci.size;
+        }
+    }
+    std::optional<SyncSendPipeline> pipeline;
+    size_t num_workers = SyncSendPipeline::WorkersFor(pipelined_files, pipelined_bytes);
+    if (!list_only && sc.HaveSendRecv2() && num_workers > 0) {
+        pipeline.emplace(compression, sc.ResolveCompressionType(CompressionType::Any),
+                         num_workers);
+    }
+    std::deque<std::shared_ptr<SyncSendPipeline::File>> prepared;
+    size_t next_to_prepare = 0;
+
     for (const copyinfo& ci : file_list) {
         if (!ci.skip) {
             if (list_only) {
                 sc.Println("would push: %s -> %s", ci.lpath.c_str(), ci.rpath.c_str());
             } else {
+                std::shared_ptr<SyncSendPipeline::File> file;
+                if (pipeline) {
+                    for (; next_to_prepare < file_list.size() &&
+                           prepared.size() < pipeline->FilesInFlight();
+                         ++next_to_prepare) {
+                        const copyinfo& upcoming = file_list[next_to_prepare];
+                        if (is_pipelined(upcoming)) {
+                            prepared.push_back(pipeline->Submit(upcoming.lpath));
+                        }
+                    }
+                    if (is_pipelined(ci)) {
+                        file = std::move(prepared.front());
+                        prepared.pop_front();
+                    }
+                }
                 if (!sync_send(sc, ci.lpath, ci.rpath, ci.time, ci.mode, false, compression,
-                               dry_run)) {
+                               dry_run, pipeline ? &*pipeline : nullptr, std::move(file))) {
                     return false;
                 }
             }
@@ -1485,11 +1596,56 @@ bool do_sync_push(const std::vector<const char*>& srcs, const char* dst, bool sy
         }
     }
 
-    for (const char* src_path : srcs) {
+    // Large top-level files are read and compressed a few files ahead of the one being sent, as
+    // in copy_local_dir_remote. Directories are sent through their own pipeline.
+    std::vector<bool> is_pipelined(srcs.size());
+    size_t pipelined_files = 0;
+    uint64_t pipelined_bytes = 0;
+    for (size_t i = 0; i < srcs.size(); ++i) {
+        struct stat src_st;
+        if (stat(srcs[i], &src_st) == 0 && S_ISREG(src_st.st_mode) &&
+            src_st.st_size >= SYNC_DATA_MAX) {
+            is_pipelined[i] = true;
+            pipelined_files++;
+            pipelined_bytes += src_st.st_size;
+        }
+    }
+    std::optional<SyncSendPipeline> pipeline;
+    size_t num_workers = SyncSendPipeline::WorkersFor(pipelined_files, pipelined_bytes);
+    if (sc.HaveSendRecv2() && num_workers > 0) {
+        pipeline.emplace(compression, sc.ResolveCompressionType(CompressionType::Any),
+                         num_workers);
+    }
+    std::deque<std::shared_ptr<SyncSendPipeline::File>> prepared;
+    size_t next_to_prepare = 0;
+
+    for (size_t i = 0; i < srcs.size(); ++i) {
+        const char* src_path = srcs[i];
         const char* dst_path = dst;
+        std::shared_ptr<SyncSendPipeline::File> file;
+        if (pipeline) {
+            for (; next_to_prepare < srcs.size() && prepared.size() < pipeline->FilesInFlight();
+                 ++next_to_prepare) {
+                if (is_pipelined[next_to_prepare]) {
+                    prepared.push_back(pipeline->Submit(srcs[next_to_prepare]));
+                }
+            }
+            if (is_pipelined[i]) {
+                file = std::move(prepared.front());
+                prepared.pop_front();
+            }
+        }
+        // The file may have changed since it was submitted, in which case it isn't sent below.
+        auto abandon_file = [&pipeline, &file]() {
+            if (file) {
+                pipeline->Abandon(*file);
+            }
+        };
+
         struct stat st;
         if (stat(src_path, &st) == -1) {
             sc.Error("cannot stat '%s': %s", src_path, strerror(errno));
+            abandon_file();
             success = false;
             continue;
         }
@@ -1512,11 +1668,13 @@ bool do_sync_push(const std::vector<const char*>& srcs, const char* dst, bool sy
                 dst_dir.append(android::base::Basename(src_path));
             }
 
+            abandon_file();
             success &=
                     copy_local_dir_remote(sc, src_path, dst_dir, sync, false, compression, dry_run);
             continue;
         } else if (!should_push_file(st.st_mode)) {
             sc.Warning("skipping special file '%s' (mode = 0o%o)", src_path, st.st_mode);
+            abandon_file();
             continue;
         }
 
@@ -1535,7 +1693,7 @@ bool do_sync_push(const std::vector<const char*>& srcs, const char* dst, bool sy
         sc.NewTransfer();
         sc.SetExpectedTotalBytes(st.st_size);
         success &= sync_send(sc, src_path, dst_path, st.st_mtime, st.st_mode, sync, compression,
-                             dry_run);
+                             dry_run, pipeline ? &*pipeline : nullptr, std::move(file));
         sc.ReportTransferRate(src_path, TransferDirection::push);
     }
 
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "client/sync_send_pipeline.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <variant>
+
+#include "sysdeps.h"
+
+#include "compression_utils.h"
+
+#include <android-base/logging.h>
+#include <android-base/stringprintf.h>
+
+using android::base::StringPrintf;
+
+// Bytes a worker may compress ahead of the writer for a single file.
+static constexpr size_t kMaxBufferedBytesPerFile = 4 * 1024 * 1024;
+
+// Starting threads and copying every chunk between them only pays off once there is this much to
+// read and compress. Smaller pushes take the serial path.
+static constexpr uint64_t kMinPipelinedBytes = 1024 * 1024;
+
+// Bytes of input that keep one worker busy for long enough to justify starting it.
+static constexpr uint64_t kBytesPerWorker = 4 * 1024 * 1024;
+
+// Once compression has been turned off, one file in this many is compressed anyway so that the
+// estimate of what compression would achieve stays current.
+static constexpr size_t kProbeInterval = 16;
+
+// Weight kept by past samples each time a new one is added to a Throughput.
+static constexpr double kThroughputDecay = 0.95;
+
+void SyncSendPipeline::Throughput::Add(double new_bytes, double new_seconds) {
+    bytes = bytes * kThroughputDecay + new_bytes;
+    seconds = seconds * kThroughputDecay + new_seconds;
+}
+
+std::optional<double> SyncSendPipeline::Throughput::BytesPerSecond() const {
+    if (seconds <= 0) {
+        return std::nullopt;
+    }
+    return bytes / seconds;
+}
+
+std::optional<SyncSendPipeline::Chunk> SyncSendPipeline::File::Next(std::string* error) {
+    std::unique_lock<std::mutex> lock(pipeline_->mutex_);
+    pipeline_->cv_.wait(lock, [this]() { return !chunks_.empty() || done_; });
+    if (chunks_.empty()) {
+        if (!error_.empty()) {
+            *error = error_;
+        }
+        return std::nullopt;
+    }
+    Chunk chunk = std::move(chunks_.front());
+    chunks_.pop_front();
+    buffered_bytes_ -= chunk.data.size();
+    pipeline_->cv_.notify_all();
+    return chunk;
+}
+
+size_t SyncSendPipeline::WorkersFor(size_t num_files, uint64_t total_bytes) {
+    if (num_files == 0 || total_bytes < kMinPipelinedBytes) {
+        return 0;
+    }
+    // Leave a core for the thread writing to the transport.
+    uint64_t max_workers = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 9) - 1;
+    uint64_t by_size = (total_bytes + kBytesPerWorker - 1) / kBytesPerWorker;
+    return std::min<uint64_t>({max_workers, num_files, by_size});
+}
+
+SyncSendPipeline::SyncSendPipeline(CompressionType requested, CompressionType automatic,
+                                   size_t num_workers)
+    : requested_(requested), automatic_(automatic) {
+    CHECK_GE(num_workers, 1u);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+SyncSendPipeline::~SyncSendPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::shared_ptr<SyncSendPipeline::File> SyncSendPipeline::Submit(std::string path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<File> file(new File(this, std::move(path), ChooseCompression()));
+    pending_.push_back(file);
+    cv_.notify_all();
+    return file;
+}
+
+void SyncSendPipeline::Abandon(File& file) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file.abandoned_ = true;
+    file.chunks_.clear();
+    file.buffered_bytes_ = 0;
+    std::erase_if(pending_, [&file](const std::shared_ptr<File>& pending) {
+        return pending.get() == &file;
+    });
+    cv_.notify_all();
+}
+
+void SyncSendPipeline::RecordWrite(size_t bytes, std::chrono::steady_clock::duration elapsed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    link_.Add(bytes, std::chrono::duration<double>(elapsed).count());
+}
+
+CompressionType SyncSendPipeline::ChooseCompression() {
+    if (requested_ != CompressionType::Any || automatic_ == CompressionType::None) {
+        return requested_ == CompressionType::Any ? automatic_ : requested_;
+    }
+
+    std::optional<double> link_rate = link_.BytesPerSecond();
+    std::optional<double> compression_rate = compression_.BytesPerSecond();
+    if (!link_rate || !compression_rate) {
+        // Nothing measured yet, start out the way adb always has.
+        return automatic_;
+    }
+
+    // Rates are in bytes of the local files per second. Raw files go out as fast as the link
+    // carries them. Compressed, the workers have to keep up too, but each byte on the link carries
+    // 1 / ratio bytes of file.
+    double raw_rate = *link_rate;
+    double compressed_rate = std::min(*compression_rate * workers_.size(),
+                                      *link_rate / std::max(compression_ratio_, 0.01));
+    if (compressed_rate >= raw_rate || ++files_since_compressed_ >= kProbeInterval) {
+        files_since_compressed_ = 0;
+        return automatic_;
+    }
+    return CompressionType::None;
+}
+
+void SyncSendPipeline::WorkerLoop() {
+    while (true) {
+        std::shared_ptr<File> file;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            file = std::move(pending_.front());
+            pending_.pop_front();
+        }
+
+        Process(*file);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        file->done_ = true;
+        cv_.notify_all();
+    }
+}
+
+void SyncSendPipeline::Process(File& file) {
+    auto fail = [this, &file](std::string error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        file.error_ = std::move(error);
+    };
+
+    unique_fd lfd(adb_open(file.path_.c_str(), O_RDONLY | O_CLOEXEC));
+    if (lfd < 0) {
+        fail(StringPrintf("opening '%s' locally failed: %s", file.path_.c_str(), strerror(errno)));
+        return;
+    }
+
+    std::variant<std::monostate, NullEncoder, BrotliEncoder, LZ4Encoder, ZstdEncoder>
+            encoder_storage;
+    Encoder* encoder = nullptr;
+    switch (file.compression_) {
+        case CompressionType::None:
+            encoder = &encoder_storage.emplace<NullEncoder>(SYNC_DATA_MAX);
+            break;
+
+        case CompressionType::Brotli:
+            encoder = &encoder_storage.emplace<BrotliEncoder>(SYNC_DATA_MAX);
+            break;
+
+        case CompressionType::LZ4:
+            encoder = &encoder_storage.emplace<LZ4Encoder>(SYNC_DATA_MAX);
+            break;
+
+        case CompressionType::Zstd:
+            encoder = &encoder_storage.emplace<ZstdEncoder>(SYNC_DATA_MAX);
+            break;
+
+        case CompressionType::Any:
+            LOG(FATAL) << "unexpected CompressionType::Any";
+    }
+
+    size_t input_bytes = 0;
+    size_t output_bytes = 0;
+    std::chrono::steady_clock::duration encode_time{};
+    size_t unreported_input = 0;
+    bool reading = true;
+    while (reading) {
+        Block input(SYNC_DATA_MAX);
+        int r = adb_read(lfd.get(), input.data(), input.size());
+        if (r < 0) {
+            fail(StringPrintf("reading '%s' locally failed: %s", file.path_.c_str(),
+                              strerror(errno)));
+            return;
+        }
+
+        auto encode_start = std::chrono::steady_clock::now();
+        if (r == 0) {
+            encoder->Finish();
+        } else {
+            input.resize(r);
+            encoder->Append(std::move(input));
+            input_bytes += r;
+            unreported_input += r;
+        }
+
+        while (true) {
+            Chunk chunk;
+            EncodeResult result = encoder->Encode(&chunk.data);
+            if (result == EncodeResult::Error) {
+                fail(StringPrintf("compressing '%s' locally failed", file.path_.c_str()));
+                return;
+            }
+
+            if (!chunk.data.empty()) {
+                output_bytes += chunk.data.size();
+                chunk.input_bytes = std::exchange(unreported_input, 0);
+                encode_time += std::chrono::steady_clock::now() - encode_start;
+                if (!Emit(file, std::move(chunk))) {
+                    return;
+                }
+                encode_start = std::chrono::steady_clock::now();
+            }
+
+            if (result == EncodeResult::Done) {
+                reading = false;
+                break;
+            } else if (result == EncodeResult::NeedInput) {
+                break;
+            }
+        }
+        encode_time += std::chrono::steady_clock::now() - encode_start;
+    }
+
+    if (file.compression_ != CompressionType::None && input_bytes > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        compression_.Add(input_bytes, std::chrono::duration<double>(encode_time).count());
+        compression_ratio_ = static_cast<double>(output_bytes) / input_bytes;
+    }
+}
+
+bool SyncSendPipeline::Emit(File& file, Chunk chunk) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, &file]() {
+        return stopping_ || file.abandoned_ || file.buffered_bytes_ < kMaxBufferedBytesPerFile;
+    });
+    if (stopping_ || file.abandoned_) {
+        return false;
+    }
+    file.buffered_bytes_ += chunk.data.size();
+    file.chunks_.push_back(std::move(chunk));
+    cv_.notify_all();
+    return true;
+}
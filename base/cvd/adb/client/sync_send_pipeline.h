@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "file_sync_protocol.h"
+#include "types.h"
+
+// Reads and compresses files for `adb push` on a pool of worker threads, so that the thread
+// writing to the sync connection only has to copy out finished ID_DATA payloads.
+//
+// Each file is still a single compressed stream, which is what adbd expects, so the parallelism is
+// across files: workers take files in submission order and the writer consumes them in the same
+// order, while later files are already being compressed.
+class SyncSendPipeline {
+  public:
+    struct Chunk {
+        // Payload of one ID_DATA packet, at most SYNC_DATA_MAX bytes.
+        Block data;
+        // Bytes of the local file consumed to produce `data`, for progress reporting.
+        size_t input_bytes = 0;
+    };
+
+    class File {
+      public:
+        const std::string& path() const { return path_; }
+        CompressionType compression() const { return compression_; }
+
+        // Blocks until the next chunk is ready. Returns nullopt once the whole file has been
+        // returned, or if it could not be read or compressed, in which case `error` is set.
+        std::optional<Chunk> Next(std::string* error);
+
+      private:
+        friend class SyncSendPipeline;
+
+        File(SyncSendPipeline* pipeline, std::string path, CompressionType compression)
+            : pipeline_(pipeline), path_(std::move(path)), compression_(compression) {}
+
+        SyncSendPipeline* pipeline_;
+        const std::string path_;
+        const CompressionType compression_;
+
+        // Guarded by pipeline_->mutex_.
+        std::deque<Chunk> chunks_;
+        size_t buffered_bytes_ = 0;
+        bool done_ = false;
+        bool abandoned_ = false;
+        std::string error_;
+    };
+
+    // Returns how many workers are worth starting to send `num_files` large files totalling
+    // `total_bytes`, or 0 if they are better sent without a pipeline.
+    static size_t WorkersFor(size_t num_files, uint64_t total_bytes);
+
+    // `requested` is the compression the user asked for. When it is CompressionType::Any, files are
+    // compressed with `automatic` only while that is measured to be faster than sending them raw.
+    // `num_workers` must be at least 1.
+    SyncSendPipeline(CompressionType requested, CompressionType automatic, size_t num_workers);
+    ~SyncSendPipeline();
+
+    SyncSendPipeline(const SyncSendPipeline&) = delete;
+    SyncSendPipeline& operator=(const SyncSendPipeline&) = delete;
+
+    // Queues `path` for reading and compression.
+    std::shared_ptr<File> Submit(std::string path);
+
+    // Stops reading `file`, which the writer will not consume the rest of. Without this, a worker
+    // would stay blocked on the file once it has buffered as much as it may.
+    void Abandon(File& file);
+
+    // Number of files worth submitting ahead of the one being written.
+    size_t FilesInFlight() const { return 2 * workers_.size(); }
+
+    // Lets the pipeline measure link throughput: `bytes` were written to the transport in
+    // `elapsed`.
+    void RecordWrite(size_t bytes, std::chrono::steady_clock::duration elapsed);
+
+  private:
+    // Running averages used to decide whether compression pays off.
+    struct Throughput {
+        void Add(double bytes, double seconds);
+        std::optional<double> BytesPerSecond() const;
+
+        double bytes = 0;
+        double seconds = 0;
+    };
+
+    void WorkerLoop();
+    void Process(File& file);
+    // Returns false if the pipeline is shutting down.
+    bool Emit(File& file, Chunk chunk);
+    CompressionType ChooseCompression();
+
+    const CompressionType requested_;
+    const CompressionType automatic_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<File>> pending_;
+    bool stopping_ = false;
+
+    Throughput link_;
+    Throughput compression_;
+    // Compressed size divided by raw size.
+    double compression_ratio_ = 1.0;
+    size_t files_since_compressed_ = 0;
+
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "client/sync_send_pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <android-base/file.h>
+
+#include "file_sync_protocol.h"
+
+namespace {
+
+std::string Contents(size_t size, char seed) {
+    std::string contents(size, '\0');
+    for (size_t i = 0; i < size; ++i) {
+        contents[i] = static_cast<char>(seed + i * 7 + i / 4096);
+    }
+    return contents;
+}
+
+// Reads all of `file` back, returning nullopt and setting `error` if it failed.
+std::optional<std::string> ReadAll(SyncSendPipeline::File& file, std::string* error) {
+    std::string data;
+    size_t input_bytes = 0;
+    while (std::optional<SyncSendPipeline::Chunk> chunk = file.Next(error)) {
+        EXPECT_LE(chunk->data.size(), static_cast<size_t>(SYNC_DATA_MAX));
+        data.append(chunk->data.data(), chunk->data.size());
+        input_bytes += chunk->input_bytes;
+    }
+    if (!error->empty()) {
+        return std::nullopt;
+    }
+    EXPECT_EQ(input_bytes, data.size());
+    return data;
+}
+
+class SyncSendPipelineTest : public ::testing::Test {
+  protected:
+    std::string WriteFile(const std::string& name, const std::string& contents) {
+        std::string path = std::string(dir_.path) + "/" + name;
+        EXPECT_TRUE(android::base::WriteStringToFile(contents, path));
+        return path;
+    }
+
+    TemporaryDir dir_;
+};
+
+TEST(SyncSendPipelineWorkersTest, SmallPushesSkipThePipeline) {
+    EXPECT_EQ(SyncSendPipeline::WorkersFor(0, 0), 0u);
+    EXPECT_EQ(SyncSendPipeline::WorkersFor(1, SYNC_DATA_MAX), 0u);
+    EXPECT_EQ(SyncSendPipeline::WorkersFor(8, 8 * SYNC_DATA_MAX), 0u);
+}
+
+TEST(SyncSendPipelineWorkersTest, WorkersAreBoundedByFilesAndBytes) {
+    constexpr uint64_t kMiB = 1024 * 1024;
+    EXPECT_EQ(SyncSendPipeline::WorkersFor(1, 1024 * kMiB), 1u);
+    EXPECT_EQ(SyncSendPipeline::WorkersFor(100, 2 * kMiB), 1u);
+    size_t many = SyncSendPipeline::WorkersFor(100, 1024 * kMiB);
+    EXPECT_GE(many, 1u);
+    EXPECT_LE(many, 8u);
+}
+
+TEST_F(SyncSendPipelineTest, FilesComeBackInSubmissionOrder) {
+    SyncSendPipeline pipeline(CompressionType::None, CompressionType::None, 3);
+    std::vector<std::string> contents;
+    std::vector<std::shared_ptr<SyncSendPipeline::File>> files;
+    for (int i = 0; i < 6; ++i) {
+        // Earlier files are larger, so that later ones tend to finish first.
+        contents.push_back(Contents((6 - i) * 3 * SYNC_DATA_MAX + i, 'a' + i));
+        files.push_back(pipeline.Submit(WriteFile(std::to_string(i), contents.back())));
+    }
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::string error;
+        std::optional<std::string> data = ReadAll(*files[i], &error);
+        ASSERT_TRUE(data.has_value()) << error;
+        EXPECT_EQ(*data, contents[i]) << "file " << i;
+    }
+}
+
+TEST_F(SyncSendPipelineTest, CompressedFilesAccountForAllInput) {
+    SyncSendPipeline pipeline(CompressionType::Brotli, CompressionType::Brotli, 1);
+    std::string contents(4 * SYNC_DATA_MAX, 'x');
+    auto file = pipeline.Submit(WriteFile("compressible", contents));
+    EXPECT_EQ(file->compression(), CompressionType::Brotli);
+
+    std::string error;
+    size_t input_bytes = 0;
+    size_t output_bytes = 0;
+    while (std::optional<SyncSendPipeline::Chunk> chunk = file->Next(&error)) {
+        input_bytes += chunk->input_bytes;
+        output_bytes += chunk->data.size();
+    }
+    EXPECT_EQ(error, "");
+    EXPECT_EQ(input_bytes, contents.size());
+    EXPECT_LT(output_bytes, contents.size());
+}
+
+TEST_F(SyncSendPipelineTest, ErrorsStayWithTheirFile) {
+    SyncSendPipeline pipeline(CompressionType::None, CompressionType::None, 2);
+    std::string before = Contents(2 * SYNC_DATA_MAX, 'b');
+    std::string after = Contents(2 * SYNC_DATA_MAX, 'c');
+    auto first = pipeline.Submit(WriteFile("before", before));
+    auto missing = pipeline.Submit(std::string(dir_.path) + "/missing");
+    auto last = pipeline.Submit(WriteFile("after", after));
+
+    std::string error;
+    EXPECT_EQ(ReadAll(*first, &error), before);
+    EXPECT_EQ(error, "");
+
+    EXPECT_EQ(ReadAll(*missing, &error), std::nullopt);
+    EXPECT_NE(error.find("missing"), std::string::npos) << error;
+
+    error.clear();
+    EXPECT_EQ(ReadAll(*last, &error), after);
+    EXPECT_EQ(error, "");
+}
+
+TEST_F(SyncSendPipelineTest, AbandonedFilesReleaseTheirWorker) {
+    SyncSendPipeline pipeline(CompressionType::None, CompressionType::None, 1);
+    // Larger than a file may buffer ahead of the writer, so the only worker
+    // blocks on it until it is abandoned.
+    auto skipped = pipeline.Submit(WriteFile("skipped", Contents(8 * 1024 * 1024, 'e')));
+    std::string contents = Contents(2 * SYNC_DATA_MAX, 'f');
+    auto next = pipeline.Submit(WriteFile("next", contents));
+
+    pipeline.Abandon(*skipped);
+
+    std::string error;
+    EXPECT_EQ(ReadAll(*next, &error), contents);
+    EXPECT_EQ(error, "");
+}
+
+TEST_F(SyncSendPipelineTest, DestroyingWithUnreadFilesDoesNotHang) {
+    // Larger than a file may buffer ahead of the writer, so the worker is
+    // blocked when the pipeline goes away.
+    std::string path = WriteFile("large", Contents(8 * 1024 * 1024, 'd'));
+    SyncSendPipeline pipeline(CompressionType::None, CompressionType::None, 2);
+    pipeline.Submit(path);
+    pipeline.Submit(path);
+}
+
+}  // namespace
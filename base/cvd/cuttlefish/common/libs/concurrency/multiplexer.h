@@ -47,8 +47,10 @@ class Multiplexer {
 
   void Push(const int idx, T&& t) {
     CheckIdx(idx);
-    queues_[idx]->Push(std::move(t));
-    sem_items_.SemPost();
+    // A full queue may drop the item, which must then not be waited for.
+    if (queues_[idx]->Push(std::move(t))) {
+      sem_items_.SemPost();
+    }
   }
 
   T Pop(QueueSelector selector) {
@@ -0,0 +1,102 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Passes items between threads through a shared queue. Even numbered threads
+// push and odd numbered threads pop, every thread runs the same number of
+// iterations, so each pushed item is popped. The batch variants move 32 items
+// per operation.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cuttlefish/common/libs/concurrency/ring_queue.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr size_t kCapacity = 1024;
+constexpr size_t kBatch = 32;
+
+struct Item {
+  int64_t value;
+};
+
+// One queue per benchmark run, shared by its threads.
+template <typename Queue>
+class QueueFixture : public benchmark::Fixture {
+ public:
+  void SetUp(benchmark::State& state) override {
+    if (state.thread_index() == 0) {
+      queue_ = std::make_unique<Queue>(kCapacity);
+    }
+  }
+
+ protected:
+  // queue_ is only read inside the loops, which start once every thread is
+  // done with SetUp.
+  void PassOne(benchmark::State& state) {
+    bool producer = state.thread_index() % 2 == 0;
+    int64_t i = 0;
+    for (auto _ : state) {
+      if (producer) {
+        queue_->PushWait(Item{i++});
+      } else {
+        Item item = queue_->Pop();
+        benchmark::DoNotOptimize(item.value);
+      }
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void PassBatches(benchmark::State& state) {
+    bool producer = state.thread_index() % 2 == 0;
+    std::vector<Item> items(kBatch);
+    for (auto _ : state) {
+      if (producer) {
+        queue_->PushBatchWait(items.begin(), items.end());
+      } else {
+        items.clear();
+        while (items.size() < kBatch) {
+          queue_->PopBatch(items, kBatch - items.size());
+        }
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+  }
+
+  std::unique_ptr<Queue> queue_;
+};
+
+#define QUEUE_BENCHMARK(Name, Queue, Method, MaxThreads) \
+  BENCHMARK_TEMPLATE_DEFINE_F(QueueFixture, Name, Queue) \
+  (benchmark::State & state) {                           \
+    this->Method(state);                                 \
+  }                                                      \
+  BENCHMARK_REGISTER_F(QueueFixture, Name)               \
+      ->ThreadRange(2, MaxThreads)                       \
+      ->UseRealTime();
+
+QUEUE_BENCHMARK(Spsc, SpscQueue<Item>, PassOne, 2)
+QUEUE_BENCHMARK(SpscBatch, SpscQueue<Item>, PassBatches, 2)
+QUEUE_BENCHMARK(Mpmc, MpmcQueue<Item>, PassOne, 8)
+QUEUE_BENCHMARK(MpmcBatch, MpmcQueue<Item>, PassBatches, 8)
+
+}  // namespace
+}  // namespace cuttlefish
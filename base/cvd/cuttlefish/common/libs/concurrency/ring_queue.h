@@ -0,0 +1,455 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+
+namespace cuttlefish {
+
+// Bounded queues on a fixed ring of slots, with the Push/Pop/PopAll/IsEmpty/
+// IsFull interface a Multiplexer expects.
+//
+// Pushing and popping never take a lock. A thread only sleeps, on a futex
+// through std::atomic::wait, when it has to wait for an item or for room, and
+// a thread only makes a wake up call when another one is asleep.
+//
+// Push drops the item when the queue is full, while PushWait waits for room.
+//
+//   SpscQueue<T>: one pushing thread and one popping thread at a time.
+//   MpmcQueue<T>: any number of both.
+
+struct RingQueueStats {
+  size_t capacity;
+  // Items in the queue, a snapshot while other threads use it.
+  size_t size;
+  uint64_t pushed;
+  uint64_t popped;
+  // Items rejected by Push because the queue was full.
+  uint64_t dropped;
+};
+
+namespace ring_queue_internal {
+
+inline constexpr size_t kCacheLineSize = 64;
+
+// An event count: waiters sleep until Notify is called after their last
+// check of the condition.
+class WaitList {
+ public:
+  static constexpr int kYieldsBeforeSleeping = 16;
+
+  // Returns once `try_ready` returns true.
+  template <typename F>
+  void Wait(F&& try_ready) {
+    // The other side is usually about to make progress, and letting it run
+    // is much cheaper than a futex round trip per item.
+    for (int i = 0; i < kYieldsBeforeSleeping; i++) {
+      if (try_ready()) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+    while (!try_ready()) {
+      waiters_.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      uint32_t epoch = epoch_.load();
+      if (try_ready()) {
+        waiters_.fetch_sub(1);
+        return;
+      }
+      epoch_.wait(epoch);
+      waiters_.fetch_sub(1);
+    }
+  }
+
+  // To be called after making the condition true.
+  void Notify(bool all) {
+    // Pairs with the read-modify-write on waiters_ in Wait: either the waiter
+    // sees the new state in its second check or this sees the waiter.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    epoch_.fetch_add(1);
+    if (all) {
+      epoch_.notify_all();
+    } else {
+      epoch_.notify_one();
+    }
+  }
+
+ private:
+  std::atomic<uint32_t> epoch_ = 0;
+  std::atomic<uint32_t> waiters_ = 0;
+};
+
+template <typename T>
+class Slot {
+ public:
+  template <typename U>
+  void Construct(U&& u) {
+    new (storage_) T(std::forward<U>(u));
+  }
+  T Take() {
+    T* value = std::launder(reinterpret_cast<T*>(storage_));
+    T t = std::move(*value);
+    value->~T();
+    return t;
+  }
+  void Destroy() { std::launder(reinterpret_cast<T*>(storage_))->~T(); }
+
+ private:
+  alignas(T) unsigned char storage_[sizeof(T)];
+};
+
+// Lamport's ring: the producer owns tail_ and the consumer owns head_, each
+// keeps a stale copy of the other index and only reloads it when the ring
+// looks full or empty.
+template <typename T>
+class SpscRing {
+ public:
+  explicit SpscRing(size_t capacity)
+      : capacity_(capacity), slots_(new Slot<T>[capacity]) {}
+  ~SpscRing() {
+    for (uint64_t i = head_.load(); i != tail_.load(); i++) {
+      slots_[i % capacity_].Destroy();
+    }
+  }
+
+  size_t capacity() const { return capacity_; }
+  uint64_t head() const { return head_.load(std::memory_order_acquire); }
+  uint64_t tail() const { return tail_.load(std::memory_order_acquire); }
+
+  template <typename U>
+  bool TryPush(U&& u) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (Room(tail) == 0) {
+      return false;
+    }
+    slots_[tail % capacity_].Construct(std::forward<U>(u));
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Moves items from [first, last) while there is room and publishes them at
+  // once. Returns the first item not pushed.
+  template <typename It>
+  It TryPushBatch(It first, It last) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    size_t room = Room(tail);
+    uint64_t end = tail;
+    for (; first != last && end - tail < room; ++first, ++end) {
+      slots_[end % capacity_].Construct(std::move(*first));
+    }
+    tail_.store(end, std::memory_order_release);
+    return first;
+  }
+
+  std::optional<T> TryPop() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (Available(head) == 0) {
+      return std::nullopt;
+    }
+    std::optional<T> t(slots_[head % capacity_].Take());
+    head_.store(head + 1, std::memory_order_release);
+    return t;
+  }
+
+  size_t TryPopBatch(std::vector<T>& out, size_t max) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    size_t count = std::min(Available(head), max);
+    for (uint64_t i = head; i < head + count; i++) {
+      out.push_back(slots_[i % capacity_].Take());
+    }
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+ private:
+  size_t Room(uint64_t tail) {
+    if (tail - cached_head_ == capacity_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    return capacity_ - (tail - cached_head_);
+  }
+  size_t Available(uint64_t head) {
+    if (cached_tail_ == head) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    return cached_tail_ - head;
+  }
+
+  const size_t capacity_;
+  const std::unique_ptr<Slot<T>[]> slots_;
+  alignas(kCacheLineSize) std::atomic<uint64_t> tail_ = 0;
+  uint64_t cached_head_ = 0;
+  alignas(kCacheLineSize) std::atomic<uint64_t> head_ = 0;
+  uint64_t cached_tail_ = 0;
+};
+
+// Dmitry Vyukov's bounded MPMC queue. Each slot has a sequence number telling
+// which lap of the ring it's ready for: producers claim a position with a CAS
+// on tail_ and only touch its slot once the sequence says the consumer of the
+// previous lap is done with it, and vice versa.
+template <typename T>
+class MpmcRing {
+ public:
+  explicit MpmcRing(size_t capacity)
+      : capacity_(capacity), cells_(new Cell[capacity]) {
+    for (size_t i = 0; i < capacity; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  ~MpmcRing() {
+    while (TryPop()) {
+    }
+  }
+
+  size_t capacity() const { return capacity_; }
+  uint64_t head() const { return head_.load(std::memory_order_acquire); }
+  uint64_t tail() const { return tail_.load(std::memory_order_acquire); }
+
+  template <typename U>
+  bool TryPush(U&& u) {
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[pos % capacity_];
+      uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+      int64_t lap = static_cast<int64_t>(sequence - pos);
+      if (lap == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (lap < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->slot.Construct(std::forward<U>(u));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename It>
+  It TryPushBatch(It first, It last) {
+    while (first != last && TryPush(std::move(*first))) {
+      ++first;
+    }
+    return first;
+  }
+
+  std::optional<T> TryPop() {
+    uint64_t pos = head_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[pos % capacity_];
+      uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+      int64_t lap = static_cast<int64_t>(sequence - (pos + 1));
+      if (lap == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (lap < 0) {
+        return std::nullopt;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+    std::optional<T> t(cell->slot.Take());
+    cell->sequence.store(pos + capacity_, std::memory_order_release);
+    return t;
+  }
+
+  size_t TryPopBatch(std::vector<T>& out, size_t max) {
+    size_t count = 0;
+    for (; count < max; count++) {
+      std::optional<T> t = TryPop();
+      if (!t) {
+        break;
+      }
+      out.push_back(std::move(*t));
+    }
+    return count;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<uint64_t> sequence;
+    Slot<T> slot;
+  };
+
+  const size_t capacity_;
+  const std::unique_ptr<Cell[]> cells_;
+  alignas(kCacheLineSize) std::atomic<uint64_t> tail_ = 0;
+  alignas(kCacheLineSize) std::atomic<uint64_t> head_ = 0;
+};
+
+}  // namespace ring_queue_internal
+
+template <typename T, typename Ring>
+class RingQueue {
+ public:
+  using QueueImpl = std::vector<T>;
+
+  explicit RingQueue(size_t capacity) : ring_(capacity) {
+    CHECK(capacity > 0) << "A queue needs room for at least one item";
+  }
+
+  // Returns false, and counts the item as dropped, if the queue is full.
+  template <typename U>
+  bool Push(U&& u) {
+    static_assert(std::is_assignable_v<T&, decltype(u)>);
+    if (!ring_.TryPush(std::forward<U>(u))) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    not_empty_.Notify(/* all= */ false);
+    return true;
+  }
+
+  // Waits for room if the queue is full.
+  template <typename U>
+  void PushWait(U&& u) {
+    static_assert(std::is_assignable_v<T&, decltype(u)>);
+    // A failed TryPush leaves `u` untouched, so it can be forwarded again.
+    if (!ring_.TryPush(std::forward<U>(u))) {
+      not_full_.Wait(
+          [this, &u]() { return ring_.TryPush(std::forward<U>(u)); });
+    }
+    not_empty_.Notify(/* all= */ false);
+  }
+
+  // Pushes items from [first, last), moving them, until the queue is full
+  // and wakes up consumers once. Returns the first item not pushed.
+  template <typename It>
+  It PushBatch(It first, It last) {
+    It rest = ring_.TryPushBatch(first, last);
+    if (rest != first) {
+      not_empty_.Notify(/* all= */ true);
+    }
+    return rest;
+  }
+
+  // Pushes all of [first, last), waiting for room as needed.
+  template <typename It>
+  void PushBatchWait(It first, It last) {
+    first = PushBatch(first, last);
+    while (first != last) {
+      not_full_.Wait([this, &first, last]() {
+        It rest = ring_.TryPushBatch(first, last);
+        bool progress = rest != first;
+        first = rest;
+        return progress;
+      });
+      not_empty_.Notify(/* all= */ true);
+    }
+  }
+
+  std::optional<T> TryPop() {
+    std::optional<T> t = ring_.TryPop();
+    if (t) {
+      not_full_.Notify(/* all= */ false);
+    }
+    return t;
+  }
+
+  T Pop() {
+    std::optional<T> t = ring_.TryPop();
+    if (!t) {
+      not_empty_.Wait([this, &t]() {
+        t = ring_.TryPop();
+        return t.has_value();
+      });
+    }
+    not_full_.Notify(/* all= */ false);
+    return std::move(*t);
+  }
+
+  // Waits for at least one item, then appends up to `max` items to `out`
+  // without waiting any further. Returns the number of items appended.
+  size_t PopBatch(std::vector<T>& out, size_t max) {
+    size_t count = ring_.TryPopBatch(out, max);
+    if (count == 0) {
+      not_empty_.Wait([this, &out, &count, max]() {
+        count = ring_.TryPopBatch(out, max);
+        return count > 0;
+      });
+    }
+    not_full_.Notify(/* all= */ true);
+    return count;
+  }
+
+  QueueImpl PopAll() {
+    QueueImpl items;
+    PopBatch(items, ring_.capacity());
+    return items;
+  }
+
+  bool IsEmpty() const { return ring_.tail() == ring_.head(); }
+  bool IsFull() const { return Size() >= ring_.capacity(); }
+
+  RingQueueStats Stats() const {
+    uint64_t popped = ring_.head();
+    uint64_t pushed = ring_.tail();
+    return RingQueueStats{
+        .capacity = ring_.capacity(),
+        .size = static_cast<size_t>(pushed > popped ? pushed - popped : 0),
+        .pushed = pushed,
+        .popped = popped,
+        .dropped = dropped_.load(std::memory_order_relaxed),
+    };
+  }
+
+ private:
+  size_t Size() const {
+    uint64_t popped = ring_.head();
+    uint64_t pushed = ring_.tail();
+    return pushed > popped ? pushed - popped : 0;
+  }
+
+  Ring ring_;
+  alignas(ring_queue_internal::kCacheLineSize)
+      ring_queue_internal::WaitList not_empty_;
+  alignas(ring_queue_internal::kCacheLineSize)
+      ring_queue_internal::WaitList not_full_;
+  alignas(ring_queue_internal::kCacheLineSize)
+      std::atomic<uint64_t> dropped_ = 0;
+};
+
+template <typename T>
+using SpscQueue = RingQueue<T, ring_queue_internal::SpscRing<T>>;
+
+template <typename T>
+using MpmcQueue = RingQueue<T, ring_queue_internal::MpmcRing<T>>;
+
+}  // namespace cuttlefish
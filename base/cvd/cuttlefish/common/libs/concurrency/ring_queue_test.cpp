@@ -0,0 +1,176 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/common/libs/concurrency/ring_queue.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace cuttlefish {
+namespace {
+
+using testing::ElementsAre;
+
+template <typename Queue>
+class RingQueueTest : public testing::Test {};
+
+using Queues = testing::Types<SpscQueue<std::unique_ptr<int>>,
+                              MpmcQueue<std::unique_ptr<int>>>;
+TYPED_TEST_SUITE(RingQueueTest, Queues);
+
+TYPED_TEST(RingQueueTest, PopsInPushOrder) {
+  TypeParam queue(3);
+
+  ASSERT_TRUE(queue.Push(std::make_unique<int>(1)));
+  ASSERT_TRUE(queue.Push(std::make_unique<int>(2)));
+
+  EXPECT_EQ(*queue.Pop(), 1);
+  EXPECT_EQ(*queue.Pop(), 2);
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_EQ(queue.TryPop(), std::nullopt);
+}
+
+TYPED_TEST(RingQueueTest, DropsWhenFull) {
+  TypeParam queue(2);
+
+  ASSERT_TRUE(queue.Push(std::make_unique<int>(1)));
+  ASSERT_TRUE(queue.Push(std::make_unique<int>(2)));
+  EXPECT_TRUE(queue.IsFull());
+  EXPECT_FALSE(queue.Push(std::make_unique<int>(3)));
+
+  RingQueueStats stats = queue.Stats();
+  EXPECT_EQ(stats.capacity, 2);
+  EXPECT_EQ(stats.size, 2);
+  EXPECT_EQ(stats.pushed, 2);
+  EXPECT_EQ(stats.popped, 0);
+  EXPECT_EQ(stats.dropped, 1);
+}
+
+TYPED_TEST(RingQueueTest, WrapsAround) {
+  TypeParam queue(3);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(queue.Push(std::make_unique<int>(i)));
+    ASSERT_TRUE(queue.Push(std::make_unique<int>(i + 100)));
+    EXPECT_EQ(*queue.Pop(), i);
+    EXPECT_EQ(*queue.Pop(), i + 100);
+  }
+}
+
+TYPED_TEST(RingQueueTest, Batches) {
+  TypeParam queue(4);
+  std::vector<std::unique_ptr<int>> items;
+  for (int i = 0; i < 6; i++) {
+    items.push_back(std::make_unique<int>(i));
+  }
+
+  auto rest = queue.PushBatch(items.begin(), items.end());
+
+  ASSERT_EQ(rest - items.begin(), 4);
+  std::vector<std::unique_ptr<int>> popped;
+  EXPECT_EQ(queue.PopBatch(popped, 3), 3);
+  EXPECT_EQ(queue.PopAll().size(), 1);
+  ASSERT_EQ(popped.size(), 3);
+  EXPECT_EQ(*popped[2], 2);
+}
+
+TYPED_TEST(RingQueueTest, WaitsForItemsAndRoom) {
+  constexpr int kItems = 100000;
+  TypeParam queue(16);
+
+  std::thread producer([&queue]() {
+    for (int i = 0; i < kItems; i++) {
+      queue.PushWait(std::make_unique<int>(i));
+    }
+  });
+  std::vector<int> seen;
+  while (seen.size() < kItems) {
+    std::vector<std::unique_ptr<int>> batch;
+    queue.PopBatch(batch, 7);
+    for (const auto& item : batch) {
+      seen.push_back(*item);
+    }
+  }
+  producer.join();
+
+  std::vector<int> expected(kItems);
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(seen, expected);
+  EXPECT_EQ(queue.Stats().dropped, 0);
+}
+
+TEST(MpmcQueueTest, ManyProducersAndConsumers) {
+  constexpr int kThreads = 4;
+  constexpr int kItemsPerThread = 50000;
+  MpmcQueue<int64_t> queue(64);
+
+  std::vector<std::thread> threads;
+  std::vector<int64_t> sums(kThreads, 0);
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&queue, t]() {
+      for (int i = 0; i < kItemsPerThread; i++) {
+        queue.PushWait(int64_t{t} * kItemsPerThread + i);
+      }
+    });
+    threads.emplace_back([&queue, &sums, t]() {
+      for (int i = 0; i < kItemsPerThread; i++) {
+        sums[t] += queue.Pop();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  int64_t total = kThreads * kItemsPerThread;
+  EXPECT_EQ(std::accumulate(sums.begin(), sums.end(), int64_t{0}),
+            total * (total - 1) / 2);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(MpmcQueueTest, DestroysQueuedItems) {
+  auto item = std::make_shared<int>(1);
+  {
+    MpmcQueue<std::shared_ptr<int>> queue(4);
+    queue.Push(item);
+    queue.Push(item);
+    EXPECT_EQ(item.use_count(), 3);
+  }
+  EXPECT_EQ(item.use_count(), 1);
+}
+
+TEST(SpscQueueTest, DestroysQueuedItems) {
+  auto item = std::make_shared<int>(1);
+  {
+    SpscQueue<std::shared_ptr<int>> queue(2);
+    queue.Push(item);
+    queue.Pop();
+    queue.Push(item);
+    queue.Push(item);
+    EXPECT_EQ(item.use_count(), 3);
+  }
+  EXPECT_EQ(item.use_count(), 1);
+}
+
+}  // namespace
+}  // namespace cuttlefish
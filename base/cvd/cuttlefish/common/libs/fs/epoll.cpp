@@ -16,14 +16,18 @@
 
 #include "cuttlefish/common/libs/fs/epoll.h"
 
+#include <errno.h>
+#include <stddef.h>
 #include <sys/epoll.h>
 
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <set>
 #include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/result/result.h"
@@ -58,12 +62,12 @@ Result<void> Epoll::Add(SharedFD fd, uint32_t events) {
   std::lock_guard lock(watched_mutex_);
   CF_EXPECT(epoll_fd_->IsOpen(), "Empty Epoll instance");
 
-  if (watched_.count(fd) != 0) {
+  if (watched_.count(&*fd) != 0) {
     return CF_ERRNO("Watched set already contains fd");
   }
   epoll_event event;
   event.events = events;
-  event.data.fd = fd->fd_;
+  event.data.ptr = &*fd;
   int success = epoll_ctl(epoll_fd_->fd_, EPOLL_CTL_ADD, fd->fd_, &event);
   if (success != 0 && errno == EEXIST) {
     // We're already tracking this fd, don't drop it from the set.
@@ -71,7 +75,7 @@ Result<void> Epoll::Add(SharedFD fd, uint32_t events) {
   } else if (success != 0) {
     return CF_ERRNO("epoll_ctl: Add failed");
   }
-  watched_.insert(fd);
+  watched_[&*fd] = fd;
   return {};
 }
 
@@ -81,14 +85,14 @@ Result<void> Epoll::AddOrModify(SharedFD fd, uint32_t events) {
 
   epoll_event event;
   event.events = events;
-  event.data.fd = fd->fd_;
-  int operation = watched_.count(fd) == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+  event.data.ptr = &*fd;
+  int operation = watched_.count(&*fd) == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
   int success = epoll_ctl(epoll_fd_->fd_, operation, fd->fd_, &event);
   if (success != 0) {
     std::string operation_str = operation == EPOLL_CTL_ADD ? "add" : "modify";
     return CF_ERRNO("epoll_ctl: Operation " << operation_str << " failed");
   }
-  watched_.insert(fd);
+  watched_[&*fd] = fd;
   return {};
 }
 
@@ -96,12 +100,12 @@ Result<void> Epoll::Modify(SharedFD fd, uint32_t events) {
   std::shared_lock lock(watched_mutex_);
   CF_EXPECT(epoll_fd_->IsOpen(), "Empty Epoll instance");
 
-  if (watched_.count(fd) == 0) {
+  if (watched_.count(&*fd) == 0) {
     return CF_ERR("Watched set did not contain fd");
   }
   epoll_event event;
   event.events = events;
-  event.data.fd = fd->fd_;
+  event.data.ptr = &*fd;
   int success = epoll_ctl(epoll_fd_->fd_, EPOLL_CTL_MOD, fd->fd_, &event);
   if (success != 0) {
     return CF_ERRNO("epoll_ctl: Modify failed");
@@ -113,44 +117,48 @@ Result<void> Epoll::Delete(SharedFD fd) {
   std::lock_guard lock(watched_mutex_);
   CF_EXPECT(epoll_fd_->IsOpen(), "Empty Epoll instance");
 
-  if (watched_.count(fd) == 0) {
+  if (watched_.erase(&*fd) == 0) {
     return CF_ERR("Watched set did not contain fd");
   }
+  // A closed fd fails with EBADF, or ENOENT if its number was reused already.
   int success = epoll_ctl(epoll_fd_->fd_, EPOLL_CTL_DEL, fd->fd_, nullptr);
-  if (success != 0) {
+  if (success != 0 && errno != EBADF && errno != ENOENT) {
     return CF_ERRNO("epoll_ctl: Delete failed");
   }
-  watched_.erase(fd);
   return {};
 }
 
 Result<std::optional<EpollEvent>> Epoll::Wait() {
-  epoll_event event;
-  int success;
+  std::vector<EpollEvent> events = CF_EXPECT(Wait(std::nullopt, 1));
+  if (events.empty()) {
+    // We probably lost the race to lock watched_mutex_ against a delete call.
+    // Treat this as a spurious wakeup.
+    return {};
+  }
+  return events[0];
+}
+
+Result<std::vector<EpollEvent>> Epoll::Wait(
+    std::optional<std::chrono::milliseconds> timeout, size_t max_events) {
   CF_EXPECT(epoll_fd_->IsOpen(), "Empty Epoll instance");
-  success = TEMP_FAILURE_RETRY(epoll_wait(epoll_fd_->fd_, &event, 1, -1));
-  if (success == -1) {
+  CF_EXPECT(max_events > 0, "Can't wait for zero events");
+  std::vector<epoll_event> events(max_events);
+  int timeout_ms = timeout ? timeout->count() : -1;
+  int num_events = TEMP_FAILURE_RETRY(
+      epoll_wait(epoll_fd_->fd_, events.data(), events.size(), timeout_ms));
+  if (num_events == -1) {
     return CF_ERRNO("epoll_wait failed");
-  } else if (success == 0) {
-    return {};
-  } else if (success != 1) {
-    return CF_ERR("epoll_wait returned an unexpected value");
   }
-  EpollEvent ret;
-  ret.events = event.events;
+  std::vector<EpollEvent> ret;
+  ret.reserve(num_events);
   std::shared_lock lock(watched_mutex_);
-  for (const auto& watched : watched_) {
-    if (watched->fd_ == event.data.fd) {
-      ret.fd = watched;
-      break;
+  for (int i = 0; i < num_events; i++) {
+    auto it = watched_.find(static_cast<const FileInstance*>(events[i].data.ptr));
+    // Deleted since epoll_wait returned.
+    if (it != watched_.end()) {
+      ret.push_back(EpollEvent{.fd = it->second, .events = events[i].events});
     }
   }
-  if (!ret.fd->IsOpen()) {
-    // Couldn't find the matching SharedFD to the file descriptor. We probably
-    // lost the race to lock watched_mutex_ against a delete call. Treat this
-    // as a spurious wakeup.
-    return {};
-  }
   return ret;
 }
 
@@ -16,11 +16,14 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <sys/epoll.h>
 
+#include <chrono>
 #include <optional>
-#include <set>
 #include <shared_mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/result/result.h"
@@ -42,8 +45,15 @@ class Epoll {
   Result<void> Add(SharedFD fd, uint32_t events);
   Result<void> Modify(SharedFD fd, uint32_t events);
   Result<void> AddOrModify(SharedFD fd, uint32_t events);
+  // Also succeeds if `fd` was closed already, but as long as other file
+  // descriptors refer to the same file only deleting it before closing it stops
+  // events from being reported.
   Result<void> Delete(SharedFD fd);
   Result<std::optional<EpollEvent>> Wait();
+  // Returns the events of up to `max_events` file descriptors, or none once
+  // `timeout` expired. Waits forever without a `timeout`.
+  Result<std::vector<EpollEvent>> Wait(
+      std::optional<std::chrono::milliseconds> timeout, size_t max_events);
 
  private:
   Epoll(SharedFD);
@@ -51,10 +61,13 @@ class Epoll {
   SharedFD epoll_fd_;
   /**
    * This read-write mutex is read-locked when interacting with it as a const
-   * std::set, and write-locked when interacting with it as a std::set.
+   * std::unordered_map, and write-locked when interacting with it as a
+   * std::unordered_map.
    */
   std::shared_mutex watched_mutex_;
-  std::set<SharedFD> watched_;
+  // The epoll user data is the FileInstance, as the file descriptor number may
+  // be reused once a watched SharedFD is closed.
+  std::unordered_map<const FileInstance*, SharedFD> watched_;
 };
 
 }  // namespace cuttlefish
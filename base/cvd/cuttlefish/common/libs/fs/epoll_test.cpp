@@ -0,0 +1,101 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/common/libs/fs/epoll.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+using std::chrono::milliseconds;
+
+class EpollTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    Result<Epoll> epoll = Epoll::Create();
+    ASSERT_TRUE(epoll.ok()) << epoll.error().Message();
+    epoll_ = std::move(*epoll);
+    ASSERT_TRUE(SharedFD::Pipe(&read_end_, &write_end_));
+  }
+
+  Epoll epoll_;
+  SharedFD read_end_;
+  SharedFD write_end_;
+};
+
+TEST_F(EpollTest, WaitReturnsAllReadyFds) {
+  SharedFD other_read, other_write;
+  ASSERT_TRUE(SharedFD::Pipe(&other_read, &other_write));
+  ASSERT_TRUE(epoll_.Add(read_end_, EPOLLIN).ok());
+  ASSERT_TRUE(epoll_.Add(other_read, EPOLLIN).ok());
+  ASSERT_EQ(write_end_->Write("a", 1), 1);
+  ASSERT_EQ(other_write->Write("b", 1), 1);
+
+  Result<std::vector<EpollEvent>> events = epoll_.Wait(milliseconds(0), 4);
+  ASSERT_TRUE(events.ok()) << events.error().Message();
+  ASSERT_EQ(events->size(), 2u);
+  EXPECT_NE((*events)[0].fd, (*events)[1].fd);
+  for (const EpollEvent& event : *events) {
+    EXPECT_TRUE(event.fd == read_end_ || event.fd == other_read);
+    EXPECT_TRUE(event.events & EPOLLIN);
+  }
+}
+
+TEST_F(EpollTest, WaitTimesOut) {
+  ASSERT_TRUE(epoll_.Add(read_end_, EPOLLIN).ok());
+
+  Result<std::vector<EpollEvent>> events = epoll_.Wait(milliseconds(10), 1);
+  ASSERT_TRUE(events.ok()) << events.error().Message();
+  EXPECT_TRUE(events->empty());
+}
+
+TEST_F(EpollTest, DeleteBeforeCloseStopsDuplicates) {
+  // Keeps the pipe open after `read_end_` is closed.
+  int raw_duplicate = read_end_->UNMANAGED_Dup();
+  SharedFD duplicate = SharedFD::Dup(raw_duplicate);
+  close(raw_duplicate);
+  ASSERT_TRUE(duplicate->IsOpen());
+  ASSERT_TRUE(epoll_.Add(read_end_, EPOLLIN).ok());
+  ASSERT_TRUE(epoll_.Delete(read_end_).ok());
+  read_end_->Close();
+  ASSERT_EQ(write_end_->Write("a", 1), 1);
+
+  // Deleting from the map alone would hide the event, the kernel would still
+  // report it.
+  Result<std::vector<EpollEvent>> events = epoll_.Wait(milliseconds(0), 1);
+  ASSERT_TRUE(events.ok()) << events.error().Message();
+  EXPECT_TRUE(events->empty());
+}
+
+TEST_F(EpollTest, ClosedFdCanBeDeleted) {
+  ASSERT_TRUE(epoll_.Add(read_end_, EPOLLIN).ok());
+  read_end_->Close();
+
+  EXPECT_TRUE(epoll_.Delete(read_end_).ok());
+  EXPECT_FALSE(epoll_.Delete(read_end_).ok());
+}
+
+}  // namespace
+}  // namespace cuttlefish
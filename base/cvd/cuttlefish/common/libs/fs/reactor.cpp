@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "cuttlefish/common/libs/fs/epoll.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr size_t kMaxEvents = 64;
+
+}  // namespace
+
+Result<std::unique_ptr<Reactor>> Reactor::Create() {
+  Epoll epoll = CF_EXPECT(Epoll::Create());
+  SharedFD wake_fd = SharedFD::Event(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  CF_EXPECTF(wake_fd->IsOpen(), "Failed to create eventfd: {}",
+             wake_fd->StrError());
+  CF_EXPECT(epoll.Add(wake_fd, EPOLLIN));
+  return std::unique_ptr<Reactor>(new Reactor(std::move(epoll), wake_fd));
+}
+
+Reactor::Reactor(Epoll epoll, SharedFD wake_fd)
+    : epoll_(std::move(epoll)), wake_fd_(std::move(wake_fd)) {}
+
+Result<void> Reactor::Watch(SharedFD fd, uint32_t events,
+                            FdCallback callback) {
+  CF_EXPECT(fd->IsOpen(), "Can't watch a closed file descriptor");
+  std::lock_guard lock(mutex_);
+  CF_EXPECT(callbacks_.count(fd) == 0, "File descriptor is already watched");
+  CF_EXPECT(epoll_.Add(fd, events));
+  callbacks_[fd] = std::make_shared<FdCallback>(std::move(callback));
+  return {};
+}
+
+Result<void> Reactor::Modify(SharedFD fd, uint32_t events) {
+  std::lock_guard lock(mutex_);
+  CF_EXPECT(callbacks_.count(fd) != 0, "File descriptor is not watched");
+  CF_EXPECT(epoll_.Modify(fd, events));
+  return {};
+}
+
+Result<void> Reactor::Unwatch(SharedFD fd) {
+  std::lock_guard lock(mutex_);
+  CF_EXPECT(callbacks_.erase(fd) != 0, "File descriptor is not watched");
+  CF_EXPECT(epoll_.Delete(fd));
+  return {};
+}
+
+Reactor::TimerId Reactor::ScheduleAfter(
+    std::chrono::steady_clock::duration delay, Task task) {
+  std::lock_guard lock(mutex_);
+  TimerId id = next_id_++;
+  timers_.push(Timer{
+      .deadline = std::chrono::steady_clock::now() + delay,
+      .id = id,
+  });
+  timer_tasks_[id] = std::move(task);
+  Wake();
+  return id;
+}
+
+void Reactor::Cancel(TimerId timer) {
+  std::lock_guard lock(mutex_);
+  timer_tasks_.erase(timer);
+}
+
+void Reactor::Post(Task task) {
+  std::lock_guard lock(mutex_);
+  tasks_.emplace_back(std::move(task));
+  Wake();
+}
+
+void Reactor::Stop() {
+  std::lock_guard lock(mutex_);
+  stopping_ = true;
+  Wake();
+}
+
+void Reactor::Wake() {
+  // Can only fail if the counter overflows, in which case it is readable
+  // anyway.
+  wake_fd_->EventfdWrite(1);
+}
+
+std::optional<std::chrono::milliseconds> Reactor::NextTimeout() {
+  if (!tasks_.empty()) {
+    return std::chrono::milliseconds(0);
+  }
+  while (!timers_.empty() && timer_tasks_.count(timers_.top().id) == 0) {
+    timers_.pop();
+  }
+  if (timers_.empty()) {
+    return std::nullopt;
+  }
+  auto timeout = std::chrono::ceil<std::chrono::milliseconds>(
+      timers_.top().deadline - std::chrono::steady_clock::now());
+  return std::max(timeout, std::chrono::milliseconds(0));
+}
+
+Result<void> Reactor::Run() {
+  while (true) {
+    std::optional<std::chrono::milliseconds> timeout;
+    {
+      std::lock_guard lock(mutex_);
+      if (stopping_) {
+        stopping_ = false;
+        return {};
+      }
+      timeout = NextTimeout();
+    }
+    std::vector<EpollEvent> events =
+        CF_EXPECT(epoll_.Wait(timeout, kMaxEvents));
+
+    for (const EpollEvent& event : events) {
+      if (event.fd == wake_fd_) {
+        eventfd_t value;
+        wake_fd_->EventfdRead(&value);
+        continue;
+      }
+      std::shared_ptr<FdCallback> callback;
+      {
+        std::lock_guard lock(mutex_);
+        auto it = callbacks_.find(event.fd);
+        // Unwatched by an earlier callback.
+        if (it == callbacks_.end()) {
+          continue;
+        }
+        callback = it->second;
+      }
+      (*callback)(event.events);
+    }
+    RunDueTimers();
+    RunPostedTasks();
+  }
+}
+
+void Reactor::RunDueTimers() {
+  auto now = std::chrono::steady_clock::now();
+  while (true) {
+    Task task;
+    {
+      std::lock_guard lock(mutex_);
+      if (timers_.empty() || timers_.top().deadline > now) {
+        return;
+      }
+      auto it = timer_tasks_.find(timers_.top().id);
+      timers_.pop();
+      if (it == timer_tasks_.end()) {
+        continue;
+      }
+      task = std::move(it->second);
+      timer_tasks_.erase(it);
+    }
+    task();
+  }
+}
+
+void Reactor::RunPostedTasks() {
+  std::vector<Task> tasks;
+  {
+    std::lock_guard lock(mutex_);
+    tasks.swap(tasks_);
+  }
+  // Tasks posted by these run in the next iteration.
+  for (Task& task : tasks) {
+    task();
+  }
+}
+
+}  // namespace cuttlefish
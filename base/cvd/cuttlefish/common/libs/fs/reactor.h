@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/epoll.h>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "cuttlefish/common/libs/fs/epoll.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+/**
+ * Event loop dispatching file descriptor readiness, timers and tasks posted
+ * from other threads to callbacks, all on the thread calling `Run`.
+ *
+ * Meant to replace per-connection threads and `Select` loops: a daemon
+ * registers all of its file descriptors with a single reactor and handles them
+ * from one thread. Each wakeup costs O(ready descriptors) instead of O(watched
+ * descriptors), and there is no FD_SETSIZE limit.
+ *
+ * All methods are safe to call from any thread, including from callbacks.
+ * Once `Unwatch` or `Cancel` returns on the reactor thread, the affected
+ * callback is not called again; from other threads a call already in progress
+ * may still finish.
+ */
+class Reactor {
+ public:
+  // Receives the epoll events that happened, e.g. EPOLLIN | EPOLLHUP.
+  using FdCallback = std::function<void(uint32_t events)>;
+  using Task = std::function<void()>;
+  using TimerId = uint64_t;
+
+  static Result<std::unique_ptr<Reactor>> Create();
+
+  Reactor(const Reactor&) = delete;
+  Reactor& operator=(const Reactor&) = delete;
+
+  /**
+   * Calls `callback` whenever any of `events` is reported for `fd`. EPOLLERR
+   * and EPOLLHUP are always reported.
+   *
+   * Notifications are level-triggered unless `events` includes EPOLLET, in
+   * which case `fd` should be non-blocking and the callback has to consume
+   * everything available, i.e. until EAGAIN, to be called again.
+   */
+  Result<void> Watch(SharedFD fd, uint32_t events, FdCallback callback);
+  Result<void> Modify(SharedFD fd, uint32_t events);
+  // Unwatch before closing `fd`, if other file descriptors refer to the same
+  // file it keeps being reported otherwise. Still succeeds if it was closed.
+  Result<void> Unwatch(SharedFD fd);
+
+  // Calls `task` once, `delay` from now.
+  TimerId ScheduleAfter(std::chrono::steady_clock::duration delay, Task task);
+  // Does nothing if the timer fired already.
+  void Cancel(TimerId timer);
+
+  // Calls `task` on the reactor thread as soon as possible.
+  void Post(Task task);
+
+  // Dispatches events until `Stop` is called. Can be called again afterwards.
+  Result<void> Run();
+  // Makes `Run` return after dispatching what is already pending.
+  void Stop();
+
+ private:
+  struct Timer {
+    std::chrono::steady_clock::time_point deadline;
+    TimerId id;
+
+    bool operator>(const Timer& other) const {
+      return deadline > other.deadline;
+    }
+  };
+
+  Reactor(Epoll epoll, SharedFD wake_fd);
+
+  void Wake();
+  // Requires `mutex_` to be held.
+  std::optional<std::chrono::milliseconds> NextTimeout();
+  void RunDueTimers();
+  void RunPostedTasks();
+
+  Epoll epoll_;
+  SharedFD wake_fd_;
+
+  std::mutex mutex_;
+  TimerId next_id_ = 1;
+  // Events are matched by SharedFD rather than file descriptor number, so a
+  // stale event for a number that was reused can't reach the new callback.
+  std::map<SharedFD, std::shared_ptr<FdCallback>> callbacks_;
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+  // Cancelled timers are only removed from here, they are skipped when they
+  // reach the top of `timers_`.
+  std::unordered_map<TimerId, Task> timer_tasks_;
+  std::vector<Task> tasks_;
+  bool stopping_ = false;
+};
+
+}  // namespace cuttlefish
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+using std::chrono::milliseconds;
+
+class ReactorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    Result<std::unique_ptr<Reactor>> reactor = Reactor::Create();
+    ASSERT_TRUE(reactor.ok()) << reactor.error().Message();
+    reactor_ = std::move(*reactor);
+    ASSERT_TRUE(SharedFD::Pipe(&read_end_, &write_end_));
+  }
+
+  std::unique_ptr<Reactor> reactor_;
+  SharedFD read_end_;
+  SharedFD write_end_;
+};
+
+TEST_F(ReactorTest, DispatchesReadableFd) {
+  std::string received;
+  ASSERT_TRUE(reactor_
+                  ->Watch(read_end_, EPOLLIN,
+                          [this, &received](uint32_t events) {
+                            EXPECT_TRUE(events & EPOLLIN);
+                            char c;
+                            ASSERT_EQ(read_end_->Read(&c, 1), 1);
+                            received += c;
+                            if (received.size() == 3) {
+                              reactor_->Stop();
+                            }
+                          })
+                  .ok());
+  // Level-triggered, so one byte per call gets everything.
+  ASSERT_EQ(write_end_->Write("abc", 3), 3);
+  ASSERT_TRUE(reactor_->Run().ok());
+  EXPECT_EQ(received, "abc");
+}
+
+TEST_F(ReactorTest, EdgeTriggeredFiresOncePerWrite) {
+  ASSERT_EQ(read_end_->Fcntl(F_SETFL, O_NONBLOCK), 0);
+  int calls = 0;
+  ASSERT_TRUE(reactor_
+                  ->Watch(read_end_, EPOLLIN | EPOLLET,
+                          [&calls](uint32_t) { calls++; })
+                  .ok());
+  ASSERT_EQ(write_end_->Write("a", 1), 1);
+  reactor_->ScheduleAfter(milliseconds(50), [this]() { reactor_->Stop(); });
+  ASSERT_TRUE(reactor_->Run().ok());
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(ReactorTest, UnwatchedFdIsNotDispatched) {
+  int calls = 0;
+  ASSERT_TRUE(
+      reactor_->Watch(read_end_, EPOLLIN, [&calls](uint32_t) { calls++; })
+          .ok());
+  ASSERT_TRUE(reactor_->Unwatch(read_end_).ok());
+  ASSERT_EQ(write_end_->Write("a", 1), 1);
+  reactor_->ScheduleAfter(milliseconds(50), [this]() { reactor_->Stop(); });
+  ASSERT_TRUE(reactor_->Run().ok());
+  EXPECT_EQ(calls, 0);
+
+  // Can be watched again, and unwatched after being closed.
+  EXPECT_TRUE(reactor_->Watch(read_end_, EPOLLIN, [](uint32_t) {}).ok());
+  read_end_->Close();
+  EXPECT_TRUE(reactor_->Unwatch(read_end_).ok());
+}
+
+TEST_F(ReactorTest, TimersFireInDeadlineOrder) {
+  std::vector<int> fired;
+  reactor_->ScheduleAfter(milliseconds(30), [&fired]() { fired.push_back(3); });
+  reactor_->ScheduleAfter(milliseconds(10), [&fired]() { fired.push_back(1); });
+  Reactor::TimerId cancelled = reactor_->ScheduleAfter(
+      milliseconds(20), [&fired]() { fired.push_back(2); });
+  reactor_->ScheduleAfter(milliseconds(40), [this]() { reactor_->Stop(); });
+  reactor_->Cancel(cancelled);
+
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(reactor_->Run().ok());
+  EXPECT_GE(std::chrono::steady_clock::now() - start, milliseconds(40));
+  EXPECT_EQ(fired, (std::vector<int>{1, 3}));
+}
+
+TEST_F(ReactorTest, PostWakesReactorFromOtherThread) {
+  std::thread::id ran_on;
+  std::thread poster([this, &ran_on]() {
+    std::this_thread::sleep_for(milliseconds(20));
+    reactor_->Post([this, &ran_on]() {
+      ran_on = std::this_thread::get_id();
+      reactor_->Stop();
+    });
+  });
+  ASSERT_TRUE(reactor_->Run().ok());
+  poster.join();
+  EXPECT_EQ(ran_on, std::this_thread::get_id());
+}
+
+TEST_F(ReactorTest, RunsAgainAfterStop) {
+  reactor_->Stop();
+  ASSERT_TRUE(reactor_->Run().ok());
+
+  bool ran = false;
+  reactor_->Post([this, &ran]() {
+    ran = true;
+    reactor_->Stop();
+  });
+  ASSERT_TRUE(reactor_->Run().ok());
+  EXPECT_TRUE(ran);
+}
+
+}  // namespace
+}  // namespace cuttlefish
@@ -29,6 +29,7 @@
 #include <sys/stat.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -1063,6 +1064,12 @@ ssize_t FileInstance::Write(const void* buf, size_t count) {
   return TEMP_FAILURE_RETRY(write(fd_, buf, count));
 }
 
+ssize_t FileInstance::Writev(const struct iovec* iov, int iovcnt) {
+  LocalErrno record_errno(errno_);
+
+  return TEMP_FAILURE_RETRY(writev(fd_, iov, iovcnt));
+}
+
 ssize_t FileInstance::PWrite(const void* buf, size_t count, size_t offset) {
   LocalErrno record_errno(errno_);
 
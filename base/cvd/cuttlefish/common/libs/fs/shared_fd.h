@@ -384,6 +384,8 @@ class FileInstance {
    *
    */
   ssize_t Write(const void* buf, size_t count);
+  // Like Write(), may write fewer bytes than the sum of the buffers.
+  ssize_t Writev(const struct iovec* iov, int iovcnt);
   ssize_t PWrite(const void* buf, size_t count, size_t offset);
 #ifdef __linux__
   int EventfdWrite(eventfd_t value);
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <stdint.h>
+
 namespace cuttlefish {
 namespace sensors {
 /*
@@ -50,6 +52,12 @@ inline constexpr int kMaxSensorId = 31;
 */
 using SensorsMask = int;
 
+// Check if a given sensor id provides scalar data
+inline constexpr bool IsScalarSensor(int id) {
+  return (id == kTemperatureId) || (id == kProximityId) || (id == kLightId) ||
+         (id == kPressureId) || (id == kHumidityId) || (id == kHingeAngle0Id);
+}
+
 inline constexpr char INNER_DELIM = ':';
 inline constexpr char OUTER_DELIM = ' ';
 
@@ -58,8 +66,29 @@ inline constexpr int kUpdateRotationVec = 0;
 inline constexpr int kGetSensorsData = 1;
 inline constexpr int kUpdateHal = 2;
 inline constexpr int kUpdateHingeAngle = 3;
+inline constexpr int kUpdateHalBatch = 4;
 
 using SensorsCmd = int;
 
+/*
+  Payload of kUpdateHalBatch: a header followed by `count` reports, in host
+  byte order. This replaces the one text message per sensor of kUpdateHal
+  once the guest HAL sends "report-format:batch" on the control channel.
+*/
+struct SensorsBatchHeader {
+  // CLOCK_MONOTONIC time on the host when the values were read.
+  uint64_t timestamp_ns;
+  uint32_t count;
+  uint32_t reserved;
+};
+static_assert(sizeof(SensorsBatchHeader) == 16);
+
+struct SensorReport {
+  uint32_t id;
+  // Scalar sensors only fill values[0].
+  float values[3];
+};
+static_assert(sizeof(SensorReport) == 16);
+
 }  // namespace sensors
 }  // namespace cuttlefish
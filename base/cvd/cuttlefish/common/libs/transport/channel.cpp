@@ -21,14 +21,91 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <vector>
+
 #include "cuttlefish/result/expect.h"
 #include "cuttlefish/result/result_type.h"
 
 namespace cuttlefish::transport {
 
+namespace {
+
+// Buffer sizes, header included, of the pooled size classes. HAL requests are
+// mostly well under a KB, the larger classes cover key blobs and certificate
+// chains. Bigger messages are allocated on demand.
+constexpr std::array<size_t, 5> kSizeClasses = {256, 1024, 4096, 16384, 65536};
+// Free buffers kept per size class. More than this are only in use during a
+// burst, they are returned to the system afterwards.
+constexpr size_t kMaxFreeBuffersPerClass = 32;
+
+class MessagePool {
+ public:
+  // Returns nullptr when `size` is too large to be pooled.
+  void* Allocate(size_t size, size_t& capacity) {
+    auto size_class =
+        std::lower_bound(kSizeClasses.begin(), kSizeClasses.end(), size);
+    if (size_class == kSizeClasses.end()) {
+      return nullptr;
+    }
+    capacity = *size_class;
+    FreeList& free_list = free_lists_[size_class - kSizeClasses.begin()];
+    {
+      std::lock_guard<std::mutex> lock(free_list.mutex);
+      if (!free_list.buffers.empty()) {
+        void* buffer = free_list.buffers.back();
+        free_list.buffers.pop_back();
+        return buffer;
+      }
+    }
+    return malloc(capacity);
+  }
+
+  void Release(void* buffer, size_t capacity) {
+    auto size_class =
+        std::lower_bound(kSizeClasses.begin(), kSizeClasses.end(), capacity);
+    FreeList& free_list = free_lists_[size_class - kSizeClasses.begin()];
+    {
+      std::lock_guard<std::mutex> lock(free_list.mutex);
+      if (free_list.buffers.size() < kMaxFreeBuffersPerClass) {
+        free_list.buffers.push_back(buffer);
+        return;
+      }
+    }
+    free(buffer);
+  }
+
+ private:
+  struct FreeList {
+    FreeList() { buffers.reserve(kMaxFreeBuffersPerClass); }
+
+    std::mutex mutex;
+    std::vector<void*> buffers;
+  };
+
+  std::array<FreeList, kSizeClasses.size()> free_lists_;
+};
+
+// Never destroyed, messages may outlive static destructors.
+MessagePool& Pool() {
+  static MessagePool* pool = new MessagePool();
+  return *pool;
+}
+
+}  // namespace
+
 void MessageDestroyer::operator()(RawMessage* ptr) {
-  memset(ptr, 0, sizeof(RawMessage) + ptr->payload_size);
-  free(ptr);
+  if (capacity_ == 0) {
+    memset(ptr, 0, sizeof(RawMessage) + ptr->payload_size);
+    free(ptr);
+    return;
+  }
+  // Only the used part needs wiping, pooled buffers are released clean.
+  memset(ptr, 0,
+         std::min(capacity_, sizeof(RawMessage) + ptr->payload_size));
+  Pool().Release(ptr, capacity_);
 }
 
 /**
@@ -38,7 +115,12 @@ void MessageDestroyer::operator()(RawMessage* ptr) {
 Result<ManagedMessage> CreateMessage(uint32_t command, bool is_response,
                                      size_t payload_size) {
   const size_t bytes_to_allocate = sizeof(RawMessage) + payload_size;
-  void* memory = malloc(bytes_to_allocate);
+  size_t capacity = 0;
+  void* memory = Pool().Allocate(bytes_to_allocate, capacity);
+  if (memory == nullptr) {
+    capacity = 0;
+    memory = malloc(bytes_to_allocate);
+  }
   CF_EXPECTF(memory != nullptr,
              "Cannot allocate {} bytes for secure_env RPC message",
              bytes_to_allocate);
@@ -46,7 +128,7 @@ Result<ManagedMessage> CreateMessage(uint32_t command, bool is_response,
   message->command = command;
   message->is_response = is_response;
   message->payload_size = payload_size;
-  return ManagedMessage(message);
+  return ManagedMessage(message, MessageDestroyer(capacity));
 }
 
 Result<ManagedMessage> CreateMessage(uint32_t command, size_t payload_size) {
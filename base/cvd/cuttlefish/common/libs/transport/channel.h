@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
 
 #include "cuttlefish/result/result_type.h"
@@ -41,11 +44,21 @@ struct RawMessage {
 /**
  * A destroyer for RawMessage instances created with
  * CreateMessage. Wipes memory from the RawMessage
- * instances.
+ * instances and returns pooled buffers to their size
+ * class.
+ *
+ * @capacity: size of the pooled buffer holding the message,
+ * or 0 for messages allocated with malloc.
  */
 class MessageDestroyer {
  public:
+  MessageDestroyer() = default;
+  explicit MessageDestroyer(size_t capacity) : capacity_(capacity) {}
+
   void operator()(RawMessage* ptr);
+
+ private:
+  size_t capacity_ = 0;
 };
 
 /** An owning pointer for a RawMessage instance. */
@@ -53,7 +66,9 @@ using ManagedMessage = std::unique_ptr<RawMessage, MessageDestroyer>;
 
 /**
  * Allocates memory for a RawMessage carrying a message of size
- * `payload_size`.
+ * `payload_size`. Messages up to a few tens of KB are served
+ * from a process wide pool of reusable buffers, so a steady
+ * stream of messages doesn't allocate.
  */
 Result<ManagedMessage> CreateMessage(uint32_t command, bool is_response,
                                      size_t payload_size);
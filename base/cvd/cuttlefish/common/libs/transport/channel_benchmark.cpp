@@ -0,0 +1,109 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures message throughput of SharedFdChannel over a socket pair, both
+// streaming in one direction and as request/response round trips like the
+// secure_env HALs do, for a range of payload sizes.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <string>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/transport/channel.h"
+#include "cuttlefish/common/libs/transport/channel_sharedfd.h"
+
+namespace cuttlefish::transport {
+namespace {
+
+constexpr uint32_t kStopCommand = 0;
+constexpr uint32_t kDataCommand = 1;
+
+void BM_CreateMessage(benchmark::State& state) {
+  for (auto _ : state) {
+    auto message = CreateMessage(kDataCommand, state.range(0));
+    benchmark::DoNotOptimize(message->get());
+  }
+}
+BENCHMARK(BM_CreateMessage)->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+void BM_Stream(benchmark::State& state) {
+  SharedFD sender_fd;
+  SharedFD receiver_fd;
+  SharedFD::SocketPair(AF_UNIX, SOCK_STREAM, 0, &sender_fd, &receiver_fd);
+  SharedFdChannel sender(sender_fd, sender_fd);
+  SharedFdChannel receiver(receiver_fd, receiver_fd, /* read_ahead */ true);
+  std::string payload(state.range(0), 'p');
+
+  std::thread consumer([&receiver]() {
+    while (true) {
+      auto message = receiver.ReceiveMessage();
+      if (!message.ok() || (*message)->command == kStopCommand) {
+        return;
+      }
+    }
+  });
+  for (auto _ : state) {
+    if (!sender.SendRequest(kDataCommand, payload).ok()) {
+      state.SkipWithError("Failed to send");
+      break;
+    }
+  }
+  (void)sender.SendRequest(kStopCommand, "");
+  consumer.join();
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_Stream)->Arg(64)->Arg(1024)->Arg(64 * 1024)->UseRealTime();
+
+void BM_RoundTrip(benchmark::State& state) {
+  SharedFD client_fd;
+  SharedFD server_fd;
+  SharedFD::SocketPair(AF_UNIX, SOCK_STREAM, 0, &client_fd, &server_fd);
+  SharedFdChannel client(client_fd, client_fd);
+  SharedFdChannel server(server_fd, server_fd, /* read_ahead */ true);
+  std::string payload(state.range(0), 'r');
+
+  std::thread responder([&server]() {
+    while (true) {
+      auto request = server.ReceiveMessage();
+      if (!request.ok() || (*request)->command == kStopCommand) {
+        return;
+      }
+      if (!server.SendResponse(**request).ok()) {
+        return;
+      }
+    }
+  });
+  for (auto _ : state) {
+    if (!client.SendRequest(kDataCommand, payload).ok() ||
+        !client.ReceiveMessage().ok()) {
+      state.SkipWithError("Round trip failed");
+      break;
+    }
+  }
+  (void)client.SendRequest(kStopCommand, "");
+  responder.join();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RoundTrip)->Arg(64)->Arg(4096)->UseRealTime();
+
+}  // namespace
+}  // namespace cuttlefish::transport
@@ -18,8 +18,13 @@
 
 #include <poll.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
+#include <limits>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -32,9 +37,34 @@
 #include "cuttlefish/result/result_type.h"
 
 namespace cuttlefish::transport {
+namespace {
+
+// Large enough for dozens of typical HAL messages per read.
+constexpr size_t kReadBufferSize = 16 * 1024;
+
+Result<void> WriteAllIov(SharedFD& fd, struct iovec* iov, int iovcnt) {
+  while (iovcnt > 0) {
+    ssize_t written = fd->Writev(iov, iovcnt);
+    CF_EXPECT_GT(written, 0, "Could not write message: " << fd->StrError());
+    size_t remaining = written;
+    for (; iovcnt > 0 && remaining >= iov->iov_len; iov++, iovcnt--) {
+      remaining -= iov->iov_len;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+      iov->iov_len -= remaining;
+    }
+  }
+  return {};
+}
 
-SharedFdChannel::SharedFdChannel(SharedFD input, SharedFD output)
-    : input_(std::move(input)), output_(std::move(output)) {}
+}  // namespace
+
+SharedFdChannel::SharedFdChannel(SharedFD input, SharedFD output,
+                                 bool read_ahead)
+    : input_(std::move(input)),
+      output_(std::move(output)),
+      read_ahead_(read_ahead) {}
 
 Result<void> SharedFdChannel::SendRequest(RawMessage& message) {
   CF_EXPECT(SendMessage(message, false));
@@ -46,7 +76,57 @@ Result<void> SharedFdChannel::SendResponse(RawMessage& message) {
   return {};
 }
 
+Result<void> SharedFdChannel::SendRequest(uint32_t command,
+                                          std::string_view payload) {
+  CF_EXPECT(SendMessage(command, false, payload));
+  return {};
+}
+
+Result<void> SharedFdChannel::SendResponse(uint32_t command,
+                                           std::string_view payload) {
+  CF_EXPECT(SendMessage(command, true, payload));
+  return {};
+}
+
 Result<ManagedMessage> SharedFdChannel::ReceiveMessage() {
+  if (!read_ahead_) {
+    return CF_EXPECT(ReceiveMessageUnbuffered());
+  }
+  if (read_buffer_.empty()) {
+    read_buffer_.resize(kReadBufferSize);
+  }
+  CF_EXPECT(FillReadBuffer(sizeof(RawMessage)));
+  struct RawMessage message_header;
+  memcpy(&message_header, read_buffer_.data() + read_begin_,
+         sizeof(RawMessage));
+  read_begin_ += sizeof(RawMessage);
+  VLOG(0) << "Received message with id: " << message_header.command;
+
+  ManagedMessage message = CF_EXPECT(
+      CreateMessage(message_header.command, message_header.is_response,
+                    message_header.payload_size));
+  char* message_bytes = reinterpret_cast<char*>(message->payload);
+  const size_t payload_size = message->payload_size;
+  if (payload_size <= read_buffer_.size()) {
+    CF_EXPECT(FillReadBuffer(payload_size));
+    memcpy(message_bytes, read_buffer_.data() + read_begin_, payload_size);
+    read_begin_ += payload_size;
+    return message;
+  }
+
+  // Too large for the buffer, the rest goes straight into the message.
+  const size_t buffered = Buffered();
+  memcpy(message_bytes, read_buffer_.data() + read_begin_, buffered);
+  read_begin_ = read_end_ = 0;
+  ssize_t read =
+      ReadExact(input_, message_bytes + buffered, payload_size - buffered);
+  CF_EXPECT(read == payload_size - buffered,
+            "Could not read message: " << input_->StrError());
+
+  return message;
+}
+
+Result<ManagedMessage> SharedFdChannel::ReceiveMessageUnbuffered() {
   struct RawMessage message_header;
   ssize_t read = ReadExactBinary(input_, &message_header);
   CF_EXPECT(read == sizeof(RawMessage),
@@ -66,6 +146,9 @@ Result<ManagedMessage> SharedFdChannel::ReceiveMessage() {
 }
 
 Result<int> SharedFdChannel::WaitForMessage() {
+  if (Buffered() > 0) {
+    return 1;
+  }
   std::vector<PollSharedFd> input_poll = {
       {.fd = input_, .events = POLLIN},  // NOLINT(misc-include-cleaner): poll.h
   };
@@ -87,4 +170,44 @@ Result<void> SharedFdChannel::SendMessage(RawMessage& message, bool response) {
   return {};
 }
 
+Result<void> SharedFdChannel::SendMessage(uint32_t command, bool response,
+                                          std::string_view payload) {
+  CF_EXPECT_LE(payload.size(), std::numeric_limits<uint32_t>::max());
+  struct RawMessage header;
+  header.command = command;
+  header.is_response = response;
+  header.payload_size = payload.size();
+  struct iovec iov[] = {
+      {.iov_base = &header, .iov_len = sizeof(header)},
+      {.iov_base = const_cast<char*>(payload.data()),
+       .iov_len = payload.size()},
+  };
+  CF_EXPECT(WriteAllIov(output_, iov, 2));
+  return {};
+}
+
+Result<void> SharedFdChannel::FillReadBuffer(size_t size) {
+  if (Buffered() >= size) {
+    return {};
+  }
+  if (read_begin_ + size > read_buffer_.size()) {
+    memmove(read_buffer_.data(), read_buffer_.data() + read_begin_,
+            Buffered());
+    read_end_ -= read_begin_;
+    read_begin_ = 0;
+  }
+  while (Buffered() < size) {
+    // Takes whatever is queued, possibly several messages at once.
+    ssize_t read = input_->Read(read_buffer_.data() + read_end_,
+                                read_buffer_.size() - read_end_);
+    CF_EXPECT(read > 0,
+              "Expected " << size << ", received " << Buffered() << "\n"
+                          << "Could not read message: "
+                          << (read == 0 ? "end of stream"
+                                        : input_->StrError()));
+    read_end_ += read;
+  }
+  return {};
+}
+
 }  // namespace cuttlefish::transport
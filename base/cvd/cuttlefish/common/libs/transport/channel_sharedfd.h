@@ -16,24 +16,56 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string_view>
+#include <vector>
+
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/common/libs/transport/channel.h"
 
 namespace cuttlefish::transport {
 
+/*
+ * Channel over a pair of stream file descriptors.
+ *
+ * With `read_ahead`, a single read pulls in as many queued messages as fit
+ * in the receive buffer, later calls to ReceiveMessage are served from it
+ * without a syscall. Messages buffered that way are not visible on the input
+ * anymore, so only enable it if the input is waited on through
+ * WaitForMessage and the channel lives as long as the input is read. Without
+ * it, the header and payload are read straight into the message.
+ */
 class SharedFdChannel : public Channel {
  public:
-  SharedFdChannel(SharedFD input, SharedFD output);
+  SharedFdChannel(SharedFD input, SharedFD output, bool read_ahead = false);
   Result<void> SendRequest(RawMessage& message) override;
   Result<void> SendResponse(RawMessage& message) override;
+  // Sends the header and payload with a single gathering write, without
+  // copying the payload into a RawMessage first.
+  Result<void> SendRequest(uint32_t command, std::string_view payload);
+  Result<void> SendResponse(uint32_t command, std::string_view payload);
   Result<ManagedMessage> ReceiveMessage() override;
   Result<int> WaitForMessage() override;
 
  private:
   SharedFD input_;
   SharedFD output_;
+  bool read_ahead_;
+  // Bytes received but not consumed yet are in [read_begin_, read_end_).
+  std::vector<char> read_buffer_;
+  size_t read_begin_ = 0;
+  size_t read_end_ = 0;
 
+  Result<ManagedMessage> ReceiveMessageUnbuffered();
   Result<void> SendMessage(RawMessage& message, bool response);
+  Result<void> SendMessage(uint32_t command, bool response,
+                           std::string_view payload);
+  // Reads ahead until at least `size` bytes are buffered, `size` must fit in
+  // the buffer.
+  Result<void> FillReadBuffer(size_t size);
+  size_t Buffered() const { return read_end_ - read_begin_; }
 };
 
 }  // namespace cuttlefish::transport
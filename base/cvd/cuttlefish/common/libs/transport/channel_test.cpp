@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/common/libs/transport/channel.h"
+
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/transport/channel_sharedfd.h"
+
+namespace cuttlefish::transport {
+namespace {
+
+std::string Payload(const ManagedMessage& message) {
+  return std::string(reinterpret_cast<const char*>(message->payload),
+                     message->payload_size);
+}
+
+// The wire format of a message, to send several with a single write.
+std::string Serialize(uint32_t command, const std::string& payload) {
+  RawMessage header;
+  header.command = command;
+  header.is_response = false;
+  header.payload_size = payload.size();
+  return std::string(reinterpret_cast<const char*>(&header), sizeof(header)) +
+         payload;
+}
+
+bool IsReadable(SharedFD fd) {
+  std::vector<PollSharedFd> poll_fds = {{.fd = fd, .events = POLLIN}};
+  return SharedFD::Poll(poll_fds, 0) == 1;
+}
+
+// The parameter is whether the receiver reads ahead.
+class SharedFdChannelTest : public testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(SharedFD::SocketPair(AF_UNIX, SOCK_STREAM, 0, &sender_fd_,
+                                     &receiver_fd_));
+    sender_.emplace(sender_fd_, sender_fd_);
+    receiver_.emplace(receiver_fd_, receiver_fd_, GetParam());
+  }
+
+  SharedFD sender_fd_;
+  SharedFD receiver_fd_;
+  std::optional<SharedFdChannel> sender_;
+  std::optional<SharedFdChannel> receiver_;
+};
+
+INSTANTIATE_TEST_SUITE_P(ReadAhead, SharedFdChannelTest, testing::Bool());
+
+TEST(CreateMessageTest, ReusesPooledBuffers) {
+  auto first = CreateMessage(1, 100);
+  ASSERT_TRUE(first.ok());
+  RawMessage* first_address = first->get();
+  first->reset();
+
+  auto second = CreateMessage(2, 120);
+  ASSERT_TRUE(second.ok());
+  EXPECT_EQ(second->get(), first_address);
+  EXPECT_EQ((*second)->command, 2);
+  EXPECT_EQ((*second)->payload_size, 120);
+}
+
+TEST(CreateMessageTest, LargeMessage) {
+  constexpr size_t kSize = 1 << 20;
+  auto message = CreateMessage(1, true, kSize);
+  ASSERT_TRUE(message.ok());
+  EXPECT_TRUE((*message)->is_response);
+  memset((*message)->payload, 'x', kSize);
+}
+
+TEST_P(SharedFdChannelTest, ReceivesQueuedMessagesInOrder) {
+  for (uint32_t i = 0; i < 100; i++) {
+    ASSERT_TRUE(sender_->SendRequest(i, std::to_string(i)).ok());
+  }
+  for (uint32_t i = 0; i < 100; i++) {
+    ASSERT_TRUE(receiver_->WaitForMessage().ok());
+    auto message = receiver_->ReceiveMessage();
+    ASSERT_TRUE(message.ok()) << message.error();
+    EXPECT_EQ((*message)->command, i);
+    EXPECT_FALSE((*message)->is_response);
+    EXPECT_EQ(Payload(*message), std::to_string(i));
+  }
+}
+
+TEST_P(SharedFdChannelTest, ReceivesMessagesLargerThanTheBuffer) {
+  std::string large(100 * 1024, 'l');
+  auto message = CreateMessage(7, large.size());
+  ASSERT_TRUE(message.ok());
+  memcpy((*message)->payload, large.data(), large.size());
+
+  // The socket buffer may be smaller than what's sent.
+  std::thread sender([this, &message]() {
+    EXPECT_TRUE(sender_->SendResponse(**message).ok());
+    EXPECT_TRUE(sender_->SendResponse(8, "small").ok());
+  });
+  auto received = receiver_->ReceiveMessage();
+  ASSERT_TRUE(received.ok()) << received.error();
+  EXPECT_EQ((*received)->command, 7);
+  EXPECT_TRUE((*received)->is_response);
+  EXPECT_EQ(Payload(*received), large);
+
+  received = receiver_->ReceiveMessage();
+  ASSERT_TRUE(received.ok()) << received.error();
+  EXPECT_EQ((*received)->command, 8);
+  EXPECT_EQ(Payload(*received), "small");
+  sender.join();
+}
+
+TEST_P(SharedFdChannelTest, EmptyPayload) {
+  ASSERT_TRUE(sender_->SendRequest(3, "").ok());
+  auto message = receiver_->ReceiveMessage();
+  ASSERT_TRUE(message.ok()) << message.error();
+  EXPECT_EQ((*message)->command, 3);
+  EXPECT_EQ((*message)->payload_size, 0);
+}
+
+TEST_P(SharedFdChannelTest, ReceivesMessagesSentInOneWrite) {
+  const std::string both = Serialize(1, "first") + Serialize(2, "second");
+  ASSERT_EQ(sender_fd_->Write(both.data(), both.size()), both.size());
+
+  ASSERT_TRUE(receiver_->WaitForMessage().ok());
+  auto message = receiver_->ReceiveMessage();
+  ASSERT_TRUE(message.ok()) << message.error();
+  EXPECT_EQ((*message)->command, 1);
+  EXPECT_EQ(Payload(*message), "first");
+
+  ASSERT_TRUE(receiver_->WaitForMessage().ok());
+  message = receiver_->ReceiveMessage();
+  ASSERT_TRUE(message.ok()) << message.error();
+  EXPECT_EQ((*message)->command, 2);
+  EXPECT_EQ(Payload(*message), "second");
+  EXPECT_FALSE(IsReadable(receiver_fd_));
+}
+
+TEST(SharedFdChannelNoReadAheadTest, LeavesLaterMessagesOnTheInput) {
+  SharedFD sender;
+  SharedFD receiver;
+  ASSERT_TRUE(SharedFD::SocketPair(AF_UNIX, SOCK_STREAM, 0, &sender, &receiver));
+  const std::string both = Serialize(1, "first") + Serialize(2, "second");
+  ASSERT_EQ(sender->Write(both.data(), both.size()), both.size());
+
+  // Callers polling the input directly must still see the second message,
+  // also once the channel that received the first one is gone.
+  {
+    SharedFdChannel channel(receiver, receiver);
+    auto message = channel.ReceiveMessage();
+    ASSERT_TRUE(message.ok()) << message.error();
+    EXPECT_EQ(Payload(*message), "first");
+  }
+  EXPECT_TRUE(IsReadable(receiver));
+
+  SharedFdChannel channel(receiver, receiver);
+  auto message = channel.ReceiveMessage();
+  ASSERT_TRUE(message.ok()) << message.error();
+  EXPECT_EQ(Payload(*message), "second");
+}
+
+}  // namespace
+}  // namespace cuttlefish::transport
@@ -0,0 +1,429 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/common/libs/utils/async_log_writer.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fmt/format.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+
+namespace cuttlefish {
+namespace {
+
+// How long the writer lets lines accumulate after a write, so that a burst of
+// lines shares one writev.
+constexpr auto kBatchWindow = std::chrono::milliseconds(5);
+
+// Set in a forked child, which doesn't inherit the writer thread.
+std::atomic<bool> forked_child = false;
+
+std::atomic<uint64_t> next_writer_id = 0;
+
+void StripColorCodes(std::string_view line, std::string& out) {
+  bool in_color_code = false;
+  for (char c : line) {
+    if (c == '\033') {
+      in_color_code = true;
+    }
+    if (!in_color_code) {
+      out.push_back(c);
+    }
+    if (c == 'm') {
+      in_color_code = false;
+    }
+  }
+}
+
+// Writes all of `iov`, giving up on the first error other than EINTR.
+void WriteAllv(SharedFD fd, std::vector<iovec>& iov) {
+  size_t index = 0;
+  while (index < iov.size()) {
+    int count = std::min<size_t>(iov.size() - index, IOV_MAX);
+    ssize_t written = fd->Writev(iov.data() + index, count);
+    if (written < 0) {
+      if (fd->GetErrno() == EINTR) {
+        continue;
+      }
+      return;
+    }
+    while (index < iov.size() && static_cast<size_t>(written) >=
+                                     iov[index].iov_len) {
+      written -= iov[index].iov_len;
+      index++;
+    }
+    if (written > 0) {
+      iov[index].iov_base = static_cast<char*>(iov[index].iov_base) + written;
+      iov[index].iov_len -= written;
+    }
+  }
+}
+
+}  // namespace
+
+struct AsyncLogWriter::Record {
+  uint64_t sequence;
+  TargetId target;
+  std::string_view line;
+};
+
+// A single producer, single consumer ring of (target, size, sequence, line)
+// records. Records are 8 byte aligned and never wrap: a record that doesn't
+// fit before the end of the ring is preceded by a padding record filling the
+// rest.
+class AsyncLogWriter::StagingBuffer {
+ public:
+  StagingBuffer() : data_(new char[kBufferSize]) {}
+
+  // Called by the owning thread only, with increasing sequence numbers.
+  bool TryPush(uint64_t sequence, TargetId target, std::string_view line) {
+    size_t needed = RecordSize(line.size());
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    size_t offset = head % kBufferSize;
+    size_t padding = kBufferSize - offset < needed ? kBufferSize - offset : 0;
+    if (kBufferSize - (head - tail) < padding + needed) {
+      return false;
+    }
+    if (padding) {
+      WriteHeader(offset, Header{kPadding, 0, 0});
+      head += padding;
+      offset = 0;
+    }
+    WriteHeader(offset,
+                Header{target, static_cast<uint32_t>(line.size()), sequence});
+    memcpy(&data_[offset + sizeof(Header)], line.data(), line.size());
+    head_.store(head + needed, std::memory_order_release);
+    return true;
+  }
+
+  bool Empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_relaxed);
+  }
+
+  // Called by the writer only. Appends the records staged so far with a
+  // sequence number below `sequence_limit` to `out`, they stay valid until
+  // Release.
+  void Peek(uint64_t sequence_limit, std::vector<Record>& out) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    while (pos < head) {
+      size_t offset = pos % kBufferSize;
+      Header header;
+      memcpy(&header, &data_[offset], sizeof(header));
+      if (header.target == kPadding) {
+        pos += kBufferSize - offset;
+        continue;
+      }
+      if (header.sequence >= sequence_limit) {
+        break;
+      }
+      out.push_back(Record{
+          header.sequence, header.target,
+          std::string_view(&data_[offset + sizeof(Header)], header.size)});
+      pos += RecordSize(header.size);
+    }
+    peeked_ = pos;
+  }
+
+  // Frees the records returned by the last Peek.
+  void Release() { tail_.store(peeked_, std::memory_order_release); }
+
+  void Retire() { retired_ = true; }
+  bool Retired() const { return retired_; }
+
+ private:
+  struct Header {
+    TargetId target;
+    uint32_t size;
+    uint64_t sequence;
+  };
+  static constexpr TargetId kPadding = UINT32_MAX;
+
+  static size_t RecordSize(size_t line_size) {
+    return (sizeof(Header) + line_size + 7) & ~size_t{7};
+  }
+
+  void WriteHeader(size_t offset, Header header) {
+    memcpy(&data_[offset], &header, sizeof(header));
+  }
+
+  std::unique_ptr<char[]> data_;
+  // Separate cache lines, the producer and the writer each write one.
+  alignas(64) std::atomic<uint64_t> head_ = 0;
+  alignas(64) std::atomic<uint64_t> tail_ = 0;
+  uint64_t peeked_ = 0;
+  std::atomic<bool> retired_ = false;
+};
+
+AsyncLogWriter& AsyncLogWriter::Get() {
+  static AsyncLogWriter& writer = *[]() {
+    AsyncLogWriter* writer = new AsyncLogWriter();
+    atexit([]() { Get().Flush(); });
+    return writer;
+  }();
+  return writer;
+}
+
+AsyncLogWriter::AsyncLogWriter() : id_(next_writer_id++) {
+  static std::once_flag at_fork;
+  std::call_once(at_fork, []() {
+    pthread_atfork(nullptr, nullptr, []() { forked_child = true; });
+  });
+  writer_ = std::thread([this]() { Run(); });
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    wake_ = true;
+  }
+  wake_cv_.notify_one();
+  writer_.join();
+}
+
+AsyncLogWriter::TargetId AsyncLogWriter::AddTarget(SharedFD fd,
+                                                   bool strip_color_codes) {
+  std::lock_guard<std::mutex> lock(targets_mutex_);
+  targets_.emplace_back(Target{std::move(fd), strip_color_codes});
+  return targets_.size() - 1;
+}
+
+void AsyncLogWriter::RemoveTarget(TargetId target) {
+  Flush();
+  std::lock_guard<std::mutex> lock(targets_mutex_);
+  targets_[target].reset();
+}
+
+AsyncLogWriter::StagingBuffer& AsyncLogWriter::ThreadBuffer() {
+  struct ThreadBuffers {
+    ~ThreadBuffers() {
+      for (auto& [writer_id, buffer] : buffers) {
+        buffer->Retire();
+      }
+    }
+    std::vector<std::pair<uint64_t, std::shared_ptr<StagingBuffer>>> buffers;
+  };
+  thread_local ThreadBuffers thread_buffers;
+  thread_local uint64_t cached_writer_id = UINT64_MAX;
+  thread_local StagingBuffer* cached_buffer = nullptr;
+
+  if (cached_writer_id == id_) {
+    return *cached_buffer;
+  }
+  auto it = std::find_if(
+      thread_buffers.buffers.begin(), thread_buffers.buffers.end(),
+      [this](const auto& entry) { return entry.first == id_; });
+  if (it == thread_buffers.buffers.end()) {
+    auto buffer = std::make_shared<StagingBuffer>();
+    {
+      std::lock_guard<std::mutex> lock(buffers_mutex_);
+      buffers_.push_back(buffer);
+    }
+    thread_buffers.buffers.emplace_back(id_, buffer);
+    it = thread_buffers.buffers.end() - 1;
+  }
+  cached_writer_id = id_;
+  cached_buffer = it->second.get();
+  return *cached_buffer;
+}
+
+bool AsyncLogWriter::Write(TargetId target, std::string_view line,
+                           bool must_deliver) {
+  if (forked_child) {
+    return false;
+  }
+  if (line.size() > kMaxLineSize) {
+    Flush();
+    return false;
+  }
+  StagingBuffer& buffer = ThreadBuffer();
+  while (!buffer.TryPush(next_sequence_++, target, line)) {
+    if (!must_deliver) {
+      dropped_++;
+      return true;
+    }
+    Flush();
+  }
+  // Pairs with the fence in Run, so either the writer sees the line or this
+  // thread sees that the writer is idle.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (idle_.load(std::memory_order_relaxed) && idle_.exchange(false)) {
+    WakeWriter();
+  }
+  return true;
+}
+
+void AsyncLogWriter::Flush() {
+  if (forked_child) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t flush = ++flush_requested_;
+  wake_ = true;
+  wake_cv_.notify_one();
+  flushed_cv_.wait(lock, [this, flush]() { return flushed_ >= flush; });
+}
+
+void AsyncLogWriter::WakeWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_ = true;
+  }
+  wake_cv_.notify_one();
+}
+
+void AsyncLogWriter::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    uint64_t flush = flush_requested_;
+    bool stopping = stopping_;
+    wake_ = false;
+    lock.unlock();
+    size_t written = DrainAll();
+    lock.lock();
+    flushed_ = flush;
+    flushed_cv_.notify_all();
+    if (stopping) {
+      return;
+    }
+    if (wake_) {
+      continue;
+    }
+    if (written > 0) {
+      wake_cv_.wait_for(lock, kBatchWindow, [this]() { return wake_; });
+      continue;
+    }
+    idle_ = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    lock.unlock();
+    bool pending;
+    {
+      std::lock_guard<std::mutex> buffers_lock(buffers_mutex_);
+      pending = std::any_of(buffers_.begin(), buffers_.end(),
+                            [](const auto& buffer) { return !buffer->Empty(); });
+    }
+    lock.lock();
+    if (!pending) {
+      wake_cv_.wait(lock, [this]() { return wake_; });
+    }
+    idle_ = false;
+  }
+}
+
+size_t AsyncLogWriter::DrainAll() {
+  std::vector<std::shared_ptr<StagingBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    // A retired buffer gets no more lines, drop it once it's drained.
+    std::erase_if(buffers_, [](const auto& buffer) {
+      return buffer->Retired() && buffer->Empty();
+    });
+    buffers = buffers_;
+  }
+  // A line numbered below the limit that isn't staged yet is still being
+  // logged, so nothing logged after it returned can be numbered below it.
+  // Later lines wait for the next drain.
+  uint64_t sequence_limit = next_sequence_;
+  std::vector<Record> records;
+  for (const auto& buffer : buffers) {
+    size_t sorted = records.size();
+    buffer->Peek(sequence_limit, records);
+    // Each buffer is in order already.
+    std::inplace_merge(records.begin(), records.begin() + sorted,
+                       records.end(), [](const Record& a, const Record& b) {
+                         return a.sequence < b.sequence;
+                       });
+  }
+  WriteRecords(records);
+  for (const auto& buffer : buffers) {
+    buffer->Release();
+  }
+  size_t written = records.size();
+
+  uint64_t dropped = dropped_;
+  if (dropped != reported_dropped_) {
+    std::string notice =
+        fmt::format("{} log lines were dropped because they were logged "
+                    "faster than they could be written\n",
+                    dropped - reported_dropped_);
+    reported_dropped_ = dropped;
+    std::lock_guard<std::mutex> lock(targets_mutex_);
+    for (const auto& target : targets_) {
+      if (target) {
+        std::vector<iovec> iov = {{notice.data(), notice.size()}};
+        WriteAllv(target->fd, iov);
+      }
+    }
+  }
+  return written;
+}
+
+void AsyncLogWriter::WriteRecords(const std::vector<Record>& records) {
+  // Most lines go to several targets, one record each. Writing target by
+  // target keeps each target's lines in order and in a single writev.
+  std::vector<TargetId> target_ids;
+  for (const auto& record : records) {
+    if (std::find(target_ids.begin(), target_ids.end(), record.target) ==
+        target_ids.end()) {
+      target_ids.push_back(record.target);
+    }
+  }
+  std::deque<std::string> stripped;
+  std::vector<iovec> iov;
+  std::lock_guard<std::mutex> lock(targets_mutex_);
+  for (TargetId id : target_ids) {
+    if (id >= targets_.size() || !targets_[id]) {
+      continue;
+    }
+    const Target& target = *targets_[id];
+    iov.clear();
+    for (const auto& record : records) {
+      if (record.target != id) {
+        continue;
+      }
+      std::string_view line = record.line;
+      if (target.strip_color_codes &&
+          line.find('\033') != std::string_view::npos) {
+        StripColorCodes(line, stripped.emplace_back());
+        line = stripped.back();
+      }
+      iov.push_back({const_cast<char*>(line.data()), line.size()});
+    }
+    WriteAllv(target.fd, iov);
+  }
+}
+
+}  // namespace cuttlefish
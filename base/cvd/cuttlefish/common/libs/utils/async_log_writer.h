@@ -0,0 +1,125 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+
+namespace cuttlefish {
+
+// Writes log lines to their destinations from a background thread, so that
+// logging never waits on a disk or a slow terminal.
+//
+// Every logging thread stages its lines in a fixed size ring buffer of its
+// own, which it fills without taking a lock. The writer thread drains all
+// the buffers and writes each destination's lines with one writev. Each line
+// is stamped with a process wide sequence number and the writer merges the
+// buffers by it, so a line logged after another one returned, on any thread,
+// is also written after it.
+//
+// When a buffer is full, lines that must be delivered wait for the writer
+// and the rest are dropped and counted. Memory use is therefore bounded by
+// kBufferSize per logging thread.
+class AsyncLogWriter {
+ public:
+  static constexpr size_t kBufferSize = 64 * 1024;
+  // Longer lines bypass the buffers, see Write.
+  static constexpr size_t kMaxLineSize = kBufferSize / 4;
+
+  using TargetId = uint32_t;
+
+  // The process wide writer. Lines still staged at exit are flushed by an
+  // atexit handler.
+  static AsyncLogWriter& Get();
+
+  AsyncLogWriter();
+  ~AsyncLogWriter();
+
+  // Color codes are stripped by the writer thread when `strip_color_codes` is
+  // set.
+  TargetId AddTarget(SharedFD fd, bool strip_color_codes);
+  // Writes every line staged for `target` before forgetting it.
+  void RemoveTarget(TargetId target);
+
+  // Stages `line` for `target`. When `must_deliver` is set and the buffer is
+  // full, waits for the writer to make room instead of dropping it.
+  //
+  // Returns false if the line was not staged because it's longer than
+  // kMaxLineSize or because this is a forked child, which has no writer
+  // thread. The caller then writes it directly; every line staged before it
+  // has already been written.
+  bool Write(TargetId target, std::string_view line, bool must_deliver);
+
+  // Waits until every line staged before the call has been written.
+  void Flush();
+
+  // Number of lines dropped because a buffer was full.
+  uint64_t Dropped() const { return dropped_; }
+
+ private:
+  class StagingBuffer;
+  struct Record;
+  struct Target {
+    SharedFD fd;
+    bool strip_color_codes;
+  };
+
+  StagingBuffer& ThreadBuffer();
+  void WakeWriter();
+  void Run();
+  // Returns the number of lines written.
+  size_t DrainAll();
+  void WriteRecords(const std::vector<Record>& records);
+
+  std::mutex targets_mutex_;
+  std::vector<std::optional<Target>> targets_;
+
+  std::mutex buffers_mutex_;
+  std::vector<std::shared_ptr<StagingBuffer>> buffers_;
+
+  // Protects the fields below, which wake up the writer and report flushes.
+  std::mutex mutex_;
+  std::condition_variable wake_cv_;
+  std::condition_variable flushed_cv_;
+  bool wake_ = false;
+  bool stopping_ = false;
+  uint64_t flush_requested_ = 0;
+  uint64_t flushed_ = 0;
+  // Set while the writer waits without a timeout, for producers to wake it.
+  std::atomic<bool> idle_ = false;
+
+  // The sequence number of the next staged line.
+  std::atomic<uint64_t> next_sequence_ = 0;
+
+  std::atomic<uint64_t> dropped_ = 0;
+  uint64_t reported_dropped_ = 0;
+  // Tells the per-thread buffers of different writers apart.
+  const uint64_t id_;
+  std::thread writer_;
+};
+
+}  // namespace cuttlefish
@@ -0,0 +1,176 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/common/libs/utils/async_log_writer.h"
+
+#include <fcntl.h>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "android-base/file.h"
+#include "fmt/format.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+using testing::HasSubstr;
+
+SharedFD OpenLog(const std::string& path) {
+  return SharedFD::Open(path, O_CREAT | O_WRONLY | O_APPEND, 0644);
+}
+
+TEST(AsyncLogWriter, KeepsEachThreadsLinesInOrder) {
+  TemporaryDir dir;
+  std::string path = std::string(dir.path) + "/log";
+  constexpr int kThreads = 4;
+  constexpr int kLines = 5000;
+  {
+    AsyncLogWriter writer;
+    AsyncLogWriter::TargetId target = writer.AddTarget(OpenLog(path), false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+      threads.emplace_back([&writer, target, t]() {
+        for (int i = 0; i < kLines; i++) {
+          writer.Write(target, fmt::format("{} {}\n", t, i),
+                       /* must_deliver= */ true);
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    writer.Flush();
+  }
+
+  Result<std::string> contents = ReadFileContents(path);
+  ASSERT_THAT(contents, IsOk());
+  std::vector<int> next(kThreads, 0);
+  std::istringstream lines(*contents);
+  int t, i;
+  while (lines >> t >> i) {
+    ASSERT_GE(t, 0);
+    ASSERT_LT(t, kThreads);
+    ASSERT_EQ(i, next[t]) << "thread " << t;
+    next[t]++;
+  }
+  EXPECT_EQ(next, std::vector<int>(kThreads, kLines));
+}
+
+TEST(AsyncLogWriter, KeepsTheOrderOfLinesAcrossThreads) {
+  TemporaryDir dir;
+  std::string path = std::string(dir.path) + "/log";
+  constexpr int kLines = 20000;
+  {
+    AsyncLogWriter writer;
+    AsyncLogWriter::TargetId target = writer.AddTarget(OpenLog(path), false);
+    // The threads take turns, each logging a line before passing the turn
+    // on, so the lines have a single order although each thread stages them
+    // in its own buffer.
+    std::atomic<int> turn = 0;
+    auto log_turns = [&writer, &turn, target](int parity) {
+      for (int i = parity; i < kLines; i += 2) {
+        while (turn != i) {
+          std::this_thread::yield();
+        }
+        writer.Write(target, fmt::format("{}\n", i),
+                     /* must_deliver= */ true);
+        turn = i + 1;
+      }
+    };
+    std::thread even(log_turns, 0);
+    std::thread odd(log_turns, 1);
+    even.join();
+    odd.join();
+    writer.Flush();
+  }
+
+  Result<std::string> contents = ReadFileContents(path);
+  ASSERT_THAT(contents, IsOk());
+  std::istringstream lines(*contents);
+  int next = 0;
+  int i;
+  while (lines >> i) {
+    ASSERT_EQ(i, next);
+    next++;
+  }
+  EXPECT_EQ(next, kLines);
+}
+
+TEST(AsyncLogWriter, StripsColorCodes) {
+  TemporaryDir dir;
+  std::string colored = std::string(dir.path) + "/colored";
+  std::string stripped = std::string(dir.path) + "/stripped";
+  {
+    AsyncLogWriter writer;
+    AsyncLogWriter::TargetId raw = writer.AddTarget(OpenLog(colored), false);
+    AsyncLogWriter::TargetId plain = writer.AddTarget(OpenLog(stripped), true);
+    writer.Write(raw, "\033[31mred\033[0m\n", true);
+    writer.Write(plain, "\033[31mred\033[0m\n", true);
+    writer.RemoveTarget(raw);
+    writer.RemoveTarget(plain);
+  }
+
+  EXPECT_EQ(ReadFile(colored), "\033[31mred\033[0m\n");
+  EXPECT_EQ(ReadFile(stripped), "red\n");
+}
+
+TEST(AsyncLogWriter, DropsLinesWhenTheTargetIsStuck) {
+  SharedFD read_end, write_end;
+  ASSERT_TRUE(SharedFD::Pipe(&read_end, &write_end));
+  AsyncLogWriter writer;
+  AsyncLogWriter::TargetId target = writer.AddTarget(write_end, false);
+  write_end = SharedFD();
+
+  // Nothing reads the pipe yet, so the writer blocks once it's full and the
+  // staging buffer fills up behind it.
+  std::string line(1000, 'x');
+  line.back() = '\n';
+  for (size_t i = 0; i < 8 * AsyncLogWriter::kBufferSize / line.size(); i++) {
+    EXPECT_TRUE(writer.Write(target, line, /* must_deliver= */ false));
+  }
+  EXPECT_GT(writer.Dropped(), 0);
+
+  std::string output;
+  std::thread reader([&read_end, &output]() { ReadAll(read_end, &output); });
+  writer.RemoveTarget(target);
+  reader.join();
+  EXPECT_THAT(output, HasSubstr("log lines were dropped"));
+}
+
+TEST(AsyncLogWriter, LeavesLongLinesToTheCaller) {
+  TemporaryDir dir;
+  AsyncLogWriter writer;
+  AsyncLogWriter::TargetId target =
+      writer.AddTarget(OpenLog(std::string(dir.path) + "/log"), false);
+
+  std::string line(AsyncLogWriter::kMaxLineSize + 1, 'x');
+
+  EXPECT_FALSE(writer.Write(target, line, true));
+}
+
+}  // namespace
+}  // namespace cuttlefish
@@ -25,6 +25,8 @@
 #include <cstring>
 #include <ctime>
 #include <limits>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -44,6 +46,7 @@
 #include "android-base/threads.h"
 
 #include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/utils/async_log_writer.h"
 #include "cuttlefish/common/libs/utils/environment.h"
 #include "cuttlefish/process/proc_file_utils.h"
 #include "cuttlefish/result/result.h"
@@ -62,11 +65,12 @@ std::string ToUpper(const std::string& input) {
 }
 
 std::vector<SeverityTarget> SeverityTargetsForFiles(
-    const std::vector<std::string>& files) {
+    const std::vector<std::string>& files, LogDelivery delivery) {
   std::vector<SeverityTarget> log_severities;
   for (const auto& file : files) {
     log_severities.emplace_back(
         SeverityTarget::FromFile(file, MetadataLevel::FULL, LogFileSeverity()));
+    log_severities.back().delivery = delivery;
   }
   return log_severities;
 }
@@ -137,10 +141,14 @@ std::string StderrOutputGenerator(const struct tm& now, int pid, uint64_t tid,
       "Mismatch in size of log_characters and values in LogSeverity");
   char severity_char = log_characters[static_cast<int>(severity)];
   std::string line_prefix;
-  if (file != nullptr) {
+  if (file != nullptr && line != 0) {
     line_prefix =
         StrFormat("%s %c %s %5d %5" PRIu64 " %s:%u] ", tag ? tag : "nullptr",
                   severity_char, timestamp, pid, tid, file, line);
+  } else if (file != nullptr) {
+    line_prefix =
+        StrFormat("%s %c %s %5d %5" PRIu64 " %s] ", tag ? tag : "nullptr",
+                  severity_char, timestamp, pid, tid, file);
   } else {
     line_prefix = StrFormat("%s %c %s %5d %5" PRIu64 " ", tag ? tag : "nullptr",
                             severity_char, timestamp, pid, tid);
@@ -163,6 +171,15 @@ std::string StderrOutputGenerator(const struct tm& now, int pid, uint64_t tid,
   return output_string;
 }
 
+// "<executable>(<pid>) ", or just the pid if the executable is unknown.
+std::string ExecutableTag() {
+  Result<std::string> exe = GetExecutablePath(getpid());
+  if (!exe.ok()) {
+    return std::to_string(getpid());
+  }
+  return fmt::format("{}({}) ", android::base::Basename(*exe), getpid());
+}
+
 }  // namespace
 
 std::string StripColorCodes(const std::string& str) {
@@ -202,14 +219,20 @@ SeverityTarget SeverityTarget::FromFd(SharedFD fd, MetadataLevel metadata_level,
 class LogSink : public absl::LogSink {
  public:
   LogSink(SeverityTarget destination, const std::string& prefix)
-      : destination_(std::move(destination)), prefix_(prefix) {
-    Result<std::string> exe = GetExecutablePath(getpid());
-    if (!exe.ok()) {
-      executable_ = std::to_string(getpid());
-      return;
+      : destination_(std::move(destination)),
+        prefix_(prefix),
+        executable_(ExecutableTag()),
+        strip_color_codes_(!destination_.target->IsATTY()) {
+    if (destination_.delivery == LogDelivery::Asynchronous) {
+      async_target_ = AsyncLogWriter::Get().AddTarget(destination_.target,
+                                                      strip_color_codes_);
+    }
+  }
+
+  ~LogSink() {
+    if (async_target_) {
+      AsyncLogWriter::Get().RemoveTarget(*async_target_);
     }
-    executable_ =
-        fmt::format("{}({}) ", android::base::Basename(*exe), getpid());
   }
 
   void Send(const absl::LogEntry& entry) override {
@@ -238,21 +261,53 @@ class LogSink : public absl::LogSink {
             message_with_prefix.c_str());
         break;
     }
-    if (severity >= destination_.severity) {
-      if (destination_.target->IsATTY()) {
-        WriteAll(destination_.target, output_string);
-      } else {
-        WriteAll(destination_.target, StripColorCodes(output_string));
+    if (async_target_) {
+      if (severity == LogSeverity::Fatal) {
+        // The process aborts once the sinks return, write everything now.
+        AsyncLogWriter::Get().Flush();
+      } else if (AsyncLogWriter::Get().Write(
+                     *async_target_, output_string,
+                     /* must_deliver= */ severity >= LogSeverity::Error)) {
+        return;
       }
     }
+    if (strip_color_codes_) {
+      WriteAll(destination_.target, StripColorCodes(output_string));
+    } else {
+      WriteAll(destination_.target, output_string);
+    }
+  }
+
+  void Flush() override {
+    if (async_target_) {
+      AsyncLogWriter::Get().Flush();
+    }
   }
 
  private:
   SeverityTarget destination_;
   std::string prefix_;
   std::string executable_;
+  bool strip_color_codes_;
+  std::optional<AsyncLogWriter::TargetId> async_target_;
 };
 
+std::string FormatLogLines(MetadataLevel metadata_level, LogSeverity severity,
+                           const struct tm& time, const std::string& source,
+                           const std::string& message) {
+  static const std::string& executable = *new std::string(ExecutableTag());
+  switch (metadata_level) {
+    case MetadataLevel::ONLY_MESSAGE:
+      return message + "\n";
+    case MetadataLevel::TAG_AND_MESSAGE:
+      return fmt::format("{}] {}\n", executable, message);
+    default:
+      return StderrOutputGenerator(time, getpid(), GetThreadId(), severity,
+                                   executable.c_str(), source.c_str(),
+                                   /* line= */ 0, message.c_str());
+  }
+}
+
 std::string FromSeverity(LogSeverity severity) {
   switch (severity) {
     case LogSeverity::Verbose:
@@ -315,17 +370,19 @@ LogSeverity LogFileSeverity() {
 
 void SetLoggers(std::vector<SeverityTarget> destinations,
                 const std::string& log_prefix) {
-  static std::vector<LogSink>& log_sinks = *new std::vector<LogSink>;
-  for (LogSink& log_sink : log_sinks) {
+  static std::vector<std::unique_ptr<LogSink>>& log_sinks =
+      *new std::vector<std::unique_ptr<LogSink>>;
+  for (auto& log_sink : log_sinks) {
     // In rare cases this function may called more than once per process
-    absl::RemoveLogSink(&log_sink);
+    absl::RemoveLogSink(log_sink.get());
   }
   log_sinks.clear();
   for (SeverityTarget& destination : destinations) {
-    log_sinks.emplace_back(std::move(destination), log_prefix);
+    log_sinks.emplace_back(
+        std::make_unique<LogSink>(std::move(destination), log_prefix));
   }
-  for (LogSink& log_sink : log_sinks) {
-    absl::AddLogSink(&log_sink);
+  for (auto& log_sink : log_sinks) {
+    absl::AddLogSink(log_sink.get());
   }
   // A custom log sink is typically used for stderr too
   absl::SetStderrThreshold(absl::LogSeverityAtLeast::kInfinity);
@@ -345,18 +402,20 @@ void LogToStderr(const std::string& log_prefix, MetadataLevel metadata_level,
 }
 
 void LogToFiles(const std::vector<std::string>& files,
-                const std::string& log_prefix) {
-  SetLoggers(SeverityTargetsForFiles(files), log_prefix);
+                const std::string& log_prefix, LogDelivery delivery) {
+  SetLoggers(SeverityTargetsForFiles(files, delivery), log_prefix);
 }
 
 void LogToStderrAndFiles(const std::vector<std::string>& files,
                          const std::string& log_prefix,
                          MetadataLevel stderr_level,
-                         std::optional<LogSeverity> stderr_severity) {
-  std::vector<SeverityTarget> log_severities = SeverityTargetsForFiles(files);
+                         std::optional<LogSeverity> stderr_severity,
+                         LogDelivery delivery) {
+  std::vector<SeverityTarget> log_severities =
+      SeverityTargetsForFiles(files, delivery);
   log_severities.push_back(
       SeverityTarget{stderr_severity ? *stderr_severity : ConsoleSeverity(),
-                     SharedFD::Dup(/* stderr */ 2), stderr_level});
+                     SharedFD::Dup(/* stderr */ 2), stderr_level, delivery});
   SetLoggers(log_severities, log_prefix);
 }
 
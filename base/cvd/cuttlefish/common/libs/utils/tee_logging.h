@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <time.h>
+
 #include <memory>
 #include <optional>
 #include <string>
@@ -47,10 +49,20 @@ LogSeverity LogFileSeverity();
 
 enum class MetadataLevel { FULL, ONLY_MESSAGE, TAG_AND_MESSAGE };
 
+enum class LogDelivery {
+  // Written by the logging thread before LOG returns.
+  Synchronous,
+  // Handed to the AsyncLogWriter thread. Lines below ERROR may be dropped
+  // when logged faster than they can be written. FATAL lines, and all lines
+  // before them, are always written before the process aborts.
+  Asynchronous,
+};
+
 struct SeverityTarget {
   LogSeverity severity;
   SharedFD target;
   MetadataLevel metadata_level;
+  LogDelivery delivery = LogDelivery::Synchronous;
 
   static SeverityTarget FromFile(
       const std::string& path,
@@ -62,6 +74,13 @@ struct SeverityTarget {
       LogSeverity severity = LogSeverity::Verbose);
 };
 
+// Formats lines that another program logged the way this process's own
+// messages are written to a destination with `metadata_level`, crediting
+// them to `source` instead of a location in the code.
+std::string FormatLogLines(MetadataLevel metadata_level, LogSeverity severity,
+                           const struct tm& time, const std::string& source,
+                           const std::string& message);
+
 // Set the new logging destinations, replacing existing ones.
 void SetLoggers(std::vector<SeverityTarget> destinations,
                 const std::string& log_prefix = "");
@@ -74,7 +93,8 @@ void LogToStderr(const std::string& log_prefix = "",
 // Configure process to log to a list of files. Logs of all severities are
 // always written in full.
 void LogToFiles(const std::vector<std::string>& files,
-                const std::string& log_prefix = "");
+                const std::string& log_prefix = "",
+                LogDelivery delivery = LogDelivery::Synchronous);
 
 // Configure the process to log to stderr and some files. Only the severity and
 // metadata for the stderr logger can be configured, full logs will be written
@@ -82,7 +102,8 @@ void LogToFiles(const std::vector<std::string>& files,
 void LogToStderrAndFiles(
     const std::vector<std::string>& files, const std::string& log_prefix = "",
     MetadataLevel stderr_level = MetadataLevel::ONLY_MESSAGE,
-    std::optional<LogSeverity> stderr_severity = std::nullopt);
+    std::optional<LogSeverity> stderr_severity = std::nullopt,
+    LogDelivery delivery = LogDelivery::Synchronous);
 
 class LogSink;
 // Adds an extra destination for this process's logs for the duration of the
@@ -0,0 +1,81 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Logs full metadata lines to a file, the way subprocesses write the launcher
+// log, from one or more threads. The argument selects the delivery.
+
+#include <memory>
+#include <string>
+
+#include "absl/log/log.h"
+#include "android-base/file.h"
+#include "benchmark/benchmark.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/async_log_writer.h"
+#include "cuttlefish/common/libs/utils/tee_logging.h"
+
+namespace cuttlefish {
+namespace {
+
+class LoggingFixture : public benchmark::Fixture {
+ public:
+  void SetUp(benchmark::State& state) override {
+    if (state.thread_index() != 0) {
+      return;
+    }
+    // Only the logger under test writes anything.
+    SetLoggers({});
+    dir_ = std::make_unique<TemporaryDir>();
+    SeverityTarget target =
+        SeverityTarget::FromFile(std::string(dir_->path) + "/launcher.log");
+    target.delivery = state.range(0) ? LogDelivery::Asynchronous
+                                     : LogDelivery::Synchronous;
+    logger_ = std::make_unique<ScopedLogger>(std::move(target), "");
+  }
+
+  void TearDown(benchmark::State& state) override {
+    if (state.thread_index() != 0) {
+      return;
+    }
+    // Includes writing whatever is still staged.
+    logger_.reset();
+    dir_.reset();
+  }
+
+ private:
+  std::unique_ptr<TemporaryDir> dir_;
+  std::unique_ptr<ScopedLogger> logger_;
+};
+
+BENCHMARK_DEFINE_F(LoggingFixture, Info)(benchmark::State& state) {
+  int i = 0;
+  for (auto _ : state) {
+    LOG(INFO) << "Processed request " << i++ << " for client "
+              << state.thread_index();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["dropped"] = AsyncLogWriter::Get().Dropped();
+}
+BENCHMARK_REGISTER_F(LoggingFixture, Info)
+    ->ArgName("async")
+    ->Arg(0)
+    ->Arg(1)
+    ->Threads(1)
+    ->Threads(8)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace cuttlefish
@@ -253,6 +253,10 @@ DEFINE_vec(gnss_file_path, CF_DEFAULTS_GNSS_FILE_PATH,
 DEFINE_vec(fixed_location_file_path, CF_DEFAULTS_FIXED_LOCATION_FILE_PATH,
            "Local fixed location file path for the gnss proxy");
 
+DEFINE_vec(gnss_replay_speed, fmt::format("{}", CF_DEFAULTS_GNSS_REPLAY_SPEED),
+           "How many times faster than recorded the gnss proxy replays the "
+           "local gnss and fixed location files");
+
 // by default, this modem-simulator is disabled
 DEFINE_vec(enable_modem_simulator,
            CF_DEFAULTS_ENABLE_MODEM_SIMULATOR ? "true" : "false",
@@ -415,9 +419,33 @@ DEFINE_vec(enable_tap_devices, "true",
            "TAP devices are used on linux for connecting to the network "
            "outside the current machine.");
 
+DEFINE_vec(log_index, fmt::format("{}", CF_DEFAULTS_LOG_INDEX),
+           "Write a binary index of the offset, time and severity of every "
+           "line in launcher.log, one file per log source, to "
+           "logs/log_index.");
+
 DEFINE_vec(vcpu_config_path, CF_DEFAULTS_VCPU_CONFIG_PATH,
            "configuration file for Virtual Cpufreq");
 
+DEFINE_vec(cgroup_parent, CF_DEFAULTS_CGROUP_PARENT,
+           "cgroup v2 directory to create a cgroup for each instance in, e.g. "
+           "a slice delegated to the user by systemd. It must not contain "
+           "processes. Empty to not use cgroups.");
+DEFINE_vec(cgroup_cpu_max, CF_DEFAULTS_CGROUP_CPU_MAX,
+           "CPU bandwidth limit of the instance as written to cpu.max, e.g. "
+           "\"200000 100000\" for two CPUs. Requires --cgroup_parent.");
+DEFINE_vec(cgroup_memory_high, CF_DEFAULTS_CGROUP_MEMORY_HIGH,
+           "Memory above which the instance is throttled and reclaimed, in "
+           "bytes with an optional K, M or G suffix. Requires "
+           "--cgroup_parent.");
+DEFINE_vec(cgroup_cpuset, CF_DEFAULTS_CGROUP_CPUSET,
+           "CPUs the instance may run on, e.g. \"0-3:8-11\". Ranges are "
+           "separated by ':' since ',' separates instances. Requires "
+           "--cgroup_parent.");
+DEFINE_vec(vmm_numa_node, CF_DEFAULTS_VMM_NUMA_NODE,
+           "NUMA node to keep the VMM's CPUs and memory on, or \"auto\" to "
+           "spread instances over the nodes. Requires --cgroup_parent.");
+
 DEFINE_string(kvm_path, "",
               "Device node file used to create VMs. Uses a default if empty.");
 
@@ -126,6 +126,7 @@ DECLARE_vec(start_gnss_proxy);
 DECLARE_vec(gnss_file_path);
 
 DECLARE_vec(fixed_location_file_path);
+DECLARE_vec(gnss_replay_speed);
 
 DECLARE_vec(enable_modem_simulator);
 DECLARE_vec(modem_simulator_sim_type);
@@ -201,9 +202,16 @@ DECLARE_vec(vhost_user_block);
 DECLARE_string(early_tmp_dir);
 
 DECLARE_vec(enable_tap_devices);
+DECLARE_vec(log_index);
 
 DECLARE_vec(vcpu_config_path);
 
+DECLARE_vec(cgroup_parent);
+DECLARE_vec(cgroup_cpu_max);
+DECLARE_vec(cgroup_memory_high);
+DECLARE_vec(cgroup_cpuset);
+DECLARE_vec(vmm_numa_node);
+
 DECLARE_string(kvm_path);
 
 DECLARE_string(vhost_vsock_path);
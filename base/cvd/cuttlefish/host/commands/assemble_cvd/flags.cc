@@ -81,6 +81,7 @@
 #include "cuttlefish/host/commands/assemble_cvd/network_flags.h"
 #include "cuttlefish/host/commands/assemble_cvd/touchpad.h"
 #include "cuttlefish/host/commands/cvdalloc/interface.h"
+#include "cuttlefish/host/libs/cgroup/instance_cgroup.h"
 #include "cuttlefish/host/libs/config/ap_boot_flow.h"
 #include "cuttlefish/host/libs/config/config_constants.h"
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
@@ -115,6 +116,23 @@ using vm_manager::QemuManager;
 
 namespace {
 
+// "" for no pinning, "auto" to spread instances over the host's nodes, or a
+// node number. "auto" goes by the instance number rather than the index in
+// this launch, so that separately launched groups don't all start on node 0.
+Result<int> ParseVmmNumaNode(const std::string& flag, int instance_num) {
+  const int nodes = NumaNodeCount();
+  if (flag.empty()) {
+    return -1;
+  } else if (flag == "auto") {
+    return nodes > 1 ? (instance_num - 1) % nodes : -1;
+  }
+  int node;
+  CF_EXPECTF(absl::SimpleAtoi(flag, &node) && node >= 0 && node < nodes,
+             "Invalid --vmm_numa_node '{}', the host has {} NUMA node(s)",
+             flag, nodes);
+  return node;
+}
+
 Result<std::pair<uint16_t, uint16_t>> ParsePortRange(const std::string& flag) {
   static const std::regex rgx("[0-9]+:[0-9]+");
   CF_EXPECTF(std::regex_match(flag, rgx),
@@ -495,6 +513,8 @@ Result<CuttlefishConfig> InitializeCuttlefishConfiguration(
       CF_EXPECT(GET_FLAG_STR_VALUE(gnss_file_path));
   std::vector<std::string> fixed_location_file_paths =
       CF_EXPECT(GET_FLAG_STR_VALUE(fixed_location_file_path));
+  std::vector<std::string> gnss_replay_speed_vec =
+      CF_EXPECT(GET_FLAG_STR_VALUE(gnss_replay_speed));
   std::vector<int> x_res_vec = CF_EXPECT(GET_FLAG_INT_VALUE(x_res));
   std::vector<int> y_res_vec = CF_EXPECT(GET_FLAG_INT_VALUE(y_res));
   std::vector<int> dpi_vec = CF_EXPECT(GET_FLAG_INT_VALUE(dpi));
@@ -648,9 +668,22 @@ Result<CuttlefishConfig> InitializeCuttlefishConfiguration(
   std::vector<std::string> vcpu_config_vec =
       CF_EXPECT(GET_FLAG_STR_VALUE(vcpu_config_path));
 
+  std::vector<std::string> cgroup_parent_vec =
+      CF_EXPECT(GET_FLAG_STR_VALUE(cgroup_parent));
+  std::vector<std::string> cgroup_cpu_max_vec =
+      CF_EXPECT(GET_FLAG_STR_VALUE(cgroup_cpu_max));
+  std::vector<std::string> cgroup_memory_high_vec =
+      CF_EXPECT(GET_FLAG_STR_VALUE(cgroup_memory_high));
+  std::vector<std::string> cgroup_cpuset_vec =
+      CF_EXPECT(GET_FLAG_STR_VALUE(cgroup_cpuset));
+  std::vector<std::string> vmm_numa_node_vec =
+      CF_EXPECT(GET_FLAG_STR_VALUE(vmm_numa_node));
+
   std::vector<bool> enable_tap_devices_vec =
       CF_EXPECT(GET_FLAG_BOOL_VALUE(enable_tap_devices));
 
+  std::vector<bool> log_index_vec = CF_EXPECT(GET_FLAG_BOOL_VALUE(log_index));
+
   std::string default_enable_sandbox = "";
   std::string default_enable_virtiofs = "";
   std::string comma_str = "";
@@ -1120,6 +1153,26 @@ Result<CuttlefishConfig> InitializeCuttlefishConfiguration(
 
     instance.set_restart_subprocesses(
         restart_subprocesses_values.ForIndex(instance_index));
+
+    const std::string& cgroup_parent = cgroup_parent_vec[instance_index];
+    const int vmm_numa_node =
+        CF_EXPECT(ParseVmmNumaNode(vmm_numa_node_vec[instance_index], num));
+    CF_EXPECTF(cgroup_parent.empty() || cgroup_parent[0] == '/',
+               "--cgroup_parent must be an absolute path, got '{}'",
+               cgroup_parent);
+    if (cgroup_parent.empty()) {
+      CF_EXPECT(cgroup_cpu_max_vec[instance_index].empty() &&
+                    cgroup_memory_high_vec[instance_index].empty() &&
+                    cgroup_cpuset_vec[instance_index].empty() &&
+                    vmm_numa_node == -1,
+                "Resource limits and NUMA placement require --cgroup_parent");
+    }
+    instance.set_cgroup_parent(cgroup_parent);
+    instance.set_cgroup_cpu_max(cgroup_cpu_max_vec[instance_index]);
+    instance.set_cgroup_memory_high(cgroup_memory_high_vec[instance_index]);
+    instance.set_cgroup_cpuset(
+        absl::StrReplaceAll(cgroup_cpuset_vec[instance_index], {{":", ","}}));
+    instance.set_vmm_numa_node(vmm_numa_node);
     instance.set_gpu_capture_binary(gpu_capture_binary_vec[instance_index]);
     if (!gpu_capture_binary_vec[instance_index].empty()) {
       CF_EXPECT(gpu_mode == GpuMode::Gfxstream ||
@@ -1195,6 +1248,13 @@ Result<CuttlefishConfig> InitializeCuttlefishConfiguration(
     instance.set_gnss_file_path(gnss_file_paths[instance_index]);
     instance.set_fixed_location_file_path(
         fixed_location_file_paths[instance_index]);
+    double gnss_replay_speed;
+    CF_EXPECTF(absl::SimpleAtod(gnss_replay_speed_vec[instance_index],
+                                &gnss_replay_speed) &&
+                   gnss_replay_speed > 0,
+               "Invalid --gnss_replay_speed: '{}'",
+               gnss_replay_speed_vec[instance_index]);
+    instance.set_gnss_replay_speed(gnss_replay_speed);
 
     std::vector<std::string> virtual_disk_paths;
 
@@ -1334,6 +1394,7 @@ Result<CuttlefishConfig> InitializeCuttlefishConfiguration(
     }
 
     instance.set_enable_tap_devices(enable_tap_devices_vec[instance_index]);
+    instance.set_log_index(log_index_vec[instance_index]);
 
     auto media_configs_bindings = injector.getMultibindings<MediaConfigs>();
     CF_EXPECT_EQ(media_configs_bindings.size(), 1,
@@ -61,6 +61,7 @@
   cuttlefish::ForCurrentInstance(cuttlefish::kDefaultUuidPrefix)
 #define CF_DEFAULTS_FILE_VERBOSITY "DEBUG"
 #define CF_DEFAULTS_VERBOSITY "INFO"
+#define CF_DEFAULTS_LOG_INDEX false
 #define CF_DEFAULTS_MEMORY_MB CF_DEFAULTS_DYNAMIC_INT
 #define CF_DEFAULTS_TRACK_HOST_TOOLS_CRC false
 // TODO: defined twice, please remove redundant definitions
@@ -242,6 +243,7 @@
 #define CF_DEFAULTS_START_GNSS_PROXY true
 #define CF_DEFAULTS_FIXED_LOCATION_FILE_PATH CF_DEFAULTS_DYNAMIC_STRING
 #define CF_DEFAULTS_GNSS_FILE_PATH CF_DEFAULTS_DYNAMIC_STRING
+#define CF_DEFAULTS_GNSS_REPLAY_SPEED 1.0
 
 // MCU emulator default configuration path
 #define CF_DEFAULTS_MCU_CONFIG_PATH CF_DEFAULTS_DYNAMIC_STRING
@@ -261,3 +263,10 @@
 
 // Virtual Cpufreq default configuration path
 #define CF_DEFAULTS_VCPU_CONFIG_PATH ""
+
+// Instances aren't placed in cgroups by default
+#define CF_DEFAULTS_CGROUP_PARENT ""
+#define CF_DEFAULTS_CGROUP_CPU_MAX ""
+#define CF_DEFAULTS_CGROUP_MEMORY_HIGH ""
+#define CF_DEFAULTS_CGROUP_CPUSET ""
+#define CF_DEFAULTS_VMM_NUMA_NODE ""
@@ -36,7 +36,6 @@
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/common/libs/utils/contains.h"
 #include "cuttlefish/common/libs/utils/disk_usage.h"
-#include "cuttlefish/common/libs/utils/environment.h"
 #include "cuttlefish/common/libs/utils/files.h"
 #include "cuttlefish/files/file_exists.h"
 #include "cuttlefish/host/commands/assemble_cvd/boot_image_utils.h"
@@ -303,31 +302,11 @@ Result<void> GenerateFileContexts(const std::string& output_path,
 
 Result<void> AddVbmetaFooter(const std::string& output_image,
                              const std::string& partition_name) {
-  // TODO(b/335742241): update to use Avb
-  std::string avbtool_path = AvbToolBinary();
-  // Add host binary path to PATH, so that avbtool can locate host util binaries
-  // such as 'fec'
-  std::string env_path =
-      StringFromEnv("PATH", "") + ":" + android::base::Dirname(avbtool_path);
-  Command avb_cmd =
-      Command(AvbToolBinary())
-          // Must unset an existing environment variable in order to modify it
-          .UnsetFromEnvironment("PATH")
-          .AddEnvironmentVariable("PATH", env_path)
-          .AddParameter("add_hashtree_footer")
-          // Arbitrary salt to keep output consistent
-          .AddParameter("--salt")
-          .AddParameter("62BBAAA0", "E4BD99E783AC")
-          .AddParameter("--hash_algorithm")
-          .AddParameter("sha256")
-          .AddParameter("--image")
-          .AddParameter(output_image)
-          .AddParameter("--partition_name")
-          .AddParameter(partition_name);
-
-  CF_EXPECT_EQ(avb_cmd.Start().Wait(), 0,
-               "Failed to add avb footer to image " << output_image);
-
+  // Unsigned, with an arbitrary salt to keep output consistent
+  CF_EXPECT(Avb(AvbToolBinary(), "", "")
+                .AddHashtreeFooter(output_image, partition_name,
+                                   "62BBAAA0E4BD99E783AC"),
+            "Failed to add avb footer to image " << output_image);
   return {};
 }
 
@@ -340,7 +319,7 @@ Result<void> AddVbmetaFooter(const std::string& output_image,
 // 3. Call  sefcontext_compile to compile file_contexts
 // 4. call mkuserimg_mke2fs to build an image, using filesystem_config and
 // file_contexts previously generated
-// 5. call avbtool to add hashtree footer, so that init/bootloader can verify
+// 5. add a hashtree footer, so that init/bootloader can verify
 // AVB chain
 Result<void> BuildDlkmImage(const std::string& src_dir, const bool is_erofs,
                             const std::string& partition_name,
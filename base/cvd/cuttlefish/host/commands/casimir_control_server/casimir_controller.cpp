@@ -16,10 +16,13 @@
 
 #include "cuttlefish/host/commands/casimir_control_server/casimir_controller.h"
 
+#include <endian.h>
 #include <fcntl.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <span>
 
 #include "cuttlefish/host/commands/casimir_control_server/casimir_control.grpc.pb.h"
 #include "cuttlefish/host/commands/casimir_control_server/crc.h"
@@ -42,20 +45,18 @@ Result<void> CasimirController::Mute() {
 }
 
 CasimirController::CasimirController(SharedFD sock)
-    : sock_(sock), power_level(10) {}
+    : sock_(sock), power_level(10) {
+  apdu_builder_.technology_ = Technology::NFC_A;
+  apdu_builder_.protocol_ = Protocol::ISO_DEP;
+  apdu_builder_.bitrate_ = BitRate::BIT_RATE_106_KBIT_S;
+}
 
 /* static */
 Result<CasimirController> CasimirController::ConnectToTcpPort(int rf_port) {
   SharedFD sock = SharedFD::SocketLocalClient(rf_port, SOCK_STREAM);
   CF_EXPECT(sock->IsOpen(),
             "Failed to connect to casimir with RF port" << rf_port);
-
-  int flags = sock->Fcntl(F_GETFL, 0);
-  CF_EXPECT_GE(flags, 0, "Failed to get FD flags of casimir socket");
-  CF_EXPECT_EQ(sock->Fcntl(F_SETFL, flags | O_NONBLOCK), 0,
-               "Failed to set casimir socket nonblocking");
-
-  return CasimirController(sock);
+  return CF_EXPECT(FromSocket(sock));
 }
 
 /* static */
@@ -64,7 +65,11 @@ Result<CasimirController> CasimirController::ConnectToUnixSocket(
   SharedFD sock = SharedFD::SocketLocalClient(rf_path, false, SOCK_STREAM);
   CF_EXPECT(sock->IsOpen(),
             "Failed to connect to casimir with RF path" << rf_path);
+  return CF_EXPECT(FromSocket(sock));
+}
 
+/* static */
+Result<CasimirController> CasimirController::FromSocket(SharedFD sock) {
   int flags = sock->Fcntl(F_GETFL, 0);
   CF_EXPECT_GE(flags, 0, "Failed to get FD flags of casimir socket");
   CF_EXPECT_EQ(sock->Fcntl(F_SETFL, flags | O_NONBLOCK), 0,
@@ -139,17 +144,13 @@ Result<uint16_t> CasimirController::Poll() {
 }
 
 Result<std::vector<uint8_t>> CasimirController::SendApdu(
-    uint16_t receiver_id, std::vector<uint8_t> apdu) {
+    uint16_t receiver_id, std::span<const uint8_t> apdu) {
   CF_EXPECT(sock_->IsOpen());
 
-  DataBuilder data_builder;
-  data_builder.data_ = std::move(apdu);
-  data_builder.receiver_ = receiver_id;
-  data_builder.technology_ = Technology::NFC_A;
-  data_builder.protocol_ = Protocol::ISO_DEP;
-  data_builder.bitrate_ = BitRate::BIT_RATE_106_KBIT_S;
+  apdu_builder_.data_.assign(apdu.begin(), apdu.end());
+  apdu_builder_.receiver_ = receiver_id;
 
-  CF_EXPECT(Write(data_builder), "Failed to send APDU bytes");
+  CF_EXPECT(Write(apdu_builder_), "Failed to send APDU bytes");
 
   auto res = CF_EXPECT(ReadRfPacket(3s), "Failed to get APDU response");
   auto rf_packet = RfPacketView::Create(slice(res));
@@ -172,12 +173,12 @@ CasimirController::SendBroadcast(std::vector<uint8_t> data, std::string type,
   if (type == "A") {
     poll_command.technology_ = Technology::NFC_A;
     if (crc) {
-      data = CF_EXPECT(WithCrc16A(data), "Could not append CRC16A");
+      AppendCrc16A(data);
     }
   } else if (type == "B") {
     poll_command.technology_ = Technology::NFC_B;
     if (crc) {
-      data = CF_EXPECT(WithCrc16B(data), "Could not append CRC16B");
+      AppendCrc16B(data);
     }
     if (bits != 8) {
       return CF_ERR(
@@ -241,80 +242,84 @@ CasimirController::SendBroadcast(std::vector<uint8_t> data, std::string type,
   return std::make_tuple(data, type, crc, bits, bitrate, timeout, power);
 }
 
+// Note: Although rf_packets.h doesn't document nor include packet header,
+// the header is necessary to know total packet size.
 Result<void> CasimirController::Write(const RfPacketBuilder& rf_packet) {
-  std::vector<uint8_t> raw_bytes = rf_packet.SerializeToBytes();
-  uint16_t header_bytes_le = htole16(raw_bytes.size());
-  ssize_t written = WriteAll(sock_, reinterpret_cast<char*>(&header_bytes_le),
-                             sizeof(header_bytes_le));
-  CF_EXPECT_EQ(written, sizeof(header_bytes_le),
-               "Failed to write packet header to casimir socket, errno="
-                   << sock_->GetErrno());
-
-  written = WriteAll(sock_, reinterpret_cast<char*>(raw_bytes.data()),
-                     raw_bytes.size());
-  CF_EXPECT_EQ(written, raw_bytes.size(),
-               "Failed to write packet payload to casimir socket, errno="
+  // The header and the packet go out in one write, so that they don't end up
+  // in separate TCP segments.
+  write_buffer_.clear();
+  write_buffer_.reserve(sizeof(uint16_t) + rf_packet.GetSize());
+  write_buffer_.resize(sizeof(uint16_t));
+  rf_packet.Serialize(write_buffer_);
+  uint16_t header_bytes_le = htole16(write_buffer_.size() - sizeof(uint16_t));
+  std::copy_n(reinterpret_cast<uint8_t*>(&header_bytes_le),
+              sizeof(header_bytes_le), write_buffer_.begin());
+
+  ssize_t written =
+      WriteAll(sock_, reinterpret_cast<char*>(write_buffer_.data()),
+               write_buffer_.size());
+  CF_EXPECT_EQ(written, write_buffer_.size(),
+               "Failed to write packet to casimir socket, errno="
                    << sock_->GetErrno());
 
   return {};
 }
 
-Result<std::shared_ptr<std::vector<uint8_t>>> CasimirController::ReadExact(
-    size_t size, std::chrono::microseconds timeout) {
-  size_t total_read = 0;
-  auto out = std::make_shared<std::vector<uint8_t>>(size);
-  auto prev_time = std::chrono::steady_clock::now();
-  while (
-      std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count() >
-      0) {
+Result<void> CasimirController::FillReadBuffer(
+    size_t size, std::chrono::steady_clock::time_point deadline) {
+  // Reads ask for more than the current packet needs, so that whatever casimir
+  // already sent after it is picked up by the same read.
+  constexpr size_t kMinReadSize = 4096;
+
+  if (read_buffer_.size() - read_offset_ >= size) {
+    return {};
+  }
+  read_buffer_.erase(read_buffer_.begin(), read_buffer_.begin() + read_offset_);
+  read_offset_ = 0;
+  while (read_buffer_.size() < size) {
+    auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    CF_EXPECT_GT(timeout.count(), 0,
+                 "Failed to read from casimir socket; timed out");
     PollSharedFd poll_fd = {
         .fd = sock_,
         .events = EPOLLIN,
         .revents = 0,
     };
-    int res = sock_.Poll(
-        &poll_fd, 1,
-        std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count());
+    int res = sock_.Poll(&poll_fd, 1, timeout.count());
     CF_EXPECT_GE(res, 0, "Failed to poll on the casimir socket");
     CF_EXPECT_EQ(poll_fd.revents, EPOLLIN,
                  "Unexpected poll result for reading");
 
+    size_t buffered = read_buffer_.size();
+    read_buffer_.resize(buffered + std::max(size - buffered, kMinReadSize));
     // Nonblocking read, so don't need to care about timeout.
-    ssize_t read =
-        sock_->Read((void*)&(out->data()[total_read]), size - total_read);
+    ssize_t read = sock_->Read(read_buffer_.data() + buffered,
+                               read_buffer_.size() - buffered);
+    read_buffer_.resize(buffered + std::max<ssize_t>(read, 0));
     CF_EXPECT_GT(
         read, 0,
         "Failed to read from casimir socket, errno=" << sock_->GetErrno());
-
-    total_read += read;
-    if (total_read >= size) {
-      return out;
-    }
-
-    auto current_time = std::chrono::steady_clock::now();
-    timeout -= std::chrono::duration_cast<std::chrono::microseconds>(
-        current_time - prev_time);
   }
-
-  return CF_ERR("Failed to read from casimir socket; timed out");
+  return {};
 }
 
-// Note: Although rf_packets.h doesn't document nor include packet header,
-// the header is necessary to know total packet size.
 Result<std::shared_ptr<std::vector<uint8_t>>> CasimirController::ReadRfPacket(
     std::chrono::microseconds timeout) {
-  auto start_time = std::chrono::steady_clock::now();
-
-  auto res = CF_EXPECT(ReadExact(sizeof(uint16_t), timeout),
-                       "Failed to read RF packet header");
-  slice packet_size_slice(res);
-  int16_t packet_size = packet_size_slice.read_le<uint16_t>();
-
-  auto current_time = std::chrono::steady_clock::now();
-  timeout -= std::chrono::duration_cast<std::chrono::microseconds>(
-      current_time - start_time);
-  return CF_EXPECT(ReadExact(packet_size, timeout),
-                   "Failed to read RF packet payload");
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+
+  CF_EXPECT(FillReadBuffer(sizeof(uint16_t), deadline),
+            "Failed to read RF packet header");
+  uint16_t packet_size = read_buffer_[read_offset_] |
+                         (read_buffer_[read_offset_ + 1] << 8);
+
+  CF_EXPECT(FillReadBuffer(sizeof(uint16_t) + packet_size, deadline),
+            "Failed to read RF packet payload");
+  auto packet_begin = read_buffer_.begin() + read_offset_ + sizeof(uint16_t);
+  auto packet = std::make_shared<std::vector<uint8_t>>(
+      packet_begin, packet_begin + packet_size);
+  read_offset_ += sizeof(uint16_t) + packet_size;
+  return packet;
 }
 
 }  // namespace cuttlefish
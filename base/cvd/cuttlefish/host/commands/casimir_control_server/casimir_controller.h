@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <span>
 #include <vector>
 
 #include "cuttlefish/common/libs/fs/shared_buf.h"
@@ -31,6 +33,8 @@ class CasimirController {
  public:
   static Result<CasimirController> ConnectToTcpPort(int rf_port);
   static Result<CasimirController> ConnectToUnixSocket(const std::string& rf);
+  // Takes a socket already connected to casimir's RF port.
+  static Result<CasimirController> FromSocket(SharedFD sock);
 
   Result<void> Mute();
   Result<void> Unmute();
@@ -48,7 +52,7 @@ class CasimirController {
   Result<uint16_t> Poll();
 
   Result<std::vector<uint8_t>> SendApdu(uint16_t receiver_id,
-                                        std::vector<uint8_t> apdu);
+                                        std::span<const uint8_t> apdu);
 
  private:
   CasimirController(SharedFD sock);
@@ -64,13 +68,22 @@ class CasimirController {
   Result<void> SelectT4AT(uint16_t sender_id);
 
   Result<void> Write(const RfPacketBuilder& rf_packet);
-  Result<std::shared_ptr<std::vector<uint8_t>>> ReadExact(
-      size_t size, std::chrono::microseconds timeout);
+  /*
+   * Reads from the socket until at least `size` bytes past `read_offset_` are
+   * buffered.
+   */
+  Result<void> FillReadBuffer(size_t size,
+                              std::chrono::steady_clock::time_point deadline);
   Result<std::shared_ptr<std::vector<uint8_t>>> ReadRfPacket(
       std::chrono::microseconds timeout);
 
   SharedFD sock_;
   uint8_t power_level;
+  // Kept across APDUs so that their buffers are reused.
+  DataBuilder apdu_builder_;
+  std::vector<uint8_t> write_buffer_;
+  std::vector<uint8_t> read_buffer_;
+  size_t read_offset_ = 0;
 };
 
 }  // namespace cuttlefish
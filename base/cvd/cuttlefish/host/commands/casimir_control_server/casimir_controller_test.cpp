@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/commands/casimir_control_server/casimir_controller.h"
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/host/commands/casimir_control_server/rf_packets.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+using testing::ElementsAre;
+
+constexpr uint16_t kReceiverId = 7;
+
+// An APDU response from the tag, as casimir frames it on the RF port.
+std::string ResponseBytes(std::vector<uint8_t> data) {
+  DataBuilder response(kReceiverId, 0, Technology::NFC_A, Protocol::ISO_DEP,
+                       BitRate::BIT_RATE_106_KBIT_S, 0, std::move(data));
+  std::vector<uint8_t> packet = response.SerializeToBytes();
+  std::string bytes = {static_cast<char>(packet.size() & 0xff),
+                       static_cast<char>(packet.size() >> 8)};
+  bytes.append(packet.begin(), packet.end());
+  return bytes;
+}
+
+class CasimirControllerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    SharedFD controller_end;
+    ASSERT_TRUE(SharedFD::SocketPair(AF_UNIX, SOCK_STREAM, 0, &controller_end,
+                                     &casimir_));
+    Result<CasimirController> controller =
+        CasimirController::FromSocket(controller_end);
+    ASSERT_THAT(controller, IsOk());
+    controller_.emplace(std::move(*controller));
+  }
+
+  Result<std::vector<uint8_t>> SendApdu() {
+    return controller_->SendApdu(kReceiverId, std::vector<uint8_t>{0x00});
+  }
+
+  void SendFromCasimir(const std::string& bytes) {
+    ASSERT_EQ(WriteAll(casimir_, bytes), bytes.size());
+  }
+
+  SharedFD casimir_;
+  std::optional<CasimirController> controller_;
+};
+
+TEST_F(CasimirControllerTest, ReadsPacketsCoalescedInOneWrite) {
+  SendFromCasimir(ResponseBytes({0x90, 0x00}) + ResponseBytes({0x6a, 0x82}));
+
+  EXPECT_THAT(SendApdu(), IsOkAndValue(ElementsAre(0x90, 0x00)));
+  // Already buffered by the first read.
+  EXPECT_THAT(SendApdu(), IsOkAndValue(ElementsAre(0x6a, 0x82)));
+}
+
+TEST_F(CasimirControllerTest, ReadsAPacketWithASplitHeader) {
+  std::string first = ResponseBytes({0x90, 0x00});
+  std::string second = ResponseBytes({0x6a, 0x82});
+  // The second packet's header is split between two writes, the first of
+  // which also carries the whole first packet.
+  std::thread casimir([this, &first, &second]() {
+    SendFromCasimir(first + second.substr(0, 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    SendFromCasimir(second.substr(1));
+  });
+
+  EXPECT_THAT(SendApdu(), IsOkAndValue(ElementsAre(0x90, 0x00)));
+  EXPECT_THAT(SendApdu(), IsOkAndValue(ElementsAre(0x6a, 0x82)));
+  casimir.join();
+}
+
+}  // namespace
+}  // namespace cuttlefish
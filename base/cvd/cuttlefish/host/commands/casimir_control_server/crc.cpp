@@ -16,51 +16,58 @@
 
 #include "cuttlefish/host/commands/casimir_control_server/crc.h"
 
-#include "cuttlefish/result/result.h"
+#include <stdint.h>
 
-namespace cuttlefish {
+#include <array>
+#include <span>
+#include <vector>
 
+namespace cuttlefish {
 namespace {
-static std::vector<uint8_t> Crc16(const std::vector<uint8_t>& data,
-                                  uint16_t initial, bool invert) {
-  uint16_t w_crc = initial;
 
-  for (uint8_t byte : data) {
-    byte ^= (w_crc & 0x00FF);
-    byte ^= (byte << 4) & 0xFF;
-    w_crc = (w_crc >> 8) ^ ((byte << 8) & 0xFFFF) ^ ((byte << 3) & 0xFFFF) ^
-            ((byte >> 4) & 0xFFFF);
+// Both CRCs use the polynomial x^16 + x^12 + x^5 + 1, processed least
+// significant bit first, so a byte at a time the update is
+// crc = (crc >> 8) ^ table[(crc ^ byte) & 0xFF].
+constexpr std::array<uint16_t, 256> MakeCrc16Table() {
+  std::array<uint16_t, 256> table{};
+  for (int i = 0; i < 256; i++) {
+    uint16_t crc = i;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+    }
+    table[i] = crc;
   }
+  return table;
+}
 
-  if (invert) {
-    w_crc = ~w_crc;
-  }
+constexpr std::array<uint16_t, 256> kCrc16Table = MakeCrc16Table();
 
-  return {static_cast<uint8_t>(w_crc & 0xFF),
-          static_cast<uint8_t>((w_crc >> 8) & 0xFF)};
+uint16_t Crc16(std::span<const uint8_t> data, uint16_t crc) {
+  for (uint8_t byte : data) {
+    crc = (crc >> 8) ^ kCrc16Table[(crc ^ byte) & 0xFF];
+  }
+  return crc;
 }
 
-static std::vector<uint8_t> Crc16A(const std::vector<uint8_t>& data) {
-  return Crc16(data, 0x6363, false);
+void AppendCrc16(std::vector<uint8_t>& data, uint16_t crc) {
+  data.push_back(crc & 0xFF);
+  data.push_back(crc >> 8);
 }
 
-static std::vector<uint8_t> Crc16B(const std::vector<uint8_t>& data) {
-  return Crc16(data, 0xFFFF, true);
-}
 }  // namespace
 
-Result<std::vector<uint8_t>> WithCrc16A(const std::vector<uint8_t>& data) {
-  std::vector<uint8_t> newData = data;
-  std::vector<uint8_t> crc = Crc16A(newData);
-  newData.insert(newData.end(), crc.begin(), crc.end());
-  return newData;
+uint16_t Crc16A(std::span<const uint8_t> data) { return Crc16(data, 0x6363); }
+
+uint16_t Crc16B(std::span<const uint8_t> data) {
+  return static_cast<uint16_t>(~Crc16(data, 0xFFFF));
+}
+
+void AppendCrc16A(std::vector<uint8_t>& data) {
+  AppendCrc16(data, Crc16A(data));
 }
 
-Result<std::vector<uint8_t>> WithCrc16B(const std::vector<uint8_t>& data) {
-  std::vector<uint8_t> newData = data;
-  std::vector<uint8_t> crc = Crc16B(newData);
-  newData.insert(newData.end(), crc.begin(), crc.end());
-  return newData;
+void AppendCrc16B(std::vector<uint8_t>& data) {
+  AppendCrc16(data, Crc16B(data));
 }
 
 }  // namespace cuttlefish
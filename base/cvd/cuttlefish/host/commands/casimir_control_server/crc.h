@@ -16,11 +16,19 @@
 
 #pragma once
 
-#include "cuttlefish/result/result.h"
+#include <stdint.h>
+
+#include <span>
+#include <vector>
 
 namespace cuttlefish {
 
-Result<std::vector<uint8_t>> WithCrc16A(const std::vector<uint8_t>& data);
-Result<std::vector<uint8_t>> WithCrc16B(const std::vector<uint8_t>& data);
+// ISO/IEC 14443-3 CRC_A and CRC_B of `data`.
+uint16_t Crc16A(std::span<const uint8_t> data);
+uint16_t Crc16B(std::span<const uint8_t> data);
+
+// Appends the CRC to `data`, least significant byte first as it's transmitted.
+void AppendCrc16A(std::vector<uint8_t>& data);
+void AppendCrc16B(std::vector<uint8_t>& data);
 
 }  // namespace cuttlefish
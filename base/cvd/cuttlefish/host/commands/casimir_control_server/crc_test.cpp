@@ -0,0 +1,55 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/commands/casimir_control_server/crc.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace cuttlefish {
+namespace {
+
+using testing::ElementsAre;
+
+// Examples from ISO/IEC 14443-3 Annex B.
+TEST(CrcTest, Crc16A) {
+  EXPECT_EQ(Crc16A(std::vector<uint8_t>{0x00, 0x00}), 0x1EA0);
+  EXPECT_EQ(Crc16A(std::vector<uint8_t>{0x12, 0x34}), 0xCF26);
+}
+
+TEST(CrcTest, Crc16B) {
+  EXPECT_EQ(Crc16B(std::vector<uint8_t>{0x00, 0x00, 0x00}), 0xC6CC);
+  EXPECT_EQ(Crc16B(std::vector<uint8_t>{0x0F, 0xAA, 0xFF}), 0xD1FC);
+  EXPECT_EQ(Crc16B(std::vector<uint8_t>{0x0A, 0x12, 0x34, 0x56}), 0xF62C);
+}
+
+TEST(CrcTest, AppendsLeastSignificantByteFirst) {
+  std::vector<uint8_t> a = {0x12, 0x34};
+  std::vector<uint8_t> b = {0x0A, 0x12, 0x34, 0x56};
+
+  AppendCrc16A(a);
+  AppendCrc16B(b);
+
+  EXPECT_THAT(a, ElementsAre(0x12, 0x34, 0x26, 0xCF));
+  EXPECT_THAT(b, ElementsAre(0x0A, 0x12, 0x34, 0x56, 0x2C, 0xF6));
+}
+
+}  // namespace
+}  // namespace cuttlefish
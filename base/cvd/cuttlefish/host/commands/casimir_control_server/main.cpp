@@ -16,6 +16,9 @@
 
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -40,6 +43,8 @@ using casimircontrolserver::SendApduRequest;
 using casimircontrolserver::SendBroadcastRequest;
 using casimircontrolserver::SendBroadcastResponse;
 using casimircontrolserver::SenderId;
+using casimircontrolserver::TransceiveApduReply;
+using casimircontrolserver::TransceiveApduRequest;
 using casimircontrolserver::TransceiveConfiguration;
 using casimircontrolserver::Void;
 
@@ -49,6 +54,7 @@ using google::protobuf::Empty;
 using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::ServerContext;
+using grpc::ServerReaderWriter;
 using grpc::Status;
 using grpc::StatusCode;
 
@@ -85,6 +91,7 @@ class CasimirControlServiceImpl final : public CasimirControlService::Service {
  private:
   Status SetPowerLevel(ServerContext* context, const PowerLevel* power_level,
                        Void*) override {
+    std::lock_guard lock(device_mutex_);
     return ResultToStatus(SetPowerLevelResult(power_level));
   }
 
@@ -98,11 +105,13 @@ class CasimirControlServiceImpl final : public CasimirControlService::Service {
   }
 
   Status Close(ServerContext* context, const Void*, Void* senderId) override {
+    std::lock_guard lock(device_mutex_);
     device_ = std::nullopt;
     return Status::OK;
   }
 
   Status Init(ServerContext*, const Void*, Void*) override {
+    std::lock_guard lock(device_mutex_);
     return ResultToStatus(Init());
   }
 
@@ -137,6 +146,7 @@ class CasimirControlServiceImpl final : public CasimirControlService::Service {
 
   Status SetRadioState(ServerContext* context, const RadioState* radio_state,
                        Void*) override {
+    std::lock_guard lock(device_mutex_);
     return ResultToStatus(SetRadioStateResult(radio_state));
   }
 
@@ -173,6 +183,7 @@ class CasimirControlServiceImpl final : public CasimirControlService::Service {
   }
 
   Status PollA(ServerContext*, const Void*, SenderId* sender_id) override {
+    std::lock_guard lock(device_mutex_);
     return ResultToStatus(PollAResult(sender_id));
   }
 
@@ -205,7 +216,7 @@ class CasimirControlServiceImpl final : public CasimirControlService::Service {
     response->clear_response_hex_strings();
     for (int i = 0; i < apdu_bytes.size(); i++) {
       std::vector<uint8_t> bytes =
-          CF_EXPECT(device_->SendApdu(id, std::move(apdu_bytes[i])),
+          CF_EXPECT(device_->SendApdu(id, apdu_bytes[i]),
                     "Failed to send APDU bytes");
       std::string resp = absl::BytesToHexString(std::string_view(
           reinterpret_cast<const char*>(bytes.data()), bytes.size()));
@@ -218,9 +229,58 @@ class CasimirControlServiceImpl final : public CasimirControlService::Service {
 
   Status SendApdu(ServerContext*, const SendApduRequest* request,
                   SendApduReply* response) override {
+    std::lock_guard lock(device_mutex_);
     return ResultToStatus(SendApduResult(request, response));
   }
 
+  Result<void> TransceiveApdusResult(
+      ServerReaderWriter<TransceiveApduReply, TransceiveApduRequest>* stream) {
+    TransceiveApduRequest request;
+    std::optional<int16_t> id;
+    TransceiveApduReply reply;
+    while (stream->Read(&request)) {
+      reply.clear_responses();
+      {
+        // Not held while waiting for the client, other RPCs can run between
+        // the requests of a stream.
+        std::lock_guard lock(device_mutex_);
+        if (!id.has_value()) {
+          CF_EXPECT(Init());
+          if (request.has_sender_id()) {
+            // Sender IDs are 1-based on the wire, see `SendApduResult`.
+            id = request.sender_id() - 1;
+          } else {
+            SenderId sender_id;
+            CF_EXPECT(PollAResult(&sender_id));
+            id = sender_id.sender_id() - 1;
+          }
+        }
+        CF_EXPECT(device_.has_value(),
+                  "The connection to casimir was closed during the stream");
+        for (const std::string& apdu : request.apdus()) {
+          std::vector<uint8_t> bytes = CF_EXPECT(
+              device_->SendApdu(
+                  *id, std::span(reinterpret_cast<const uint8_t*>(apdu.data()),
+                                 apdu.size())),
+              "Failed to send APDU bytes");
+          reply.add_responses(bytes.data(), bytes.size());
+        }
+      }
+      CF_EXPECT(stream->Write(reply), "Client closed the APDU stream");
+    }
+    return {};
+  }
+
+  // ISO-DEP is half duplex, so APDUs still reach the device one at a time.
+  // Streaming only saves the client a round trip per APDU: the next request is
+  // usually buffered by the time the previous response is written.
+  Status TransceiveApdus(
+      ServerContext*,
+      ServerReaderWriter<TransceiveApduReply, TransceiveApduRequest>* stream)
+      override {
+    return ResultToStatus(TransceiveApdusResult(stream));
+  }
+
   Result<void> SendBroadcastResult(const SendBroadcastRequest* request,
                                    SendBroadcastResponse* response) {
     // Default configuration values
@@ -281,9 +341,13 @@ class CasimirControlServiceImpl final : public CasimirControlService::Service {
 
   Status SendBroadcast(ServerContext*, const SendBroadcastRequest* request,
                        SendBroadcastResponse* response) override {
+    std::lock_guard lock(device_mutex_);
     return ResultToStatus(SendBroadcastResult(request, response));
   }
 
+  // gRPC runs the handlers on several threads, every access to the device
+  // holds device_mutex_.
+  std::mutex device_mutex_;
   std::optional<CasimirController> device_;
   bool is_radio_on_ = false;
 };
@@ -18,59 +18,85 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 
-#include <condition_variable>
-#include <deque>
 #include <memory>
-#include <mutex>
 #include <string>
-#include <thread>
 #include <utility>
-#include <vector>
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "gflags/gflags.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
-#include "cuttlefish/common/libs/fs/shared_select.h"
+#include "cuttlefish/host/commands/console_forwarder/ring_buffer_sink.h"
 #include "cuttlefish/host/libs/config/config_instance_derived.h"
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
 #include "cuttlefish/host/libs/config/logging.h"
 #include "cuttlefish/posix/strerror.h"
+#include "cuttlefish/result/result.h"
 
 DEFINE_int32(console_in_fd, -1,
              "File descriptor for the console's input channel");
 DEFINE_int32(console_out_fd, -1,
              "File descriptor for the console's output channel");
+DEFINE_uint32(sink_buffer_size, 1 << 20,
+              "Bytes buffered for each destination of the console data before "
+              "its overflow policy applies");
+DEFINE_string(console_log_overflow, "block",
+              "What to do when the console log can't keep up: 'block' or "
+              "'drop_oldest'");
+DEFINE_string(kernel_log_overflow, "block",
+              "What to do when the kernel log monitor can't keep up: 'block' "
+              "or 'drop_oldest'");
+DEFINE_string(client_overflow, "drop_oldest",
+              "What to do when the console client can't keep up: 'block' or "
+              "'drop_oldest'");
+DEFINE_string(console_in_overflow, "block",
+              "What to do when the console doesn't consume client input: "
+              "'block' or 'drop_oldest'");
 
 namespace cuttlefish {
 
+struct OverflowPolicies {
+  OverflowPolicy console_log;
+  OverflowPolicy kernel_log;
+  OverflowPolicy client;
+  OverflowPolicy console_in;
+};
+
 // Handles forwarding the serial console to a pseudo-terminal (PTY)
 // It receives a couple of fds for the console (could be the same fd twice if,
 // for example a socket_pair were used).
 // Data available in the console's output needs to be read immediately to avoid
 // the having the VMM blocked on writes to the pipe. To achieve this one thread
 // takes care of (and only of) all read calls (from console output and from the
-// socket client), using select(2) to ensure it never blocks. Writes are handled
-// in a different thread, the two threads communicate through a buffer queue
-// protected by a mutex.
+// socket client), dispatched by a Reactor to ensure it never blocks. Every
+// destination is written by a thread of its own, fed through a fixed size ring
+// buffer, so a stuck destination can neither delay the others nor make memory
+// use grow without bounds.
 class ConsoleForwarder {
  public:
   ConsoleForwarder(std::string console_path, SharedFD console_in,
                    SharedFD console_out, SharedFD console_log,
-                   SharedFD kernel_log)
+                   SharedFD kernel_log, size_t buffer_size,
+                   const OverflowPolicies& policies)
       : console_path_(console_path),
-        console_in_(console_in),
         console_out_(console_out),
-        console_log_(console_log),
-        kernel_log_(kernel_log) {}
+        console_in_sink_("console input", console_in, buffer_size,
+                         policies.console_in),
+        console_log_sink_("console log", console_log, buffer_size,
+                          policies.console_log),
+        kernel_log_sink_("kernel log", kernel_log, buffer_size,
+                         policies.kernel_log),
+        client_sink_("console client", SharedFD(), buffer_size,
+                     policies.client) {}
   [[noreturn]] void StartServer() {
-    // Create a new thread to handle writes to the console
-    writer_thread_ = std::thread([this]() { WriteLoop(); });
     // Use the calling thread (likely the process' main thread) to handle
     // reading the console's output and input from the client.
     ReadLoop();
@@ -109,120 +135,83 @@ class ConsoleForwarder {
     return pty_shared_fd;
   }
 
-  void EnqueueWrite(std::shared_ptr<std::vector<char>> buf_ptr, SharedFD fd) {
-    std::lock_guard<std::mutex> lock(write_queue_mutex_);
-    write_queue_.emplace_back(fd, buf_ptr);
-    condvar_.notify_one();
+  [[noreturn]] void ReadLoop() {
+    auto reactor = Reactor::Create();
+    CHECK(reactor.ok()) << reactor.error();
+    reactor_ = std::move(*reactor);
+
+    Result<void> watched = reactor_->Watch(
+        console_out_, EPOLLIN, [this](uint32_t) { ReadConsoleOutput(); });
+    CHECK(watched.ok()) << watched.error();
+    OpenClient();
+
+    Result<void> run = reactor_->Run();
+    CHECK(run.ok()) << run.error();
+    LOG(FATAL) << "Console read loop stopped";
+  }
+
+  void OpenClient() {
+    client_fd_ = OpenPTY();
+    client_sink_.SetFd(client_fd_);
+    // EPOLLPRI reports packet mode status changes.
+    Result<void> watched =
+        reactor_->Watch(client_fd_, EPOLLIN | EPOLLPRI,
+                        [this](uint32_t) { ReadClientInput(); });
+    CHECK(watched.ok()) << watched.error();
   }
 
-  [[noreturn]] void WriteLoop() {
-    while (true) {
-      while (!write_queue_.empty()) {
-        std::shared_ptr<std::vector<char>> buf_ptr;
-        SharedFD fd;
-        {
-          std::lock_guard<std::mutex> lock(write_queue_mutex_);
-          auto& front = write_queue_.front();
-          buf_ptr = front.second;
-          fd = front.first;
-          write_queue_.pop_front();
-        }
-        // Write all bytes to the file descriptor. Writes may block, so the
-        // mutex lock should NOT be held while writing to avoid blocking the
-        // other thread.
-        ssize_t bytes_written = 0;
-        ssize_t bytes_to_write = buf_ptr->size();
-        while (bytes_to_write > 0) {
-          bytes_written =
-              fd->Write(buf_ptr->data() + bytes_written, bytes_to_write);
-          if (bytes_written < 0) {
-            // It is expected for writes to the PTY to fail if nothing is
-            // connected
-            if (fd->GetErrno() != EAGAIN) {
-              LOG(ERROR) << "Error writing to fd: " << fd->StrError();
-            }
-
-            // Don't try to write from this buffer anymore, error handling will
-            // be done on the reading thread (failed client will be
-            // disconnected, on serial console failure this process will abort).
-            break;
-          }
-          bytes_to_write -= bytes_written;
-        }
-      }
-      {
-        std::unique_lock<std::mutex> lock(write_queue_mutex_);
-        // Check again before sleeping, state may have changed
-        if (write_queue_.empty()) {
-          condvar_.wait(lock);
-        }
-      }
+  void ReadConsoleOutput() {
+    auto bytes_read = console_out_->Read(read_buffer_, sizeof(read_buffer_));
+    // This is likely unrecoverable, so exit here
+    CHECK(bytes_read > 0) << "Error reading from console output: "
+                          << console_out_->StrError();
+    console_log_sink_.Write(read_buffer_, bytes_read);
+    if (client_fd_->IsOpen()) {
+      client_sink_.Write(read_buffer_, bytes_read);
     }
+    kernel_log_sink_.Write(read_buffer_, bytes_read);
   }
 
-  [[noreturn]] void ReadLoop() {
-    SharedFD client_fd;
-    while (true) {
-      if (!client_fd->IsOpen()) {
-        client_fd = OpenPTY();
-      }
-
-      SharedFDSet read_set;
-      read_set.Set(console_out_);
-      read_set.Set(client_fd);
-
-      SharedFDSet error_set;
-      error_set.Set(client_fd);
-
-      Select(&read_set, nullptr, &error_set, nullptr);
-      if (read_set.IsSet(console_out_)) {
-        std::shared_ptr<std::vector<char>> buf_ptr =
-            std::make_shared<std::vector<char>>(4096);
-        auto bytes_read = console_out_->Read(buf_ptr->data(), buf_ptr->size());
-        // This is likely unrecoverable, so exit here
-        CHECK(bytes_read > 0) << "Error reading from console output: "
-                              << console_out_->StrError();
-        buf_ptr->resize(bytes_read);
-        EnqueueWrite(buf_ptr, console_log_);
-        if (client_fd->IsOpen()) {
-          EnqueueWrite(buf_ptr, client_fd);
-        }
-        EnqueueWrite(buf_ptr, kernel_log_);
-      }
-      if (read_set.IsSet(client_fd) || error_set.IsSet(client_fd)) {
-        std::shared_ptr<std::vector<char>> buf_ptr =
-            std::make_shared<std::vector<char>>(4096);
-        auto bytes_read = client_fd->Read(buf_ptr->data(), buf_ptr->size());
-        if (bytes_read <= 0) {
-          // If this happens, it's usually because the PTY controller went away
-          // e.g. the user closed minicom, or killed screen, or closed kgdb. In
-          // such a case, we will just re-create the PTY
-          LOG(ERROR) << "Error reading from client fd: "
-                     << client_fd->StrError();
-          client_fd->Close();
-        } else if (bytes_read == 1) {  // Control message
-          VLOG(0) << "pty control message: " << (int)(*buf_ptr)[0];
-        } else {
-          buf_ptr->resize(bytes_read);
-          buf_ptr->erase(buf_ptr->begin());
-          EnqueueWrite(buf_ptr, console_in_);
-        }
-      }
+  void ReadClientInput() {
+    auto bytes_read = client_fd_->Read(read_buffer_, sizeof(read_buffer_));
+    if (bytes_read <= 0) {
+      // If this happens, it's usually because the PTY controller went away
+      // e.g. the user closed minicom, or killed screen, or closed kgdb. In
+      // such a case, we will just re-create the PTY
+      LOG(ERROR) << "Error reading from client fd: " << client_fd_->StrError();
+      Result<void> unwatched = reactor_->Unwatch(client_fd_);
+      CHECK(unwatched.ok()) << unwatched.error();
+      client_fd_->Close();
+      OpenClient();
+    } else if (bytes_read == 1) {  // Control message
+      VLOG(0) << "pty control message: " << (int)read_buffer_[0];
+    } else {
+      // Skip the packet mode header byte.
+      console_in_sink_.Write(read_buffer_ + 1, bytes_read - 1);
     }
   }
 
   std::string console_path_;
-  SharedFD console_in_;
   SharedFD console_out_;
-  SharedFD console_log_;
-  SharedFD kernel_log_;
-  std::thread writer_thread_;
-  std::mutex write_queue_mutex_;
-  std::condition_variable condvar_;
-  std::deque<std::pair<SharedFD, std::shared_ptr<std::vector<char>>>>
-      write_queue_;
+  RingBufferSink console_in_sink_;
+  RingBufferSink console_log_sink_;
+  RingBufferSink kernel_log_sink_;
+  RingBufferSink client_sink_;
+  // Only used from the read loop.
+  std::unique_ptr<Reactor> reactor_;
+  SharedFD client_fd_;
+  char read_buffer_[4096];
 };
 
+Result<OverflowPolicies> OverflowPoliciesFromFlags() {
+  return OverflowPolicies{
+      .console_log = CF_EXPECT(ParseOverflowPolicy(FLAGS_console_log_overflow)),
+      .kernel_log = CF_EXPECT(ParseOverflowPolicy(FLAGS_kernel_log_overflow)),
+      .client = CF_EXPECT(ParseOverflowPolicy(FLAGS_client_overflow)),
+      .console_in = CF_EXPECT(ParseOverflowPolicy(FLAGS_console_in_overflow)),
+  };
+}
+
 int ConsoleForwarderMain(int argc, char** argv) {
   DefaultSubprocessLogging(argv);
   ::gflags::ParseCommandLineFlags(&argc, &argv, true);
@@ -251,8 +240,12 @@ int ConsoleForwarderMain(int argc, char** argv) {
       SharedFD::Open(console_log.c_str(), O_CREAT | O_APPEND | O_WRONLY, 0666);
   SharedFD kernel_log_fd =
       SharedFD::Open(KernelLogPipeName(instance), O_APPEND | O_WRONLY, 0666);
+  CHECK(FLAGS_sink_buffer_size > 0) << "--sink_buffer_size must be positive";
+  Result<OverflowPolicies> policies = OverflowPoliciesFromFlags();
+  CHECK(policies.ok()) << policies.error();
   ConsoleForwarder console_forwarder(console_path, console_in, console_out,
-                                     console_log_fd, kernel_log_fd);
+                                     console_log_fd, kernel_log_fd,
+                                     FLAGS_sink_buffer_size, *policies);
 
   // Don't get a SIGPIPE from the clients
   CHECK(sigaction(SIGPIPE, nullptr, nullptr) == 0)
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/commands/console_forwarder/ring_buffer_sink.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/log/log.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+// How long the writer waits for a non-blocking fd to become writable before
+// checking whether it was replaced.
+constexpr int kPollOutTimeoutMs = 100;
+
+}  // namespace
+
+Result<OverflowPolicy> ParseOverflowPolicy(std::string_view name) {
+  if (name == "block") {
+    return OverflowPolicy::kBlock;
+  } else if (name == "drop_oldest") {
+    return OverflowPolicy::kDropOldest;
+  }
+  return CF_ERRF("Unknown overflow policy '{}', expected 'block' or "
+                 "'drop_oldest'",
+                 name);
+}
+
+RingBufferSink::RingBufferSink(std::string name, SharedFD fd, size_t capacity,
+                               OverflowPolicy policy)
+    : name_(std::move(name)), policy_(policy), buffer_(capacity) {
+  PrepareFd(fd);
+  fd_ = std::move(fd);
+  writer_ = std::thread([this]() { WriteLoop(); });
+}
+
+RingBufferSink::~RingBufferSink() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  writer_.join();
+}
+
+void RingBufferSink::Write(const char* data, size_t size) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (policy_ == OverflowPolicy::kBlock) {
+    while (size > 0) {
+      cv_.wait(lock, [this]() { return stop_ || size_ < buffer_.size(); });
+      if (stop_) {
+        return;
+      }
+      size_t chunk = std::min(size, buffer_.size() - size_);
+      CopyIn(data, chunk);
+      data += chunk;
+      size -= chunk;
+      cv_.notify_all();
+    }
+    return;
+  }
+
+  // Only the newest bytes of an oversized write would survive anyway.
+  if (size > buffer_.size()) {
+    size_t excess = size - buffer_.size();
+    dropped_bytes_ += excess;
+    data += excess;
+    size -= excess;
+  }
+  if (size_ + size > buffer_.size()) {
+    cv_.wait(lock, [this, size]() {
+      return stop_ || !writing_ || size_ + size <= buffer_.size();
+    });
+    if (size_ + size > buffer_.size()) {
+      Drop(size_ + size - buffer_.size());
+    }
+  }
+  CopyIn(data, size);
+  cv_.notify_all();
+}
+
+void RingBufferSink::SetFd(SharedFD fd) {
+  PrepareFd(fd);
+  std::lock_guard<std::mutex> lock(mutex_);
+  fd_ = std::move(fd);
+}
+
+uint64_t RingBufferSink::DroppedBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_bytes_;
+}
+
+void RingBufferSink::WriteLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return stop_ || size_ > 0; });
+    if (stop_) {
+      return;
+    }
+    struct iovec iov[2];
+    int iovcnt = 1;
+    size_t first = std::min(size_, buffer_.size() - read_pos_);
+    iov[0] = {.iov_base = buffer_.data() + read_pos_, .iov_len = first};
+    if (first < size_) {
+      iov[1] = {.iov_base = buffer_.data(), .iov_len = size_ - first};
+      iovcnt = 2;
+    }
+    SharedFD fd = fd_;
+    writing_ = true;
+    lock.unlock();
+
+    ssize_t written = fd->Writev(iov, iovcnt);
+    int error = fd->GetErrno();
+
+    lock.lock();
+    writing_ = false;
+    cv_.notify_all();
+    if (written > 0) {
+      Consume(written);
+    } else if (written < 0 && error == EAGAIN) {
+      // The producer may drop data meanwhile, the buffer is read again after.
+      lock.unlock();
+      PollSharedFd poll_fd = {.fd = fd, .events = POLLOUT, .revents = 0};
+      SharedFD::Poll(&poll_fd, 1, kPollOutTimeoutMs);
+      lock.lock();
+    } else if (written < 0) {
+      // Error handling is left to the reading side, e.g. a failed client is
+      // replaced there. Don't retry the same bytes forever meanwhile.
+      LOG(ERROR) << "Error writing to " << name_ << ": " << fd->StrError();
+      Drop(size_);
+    }
+  }
+}
+
+void RingBufferSink::PrepareFd(SharedFD& fd) {
+  if (policy_ != OverflowPolicy::kDropOldest || !fd->IsOpen()) {
+    return;
+  }
+  int flags = fd->Fcntl(F_GETFL, 0);
+  if (flags < 0 || fd->Fcntl(F_SETFL, flags | O_NONBLOCK) < 0) {
+    LOG(ERROR) << "Failed to make " << name_
+               << " non-blocking: " << fd->StrError();
+  }
+}
+
+void RingBufferSink::CopyIn(const char* data, size_t size) {
+  size_t write_pos = (read_pos_ + size_) % buffer_.size();
+  size_t first = std::min(size, buffer_.size() - write_pos);
+  memcpy(buffer_.data() + write_pos, data, first);
+  memcpy(buffer_.data(), data + first, size - first);
+  size_ += size;
+}
+
+void RingBufferSink::Consume(size_t size) {
+  read_pos_ = (read_pos_ + size) % buffer_.size();
+  size_ -= size;
+}
+
+void RingBufferSink::Drop(size_t size) {
+  Consume(size);
+  dropped_bytes_ += size;
+  LOG_EVERY_N_SEC(WARNING, 10)
+      << name_ << " can't keep up, " << dropped_bytes_
+      << " bytes dropped so far";
+}
+
+}  // namespace cuttlefish
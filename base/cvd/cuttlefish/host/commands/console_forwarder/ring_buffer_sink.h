@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+// What to do with new data when a sink's buffer is full.
+enum class OverflowPolicy {
+  // Wait for the writer to make room. Nothing is lost, but a stuck output
+  // stalls the producer.
+  kBlock,
+  // Discard the oldest buffered bytes. The file descriptor is switched to
+  // non-blocking mode so that the writer never holds on to data for long.
+  kDropOldest,
+};
+
+Result<OverflowPolicy> ParseOverflowPolicy(std::string_view name);
+
+// Forwards bytes to a file descriptor from a dedicated thread through a fixed
+// size ring buffer. Buffered data is written with writev, which covers the
+// wrap around in a single call.
+class RingBufferSink {
+ public:
+  RingBufferSink(std::string name, SharedFD fd, size_t capacity,
+                 OverflowPolicy policy);
+  ~RingBufferSink();
+
+  RingBufferSink(const RingBufferSink&) = delete;
+  RingBufferSink& operator=(const RingBufferSink&) = delete;
+
+  void Write(const char* data, size_t size);
+  // Buffered data is kept and goes to the new file descriptor.
+  void SetFd(SharedFD fd);
+
+  uint64_t DroppedBytes();
+
+ private:
+  void WriteLoop();
+  void PrepareFd(SharedFD& fd);
+  void CopyIn(const char* data, size_t size);
+  void Consume(size_t size);
+  void Drop(size_t size);
+
+  const std::string name_;
+  const OverflowPolicy policy_;
+  std::vector<char> buffer_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  SharedFD fd_;
+  size_t read_pos_ = 0;
+  size_t size_ = 0;
+  // The writer reads from the buffer without holding the mutex, so the bytes
+  // it's writing can't be dropped until it's done.
+  bool writing_ = false;
+  bool stop_ = false;
+  uint64_t dropped_bytes_ = 0;
+
+  std::thread writer_;
+};
+
+}  // namespace cuttlefish
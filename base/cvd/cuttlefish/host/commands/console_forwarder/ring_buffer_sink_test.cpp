@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/commands/console_forwarder/ring_buffer_sink.h"
+
+#include <fcntl.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+
+namespace cuttlefish {
+namespace {
+
+class RingBufferSinkTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(SharedFD::Pipe(&read_end_, &write_end_));
+  }
+
+  std::string ReadExactly(size_t size) {
+    std::string data(size, '\0');
+    EXPECT_EQ(ReadExact(read_end_, &data), size);
+    return data;
+  }
+
+  SharedFD read_end_;
+  SharedFD write_end_;
+};
+
+TEST_F(RingBufferSinkTest, ForwardsAcrossWrapAround) {
+  RingBufferSink sink("test", write_end_, 8, OverflowPolicy::kBlock);
+
+  // With a capacity of 8 these writes wrap around the end of the buffer.
+  std::string expected;
+  for (int i = 0; i < 10; i++) {
+    std::string chunk = std::to_string(i) + "abcde";
+    sink.Write(chunk.data(), chunk.size());
+    expected += chunk;
+  }
+
+  EXPECT_EQ(ReadExactly(expected.size()), expected);
+  EXPECT_EQ(sink.DroppedBytes(), 0);
+}
+
+TEST_F(RingBufferSinkTest, DropOldestKeepsNewestData) {
+  // Fill the pipe so that nothing else can be written to it for now.
+  ASSERT_GE(write_end_->Fcntl(F_SETFL, O_NONBLOCK), 0);
+  std::string filler(4096, 'x');
+  size_t pipe_contents = 0;
+  ssize_t written;
+  while ((written = write_end_->Write(filler.data(), filler.size())) > 0) {
+    pipe_contents += written;
+  }
+  // Writes of up to a page are atomic, so a few bytes may still fit.
+  while (write_end_->Write(filler.data(), 1) > 0) {
+    pipe_contents++;
+  }
+
+  RingBufferSink sink("test", write_end_, 4, OverflowPolicy::kDropOldest);
+  sink.Write("123", 3);
+  sink.Write("456", 3);
+  sink.Write("789", 3);
+  EXPECT_EQ(sink.DroppedBytes(), 5);
+
+  ReadExactly(pipe_contents);
+  EXPECT_EQ(ReadExactly(4), "6789");
+}
+
+TEST_F(RingBufferSinkTest, BlockWaitsForTheReader) {
+  RingBufferSink sink("test", write_end_, 64, OverflowPolicy::kBlock);
+  std::string data(1 << 20, 'y');
+
+  std::thread reader([this, &data]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(ReadExactly(data.size()), data);
+  });
+  sink.Write(data.data(), data.size());
+  reader.join();
+
+  EXPECT_EQ(sink.DroppedBytes(), 0);
+}
+
+TEST(OverflowPolicyTest, Parse) {
+  EXPECT_EQ(*ParseOverflowPolicy("block"), OverflowPolicy::kBlock);
+  EXPECT_EQ(*ParseOverflowPolicy("drop_oldest"), OverflowPolicy::kDropOldest);
+  EXPECT_FALSE(ParseOverflowPolicy("drop_newest").ok());
+}
+
+}  // namespace
+}  // namespace cuttlefish
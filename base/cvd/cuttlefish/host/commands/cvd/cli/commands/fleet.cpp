@@ -18,6 +18,7 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "json/value.h"
@@ -25,6 +26,7 @@
 #include "cuttlefish/flag_parser/flag.h"
 #include "cuttlefish/host/commands/cvd/cli/command_request.h"
 #include "cuttlefish/host/commands/cvd/instances/instance_manager.h"
+#include "cuttlefish/host/commands/cvd/instances/local_instance_group.h"
 #include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
@@ -62,9 +64,13 @@ Result<void> CvdFleetCommandHandler::Handle(const CommandRequest& request) {
   CF_EXPECT(ConsumeFlags({}, args, {.fail_on_unexpected_argument = true}));
 
   auto all_groups = CF_EXPECT(instance_manager_.FindGroups({}));
-  Json::Value groups_json(Json::arrayValue);
+  std::vector<LocalInstanceGroup*> groups;
   for (auto& group : all_groups) {
-    groups_json.append(CF_EXPECT(group.FetchStatus()));
+    groups.push_back(&group);
+  }
+  Json::Value groups_json(Json::arrayValue);
+  for (auto& group_json : CF_EXPECT(FetchGroupsStatus(groups))) {
+    groups_json.append(std::move(group_json));
   }
   Json::Value output_json(Json::objectValue);
   output_json["groups"] = groups_json;
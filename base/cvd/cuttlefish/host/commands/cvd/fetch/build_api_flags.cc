@@ -69,6 +69,15 @@ std::vector<Flag> BuildApiFlags::Flags() {
           .Help("Max allowed size(in gigabytes) of the local fetch file cache. "
                 " If the cache grows beyond this size it will be pruned after "
                 "the fetches complete."));
+  flags.emplace_back(
+      GflagsCompatFlag("max_http_transfers_per_host",
+                       this->max_http_transfers_per_host)
+          .Help("How many downloads from the same server can be in progress "
+                "at once. 0 is unlimited."));
+  flags.emplace_back(
+      GflagsCompatFlag("http_verbose", this->http_verbose)
+          .Help("Log HTTP requests and response headers, with credentials "
+                "removed."));
 
   for (Flag flag : this->credential_flags.Flags()) {
     flags.emplace_back(std::move(flag));
@@ -35,6 +35,8 @@ inline constexpr char kDefaultProjectID[] = "";
 inline constexpr std::chrono::seconds kDefaultWaitRetryPeriod =
     std::chrono::seconds(20);
 inline constexpr bool kDefaultEnableCaching = true;
+inline constexpr int kDefaultMaxHttpTransfersPerHost = 8;
+inline constexpr bool kDefaultHttpVerbose = false;
 
 struct BuildApiFlags {
   std::vector<Flag> Flags();
@@ -48,6 +50,8 @@ struct BuildApiFlags {
   bool enable_caching = kDefaultEnableCaching;
   size_t max_cache_size_gb = kDefaultCacheSizeGb;
   CasDownloaderFlags cas_downloader_flags;
+  int max_http_transfers_per_host = kDefaultMaxHttpTransfersPerHost;
+  bool http_verbose = kDefaultHttpVerbose;
 };
 
 }  // namespace cuttlefish
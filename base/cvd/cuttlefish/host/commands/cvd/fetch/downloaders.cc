@@ -27,6 +27,7 @@
 #include "cuttlefish/host/libs/web/android_build_api.h"
 #include "cuttlefish/host/libs/web/android_build_url.h"
 #include "cuttlefish/host/libs/web/build_api.h"
+#include "cuttlefish/host/libs/web/build_metadata_cache.h"
 #include "cuttlefish/host/libs/web/caching_build_api.h"
 #include "cuttlefish/host/libs/web/credential_source.h"
 #include "cuttlefish/host/libs/web/http_client/curl_http_client.h"
@@ -44,6 +45,7 @@ struct Downloaders::Impl {
   std::unique_ptr<CredentialSource> android_creds_;
   std::unique_ptr<AndroidBuildUrl> android_build_url_;
   std::unique_ptr<CasDownloader> cas_downloader_;
+  std::unique_ptr<BuildMetadataCache> metadata_cache_;
   std::unique_ptr<AndroidBuildApi> android_build_api_;
   std::unique_ptr<CachingBuildApi> caching_build_api_;
   std::unique_ptr<CredentialSource> luci_credential_source_;
@@ -61,7 +63,10 @@ Result<Downloaders> Downloaders::Create(const BuildApiFlags& flags,
                                         const std::string& cache_base_path) {
   std::unique_ptr<Downloaders::Impl> impl(new Downloaders::Impl());
 
-  impl->curl_ = CurlHttpClient(/*use_logging_debug_function=*/true);
+  impl->curl_ = CurlMultiHttpClient({
+      .max_transfers_per_host = flags.max_http_transfers_per_host,
+      .verbose = flags.http_verbose,
+  });
   impl->retrying_http_client_ = RetryingServerErrorHttpClient(
       *impl->curl_, 10, std::chrono::milliseconds(5000));
 
@@ -88,10 +93,15 @@ Result<Downloaders> Downloaders::Create(const BuildApiFlags& flags,
     impl->cas_downloader_ = std::move(cas_downloader_result.value());
   }
 
+  if (flags.enable_caching) {
+    impl->metadata_cache_ =
+        std::make_unique<BuildMetadataCache>(cache_base_path + "/metadata");
+  }
+
   impl->android_build_api_ = std::make_unique<AndroidBuildApi>(
       *impl->retrying_http_client_, *impl->android_build_url_,
       impl->android_creds_.get(), flags.wait_retry_period,
-      impl->cas_downloader_.get());
+      impl->cas_downloader_.get(), impl->metadata_cache_.get());
 
   if (flags.enable_caching) {
     impl->caching_build_api_ = std::make_unique<CachingBuildApi>(
@@ -20,6 +20,7 @@
 #include <json/json.h>
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <iterator>
 #include <set>
@@ -31,6 +32,7 @@
 
 #include "cuttlefish/host/commands/cvd/instances/instance_database_types.h"
 #include "cuttlefish/host/commands/cvd/instances/local_instance.h"
+#include "cuttlefish/host/commands/cvd/instances/status_fetcher.h"
 #include "cuttlefish/host/commands/cvd/utils/common.h"
 #include "cuttlefish/host/libs/log_names/log_names.h"
 #include "cuttlefish/result/result.h"
@@ -223,19 +225,45 @@ std::vector<std::string> LocalInstanceGroup::GroupLogBasenames() {
   };
 }
 
-Result<Json::Value> LocalInstanceGroup::FetchStatus(
-    std::chrono::seconds timeout) {
-  Json::Value instances_json(Json::arrayValue);
-  for (auto& instance : Instances()) {
-    auto instance_status_json = CF_EXPECT(instance.FetchStatus(timeout));
-    instances_json.append(instance_status_json);
-  }
+Json::Value LocalInstanceGroup::StatusJson(Json::Value instances_json) const {
   Json::Value group_json;
   group_json["group_name"] = GroupName();
   group_json["metrics_dir"] = MetricsDir();
   group_json["start_time"] = Format(StartTime());
-  group_json["instances"] = instances_json;
+  group_json["instances"] = std::move(instances_json);
   return group_json;
 }
 
+Result<Json::Value> LocalInstanceGroup::FetchStatus(
+    std::chrono::seconds timeout) {
+  return CF_EXPECT(FetchGroupsStatus({this}, timeout))[0];
+}
+
+Result<std::vector<Json::Value>> FetchGroupsStatus(
+    const std::vector<LocalInstanceGroup*>& groups,
+    std::chrono::seconds timeout) {
+  std::vector<LocalInstance*> instances;
+  for (LocalInstanceGroup* group : groups) {
+    for (LocalInstance& instance : group->Instances()) {
+      instances.push_back(&instance);
+    }
+  }
+  std::vector<Result<Json::Value>> instance_statuses =
+      FetchInstancesStatus(instances, timeout);
+
+  std::vector<Json::Value> group_statuses;
+  group_statuses.reserve(groups.size());
+  auto status_it = instance_statuses.begin();
+  for (LocalInstanceGroup* group : groups) {
+    Json::Value instances_json(Json::arrayValue);
+    for (const LocalInstance& instance : group->Instances()) {
+      instances_json.append(CF_EXPECTF(std::move(*status_it++),
+                                       "Failed to fetch status of \"{}\"",
+                                       instance.Name()));
+    }
+    group_statuses.emplace_back(group->StatusJson(std::move(instances_json)));
+  }
+  return group_statuses;
+}
+
 }  // namespace cuttlefish
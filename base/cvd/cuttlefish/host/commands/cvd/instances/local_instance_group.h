@@ -18,6 +18,7 @@
 
 #include <json/json.h>
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -96,6 +97,10 @@ class LocalInstanceGroup {
 
  private:
   friend class InstanceDatabase;
+  friend Result<std::vector<Json::Value>> FetchGroupsStatus(
+      const std::vector<LocalInstanceGroup*>&, std::chrono::seconds);
+
+  Json::Value StatusJson(Json::Value instances_json) const;
 
   static Result<LocalInstanceGroup> Create(
       const cvd::InstanceGroup& group_proto);
@@ -109,4 +114,11 @@ class LocalInstanceGroup {
   std::vector<LocalInstance> instances_;
 };
 
+// Like LocalInstanceGroup::FetchStatus, but the instances of all the groups are
+// queried together so that one slow group doesn't delay the others. Returns
+// one JSON object per group, in the same order as `groups`.
+Result<std::vector<Json::Value>> FetchGroupsStatus(
+    const std::vector<LocalInstanceGroup*>& groups,
+    std::chrono::seconds timeout = std::chrono::seconds(5));
+
 }  // namespace cuttlefish
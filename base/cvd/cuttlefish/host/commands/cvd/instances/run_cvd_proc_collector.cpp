@@ -104,14 +104,16 @@ static std::optional<std::string> HostOut(
   return std::nullopt;
 }
 
-Result<RunCvdProcInfo> ExtractRunCvdInfo(const pid_t pid) {
-  auto proc_info = CF_EXPECT(ExtractProcInfo(pid));
+// The owner comes from `process_table`, the rest isn't part of the status file
+// the table was built from.
+Result<RunCvdProcInfo> ExtractRunCvdInfo(const ProcessTable& process_table,
+                                         const pid_t pid) {
   RunCvdProcInfo info;
-  info.pid_ = proc_info.pid_;
-  info.real_owner_uid_ = proc_info.real_owner_;
-  info.exec_path_ = proc_info.actual_exec_path_;
-  info.cmd_args_ = std::move(proc_info.args_);
-  info.envs_ = std::move(proc_info.envs_);
+  info.pid_ = pid;
+  info.real_owner_uid_ = CF_EXPECT(process_table.OwnerUid(pid));
+  info.exec_path_ = CF_EXPECT(GetExecutablePath(pid));
+  info.cmd_args_ = CF_EXPECT(GetCmdArgs(pid));
+  info.envs_ = CF_EXPECT(GetEnvs(pid));
   if (auto it = info.envs_.find("HOME"); it == info.envs_.end()) {
     return CF_ERR("HOME not present in environment");
   } else {
@@ -142,22 +144,14 @@ Result<RunCvdProcInfo> ExtractRunCvdInfo(const pid_t pid) {
   return info;
 }
 
-Result<std::vector<RunCvdProcInfo>> ExtractAllRunCvdInfo(
-    std::optional<uid_t> uid) {
+std::vector<RunCvdProcInfo> ExtractAllRunCvdInfo(
+    const ProcessTable& process_table, uid_t uid) {
   std::vector<RunCvdProcInfo> run_cvd_procs_of_uid;
-  auto run_cvd_pids = CF_EXPECT(CollectPidsByExecName("run_cvd"), getuid());
-  std::vector<ProcInfo> run_cvd_proc_infos;
-  run_cvd_proc_infos.reserve(run_cvd_pids.size());
-  for (const auto run_cvd_pid : run_cvd_pids) {
-    auto proc_info_result = ExtractRunCvdInfo(run_cvd_pid);
+  for (const auto run_cvd_pid : process_table.PidsByExecName("run_cvd", uid)) {
+    auto proc_info_result = ExtractRunCvdInfo(process_table, run_cvd_pid);
     if (!proc_info_result.ok()) {
       VLOG(0) << "Failed to fetch run_cvd process info for " << run_cvd_pid;
-      // perhaps, not my process
-      continue;
-    }
-    if (uid && uid.value() != proc_info_result->real_owner_uid_) {
-      VLOG(0) << "run_cvd process " << run_cvd_pid << " does not belong to "
-              << uid.value() << " so skipped.";
+      // perhaps, it exited in the meantime
       continue;
     }
     run_cvd_procs_of_uid.emplace_back(std::move(*proc_info_result));
@@ -187,8 +181,11 @@ Result<RunCvdProcessCollector> RunCvdProcessCollector::Get() {
 }
 
 Result<std::vector<GroupProcInfo>> RunCvdProcessCollector::CollectInfo() {
+  // A single snapshot of /proc serves both the run_cvd lookup and the parent
+  // pid checks below, instead of rereading every status file per query.
+  const ProcessTable process_table = CF_EXPECT(ProcessTable::Scan());
   std::vector<RunCvdProcInfo> run_cvd_infos =
-      CF_EXPECT(ExtractAllRunCvdInfo(getuid()));
+      ExtractAllRunCvdInfo(process_table, getuid());
 
   // home --> group map
   std::unordered_map<std::string, GroupProcInfo> groups;
@@ -221,7 +218,7 @@ Result<std::vector<GroupProcInfo>> RunCvdProcessCollector::CollectInfo() {
     for (auto& [id, instance] : id_instance_map) {
       const auto& instance_run_cvd_pids = instance.pids_;
       for (const auto run_cvd_pid : instance_run_cvd_pids) {
-        auto ppid_result = Ppid(run_cvd_pid);
+        auto ppid_result = process_table.Ppid(run_cvd_pid);
         if (!ppid_result.ok()) {
           VLOG(1) << "Failed to fetch the parent id of " << run_cvd_pid;
           continue;
@@ -17,7 +17,10 @@
 #include "cuttlefish/host/commands/cvd/instances/status_fetcher.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <future>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -70,6 +73,10 @@ void OverrideInstanceJson(const LocalInstance& instance,
   }
 }
 
+// How long the status tool may run past the time it was given to wait for
+// run_cvd, before it's considered stuck.
+constexpr std::chrono::seconds kStatusToolGracePeriod(5);
+
 Result<std::string> GetBin(const std::string& host_artifacts_path) {
   return CF_EXPECT(HostToolTarget(host_artifacts_path).GetStatusBinName());
 }
@@ -90,6 +97,10 @@ Result<Json::Value> FetchInstanceStatus(LocalInstance& instance,
     return instance_json;
   }
 
+  // Shared by both commands below so that a stuck instance can't hold the
+  // caller for longer than this.
+  const auto deadline =
+      std::chrono::steady_clock::now() + timeout + kStatusToolGracePeriod;
   const auto working_dir = CurrentDirectory();
 
   auto android_host_out = instance.HostArtifactsPath();
@@ -113,10 +124,18 @@ Result<Json::Value> FetchInstanceStatus(LocalInstance& instance,
   Command help_cmd = CF_EXPECT(ConstructCommand(help_cmd_param));
 
   std::string stdout_str, stderr_str;
-  RunWithManagedStdio(std::move(help_cmd), nullptr, &stdout_str, &stderr_str);
-
-  std::vector<GflagDescription> internal_flags =
-      CF_EXPECT(ParseGflagsXmlHelp(stdout_str));
+  int help_res = RunWithManagedStdio(std::move(help_cmd), nullptr, &stdout_str,
+                                     &stderr_str, deadline);
+
+  // A probe killed at the deadline leaves partial or no help, which is treated
+  // as no help at all. The status tool then runs out of time as well and the
+  // instance is reported with a warning like any other unresponsive one.
+  std::vector<GflagDescription> internal_flags;
+  if (help_res >= 0) {
+    internal_flags = CF_EXPECT(ParseGflagsXmlHelp(stdout_str));
+  } else {
+    LOG(WARNING) << "Could not get the flags of " << bin;
+  }
   bool has_print = std::any_of(
       internal_flags.begin(), internal_flags.end(),
       [](const GflagDescription& desc) { return desc.name == "print"; });
@@ -142,7 +161,7 @@ Result<Json::Value> FetchInstanceStatus(LocalInstance& instance,
   std::string serialized_json;
 
   int res = RunWithManagedStdio(std::move(command), nullptr, &serialized_json,
-                                nullptr /*stderr*/);
+                                nullptr /*stderr*/, deadline);
 
   // old branches will print nothing
   if (serialized_json.empty() && res == 0) {
@@ -172,6 +191,33 @@ Result<Json::Value> FetchInstanceStatus(LocalInstance& instance,
   return instance_status_json;
 }
 
+std::vector<Result<Json::Value>> FetchInstancesStatus(
+    const std::vector<LocalInstance*>& instances, std::chrono::seconds timeout,
+    const InstanceStatusFetcher& fetch) {
+  std::vector<Result<Json::Value>> statuses(instances.size());
+  std::atomic<size_t> next_index = 0;
+  auto fetch_next = [&instances, &statuses, &next_index, &fetch, timeout]() {
+    for (size_t i = next_index++; i < instances.size(); i = next_index++) {
+      statuses[i] = fetch(*instances[i], timeout);
+    }
+  };
+
+  size_t num_workers = std::min(instances.size(), kMaxConcurrentStatusFetches);
+  if (num_workers <= 1) {
+    fetch_next();
+    return statuses;
+  }
+  std::vector<std::future<void>> workers;
+  workers.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers.emplace_back(std::async(std::launch::async, fetch_next));
+  }
+  for (auto& worker : workers) {
+    worker.get();
+  }
+  return statuses;
+}
+
 std::string HumanFriendlyStateName(cvd::InstanceState state) {
   std::string name = cvd::InstanceState_Name(state);
   // Drop the enum name prefix
@@ -19,6 +19,12 @@
 #include <sys/types.h>
 
 #include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "json/value.h"
 
 #include "cuttlefish/host/commands/cvd/instances/cvd_persistent_data.pb.h"
 #include "cuttlefish/host/commands/cvd/instances/local_instance.h"
@@ -26,11 +32,27 @@
 
 namespace cuttlefish {
 
+// Upper bound on the status tools running at the same time.
+inline constexpr size_t kMaxConcurrentStatusFetches = 16;
+
 // Fetches status from a single instance. Waits for each run_cvd process to
-// respond within the given timeout.
+// respond within the given timeout. The status tool itself is killed if it
+// takes much longer than that.
 Result<Json::Value> FetchInstanceStatus(LocalInstance& instance,
                                         std::chrono::seconds timeout);
 
+using InstanceStatusFetcher =
+    std::function<Result<Json::Value>(LocalInstance&, std::chrono::seconds)>;
+
+// Fetches status from all the given instances concurrently, running at most
+// kMaxConcurrentStatusFetches status tools at a time. A status tool that is
+// killed at its deadline is reported like one that failed, with a "warning"
+// and the instance marked unreachable. The output has the same order as
+// `instances`. `fetch` is only replaced in tests.
+std::vector<Result<Json::Value>> FetchInstancesStatus(
+    const std::vector<LocalInstance*>& instances, std::chrono::seconds timeout,
+    const InstanceStatusFetcher& fetch = FetchInstanceStatus);
+
 // The most important thing this function does is turn "INSTANCE_STATE_RUNNING"
 // into "Running". Some external tools (like the host orchestrator) already
 // depend on this string.
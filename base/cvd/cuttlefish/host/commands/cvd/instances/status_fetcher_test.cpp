@@ -0,0 +1,158 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/cvd/instances/status_fetcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json/value.h"
+
+#include "cuttlefish/host/commands/cvd/instances/local_instance.h"
+#include "cuttlefish/host/commands/cvd/instances/local_instance_group.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+
+class FetchInstancesStatusTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    LocalInstanceGroup::Builder builder("group");
+    for (unsigned id = 1; id <= kNumInstances; id++) {
+      builder.AddInstance(id);
+    }
+    Result<LocalInstanceGroup> group = builder.Build();
+    ASSERT_THAT(group, IsOk());
+    group_.emplace(std::move(*group));
+    for (LocalInstance& instance : group_->Instances()) {
+      instances_.push_back(&instance);
+    }
+  }
+
+  static constexpr unsigned kNumInstances = 20;
+  std::optional<LocalInstanceGroup> group_;
+  std::vector<LocalInstance*> instances_;
+};
+
+TEST_F(FetchInstancesStatusTest, InstancesThatAreNotRunningAreNotQueried) {
+  std::vector<Result<Json::Value>> statuses =
+      FetchInstancesStatus(instances_, seconds(1));
+
+  ASSERT_EQ(statuses.size(), kNumInstances);
+  for (size_t i = 0; i < statuses.size(); i++) {
+    ASSERT_THAT(statuses[i], IsOk());
+    EXPECT_EQ((*statuses[i])["instance_name"].asString(),
+              instances_[i]->Name());
+    EXPECT_EQ((*statuses[i])["status"].asString(), "Preparing");
+  }
+}
+
+TEST_F(FetchInstancesStatusTest, KeepsOrderAndBoundsConcurrency) {
+  std::atomic<int> running = 0;
+  std::atomic<int> max_running = 0;
+  auto fetch = [&](LocalInstance& instance, seconds) -> Result<Json::Value> {
+    int now_running = ++running;
+    int expected = max_running;
+    while (now_running > expected &&
+           !max_running.compare_exchange_weak(expected, now_running)) {
+    }
+    // Later instances finish first.
+    std::this_thread::sleep_for(
+        milliseconds(5 * (kNumInstances - instance.Id())));
+    running--;
+    Json::Value status;
+    status["id"] = instance.Id();
+    return status;
+  };
+
+  std::vector<Result<Json::Value>> statuses =
+      FetchInstancesStatus(instances_, seconds(1), fetch);
+
+  ASSERT_EQ(statuses.size(), kNumInstances);
+  for (size_t i = 0; i < statuses.size(); i++) {
+    ASSERT_THAT(statuses[i], IsOk());
+    EXPECT_EQ((*statuses[i])["id"].asUInt(), instances_[i]->Id());
+  }
+  EXPECT_GT(max_running, 1);
+  EXPECT_LE(max_running, kMaxConcurrentStatusFetches);
+}
+
+TEST_F(FetchInstancesStatusTest, ErrorsStayWithTheirInstance) {
+  auto fetch = [](LocalInstance& instance, seconds) -> Result<Json::Value> {
+    CF_EXPECTF(instance.Id() != 3, "instance {} is broken", instance.Id());
+    return Json::Value(instance.Id());
+  };
+
+  std::vector<Result<Json::Value>> statuses =
+      FetchInstancesStatus(instances_, seconds(1), fetch);
+
+  ASSERT_EQ(statuses.size(), kNumInstances);
+  for (size_t i = 0; i < statuses.size(); i++) {
+    if (instances_[i]->Id() == 3) {
+      EXPECT_THAT(statuses[i], IsError());
+    } else {
+      EXPECT_THAT(statuses[i], IsOk());
+    }
+  }
+}
+
+TEST_F(FetchInstancesStatusTest, HungInstanceOnlyDelaysItself) {
+  // Stands in for a status tool that is killed when its deadline passes.
+  auto fetch = [](LocalInstance& instance,
+                  seconds timeout) -> Result<Json::Value> {
+    if (instance.Id() == 1) {
+      std::this_thread::sleep_for(timeout);
+      return CF_ERR("timed out");
+    }
+    std::this_thread::sleep_for(milliseconds(100));
+    return Json::Value(instance.Id());
+  };
+
+  auto start = steady_clock::now();
+  std::vector<Result<Json::Value>> statuses =
+      FetchInstancesStatus(instances_, seconds(1), fetch);
+  auto elapsed = steady_clock::now() - start;
+
+  EXPECT_THAT(statuses[0], IsError());
+  for (size_t i = 1; i < statuses.size(); i++) {
+    EXPECT_THAT(statuses[i], IsOk());
+  }
+  // Sequential fetches would take 1s + 19 * 100ms.
+  EXPECT_GE(elapsed, seconds(1));
+  EXPECT_LT(elapsed, milliseconds(1800));
+}
+
+TEST_F(FetchInstancesStatusTest, GroupStatusListsAllInstances) {
+  Result<Json::Value> status = group_->FetchStatus(seconds(1));
+
+  ASSERT_THAT(status, IsOk());
+  EXPECT_EQ((*status)["group_name"].asString(), "group");
+  EXPECT_EQ((*status)["instances"].size(), kNumInstances);
+}
+
+}  // namespace
+}  // namespace cuttlefish
@@ -99,23 +99,6 @@ Result<void> RunStopCvdAll(bool clear_runtime_dirs) {
   return {};
 }
 
-static bool IsStillRunCvd(const pid_t pid) {
-  std::string pid_dir = fmt::format("/proc/{}", pid);
-  if (!FileExists(pid_dir)) {
-    return false;
-  }
-  auto owner_result = OwnerUid(pid);
-  if (!owner_result.ok() || (getuid() != *owner_result)) {
-    return false;
-  }
-  auto extract_proc_info_result = ExtractProcInfo(pid);
-  if (!extract_proc_info_result.ok()) {
-    return false;
-  }
-  return (android::base::Basename(
-              extract_proc_info_result->actual_exec_path_) == "run_cvd");
-}
-
 Result<void> SendSignal(pid_t pid) {
   int kill_res = kill(pid, SIGKILL);
   CF_EXPECTF(kill_res == 0, "Failed to kill {}: {}", pid, StrError(errno));
@@ -123,10 +106,14 @@ Result<void> SendSignal(pid_t pid) {
 }
 
 Result<void> SendSignal(const GroupProcInfo& group_info) {
+  // The group was collected earlier, skip the processes that are gone since.
+  const ProcessTable process_table = CF_EXPECT(ProcessTable::Scan());
+  const std::vector<pid_t> run_cvd_pids =
+      process_table.PidsByExecName("run_cvd", getuid());
   std::vector<pid_t> failed_pids;
   for (const auto& [unused, instance] : group_info.instances_) {
     for (const auto parent_run_cvd_pid : instance.parent_run_cvd_pids_) {
-      if (!IsStillRunCvd(parent_run_cvd_pid)) {
+      if (!Contains(run_cvd_pids, parent_run_cvd_pid)) {
         continue;
       }
       LOG(INFO) << "Sending SIGKILL to process " << parent_run_cvd_pid;
@@ -14,9 +14,14 @@
  * limitations under the License.
  */
 
+#include <stddef.h>
+
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
 #include <thread>
 
-#include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "gflags/gflags.h"
 #include "grpcpp/create_channel.h"
@@ -25,14 +30,19 @@
 #include "cuttlefish/common/libs/utils/tee_logging.h"
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
 #include "cuttlefish/host/libs/location/GnssClient.h"
+#include "cuttlefish/host/libs/location/GpsFix.h"
+#include "cuttlefish/host/libs/location/GpsTrack.h"
 #include "cuttlefish/host/libs/location/GpxParser.h"
 #include "cuttlefish/host/libs/location/KmlParser.h"
+#include "cuttlefish/result/result.h"
 
 DEFINE_int32(instance_num, 1, "Which instance to read the configs from");
 DEFINE_double(delay, 1.0, "delay interval between different coordinates");
 
-DEFINE_string(format, "", "supported file format, either kml or gpx");
+DEFINE_string(format, "", "supported file format, either kml, gpx or track");
 DEFINE_string(file_path, "", "path to input file location {Kml or gpx} format");
+DEFINE_string(track_output, "",
+              "path to also save the locations to as a precompiled track");
 
 const char* kUsageMessage = R""""(gps locations import commandline utility
 
@@ -44,11 +54,16 @@ arguments:
     input file format for cvd_import_locations
         "gpx" for gpx input data file
         "kml" for kml input data file
+        "track" for a track file saved with --track_output
 
   --file_path=[path]
     gps locations input file path
     if path is not specified, error will be reported
 
+  --track_output=[path]
+    also save the imported locations as a precompiled track, which later
+    imports read without parsing
+
   --delay=[delay_value]
     delay between different gps locations ( double , default value is 1.0 second)
 
@@ -65,25 +80,24 @@ examples:
 
     cvd_import_locations --format="gpx" --file_path="input.gpx" --delay=.5 --instance_num=2
 
+    cvd_import_locations --format="gpx" --file_path="input.gpx" --track_output="input.track"
+    cvd_import_locations --format="track" --file_path="input.track"
+
 )"""";
 namespace cuttlefish {
 namespace {
 
-int ImportLocationsCvdMain(int argc, char** argv) {
+Result<void> ImportLocationsCvdMain(int argc, char** argv) {
   LogToStderr();
   google::ParseCommandLineFlags(&argc, &argv, true);
 
   auto config = CuttlefishConfig::Get();
-  if (!config) {
-    LOG(ERROR) << "Failed to obtain config object";
-    return 1;
-  }
-  std::set<std::string> supportedFormat = {"gpx", "GPX", "kml", "KML"};
+  CF_EXPECT(config != nullptr, "Failed to obtain config object");
+  std::set<std::string> supportedFormat = {"gpx", "GPX", "kml",
+                                           "KML", "track", "TRACK"};
 
-  if (supportedFormat.count(FLAGS_format) == 0) {
-    LOG(ERROR) << "Unsupported parsing format" << std::endl;
-    return 1;
-  }
+  CF_EXPECT(supportedFormat.count(FLAGS_format) != 0,
+            "Unsupported parsing format");
   LOG(INFO) << FLAGS_format << " Supported format" << std::endl;
   auto instance = config->ForInstance(FLAGS_instance_num);
   auto server_port = instance.gnss_grpc_proxy_server_port();
@@ -92,33 +106,44 @@ int ImportLocationsCvdMain(int argc, char** argv) {
   GnssClient gpsclient(
       grpc::CreateChannel(socket_name, grpc::InsecureChannelCredentials()));
 
-  GpsFixArray coordinates;
-  std::string error;
-  bool isOk = false;
-
   LOG(INFO) << "Server port: " << server_port << " socket: " << socket_name
             << std::endl;
+
+  // Locations are sent while the file is parsed, so the device starts moving
+  // before a long track is fully read.
+  int delay = (int)(1000 * FLAGS_delay);
+  std::unique_ptr<GpsLocationStream> stream =
+      gpsclient.StreamGpsLocations(delay);
+  GpsTrackWriter track;
+  size_t count = 0;
+  GpsFixCallback onFix = [&](const GpsFix& fix) -> Result<void> {
+    CF_EXPECT(stream->Send(fix), "Failed to send gps location data");
+    if (!FLAGS_track_output.empty()) {
+      track.Add(fix);
+    }
+    count++;
+    return {};
+  };
+
   if (FLAGS_format == "gpx" || FLAGS_format == "GPX") {
-    isOk = GpxParser::parseFile(FLAGS_file_path.c_str(), &coordinates, &error);
+    CF_EXPECT(GpxParser::streamFile(FLAGS_file_path, onFix), "Parsing Error");
   } else if (FLAGS_format == "kml" || FLAGS_format == "KML") {
-    isOk = KmlParser::parseFile(FLAGS_file_path.c_str(), &coordinates, &error);
+    CF_EXPECT(KmlParser::streamFile(FLAGS_file_path, onFix), "Parsing Error");
+  } else {
+    std::unique_ptr<GpsTrack> input = CF_EXPECT(GpsTrack::Map(FLAGS_file_path));
+    for (size_t i = 0; i < input->size(); i++) {
+      CF_EXPECT(onFix(input->At(i)));
+    }
   }
 
-  LOG(INFO) << "Number of parsed points: " << coordinates.size() << std::endl;
+  LOG(INFO) << "Number of parsed points: " << count << std::endl;
 
-  if (!isOk) {
-    LOG(ERROR) << " Parsing Error: " << error << std::endl;
-    return 1;
-  }
-
-  int delay = (int)(1000 * FLAGS_delay);
-  auto status = gpsclient.SendGpsLocations(delay, coordinates);
-  CHECK(status.ok()) << "Failed to send gps location data \n";
-  if (!status.ok()) {
-    return 1;
+  CF_EXPECT(stream->Finish(), "Failed to send gps location data");
+  if (!FLAGS_track_output.empty()) {
+    CF_EXPECT(track.WriteToFile(FLAGS_track_output));
   }
   std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-  return 0;
+  return {};
 }
 
 }  // namespace
@@ -126,5 +151,11 @@ int ImportLocationsCvdMain(int argc, char** argv) {
 
 int main(int argc, char** argv) {
   gflags::SetUsageMessage(kUsageMessage);
-  return cuttlefish::ImportLocationsCvdMain(argc, argv);
+  cuttlefish::Result<void> result =
+      cuttlefish::ImportLocationsCvdMain(argc, argv);
+  if (!result.ok()) {
+    LOG(ERROR) << result.error();
+    return 1;
+  }
+  return 0;
 }
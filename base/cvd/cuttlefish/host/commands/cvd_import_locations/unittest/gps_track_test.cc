@@ -0,0 +1,107 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/location/GpsTrack.h"
+
+#include <memory>
+#include <string>
+
+#include "android-base/file.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/host/libs/location/GpsFix.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+GpsFix Fix(float latitude, float longitude, float elevation, time_t time,
+           std::string name = "", std::string description = "") {
+  GpsFix fix;
+  fix.latitude = latitude;
+  fix.longitude = longitude;
+  fix.elevation = elevation;
+  fix.time = time;
+  fix.name = std::move(name);
+  fix.description = std::move(description);
+  return fix;
+}
+
+GpsTrackWriter ThreeFixes() {
+  GpsTrackWriter writer;
+  writer.Add(Fix(37.42f, -122.08f, 10.5f, 1000, "Start", "Parking lot"));
+  writer.Add(Fix(37.43f, -122.09f, 11.0f, 1001));
+  writer.Add(Fix(37.44f, -122.10f, 12.0f, 1003, "", "Finish line"));
+  return writer;
+}
+
+TEST(GpsTrack, ReadsBackFixes) {
+  Result<std::string> bytes = ThreeFixes().Serialize();
+  ASSERT_THAT(bytes, IsOk());
+
+  Result<std::unique_ptr<GpsTrack>> track = GpsTrack::FromBytes(*bytes);
+
+  ASSERT_THAT(track, IsOk());
+  ASSERT_EQ((*track)->size(), 3);
+  EXPECT_FLOAT_EQ((*track)->Latitude(1), 37.43f);
+  EXPECT_FLOAT_EQ((*track)->Longitude(2), -122.10f);
+  EXPECT_FLOAT_EQ((*track)->Elevation(0), 10.5f);
+  EXPECT_EQ((*track)->Time(2), 1003);
+  EXPECT_EQ((*track)->Name(0), "Start");
+  EXPECT_EQ((*track)->Description(0), "Parking lot");
+  EXPECT_EQ((*track)->Name(1), "");
+  EXPECT_EQ((*track)->Description(1), "");
+  GpsFix last = (*track)->At(2);
+  EXPECT_EQ(last.name, "");
+  EXPECT_EQ(last.description, "Finish line");
+}
+
+TEST(GpsTrack, MapsWrittenFile) {
+  TemporaryDir dir;
+  std::string path = std::string(dir.path) + "/route.track";
+  ASSERT_THAT(ThreeFixes().WriteToFile(path), IsOk());
+
+  Result<std::unique_ptr<GpsTrack>> track = GpsTrack::Map(path);
+
+  ASSERT_THAT(track, IsOk());
+  ASSERT_EQ((*track)->size(), 3);
+  EXPECT_EQ((*track)->At(0).name, "Start");
+}
+
+TEST(GpsTrack, EmptyTrack) {
+  Result<std::string> bytes = GpsTrackWriter().Serialize();
+  ASSERT_THAT(bytes, IsOk());
+
+  Result<std::unique_ptr<GpsTrack>> track = GpsTrack::FromBytes(*bytes);
+
+  ASSERT_THAT(track, IsOk());
+  EXPECT_EQ((*track)->size(), 0);
+}
+
+TEST(GpsTrack, RejectsInvalidData) {
+  Result<std::string> bytes = ThreeFixes().Serialize();
+  ASSERT_THAT(bytes, IsOk());
+
+  EXPECT_THAT(GpsTrack::FromBytes("not a track"), IsError());
+  EXPECT_THAT(GpsTrack::FromBytes(bytes->substr(0, bytes->size() - 1)),
+              IsError());
+  std::string corrupt = *bytes;
+  corrupt[0] = 'X';
+  EXPECT_THAT(GpsTrack::FromBytes(corrupt), IsError());
+}
+
+}  // namespace
+}  // namespace cuttlefish
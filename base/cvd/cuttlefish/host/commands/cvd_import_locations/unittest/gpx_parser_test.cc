@@ -15,6 +15,8 @@
  */
 
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include "android-base/file.h"
 #include "gtest/gtest.h"
@@ -22,6 +24,8 @@
 #include "cuttlefish/host/libs/location/GpsFix.h"
 #include "cuttlefish/host/libs/location/GpxParser.h"
 #include "cuttlefish/host/libs/location/StringParse.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
 
 namespace cuttlefish {
 
@@ -380,4 +384,57 @@ TEST(GpxParser, ParseValidDocumentString) {
   EXPECT_EQ("Trkpt 2-2", locations[7].name);
 }
 
+char kUnsortedText[] =
+    "<?xml version=\"1.0\"?>"
+    "<gpx>"
+    "<wpt lat=\"1\" lon=\"2\">"
+    "<time>2012-01-01T10:00:00Z</time><name>Later</name><ele>5</ele>"
+    "</wpt>"
+    "<trk><trkseg>"
+    "<trkpt lat=\"3\" lon=\"4\"><time>2012-01-01T09:00:00Z</time></trkpt>"
+    "</trkseg></trk>"
+    "</gpx>";
+TEST(GpxParser, StreamStringInDocumentOrder) {
+  std::vector<GpsFix> streamed;
+  Result<void> result = GpxParser::streamString(
+      kUnsortedText, [&streamed](const GpsFix& fix) -> Result<void> {
+        streamed.push_back(fix);
+        return {};
+      });
+
+  ASSERT_THAT(result, IsOk());
+  ASSERT_EQ(2U, streamed.size());
+  EXPECT_EQ("Later", streamed[0].name);
+  EXPECT_FLOAT_EQ(5, streamed[0].elevation);
+  // Fields of one point do not carry over to the next.
+  EXPECT_EQ("", streamed[1].name);
+  EXPECT_FLOAT_EQ(0, streamed[1].elevation);
+  EXPECT_EQ(3600, streamed[0].time - streamed[1].time);
+
+  GpsFixArray sorted;
+  std::string error;
+  ASSERT_TRUE(ParseGpxString(&sorted, kUnsortedText, &error));
+  ASSERT_EQ(2U, sorted.size());
+  EXPECT_EQ("Later", sorted[1].name);
+}
+
+TEST(GpxParser, StreamStopsOnCallbackError) {
+  int calls = 0;
+  Result<void> result = GpxParser::streamString(
+      kValidDocumentText, [&calls](const GpsFix&) -> Result<void> {
+        calls++;
+        return CF_ERR("Stop");
+      });
+
+  EXPECT_THAT(result, IsError());
+  EXPECT_EQ(1, calls);
+}
+
+TEST(GpxParser, StreamFileNotFound) {
+  Result<void> result = GpxParser::streamFile(
+      "i_dont_exist.gpx", [](const GpsFix&) -> Result<void> { return {}; });
+
+  EXPECT_THAT(result, IsError());
+}
+
 }  // namespace cuttlefish
\ No newline at end of file
@@ -15,13 +15,18 @@
  */
 
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include "android-base/file.h"
+#include "fmt/format.h"
 #include "gtest/gtest.h"
 
 #include "cuttlefish/host/libs/location/GpsFix.h"
 #include "cuttlefish/host/libs/location/KmlParser.h"
 #include "cuttlefish/host/libs/location/StringParse.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
 
 namespace cuttlefish {
 namespace {
@@ -660,4 +665,75 @@ TEST(KmlParser, ParsePlacemarkNullNameNoCrashString) {
   EXPECT_STREQ("", locations.front().description.c_str());
 }
 
+std::vector<GpsFix> StreamKml(const std::string& text) {
+  std::vector<GpsFix> fixes;
+  Result<void> result = KmlParser::streamString(
+      text, [&fixes](const GpsFix& fix) -> Result<void> {
+        fixes.push_back(fix);
+        return {};
+      });
+  EXPECT_THAT(result, IsOk());
+  return fixes;
+}
+
+TEST(KmlParser, StreamLongLineString) {
+  // Much larger than the chunks given to the parser, so numbers are split
+  // between pieces of text.
+  std::string text =
+      "<?xml version=\"1.0\"?><kml><Placemark><name>Drive</name>"
+      "<LineString><coordinates>\n";
+  constexpr int kFixes = 20000;
+  for (int i = 0; i < kFixes; i++) {
+    text += fmt::format("  -122.{:06d} , 37.{:06d},{} \n", i, i, i % 100);
+  }
+  text += "</coordinates></LineString></Placemark></kml>";
+
+  std::vector<GpsFix> fixes = StreamKml(text);
+
+  ASSERT_EQ(kFixes, fixes.size());
+  EXPECT_EQ("Drive", fixes[0].name);
+  EXPECT_EQ("", fixes[1].name);
+  EXPECT_FLOAT_EQ(-122.012345, fixes[12345].longitude);
+  EXPECT_FLOAT_EQ(37.012345, fixes[12345].latitude);
+  EXPECT_FLOAT_EQ(45, fixes[12345].elevation);
+}
+
+TEST(KmlParser, StreamGxTrack) {
+  std::vector<GpsFix> fixes = StreamKml(
+      "<?xml version=\"1.0\"?>"
+      "<kml xmlns:gx=\"http://www.google.com/kml/ext/2.2\"><Placemark>"
+      "<gx:Track>"
+      "<gx:coord>-122.1 37.1 10</gx:coord>"
+      "<gx:coord>-122.2 37.2 20</gx:coord>"
+      "</gx:Track>"
+      "<description>After the track</description>"
+      "</Placemark></kml>");
+
+  ASSERT_EQ(2U, fixes.size());
+  EXPECT_FLOAT_EQ(-122.2, fixes[1].longitude);
+  EXPECT_FLOAT_EQ(20, fixes[1].elevation);
+  // The first fix was sent before the description was read.
+  EXPECT_EQ("", fixes[0].description);
+}
+
+TEST(KmlParser, StreamPointWithTrailingDescription) {
+  std::vector<GpsFix> fixes = StreamKml(
+      "<?xml version=\"1.0\"?><kml><Placemark>"
+      "<Point><coordinates>-122.1,37.1,0</coordinates></Point>"
+      "<description>After the point</description>"
+      "</Placemark></kml>");
+
+  ASSERT_EQ(1U, fixes.size());
+  EXPECT_EQ("After the point", fixes[0].description);
+}
+
+TEST(KmlParser, StreamRejectsTupleWithoutAltitude) {
+  Result<void> result = KmlParser::streamString(
+      "<kml><Placemark><Point><coordinates>-122.1,37.1</coordinates></Point>"
+      "</Placemark></kml>",
+      [](const GpsFix&) -> Result<void> { return {}; });
+
+  EXPECT_THAT(result, IsError());
+}
+
 }  // namespace cuttlefish
\ No newline at end of file
@@ -0,0 +1,152 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Imports a synthetic drive track, one fix per second, as a GPX document, as a
+// KML LineString and as a precompiled track. The range is the number of fixes;
+// 36000 is a ten hour drive.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "fmt/format.h"
+
+#include "cuttlefish/host/libs/location/GpsFix.h"
+#include "cuttlefish/host/libs/location/GpsTrack.h"
+#include "cuttlefish/host/libs/location/GpxParser.h"
+#include "cuttlefish/host/libs/location/KmlParser.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+double Latitude(int64_t i) { return 37.0 + i * 1e-5; }
+double Longitude(int64_t i) { return -122.0 - i * 1e-5; }
+
+std::string GpxTrack(int64_t fixes) {
+  std::string text = "<?xml version=\"1.0\"?><gpx><trk><trkseg>\n";
+  for (int64_t i = 0; i < fixes; i++) {
+    text += fmt::format(
+        "<trkpt lat=\"{:.7f}\" lon=\"{:.7f}\"><ele>{}</ele>"
+        "<time>2024-05-01T{:02d}:{:02d}:{:02d}Z</time></trkpt>\n",
+        Latitude(i), Longitude(i), 10 + i % 50, (i / 3600) % 24,
+        (i / 60) % 60, i % 60);
+  }
+  text += "</trkseg></trk></gpx>\n";
+  return text;
+}
+
+std::string KmlTrack(int64_t fixes) {
+  std::string text =
+      "<?xml version=\"1.0\"?><kml><Placemark><name>Drive</name>"
+      "<LineString><coordinates>\n";
+  for (int64_t i = 0; i < fixes; i++) {
+    text += fmt::format("{:.7f},{:.7f},{}\n", Longitude(i), Latitude(i),
+                        10 + i % 50);
+  }
+  text += "</coordinates></LineString></Placemark></kml>\n";
+  return text;
+}
+
+std::string PrecompiledTrack(int64_t fixes) {
+  GpsTrackWriter writer;
+  GpsFixCallback add = [&writer](const GpsFix& fix) -> Result<void> {
+    writer.Add(fix);
+    return {};
+  };
+  Result<void> parsed = GpxParser::streamString(GpxTrack(fixes), add);
+  Result<std::string> bytes = writer.Serialize();
+  return parsed.ok() && bytes.ok() ? *bytes : "";
+}
+
+GpsFixCallback CountFixes(size_t& count) {
+  return [&count](const GpsFix& fix) -> Result<void> {
+    benchmark::DoNotOptimize(fix.latitude);
+    count++;
+    return {};
+  };
+}
+
+void BM_GpxParseString(benchmark::State& state) {
+  std::string text = GpxTrack(state.range(0));
+  for (auto _ : state) {
+    GpsFixArray fixes;
+    std::string error;
+    if (!GpxParser::parseString(text.data(), text.size(), &fixes, &error)) {
+      state.SkipWithError(error.c_str());
+      return;
+    }
+    benchmark::DoNotOptimize(fixes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_GpxParseString)->Arg(1000)->Arg(36000);
+
+void BM_GpxStreamString(benchmark::State& state) {
+  std::string text = GpxTrack(state.range(0));
+  for (auto _ : state) {
+    size_t count = 0;
+    if (!GpxParser::streamString(text, CountFixes(count)).ok()) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_GpxStreamString)->Arg(1000)->Arg(36000);
+
+void BM_KmlStreamString(benchmark::State& state) {
+  std::string text = KmlTrack(state.range(0));
+  for (auto _ : state) {
+    size_t count = 0;
+    if (!KmlParser::streamString(text, CountFixes(count)).ok()) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_KmlStreamString)->Arg(1000)->Arg(36000);
+
+void BM_TrackRead(benchmark::State& state) {
+  std::string bytes = PrecompiledTrack(state.range(0));
+  for (auto _ : state) {
+    Result<std::unique_ptr<GpsTrack>> track = GpsTrack::FromBytes(bytes);
+    if (!track.ok()) {
+      state.SkipWithError("Invalid track");
+      return;
+    }
+    size_t count = 0;
+    GpsFixCallback onFix = CountFixes(count);
+    for (size_t i = 0; i < (*track)->size(); i++) {
+      if (!onFix((*track)->At(i)).ok()) {
+        state.SkipWithError("Callback failed");
+        return;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_TrackRead)->Arg(1000)->Arg(36000);
+
+}  // namespace
+}  // namespace cuttlefish
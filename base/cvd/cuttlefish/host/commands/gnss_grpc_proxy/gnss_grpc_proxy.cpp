@@ -15,29 +15,36 @@
  */
 
 #include <chrono>
-#include <fstream>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "absl/log/log.h"
 #include "absl/strings/match.h"
-#include "absl/strings/str_split.h"
+#include "absl/strings/str_cat.h"
 #include "gflags/gflags.h"
 #include "grpcpp/ext/proto_server_reflection_plugin.h"
 #include "grpcpp/health_check_service_interface.h"
 #include "grpcpp/server.h"
 #include "grpcpp/server_builder.h"
 #include "grpcpp/server_context.h"
+#include "grpcpp/support/sync_stream.h"
 
 #include "cuttlefish/common/libs/fs/shared_buf.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/host/commands/gnss_grpc_proxy/gnss_grpc_proxy.grpc.pb.h"
+#include "cuttlefish/host/commands/gnss_grpc_proxy/gnss_timeline.h"
 #include "cuttlefish/host/libs/config/logging.h"
 
+using cuttlefish::GnssRecordKind;
+using cuttlefish::GnssReplay;
+using cuttlefish::GnssTimeline;
 using gnss_grpc_proxy::GnssGrpcProxy;
 using gnss_grpc_proxy::SendGpsCoordinatesReply;
 using gnss_grpc_proxy::SendGpsCoordinatesRequest;
@@ -46,6 +53,7 @@ using gnss_grpc_proxy::SendGpsRequest;
 using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::ServerContext;
+using grpc::ServerReader;
 using grpc::Status;
 
 DEFINE_int32(gnss_in_fd, -1, "File descriptor for the gnss's input channel");
@@ -63,6 +71,11 @@ DEFINE_string(gnss_file_path, "",
               "gnss raw measurement file path for gnss grpc");
 DEFINE_string(fixed_location_file_path, "",
               "fixed location file path for gnss grpc");
+DEFINE_double(replay_speed, 1.0,
+              "How many times faster than recorded to replay the files");
+DEFINE_string(timeline_cache_dir, "",
+              "Directory to keep the parsed files in, shared by the proxies "
+              "replaying the same files");
 
 constexpr char CMD_GET_LOCATION[] = "CMD_GET_LOCATION";
 constexpr char CMD_GET_RAWMEASUREMENT[] = "CMD_GET_RAWMEASUREMENT";
@@ -131,6 +144,26 @@ class GnssGrpcProxyServiceImpl final : public GnssGrpcProxy::Service {
     return Status::OK;
   }
 
+  Status StreamGpsVector(ServerContext* context,
+                         ServerReader<SendGpsCoordinatesRequest>* reader,
+                         SendGpsCoordinatesReply* reply) override {
+    SendGpsCoordinatesRequest request;
+    bool first = true;
+    while (reader->Read(&request)) {
+      std::lock_guard<std::mutex> lock(fixed_locations_queue_mutex_);
+      if (first) {
+        fixed_locations_queue_ = {};
+        fixed_locations_delay_ = request.delay();
+        first = false;
+      }
+      for (const auto& loc : request.coordinates()) {
+        fixed_locations_queue_.push(ConvertCoordinate(loc));
+      }
+    }
+    reply->set_status(SendGpsCoordinatesReply::OK);
+    return Status::OK;
+  }
+
   void sendToSerial() {
     std::lock_guard<std::mutex> lock(cached_fixed_location_mutex);
     ssize_t bytes_written = cuttlefish::WriteAll(
@@ -153,8 +186,8 @@ class GnssGrpcProxyServiceImpl final : public GnssGrpcProxy::Service {
       VLOG(0) << "Skip same record";
       previous_cached_gnss_raw = cached_gnss_raw;
     }
-    ssize_t bytes_written =
-        cuttlefish::WriteAll(gnss_in_, cached_gnss_raw + END_OF_MSG_MARK);
+    ssize_t bytes_written = cuttlefish::WriteAll(
+        gnss_in_, absl::StrCat(cached_gnss_raw, END_OF_MSG_MARK));
     VLOG(0) << "Send Gnss Raw to serial: bytes_written: " << bytes_written;
     if (bytes_written < 0) {
       LOG(ERROR) << "Error writing to fd: " << gnss_in_->StrError();
@@ -170,105 +203,25 @@ class GnssGrpcProxyServiceImpl final : public GnssGrpcProxy::Service {
     fixed_location_read_thread_ = std::thread([this]() { ReadFixedLocLoop(); });
   }
 
-  void StartReadFixedLocationFileThread() {
-    // Create a new thread to read fixed_location data.
-    fixed_location_file_read_thread_ =
-        std::thread([this]() { ReadFixedLocationFromLocalFile(); });
+  void ReplayFixedLocations(GnssReplay replay) {
+    fixed_location_replay_.emplace(std::move(replay));
   }
 
-  void StartReadGnssRawMeasurementFileThread() {
-    // Create a new thread to read raw measurement data.
-    measurement_file_read_thread_ =
-        std::thread([this]() { ReadGnssRawMeasurement(); });
+  void ReplayMeasurements(GnssReplay replay) {
+    measurement_replay_.emplace(std::move(replay));
   }
 
-  void ReadFixedLocationFromLocalFile() {
-    std::ifstream file(FLAGS_fixed_location_file_path);
-    if (file.is_open()) {
-      std::string line;
-      while (std::getline(file, line)) {
-        /* Only support fix location format to make it simple.
-         * Records will only contains 'Fix' prefix.
-         * Sample line:
-         * Fix,GPS,37.7925002,-122.3979132,13.462797,0.000000,48.000000,0.000000,1593029872254,0.581968,0.000000
-         * Sending at 1Hz, currently user should provide a fixed location
-         * file that has one location per second. need some extra work to
-         * make it more generic, i.e. align with the timestamp in the file.
-         */
-        {
-          std::lock_guard<std::mutex> lock(cached_fixed_location_mutex);
-          cached_fixed_location = line;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-      }
-      file.close();
-    } else {
-      LOG(ERROR) << "Can not open fixed location file: "
-                 << FLAGS_gnss_file_path;
-      return;
-    }
-  }
-
-  void ReadGnssRawMeasurement() {
-    std::ifstream file(FLAGS_gnss_file_path);
-
-    if (file.is_open()) {
-      std::string line;
-      std::string cached_line = "";
-      std::string header = "";
-
-      while (!cached_line.empty() || std::getline(file, line)) {
-        if (!cached_line.empty()) {
-          line = cached_line;
-          cached_line = "";
-        }
-
-        // Get data header.
-        if (header.empty() && absl::StartsWith(line, "# Raw")) {
-          header = line;
-          VLOG(0) << "Header: " << header;
-          continue;
-        }
-
-        // Ignore not raw measurement data.
-        if (!absl::StartsWith(line, "Raw")) {
-          continue;
-        }
-
-        {
-          std::lock_guard<std::mutex> lock(cached_gnss_raw_mutex);
-          cached_gnss_raw = header + "\n" + line;
-
-          std::string new_line = "";
-          while (std::getline(file, new_line)) {
-            // Group raw data by TimeNanos.
-            if (getTimeNanosFromLine(new_line) == getTimeNanosFromLine(line)) {
-              cached_gnss_raw += "\n" + new_line;
-            } else {
-              cached_line = new_line;
-              break;
-            }
-          }
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-      }
-      file.close();
-    } else {
-      LOG(ERROR) << "Can not open GNSS Raw file: " << FLAGS_gnss_file_path;
-      return;
-    }
+  void StartReplayThread() {
+    replay_thread_ = std::thread([this]() { ReplayLoop(); });
   }
 
   ~GnssGrpcProxyServiceImpl() {
-    if (fixed_location_file_read_thread_.joinable()) {
-      fixed_location_file_read_thread_.join();
+    if (replay_thread_.joinable()) {
+      replay_thread_.join();
     }
     if (fixed_location_write_thread_.joinable()) {
       fixed_location_write_thread_.join();
     }
-    if (measurement_file_read_thread_.joinable()) {
-      measurement_file_read_thread_.join();
-    }
     if (measurement_read_thread_.joinable()) {
       measurement_read_thread_.join();
     }
@@ -278,6 +231,46 @@ class GnssGrpcProxyServiceImpl final : public GnssGrpcProxy::Service {
   }
 
  private:
+  // Makes the record of each replayed file that is due the current one,
+  // sleeping until the next record of either file is due.
+  void ReplayLoop() {
+    std::optional<size_t> fixed_location_index;
+    std::optional<size_t> measurement_index;
+    while (true) {
+      auto now = std::chrono::steady_clock::now();
+      std::optional<std::chrono::steady_clock::time_point> next;
+      auto schedule = [&next](auto change) {
+        if (change && (!next || *change < *next)) {
+          next = change;
+        }
+      };
+      if (fixed_location_replay_) {
+        size_t index = fixed_location_replay_->IndexAt(now);
+        if (index != fixed_location_index) {
+          fixed_location_index = index;
+          std::lock_guard<std::mutex> lock(cached_fixed_location_mutex);
+          cached_fixed_location =
+              fixed_location_replay_->timeline().Record(index);
+        }
+        schedule(fixed_location_replay_->NextChange(index));
+      }
+      if (measurement_replay_) {
+        size_t index = measurement_replay_->IndexAt(now);
+        if (index != measurement_index) {
+          measurement_index = index;
+          std::lock_guard<std::mutex> lock(cached_gnss_raw_mutex);
+          cached_gnss_raw = measurement_replay_->timeline().Record(index);
+        }
+        schedule(measurement_replay_->NextChange(index));
+      }
+      if (!next) {
+        // The last records stay current.
+        return;
+      }
+      std::this_thread::sleep_until(*next);
+    }
+  }
+
   void SendCommand(std::string command, cuttlefish::SharedFD source_out,
                    int out_fd) {
     std::vector<char> buffer(GNSS_SERIAL_BUFFER_SIZE);
@@ -346,13 +339,7 @@ class GnssGrpcProxyServiceImpl final : public GnssGrpcProxy::Service {
     }
   }
 
-  std::string getTimeNanosFromLine(const std::string& line) {
-    // TimeNanos is in column #3.
-    std::vector<std::string> vals = absl::StrSplit(line, ',');
-    return vals.size() >= 3 ? vals[2] : "-1";
-  }
-
-  bool isGnssRawMeasurement(const std::string& inputStr) {
+  bool isGnssRawMeasurement(std::string_view inputStr) {
     // TODO: add more logic check to by pass invalid data.
     return !inputStr.empty() && absl::StartsWith(inputStr, "# Raw");
   }
@@ -364,15 +351,18 @@ class GnssGrpcProxyServiceImpl final : public GnssGrpcProxy::Service {
 
   std::thread measurement_read_thread_;
   std::thread fixed_location_read_thread_;
-  std::thread fixed_location_file_read_thread_;
   std::thread fixed_location_write_thread_;
-  std::thread measurement_file_read_thread_;
+  std::thread replay_thread_;
+
+  std::optional<GnssReplay> fixed_location_replay_;
+  std::optional<GnssReplay> measurement_replay_;
 
   std::string cached_fixed_location;
   std::mutex cached_fixed_location_mutex;
 
-  std::string cached_gnss_raw;
-  std::string previous_cached_gnss_raw;
+  // Records of the replayed measurements file.
+  std::string_view cached_gnss_raw;
+  std::string_view previous_cached_gnss_raw;
   std::mutex cached_gnss_raw_mutex;
 
   std::queue<std::string> fixed_locations_queue_;
@@ -419,13 +409,48 @@ void RunServer() {
     return;
   }
 
+  if (FLAGS_replay_speed <= 0) {
+    LOG(ERROR) << "Invalid replay speed: " << FLAGS_replay_speed;
+    return;
+  }
+
   GnssGrpcProxyServiceImpl service(gnss_in, gnss_out, fixed_location_in,
                                    fixed_location_out);
   service.StartServer();
   if (!FLAGS_gnss_file_path.empty()) {
-    // TODO: On-demand start the read file threads according to data type.
-    service.StartReadFixedLocationFileThread();
-    service.StartReadGnssRawMeasurementFileThread();
+    // The files are only replayed in the local mode, in the gRPC mode the
+    // locations come from the clients.
+    std::unique_ptr<GnssTimeline> fixed_locations;
+    if (!FLAGS_fixed_location_file_path.empty()) {
+      auto timeline = cuttlefish::LoadGnssTimeline(
+          GnssRecordKind::kFixedLocation, FLAGS_fixed_location_file_path,
+          FLAGS_timeline_cache_dir);
+      if (timeline.ok()) {
+        fixed_locations = std::move(*timeline);
+      } else {
+        LOG(ERROR) << "Can not load fixed location file: " << timeline.error();
+      }
+    }
+    std::unique_ptr<GnssTimeline> measurements;
+    auto timeline = cuttlefish::LoadGnssTimeline(
+        GnssRecordKind::kRawMeasurement, FLAGS_gnss_file_path,
+        FLAGS_timeline_cache_dir);
+    if (timeline.ok()) {
+      measurements = std::move(*timeline);
+    } else {
+      LOG(ERROR) << "Can not load GNSS Raw file: " << timeline.error();
+    }
+    // Both files are replayed from the same start.
+    auto replay_start = std::chrono::steady_clock::now();
+    if (fixed_locations) {
+      service.ReplayFixedLocations(GnssReplay(
+          std::move(fixed_locations), FLAGS_replay_speed, replay_start));
+    }
+    if (measurements) {
+      service.ReplayMeasurements(GnssReplay(
+          std::move(measurements), FLAGS_replay_speed, replay_start));
+    }
+    service.StartReplayThread();
 
     // In the local mode, we are not start a grpc server, use a infinite loop
     // instead
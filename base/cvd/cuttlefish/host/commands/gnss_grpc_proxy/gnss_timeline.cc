@@ -0,0 +1,360 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/gnss_grpc_proxy/gnss_timeline.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fmt/format.h"
+
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/files/file_exists.h"
+#include "cuttlefish/host/libs/location/MappedFile.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+// File layout: a header, `count` entries, then the text of the records.
+constexpr char kMagic[8] = {'C', 'F', 'G', 'N', 'S', 'S', 'T', 'L'};
+constexpr uint32_t kVersion = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t kind;
+  uint64_t count;
+};
+static_assert(sizeof(Header) == 24);
+
+struct Entry {
+  int64_t time_ns;
+  // Relative to the end of the entries.
+  uint32_t offset;
+  uint32_t size;
+};
+static_assert(sizeof(Entry) == 16);
+
+constexpr int64_t kDefaultRecordInterval = 1'000'000'000;
+
+std::string_view Field(std::string_view line, size_t index) {
+  for (size_t i = 0; i < index; i++) {
+    size_t comma = line.find(',');
+    if (comma == std::string_view::npos) {
+      return {};
+    }
+    line.remove_prefix(comma + 1);
+  }
+  return line.substr(0, line.find(','));
+}
+
+std::optional<int64_t> ParseInt64(std::string_view str) {
+  int64_t value = 0;
+  auto [end, error] = std::from_chars(str.data(), str.data() + str.size(),
+                                      value);
+  if (str.empty() || error != std::errc() || end != str.data() + str.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+class TimelineBuilder {
+ public:
+  void Add(std::optional<int64_t> time_ns, std::string_view text) {
+    int64_t relative;
+    if (entries_.empty()) {
+      relative = 0;
+    } else if (time_ns && first_time_ns_ &&
+               *time_ns - *first_time_ns_ >= entries_.back().time_ns) {
+      relative = *time_ns - *first_time_ns_;
+    } else {
+      relative = entries_.back().time_ns + kDefaultRecordInterval;
+    }
+    if (entries_.empty()) {
+      first_time_ns_ = time_ns;
+    }
+    entries_.push_back(Entry{
+        .time_ns = relative,
+        .offset = static_cast<uint32_t>(data_.size()),
+        .size = static_cast<uint32_t>(text.size()),
+    });
+    data_ += text;
+  }
+
+  Result<std::string> Build(GnssRecordKind kind) {
+    CF_EXPECT(!entries_.empty(), "No records found");
+    CF_EXPECT(data_.size() <= UINT32_MAX, "Too much record data");
+    Header header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.kind = static_cast<uint32_t>(kind);
+    header.count = entries_.size();
+
+    std::string bytes;
+    bytes.reserve(sizeof(header) + entries_.size() * sizeof(Entry) +
+                  data_.size());
+    bytes.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes.append(reinterpret_cast<const char*>(entries_.data()),
+                 entries_.size() * sizeof(Entry));
+    bytes += data_;
+    return bytes;
+  }
+
+ private:
+  std::vector<Entry> entries_;
+  std::string data_;
+  std::optional<int64_t> first_time_ns_;
+};
+
+template <typename F>
+void ForEachLine(std::string_view text, F callback) {
+  while (!text.empty()) {
+    size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    callback(line);
+  }
+}
+
+Result<std::string> CompileFixedLocations(std::string_view text) {
+  TimelineBuilder builder;
+  ForEachLine(text, [&builder](std::string_view line) {
+    if (!line.starts_with("Fix")) {
+      return;
+    }
+    // Fix,Provider,Latitude,Longitude,Altitude,Speed,Accuracy,Bearing,UnixMs
+    std::optional<int64_t> time_ms = ParseInt64(Field(line, 8));
+    std::optional<int64_t> time_ns;
+    if (time_ms) {
+      time_ns = *time_ms * 1'000'000;
+    }
+    builder.Add(time_ns, line);
+  });
+  return CF_EXPECT(builder.Build(GnssRecordKind::kFixedLocation));
+}
+
+Result<std::string> CompileRawMeasurements(std::string_view text) {
+  TimelineBuilder builder;
+  std::string_view header;
+  // Consecutive measurements with the same TimeNanos make up one record.
+  std::string record;
+  std::string_view record_time;
+  auto flush = [&]() {
+    if (!record.empty()) {
+      builder.Add(ParseInt64(record_time), record);
+      record.clear();
+    }
+  };
+  ForEachLine(text, [&](std::string_view line) {
+    if (header.empty() && line.starts_with("# Raw")) {
+      header = line;
+      return;
+    }
+    if (header.empty() || !line.starts_with("Raw")) {
+      flush();
+      return;
+    }
+    // Raw,utcTimeMillis,TimeNanos,...
+    std::string_view time = Field(line, 2);
+    if (!record.empty() && time != record_time) {
+      flush();
+    }
+    if (record.empty()) {
+      record_time = time;
+      record.append(header);
+    }
+    record.append("\n");
+    record.append(line);
+  });
+  flush();
+  return CF_EXPECT(builder.Build(GnssRecordKind::kRawMeasurement));
+}
+
+std::string KindName(GnssRecordKind kind) {
+  return kind == GnssRecordKind::kFixedLocation ? "fixed_location"
+                                                : "raw_measurement";
+}
+
+}  // namespace
+
+Result<std::string> CompileGnssTimeline(GnssRecordKind kind,
+                                        std::string_view text) {
+  switch (kind) {
+    case GnssRecordKind::kFixedLocation:
+      return CF_EXPECT(CompileFixedLocations(text));
+    case GnssRecordKind::kRawMeasurement:
+      return CF_EXPECT(CompileRawMeasurements(text));
+  }
+  return CF_ERRF("Unknown record kind {}", static_cast<uint32_t>(kind));
+}
+
+GnssTimeline::GnssTimeline(MappedFile file)
+    : file_(std::move(file)), bytes_(file_.bytes()) {}
+
+Result<std::unique_ptr<GnssTimeline>> GnssTimeline::FromBytes(
+    GnssRecordKind kind, std::string bytes) {
+  std::unique_ptr<GnssTimeline> timeline(
+      new GnssTimeline(MappedFile(std::move(bytes))));
+  CF_EXPECT(timeline->Validate(kind));
+  return timeline;
+}
+
+Result<std::unique_ptr<GnssTimeline>> GnssTimeline::Map(
+    GnssRecordKind kind, const std::string& path) {
+  std::unique_ptr<GnssTimeline> timeline(
+      new GnssTimeline(CF_EXPECT(MappedFile::Map(path))));
+  CF_EXPECTF(timeline->Validate(kind), "Invalid timeline '{}'", path);
+  return timeline;
+}
+
+Result<void> GnssTimeline::Validate(GnssRecordKind kind) {
+  CF_EXPECT(ValidateMappedFileHeader(bytes_, sizeof(Header),
+                                     std::string_view(kMagic, sizeof(kMagic)),
+                                     kVersion),
+            "Not a GNSS timeline");
+  Header header;
+  memcpy(&header, bytes_.data(), sizeof(header));
+  CF_EXPECT_EQ(header.kind, static_cast<uint32_t>(kind), "Wrong record kind");
+  CF_EXPECT_GT(header.count, 0u, "Empty timeline");
+  CF_EXPECT_LE(header.count,
+               (bytes_.size() - sizeof(Header)) / sizeof(Entry),
+               "Truncated entries");
+  size_ = header.count;
+
+  size_t data_size = bytes_.size() - sizeof(Header) - size_ * sizeof(Entry);
+  int64_t previous_time = 0;
+  for (size_t i = 0; i < size_; i++) {
+    Entry entry;
+    memcpy(&entry, bytes_.data() + sizeof(Header) + i * sizeof(Entry),
+           sizeof(entry));
+    CF_EXPECTF(entry.offset <= data_size &&
+                   entry.size <= data_size - entry.offset,
+               "Record {} is out of bounds", i);
+    CF_EXPECTF(entry.time_ns >= previous_time, "Record {} is out of order",
+               i);
+    previous_time = entry.time_ns;
+  }
+  return {};
+}
+
+std::chrono::nanoseconds GnssTimeline::Time(size_t index) const {
+  Entry entry;
+  memcpy(&entry, bytes_.data() + sizeof(Header) + index * sizeof(Entry),
+         sizeof(entry));
+  return std::chrono::nanoseconds(entry.time_ns);
+}
+
+std::string_view GnssTimeline::Record(size_t index) const {
+  Entry entry;
+  memcpy(&entry, bytes_.data() + sizeof(Header) + index * sizeof(Entry),
+         sizeof(entry));
+  size_t data_start = sizeof(Header) + size_ * sizeof(Entry);
+  return bytes_.substr(data_start + entry.offset, entry.size);
+}
+
+size_t GnssTimeline::IndexAt(std::chrono::nanoseconds elapsed) const {
+  // Finds the first record after `elapsed`.
+  size_t low = 0;
+  size_t high = size_;
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (Time(middle) <= elapsed) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low == 0 ? 0 : low - 1;
+}
+
+Result<std::unique_ptr<GnssTimeline>> LoadGnssTimeline(
+    GnssRecordKind kind, const std::string& source_path,
+    const std::string& cache_dir) {
+  if (cache_dir.empty()) {
+    std::string text = CF_EXPECT(ReadFileContents(source_path));
+    std::string bytes = CF_EXPECTF(CompileGnssTimeline(kind, text),
+                                   "Failed to parse '{}'", source_path);
+    return CF_EXPECT(GnssTimeline::FromBytes(kind, std::move(bytes)));
+  }
+  // Any change to the source file is very likely to change its size or
+  // modification time, which makes it a different cache entry.
+  std::string real_path = CF_EXPECT(RealPath(source_path));
+  auto modified = CF_EXPECT(FileModificationTime(real_path));
+  std::string key = fmt::format(
+      "{}:{}:{}", real_path, FileSize(real_path),
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          modified.time_since_epoch())
+          .count());
+  std::string cache_path =
+      fmt::format("{}/{}_{:016x}.timeline", cache_dir, KindName(kind),
+                  std::hash<std::string>{}(key));
+  if (FileExists(cache_path)) {
+    Result<std::unique_ptr<GnssTimeline>> cached =
+        GnssTimeline::Map(kind, cache_path);
+    if (cached.ok()) {
+      return std::move(*cached);
+    }
+  }
+
+  CF_EXPECT(EnsureDirectoryExists(cache_dir));
+  std::string text = CF_EXPECT(ReadFileContents(real_path));
+  std::string bytes = CF_EXPECTF(CompileGnssTimeline(kind, text),
+                                 "Failed to parse '{}'", real_path);
+  CF_EXPECT(WriteMappedFile(cache_path, bytes));
+  return CF_EXPECT(GnssTimeline::Map(kind, cache_path));
+}
+
+GnssReplay::GnssReplay(std::shared_ptr<const GnssTimeline> timeline,
+                       double speed,
+                       std::chrono::steady_clock::time_point start)
+    : timeline_(std::move(timeline)), speed_(speed), start_(start) {}
+
+size_t GnssReplay::IndexAt(std::chrono::steady_clock::time_point now) const {
+  auto real =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_);
+  auto elapsed = std::chrono::nanoseconds(
+      std::llround(static_cast<double>(real.count()) * speed_));
+  return timeline_->IndexAt(elapsed);
+}
+
+std::optional<std::chrono::steady_clock::time_point> GnssReplay::NextChange(
+    size_t index) const {
+  if (index + 1 >= timeline_->size()) {
+    return std::nullopt;
+  }
+  double next = static_cast<double>(timeline_->Time(index + 1).count());
+  auto real = std::chrono::nanoseconds(
+      static_cast<int64_t>(std::ceil(next / speed_)));
+  return start_ +
+         std::chrono::duration_cast<std::chrono::steady_clock::duration>(real);
+}
+
+}  // namespace cuttlefish
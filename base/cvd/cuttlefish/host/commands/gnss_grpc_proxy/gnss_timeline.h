@@ -0,0 +1,102 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "cuttlefish/host/libs/location/MappedFile.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+enum class GnssRecordKind : uint32_t {
+  // "Fix,GPS,<lat>,<lon>,<alt>,..." lines, timed by their UTC milliseconds.
+  kFixedLocation = 1,
+  // GnssLogger "Raw,..." lines after a "# Raw" header, grouped and timed by
+  // their TimeNanos column.
+  kRawMeasurement = 2,
+};
+
+// Parses a fixed location or raw measurement file into the binary timeline
+// format read by GnssTimeline. Records keep the text sent to the guest and a
+// time relative to the first record. Records without a usable timestamp come
+// one second after the previous one.
+Result<std::string> CompileGnssTimeline(GnssRecordKind kind,
+                                        std::string_view text);
+
+// A read-only sequence of timed records. When mapped from a file, processes
+// replaying the same file share its pages.
+class GnssTimeline {
+ public:
+  static Result<std::unique_ptr<GnssTimeline>> FromBytes(GnssRecordKind kind,
+                                                         std::string bytes);
+  static Result<std::unique_ptr<GnssTimeline>> Map(GnssRecordKind kind,
+                                                   const std::string& path);
+
+  size_t size() const { return size_; }
+  std::chrono::nanoseconds Time(size_t index) const;
+  std::string_view Record(size_t index) const;
+
+  // The index of the last record at or before `elapsed`, or the first record
+  // if `elapsed` is negative.
+  size_t IndexAt(std::chrono::nanoseconds elapsed) const;
+
+ private:
+  explicit GnssTimeline(MappedFile file);
+
+  Result<void> Validate(GnssRecordKind kind);
+
+  MappedFile file_;
+  std::string_view bytes_;
+  size_t size_ = 0;
+};
+
+// Loads the timeline of the text file at `source_path`, compiling it into
+// `cache_dir` first unless another process already did. Compiles in memory
+// when `cache_dir` is empty.
+Result<std::unique_ptr<GnssTimeline>> LoadGnssTimeline(
+    GnssRecordKind kind, const std::string& source_path,
+    const std::string& cache_dir);
+
+// Plays a timeline from `start`, `speed` times faster than recorded.
+class GnssReplay {
+ public:
+  GnssReplay(std::shared_ptr<const GnssTimeline> timeline, double speed,
+             std::chrono::steady_clock::time_point start);
+
+  const GnssTimeline& timeline() const { return *timeline_; }
+
+  // The index of the record current at `now`.
+  size_t IndexAt(std::chrono::steady_clock::time_point now) const;
+  // When the record after `index` becomes current, or nothing after the last
+  // record.
+  std::optional<std::chrono::steady_clock::time_point> NextChange(
+      size_t index) const;
+
+ private:
+  std::shared_ptr<const GnssTimeline> timeline_;
+  double speed_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace cuttlefish
@@ -0,0 +1,157 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/gnss_grpc_proxy/gnss_timeline.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "android-base/file.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+
+constexpr char kFixes[] =
+    "# Fix,Provider,Latitude,Longitude,Altitude,Speed,Accuracy,Bearing,"
+    "UnixTimeMillis\n"
+    "Fix,GPS,37.1,-122.1,13.4,0.0,48.0,0.0,1593029872000,0.5,0.0\n"
+    "Fix,GPS,37.2,-122.2,13.4,0.0,48.0,0.0,1593029872250,0.5,0.0\n"
+    "Fix,GPS,37.3,-122.3,13.4,0.0,48.0,0.0,1593029874250,0.5,0.0\n";
+
+std::unique_ptr<GnssTimeline> Compile(GnssRecordKind kind,
+                                      const std::string& text) {
+  Result<std::string> bytes = CompileGnssTimeline(kind, text);
+  EXPECT_THAT(bytes, IsOk());
+  if (!bytes.ok()) {
+    return nullptr;
+  }
+  Result<std::unique_ptr<GnssTimeline>> timeline =
+      GnssTimeline::FromBytes(kind, std::move(*bytes));
+  EXPECT_THAT(timeline, IsOk());
+  return timeline.ok() ? std::move(*timeline) : nullptr;
+}
+
+TEST(GnssTimelineTest, TimesFixesFromTheirTimestamps) {
+  auto timeline = Compile(GnssRecordKind::kFixedLocation, kFixes);
+  ASSERT_NE(timeline, nullptr);
+
+  ASSERT_EQ(timeline->size(), 3);
+  EXPECT_EQ(timeline->Time(0), milliseconds(0));
+  EXPECT_EQ(timeline->Time(1), milliseconds(250));
+  EXPECT_EQ(timeline->Time(2), milliseconds(2250));
+  EXPECT_EQ(timeline->Record(1),
+            "Fix,GPS,37.2,-122.2,13.4,0.0,48.0,0.0,1593029872250,0.5,0.0");
+}
+
+TEST(GnssTimelineTest, SpacesUntimedRecordsOneSecondApart) {
+  auto timeline = Compile(GnssRecordKind::kFixedLocation,
+                          "Fix,GPS,1,2,3\n"
+                          "Fix,GPS,4,5,6\r\n"
+                          "Fix,GPS,7,8,9\n");
+  ASSERT_NE(timeline, nullptr);
+
+  ASSERT_EQ(timeline->size(), 3);
+  EXPECT_EQ(timeline->Time(2), seconds(2));
+  EXPECT_EQ(timeline->Record(1), "Fix,GPS,4,5,6");
+}
+
+TEST(GnssTimelineTest, GroupsRawMeasurementsByTimeNanos) {
+  auto timeline = Compile(GnssRecordKind::kRawMeasurement,
+                          "Raw,0,5,before header\n"
+                          "# Raw,utcTimeMillis,TimeNanos,Svid\n"
+                          "Raw,0,1000000000,1\n"
+                          "Raw,0,1000000000,2\n"
+                          "Fix,GPS,1,2,3\n"
+                          "Raw,0,1500000000,3\n");
+  ASSERT_NE(timeline, nullptr);
+
+  ASSERT_EQ(timeline->size(), 2);
+  EXPECT_EQ(timeline->Record(0),
+            "# Raw,utcTimeMillis,TimeNanos,Svid\n"
+            "Raw,0,1000000000,1\n"
+            "Raw,0,1000000000,2");
+  EXPECT_EQ(timeline->Time(1), milliseconds(500));
+}
+
+TEST(GnssTimelineTest, FindsTheRecordAtATime) {
+  auto timeline = Compile(GnssRecordKind::kFixedLocation, kFixes);
+  ASSERT_NE(timeline, nullptr);
+
+  EXPECT_EQ(timeline->IndexAt(milliseconds(-1)), 0);
+  EXPECT_EQ(timeline->IndexAt(milliseconds(249)), 0);
+  EXPECT_EQ(timeline->IndexAt(milliseconds(250)), 1);
+  EXPECT_EQ(timeline->IndexAt(seconds(100)), 2);
+}
+
+TEST(GnssTimelineTest, RejectsInvalidData) {
+  EXPECT_THAT(CompileGnssTimeline(GnssRecordKind::kFixedLocation, "x\n"),
+              IsError());
+
+  Result<std::string> bytes =
+      CompileGnssTimeline(GnssRecordKind::kFixedLocation, kFixes);
+  ASSERT_THAT(bytes, IsOk());
+  EXPECT_THAT(GnssTimeline::FromBytes(GnssRecordKind::kRawMeasurement, *bytes),
+              IsError());
+  EXPECT_THAT(GnssTimeline::FromBytes(GnssRecordKind::kFixedLocation,
+                                      bytes->substr(0, bytes->size() - 1)),
+              IsError());
+}
+
+TEST(GnssTimelineTest, ReplaysFasterThanRecorded) {
+  std::shared_ptr<const GnssTimeline> timeline =
+      Compile(GnssRecordKind::kFixedLocation, kFixes);
+  ASSERT_NE(timeline, nullptr);
+  steady_clock::time_point start = steady_clock::now();
+  GnssReplay replay(timeline, 10.0, start);
+
+  EXPECT_EQ(replay.IndexAt(start + milliseconds(24)), 0);
+  EXPECT_EQ(replay.IndexAt(start + milliseconds(25)), 1);
+  EXPECT_EQ(replay.NextChange(1), start + milliseconds(225));
+  EXPECT_EQ(replay.IndexAt(*replay.NextChange(1)), 2);
+  EXPECT_EQ(replay.NextChange(2), std::nullopt);
+}
+
+TEST(GnssTimelineTest, SharesTheCompiledFile) {
+  TemporaryDir dir;
+  std::string source = std::string(dir.path) + "/fixes.csv";
+  std::string cache = std::string(dir.path) + "/cache";
+  ASSERT_TRUE(android::base::WriteStringToFile(kFixes, source));
+
+  auto first = LoadGnssTimeline(GnssRecordKind::kFixedLocation, source, cache);
+  ASSERT_THAT(first, IsOk());
+  Result<std::vector<std::string>> files = DirectoryContents(cache);
+  ASSERT_THAT(files, IsOk());
+  auto second =
+      LoadGnssTimeline(GnssRecordKind::kFixedLocation, source, cache);
+
+  ASSERT_THAT(second, IsOk());
+  EXPECT_EQ(DirectoryContents(cache).value(), *files);
+  EXPECT_EQ((*second)->size(), 3);
+  EXPECT_EQ((*second)->Record(2), (*first)->Record(2));
+}
+
+}  // namespace
+}  // namespace cuttlefish
@@ -18,6 +18,8 @@
 
 #include <fcntl.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <sys/epoll.h>
 #include <sys/types.h>
 
 #include <string>
@@ -29,10 +31,11 @@
 #include "absl/strings/ascii.h"
 #include "absl/strings/str_split.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
-#include "cuttlefish/common/libs/fs/shared_select.h"
 #include "cuttlefish/host/libs/config/config_constants.h"
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
+#include "cuttlefish/result/result.h"
 
 namespace cuttlefish::monitor {
 namespace {
@@ -103,14 +106,10 @@ KernelLogServer::KernelLogServer(SharedFD pipe_fd, const std::string& log_name)
       log_fd_(SharedFD::Open(log_name.c_str(), O_CREAT | O_RDWR | O_APPEND,
                              0666)) {}
 
-void KernelLogServer::BeforeSelect(SharedFDSet* fd_read) const {
-  fd_read->Set(pipe_fd_);
-}
-
-void KernelLogServer::AfterSelect(const SharedFDSet& fd_read) {
-  if (fd_read.IsSet(pipe_fd_)) {
-    HandleIncomingMessage();
-  }
+Result<void> KernelLogServer::Watch(Reactor& reactor) {
+  CF_EXPECT(reactor.Watch(pipe_fd_, EPOLLIN,
+                          [this](uint32_t) { HandleIncomingMessage(); }));
+  return {};
 }
 
 void KernelLogServer::SubscribeToEvents(EventCallback callback) {
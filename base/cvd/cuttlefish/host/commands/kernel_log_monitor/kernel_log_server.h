@@ -23,8 +23,9 @@
 
 #include "json/json.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
-#include "cuttlefish/common/libs/fs/shared_select.h"
+#include "cuttlefish/result/result.h"
 
 namespace cuttlefish::monitor {
 
@@ -62,13 +63,8 @@ class KernelLogServer {
 
   ~KernelLogServer() = default;
 
-  // BeforeSelect is Called right before Select() to populate interesting
-  // SharedFDs.
-  void BeforeSelect(SharedFDSet* fd_read) const;
-
-  // AfterSelect is Called right after Select() to detect and respond to changes
-  // on affected SharedFDs.
-  void AfterSelect(const SharedFDSet& fd_read);
+  // Handles incoming log data from `reactor`'s thread.
+  Result<void> Watch(Reactor& reactor);
 
   void SubscribeToEvents(EventCallback callback);
 
@@ -20,6 +20,7 @@
 #include <unistd.h>
 
 #include <cstdlib>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -29,8 +30,8 @@
 #include "gflags/gflags.h"
 #include "json/value.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
-#include "cuttlefish/common/libs/fs/shared_select.h"
 #include "cuttlefish/host/commands/kernel_log_monitor/kernel_log_server.h"
 #include "cuttlefish/host/commands/kernel_log_monitor/utils.h"
 #include "cuttlefish/host/libs/config/config_instance_derived.h"
@@ -124,20 +125,13 @@ int KernelLogMonitorMain(int argc, char** argv) {
     }
   }
 
-  for (;;) {
-    SharedFDSet fd_read;
-    fd_read.Zero();
-
-    klog.BeforeSelect(&fd_read);
-
-    int ret = Select(&fd_read, nullptr, nullptr, nullptr);
-    if (ret <= 0) {
-      continue;
-    }
-
-    klog.AfterSelect(fd_read);
-  }
+  Result<std::unique_ptr<Reactor>> reactor = Reactor::Create();
+  CHECK(reactor.ok()) << reactor.error();
+  Result<void> watched = klog.Watch(**reactor);
+  CHECK(watched.ok()) << watched.error();
 
+  Result<void> run = (*reactor)->Run();
+  CHECK(run.ok()) << run.error();
   return 0;
 }
 
@@ -0,0 +1,48 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/log_tee/log_index.h"
+
+#include <fcntl.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+std::string LogIndexPath(const std::string& index_dir,
+                         const std::string& source) {
+  return index_dir + "/" + source + ".idx";
+}
+
+Result<std::vector<LogIndexEntry>> ReadLogIndex(const std::string& path) {
+  SharedFD fd = SharedFD::Open(path, O_RDONLY);
+  CF_EXPECTF(fd->IsOpen(), "Failed to open '{}': {}", path, fd->StrError());
+  std::string data;
+  CF_EXPECTF(ReadAll(fd, &data) >= 0, "Failed to read '{}': {}", path,
+             fd->StrError());
+  // A partial entry at the end is still being written.
+  std::vector<LogIndexEntry> entries(data.size() / sizeof(LogIndexEntry));
+  memcpy(entries.data(), data.data(),
+              entries.size() * sizeof(LogIndexEntry));
+  return entries;
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,49 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+// An index file holds one entry per line that a log source wrote, in the
+// order they were written, so that a source's lines can be picked out of the
+// shared log file by severity or time without parsing all of it.
+struct LogIndexEntry {
+  // Where the formatted line starts in the log file, and its size including
+  // the metadata and the newline.
+  uint64_t offset;
+  uint32_t size;
+  // A LogSeverity.
+  uint8_t severity;
+  uint8_t reserved[3];
+  // CLOCK_REALTIME when the line was read.
+  int64_t time_ns;
+};
+static_assert(sizeof(LogIndexEntry) == 24);
+
+// The index file of a source in `index_dir`.
+std::string LogIndexPath(const std::string& index_dir,
+                         const std::string& source);
+
+Result<std::vector<LogIndexEntry>> ReadLogIndex(const std::string& path);
+
+}  // namespace cuttlefish
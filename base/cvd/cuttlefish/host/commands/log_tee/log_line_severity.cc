@@ -0,0 +1,187 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/log_tee/log_line_severity.h"
+
+#include <stddef.h>
+
+#include <optional>
+#include <string_view>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+
+#include "cuttlefish/common/libs/utils/tee_logging.h"
+
+namespace cuttlefish {
+namespace {
+
+bool ConsumeChar(std::string_view& line, char c) {
+  if (line.empty() || line[0] != c) {
+    return false;
+  }
+  line.remove_prefix(1);
+  return true;
+}
+
+bool ConsumeDigits(std::string_view& line, size_t count) {
+  if (line.size() < count) {
+    return false;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (!absl::ascii_isdigit(line[i])) {
+      return false;
+    }
+  }
+  line.remove_prefix(count);
+  return true;
+}
+
+// Returns whether there was at least one space.
+bool ConsumeSpaces(std::string_view& line) {
+  size_t spaces = 0;
+  while (spaces < line.size() && line[spaces] == ' ') {
+    spaces++;
+  }
+  line.remove_prefix(spaces);
+  return spaces > 0;
+}
+
+bool ConsumeNumber(std::string_view& line) {
+  size_t digits = 0;
+  while (digits < line.size() && absl::ascii_isdigit(line[digits])) {
+    digits++;
+  }
+  line.remove_prefix(digits);
+  return digits > 0;
+}
+
+// Crosvm starts lines with a local ISO 8601 timestamp and a log level, e.g.
+// "[2024-05-15T23:43:46.448645816+00:00 INFO  disk] ..." (based on
+// external/crosvm/base/src/syslog.rs).
+std::optional<LogSeverity> CrosvmSeverity(std::string_view line) {
+  bool timestamp =
+      ConsumeChar(line, '[') && ConsumeDigits(line, 4) &&
+      ConsumeChar(line, '-') && ConsumeDigits(line, 2) &&
+      ConsumeChar(line, '-') && ConsumeDigits(line, 2) &&
+      ConsumeChar(line, 'T') && ConsumeDigits(line, 2) &&
+      ConsumeChar(line, ':') && ConsumeDigits(line, 2) &&
+      ConsumeChar(line, ':') && ConsumeDigits(line, 2) &&
+      ConsumeChar(line, '.') && ConsumeDigits(line, 9);
+  if (!timestamp) {
+    return std::nullopt;
+  }
+  // Timezone: "Z", "+hh", "+hhmm" or "+hh:mm".
+  if (!ConsumeChar(line, 'Z')) {
+    if (!(ConsumeChar(line, '+') || ConsumeChar(line, '-')) ||
+        !ConsumeDigits(line, 2)) {
+      return std::nullopt;
+    }
+    if (ConsumeChar(line, ':')) {
+      if (!ConsumeDigits(line, 2)) {
+        return std::nullopt;
+      }
+    } else {
+      ConsumeDigits(line, 2);
+    }
+  }
+  if (line.empty() || !absl::ascii_isspace(line[0])) {
+    return std::nullopt;
+  }
+  line.remove_prefix(1);
+
+  if (absl::StartsWith(line, "ERROR")) {
+    return LogSeverity::Error;
+  } else if (absl::StartsWith(line, "WARN")) {
+    return LogSeverity::Warning;
+  } else if (absl::StartsWith(line, "INFO")) {
+    // These are printed on every boot and aren't interesting.
+    if (absl::StrContains(line, "disk] Disk image file is hosted") ||
+        absl::StrContains(line, "disk] disk size")) {
+      return LogSeverity::Debug;
+    }
+    return LogSeverity::Info;
+  } else if (absl::StartsWith(line, "DEBUG")) {
+    return LogSeverity::Debug;
+  } else if (absl::StartsWith(line, "TRACE")) {
+    return LogSeverity::Verbose;
+  }
+  return std::nullopt;
+}
+
+std::optional<LogSeverity> FromLogcatPriority(char priority) {
+  switch (priority) {
+    case 'V':
+      return LogSeverity::Verbose;
+    case 'D':
+      return LogSeverity::Debug;
+    case 'I':
+      return LogSeverity::Info;
+    case 'W':
+      return LogSeverity::Warning;
+    case 'E':
+      return LogSeverity::Error;
+    case 'F':
+    case 'A':
+      return LogSeverity::Fatal;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Logcat's threadtime format, "05-15 23:43:46.448  1234  1240 I Tag: ...", and
+// its brief format, "I/Tag( 1234): ...".
+std::optional<LogSeverity> LogcatSeverity(std::string_view line) {
+  if (line.size() > 2 && line[1] == '/' &&
+      line.find("): ") != std::string_view::npos) {
+    return FromLogcatPriority(line[0]);
+  }
+  bool prefix = ConsumeDigits(line, 2) && ConsumeChar(line, '-') &&
+                ConsumeDigits(line, 2) && ConsumeChar(line, ' ') &&
+                ConsumeDigits(line, 2) && ConsumeChar(line, ':') &&
+                ConsumeDigits(line, 2) && ConsumeChar(line, ':') &&
+                ConsumeDigits(line, 2) && ConsumeChar(line, '.') &&
+                ConsumeDigits(line, 3) && ConsumeSpaces(line) &&
+                ConsumeNumber(line) && ConsumeSpaces(line) &&
+                ConsumeNumber(line) && ConsumeSpaces(line);
+  if (!prefix || line.size() < 2 || line[1] != ' ') {
+    return std::nullopt;
+  }
+  return FromLogcatPriority(line[0]);
+}
+
+}  // namespace
+
+LogSeverity GuessLogSeverity(std::string_view line) {
+  // Cuttlefish's own bracketed severities.
+  if (absl::StartsWith(line, "[INFO")) {
+    return LogSeverity::Debug;
+  } else if (absl::StartsWith(line, "[ERROR")) {
+    return LogSeverity::Error;
+  } else if (absl::StartsWith(line, "[WARNING")) {
+    return LogSeverity::Warning;
+  } else if (absl::StartsWith(line, "[VERBOSE")) {
+    return LogSeverity::Verbose;
+  }
+  if (std::optional<LogSeverity> severity = CrosvmSeverity(line)) {
+    return *severity;
+  }
+  if (std::optional<LogSeverity> severity = LogcatSeverity(line)) {
+    return *severity;
+  }
+  return LogSeverity::Debug;
+}
+
+}  // namespace cuttlefish
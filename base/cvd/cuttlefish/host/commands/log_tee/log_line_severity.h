@@ -0,0 +1,29 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string_view>
+
+#include "cuttlefish/common/libs/utils/tee_logging.h"
+
+namespace cuttlefish {
+
+// Determines the severity of a line logged by a host process from its own
+// metadata, for the crosvm and logcat formats. Lines that aren't recognized
+// are Debug.
+LogSeverity GuessLogSeverity(std::string_view line);
+
+}  // namespace cuttlefish
@@ -0,0 +1,79 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/log_tee/log_line_severity.h"
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/utils/tee_logging.h"
+
+namespace cuttlefish {
+
+TEST(LogLineSeverityTest, Crosvm) {
+  EXPECT_EQ(GuessLogSeverity("[2026-05-15T23:43:46.448645816+00:00 ERROR "
+                             "devices] failed"),
+            LogSeverity::Error);
+  EXPECT_EQ(GuessLogSeverity("[2026-05-15T23:43:46.448645816Z WARN  vm] slow"),
+            LogSeverity::Warning);
+  EXPECT_EQ(GuessLogSeverity("[2026-05-15T23:43:46.448645816-0700 INFO  "
+                             "crosvm] started"),
+            LogSeverity::Info);
+  EXPECT_EQ(GuessLogSeverity("[2026-05-15T23:43:46.448645816+05 DEBUG x] y"),
+            LogSeverity::Debug);
+  EXPECT_EQ(GuessLogSeverity("[2026-05-15T23:43:46.448645816+00:00 TRACE "
+                             "x] y"),
+            LogSeverity::Verbose);
+}
+
+TEST(LogLineSeverityTest, CrosvmDiskInfoIsDebug) {
+  EXPECT_EQ(GuessLogSeverity("[2026-05-15T23:43:46.448645816+00:00 INFO  "
+                             "disk] disk size 294518784"),
+            LogSeverity::Debug);
+}
+
+TEST(LogLineSeverityTest, MalformedCrosvmTimestamp) {
+  // Milliseconds instead of nanoseconds.
+  EXPECT_EQ(GuessLogSeverity("[2026-05-15T23:43:46.448+00:00 ERROR x] y"),
+            LogSeverity::Debug);
+  EXPECT_EQ(GuessLogSeverity("[2026-05-15T23:43:46.448645816+00: ERROR x] y"),
+            LogSeverity::Debug);
+  EXPECT_EQ(GuessLogSeverity("[2026-05-15 23:43:46.448645816Z ERROR x] y"),
+            LogSeverity::Debug);
+}
+
+TEST(LogLineSeverityTest, Logcat) {
+  EXPECT_EQ(GuessLogSeverity("05-15 23:43:46.448  1234  1240 E Tag: failed"),
+            LogSeverity::Error);
+  EXPECT_EQ(GuessLogSeverity("05-15 23:43:46.448 1234 1240 W Tag: slow"),
+            LogSeverity::Warning);
+  EXPECT_EQ(GuessLogSeverity("05-15 23:43:46.448  1234  1240 V Tag: x"),
+            LogSeverity::Verbose);
+  EXPECT_EQ(GuessLogSeverity("I/Tag( 1234): started"), LogSeverity::Info);
+  EXPECT_EQ(GuessLogSeverity("F/libc( 1234): abort"), LogSeverity::Fatal);
+}
+
+TEST(LogLineSeverityTest, Bracketed) {
+  EXPECT_EQ(GuessLogSeverity("[ERROR] failed"), LogSeverity::Error);
+  EXPECT_EQ(GuessLogSeverity("[WARNING] slow"), LogSeverity::Warning);
+  EXPECT_EQ(GuessLogSeverity("[INFO] started"), LogSeverity::Debug);
+}
+
+TEST(LogLineSeverityTest, Unrecognized) {
+  EXPECT_EQ(GuessLogSeverity("plain message"), LogSeverity::Debug);
+  EXPECT_EQ(GuessLogSeverity("E/no parenthesis"), LogSeverity::Debug);
+  EXPECT_EQ(GuessLogSeverity(""), LogSeverity::Debug);
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,288 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/log_tee/log_multiplexer.h"
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <time.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/common/libs/utils/tee_logging.h"
+#include "cuttlefish/host/commands/log_tee/log_index.h"
+#include "cuttlefish/host/commands/log_tee/log_line_severity.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr size_t kReadSize = 1 << 16;
+// Longer lines are split so that a source can't make the tee buffer without
+// bound.
+constexpr size_t kMaxLineSize = 1 << 16;
+// Written out right away instead of at the end of the reactor iteration.
+constexpr size_t kMaxBufferSize = 1 << 20;
+
+std::string_view StripTrailingWhitespace(std::string_view line) {
+  while (!line.empty() && (line.back() == ' ' || line.back() == '\t' ||
+                           line.back() == '\r')) {
+    line.remove_suffix(1);
+  }
+  return line;
+}
+
+}  // namespace
+
+Result<std::unique_ptr<LogMultiplexer>> LogMultiplexer::Create(
+    Reactor& reactor, LogMultiplexerOptions options) {
+  if (!options.index_dir.empty()) {
+    CF_EXPECT(EnsureDirectoryExists(options.index_dir));
+  }
+  return std::unique_ptr<LogMultiplexer>(
+      new LogMultiplexer(reactor, std::move(options)));
+}
+
+LogMultiplexer::LogMultiplexer(Reactor& reactor, LogMultiplexerOptions options)
+    : reactor_(reactor), index_dir_(std::move(options.index_dir)) {
+  bool is_tty = options.log_file.target->IsATTY();
+  destinations_.push_back(Destination{
+      .target = std::move(options.log_file),
+      .is_tty = is_tty,
+  });
+  if (options.console) {
+    is_tty = options.console->target->IsATTY();
+    destinations_.push_back(Destination{
+        .target = std::move(*options.console),
+        .is_tty = is_tty,
+    });
+  }
+}
+
+LogMultiplexer::~LogMultiplexer() {
+  for (const std::unique_ptr<Source>& source : sources_) {
+    if (!source->closed) {
+      (void)reactor_.Unwatch(source->fd);
+    }
+  }
+}
+
+Result<void> LogMultiplexer::AddSource(const std::string& name, SharedFD fd) {
+  CF_EXPECTF(fd->IsOpen(), "Log source '{}' is not open: {}", name,
+             fd->StrError());
+  int flags = fd->Fcntl(F_GETFL, 0);
+  CF_EXPECTF(flags >= 0 && fd->Fcntl(F_SETFL, flags | O_NONBLOCK) == 0,
+             "Failed to make log source '{}' non-blocking: {}", name,
+             fd->StrError());
+
+  auto source = std::make_unique<Source>();
+  source->name = name;
+  source->fd = fd;
+  if (!index_dir_.empty()) {
+    std::string path = LogIndexPath(index_dir_, name);
+    source->index = SharedFD::Open(path, O_CREAT | O_WRONLY | O_APPEND, 0644);
+    CF_EXPECTF(source->index->IsOpen(), "Failed to open '{}': {}", path,
+               source->index->StrError());
+  }
+
+  Source* raw_source = source.get();
+  CF_EXPECT(reactor_.Watch(fd, EPOLLIN, [this, raw_source](uint32_t) {
+    if (ReadSource(*raw_source) != ReadResult::kClosed) {
+      return;
+    }
+    Result<void> unwatched = reactor_.Unwatch(raw_source->fd);
+    if (!unwatched.ok()) {
+      LOG(ERROR) << "Failed to unwatch log source: " << unwatched.error();
+    }
+  }));
+  sources_.emplace_back(std::move(source));
+  return {};
+}
+
+LogMultiplexer::ReadResult LogMultiplexer::ReadSource(Source& source) {
+  if (source.closed) {
+    return ReadResult::kClosed;
+  }
+  char buf[kReadSize];
+  ssize_t bytes_read = source.fd->Read(buf, sizeof(buf));
+  if (bytes_read < 0 && source.fd->GetErrno() == EAGAIN) {
+    return ReadResult::kEmpty;
+  }
+  if (bytes_read <= 0) {
+    if (bytes_read < 0) {
+      LOG(ERROR) << "Failed to read logs of " << source.name << ": "
+                 << source.fd->StrError();
+    }
+    source.closed = true;
+    if (!source.partial_line.empty()) {
+      AddLine(source, source.partial_line);
+      source.partial_line.clear();
+    }
+    return ReadResult::kClosed;
+  }
+
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  now_ns_ = static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  localtime_r(&ts.tv_sec, &now_);
+  AddLines(source, std::string_view(buf, bytes_read));
+  return ReadResult::kData;
+}
+
+void LogMultiplexer::AddLines(Source& source, std::string_view data) {
+  while (!data.empty()) {
+    size_t newline = data.find('\n');
+    if (newline == std::string_view::npos) {
+      source.partial_line.append(data);
+      if (source.partial_line.size() >= kMaxLineSize) {
+        AddLine(source, source.partial_line);
+        source.partial_line.clear();
+      }
+      return;
+    }
+    if (source.partial_line.empty()) {
+      AddLine(source, data.substr(0, newline));
+    } else {
+      source.partial_line.append(data.substr(0, newline));
+      AddLine(source, source.partial_line);
+      source.partial_line.clear();
+    }
+    data.remove_prefix(newline + 1);
+  }
+}
+
+void LogMultiplexer::AddLine(Source& source, std::string_view line) {
+  line = StripTrailingWhitespace(line);
+  if (line.empty()) {
+    return;
+  }
+  LogSeverity severity = GuessLogSeverity(line);
+  std::string message(line);
+  for (size_t i = 0; i < destinations_.size(); i++) {
+    Destination& destination = destinations_[i];
+    if (severity < destination.target.severity) {
+      continue;
+    }
+    std::string formatted =
+        FormatLogLines(destination.target.metadata_level, severity, now_,
+                       source.name, message);
+    if (!destination.is_tty && formatted.find('\033') != std::string::npos) {
+      formatted = StripColorCodes(formatted);
+    }
+    // Only the log file is indexed.
+    if (i == 0 && source.index->IsOpen()) {
+      source.pending_index.emplace_back(LogIndexEntry{
+          .offset = destination.buffer.size(),
+          .size = static_cast<uint32_t>(formatted.size()),
+          .severity = static_cast<uint8_t>(severity),
+          .reserved = {},
+          .time_ns = now_ns_,
+      });
+    }
+    destination.buffer.append(formatted);
+  }
+
+  if (destinations_[0].buffer.size() >= kMaxBufferSize) {
+    Result<void> flushed = Flush();
+    if (!flushed.ok()) {
+      LOG(ERROR) << flushed.error();
+    }
+  } else {
+    ScheduleFlush();
+  }
+}
+
+void LogMultiplexer::ScheduleFlush() {
+  if (flush_scheduled_) {
+    return;
+  }
+  flush_scheduled_ = true;
+  // Posted tasks run after the reactor dispatched all the events it got.
+  reactor_.Post([this]() {
+    flush_scheduled_ = false;
+    Result<void> flushed = Flush();
+    if (!flushed.ok()) {
+      LOG(ERROR) << flushed.error();
+    }
+  });
+}
+
+Result<void> LogMultiplexer::Flush() {
+  Result<void> result;
+  for (size_t i = 0; i < destinations_.size(); i++) {
+    Destination& destination = destinations_[i];
+    if (destination.buffer.empty()) {
+      continue;
+    }
+    SharedFD& fd = destination.target.target;
+    ssize_t written = WriteAll(fd, destination.buffer);
+    if (written != static_cast<ssize_t>(destination.buffer.size())) {
+      result = CF_ERRF("Failed to write logs: {}", fd->StrError());
+    } else if (i == 0 && !index_dir_.empty()) {
+      // The log file is opened with O_APPEND, so this is where the buffer
+      // ended up even if other processes write to the file too.
+      off_t end = fd->LSeek(0, SEEK_CUR);
+      uint64_t start = end - destination.buffer.size();
+      for (const std::unique_ptr<Source>& source : sources_) {
+        if (source->pending_index.empty() || end < 0) {
+          continue;
+        }
+        for (LogIndexEntry& entry : source->pending_index) {
+          entry.offset += start;
+        }
+        size_t size = source->pending_index.size() * sizeof(LogIndexEntry);
+        if (WriteAll(source->index,
+                     reinterpret_cast<const char*>(
+                         source->pending_index.data()),
+                     size) != static_cast<ssize_t>(size)) {
+          result = CF_ERRF("Failed to write the log index of '{}': {}",
+                           source->name, source->index->StrError());
+        }
+      }
+    }
+    destination.buffer.clear();
+  }
+  for (const std::unique_ptr<Source>& source : sources_) {
+    source->pending_index.clear();
+  }
+  return result;
+}
+
+Result<void> LogMultiplexer::Drain() {
+  for (const std::unique_ptr<Source>& source : sources_) {
+    while (ReadSource(*source) == ReadResult::kData) {
+    }
+    if (!source->partial_line.empty()) {
+      AddLine(*source, source->partial_line);
+      source->partial_line.clear();
+    }
+  }
+  CF_EXPECT(Flush());
+  return {};
+}
+
+}  // namespace cuttlefish
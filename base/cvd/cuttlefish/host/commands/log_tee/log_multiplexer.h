@@ -0,0 +1,101 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <time.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/tee_logging.h"
+#include "cuttlefish/host/commands/log_tee/log_index.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+struct LogMultiplexerOptions {
+  // Gets every line, normally launcher.log with full metadata.
+  SeverityTarget log_file;
+  std::optional<SeverityTarget> console;
+  // Where to keep an index of the lines of each source in `log_file`, none
+  // if empty.
+  std::string index_dir;
+};
+
+// Reads the logs of many processes from one thread and writes them out line by
+// line, credited to the process and with the severity found in the line.
+//
+// Sources are read as the reactor reports them readable. The lines read in one
+// reactor iteration are written out together, so that a burst of logs from
+// many sources costs one write per destination rather than one per line.
+class LogMultiplexer {
+ public:
+  static Result<std::unique_ptr<LogMultiplexer>> Create(
+      Reactor& reactor, LogMultiplexerOptions options);
+  ~LogMultiplexer();
+
+  // `fd` is made non-blocking.
+  Result<void> AddSource(const std::string& name, SharedFD fd);
+
+  // Reads whatever the sources have left and writes out everything, including
+  // lines without a newline yet.
+  Result<void> Drain();
+
+ private:
+  struct Source {
+    std::string name;
+    SharedFD fd;
+    bool closed = false;
+    // The start of a line without its newline yet.
+    std::string partial_line;
+    SharedFD index;
+    // Entries for lines in `log_file_buffer_`, with offsets relative to the
+    // start of the buffer.
+    std::vector<LogIndexEntry> pending_index;
+  };
+  struct Destination {
+    SeverityTarget target;
+    bool is_tty;
+    std::string buffer;
+  };
+
+  LogMultiplexer(Reactor& reactor, LogMultiplexerOptions options);
+
+  enum class ReadResult { kData, kEmpty, kClosed };
+
+  ReadResult ReadSource(Source& source);
+  void AddLines(Source& source, std::string_view data);
+  void AddLine(Source& source, std::string_view line);
+  void ScheduleFlush();
+  Result<void> Flush();
+
+  Reactor& reactor_;
+  std::vector<Destination> destinations_;
+  std::string index_dir_;
+  std::vector<std::unique_ptr<Source>> sources_;
+  bool flush_scheduled_ = false;
+  // The local time of the lines being read, updated once per read.
+  struct tm now_;
+  int64_t now_ns_ = 0;
+};
+
+}  // namespace cuttlefish
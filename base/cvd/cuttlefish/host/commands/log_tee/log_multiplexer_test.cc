@@ -0,0 +1,178 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/log_tee/log_multiplexer.h"
+
+#include <fcntl.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "android-base/file.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/tee_logging.h"
+#include "cuttlefish/host/commands/log_tee/log_index.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+class LogMultiplexerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    Result<std::unique_ptr<Reactor>> reactor = Reactor::Create();
+    ASSERT_THAT(reactor, IsOk());
+    reactor_ = std::move(*reactor);
+    log_path_ = std::string(temp_dir_.path) + "/launcher.log";
+    index_dir_ = std::string(temp_dir_.path) + "/index";
+  }
+
+  std::unique_ptr<LogMultiplexer> Multiplexer(
+      LogSeverity severity = LogSeverity::Verbose,
+      MetadataLevel metadata_level = MetadataLevel::ONLY_MESSAGE) {
+    Result<std::unique_ptr<LogMultiplexer>> multiplexer =
+        LogMultiplexer::Create(
+            *reactor_, LogMultiplexerOptions{
+                           .log_file = SeverityTarget::FromFile(
+                               log_path_, metadata_level, severity),
+                           .index_dir = index_dir_,
+                       });
+    EXPECT_THAT(multiplexer, IsOk());
+    return multiplexer.ok() ? std::move(*multiplexer) : nullptr;
+  }
+
+  // Returns the write end.
+  SharedFD AddSource(LogMultiplexer& multiplexer, const std::string& name) {
+    SharedFD read_end;
+    SharedFD write_end;
+    EXPECT_TRUE(SharedFD::Pipe(&read_end, &write_end));
+    EXPECT_THAT(multiplexer.AddSource(name, read_end), IsOk());
+    return write_end;
+  }
+
+  // Runs one iteration of the reactor.
+  void RunOnce() {
+    reactor_->Post([this]() { reactor_->Stop(); });
+    ASSERT_THAT(reactor_->Run(), IsOk());
+  }
+
+  std::string Log() {
+    std::string contents;
+    android::base::ReadFileToString(log_path_, &contents);
+    return contents;
+  }
+
+  TemporaryDir temp_dir_;
+  std::unique_ptr<Reactor> reactor_;
+  std::string log_path_;
+  std::string index_dir_;
+};
+
+TEST_F(LogMultiplexerTest, JoinsPartialLines) {
+  std::unique_ptr<LogMultiplexer> multiplexer = Multiplexer();
+  SharedFD source = AddSource(*multiplexer, "crosvm");
+
+  ASSERT_EQ(WriteAll(source, "first li"), 8);
+  RunOnce();
+  EXPECT_EQ(Log(), "");
+
+  ASSERT_EQ(WriteAll(source, "ne\nsecond line\n\n"), 16);
+  RunOnce();
+  EXPECT_EQ(Log(), "first line\nsecond line\n");
+}
+
+TEST_F(LogMultiplexerTest, DrainWritesPartialLines) {
+  std::unique_ptr<LogMultiplexer> multiplexer = Multiplexer();
+  SharedFD source = AddSource(*multiplexer, "crosvm");
+
+  ASSERT_EQ(WriteAll(source, "complete\nincomplete"), 19);
+
+  EXPECT_THAT(multiplexer->Drain(), IsOk());
+  EXPECT_EQ(Log(), "complete\nincomplete\n");
+}
+
+TEST_F(LogMultiplexerTest, FiltersBySeverity) {
+  std::unique_ptr<LogMultiplexer> multiplexer =
+      Multiplexer(LogSeverity::Warning);
+  SharedFD source = AddSource(*multiplexer, "casimir");
+
+  ASSERT_GT(WriteAll(source,
+                     "05-15 23:43:46.448  1  2 I Tag: info\n"
+                     "05-15 23:43:46.448  1  2 E Tag: error\n"
+                     "unknown\n"),
+            0);
+  RunOnce();
+
+  EXPECT_EQ(Log(), "05-15 23:43:46.448  1  2 E Tag: error\n");
+}
+
+TEST_F(LogMultiplexerTest, CreditsLinesToTheirSource) {
+  std::unique_ptr<LogMultiplexer> multiplexer =
+      Multiplexer(LogSeverity::Verbose, MetadataLevel::FULL);
+  SharedFD wmediumd = AddSource(*multiplexer, "wmediumd");
+  SharedFD pica = AddSource(*multiplexer, "pica");
+
+  ASSERT_GT(WriteAll(wmediumd, "from wmediumd\n"), 0);
+  ASSERT_GT(WriteAll(pica, "from pica\n"), 0);
+  RunOnce();
+
+  std::string log = Log();
+  EXPECT_NE(log.find(" wmediumd] from wmediumd\n"), std::string::npos) << log;
+  EXPECT_NE(log.find(" pica] from pica\n"), std::string::npos) << log;
+}
+
+TEST_F(LogMultiplexerTest, IndexesLinesOfEachSource) {
+  std::unique_ptr<LogMultiplexer> multiplexer = Multiplexer();
+  SharedFD first = AddSource(*multiplexer, "first");
+  SharedFD second = AddSource(*multiplexer, "second");
+  // Written by another process to the same file.
+  SharedFD other = SharedFD::Open(log_path_, O_WRONLY | O_APPEND);
+  ASSERT_EQ(WriteAll(other, "other\n"), 6);
+
+  ASSERT_GT(WriteAll(first, "[ERROR] one\n"), 0);
+  ASSERT_GT(WriteAll(second, "two\n"), 0);
+  RunOnce();
+  ASSERT_GT(WriteAll(first, "three\n"), 0);
+  RunOnce();
+
+  std::string log = Log();
+  Result<std::vector<LogIndexEntry>> first_index =
+      ReadLogIndex(LogIndexPath(index_dir_, "first"));
+  ASSERT_THAT(first_index, IsOk());
+  ASSERT_EQ(first_index->size(), 2);
+  EXPECT_EQ(log.substr((*first_index)[0].offset, (*first_index)[0].size),
+            "[ERROR] one\n");
+  EXPECT_EQ((*first_index)[0].severity,
+            static_cast<uint8_t>(LogSeverity::Error));
+  EXPECT_EQ(log.substr((*first_index)[1].offset, (*first_index)[1].size),
+            "three\n");
+
+  Result<std::vector<LogIndexEntry>> second_index =
+      ReadLogIndex(LogIndexPath(index_dir_, "second"));
+  ASSERT_THAT(second_index, IsOk());
+  ASSERT_EQ(second_index->size(), 1);
+  EXPECT_EQ(log.substr((*second_index)[0].offset, (*second_index)[0].size),
+            "two\n");
+  EXPECT_GT((*second_index)[0].time_ns, 0);
+}
+
+}  // namespace
+}  // namespace cuttlefish
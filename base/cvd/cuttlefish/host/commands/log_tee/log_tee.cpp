@@ -13,189 +13,149 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
 #include <signal.h>
-#ifdef __linux__
+#include <sys/epoll.h>
 #include <sys/signalfd.h>
-#endif
+#include <unistd.h>
 
-#include <regex>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
-#include "absl/strings/ascii.h"
-#include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
+#include "android-base/file.h"
 #include "gflags/gflags.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/common/libs/utils/tee_logging.h"
+#include "cuttlefish/host/commands/log_tee/log_multiplexer.h"
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
 #include "cuttlefish/posix/strerror.h"
-
-using cuttlefish::StrError;
+#include "cuttlefish/result/result.h"
 
 DEFINE_string(process_name, "", "The process to credit log messages to");
 DEFINE_int32(log_fd_in, -1, "The file descriptor to read logs from.");
+DEFINE_string(log_sources_file, "",
+              "A file with one log source per line, the name of the process "
+              "to credit its log messages to and the path of a FIFO to read "
+              "them from, separated by a space.");
+DEFINE_string(log_index_dir, "",
+              "Directory to write an index of the lines of each source in "
+              "the launcher log to. No index is written if empty.");
+
+namespace cuttlefish {
+namespace {
+
+Result<void> AddSourcesFromFile(LogMultiplexer& multiplexer,
+                                const std::string& path) {
+  std::string contents;
+  CF_EXPECTF(android::base::ReadFileToString(path, &contents),
+             "Failed to read '{}'", path);
+  for (std::string_view line : absl::StrSplit(contents, '\n')) {
+    if (line.empty()) {
+      continue;
+    }
+    std::vector<std::string> fields = absl::StrSplit(line, ' ');
+    CF_EXPECTF(fields.size() == 2, "Invalid log source line: '{}'", line);
+    // Opening the FIFO for writing too means it never reports end of file,
+    // even while none of the processes writing to it are running.
+    SharedFD fd = SharedFD::Open(fields[1], O_RDWR);
+    CF_EXPECTF(fd->IsOpen(), "Failed to open '{}': {}", fields[1],
+               fd->StrError());
+    CF_EXPECT(multiplexer.AddSource(fields[0], fd));
+  }
+  return {};
+}
 
-// Crosvm formats logs starting with a local ISO 8601 timestamp and then a
-// log level (based on external/crosvm/base/src/syslog.rs).
-const std::regex kCrosvmLogPattern(
-    "^\\["
-    "\\d{4}" /* year */
-    "-"
-    "\\d{2}" /* month */
-    "-"
-    "\\d{2}" /* day */
-    "T"
-    "\\d{2}" /* hour */
-    ":"
-    "\\d{2}" /* minute*/
-    ":"
-    "\\d{2}" /* second */
-    "\\."
-    "\\d{9}"                          /* millisecond */
-    "(Z|[+-]\\d{2}(:\\d{2}|\\d{2})?)" /* timezone */
-    "\\s"
-    "(ERROR|WARN|INFO|DEBUG|TRACE)");
-
-int main(int argc, char** argv) {
-  google::ParseCommandLineFlags(&argc, &argv, /* remove_flags */ true);
-
-  CHECK(FLAGS_log_fd_in >= 0) << "-log_fd_in is required";
-
-  auto config = cuttlefish::CuttlefishConfig::Get();
-
-  CHECK(config) << "Could not open cuttlefish config";
+Result<void> LogTeeMain() {
+  CF_EXPECT(FLAGS_log_fd_in >= 0 || !FLAGS_log_sources_file.empty(),
+            "-log_fd_in or -log_sources_file is required");
 
+  const CuttlefishConfig* config = CuttlefishConfig::Get();
+  CF_EXPECT(config != nullptr, "Could not open cuttlefish config");
   auto instance = config->ForDefaultInstance();
 
+  // For messages about the tee itself.
   if (instance.run_as_daemon()) {
-    cuttlefish::LogToFiles({instance.launcher_log_path()});
+    LogToFiles({instance.launcher_log_path()});
   } else {
-    cuttlefish::LogToStderrAndFiles({instance.launcher_log_path()});
+    LogToStderrAndFiles({instance.launcher_log_path()});
   }
 
-  auto log_fd = cuttlefish::SharedFD::Dup(FLAGS_log_fd_in);
-  CHECK(log_fd->IsOpen()) << "Failed to dup log_fd_in: " << log_fd->StrError();
-  close(FLAGS_log_fd_in);
+  LogMultiplexerOptions options{
+      .log_file = SeverityTarget::FromFile(instance.launcher_log_path(),
+                                           MetadataLevel::FULL,
+                                           LogFileSeverity()),
+      .index_dir = FLAGS_log_index_dir,
+  };
+  if (!instance.run_as_daemon()) {
+    options.console =
+        SeverityTarget::FromFd(SharedFD::Dup(/* stderr */ 2),
+                               MetadataLevel::ONLY_MESSAGE, ConsoleSeverity());
+  }
 
-  if (!FLAGS_process_name.empty()) {
-    LOG(WARNING) << "Log tags unsupported with abseil logging: "
-                 << FLAGS_process_name;
+  std::unique_ptr<Reactor> reactor = CF_EXPECT(Reactor::Create());
+  std::unique_ptr<LogMultiplexer> multiplexer =
+      CF_EXPECT(LogMultiplexer::Create(*reactor, std::move(options)));
+
+  if (FLAGS_log_fd_in >= 0) {
+    SharedFD log_fd = SharedFD::Dup(FLAGS_log_fd_in);
+    CF_EXPECTF(log_fd->IsOpen(), "Failed to dup log_fd_in: {}",
+               log_fd->StrError());
+    close(FLAGS_log_fd_in);
+    std::string name =
+        FLAGS_process_name.empty() ? "log_tee" : FLAGS_process_name;
+    CF_EXPECT(multiplexer->AddSource(name, log_fd));
+  }
+  if (!FLAGS_log_sources_file.empty()) {
+    CF_EXPECT(AddSourcesFromFile(*multiplexer, FLAGS_log_sources_file));
   }
 
   // mask SIGINT and handle it using signalfd
   sigset_t mask;
   sigemptyset(&mask);
   sigaddset(&mask, SIGINT);
-  CHECK(sigprocmask(SIG_BLOCK, &mask, NULL) == 0)
-      << "sigprocmask failed: " << StrError(errno);
-#ifdef __linux__
+  CF_EXPECTF(sigprocmask(SIG_BLOCK, &mask, NULL) == 0,
+             "sigprocmask failed: {}", StrError(errno));
   int sfd = signalfd(-1, &mask, 0);
-  CHECK(sfd >= 0) << "signalfd failed: " << StrError(errno);
-  auto int_fd = cuttlefish::SharedFD::Dup(sfd);
+  CF_EXPECTF(sfd >= 0, "signalfd failed: {}", StrError(errno));
+  SharedFD int_fd = SharedFD::Dup(sfd);
   close(sfd);
-#endif
-
-  auto poll_fds = std::vector<cuttlefish::PollSharedFd>{
-      cuttlefish::PollSharedFd{
-          .fd = log_fd,
-          .events = POLL_IN,
-          .revents = 0,
-      },
-#ifdef __linux__
-      cuttlefish::PollSharedFd{
-          .fd = int_fd,
-          .events = POLL_IN,
-          .revents = 0,
-      },
-#endif
-  };
 
-  VLOG(0) << "Starting to read from process " << FLAGS_process_name;
-
-  char buf[1 << 16];
-  ssize_t chars_read = 0;
-  for (;;) {
-    // We can assume all writers to `log_fd` have completed before a SIGINT is
-    // sent, but we need to make sure we've actually read all the data before
-    // exiting. So, keep reading from `log_fd` until both (1) we get SIGINT and
-    // (2) `log_fd` is empty (but not necessarily EOF).
-    //
-    // This could be simpler if all the writers would close their FDs when they
-    // are finished. Then, we could just read until EOF. However that would
-    // require more work elsewhere in cuttlefish.
-    CHECK(cuttlefish::SharedFD::Poll(poll_fds, /*timeout=*/-1) >= 0)
-        << "poll failed: " << StrError(errno);
-    if (poll_fds[0].revents) {
-      chars_read = log_fd->Read(buf, sizeof(buf));
-      if (chars_read < 0) {
-        VLOG(0) << "Failed to read from process " << FLAGS_process_name << ": "
-                << log_fd->StrError();
-        break;
-      }
-      if (chars_read == 0) {
-        break;
-      }
-      std::string trimmed(
-          absl::StripAsciiWhitespace(std::string_view(buf, chars_read)));
-      // Newlines inside `trimmed` are handled by the android logging code.
-      // These checks attempt to determine the log severity coming from crosvm.
-      // There is no guarantee of success all the time since log line boundaries
-      // could be out sync with the reads, but that's ok.
-      if (absl::StartsWith(trimmed, "[INFO")) {
-        VLOG(0) << trimmed;
-      } else if (absl::StartsWith(trimmed, "[ERROR")) {
-        LOG(ERROR) << trimmed;
-      } else if (absl::StartsWith(trimmed, "[WARNING")) {
-        LOG(WARNING) << trimmed;
-      } else if (absl::StartsWith(trimmed, "[VERBOSE")) {
-        VLOG(1) << trimmed;
-      } else {
-        std::smatch match_result;
-        if (std::regex_search(trimmed, match_result, kCrosvmLogPattern)) {
-          if (match_result.size() == 4) {
-            const auto& level = match_result[3];
-            if (level == "ERROR") {
-              LOG(ERROR) << trimmed;
-            } else if (level == "WARN") {
-              LOG(WARNING) << trimmed;
-            } else if (level == "INFO") {
-              if (trimmed.find("disk] Disk image file is hosted") !=
-                      std::string::npos ||
-                  trimmed.find("disk] disk size") != std::string::npos) {
-                VLOG(0) << trimmed;
-              } else {
-                LOG(INFO) << trimmed;
-              }
-            } else if (level == "DEBUG") {
-              VLOG(0) << trimmed;
-            } else if (level == "TRACE") {
-              VLOG(1) << trimmed;
-            } else {
-              VLOG(0) << trimmed;
-            }
-          }
-        } else {
-          VLOG(0) << trimmed;
-        }
-      }
-
-      // Go back to polling immediately to see if there is more data, don't
-      // handle any signals yet.
-      continue;
-    }
-#ifdef __linux__
-    if (poll_fds[1].revents) {
-      struct signalfd_siginfo siginfo;
-      int s = int_fd->Read(&siginfo, sizeof(siginfo));
-      CHECK(s == sizeof(siginfo)) << "bad read size on signalfd, expected "
-                                  << sizeof(siginfo) << " got " << s;
-      CHECK(siginfo.ssi_signo == SIGINT)
-          << "unexpected signal: " << siginfo.ssi_signo;
-      break;
-    }
-#endif
-  }
+  // We can assume all writers have completed before a SIGINT is sent, but we
+  // need to make sure we've actually read all the data before exiting. So,
+  // keep reading until we get SIGINT and then read what the sources have left
+  // (but not necessarily until EOF).
+  Result<void> result;
+  CF_EXPECT(reactor->Watch(int_fd, EPOLLIN, [&](uint32_t) {
+    struct signalfd_siginfo siginfo;
+    int s = int_fd->Read(&siginfo, sizeof(siginfo));
+    CHECK(s == sizeof(siginfo)) << "bad read size on signalfd, expected "
+                                << sizeof(siginfo) << " got " << s;
+    CHECK(siginfo.ssi_signo == SIGINT)
+        << "unexpected signal: " << siginfo.ssi_signo;
+    result = multiplexer->Drain();
+    reactor->Stop();
+  }));
+
+  VLOG(0) << "Starting to read logs";
+  CF_EXPECT(reactor->Run());
+  CF_EXPECT(std::move(result));
+  VLOG(0) << "Finished reading logs";
+  return {};
+}
+
+}  // namespace
+}  // namespace cuttlefish
+
+int main(int argc, char** argv) {
+  google::ParseCommandLineFlags(&argc, &argv, /* remove_flags */ true);
 
-  VLOG(0) << "Finished reading from process " << FLAGS_process_name;
+  cuttlefish::Result<void> result = cuttlefish::LogTeeMain();
+  CHECK(result.ok()) << result.error();
 }
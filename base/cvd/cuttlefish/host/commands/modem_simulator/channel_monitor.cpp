@@ -16,26 +16,47 @@
 
 #include "cuttlefish/host/commands/modem_simulator/channel_monitor.h"
 
+#include <stdint.h>
+#include <sys/epoll.h>
+
 #include <algorithm>
 
 #include "absl/log/log.h"
 #include "absl/strings/str_replace.h"
 
-#include "cuttlefish/common/libs/fs/shared_select.h"
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/host/commands/modem_simulator/virtual_modem_simulator.h"
+#include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
 
 constexpr int32_t kMaxCommandLength = 4096;
 
-ChannelMonitor::ChannelMonitor(VirtualModemSimulator& modem, SharedFD server)
-    : modem_(modem), server_(std::move(server)) {
-  if (!SharedFD::Pipe(&read_pipe_, &write_pipe_)) {
-    LOG(ERROR) << "Unable to create pipe, ignore";
+ChannelMonitor::ChannelMonitor(VirtualModemSimulator& modem, Reactor& reactor,
+                               SharedFD server)
+    : modem_(modem), reactor_(reactor), server_(std::move(server)) {
+  if (server_->IsOpen()) {
+    Result<void> watched = reactor_.Watch(
+        server_, EPOLLIN, [this](uint32_t) { AcceptIncomingConnection(); });
+    if (!watched.ok()) {
+      LOG(ERROR) << "Unable to watch server socket: " << watched.error();
+    }
+  }
+}
+
+void ChannelMonitor::WatchClient(Client& client) {
+  Result<void> watched =
+      reactor_.Watch(client.client_read_fd_, EPOLLIN,
+                     [this, &client](uint32_t) { ReadCommand(client); });
+  if (!watched.ok()) {
+    LOG(ERROR) << "Unable to watch client: " << watched.error();
   }
+}
 
-  if (server_->IsOpen()) {
-    monitor_thread_ = std::thread([this]() { MonitorLoop(); });
+void ChannelMonitor::UnwatchClient(Client& client) {
+  Result<void> unwatched = reactor_.Unwatch(client.client_read_fd_);
+  if (!unwatched.ok()) {
+    VLOG(0) << "Unable to unwatch client: " << unwatched.error();
   }
 }
 
@@ -52,16 +73,10 @@ ClientId ChannelMonitor::SetRemoteClient(SharedFD client, bool is_accepted) {
   if (remote_client->client_read_fd_->IsOpen() &&
       remote_client->client_write_fd_->IsOpen()) {
     remote_client->first_read_command_ = false;
+    WatchClient(*remote_client);
     remote_clients_.push_back(std::move(remote_client));
     VLOG(0) << "added one remote client";
   }
-
-  // Trigger monitor loop
-  if (write_pipe_->IsOpen()) {
-    write_pipe_->Write("OK", sizeof("OK"));
-  } else {
-    LOG(ERROR) << "Pipe created fail, can't trigger monitor loop";
-  }
   return id;
 }
 
@@ -73,6 +88,7 @@ void ChannelMonitor::AcceptIncomingConnection() {
   } else {
     auto client = std::make_unique<Client>(client_fd);
     VLOG(0) << "added one RIL client";
+    WatchClient(*client);
     clients_.push_back(std::move(client));
     if (clients_.size() == 1) {
       // The first connected client default to be the unsolicited commands
@@ -94,6 +110,7 @@ void ChannelMonitor::ReadCommand(Client& client) {
     }
     VLOG(0) << "Error reading from client fd: "
             << client.client_read_fd_->StrError();
+    UnwatchClient(client);
     client.client_read_fd_->Close();  // Ignore errors here
     client.client_write_fd_->Close();
     // Erase client from the vector clients
@@ -165,17 +182,15 @@ void ChannelMonitor::CloseRemoteConnection(ClientId client) {
   auto iter = remote_clients_.begin();
   for (; iter != remote_clients_.end(); ++iter) {
     if (iter->get()->Id() == client) {
+      UnwatchClient(**iter);
       iter->get()->client_read_fd_->Close();
       iter->get()->client_write_fd_->Close();
       iter->get()->is_valid = false;
 
-      // Trigger monitor loop
-      if (write_pipe_->IsOpen()) {
-        write_pipe_->Write("OK", sizeof("OK"));
-        VLOG(0) << "asking to remove clients";
-      } else {
-        LOG(ERROR) << "Pipe created fail, can't trigger monitor loop";
-      }
+      // The client might be in use further up the stack, so it is only erased
+      // after returning to the reactor.
+      reactor_.Post([this]() { removeInvalidClients(remote_clients_); });
+      VLOG(0) << "asking to remove clients";
       return;
     }
   }
@@ -183,13 +198,19 @@ void ChannelMonitor::CloseRemoteConnection(ClientId client) {
 }
 
 ChannelMonitor::~ChannelMonitor() {
-  if (write_pipe_->IsOpen()) {
-    write_pipe_->Write("KO", sizeof("KO"));
+  if (server_->IsOpen()) {
+    Result<void> unwatched = reactor_.Unwatch(server_);
+    if (!unwatched.ok()) {
+      LOG(ERROR) << "Unable to unwatch server socket: " << unwatched.error();
+    }
   }
-
-  if (monitor_thread_.joinable()) {
-    VLOG(0) << "waiting for monitor thread to join";
-    monitor_thread_.join();
+  for (auto& client : clients_) {
+    UnwatchClient(*client);
+  }
+  for (auto& client : remote_clients_) {
+    if (client->is_valid) {
+      UnwatchClient(*client);
+    }
   }
 }
 
@@ -206,56 +227,4 @@ void ChannelMonitor::removeInvalidClients(
   }
 }
 
-void ChannelMonitor::MonitorLoop() {
-  do {
-    cuttlefish::SharedFDSet read_set;
-    read_set.Set(server_);
-    read_set.Set(read_pipe_);
-    for (auto& client : clients_) {
-      if (client->is_valid) {
-        read_set.Set(client->client_read_fd_);
-      }
-    }
-    for (auto& client : remote_clients_) {
-      if (client->is_valid) {
-        read_set.Set(client->client_read_fd_);
-      }
-    }
-    int num_fds = cuttlefish::Select(&read_set, nullptr, nullptr, nullptr);
-    if (num_fds < 0) {
-      LOG(ERROR) << "Select call returned error : " << strerror(errno);
-      // std::exit(kSelectError);
-      break;
-    } else if (num_fds > 0) {
-      if (read_set.IsSet(server_)) {
-        AcceptIncomingConnection();
-      }
-      if (read_set.IsSet(read_pipe_)) {
-        std::string buf(2, ' ');
-        read_pipe_->Read(buf.data(), buf.size());  // Empty pipe
-        if (buf == std::string("KO")) {
-          VLOG(0) << "requested to exit now";
-          break;
-        }
-        // clean the lists
-        removeInvalidClients(clients_);
-        removeInvalidClients(remote_clients_);
-      }
-      for (auto& client : clients_) {
-        if (read_set.IsSet(client->client_read_fd_)) {
-          ReadCommand(*client);
-        }
-      }
-      for (auto& client : remote_clients_) {
-        if (read_set.IsSet(client->client_read_fd_)) {
-          ReadCommand(*client);
-        }
-      }
-    } else {
-      // Ignore errors here
-      LOG(ERROR) << "Select call returned error : " << strerror(errno);
-    }
-  } while (true);
-}
-
 }  // namespace cuttlefish
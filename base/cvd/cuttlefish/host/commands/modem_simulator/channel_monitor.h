@@ -15,9 +15,9 @@
 
 #pragma once
 
-#include <thread>
 #include <vector>
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/host/commands/modem_simulator/client.h"
 #include "cuttlefish/host/commands/modem_simulator/virtual_modem_simulator.h"
@@ -34,7 +34,10 @@ enum ModemSimulatorExitCodes : int {
 
 class ChannelMonitor {
  public:
-  ChannelMonitor(VirtualModemSimulator& modem, cuttlefish::SharedFD server);
+  // Accepts RIL connections on `server` and reads commands from all clients
+  // on the thread running `reactor`, which must outlive the monitor.
+  ChannelMonitor(VirtualModemSimulator& modem, Reactor& reactor,
+                 cuttlefish::SharedFD server);
   ~ChannelMonitor();
 
   ChannelMonitor(const ChannelMonitor&) = delete;
@@ -49,18 +52,17 @@ class ChannelMonitor {
 
  private:
   VirtualModemSimulator& modem_;
-  std::thread monitor_thread_;
+  Reactor& reactor_;
   cuttlefish::SharedFD server_;
-  cuttlefish::SharedFD read_pipe_;
-  cuttlefish::SharedFD write_pipe_;
   std::vector<std::unique_ptr<Client>> clients_;
   std::vector<std::unique_ptr<Client>> remote_clients_;
 
   void AcceptIncomingConnection();
   void OnClientSocketClosed(int sock);
   void ReadCommand(Client& client);
+  void WatchClient(Client& client);
+  void UnwatchClient(Client& client);
 
-  void MonitorLoop();
   static void removeInvalidClients(
       std::vector<std::unique_ptr<Client>>& clients);
 };
@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/modem_simulator/command_trie.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <optional>
+#include <string_view>
+
+namespace cuttlefish {
+namespace {
+
+bool CharLess(const std::pair<char, uint32_t>& child, char c) {
+  return child.first < c;
+}
+
+}  // namespace
+
+CommandTrie::CommandTrie() : nodes_(1) {}
+
+void CommandTrie::Insert(std::string_view prefix, MatchMode mode,
+                         size_t value) {
+  uint32_t node = 0;
+  for (char c : prefix) {
+    auto& children = nodes_[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), c, CharLess);
+    if (it != children.end() && it->first == c) {
+      node = it->second;
+      continue;
+    }
+    uint32_t child = nodes_.size();
+    children.emplace(it, c, child);
+    // `children` may dangle after this, it is not used again.
+    nodes_.emplace_back();
+    node = child;
+  }
+  auto& slot = mode == FULL_MATCH ? nodes_[node].full_match
+                                  : nodes_[node].partial_match;
+  // An earlier handler for the same prefix shadows later ones.
+  if (!slot) {
+    slot = value;
+  }
+}
+
+uint32_t CommandTrie::Child(uint32_t node, char c) const {
+  const auto& children = nodes_[node].children;
+  auto it = std::lower_bound(children.begin(), children.end(), c, CharLess);
+  return it != children.end() && it->first == c ? it->second : kNoChild;
+}
+
+std::optional<size_t> CommandTrie::Find(std::string_view command) const {
+  std::optional<size_t> best;
+  auto consider = [&best](const std::optional<size_t>& candidate) {
+    if (candidate && (!best || *candidate < *best)) {
+      best = candidate;
+    }
+  };
+
+  uint32_t node = 0;
+  for (char c : command) {
+    consider(nodes_[node].partial_match);
+    node = Child(node, c);
+    if (node == kNoChild) {
+      return best;
+    }
+  }
+  consider(nodes_[node].partial_match);
+  consider(nodes_[node].full_match);
+  return best;
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,65 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cuttlefish {
+
+/**
+ * Maps AT command prefixes to handler indices so that a command can be
+ * matched against every registered handler in a single pass over its
+ * characters.
+ *
+ * When several entries match, the one inserted first wins, which is the same
+ * result a linear scan over the handlers in insertion order would give.
+ */
+class CommandTrie {
+ public:
+  enum MatchMode { FULL_MATCH = 0, PARTIAL_MATCH = 1 };
+
+  CommandTrie();
+
+  // Registers `value` for commands equal to `prefix` (FULL_MATCH) or starting
+  // with it (PARTIAL_MATCH). Values must be inserted in increasing order.
+  void Insert(std::string_view prefix, MatchMode mode, size_t value);
+
+  // Looks up `command`, which must not include the leading "AT".
+  std::optional<size_t> Find(std::string_view command) const;
+
+ private:
+  static constexpr uint32_t kNoChild = 0;
+
+  struct Node {
+    // Sorted by character. AT commands use a small alphabet, so the children
+    // of any node are few and a binary search beats a full fan-out table.
+    std::vector<std::pair<char, uint32_t>> children;
+    std::optional<size_t> full_match;
+    std::optional<size_t> partial_match;
+  };
+
+  uint32_t Child(uint32_t node, char c) const;
+
+  std::vector<Node> nodes_;
+};
+
+}  // namespace cuttlefish
@@ -14,8 +14,12 @@
 // limitations under the License.
 
 #include <signal.h>
+#include <stdint.h>
+#include <sys/epoll.h>
 #include <unistd.h>
 
+#include <memory>
+
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/strings/str_split.h"
@@ -23,12 +27,13 @@
 #include "gflags/gflags.h"
 
 #include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
-#include "cuttlefish/common/libs/fs/shared_select.h"
 #include "cuttlefish/common/libs/utils/tee_logging.h"
 #include "cuttlefish/host/commands/modem_simulator/modem_simulator.h"
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
 #include "cuttlefish/host/libs/log_names/log_names.h"
+#include "cuttlefish/result/result.h"
 
 // we can start multiple modems simultaneously; each modem
 // will listen to one server fd for incoming sms/phone call
@@ -98,6 +103,10 @@ int ModemSimulatorMain(int argc, char** argv) {
   auto nvram_config = NvramConfig::Get();
   const auto nvram_config_file = nvram_config->ConfigFileLocation();
 
+  // All sockets are handled from this thread.
+  Result<std::unique_ptr<Reactor>> reactor = Reactor::Create();
+  CHECK(reactor.ok()) << "Unable to create reactor: " << reactor.error();
+
   // Start channel monitor, wait for RIL to connect
   int32_t modem_id = 0;
   std::vector<std::unique_ptr<ModemSimulator>> modem_simulators;
@@ -109,7 +118,7 @@ int ModemSimulatorMain(int argc, char** argv) {
 
     auto modem_simulator = std::make_unique<ModemSimulator>(modem_id);
     auto channel_monitor =
-        std::make_unique<ChannelMonitor>(*modem_simulator, fd);
+        std::make_unique<ChannelMonitor>(*modem_simulator, **reactor, fd);
 
     modem_simulator->Initialize(std::move(channel_monitor));
 
@@ -130,42 +139,43 @@ int ModemSimulatorMain(int argc, char** argv) {
     std::exit(kServerError);
   }
 
-  // Server loop
-  while (true) {
-    SharedFDSet read_set;
-    read_set.Set(monitor_socket);
-    int num_fds = Select(&read_set, nullptr, nullptr, nullptr);
-    if (num_fds <= 0) {  // Ignore select error
-      LOG(ERROR) << "Select call returned error : " << strerror(errno);
-    } else if (read_set.IsSet(monitor_socket)) {
-      auto conn = SharedFD::Accept(*monitor_socket);
-      std::string buf(4, ' ');
-      auto read = ReadExact(conn, &buf);
-      if (read <= 0) {
-        conn->Close();
-        LOG(WARNING) << "Detected close from the other side";
-        continue;
+  auto handle_monitor_connection = [&monitor_socket, &modem_simulators,
+                                    &nvram_config,
+                                    &nvram_config_file](uint32_t) {
+    auto conn = SharedFD::Accept(*monitor_socket);
+    std::string buf(4, ' ');
+    auto read = ReadExact(conn, &buf);
+    if (read <= 0) {
+      conn->Close();
+      LOG(WARNING) << "Detected close from the other side";
+      return;
+    }
+    if (buf == "STOP") {  // Exit request from parent process
+      LOG(INFO) << "Exit request from parent process";
+      nvram_config->SaveToFile(nvram_config_file);
+      for (auto& modem : modem_simulators) {
+        modem->SaveModemState();
       }
-      if (buf == "STOP") {  // Exit request from parent process
-        LOG(INFO) << "Exit request from parent process";
-        nvram_config->SaveToFile(nvram_config_file);
-        for (auto& modem : modem_simulators) {
-          modem->SaveModemState();
-        }
-        WriteAll(conn, "OK");  // Ignore the return value. Exit anyway.
-        std::exit(kSuccess);
-      } else if (buf.compare(0, 3, "REM") == 0) {  // REMO for modem id 0 ...
-        // Remote request from other cuttlefish instance
-        int id = std::stoi(buf.substr(3, 1));
-        if (id >= modem_simulators.size()) {
-          LOG(ERROR) << "Not supported modem simulator count: " << id;
-        } else {
-          modem_simulators[id]->SetRemoteClient(conn, true);
-        }
+      WriteAll(conn, "OK");  // Ignore the return value. Exit anyway.
+      std::exit(kSuccess);
+    } else if (buf.compare(0, 3, "REM") == 0) {  // REMO for modem id 0 ...
+      // Remote request from other cuttlefish instance
+      int id = std::stoi(buf.substr(3, 1));
+      if (id >= modem_simulators.size()) {
+        LOG(ERROR) << "Not supported modem simulator count: " << id;
+      } else {
+        modem_simulators[id]->SetRemoteClient(conn, true);
       }
     }
-  }
+  };
+  Result<void> watched = (*reactor)->Watch(monitor_socket, EPOLLIN,
+                                           handle_monitor_connection);
+  CHECK(watched.ok()) << "Unable to watch monitor socket: " << watched.error();
+
   // Until kill or exit
+  Result<void> run = (*reactor)->Run();
+  CHECK(run.ok()) << "Event loop failed: " << run.error();
+  return kSuccess;
 }
 
 }  // namespace
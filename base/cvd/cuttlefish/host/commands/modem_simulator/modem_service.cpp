@@ -25,30 +25,21 @@ namespace cuttlefish {
 
 CommandHandler::CommandHandler(const std::string& command, f_func handler)
     : command_prefix(command),
-      match_mode(FULL_MATCH),
+      match_mode(CommandTrie::FULL_MATCH),
       f_command_handler(handler) {}
 
 CommandHandler::CommandHandler(const std::string& command, p_func handler)
     : command_prefix(command),
-      match_mode(PARTIAL_MATCH),
+      match_mode(CommandTrie::PARTIAL_MATCH),
       p_command_handler(handler) {}
 
-int CommandHandler::Compare(const std::string& command) const {
-  int result = -1;
-  if (match_mode == PARTIAL_MATCH) {
-    result =
-        command.compare(2, command_prefix.size(), command_prefix);  // skip "AT"
-  } else {
-    result = command.compare(2, command.size(), command_prefix);
-  }
-  return result;
-}
-
 void CommandHandler::HandleCommand(const Client& client,
                                    std::string& command) const {
-  if (match_mode == PARTIAL_MATCH && p_command_handler != nullptr) {
+  if (match_mode == CommandTrie::PARTIAL_MATCH &&
+      p_command_handler != nullptr) {
     (*p_command_handler)(client, command);
-  } else if (match_mode == FULL_MATCH && f_command_handler != nullptr) {
+  } else if (match_mode == CommandTrie::FULL_MATCH &&
+             f_command_handler != nullptr) {
     (*f_command_handler)(client);
   } else {
     LOG(ERROR) << "Mismatched mode and handler, CHECK!";
@@ -64,18 +55,6 @@ ModemService::ModemService(int32_t service_id,
       thread_looper_(thread_looper),
       channel_monitor_(channel_monitor) {}
 
-bool ModemService::HandleModemCommand(const Client& client,
-                                      std::string command) {
-  for (auto& handler : command_handlers_) {
-    if (handler.Compare(command) == 0) {
-      handler.HandleCommand(client, command);
-      return true;
-    }
-  }
-
-  return false;
-}
-
 void ModemService::HandleCommandDefaultSupported(const Client& client) {
   std::string response{"OK\r"};
   client.SendCommandResponse(response);
@@ -21,6 +21,7 @@
 
 #include "cuttlefish/host/commands/modem_simulator/channel_monitor.h"
 #include "cuttlefish/host/commands/modem_simulator/command_parser.h"
+#include "cuttlefish/host/commands/modem_simulator/command_trie.h"
 #include "cuttlefish/host/commands/modem_simulator/thread_looper.h"
 
 namespace cuttlefish {
@@ -47,12 +48,13 @@ class CommandHandler {
 
   ~CommandHandler() = default;
 
-  int Compare(const std::string& command) const;
+  using MatchMode = CommandTrie::MatchMode;
+
+  const std::string& Prefix() const { return command_prefix; }
+  MatchMode Mode() const { return match_mode; }
   void HandleCommand(const Client& client, std::string& command) const;
 
  private:
-  enum MatchMode { FULL_MATCH = 0, PARTIAL_MATCH = 1 };
-
   std::string command_prefix;
   MatchMode match_mode;
 
@@ -67,7 +69,9 @@ class ModemService {
   ModemService(const ModemService&) = delete;
   ModemService& operator=(const ModemService&) = delete;
 
-  bool HandleModemCommand(const Client& client, std::string command);
+  const std::vector<CommandHandler>& CommandHandlers() const {
+    return command_handlers_;
+  }
 
   static constexpr char kCmeErrorOperationNotAllowed[] = "+CME ERROR: 3";
   static constexpr char kCmeErrorOperationNotSupported[] = "+CME ERROR: 4";
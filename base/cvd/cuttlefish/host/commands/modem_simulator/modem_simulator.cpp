@@ -16,6 +16,8 @@
 #include "cuttlefish/host/commands/modem_simulator/modem_simulator.h"
 
 #include <memory>
+#include <optional>
+#include <string_view>
 
 #include "absl/log/log.h"
 
@@ -92,6 +94,20 @@ void ModemSimulator::RegisterModemService() {
   modem_services_[kSupService] = std::move(supservice);
   modem_services_[kStkService] = std::move(stkservice);
   modem_services_[kMiscService] = std::move(miscservice);
+
+  BuildCommandTrie();
+}
+
+void ModemSimulator::BuildCommandTrie() {
+  command_handlers_.clear();
+  command_trie_ = CommandTrie();
+  for (const auto& [type, service] : modem_services_) {
+    for (const auto& handler : service->CommandHandlers()) {
+      command_trie_.Insert(handler.Prefix(), handler.Mode(),
+                           command_handlers_.size());
+      command_handlers_.push_back(&handler);
+    }
+  }
 }
 
 void ModemSimulator::DispatchCommand(const Client& client,
@@ -106,15 +122,14 @@ void ModemSimulator::DispatchCommand(const Client& client,
     }
   }
 
-  bool success = false;
-  for (auto& service : modem_services_) {
-    success = service.second->HandleModemCommand(client, command);
-    if (success) {
-      break;
-    }
+  std::optional<size_t> handler;
+  if (command.size() >= 2) {
+    // skip "AT"
+    handler = command_trie_.Find(std::string_view(command).substr(2));
   }
-
-  if (!success && client.Type() != Client::REMOTE) {
+  if (handler) {
+    command_handlers_[*handler]->HandleCommand(client, command);
+  } else if (client.Type() != Client::REMOTE) {
     VLOG(0) << "Not supported AT command: " << command;
     client.SendCommandResponse(ModemService::kCmeErrorOperationNotSupported);
   }
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "cuttlefish/host/commands/modem_simulator/channel_monitor.h"
+#include "cuttlefish/host/commands/modem_simulator/command_trie.h"
 #include "cuttlefish/host/commands/modem_simulator/modem_service.h"
 #include "cuttlefish/host/commands/modem_simulator/nvram_config.h"
 #include "cuttlefish/host/commands/modem_simulator/thread_looper.h"
@@ -51,6 +52,11 @@ class ModemSimulator : public VirtualModemSimulator {
   void SetTimeZone(std::string timezone);
   bool SetPhoneNumber(std::string_view number);
 
+  // The handlers of all services, in the order DispatchCommand tries them.
+  const std::vector<const CommandHandler*>& CommandHandlers() const {
+    return command_handlers_;
+  }
+
  private:
   int32_t modem_id_;
   std::unique_ptr<ChannelMonitor> channel_monitor_;
@@ -63,9 +69,15 @@ class ModemSimulator : public VirtualModemSimulator {
 
   std::map<ModemServiceType, std::unique_ptr<ModemService>> modem_services_;
 
+  // Handlers of all services, in the order they are tried, and a trie from
+  // their command prefixes to positions in `command_handlers_`.
+  std::vector<const CommandHandler*> command_handlers_;
+  CommandTrie command_trie_;
+
   static void LoadNvramConfig();
 
   void RegisterModemService();
+  void BuildCommandTrie();
 };
 
 }  // namespace cuttlefish
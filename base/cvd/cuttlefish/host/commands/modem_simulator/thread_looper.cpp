@@ -15,6 +15,10 @@
 
 #include "cuttlefish/host/commands/modem_simulator/thread_looper.h"
 
+#include <algorithm>
+#include <functional>
+#include <utility>
+
 #include "absl/log/check.h"
 
 namespace cuttlefish {
@@ -25,8 +29,11 @@ ThreadLooper::ThreadLooper() : stopped_(false), next_serial_(1) {
 
 ThreadLooper::~ThreadLooper() { Stop(); }
 
-bool ThreadLooper::Event::operator<=(const Event& other) const {
-  return when <= other.when;
+bool ThreadLooper::Timer::operator>(const Timer& other) const {
+  if (when != other.when) {
+    return when > other.when;
+  }
+  return serial > other.serial;
 }
 
 ThreadLooper::Serial ThreadLooper::Post(Callback cb) {
@@ -36,7 +43,7 @@ ThreadLooper::Serial ThreadLooper::Post(Callback cb) {
   // If it's the time to process event with delay exactly when posting
   // a event without delay. Looper would process the event without delay firstly
   // if when set to be std::nullptr. so set when_ to be now.
-  Insert({std::chrono::steady_clock::now(), cb, serial});
+  Insert({std::chrono::steady_clock::now(), serial}, std::move(cb));
 
   return serial;
 }
@@ -46,38 +53,43 @@ ThreadLooper::Serial ThreadLooper::Post(
   CHECK(cb != nullptr);
 
   auto serial = next_serial_++;
-  Insert({std::chrono::steady_clock::now() + delay, cb, serial});
+  Insert({std::chrono::steady_clock::now() + delay, serial}, std::move(cb));
 
   return serial;
 }
 
 bool ThreadLooper::CancelSerial(Serial serial) {
   std::lock_guard<std::mutex> autolock(lock_);
-
-  bool found = false;
-  for (auto iter = queue_.begin(); iter != queue_.end(); ++iter) {
-    if (iter->serial == serial) {
-      queue_.erase(iter);
-      cond_.notify_all();
-
-      found = true;
-      break;
-    }
-  }
-
-  return found;
+  // The looper never needs waking up here: at worst it wakes at the deadline
+  // of the cancelled timer and goes back to sleep.
+  return callbacks_.erase(serial) > 0;
 }
 
-void ThreadLooper::Insert(const Event& event) {
+void ThreadLooper::Insert(Timer timer, Callback cb) {
   std::lock_guard<std::mutex> autolock(lock_);
 
-  auto iter = queue_.begin();
-  while (iter != queue_.end() && *iter <= event) {
-    ++iter;
+  callbacks_.emplace(timer.serial, std::move(cb));
+  timers_.push_back(timer);
+  std::push_heap(timers_.begin(), timers_.end(), std::greater<Timer>());
+  PruneCancelled();
+
+  // Only a new earliest deadline changes how long the looper has to sleep.
+  if (timers_.front().serial == timer.serial) {
+    cond_.notify_one();
   }
+}
 
-  queue_.insert(iter, event);
-  cond_.notify_all();
+void ThreadLooper::PruneCancelled() {
+  if (timers_.size() > 2 * callbacks_.size()) {
+    std::erase_if(timers_, [this](const Timer& timer) {
+      return !callbacks_.contains(timer.serial);
+    });
+    std::make_heap(timers_.begin(), timers_.end(), std::greater<Timer>());
+  }
+  while (!timers_.empty() && !callbacks_.contains(timers_.front().serial)) {
+    std::pop_heap(timers_.begin(), timers_.end(), std::greater<Timer>());
+    timers_.pop_back();
+  }
 }
 
 void ThreadLooper::ThreadLoop() {
@@ -90,22 +102,21 @@ void ThreadLooper::ThreadLoop() {
         break;
       }
 
-      if (queue_.empty()) {
+      PruneCancelled();
+      if (timers_.empty()) {
         cond_.wait(lock);
         continue;
       }
 
-      auto time_to_wait =
-          queue_.front().when - std::chrono::steady_clock::now();
-      if (time_to_wait.count() > 0) {
-        // wait with timeout
-        auto durationMs =
-            std::chrono::duration_cast<std::chrono::milliseconds>(time_to_wait);
-        cond_.wait_for(lock, durationMs);
+      auto when = timers_.front().when;
+      if (when > std::chrono::steady_clock::now()) {
+        cond_.wait_until(lock, when);
         continue;
       }
-      cb = queue_.front().cb;  // callback at front of queue
-      queue_.pop_front();
+      std::pop_heap(timers_.begin(), timers_.end(), std::greater<Timer>());
+      auto node = callbacks_.extract(timers_.back().serial);
+      timers_.pop_back();
+      cb = std::move(node.mapped());
     }
     cb();
   }
@@ -18,10 +18,11 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
-#include <deque>
 #include <functional>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace cuttlefish {
 
@@ -68,12 +69,15 @@ class ThreadLooper {
   bool CancelSerial(Serial serial);
 
  private:
-  struct Event {
+  // Deadlines are kept in a binary min-heap. Callbacks live in `callbacks_`,
+  // so cancelling only erases the callback and leaves a stale heap entry that
+  // is skipped once it reaches the top.
+  struct Timer {
     std::chrono::steady_clock::time_point when;
-    Callback cb;
     Serial serial;
 
-    bool operator<=(const Event& other) const;
+    // Heap order: earliest deadline on top, ties run in posting order.
+    bool operator>(const Timer& other) const;
   };
 
   bool stopped_;
@@ -81,12 +85,16 @@ class ThreadLooper {
 
   std::mutex lock_;
   std::condition_variable cond_;
-  std::deque<Event> queue_;
+  std::vector<Timer> timers_;
+  std::unordered_map<Serial, Callback> callbacks_;
   std::atomic<Serial> next_serial_;
 
   void ThreadLoop();
 
-  void Insert(const Event& event);
+  void Insert(Timer timer, Callback cb);
+  // Drops heap entries of cancelled callbacks from the top of the heap, and
+  // from the whole heap once they outnumber the live ones.
+  void PruneCancelled();
 };
 
 };  // namespace cuttlefish
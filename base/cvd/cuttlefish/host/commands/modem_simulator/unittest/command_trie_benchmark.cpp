@@ -0,0 +1,184 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the prefix trie against the linear scan over every service's
+// handlers that ModemSimulator::DispatchCommand used before, on a sequence of
+// the commands the RIL sends while a device boots and then polls the modem.
+
+#include <stddef.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "benchmark/benchmark.h"
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/host/commands/modem_simulator/channel_monitor.h"
+#include "cuttlefish/host/commands/modem_simulator/command_trie.h"
+#include "cuttlefish/host/commands/modem_simulator/modem_service.h"
+#include "cuttlefish/host/commands/modem_simulator/modem_simulator.h"
+#include "cuttlefish/host/commands/modem_simulator/nvram_config.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+// The handler tables of the modem services, as ModemSimulator registers
+// them. The services fall back to their defaults without a device config, the
+// handlers are only looked up and never run.
+const std::vector<const CommandHandler*>& Handlers() {
+  static ModemSimulator* modem = []() {
+    NvramConfig::InitNvramConfigService(1, 1);
+    Result<std::unique_ptr<Reactor>> reactor = Reactor::Create();
+    CHECK(reactor.ok()) << reactor.error();
+    // Leaked along with the modem, which keeps a reference to it.
+    Reactor* modem_reactor = reactor->release();
+    auto modem = new ModemSimulator(0);
+    modem->Initialize(
+        std::make_unique<ChannelMonitor>(*modem, *modem_reactor, SharedFD()));
+    return modem;
+  }();
+  return modem->CommandHandlers();
+}
+
+// A hand-written sequence modelled on the RIL's start-up requests followed by
+// its periodic polling of the modem, with a call, an SMS and an unsupported
+// command.
+const std::vector<std::string> kRilTrace = {
+    "ATE0Q0V1",
+    "ATS0=0",
+    "AT+CMEE=1",
+    "AT+CREG=2",
+    "AT+CGREG=2",
+    "AT+CEREG=2",
+    "AT+CCWA=1",
+    "AT+CMOD=0",
+    "AT+CMUT=0",
+    "AT+CSSN=0,1",
+    "AT+COLP=0",
+    "AT+CSCS=\"HEX\"",
+    "AT+CUSD=1",
+    "AT+CGEREP=1,0",
+    "AT+CMGF=0",
+    "AT+CFUN?",
+    "AT+CFUN=1",
+    "AT+CPIN?",
+    "AT+CIMI",
+    "AT+CICCID",
+    "AT+CGSN",
+    "AT+CGSN=2",
+    "AT+CLCK=\"SC\",2",
+    "AT+CRSM=192,28486,0,0,15,,\"3F007F20\"",
+    "AT+CRSM=176,28486,0,0,17,,\"3F007F20\"",
+    "AT+CRSM=192,28433,0,0,15,,\"3F007F20\"",
+    "AT+CRSM=176,28433,0,0,1,,\"3F007F20\"",
+    "AT+CTEC=?",
+    "AT+CTEC?",
+    "AT+CSCA?",
+    "AT+CLIP?",
+    "AT+CLIR?",
+    "AT+CGDCONT?",
+    "AT+CGDCONT=1,\"IPV4V6\",\"internet\",,0,0",
+    "AT+CGACT=1,1",
+    "AT+CGACT?",
+    "AT+CGCONTRDP=1",
+    "AT+CREG?",
+    "AT+CGREG?",
+    "AT+CEREG?",
+    "AT+COPS=3,0;+COPS?;+COPS=3,1;+COPS?;+COPS=3,2;+COPS?",
+    "AT+CSQ",
+    "AT+CLCC",
+    "AT+CREG?",
+    "AT+CGREG?",
+    "AT+CEREG?",
+    "AT+CSQ",
+    "AT+CLCC",
+    "AT+COPS?",
+    "AT+CSQ",
+    "AT+CUSATD?",
+    "ATD5551234;",
+    "AT+CLCC",
+    "AT+VTS=1",
+    "ATH",
+    "AT+CMGS=23",
+    "AT+CNMA=1",
+    "AT+XUNSUPPORTED",
+};
+
+std::optional<size_t> LinearFind(const std::string& command) {
+  const std::vector<const CommandHandler*>& handlers = Handlers();
+  for (size_t i = 0; i < handlers.size(); i++) {
+    const std::string& prefix = handlers[i]->Prefix();
+    int result = handlers[i]->Mode() == CommandTrie::PARTIAL_MATCH
+                     ? command.compare(2, prefix.size(), prefix)
+                     : command.compare(2, command.size(), prefix);
+    if (result == 0) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+CommandTrie BuildTrie() {
+  const std::vector<const CommandHandler*>& handlers = Handlers();
+  CommandTrie trie;
+  for (size_t i = 0; i < handlers.size(); i++) {
+    trie.Insert(handlers[i]->Prefix(), handlers[i]->Mode(), i);
+  }
+  return trie;
+}
+
+void BM_LinearDispatch(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& command : kRilTrace) {
+      benchmark::DoNotOptimize(LinearFind(command));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kRilTrace.size());
+}
+BENCHMARK(BM_LinearDispatch);
+
+void BM_TrieDispatch(benchmark::State& state) {
+  CommandTrie trie = BuildTrie();
+  for (const auto& command : kRilTrace) {
+    if (trie.Find(std::string_view(command).substr(2)) !=
+        LinearFind(command)) {
+      state.SkipWithError("Trie and linear dispatch disagree");
+      return;
+    }
+  }
+  for (auto _ : state) {
+    for (const auto& command : kRilTrace) {
+      benchmark::DoNotOptimize(trie.Find(std::string_view(command).substr(2)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kRilTrace.size());
+}
+BENCHMARK(BM_TrieDispatch);
+
+void BM_TrieBuild(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BuildTrie());
+  }
+}
+BENCHMARK(BM_TrieBuild);
+
+}  // namespace
+}  // namespace cuttlefish
@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/modem_simulator/command_trie.h"
+
+#include <optional>
+
+#include "gtest/gtest.h"
+
+namespace cuttlefish {
+namespace {
+
+TEST(CommandTrieTest, FullMatchRequiresWholeCommand) {
+  CommandTrie trie;
+  trie.Insert("+CPIN?", CommandTrie::FULL_MATCH, 0);
+
+  EXPECT_EQ(trie.Find("+CPIN?"), 0);
+  EXPECT_EQ(trie.Find("+CPIN"), std::nullopt);
+  EXPECT_EQ(trie.Find("+CPIN?1"), std::nullopt);
+}
+
+TEST(CommandTrieTest, PartialMatchAcceptsLongerCommands) {
+  CommandTrie trie;
+  trie.Insert("+CPIN=", CommandTrie::PARTIAL_MATCH, 0);
+
+  EXPECT_EQ(trie.Find("+CPIN="), 0);
+  EXPECT_EQ(trie.Find("+CPIN=\"1234\""), 0);
+  EXPECT_EQ(trie.Find("+CPIN"), std::nullopt);
+}
+
+TEST(CommandTrieTest, EarliestInsertedMatchWins) {
+  CommandTrie trie;
+  trie.Insert("+CGDCONT=", CommandTrie::PARTIAL_MATCH, 0);
+  trie.Insert("D*99***1#", CommandTrie::FULL_MATCH, 1);
+  trie.Insert("D", CommandTrie::PARTIAL_MATCH, 2);
+  trie.Insert("+CSSN", CommandTrie::PARTIAL_MATCH, 3);
+  trie.Insert("+CSSN=0,1", CommandTrie::FULL_MATCH, 4);
+  trie.Insert("+CSSN", CommandTrie::PARTIAL_MATCH, 5);
+
+  EXPECT_EQ(trie.Find("D*99***1#"), 1);
+  EXPECT_EQ(trie.Find("D*99***1"), 2);
+  EXPECT_EQ(trie.Find("D5551234;"), 2);
+  EXPECT_EQ(trie.Find("+CSSN=0,1"), 3);
+  EXPECT_EQ(trie.Find("+CGDCONT=1,\"IP\""), 0);
+}
+
+TEST(CommandTrieTest, UnknownCommandsAreNotMatched) {
+  CommandTrie trie;
+  trie.Insert("+CREG", CommandTrie::PARTIAL_MATCH, 0);
+  trie.Insert("A", CommandTrie::FULL_MATCH, 1);
+
+  EXPECT_EQ(trie.Find(""), std::nullopt);
+  EXPECT_EQ(trie.Find("+CRE"), std::nullopt);
+  EXPECT_EQ(trie.Find("+XYZ"), std::nullopt);
+  EXPECT_EQ(trie.Find("AB"), std::nullopt);
+}
+
+}  // namespace
+}  // namespace cuttlefish
@@ -21,6 +21,7 @@
 #include <filesystem>
 #include <fstream>
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_select.h"
 #include "cuttlefish/common/libs/utils/files.h"
 #include "cuttlefish/host/commands/assemble_cvd/flags_defaults.h"
@@ -84,9 +85,13 @@ class ModemServiceTest : public ::testing::Test {
     modem_side_ = new Client(modem_shared_fd);
     modem_simulator_ = new ModemSimulator(0);
 
+    auto reactor = Reactor::Create();
+    ASSERT_TRUE(reactor.ok()) << reactor.error().Message();
+    reactor_ = reactor->release();
+
     cuttlefish::SharedFD server;
     auto channel_monitor =
-        std::make_unique<ChannelMonitor>(*modem_simulator_, server);
+        std::make_unique<ChannelMonitor>(*modem_simulator_, *reactor_, server);
     modem_simulator_->Initialize(std::move(channel_monitor));
   }
 
@@ -94,6 +99,7 @@ class ModemServiceTest : public ::testing::Test {
     delete ril_side_;
     delete modem_side_;
     delete modem_simulator_;
+    delete reactor_;
     fs::remove_all(tmp_test_dir);
   };
 
@@ -220,12 +226,15 @@ class ModemServiceTest : public ::testing::Test {
   static Client* ril_side_;
   static Client* modem_side_;
   static ModemSimulator* modem_simulator_;
+  // Never run, the channel monitor has no server to watch.
+  static Reactor* reactor_;
 
   // For distinguishing the response from command response or unsolicited command
   std::string command_prefix_;
 };
 
 ModemSimulator* ModemServiceTest::modem_simulator_ = nullptr;
+Reactor* ModemServiceTest::reactor_ = nullptr;
 Client* ModemServiceTest::ril_side_ = nullptr;
 Client* ModemServiceTest::modem_side_ = nullptr;
 
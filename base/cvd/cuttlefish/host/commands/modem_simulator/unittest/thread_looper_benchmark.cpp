@@ -0,0 +1,67 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the ThreadLooper operations the modem services issue while
+// polling: posting delayed timers, and cancelling and re-posting them.
+
+#include <chrono>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cuttlefish/host/commands/modem_simulator/thread_looper.h"
+
+namespace cuttlefish {
+namespace {
+
+// Far enough out that no timer fires while the benchmark runs.
+constexpr auto kFarDelay = std::chrono::hours(1);
+
+void BM_PostThenCancel(benchmark::State& state) {
+  ThreadLooper looper;
+  std::vector<ThreadLooper::Serial> serials(state.range(0));
+  for (auto _ : state) {
+    for (size_t i = 0; i < serials.size(); i++) {
+      serials[i] = looper.Post([]() {}, kFarDelay + std::chrono::seconds(i));
+    }
+    for (auto serial : serials) {
+      benchmark::DoNotOptimize(looper.CancelSerial(serial));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * serials.size());
+}
+BENCHMARK(BM_PostThenCancel)->Range(64, 8192);
+
+// A steady set of pending timers, each repeatedly cancelled and re-posted the
+// way registration and signal strength polling reschedule themselves.
+void BM_ReschedulePending(benchmark::State& state) {
+  ThreadLooper looper;
+  std::vector<ThreadLooper::Serial> serials;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    serials.push_back(
+        looper.Post([]() {}, kFarDelay + std::chrono::seconds(i)));
+  }
+  size_t next = 0;
+  for (auto _ : state) {
+    looper.CancelSerial(serials[next]);
+    serials[next] = looper.Post([]() {}, kFarDelay);
+    next = (next + 1) % serials.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReschedulePending)->Range(64, 8192);
+
+}  // namespace
+}  // namespace cuttlefish
@@ -0,0 +1,120 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/modem_simulator/thread_looper.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace cuttlefish {
+namespace {
+
+using std::chrono::milliseconds;
+
+// Collects the ids of callbacks run on the looper thread.
+class Recorder {
+ public:
+  ThreadLooper::Callback Record(int id) {
+    return [this, id]() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ids_.push_back(id);
+      cond_.notify_all();
+    };
+  }
+
+  std::vector<int> WaitFor(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait_for(lock, std::chrono::seconds(10),
+                   [this, count]() { return ids_.size() >= count; });
+    return ids_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::vector<int> ids_;
+};
+
+TEST(ThreadLooperTest, RunsInDeadlineOrder) {
+  Recorder recorder;
+  ThreadLooper looper;
+
+  looper.Post(recorder.Record(3), milliseconds(60));
+  looper.Post(recorder.Record(1), milliseconds(20));
+  looper.Post(recorder.Record(2), milliseconds(40));
+
+  EXPECT_EQ(recorder.WaitFor(3), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(ThreadLooperTest, EqualDeadlinesRunInPostingOrder) {
+  Recorder recorder;
+  ThreadLooper looper;
+
+  for (int i = 0; i < 100; i++) {
+    looper.Post(recorder.Record(i));
+  }
+
+  std::vector<int> ids = recorder.WaitFor(100);
+  ASSERT_EQ(ids.size(), 100);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(ids[i], i);
+  }
+}
+
+TEST(ThreadLooperTest, CancelledCallbacksDoNotRun) {
+  Recorder recorder;
+  ThreadLooper looper;
+
+  auto first = looper.Post(recorder.Record(1), milliseconds(20));
+  looper.Post(recorder.Record(2), milliseconds(40));
+  auto third = looper.Post(recorder.Record(3), milliseconds(60));
+  looper.Post(recorder.Record(4), milliseconds(80));
+
+  EXPECT_TRUE(looper.CancelSerial(first));
+  EXPECT_TRUE(looper.CancelSerial(third));
+  EXPECT_FALSE(looper.CancelSerial(third));
+
+  EXPECT_EQ(recorder.WaitFor(2), (std::vector<int>{2, 4}));
+}
+
+TEST(ThreadLooperTest, CancelAfterRunFails) {
+  Recorder recorder;
+  ThreadLooper looper;
+
+  auto serial = looper.Post(recorder.Record(1));
+  recorder.WaitFor(1);
+
+  EXPECT_FALSE(looper.CancelSerial(serial));
+}
+
+TEST(ThreadLooperTest, ManyCancelledTimersDoNotDelayLiveOnes) {
+  Recorder recorder;
+  ThreadLooper looper;
+
+  for (int i = 0; i < 10000; i++) {
+    auto serial = looper.Post(recorder.Record(-1), std::chrono::hours(1));
+    ASSERT_TRUE(looper.CancelSerial(serial));
+  }
+  looper.Post(recorder.Record(1), milliseconds(10));
+
+  EXPECT_EQ(recorder.WaitFor(1), (std::vector<int>{1}));
+}
+
+}  // namespace
+}  // namespace cuttlefish
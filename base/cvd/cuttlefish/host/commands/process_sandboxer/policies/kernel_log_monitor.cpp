@@ -24,6 +24,9 @@ sandbox2::PolicyBuilder KernelLogMonitorPolicy(const HostInfo& host) {
   return BaselinePolicy(host, host.HostToolExe("kernel_log_monitor"))
       .AddDirectory(host.log_dir, /* is_ro= */ false)
       .AddFile(host.cuttlefish_config_path)
+      .AllowEpoll()
+      .AllowEpollWait()
+      .AllowEventFd()
       .AllowHandleSignals()
       .AllowOpen()
       .AllowRead()
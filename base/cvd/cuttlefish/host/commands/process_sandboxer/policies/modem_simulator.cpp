@@ -48,6 +48,9 @@ sandbox2::PolicyBuilder ModemSimulatorPolicy(const HostInfo& host) {
             };
           })
       .AddPolicyOnSyscall(__NR_socket, {ARG_32(0), JEQ32(AF_UNIX, ALLOW)})
+      .AllowEpoll()
+      .AllowEpollWait()
+      .AllowEventFd()
       .AllowHandleSignals()
       .AllowPipe()
       .AllowSafeFcntl()
@@ -122,6 +122,8 @@ sandbox2::PolicyBuilder RunCvdPolicy(const HostInfo& host) {
                                         JEQ32(AF_VSOCK, ALLOW)})
       .AllowChmod()
       .AllowDup()
+      .AllowEpoll()
+      .AllowEpollWait()
       .AllowEventFd()
       .AllowFork()  // Multithreading, sandboxer_proxy, process monitor
       .AllowGetIDs()
@@ -33,6 +33,9 @@ sandbox2::PolicyBuilder SecureEnvPolicy(const HostInfo& host) {
       .AddFile(host.cuttlefish_config_path)
       .AddFile(exe)  // to exec itself
       .AllowDup()
+      .AllowEpoll()
+      .AllowEpollWait()
+      .AllowEventFd()
       .AllowFork()    // Something is using clone, not sure what
       .AllowGetIDs()  // For getuid
       .AllowSafeFcntl()
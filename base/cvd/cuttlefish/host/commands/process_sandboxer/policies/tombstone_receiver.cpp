@@ -31,6 +31,9 @@ sandbox2::PolicyBuilder TombstoneReceiverPolicy(const HostInfo& host) {
       .AddDirectory(JoinPath(host.runtime_dir, "tombstones"),
                     /* is_ro= */ false)
       .AddFile(host.cuttlefish_config_path)
+      .AllowEpoll()
+      .AllowEpollWait()
+      .AllowEventFd()
       .AllowSafeFcntl()
       .AllowSelect()
       .AllowSyscall(__NR_accept)
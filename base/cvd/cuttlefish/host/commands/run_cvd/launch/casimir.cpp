@@ -62,8 +62,7 @@ Result<std::vector<MonitorCommand>> Casimir(
   }
 
   std::vector<MonitorCommand> commands;
-  commands.emplace_back(
-      CF_EXPECT(log_tee.CreateFullLogTee(casimir, "casimir")));
+  CF_EXPECT(log_tee.TeeFullLogs(casimir, "casimir"));
   commands.emplace_back(std::move(casimir));
   return commands;
 }
@@ -62,8 +62,11 @@ Result<std::vector<MonitorCommand>> Cvdalloc::Commands() {
   Command cmd(path, KillSubprocessFallback(nice_stop));
   cmd.AddParameter("--id=", instance_.id());
   cmd.AddParameter("--socket=", their_socket_);
+  MonitorCommand monitored(std::move(cmd));
+  monitored.id = Name();
+  monitored.readiness_probe = [this]() { return WaitForAvailability(); };
   std::vector<MonitorCommand> commands;
-  commands.emplace_back(std::move(cmd));
+  commands.emplace_back(std::move(monitored));
   return commands;
 }
 
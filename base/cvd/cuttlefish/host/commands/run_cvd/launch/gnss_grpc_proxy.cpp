@@ -31,6 +31,7 @@
 namespace cuttlefish {
 
 Result<std::optional<MonitorCommand>> GnssGrpcProxyServer(
+    const CuttlefishConfig& config,
     const CuttlefishConfig::InstanceSpecific& instance,
     GrpcSocketCreator& grpc_socket) {
   if (!instance.enable_gnss_grpc_proxy()) {
@@ -68,6 +69,14 @@ Result<std::optional<MonitorCommand>> GnssGrpcProxyServer(
     gnss_grpc_proxy_cmd.AddParameter("--fixed_location_file_path=",
                                      instance.fixed_location_file_path());
   }
+  if (!instance.gnss_file_path().empty() ||
+      !instance.fixed_location_file_path().empty()) {
+    gnss_grpc_proxy_cmd.AddParameter("--replay_speed=",
+                                     instance.gnss_replay_speed());
+    // Instances replaying the same files parse them once.
+    gnss_grpc_proxy_cmd.AddParameter("--timeline_cache_dir=",
+                                     config.AssemblyPath("gnss_timelines"));
+  }
   return gnss_grpc_proxy_cmd;
 }
 
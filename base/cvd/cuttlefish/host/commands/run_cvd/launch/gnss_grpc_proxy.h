@@ -25,6 +25,7 @@
 namespace cuttlefish {
 
 Result<std::optional<MonitorCommand>> GnssGrpcProxyServer(
+    const CuttlefishConfig& config,
     const CuttlefishConfig::InstanceSpecific& instance,
     GrpcSocketCreator& grpc_socket);
 
@@ -129,54 +129,44 @@ class VhostInputDevices : public CommandSource,
     std::vector<MonitorCommand> commands;
     Command rotary_cmd =
         NewVhostUserInputCommand(rotary_sockets_, DefaultRotaryDeviceSpec());
-    Command rotary_log_tee =
-        CF_EXPECT(log_tee_.CreateLogTee(rotary_cmd, "vhost_user_rotary",
-                                        Command::StdIoChannel::kStdErr),
-                  "Failed to create log tee command for rotary device");
+    CF_EXPECT(log_tee_.TeeLogs(rotary_cmd, "vhost_user_rotary",
+                               Command::StdIoChannel::kStdErr),
+              "Failed to create log tee for rotary device");
     commands.emplace_back(std::move(rotary_cmd));
-    commands.emplace_back(std::move(rotary_log_tee));
 
     if (instance_.enable_mouse()) {
       Command mouse_cmd =
           NewVhostUserInputCommand(mouse_sockets_, DefaultMouseSpec());
-      Command mouse_log_tee =
-          CF_EXPECT(log_tee_.CreateLogTee(mouse_cmd, "vhost_user_mouse",
-                                          Command::StdIoChannel::kStdErr),
-                    "Failed to create log tee command for mouse device");
+      CF_EXPECT(log_tee_.TeeLogs(mouse_cmd, "vhost_user_mouse",
+                                 Command::StdIoChannel::kStdErr),
+                "Failed to create log tee for mouse device");
       commands.emplace_back(std::move(mouse_cmd));
-      commands.emplace_back(std::move(mouse_log_tee));
     }
 
     if (instance_.enable_gamepad()) {
       Command gamepad_cmd =
           NewVhostUserInputCommand(gamepad_sockets_, DefaultGamepadSpec());
-      Command gamepad_log_tee =
-          CF_EXPECT(log_tee_.CreateLogTee(gamepad_cmd, "vhost_user_gamepad",
-                                          Command::StdIoChannel::kStdErr),
-                    "Failed to create log tee command for gamepad device");
+      CF_EXPECT(log_tee_.TeeLogs(gamepad_cmd, "vhost_user_gamepad",
+                                 Command::StdIoChannel::kStdErr),
+                "Failed to create log tee for gamepad device");
       commands.emplace_back(std::move(gamepad_cmd));
-      commands.emplace_back(std::move(gamepad_log_tee));
     }
 
     std::string keyboard_spec =
         instance_.custom_keyboard_config().value_or(DefaultKeyboardSpec());
     Command keyboard_cmd =
         NewVhostUserInputCommand(keyboard_sockets_, keyboard_spec);
-    Command keyboard_log_tee =
-        CF_EXPECT(log_tee_.CreateLogTee(keyboard_cmd, "vhost_user_keyboard",
-                                        Command::StdIoChannel::kStdErr),
-                  "Failed to create log tee command for keyboard device");
+    CF_EXPECT(log_tee_.TeeLogs(keyboard_cmd, "vhost_user_keyboard",
+                               Command::StdIoChannel::kStdErr),
+              "Failed to create log tee for keyboard device");
     commands.emplace_back(std::move(keyboard_cmd));
-    commands.emplace_back(std::move(keyboard_log_tee));
 
     Command switches_cmd =
         NewVhostUserInputCommand(switches_sockets_, DefaultSwitchesSpec());
-    Command switches_log_tee =
-        CF_EXPECT(log_tee_.CreateLogTee(switches_cmd, "vhost_user_switches",
-                                        Command::StdIoChannel::kStdErr),
-                  "Failed to create log tee command for switches device");
+    CF_EXPECT(log_tee_.TeeLogs(switches_cmd, "vhost_user_switches",
+                               Command::StdIoChannel::kStdErr),
+              "Failed to create log tee for switches device");
     commands.emplace_back(std::move(switches_cmd));
-    commands.emplace_back(std::move(switches_log_tee));
 
     const bool use_multi_touch = ShouldEnableMultitouch(instance_);
 
@@ -198,13 +188,11 @@ class VhostInputDevices : public CommandSource,
                  "Failed to write touchscreen spec to file: {}", spec_path);
       Command touchscreen_cmd =
           NewVhostUserInputCommand(touchscreen_sockets_[i], spec_path);
-      Command touchscreen_log_tee = CF_EXPECTF(
-          log_tee_.CreateLogTee(touchscreen_cmd,
-                                fmt::format("vhost_user_touchscreen_{}", i),
-                                Command::StdIoChannel::kStdErr),
-          "Failed to create log tee for touchscreen device", i);
+      CF_EXPECTF(log_tee_.TeeLogs(touchscreen_cmd,
+                                  fmt::format("vhost_user_touchscreen_{}", i),
+                                  Command::StdIoChannel::kStdErr),
+                 "Failed to create log tee for touchscreen {}", i);
       commands.emplace_back(std::move(touchscreen_cmd));
-      commands.emplace_back(std::move(touchscreen_log_tee));
     }
 
     std::string touchpad_template_path =
@@ -225,13 +213,11 @@ class VhostInputDevices : public CommandSource,
                  "Failed to write touchpad spec to file: {}", spec_path);
       Command touchpad_cmd =
           NewVhostUserInputCommand(touchpad_sockets_[i], spec_path);
-      Command touchpad_log_tee =
-          CF_EXPECTF(log_tee_.CreateLogTee(
-                         touchpad_cmd, fmt::format("vhost_user_touchpad_{}", i),
-                         Command::StdIoChannel::kStdErr),
-                     "Failed to create log tee for touchpad {}", i);
+      CF_EXPECTF(log_tee_.TeeLogs(touchpad_cmd,
+                                  fmt::format("vhost_user_touchpad_{}", i),
+                                  Command::StdIoChannel::kStdErr),
+                 "Failed to create log tee for touchpad {}", i);
       commands.emplace_back(std::move(touchpad_cmd));
-      commands.emplace_back(std::move(touchpad_log_tee));
     }
     return commands;
   }
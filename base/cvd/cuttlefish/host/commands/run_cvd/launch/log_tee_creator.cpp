@@ -15,54 +15,106 @@
 
 #include "cuttlefish/host/commands/run_cvd/launch/log_tee_creator.h"
 
+#include <fcntl.h>
+#include <signal.h>
+
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "fmt/format.h"
+#include "fruit/fruit.h"
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/host/libs/config/config_utils.h"
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
+#include "cuttlefish/host/libs/feature/command_source.h"
+#include "cuttlefish/host/libs/feature/feature.h"
 #include "cuttlefish/process/command.h"
+#include "cuttlefish/process/subprocess.h"
 #include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
 
-namespace {
-Result<Command> CreateLogTeeImpl(
-    Command& cmd, const CuttlefishConfig::InstanceSpecific& instance,
-    std::string process_name,
+LogTeeCreator::LogTeeCreator(const CuttlefishConfig::InstanceSpecific& instance)
+    : instance_(instance) {}
+
+Result<void> LogTeeCreator::TeeLogsImpl(
+    Command& cmd, std::string process_name,
     const std::vector<Command::StdIoChannel>& log_channels) {
+  for (const auto& [name, path] : sources_) {
+    CF_EXPECTF(name != process_name, "Duplicate log tee source '{}'", name);
+  }
   auto name_with_ext = process_name + "_logs.fifo";
-  auto logs_path = instance.PerInstanceInternalPath(name_with_ext.c_str());
+  auto logs_path = instance_.PerInstanceInternalPath(name_with_ext.c_str());
   auto logs = CF_EXPECT(SharedFD::Fifo(logs_path, 0666));
 
   for (const auto& channel : log_channels) {
     cmd.RedirectStdIO(channel, logs);
   }
 
-  return Command(HostBinaryPath("log_tee"))
-      .AddParameter("--process_name=", process_name)
-      .AddParameter("--log_fd_in=", logs);
+  sources_.emplace_back(std::move(process_name), std::move(logs_path));
+  return {};
 }
-}  // namespace
-
-LogTeeCreator::LogTeeCreator(const CuttlefishConfig::InstanceSpecific& instance)
-    : instance_(instance) {}
 
-Result<Command> LogTeeCreator::CreateFullLogTee(Command& cmd,
-                                                std::string process_name) {
-  return CF_EXPECT(CreateLogTeeImpl(
-      cmd, instance_, std::move(process_name),
+Result<void> LogTeeCreator::TeeFullLogs(Command& cmd,
+                                        std::string process_name) {
+  CF_EXPECT(TeeLogsImpl(
+      cmd, std::move(process_name),
       {Command::StdIoChannel::kStdOut, Command::StdIoChannel::kStdErr}));
+  return {};
 }
 
-Result<Command> LogTeeCreator::CreateLogTee(Command& cmd,
-                                            std::string process_name,
-                                            Command::StdIoChannel log_channel) {
+Result<void> LogTeeCreator::TeeLogs(Command& cmd, std::string process_name,
+                                    Command::StdIoChannel log_channel) {
   CF_EXPECT(log_channel != Command::StdIoChannel::kStdIn,
             "Invalid channel for log tee: stdin");
-  return CF_EXPECT(
-      CreateLogTeeImpl(cmd, instance_, std::move(process_name), {log_channel}));
+  CF_EXPECT(TeeLogsImpl(cmd, std::move(process_name), {log_channel}));
+  return {};
+}
+
+Result<std::vector<MonitorCommand>> LogTeeCreator::Commands() {
+  // Sources are added by the commands created after this one, so they are
+  // only known by the time the log tee starts.
+  Command log_tee(HostBinaryPath("log_tee"));
+  log_tee.AddParameter("--log_sources_file=",
+                       instance_.PerInstanceInternalPath("log_tee_sources"));
+  if (instance_.log_index()) {
+    log_tee.AddParameter("--log_index_dir=",
+                         instance_.PerInstanceLogPath("log_index"));
+  }
+  log_tee.AddPrerequisite([this]() { return WriteSourcesFile(); });
+  log_tee.SetStopper(KillSubprocessFallback([](Subprocess* proc) {
+    // Ask nicely so that log_tee gets a chance to process all the logs.
+    bool res = kill(proc->pid(), SIGINT) == 0;
+    return res ? StopperResult::kSuccess : StopperResult::kFailure;
+  }));
+
+  std::vector<MonitorCommand> commands;
+  commands.emplace_back(std::move(log_tee));
+  return commands;
+}
+
+Result<void> LogTeeCreator::WriteSourcesFile() {
+  std::string contents;
+  for (const auto& [name, path] : sources_) {
+    contents += fmt::format("{} {}\n", name, path);
+  }
+  std::string path = instance_.PerInstanceInternalPath("log_tee_sources");
+  SharedFD file = SharedFD::Open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+  CF_EXPECTF(file->IsOpen(), "Failed to open '{}': {}", path,
+             file->StrError());
+  CF_EXPECTF(WriteAll(file, contents) == static_cast<ssize_t>(contents.size()),
+             "Failed to write '{}': {}", path, file->StrError());
+  return {};
+}
+
+fruit::Component<fruit::Required<const CuttlefishConfig::InstanceSpecific>>
+LogTeeComponent() {
+  return fruit::createComponent()
+      .addMultibinding<CommandSource, LogTeeCreator>()
+      .addMultibinding<SetupFeature, LogTeeCreator>();
 }
 
 }  // namespace cuttlefish
@@ -16,29 +16,57 @@
 #pragma once
 
 #include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "fruit/fruit.h"
 
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
+#include "cuttlefish/host/libs/feature/command_source.h"
 #include "cuttlefish/process/command.h"
 #include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
 
-class LogTeeCreator {
+// Runs the instance's log tee, a single process that reads the logs of all
+// the commands set up through this class and writes them to the launcher log,
+// credited to the command that wrote them.
+class LogTeeCreator : public CommandSource {
  public:
   INJECT(LogTeeCreator(const CuttlefishConfig::InstanceSpecific& instance));
 
-  // Creates a log tee command for the stdout and stderr channels of the given
-  // command.
-  Result<Command> CreateFullLogTee(Command& cmd, std::string process_name);
+  // Sends the stdout and stderr channels of the given command to the log tee.
+  Result<void> TeeFullLogs(Command& cmd, std::string process_name);
 
-  // Creates a log tee command for specified channel of the given command.
-  Result<Command> CreateLogTee(Command& cmd, std::string process_name,
-                               Command::StdIoChannel log_channel);
+  // Sends the specified channel of the given command to the log tee.
+  Result<void> TeeLogs(Command& cmd, std::string process_name,
+                       Command::StdIoChannel log_channel);
+
+  // CommandSource
+  Result<std::vector<MonitorCommand>> Commands() override;
+
+  // SetupFeature
+  std::string Name() const override { return "LogTee"; }
 
  private:
+  std::unordered_set<SetupFeature*> Dependencies() const override { return {}; }
+  Result<void> ResultSetup() override { return {}; }
+
+  Result<void> TeeLogsImpl(
+      Command& cmd, std::string process_name,
+      const std::vector<Command::StdIoChannel>& log_channels);
+  // Lists the sources for the log tee to read, when it starts.
+  Result<void> WriteSourcesFile();
+
   const CuttlefishConfig::InstanceSpecific instance_;
+  // Process names and the paths of the FIFOs their logs are written to.
+  std::vector<std::pair<std::string, std::string>> sources_;
 };
 
+// The log tee is started before the commands whose logs it reads, so this
+// should be installed first.
+fruit::Component<fruit::Required<const CuttlefishConfig::InstanceSpecific>>
+LogTeeComponent();
+
 }  // namespace cuttlefish
@@ -80,8 +80,11 @@ class Mcu : public vm_manager::VmmDependencyCommand {
     }
 
     std::vector<MonitorCommand> commands;
-    commands.emplace_back(CF_EXPECT(log_tee_.CreateFullLogTee(command, "mcu")));
-    commands.emplace_back(std::move(command));
+    CF_EXPECT(log_tee_.TeeFullLogs(command, "mcu"));
+    MonitorCommand monitored(std::move(command));
+    monitored.id = Name();
+    monitored.readiness_probe = [this]() { return WaitForAvailability(); };
+    commands.emplace_back(std::move(monitored));
     return commands;
   }
 
@@ -65,15 +65,6 @@ class OpenWrt : public CommandSource {
 
     CrosvmBuilder ap_cmd;
 
-    ap_cmd.Cmd().AddPrerequisite([this]() -> Result<void> {
-      if (cvdalloc_.Enabled()) {
-        CF_EXPECT(cvdalloc_.WaitForAvailability());
-        LOG(INFO) << "openwrt (run_cvd): cvdalloc is available.";
-      }
-      CF_EXPECT(wmediumd_server_.WaitForAvailability());
-      return {};
-    });
-
     std::string first_time_argument;
     if (IsRestoring(config_)) {
       const std::string snapshot_dir_path = config_.snapshot_path();
@@ -171,9 +162,14 @@ class OpenWrt : public CommandSource {
     }
 
     std::vector<MonitorCommand> commands;
-    commands.emplace_back(
-        CF_EXPECT(log_tee_.CreateFullLogTee(ap_cmd.Cmd(), "openwrt")));
-    commands.emplace_back(std::move(ap_cmd.Cmd()));
+    CF_EXPECT(log_tee_.TeeFullLogs(ap_cmd.Cmd(), "openwrt"));
+    MonitorCommand& monitored = commands.emplace_back(std::move(ap_cmd.Cmd()));
+    if (cvdalloc_.Enabled()) {
+      monitored.dependencies.push_back(cvdalloc_.Name());
+    }
+    if (wmediumd_server_.Enabled()) {
+      monitored.dependencies.push_back(wmediumd_server_.Name());
+    }
     return commands;
   }
 
@@ -43,7 +43,7 @@ Result<std::vector<MonitorCommand>> Pica(
                   .AddParameter("--pcapng-dir=", pcap_dir);
 
   std::vector<MonitorCommand> commands;
-  commands.emplace_back(CF_EXPECT(log_tee.CreateFullLogTee(pica, "pica")));
+  CF_EXPECT(log_tee.TeeFullLogs(pica, "pica"));
   commands.emplace_back(std::move(pica));
   return commands;
 }
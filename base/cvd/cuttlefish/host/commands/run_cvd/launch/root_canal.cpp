@@ -114,8 +114,7 @@ class RootCanal : public CommandSource {
                                       config_.rootcanal_link_ble_port());
 
     std::vector<MonitorCommand> commands;
-    commands.emplace_back(
-        CF_EXPECT(log_tee_.CreateFullLogTee(rootcanal, "rootcanal")));
+    CF_EXPECT(log_tee_.TeeFullLogs(rootcanal, "rootcanal"));
     commands.emplace_back(std::move(rootcanal));
     commands.emplace_back(std::move(hci_vsock_proxy));
     commands.emplace_back(std::move(test_vsock_proxy));
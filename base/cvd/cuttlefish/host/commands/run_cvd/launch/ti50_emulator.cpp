@@ -69,9 +69,12 @@ class Ti50Emulator : public vm_manager::VmmDependencyCommand {
     command.AddParameter("-p=", instance_.instance_dir());
 
     std::vector<MonitorCommand> commands;
-    commands.emplace_back(
-        CF_EXPECT(log_tee_.CreateFullLogTee(command, "ti50")));
-    commands.emplace_back(std::move(command));
+    CF_EXPECT(log_tee_.TeeFullLogs(command, "ti50"));
+    MonitorCommand monitored(std::move(command));
+    // Accepts the emulator's connection, so it must only run once.
+    monitored.id = Name();
+    monitored.readiness_probe = [this]() { return WaitForAvailability(); };
+    commands.emplace_back(std::move(monitored));
     return commands;
   }
 
@@ -57,6 +57,9 @@ class VhostDeviceVsock : public vm_manager::VmmDependencyCommand {
   std::string Name() const override;
   bool Enabled() const override;
 
+  // VmmDependencyCommand
+  bool StartsDaemon() const override;
+
   Result<void> WaitForAvailability() override;
 
  private:
@@ -74,10 +77,10 @@ VhostDeviceVsock::VhostDeviceVsock(
     : log_tee_(log_tee), instance_(instance), cfconfig_(cfconfig) {}
 
 Result<std::vector<MonitorCommand>> VhostDeviceVsock::Commands() {
-  auto instances = cfconfig_.Instances();
-  if (instance_.serial_number() != instances[0].serial_number()) {
+  if (!StartsDaemon()) {
     return {};
   }
+  auto instances = cfconfig_.Instances();
 
   Command command(ProcessRestarterBinary());
   command.AddParameter("-when_killed");
@@ -104,9 +107,11 @@ Result<std::vector<MonitorCommand>> VhostDeviceVsock::Commands() {
   }
 
   std::vector<MonitorCommand> commands;
-  commands.emplace_back(
-      CF_EXPECT(log_tee_.CreateFullLogTee(command, "vhost_device_vsock")));
-  commands.emplace_back(std::move(command));
+  CF_EXPECT(log_tee_.TeeFullLogs(command, "vhost_device_vsock"));
+  MonitorCommand monitored(std::move(command));
+  monitored.id = Name();
+  monitored.readiness_probe = [this]() { return WaitForAvailability(); };
+  commands.emplace_back(std::move(monitored));
   return commands;
 }
 
@@ -114,6 +119,11 @@ std::string VhostDeviceVsock::Name() const { return "VhostDeviceVsock"; }
 
 bool VhostDeviceVsock::Enabled() const { return instance_.vhost_user_vsock(); }
 
+// A single device serves the vsock of all instances, started by the first.
+bool VhostDeviceVsock::StartsDaemon() const {
+  return instance_.serial_number() == cfconfig_.Instances()[0].serial_number();
+}
+
 Result<void> VhostDeviceVsock::WaitForAvailability() {
   if (Enabled()) {
     CF_EXPECT(WaitForUnixSocket(
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "fmt/format.h"
 #include "fruit/component.h"
 #include "fruit/fruit_forward_decls.h"
 #include "fruit/macro.h"
@@ -80,11 +81,11 @@ class VhostUserMediaDevices : public CommandSource {
       }
       Command cmd = NewCommand(binary_path, instance_.media_socket_path(index),
                                config.lens_facing);
-      Command cmd_log_tee = CF_EXPECT(
-          log_tee_.CreateLogTee(cmd, "vhu_media_simple_device", kStdErr),
-          "Failed to create log tee command for media device");
+      CF_EXPECT(
+          log_tee_.TeeLogs(
+              cmd, fmt::format("vhu_media_simple_device_{}", index), kStdErr),
+          "Failed to create log tee for media device");
       commands.emplace_back(std::move(cmd));
-      commands.emplace_back(std::move(cmd_log_tee));
     }
     return commands;
   }
@@ -92,8 +92,11 @@ Result<std::vector<MonitorCommand>> WmediumdServer::Commands() {
   cmd.AddParameter("--grpc_uds_path=", grpc_socket_.CreateGrpcSocket(Name()));
 
   std::vector<MonitorCommand> commands;
-  commands.emplace_back(CF_EXPECT(log_tee_.CreateFullLogTee(cmd, "wmediumd")));
-  commands.emplace_back(std::move(cmd));
+  CF_EXPECT(log_tee_.TeeFullLogs(cmd, "wmediumd"));
+  MonitorCommand monitored(std::move(cmd));
+  monitored.id = Name();
+  monitored.readiness_probe = [this]() { return WaitForAvailability(); };
+  commands.emplace_back(std::move(monitored));
   return commands;
 }
 
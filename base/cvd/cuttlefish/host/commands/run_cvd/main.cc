@@ -19,6 +19,7 @@
 #include <unistd.h>
 
 #include <fstream>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -43,6 +44,7 @@
 #include "cuttlefish/host/commands/run_cvd/launch/gnss_grpc_proxy.h"
 #include "cuttlefish/host/commands/run_cvd/launch/input_connections_provider.h"
 #include "cuttlefish/host/commands/run_cvd/launch/kernel_log_monitor.h"
+#include "cuttlefish/host/commands/run_cvd/launch/log_tee_creator.h"
 #include "cuttlefish/host/commands/run_cvd/launch/logcat_receiver.h"
 #include "cuttlefish/host/commands/run_cvd/launch/mcu.h"
 #include "cuttlefish/host/commands/run_cvd/launch/modem.h"
@@ -155,6 +157,8 @@ fruit::Component<> runCvdComponent(
       .bindInstance(*config)
       .bindInstance(*instance)
       .bindInstance(*environment)
+      // Started first and stopped last, to read the logs of everything else.
+      .install(LogTeeComponent)
 #ifdef __linux__
       .install(AutoCmd<AutomotiveProxyService>::Component)
       .install(AutoCmd<ModemSimulator>::Component)
@@ -239,7 +243,8 @@ void ConfigureLogs(const CuttlefishConfig& config,
   if (config.Instances().size() > 1) {
     prefix = instance.instance_name() + ": ";
   }
-  LogToStderrAndFiles({log_path}, prefix);
+  LogToStderrAndFiles({log_path}, prefix, MetadataLevel::ONLY_MESSAGE,
+                      std::nullopt, LogDelivery::Asynchronous);
 }
 
 }  // namespace
@@ -18,6 +18,8 @@
 
 #include <errno.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <sys/epoll.h>
 #include <unistd.h>
 #include <utime.h>
 
@@ -30,15 +32,17 @@
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/log/log_sink_registry.h"
 #include "fruit/injector.h"
 #include "gflags/gflags.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_buf.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
-#include "cuttlefish/common/libs/fs/shared_select.h"
 #include "cuttlefish/common/libs/utils/files.h"
 #include "cuttlefish/host/commands/run_cvd/launch/snapshot_control_files.h"
 #include "cuttlefish/host/commands/run_cvd/launch/webrtc_controller.h"
+#include "cuttlefish/host/libs/cgroup/instance_cgroup.h"
 #include "cuttlefish/host/libs/command_util/runner/defs.h"
 #include "cuttlefish/host/libs/command_util/runner/run_cvd.pb.h"
 #include "cuttlefish/host/libs/command_util/util.h"
@@ -97,6 +101,20 @@ Result<void> ServerLoopImpl::Run() {
       instance_.restart_subprocesses());
   process_monitor_properties.StraceLogDir(instance_.PerInstanceLogPath(""));
   process_monitor_properties.StraceCommands(config_.straced_host_executables());
+  process_monitor_properties.StartupReportPath(
+      instance_.PerInstanceLogPath("process_startup_times.json"));
+  if (!instance_.cgroup_path().empty()) {
+    CgroupLimits limits = {
+        .cpu_max = instance_.cgroup_cpu_max(),
+        .memory_high = instance_.cgroup_memory_high(),
+        .cpuset_cpus = instance_.cgroup_cpuset(),
+    };
+    InstanceCgroup cgroup = CF_EXPECT(InstanceCgroup::Create(
+        instance_.cgroup_path(), limits, instance_.vmm_numa_node()));
+    // Everything started from here on inherits the cgroup.
+    CF_EXPECT(cgroup.JoinDaemons());
+    process_monitor_properties.VmmCgroup(cgroup.VmmPath());
+  }
 
   for (auto& command_source : command_sources_) {
     if (command_source->Enabled()) {
@@ -114,53 +132,81 @@ Result<void> ServerLoopImpl::Run() {
   CF_EXPECT(process_monitor.StartAndMonitorProcesses());
   device_status_ = DeviceStatus::kActive;
 
-  while (true) {
-    // TODO: use select to handle simultaneous connections.
-    SharedFDSet read_set;
-    read_set.Set(server_);
-    read_set.Set(process_monitor.status());
-
-    Select(&read_set, nullptr, nullptr, nullptr);
+  std::unique_ptr<Reactor> reactor = CF_EXPECT(Reactor::Create());
+  Result<void> result;
+  CF_EXPECT(reactor->Watch(process_monitor.status(), EPOLLIN,
+                           [&reactor, &result](uint32_t) {
+                             result = CF_ERR("process monitor has died");
+                             reactor->Stop();
+                           }));
+  // Requests are handled as they arrive, so a client that is connected but
+  // hasn't sent its request yet doesn't hold up the others.
+  CF_EXPECT(reactor->Watch(
+      server_, EPOLLIN, [this, &reactor, &process_monitor](uint32_t) {
+        auto client = SharedFD::Accept(*server_);
+        if (!client->IsOpen()) {
+          LOG(ERROR) << "Failed to accept client: " << client->StrError();
+          return;
+        }
+        Result<void> watched = reactor->Watch(
+            client, EPOLLIN,
+            [this, &reactor, &process_monitor, client](uint32_t) {
+              HandleClientRequest(*reactor, client, process_monitor);
+            });
+        if (!watched.ok()) {
+          LOG(ERROR) << "Failed to watch client: " << watched.error();
+        }
+      }));
+
+  CF_EXPECT(reactor->Run());
+  return result;
+}
 
-    if (read_set.IsSet(process_monitor.status())) {
-      return CF_ERR("process monitor has died");
+void ServerLoopImpl::HandleClientRequest(Reactor& reactor, SharedFD client,
+                                         ProcessMonitor& process_monitor) {
+  auto close_client = [&reactor, &client]() {
+    Result<void> unwatched = reactor.Unwatch(client);
+    if (!unwatched.ok()) {
+      LOG(ERROR) << "Failed to unwatch client: " << unwatched.error();
     }
+    client->Close();
+  };
 
-    CF_EXPECT(read_set.IsSet(server_));
-    auto client = SharedFD::Accept(*server_);
-    while (client->IsOpen()) {
-      auto launcher_action_with_info_result = ReadLauncherActionFromFd(client);
-      if (!launcher_action_with_info_result.ok()) {
-        LOG(ERROR) << "Reading launcher command from monitor failed: "
-                   << launcher_action_with_info_result.error();
-        break;
-      }
-      auto launcher_action_opt = std::move(*launcher_action_with_info_result);
-      if (!launcher_action_opt.has_value()) {
-        // client disconnected
-        break;
-      }
-      auto launcher_action = *launcher_action_opt;
-      if (launcher_action.action != LauncherAction::kExtended) {
-        HandleActionWithNoData(launcher_action.action, client, process_monitor);
-        continue;
-      }
-      auto result = HandleExtended(launcher_action, process_monitor);
-      auto response = LauncherResponse::kSuccess;
-      if (!result.ok()) {
-        LOG(ERROR) << "Failed to handle extended action request.";
-        LOG(ERROR) << result.error();
-        response = LauncherResponse::kError;
-      }
-      const auto n_written = client->Write(&response, sizeof(response));
-      if (n_written != sizeof(response)) {
-        LOG(ERROR) << "Failed to write response";
-      }
-      // extended operations for now are 1 time request-response exchanges.
-      // thus, we will close the client FD.
-      client->Close();
+  auto launcher_action_with_info_result = ReadLauncherActionFromFd(client);
+  if (!launcher_action_with_info_result.ok()) {
+    LOG(ERROR) << "Reading launcher command from monitor failed: "
+               << launcher_action_with_info_result.error();
+    close_client();
+    return;
+  }
+  auto launcher_action_opt = std::move(*launcher_action_with_info_result);
+  if (!launcher_action_opt.has_value()) {
+    // client disconnected
+    close_client();
+    return;
+  }
+  auto launcher_action = *launcher_action_opt;
+  if (launcher_action.action != LauncherAction::kExtended) {
+    HandleActionWithNoData(launcher_action.action, client, process_monitor);
+    if (!client->IsOpen()) {
+      close_client();
     }
+    return;
+  }
+  auto result = HandleExtended(launcher_action, process_monitor);
+  auto response = LauncherResponse::kSuccess;
+  if (!result.ok()) {
+    LOG(ERROR) << "Failed to handle extended action request.";
+    LOG(ERROR) << result.error();
+    response = LauncherResponse::kError;
+  }
+  const auto n_written = client->Write(&response, sizeof(response));
+  if (n_written != sizeof(response)) {
+    LOG(ERROR) << "Failed to write response";
   }
+  // extended operations for now are 1 time request-response exchanges.
+  // thus, we will close the client FD.
+  close_client();
 }
 
 Result<void> ServerLoopImpl::ResultSetup() {
@@ -449,6 +495,8 @@ void ServerLoopImpl::RestartRunCvd(int notification_fd) {
   argv[argv_vec.size()] = reboot_notification.data();
   argv[argv_vec.size() + 1] = nullptr;
 
+  // Staged log lines would be lost with this process image.
+  absl::FlushLogSinks();
   execv("/proc/self/exe", argv.get());
   // execve should not return, so something went wrong.
   PLOG(ERROR) << "execv returned: ";
@@ -24,6 +24,7 @@
 
 #include "fruit/fruit.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/common/libs/utils/json.h"
 #include "cuttlefish/host/commands/run_cvd/launch/webrtc_controller.h"
@@ -79,6 +80,9 @@ class ServerLoopImpl : public ServerLoop,
   Result<void> HandleScreenshotDisplay(
       const run_cvd::ScreenshotDisplay& request);
 
+  // Handles one request from a client of the launcher monitor socket.
+  void HandleClientRequest(Reactor& reactor, SharedFD client,
+                           ProcessMonitor& process_monitor);
   void HandleActionWithNoData(const LauncherAction action,
                               const SharedFD& client,
                               ProcessMonitor& process_monitor);
@@ -27,6 +27,7 @@
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/log/log_sink_registry.h"
 
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/common/libs/security/confui_sign.h"
@@ -45,7 +46,7 @@
 #include "cuttlefish/host/commands/secure_env/proxy_keymaster_context.h"
 #include "cuttlefish/host/commands/secure_env/rust/kmr_ta.h"
 #include "cuttlefish/host/commands/secure_env/soft_gatekeeper.h"
-#include "cuttlefish/host/commands/secure_env/storage/insecure_json_storage.h"
+#include "cuttlefish/host/commands/secure_env/storage/insecure_log_storage.h"
 #include "cuttlefish/host/commands/secure_env/storage/storage.h"
 #include "cuttlefish/host/commands/secure_env/storage/tpm_storage.h"
 #include "cuttlefish/host/commands/secure_env/suspend_resume_handler.h"
@@ -117,6 +118,8 @@ SharedFD DupFdFlag(gflags::int32 fd) {
     argv[i] = strdup(gflags::GetArgvs()[i].c_str());
     CHECK(argv[i] != nullptr) << "OOM";
   }
+  // Staged log lines would be lost with this process image.
+  absl::FlushLogSinks();
   execv(SecureEnvBinary().c_str(), argv.data());
   char buf[128];
   LOG(FATAL) << "Exec failed, secure_env is out of sync with the guest: "
@@ -186,7 +189,7 @@ ChooseOemlockComponent() {
       .registerProvider(
           [](TpmResourceManager& resource_manager) -> secure_env::Storage* {
             if (FLAGS_oemlock_impl == "software") {
-              return new secure_env::InsecureJsonStorage("oemlock_insecure");
+              return new secure_env::InsecureLogStorage("oemlock_insecure");
             } else if (FLAGS_oemlock_impl == "tpm") {
               return new secure_env::TpmStorage(resource_manager,
                                                 "oemlock_secure");
@@ -241,11 +244,11 @@ SecureEnvComponent() {
                                           "gatekeeper_secure");
       })
       .registerProvider([]() {
-        return new secure_env::InsecureJsonStorage("gatekeeper_insecure");
+        return new secure_env::InsecureLogStorage("gatekeeper_insecure");
       })
       .registerProvider([](TpmResourceManager& resource_manager,
                            secure_env::TpmStorage& secure_storage,
-                           secure_env::InsecureJsonStorage& insecure_storage) {
+                           secure_env::InsecureLogStorage& insecure_storage) {
         return new TpmGatekeeper(resource_manager, secure_storage,
                                  insecure_storage);
       })
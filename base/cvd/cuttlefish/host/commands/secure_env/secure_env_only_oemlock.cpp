@@ -20,6 +20,7 @@
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/log/log_sink_registry.h"
 #include "gflags/gflags.h"
 
 #include "cuttlefish/common/libs/fs/shared_fd.h"
@@ -28,7 +29,7 @@
 #include "cuttlefish/host/commands/kernel_log_monitor/utils.h"
 #include "cuttlefish/host/commands/secure_env/oemlock/oemlock.h"
 #include "cuttlefish/host/commands/secure_env/oemlock/oemlock_responder.h"
-#include "cuttlefish/host/commands/secure_env/storage/insecure_json_storage.h"
+#include "cuttlefish/host/commands/secure_env/storage/insecure_log_storage.h"
 #include "cuttlefish/host/commands/secure_env/suspend_resume_handler.h"
 #include "cuttlefish/host/commands/secure_env/worker_thread_loop_body.h"
 #include "cuttlefish/host/libs/config/known_paths.h"
@@ -92,6 +93,8 @@ SharedFD DupFdFlag(gflags::int32 fd) {
     argv[i] = strdup(gflags::GetArgvs()[i].c_str());
     CHECK(argv[i] != nullptr) << "OOM";
   }
+  // Staged log lines would be lost with this process image.
+  absl::FlushLogSinks();
   execv(SecureEnvBinary().c_str(), argv.data());
   char buf[128];
   LOG(FATAL) << "Exec failed, secure_env is out of sync with the guest: "
@@ -134,7 +137,7 @@ Result<void> SecureEnvMain(int argc, char** argv) {
   DefaultSubprocessLogging(argv);
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
-  secure_env::InsecureJsonStorage storage("oemlock_insecure");
+  secure_env::InsecureLogStorage storage("oemlock_insecure");
   oemlock::OemLock oemlock(storage);
 
   std::timed_mutex oemlock_lock;
@@ -0,0 +1,101 @@
+//
+// Copyright (C) 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/secure_env/storage/insecure_log_storage.h"
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "json/json.h"
+
+#include "cuttlefish/common/libs/utils/base64.h"
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/common/libs/utils/json.h"
+#include "cuttlefish/host/commands/secure_env/storage/key_value_log.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace secure_env {
+namespace {
+
+Result<std::map<std::string, std::vector<uint8_t>>> ReadLegacyJson(
+    const std::string& path) {
+  std::string json = CF_EXPECT(ReadFileContents(path));
+  Json::Value root = CF_EXPECT(ParseJson(json));
+  std::map<std::string, std::vector<uint8_t>> entries;
+  for (const std::string& key : root.getMemberNames()) {
+    entries[key] = CF_EXPECTF(DecodeBase64(root[key].asString()),
+                              "Failed to decode base64 to read key '{}'", key);
+  }
+  return entries;
+}
+
+}  // namespace
+
+InsecureLogStorage::InsecureLogStorage(std::string path)
+    : path_(std::move(path)) {}
+
+Result<KeyValueLog*> InsecureLogStorage::Log() const {
+  if (log_) {
+    return log_.get();
+  }
+  // Files from before the log format are JSON objects. They are converted in
+  // one step so that a crash leaves either the old or the new file.
+  if (FileHasContent(path_) && !KeyValueLog::IsLogFile(path_)) {
+    auto legacy =
+        CF_EXPECTF(ReadLegacyJson(path_), "Failed to import '{}'", path_);
+    log_ = std::make_unique<KeyValueLog>(
+        CF_EXPECT(KeyValueLog::Create(path_, std::move(legacy))));
+    return log_.get();
+  }
+  KeyValueLog log = CF_EXPECT(KeyValueLog::Open(path_));
+  log_ = std::make_unique<KeyValueLog>(std::move(log));
+  return log_.get();
+}
+
+bool InsecureLogStorage::Exists() const {
+  std::lock_guard lock(mutex_);
+  return log_ != nullptr || FileHasContent(path_);
+}
+
+Result<bool> InsecureLogStorage::HasKey(const std::string& key) const {
+  std::lock_guard lock(mutex_);
+  return CF_EXPECT(Log())->Contains(key);
+}
+
+Result<ManagedStorageData> InsecureLogStorage::Read(
+    const std::string& key) const {
+  std::lock_guard lock(mutex_);
+  const std::vector<uint8_t>* value = CF_EXPECT(Log())->Get(key);
+  CF_EXPECT(value != nullptr, "Key: " << key << " not found in " << path_);
+  return CF_EXPECT(CreateStorageData(value->data(), value->size()));
+}
+
+Result<void> InsecureLogStorage::Write(const std::string& key,
+                                        const StorageData& data) {
+  std::lock_guard lock(mutex_);
+  std::vector<uint8_t> value(data.payload, data.payload + data.size);
+  CF_EXPECT(CF_EXPECT(Log())->Put(key, std::move(value)));
+  return {};
+}
+
+}  // namespace secure_env
+}  // namespace cuttlefish
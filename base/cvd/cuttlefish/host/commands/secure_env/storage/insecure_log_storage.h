@@ -15,14 +15,25 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "cuttlefish/host/commands/secure_env/storage/key_value_log.h"
 #include "cuttlefish/host/commands/secure_env/storage/storage.h"
 
 namespace cuttlefish {
 namespace secure_env {
 
-class InsecureJsonStorage : public secure_env::Storage {
+/**
+ * Unencrypted storage backed by a `KeyValueLog` that is loaded once and then
+ * served from memory. Files written by older versions as a JSON object of
+ * base64 values are converted to the log format the first time they are
+ * opened.
+ */
+class InsecureLogStorage : public secure_env::Storage {
  public:
-  InsecureJsonStorage(std::string path);
+  InsecureLogStorage(std::string path);
 
   Result<bool> HasKey(const std::string& key) const override;
   Result<ManagedStorageData> Read(const std::string& key) const override;
@@ -30,7 +41,11 @@ class InsecureJsonStorage : public secure_env::Storage {
   bool Exists() const override;
 
  private:
+  Result<KeyValueLog*> Log() const;
+
   std::string path_;
+  mutable std::mutex mutex_;
+  mutable std::unique_ptr<KeyValueLog> log_;
 };
 
 }  // namespace secure_env
@@ -0,0 +1,90 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/secure_env/storage/insecure_log_storage.h"
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "android-base/file.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/host/commands/secure_env/storage/key_value_log.h"
+#include "cuttlefish/host/commands/secure_env/storage/storage.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace secure_env {
+namespace {
+
+using testing::ElementsAre;
+
+class InsecureLogStorageTest : public testing::Test {
+ protected:
+  std::string path_ =
+      testing::TempDir() + "/insecure_log_storage_" +
+      testing::UnitTest::GetInstance()->current_test_info()->name();
+
+  void TearDown() override { unlink(path_.c_str()); }
+
+  static std::vector<uint8_t> Payload(const ManagedStorageData& data) {
+    return std::vector<uint8_t>(data->payload, data->payload + data->size);
+  }
+};
+
+TEST_F(InsecureLogStorageTest, MissingFileDoesNotExist) {
+  InsecureLogStorage storage(path_);
+
+  EXPECT_FALSE(storage.Exists());
+  EXPECT_NE(access(path_.c_str(), F_OK), 0);
+}
+
+TEST_F(InsecureLogStorageTest, ImportsLegacyJson) {
+  // Older versions stored base64 values, here {1, 2, 3} and {1}.
+  ASSERT_TRUE(android::base::WriteStringToFile(
+      R"({"blob": "AQID", "oemlock": "AQ=="})", path_));
+
+  {
+    InsecureLogStorage storage(path_);
+    ASSERT_TRUE(storage.Exists());
+    EXPECT_THAT(storage.HasKey("oemlock"), IsOkAndValue(true));
+    Result<ManagedStorageData> blob = storage.Read("blob");
+    ASSERT_THAT(blob, IsOk());
+    EXPECT_THAT(Payload(*blob), ElementsAre(1, 2, 3));
+
+    Result<ManagedStorageData> update = CreateStorageData("\x02", 1);
+    ASSERT_THAT(update, IsOk());
+    EXPECT_THAT(storage.Write("oemlock", **update), IsOk());
+  }
+  EXPECT_TRUE(KeyValueLog::IsLogFile(path_));
+
+  InsecureLogStorage reopened(path_);
+  EXPECT_TRUE(reopened.Exists());
+  Result<ManagedStorageData> oemlock = reopened.Read("oemlock");
+  ASSERT_THAT(oemlock, IsOk());
+  EXPECT_THAT(Payload(*oemlock), ElementsAre(2));
+  Result<ManagedStorageData> blob = reopened.Read("blob");
+  ASSERT_THAT(blob, IsOk());
+  EXPECT_THAT(Payload(*blob), ElementsAre(1, 2, 3));
+}
+
+}  // namespace
+}  // namespace secure_env
+}  // namespace cuttlefish
@@ -0,0 +1,260 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/secure_env/storage/key_value_log.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "android-base/file.h"
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace secure_env {
+namespace {
+
+constexpr std::string_view kSignature = "CFKVLOG1";
+
+// Compaction is skipped for small logs, the rewrite would cost more than the
+// space it reclaims.
+constexpr uint64_t kMinCompactionBytes = 64 * 1024;
+
+struct RecordHeader {
+  uint32_t crc;
+  uint32_t key_size;
+  uint32_t value_size;
+};
+
+// zlib resets the checksum when handed a null buffer, which an empty key or
+// value may have.
+uLong UpdateCrc(uLong crc, const void* data, size_t size) {
+  if (size == 0) {
+    return crc;
+  }
+  return crc32(crc, reinterpret_cast<const Bytef*>(data), size);
+}
+
+uint32_t RecordCrc(const RecordHeader& header, std::string_view key,
+                   const uint8_t* value) {
+  uLong crc = UpdateCrc(crc32(0, nullptr, 0), &header.key_size,
+                        sizeof(header.key_size) + sizeof(header.value_size));
+  crc = UpdateCrc(crc, key.data(), key.size());
+  return UpdateCrc(crc, value, header.value_size);
+}
+
+uint64_t RecordSize(std::string_view key, const std::vector<uint8_t>& value) {
+  return sizeof(RecordHeader) + key.size() + value.size();
+}
+
+void AppendRecord(std::string& out, std::string_view key,
+                  const std::vector<uint8_t>& value) {
+  RecordHeader header{
+      .key_size = static_cast<uint32_t>(key.size()),
+      .value_size = static_cast<uint32_t>(value.size()),
+  };
+  header.crc = RecordCrc(header, key, value.data());
+  out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.append(key);
+  out.append(reinterpret_cast<const char*>(value.data()), value.size());
+}
+
+// Parses records from `contents` into `entries`, returning the offset just
+// past the last intact record.
+size_t ParseRecords(std::string_view contents,
+                    std::map<std::string, std::vector<uint8_t>>& entries) {
+  size_t offset = kSignature.size();
+  while (contents.size() - offset >= sizeof(RecordHeader)) {
+    RecordHeader header;
+    memcpy(&header, contents.data() + offset, sizeof(header));
+    size_t payload = size_t{header.key_size} + header.value_size;
+    if (contents.size() - offset - sizeof(header) < payload) {
+      break;
+    }
+    std::string_view key =
+        contents.substr(offset + sizeof(header), header.key_size);
+    auto value = reinterpret_cast<const uint8_t*>(key.data() + key.size());
+    if (RecordCrc(header, key, value) != header.crc) {
+      break;
+    }
+    entries[std::string(key)].assign(value, value + header.value_size);
+    offset += sizeof(header) + payload;
+  }
+  return offset;
+}
+
+Result<void> WriteAndSync(SharedFD fd, const std::string& data) {
+  CF_EXPECT_EQ(WriteAll(fd, data), data.size(), fd->StrError());
+  CF_EXPECT_EQ(fd->Fsync(), 0, fd->StrError());
+  return {};
+}
+
+Result<void> SyncDirectoryOf(const std::string& path) {
+  SharedFD dir = SharedFD::Open(android::base::Dirname(path),
+                                O_RDONLY | O_DIRECTORY);
+  CF_EXPECT(dir->IsOpen(), dir->StrError());
+  CF_EXPECT_EQ(dir->Fsync(), 0, dir->StrError());
+  return {};
+}
+
+// Writes a log holding `entries` to a temporary file and renames it over
+// `path`. Returns the new file and its size.
+Result<std::pair<SharedFD, uint64_t>> ReplaceLogFile(
+    const std::string& path,
+    const std::map<std::string, std::vector<uint8_t>>& entries) {
+  std::string contents(kSignature);
+  for (const auto& [key, value] : entries) {
+    AppendRecord(contents, key, value);
+  }
+
+  const std::string temp_path = path + ".tmp";
+  SharedFD temp =
+      SharedFD::Open(temp_path, O_RDWR | O_APPEND | O_CREAT | O_TRUNC, 0600);
+  CF_EXPECTF(temp->IsOpen(), "Failed to open '{}': {}", temp_path,
+             temp->StrError());
+  CF_EXPECT(WriteAndSync(temp, contents));
+  CF_EXPECTF(rename(temp_path.c_str(), path.c_str()) == 0,
+             "Failed to rename '{}' to '{}': {}", temp_path, path,
+             strerror(errno));
+  CF_EXPECT(SyncDirectoryOf(path));
+  return std::make_pair(temp, uint64_t{contents.size()});
+}
+
+}  // namespace
+
+bool KeyValueLog::IsLogFile(const std::string& path) {
+  SharedFD fd = SharedFD::Open(path, O_RDONLY);
+  std::string signature(kSignature.size(), '\0');
+  return fd->IsOpen() &&
+         fd->Read(signature.data(), signature.size()) == signature.size() &&
+         signature == kSignature;
+}
+
+Result<KeyValueLog> KeyValueLog::Open(const std::string& path) {
+  SharedFD fd = SharedFD::Open(path, O_RDWR | O_APPEND | O_CREAT, 0600);
+  CF_EXPECTF(fd->IsOpen(), "Failed to open '{}': {}", path, fd->StrError());
+
+  std::string contents;
+  CF_EXPECT_GE(ReadAll(fd, &contents), 0, fd->StrError());
+  std::map<std::string, std::vector<uint8_t>> entries;
+  if (contents.empty()) {
+    CF_EXPECT(WriteAndSync(fd, std::string(kSignature)));
+    return KeyValueLog(path, fd, std::move(entries), kSignature.size());
+  }
+  CF_EXPECTF(std::string_view(contents).starts_with(kSignature),
+             "'{}' is not a key-value log", path);
+
+  size_t valid = ParseRecords(contents, entries);
+  if (valid != contents.size()) {
+    LOG(WARNING) << "Discarding " << contents.size() - valid
+                 << " bytes of incomplete records at the end of " << path;
+    CF_EXPECT_EQ(fd->Truncate(valid), 0, fd->StrError());
+    CF_EXPECT_EQ(fd->Fsync(), 0, fd->StrError());
+  }
+  return KeyValueLog(path, fd, std::move(entries), valid);
+}
+
+Result<KeyValueLog> KeyValueLog::Create(
+    const std::string& path,
+    std::map<std::string, std::vector<uint8_t>> entries) {
+  auto [fd, size] = CF_EXPECT(ReplaceLogFile(path, entries));
+  return KeyValueLog(path, fd, std::move(entries), size);
+}
+
+KeyValueLog::KeyValueLog(std::string path, SharedFD fd,
+                         std::map<std::string, std::vector<uint8_t>> entries,
+                         uint64_t log_bytes)
+    : path_(std::move(path)),
+      fd_(std::move(fd)),
+      entries_(std::move(entries)),
+      log_bytes_(log_bytes),
+      live_bytes_(LiveBytes()) {}
+
+bool KeyValueLog::Contains(const std::string& key) const {
+  return entries_.count(key) > 0;
+}
+
+const std::vector<uint8_t>* KeyValueLog::Get(const std::string& key) const {
+  auto it = entries_.find(key);
+  return it == entries_.end() ? nullptr : &it->second;
+}
+
+Result<void> KeyValueLog::Put(const std::string& key,
+                              std::vector<uint8_t> value) {
+  std::string record;
+  AppendRecord(record, key, value);
+  Result<void> written = WriteAndSync(fd_, record);
+  if (!written.ok()) {
+    // Open stops at the first bad record, so a torn one left behind would
+    // hide every record appended after it.
+    CF_EXPECTF(DiscardTornRecord(),
+               "Failed to append to '{}' and to discard the partial record",
+               path_);
+    CF_EXPECTF(std::move(written), "Failed to append to '{}'", path_);
+  }
+  log_bytes_ += record.size();
+  auto [it, inserted] = entries_.try_emplace(key);
+  if (!inserted) {
+    live_bytes_ -= RecordSize(key, it->second);
+  }
+  live_bytes_ += record.size();
+  it->second = std::move(value);
+
+  if (log_bytes_ > kMinCompactionBytes && log_bytes_ > 2 * live_bytes_) {
+    CF_EXPECT(Compact());
+  }
+  return {};
+}
+
+Result<void> KeyValueLog::DiscardTornRecord() {
+  if (fd_->Truncate(log_bytes_) == 0 && fd_->Fsync() == 0) {
+    return {};
+  }
+  LOG(WARNING) << "Failed to truncate '" << path_ << "': " << fd_->StrError()
+               << ", rewriting it";
+  CF_EXPECT(Compact());
+  return {};
+}
+
+Result<void> KeyValueLog::Compact() {
+  auto [fd, size] = CF_EXPECT(ReplaceLogFile(path_, entries_));
+  fd_ = fd;
+  log_bytes_ = size;
+  live_bytes_ = size;
+  return {};
+}
+
+uint64_t KeyValueLog::LiveBytes() const {
+  uint64_t bytes = kSignature.size();
+  for (const auto& [key, value] : entries_) {
+    bytes += RecordSize(key, value);
+  }
+  return bytes;
+}
+
+}  // namespace secure_env
+}  // namespace cuttlefish
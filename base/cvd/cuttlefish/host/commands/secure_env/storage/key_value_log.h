@@ -0,0 +1,78 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace secure_env {
+
+/**
+ * Binary key-value store kept fully in memory and persisted as an append-only
+ * log of checksummed records.
+ *
+ * Every `Put` appends a single record and fsyncs it, so a crash can at worst
+ * leave a torn final record, which is discarded on the next `Open`. Once the
+ * log holds mostly overwritten records it is compacted by writing the live
+ * entries to a temporary file and renaming it over the log.
+ */
+class KeyValueLog {
+ public:
+  // Returns true if `path` starts with the log file signature.
+  static bool IsLogFile(const std::string& path);
+
+  // Loads the log at `path`, creating an empty one if it does not exist.
+  static Result<KeyValueLog> Open(const std::string& path);
+  // Atomically replaces whatever is at `path` with a log holding exactly
+  // `entries`.
+  static Result<KeyValueLog> Create(
+      const std::string& path,
+      std::map<std::string, std::vector<uint8_t>> entries);
+
+  bool Contains(const std::string& key) const;
+  // Returns nullptr if the key is not present.
+  const std::vector<uint8_t>* Get(const std::string& key) const;
+  Result<void> Put(const std::string& key, std::vector<uint8_t> value);
+
+  size_t Size() const { return entries_.size(); }
+
+ private:
+  KeyValueLog(std::string path, SharedFD fd,
+              std::map<std::string, std::vector<uint8_t>> entries,
+              uint64_t log_bytes);
+
+  // Cuts the log back to its last complete record after a failed append.
+  Result<void> DiscardTornRecord();
+  Result<void> Compact();
+  uint64_t LiveBytes() const;
+
+  std::string path_;
+  SharedFD fd_;
+  std::map<std::string, std::vector<uint8_t>> entries_;
+  uint64_t log_bytes_;
+  // What `log_bytes_` would be right after compaction.
+  uint64_t live_bytes_;
+};
+
+}  // namespace secure_env
+}  // namespace cuttlefish
@@ -0,0 +1,146 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/commands/secure_env/storage/key_value_log.h"
+
+#include <signal.h>
+#include <stdint.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "android-base/file.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace secure_env {
+namespace {
+
+using testing::Pointee;
+
+class KeyValueLogTest : public testing::Test {
+ protected:
+  std::string path_ =
+      testing::TempDir() + "/key_value_log_" +
+      testing::UnitTest::GetInstance()->current_test_info()->name();
+
+  void TearDown() override { unlink(path_.c_str()); }
+
+  off_t FileSize() {
+    struct stat st {};
+    stat(path_.c_str(), &st);
+    return st.st_size;
+  }
+};
+
+TEST_F(KeyValueLogTest, ValuesSurviveReopen) {
+  {
+    Result<KeyValueLog> log = KeyValueLog::Open(path_);
+    ASSERT_THAT(log, IsOk());
+    EXPECT_THAT(log->Put("a", {1, 2, 3}), IsOk());
+    EXPECT_THAT(log->Put("b", {}), IsOk());
+    EXPECT_THAT(log->Put("a", {4}), IsOk());
+  }
+  EXPECT_TRUE(KeyValueLog::IsLogFile(path_));
+
+  Result<KeyValueLog> log = KeyValueLog::Open(path_);
+  ASSERT_THAT(log, IsOk());
+  EXPECT_EQ(log->Size(), 2);
+  EXPECT_THAT(log->Get("a"), Pointee(std::vector<uint8_t>{4}));
+  EXPECT_THAT(log->Get("b"), Pointee(std::vector<uint8_t>{}));
+  EXPECT_EQ(log->Get("c"), nullptr);
+}
+
+TEST_F(KeyValueLogTest, TornRecordIsDiscarded) {
+  {
+    Result<KeyValueLog> log = KeyValueLog::Open(path_);
+    ASSERT_THAT(log, IsOk());
+    EXPECT_THAT(log->Put("a", {1}), IsOk());
+    EXPECT_THAT(log->Put("b", {2, 2, 2, 2}), IsOk());
+  }
+  ASSERT_EQ(truncate(path_.c_str(), FileSize() - 2), 0);
+
+  Result<KeyValueLog> log = KeyValueLog::Open(path_);
+  ASSERT_THAT(log, IsOk());
+  EXPECT_THAT(log->Get("a"), Pointee(std::vector<uint8_t>{1}));
+  EXPECT_FALSE(log->Contains("b"));
+
+  // Records appended after recovery are readable again.
+  EXPECT_THAT(log->Put("c", {3}), IsOk());
+  Result<KeyValueLog> reopened = KeyValueLog::Open(path_);
+  ASSERT_THAT(reopened, IsOk());
+  EXPECT_THAT(reopened->Get("c"), Pointee(std::vector<uint8_t>{3}));
+}
+
+TEST_F(KeyValueLogTest, FailedPutLeavesNoTornRecord) {
+  {
+    Result<KeyValueLog> log = KeyValueLog::Open(path_);
+    ASSERT_THAT(log, IsOk());
+    EXPECT_THAT(log->Put("a", {1}), IsOk());
+
+    // Only part of the next record fits under the file size limit.
+    sighandler_t old_handler = signal(SIGXFSZ, SIG_IGN);
+    struct rlimit old_limit;
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &old_limit), 0);
+    struct rlimit limit = old_limit;
+    limit.rlim_cur = FileSize() + 8;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limit), 0);
+    Result<void> put = log->Put("b", std::vector<uint8_t>(64, 2));
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &old_limit), 0);
+    signal(SIGXFSZ, old_handler);
+    EXPECT_THAT(put, IsError());
+    EXPECT_FALSE(log->Contains("b"));
+
+    EXPECT_THAT(log->Put("c", {3}), IsOk());
+  }
+
+  Result<KeyValueLog> log = KeyValueLog::Open(path_);
+  ASSERT_THAT(log, IsOk());
+  EXPECT_THAT(log->Get("a"), Pointee(std::vector<uint8_t>{1}));
+  EXPECT_FALSE(log->Contains("b"));
+  EXPECT_THAT(log->Get("c"), Pointee(std::vector<uint8_t>{3}));
+}
+
+TEST_F(KeyValueLogTest, OverwritesAreCompacted) {
+  Result<KeyValueLog> log = KeyValueLog::Open(path_);
+  ASSERT_THAT(log, IsOk());
+  std::vector<uint8_t> value(1024, 0);
+  for (int i = 0; i < 1000; i++) {
+    value[0] = i;
+    ASSERT_THAT(log->Put("key", value), IsOk());
+  }
+  EXPECT_LT(FileSize(), 128 * 1024);
+
+  Result<KeyValueLog> reopened = KeyValueLog::Open(path_);
+  ASSERT_THAT(reopened, IsOk());
+  EXPECT_THAT(reopened->Get("key"), Pointee(value));
+}
+
+TEST_F(KeyValueLogTest, OtherFilesAreRejected) {
+  ASSERT_TRUE(android::base::WriteStringToFile("{\"a\": \"AQ==\"}", path_));
+  EXPECT_FALSE(KeyValueLog::IsLogFile(path_));
+  EXPECT_THAT(KeyValueLog::Open(path_), IsError());
+}
+
+}  // namespace
+}  // namespace secure_env
+}  // namespace cuttlefish
@@ -15,65 +15,74 @@
 
 #include "cuttlefish/host/commands/secure_env/worker_thread_loop_body.h"
 
-#include "absl/log/log.h"
+#include <stdint.h>
+#include <sys/epoll.h>
 
-#include "cuttlefish/common/libs/fs/shared_select.h"
+#include <functional>
+#include <memory>
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/host/commands/secure_env/suspend_resume_handler.h"
-#include "cuttlefish/posix/strerror.h"
+#include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
 namespace secure_env_impl {
+namespace {
+
+Result<void> HandleSuspend(SharedFD snapshot_socket) {
+  // Read the suspend request.
+  SnapshotSocketMessage suspend_request;
+  CF_EXPECT_EQ(sizeof(suspend_request),
+               snapshot_socket->Read(&suspend_request, sizeof(suspend_request)),
+               "socket read failed: " << snapshot_socket->StrError());
+  CF_EXPECT_EQ(SnapshotSocketMessage::kSuspend, suspend_request);
+  // Send the ACK response.
+  const SnapshotSocketMessage ack_response = SnapshotSocketMessage::kSuspendAck;
+  CF_EXPECT_EQ(sizeof(ack_response),
+               snapshot_socket->Write(&ack_response, sizeof(ack_response)),
+               "socket write failed: " << snapshot_socket->StrError());
+  // Block until resumed.
+  SnapshotSocketMessage resume_request;
+  CF_EXPECT_EQ(sizeof(resume_request),
+               snapshot_socket->Read(&resume_request, sizeof(resume_request)),
+               "socket read failed: " << snapshot_socket->StrError());
+  CF_EXPECT_EQ(SnapshotSocketMessage::kResume, resume_request);
+  return {};
+}
+
+}  // namespace
 
 Result<void> WorkerInnerLoop(std::function<bool()> process_callback,
                              SharedFD read_fd, SharedFD snapshot_socket) {
-  for (;;) {
-    SharedFDSet readable_fds;
-    readable_fds.Set(read_fd);
-    readable_fds.Set(snapshot_socket);
+  std::unique_ptr<Reactor> reactor = CF_EXPECT(Reactor::Create());
+  bool stopping = false;
+  Result<void> result;
 
-    int num_fds = Select(&readable_fds, nullptr, nullptr, nullptr);
-    if (num_fds < 0) {
-      LOG(FATAL) << "Select() returned a negative value: " << num_fds
-                 << StrError(errno);
+  CF_EXPECT(reactor->Watch(read_fd, EPOLLIN, [&](uint32_t) {
+    // if process_callback() fails, we need to reset the secure_env
+    // component.
+    if (!stopping && !process_callback()) {
+      // NOTE: We don't need to worry about whether `snapshot_socket` is
+      // readable at this point. After the component is reset, we'll re-enter
+      // this loop and take care of it.
+      stopping = true;
+      reactor->Stop();
     }
-
-    if (readable_fds.IsSet(read_fd)) {
-      // if process_callback() fails, we need to reset the secure_env
-      // component.
-      if (!process_callback()) {
-        // NOTE: We don't need to worry about whether `snapshot_socket` is
-        // readable at this point. After the component is reset, we'll re-enter
-        // this loop and take care of it.
-        break;
-      }
-      continue;
+  }));
+  CF_EXPECT(reactor->Watch(snapshot_socket, EPOLLIN, [&](uint32_t) {
+    if (stopping) {
+      return;
     }
-
-    if (readable_fds.IsSet(snapshot_socket)) {
-      // Read the suspend request.
-      SnapshotSocketMessage suspend_request;
-      CF_EXPECT_EQ(
-          sizeof(suspend_request),
-          snapshot_socket->Read(&suspend_request, sizeof(suspend_request)),
-          "socket read failed: " << snapshot_socket->StrError());
-      CF_EXPECT_EQ(SnapshotSocketMessage::kSuspend, suspend_request);
-      // Send the ACK response.
-      const SnapshotSocketMessage ack_response =
-          SnapshotSocketMessage::kSuspendAck;
-      CF_EXPECT_EQ(sizeof(ack_response),
-                   snapshot_socket->Write(&ack_response, sizeof(ack_response)),
-                   "socket write failed: " << snapshot_socket->StrError());
-      // Block until resumed.
-      SnapshotSocketMessage resume_request;
-      CF_EXPECT_EQ(
-          sizeof(resume_request),
-          snapshot_socket->Read(&resume_request, sizeof(resume_request)),
-          "socket read failed: " << snapshot_socket->StrError());
-      CF_EXPECT_EQ(SnapshotSocketMessage::kResume, resume_request);
+    result = HandleSuspend(snapshot_socket);
+    if (!result.ok()) {
+      stopping = true;
+      reactor->Stop();
     }
-  }
+  }));
 
-  return {};
+  CF_EXPECT(reactor->Run());
+  return result;
 }
 
 }  // namespace secure_env_impl
@@ -77,14 +77,7 @@ Result<void> ProcessWebrtcRequest(transport::SharedFdChannel& channel,
       int mask;
       CF_EXPECT(static_cast<bool>(ss >> mask), kReqMisFormatted);
       auto sensors_data = sensors_simulator.GetSensorsData(mask);
-      auto size = sensors_data.size();
-      cmd = kGetSensorsData;
-      auto response =
-          CF_EXPECT(transport::CreateMessage(cmd, true, size),
-                    "Failed to allocate message for cmd: "
-                        << cmd << " with size: " << size << " bytes.");
-      memcpy(response->payload, sensors_data.data(), size);
-      CF_EXPECT(channel.SendResponse(*response),
+      CF_EXPECT(channel.SendResponse(kGetSensorsData, sensors_data),
                 "Can't send request for cmd: " << cmd);
       break;
     }
@@ -126,7 +119,8 @@ int SensorsSimulatorMain(int argc, char** argv) {
   SharedFD kernel_events_fd = SharedFD::Dup(FLAGS_kernel_events_fd);
   close(FLAGS_kernel_events_fd);
 
-  transport::SharedFdChannel channel(webrtc_fd, webrtc_fd);
+  transport::SharedFdChannel channel(webrtc_fd, webrtc_fd,
+                                     /* read_ahead */ true);
 
   auto device_type = static_cast<DeviceType>(FLAGS_device_type);
   SensorsSimulator sensors_simulator(device_type == DeviceType::Auto);
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/commands/sensors_simulator/sensors_hal_control.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+
+#include "cuttlefish/common/libs/sensors/sensors.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace sensors {
+namespace {
+
+// Used until the guest HAL asks for a sampling period.
+constexpr std::chrono::milliseconds kDefaultInterval(1000);
+constexpr std::chrono::milliseconds kMinInterval(1);
+
+}  // namespace
+
+Result<std::string> SensorIdToName(int id) {
+  switch (id) {
+    case kAccelerationId:
+      return "acceleration";
+    case kGyroscopeId:
+      return "gyroscope";
+    case kMagneticId:
+      return "magnetic";
+    case kTemperatureId:
+      return "temperature";
+    case kProximityId:
+      return "proximity";
+    case kLightId:
+      return "light";
+    case kPressureId:
+      return "pressure";
+    case kHumidityId:
+      return "humidity";
+    case kUncalibMagneticId:
+      return "magnetic-uncalibrated";
+    case kUncalibGyroscopeId:
+      return "gyroscope-uncalibrated";
+    case kHingeAngle0Id:
+      return "hinge-angle0";
+    case kUncalibAccelerationId:
+      return "acceleration-uncalibrated";
+    case kRotationVecId:
+      return "rotation";
+    case kSensorHandleLowLatencyOffBodyDetect:
+      return "low-latency-off-body-detect";
+    default:
+      return CF_ERR("Unsupported sensor id: " << id);
+  }
+}
+
+Result<int> SensorNameToId(std::string_view name) {
+  for (int id = 0; id <= kMaxSensorId; id++) {
+    Result<std::string> id_name = SensorIdToName(id);
+    if (id_name.ok() && *id_name == name) {
+      return id;
+    }
+  }
+  return CF_ERR("Unsupported sensor name: " << name);
+}
+
+/*
+  Handles the Goldfish sensor control requests
+    "set:<sensor>:<0|1>"      activates or deactivates a sensor,
+    "set-delay:<ms>"          sets the sampling period of every sensor,
+  and the Cuttlefish extensions
+    "set-delay:<sensor>:<ms>" sets the sampling period of one sensor,
+    "report-format:<batch|text>"
+                              selects kUpdateHalBatch or kUpdateHal reports.
+*/
+Result<SensorControl> ParseSensorControl(std::string_view request) {
+  std::vector<std::string_view> parts = absl::StrSplit(request, INNER_DELIM);
+  if (parts[0] == "report-format" && parts.size() == 2) {
+    CF_EXPECT(parts[1] == "batch" || parts[1] == "text",
+              "Unsupported report format: " << parts[1]);
+    return SetReportFormat{.batch = parts[1] == "batch"};
+  }
+  if (parts[0] == "set" && parts.size() == 3) {
+    int id = CF_EXPECT(SensorNameToId(parts[1]));
+    CF_EXPECT(parts[2] == "0" || parts[2] == "1",
+              "Malformed activation request: " << request);
+    return SetSensorActive{.id = id, .active = parts[2] == "1"};
+  }
+  if (parts[0] == "set-delay" && (parts.size() == 2 || parts.size() == 3)) {
+    std::optional<int> id;
+    if (parts.size() == 3) {
+      id = CF_EXPECT(SensorNameToId(parts[1]));
+    }
+    int delay_ms;
+    CF_EXPECT(absl::SimpleAtoi(parts.back(), &delay_ms) && delay_ms >= 0,
+              "Malformed delay request: " << request);
+    return SetSensorDelay{.id = id,
+                          .delay = std::chrono::milliseconds(delay_ms)};
+  }
+  return CF_ERR("Unsupported sensors HAL request: " << request);
+}
+
+ReportSchedule::ReportSchedule(Clock::time_point now) { Reset(now); }
+
+void ReportSchedule::Reset(Clock::time_point now) {
+  guest_controls_activation_ = false;
+  guest_active_sensors_ = 0;
+  std::fill(std::begin(intervals_), std::end(intervals_), kDefaultInterval);
+  std::fill(std::begin(deadlines_), std::end(deadlines_), now);
+}
+
+void ReportSchedule::SetActive(int id, bool active, Clock::time_point now) {
+  guest_controls_activation_ = true;
+  if (active) {
+    guest_active_sensors_ |= 1 << id;
+    deadlines_[id] = now;
+  } else {
+    guest_active_sensors_ &= ~(1 << id);
+  }
+}
+
+void ReportSchedule::SetDelay(std::optional<int> id,
+                              std::chrono::milliseconds delay,
+                              Clock::time_point now) {
+  Clock::duration interval = std::max<Clock::duration>(delay, kMinInterval);
+  for (int i = 0; i <= kMaxSensorId; i++) {
+    if (!id || *id == i) {
+      intervals_[i] = interval;
+      // Don't keep waiting out a longer period that was just replaced.
+      deadlines_[i] = std::min(deadlines_[i], now + interval);
+    }
+  }
+}
+
+SensorsMask ReportSchedule::Active(SensorsMask sensors) const {
+  return guest_controls_activation_ ? sensors & guest_active_sensors_
+                                    : sensors;
+}
+
+SensorsMask ReportSchedule::TakeDue(
+    SensorsMask active, Clock::time_point now,
+    std::optional<Clock::time_point>& next_deadline) {
+  SensorsMask due = 0;
+  next_deadline.reset();
+  for (int id = 0; id <= kMaxSensorId; id++) {
+    if (!(active & (1 << id))) {
+      continue;
+    }
+    if (deadlines_[id] <= now) {
+      due |= 1 << id;
+      deadlines_[id] += intervals_[id];
+      // Skip the samples missed while falling behind instead of bursting.
+      if (deadlines_[id] <= now) {
+        deadlines_[id] = now + intervals_[id];
+      }
+    }
+    if (!next_deadline || deadlines_[id] < *next_deadline) {
+      next_deadline = deadlines_[id];
+    }
+  }
+  return due;
+}
+
+}  // namespace sensors
+}  // namespace cuttlefish
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "cuttlefish/common/libs/sensors/sensors.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace sensors {
+
+// The names the Goldfish sensors HAL uses for the sensors.
+Result<std::string> SensorIdToName(int id);
+Result<int> SensorNameToId(std::string_view name);
+
+// "set:<sensor>:<0|1>"
+struct SetSensorActive {
+  int id;
+  bool active;
+};
+
+// "set-delay:<ms>" and "set-delay:<sensor>:<ms>", `id` is unset for the
+// former which applies to every sensor.
+struct SetSensorDelay {
+  std::optional<int> id;
+  std::chrono::milliseconds delay;
+};
+
+// "report-format:<batch|text>"
+struct SetReportFormat {
+  bool batch;
+};
+
+using SensorControl =
+    std::variant<SetSensorActive, SetSensorDelay, SetReportFormat>;
+
+Result<SensorControl> ParseSensorControl(std::string_view request);
+
+/*
+ * When each continuous mode sensor is next due to be reported to the guest.
+ *
+ * Not thread safe.
+ */
+class ReportSchedule {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit ReportSchedule(Clock::time_point now);
+
+  // Forgets everything the guest asked for.
+  void Reset(Clock::time_point now);
+  void SetActive(int id, bool active, Clock::time_point now);
+  void SetDelay(std::optional<int> id, std::chrono::milliseconds delay,
+                Clock::time_point now);
+
+  // Which of `sensors` the guest activated. Guests that never send
+  // "set:<sensor>:<0|1>" get all of them.
+  SensorsMask Active(SensorsMask sensors) const;
+  // Returns which of `active` are due at `now` and moves their deadlines past
+  // it. Sets `next_deadline` to the earliest deadline of `active`, or unsets
+  // it if there is none.
+  SensorsMask TakeDue(SensorsMask active, Clock::time_point now,
+                      std::optional<Clock::time_point>& next_deadline);
+
+ private:
+  bool guest_controls_activation_ = false;
+  SensorsMask guest_active_sensors_ = 0;
+  Clock::duration intervals_[kMaxSensorId + 1];
+  Clock::time_point deadlines_[kMaxSensorId + 1];
+};
+
+}  // namespace sensors
+}  // namespace cuttlefish
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/commands/sensors_simulator/sensors_hal_control.h"
+
+#include <chrono>
+#include <optional>
+#include <variant>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/sensors/sensors.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace sensors {
+namespace {
+
+using std::chrono::milliseconds;
+using testing::Optional;
+using Clock = ReportSchedule::Clock;
+
+constexpr SensorsMask Mask(int id) { return 1 << id; }
+
+TEST(SensorNameToIdTest, RoundTripsEverySensorName) {
+  for (int id = 0; id <= kMaxSensorId; id++) {
+    Result<std::string> name = SensorIdToName(id);
+    if (!name.ok()) {
+      continue;
+    }
+    EXPECT_THAT(SensorNameToId(*name), IsOkAndValue(id)) << *name;
+  }
+  EXPECT_THAT(SensorNameToId("acceleration"), IsOkAndValue(kAccelerationId));
+  EXPECT_THAT(SensorNameToId("hinge-angle0"), IsOkAndValue(kHingeAngle0Id));
+}
+
+TEST(SensorNameToIdTest, RejectsUnknownNames) {
+  EXPECT_THAT(SensorNameToId("barometer"), IsError());
+  EXPECT_THAT(SensorNameToId(""), IsError());
+}
+
+TEST(ParseSensorControlTest, SetActive) {
+  Result<SensorControl> control = ParseSensorControl("set:gyroscope:1");
+  ASSERT_THAT(control, IsOk());
+  const auto* set = std::get_if<SetSensorActive>(&*control);
+  ASSERT_NE(set, nullptr);
+  EXPECT_EQ(set->id, kGyroscopeId);
+  EXPECT_TRUE(set->active);
+
+  control = ParseSensorControl("set:magnetic:0");
+  ASSERT_THAT(control, IsOk());
+  set = std::get_if<SetSensorActive>(&*control);
+  ASSERT_NE(set, nullptr);
+  EXPECT_EQ(set->id, kMagneticId);
+  EXPECT_FALSE(set->active);
+}
+
+TEST(ParseSensorControlTest, SetDelay) {
+  Result<SensorControl> control = ParseSensorControl("set-delay:200");
+  ASSERT_THAT(control, IsOk());
+  const auto* delay = std::get_if<SetSensorDelay>(&*control);
+  ASSERT_NE(delay, nullptr);
+  EXPECT_EQ(delay->id, std::nullopt);
+  EXPECT_EQ(delay->delay, milliseconds(200));
+
+  control = ParseSensorControl("set-delay:light:5");
+  ASSERT_THAT(control, IsOk());
+  delay = std::get_if<SetSensorDelay>(&*control);
+  ASSERT_NE(delay, nullptr);
+  EXPECT_THAT(delay->id, Optional(kLightId));
+  EXPECT_EQ(delay->delay, milliseconds(5));
+}
+
+TEST(ParseSensorControlTest, ReportFormat) {
+  Result<SensorControl> control = ParseSensorControl("report-format:batch");
+  ASSERT_THAT(control, IsOk());
+  const auto* format = std::get_if<SetReportFormat>(&*control);
+  ASSERT_NE(format, nullptr);
+  EXPECT_TRUE(format->batch);
+
+  control = ParseSensorControl("report-format:text");
+  ASSERT_THAT(control, IsOk());
+  format = std::get_if<SetReportFormat>(&*control);
+  ASSERT_NE(format, nullptr);
+  EXPECT_FALSE(format->batch);
+}
+
+TEST(ParseSensorControlTest, RejectsMalformedRequests) {
+  EXPECT_THAT(ParseSensorControl("set:gyroscope:2"), IsError());
+  EXPECT_THAT(ParseSensorControl("set:barometer:1"), IsError());
+  EXPECT_THAT(ParseSensorControl("set:gyroscope"), IsError());
+  EXPECT_THAT(ParseSensorControl("set-delay:-1"), IsError());
+  EXPECT_THAT(ParseSensorControl("set-delay:soon"), IsError());
+  EXPECT_THAT(ParseSensorControl("set-delay:barometer:10"), IsError());
+  EXPECT_THAT(ParseSensorControl("report-format:json"), IsError());
+  EXPECT_THAT(ParseSensorControl("list-sensors"), IsError());
+  EXPECT_THAT(ParseSensorControl(""), IsError());
+}
+
+TEST(ReportScheduleTest, EverySensorIsActiveUntilTheGuestSelectsSome) {
+  const SensorsMask sensors = Mask(kAccelerationId) | Mask(kGyroscopeId);
+  ReportSchedule schedule(Clock::now());
+  EXPECT_EQ(schedule.Active(sensors), sensors);
+
+  schedule.SetActive(kGyroscopeId, true, Clock::now());
+  EXPECT_EQ(schedule.Active(sensors), Mask(kGyroscopeId));
+  schedule.SetActive(kGyroscopeId, false, Clock::now());
+  EXPECT_EQ(schedule.Active(sensors), 0);
+
+  schedule.Reset(Clock::now());
+  EXPECT_EQ(schedule.Active(sensors), sensors);
+}
+
+TEST(ReportScheduleTest, ReportsEachSensorAtItsInterval) {
+  const Clock::time_point start = Clock::now();
+  const SensorsMask active = Mask(kAccelerationId) | Mask(kGyroscopeId);
+  ReportSchedule schedule(start);
+  schedule.SetDelay(kAccelerationId, milliseconds(10), start);
+  schedule.SetDelay(kGyroscopeId, milliseconds(25), start);
+
+  std::optional<Clock::time_point> next;
+  EXPECT_EQ(schedule.TakeDue(active, start, next), active);
+  EXPECT_EQ(next, start + milliseconds(10));
+
+  EXPECT_EQ(schedule.TakeDue(active, start + milliseconds(5), next), 0);
+  EXPECT_EQ(next, start + milliseconds(10));
+
+  EXPECT_EQ(schedule.TakeDue(active, start + milliseconds(10), next),
+            Mask(kAccelerationId));
+  EXPECT_EQ(next, start + milliseconds(20));
+
+  EXPECT_EQ(schedule.TakeDue(active, start + milliseconds(20), next),
+            Mask(kAccelerationId));
+  EXPECT_EQ(next, start + milliseconds(25));
+
+  EXPECT_EQ(schedule.TakeDue(active, start + milliseconds(25), next),
+            Mask(kGyroscopeId));
+  EXPECT_EQ(schedule.TakeDue(active, start + milliseconds(30), next),
+            Mask(kAccelerationId));
+  EXPECT_EQ(schedule.TakeDue(active, start + milliseconds(40), next),
+            Mask(kAccelerationId));
+  // Both are due together, so they go out in one report.
+  EXPECT_EQ(schedule.TakeDue(active, start + milliseconds(50), next), active);
+}
+
+TEST(ReportScheduleTest, SkipsMissedSamplesInsteadOfBursting) {
+  const Clock::time_point start = Clock::now();
+  const SensorsMask active = Mask(kLightId);
+  ReportSchedule schedule(start);
+  schedule.SetDelay(std::nullopt, milliseconds(10), start);
+
+  std::optional<Clock::time_point> next;
+  EXPECT_EQ(schedule.TakeDue(active, start, next), active);
+  // Fell behind by several intervals, only one report is due.
+  EXPECT_EQ(schedule.TakeDue(active, start + milliseconds(55), next), active);
+  EXPECT_EQ(next, start + milliseconds(65));
+  EXPECT_EQ(schedule.TakeDue(active, start + milliseconds(56), next), 0);
+}
+
+TEST(ReportScheduleTest, ShorterDelayTakesEffectImmediately) {
+  const Clock::time_point start = Clock::now();
+  const SensorsMask active = Mask(kPressureId);
+  ReportSchedule schedule(start);
+
+  std::optional<Clock::time_point> next;
+  EXPECT_EQ(schedule.TakeDue(active, start, next), active);
+  EXPECT_EQ(next, start + milliseconds(1000));
+
+  schedule.SetDelay(kPressureId, milliseconds(20), start + milliseconds(5));
+  EXPECT_EQ(schedule.TakeDue(active, start + milliseconds(5), next), 0);
+  EXPECT_EQ(next, start + milliseconds(25));
+}
+
+TEST(ReportScheduleTest, ActivatedSensorIsDueRightAway) {
+  const Clock::time_point start = Clock::now();
+  ReportSchedule schedule(start);
+  std::optional<Clock::time_point> next;
+  schedule.TakeDue(Mask(kMagneticId), start, next);
+
+  schedule.SetActive(kMagneticId, true, start + milliseconds(100));
+  EXPECT_EQ(schedule.TakeDue(Mask(kMagneticId), start + milliseconds(100),
+                             next),
+            Mask(kMagneticId));
+}
+
+TEST(ReportScheduleTest, NothingActiveHasNoDeadline) {
+  ReportSchedule schedule(Clock::now());
+  std::optional<Clock::time_point> next = Clock::now();
+  EXPECT_EQ(schedule.TakeDue(0, Clock::now(), next), 0);
+  EXPECT_EQ(next, std::nullopt);
+}
+
+}  // namespace
+}  // namespace sensors
+}  // namespace cuttlefish
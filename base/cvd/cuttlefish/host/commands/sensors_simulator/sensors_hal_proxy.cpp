@@ -16,19 +16,27 @@
 
 #include "cuttlefish/host/commands/sensors_simulator/sensors_hal_proxy.h"
 
+#include <string.h>
+
+#include <chrono>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <variant>
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "fmt/format.h"
+
+#include "cuttlefish/host/commands/sensors_simulator/sensors_hal_control.h"
 
 namespace cuttlefish {
 namespace sensors {
 
 namespace {
 static constexpr char END_OF_MSG = '\n';
-static constexpr uint32_t kIntervalMs = 1000;
-
+static constexpr std::string_view kEndOfRequest("\n\0", 2);
 /*
   Aligned with Goldfish sensor flags defined in
   `device/generic/goldfish/hals/sensors/sensor_list.cpp`.
@@ -45,89 +53,10 @@ static constexpr SensorsMask kContinuousModeSensors =
 */
 static constexpr SensorsMask kOnChangeSensors = (1 << kHingeAngle0Id);
 
-Result<std::string> SensorIdToName(int id) {
-  switch (id) {
-    case kAccelerationId:
-      return "acceleration";
-    case kGyroscopeId:
-      return "gyroscope";
-    case kMagneticId:
-      return "magnetic";
-    case kTemperatureId:
-      return "temperature";
-    case kProximityId:
-      return "proximity";
-    case kLightId:
-      return "light";
-    case kPressureId:
-      return "pressure";
-    case kHumidityId:
-      return "humidity";
-    case kUncalibMagneticId:
-      return "magnetic-uncalibrated";
-    case kUncalibGyroscopeId:
-      return "gyroscope-uncalibrated";
-    case kHingeAngle0Id:
-      return "hinge-angle0";
-    case kUncalibAccelerationId:
-      return "acceleration-uncalibrated";
-    case kRotationVecId:
-      return "rotation";
-    case kSensorHandleLowLatencyOffBodyDetect:
-      return "low-latency-off-body-detect";
-    default:
-      return CF_ERR("Unsupported sensor id: " << id);
-  }
-}
-
 Result<void> SendResponseHelper(transport::SharedFdChannel& channel,
                                 const std::string& msg) {
-  size_t size = msg.size();
-  int cmd = sensors::kUpdateHal;
-  transport::ManagedMessage response = CF_EXPECT(
-      transport::CreateMessage(cmd, msg.size()), "Failed to allocate message.");
-  std::memcpy(response->payload, msg.data(), size);
-  CF_EXPECT(channel.SendResponse(*response), "Can't update sensor HAL.");
-  return {};
-}
-
-Result<void> ProcessHalRequest(transport::SharedFdChannel& channel,
-                               std::atomic<bool>& hal_activated,
-                               uint32_t mask) {
-  transport::ManagedMessage request =
-      CF_EXPECT(channel.ReceiveMessage(), "Couldn't receive message.");
-  std::string payload(reinterpret_cast<const char*>(request->payload),
-                      request->payload_size);
-  if (payload.rfind("list-sensors", 0) == 0) {
-    std::string msg = std::to_string(mask) + END_OF_MSG;
-    CF_EXPECT(SendResponseHelper(channel, msg));
-    hal_activated = true;
-  }
-  return {};
-}
-
-Result<void> UpdateSensorsHal(const std::string& sensors_data,
-                              transport::SharedFdChannel& channel,
-                              uint32_t mask) {
-  std::vector<std::string> reports;
-  std::string report;
-  std::stringstream sensors_data_stream(sensors_data);
-  int id = 0;
-
-  while (mask) {
-    if (mask & 1) {
-      CF_EXPECT(static_cast<bool>(sensors_data_stream >> report));
-      Result<std::string> result = SensorIdToName(id);
-      if (result.ok()) {
-        reports.push_back(result.value() + INNER_DELIM + report + END_OF_MSG);
-      }
-    }
-    id += 1;
-    mask >>= 1;
-  }
-  for (const auto& r : reports) {
-    CF_EXPECT(SendResponseHelper(channel, r));
-  }
+  CF_EXPECT(channel.SendResponse(sensors::kUpdateHal, msg),
+            "Can't update sensor HAL.");
   return {};
 }
 
@@ -166,11 +95,13 @@ SensorsHalProxy::SensorsHalProxy(SharedFD control_from_guest_fd,
                                  SensorsSimulator& sensors_simulator,
                                  DeviceType device_type)
     : control_channel_(std::move(control_from_guest_fd),
-                       std::move(control_to_guest_fd)),
+                       std::move(control_to_guest_fd), /* read_ahead */ true),
       data_channel_(std::move(data_from_guest_fd), std::move(data_to_guest_fd)),
       kernel_events_fd_(std::move(kernel_events_fd)),
-      sensors_simulator_(sensors_simulator) {
+      sensors_simulator_(sensors_simulator),
+      schedule_(Clock::now()) {
   const SensorsMask host_enabled_sensors = HostEnabledSensors(device_type);
+  ResetGuestState();
 
   sensors_simulator_.SetSensorsChangedCallback(
       host_enabled_sensors & kOnChangeSensors,
@@ -178,19 +109,15 @@ SensorsHalProxy::SensorsHalProxy(SharedFD control_from_guest_fd,
 
   req_responder_thread_ = std::thread([this, host_enabled_sensors] {
     while (running_) {
-      auto result = ProcessHalRequest(control_channel_, hal_activated_,
-                                      host_enabled_sensors);
+      auto result = ProcessHalRequest(host_enabled_sensors);
       if (!result.ok()) {
-        running_ = false;
+        Stop();
         LOG(ERROR) << result.error();
       }
     }
   });
   data_reporter_thread_ = std::thread([this, host_enabled_sensors] {
-    while (running_) {
-      ReportToGuest(host_enabled_sensors & kContinuousModeSensors);
-      std::this_thread::sleep_for(std::chrono::milliseconds(kIntervalMs));
-    }
+    ReportContinuousSensors(host_enabled_sensors & kContinuousModeSensors);
   });
   reboot_monitor_thread_ = std::thread([this] {
     while (kernel_events_fd_->IsOpen()) {
@@ -200,23 +127,139 @@ SensorsHalProxy::SensorsHalProxy(SharedFD control_from_guest_fd,
       CHECK(read_result->has_value()) << "EOF in kernel log monitor";
       if ((*read_result)->event == monitor::Event::BootloaderLoaded) {
         hal_activated_ = false;
+        ResetGuestState();
       }
     }
   });
 }
 
+Result<void> SensorsHalProxy::ProcessHalRequest(
+    SensorsMask host_enabled_sensors) {
+  transport::ManagedMessage request = CF_EXPECT(
+      control_channel_.ReceiveMessage(), "Couldn't receive message.");
+  std::string_view payload(reinterpret_cast<const char*>(request->payload),
+                           request->payload_size);
+  payload = payload.substr(0, payload.find_first_of(kEndOfRequest));
+  if (payload.rfind("list-sensors", 0) == 0) {
+    std::string msg = std::to_string(host_enabled_sensors) + END_OF_MSG;
+    CF_EXPECT(SendResponseHelper(control_channel_, msg));
+    {
+      std::lock_guard<std::mutex> lock(schedule_mtx_);
+      hal_activated_ = true;
+    }
+    schedule_cv_.notify_one();
+    return {};
+  }
+  Result<void> result = ProcessSensorControl(payload);
+  if (!result.ok()) {
+    // A request the host doesn't understand only affects that request.
+    LOG(WARNING) << result.error().Message();
+  }
+  return {};
+}
+
+Result<void> SensorsHalProxy::ProcessSensorControl(std::string_view request) {
+  SensorControl control = CF_EXPECT(ParseSensorControl(request));
+  if (const auto* format = std::get_if<SetReportFormat>(&control)) {
+    std::lock_guard<std::mutex> lock(report_mtx_);
+    batch_reports_ = format->batch;
+    return {};
+  }
+  {
+    std::lock_guard<std::mutex> lock(schedule_mtx_);
+    if (const auto* set = std::get_if<SetSensorActive>(&control)) {
+      schedule_.SetActive(set->id, set->active, Clock::now());
+    } else if (const auto* set = std::get_if<SetSensorDelay>(&control)) {
+      schedule_.SetDelay(set->id, set->delay, Clock::now());
+    }
+  }
+  schedule_cv_.notify_one();
+  return {};
+}
+
+void SensorsHalProxy::ReportContinuousSensors(SensorsMask continuous_sensors) {
+  std::unique_lock<std::mutex> lock(schedule_mtx_);
+  while (running_) {
+    SensorsMask active =
+        hal_activated_ ? schedule_.Active(continuous_sensors) : 0;
+    std::optional<Clock::time_point> next_deadline;
+    SensorsMask due = schedule_.TakeDue(active, Clock::now(), next_deadline);
+    if (due) {
+      lock.unlock();
+      ReportToGuest(due);
+      lock.lock();
+    } else if (next_deadline) {
+      schedule_cv_.wait_until(lock, *next_deadline);
+    } else {
+      schedule_cv_.wait(lock);
+    }
+  }
+}
+
+void SensorsHalProxy::ResetGuestState() {
+  {
+    std::lock_guard<std::mutex> lock(schedule_mtx_);
+    schedule_.Reset(Clock::now());
+  }
+  schedule_cv_.notify_one();
+  std::lock_guard<std::mutex> lock(report_mtx_);
+  batch_reports_ = false;
+}
+
+void SensorsHalProxy::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(schedule_mtx_);
+    running_ = false;
+  }
+  schedule_cv_.notify_all();
+}
+
 void SensorsHalProxy::ReportToGuest(SensorsMask mask) {
   if (!hal_activated_ || !mask) {
     return;
   }
-  std::string sensors_data = sensors_simulator_.GetSensorsData(mask);
   std::lock_guard<std::mutex> lock(report_mtx_);
-  Result<void> result = UpdateSensorsHal(sensors_data, data_channel_, mask);
+  sensors_simulator_.GetSensorReports(mask, reports_);
+  Result<void> result = batch_reports_ ? SendBatch() : SendTextReports();
   if (!result.ok()) {
-    running_ = false;
+    Stop();
     LOG(ERROR) << result.error();
   }
 }
 
+Result<void> SensorsHalProxy::SendBatch() {
+  SensorsBatchHeader header = {};
+  header.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            Clock::now().time_since_epoch())
+                            .count();
+  header.count = reports_.size();
+  payload_.resize(sizeof(header) + reports_.size() * sizeof(SensorReport));
+  memcpy(payload_.data(), &header, sizeof(header));
+  memcpy(payload_.data() + sizeof(header), reports_.data(),
+         reports_.size() * sizeof(SensorReport));
+  CF_EXPECT(data_channel_.SendResponse(kUpdateHalBatch, payload_),
+            "Can't update sensor HAL.");
+  return {};
+}
+
+Result<void> SensorsHalProxy::SendTextReports() {
+  for (const SensorReport& report : reports_) {
+    Result<std::string> name = SensorIdToName(report.id);
+    if (!name.ok()) {
+      continue;
+    }
+    if (IsScalarSensor(report.id)) {
+      payload_ = fmt::format("{}{}{:g}{}", *name, INNER_DELIM,
+                             report.values[0], END_OF_MSG);
+    } else {
+      payload_ = fmt::format("{0}{1}{2:g}{1}{3:g}{1}{4:g}{5}", *name,
+                             INNER_DELIM, report.values[0], report.values[1],
+                             report.values[2], END_OF_MSG);
+    }
+    CF_EXPECT(SendResponseHelper(data_channel_, payload_));
+  }
+  return {};
+}
+
 }  // namespace sensors
 }  // namespace cuttlefish
@@ -17,14 +17,20 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 #include "cuttlefish/common/libs/sensors/sensors.h"
 #include "cuttlefish/common/libs/transport/channel_sharedfd.h"
 #include "cuttlefish/common/libs/utils/device_type.h"
 #include "cuttlefish/host/commands/kernel_log_monitor/kernel_log_server.h"
 #include "cuttlefish/host/commands/kernel_log_monitor/utils.h"
+#include "cuttlefish/host/commands/sensors_simulator/sensors_hal_control.h"
 #include "cuttlefish/host/commands/sensors_simulator/sensors_simulator.h"
 
 namespace cuttlefish {
@@ -38,7 +44,20 @@ class SensorsHalProxy {
                   SensorsSimulator& sensors_simulator, DeviceType device_type);
 
  private:
+  using Clock = ReportSchedule::Clock;
+
+  Result<void> ProcessHalRequest(SensorsMask host_enabled_sensors);
+  Result<void> ProcessSensorControl(std::string_view request);
+  // Reports each active continuous mode sensor at the interval the guest asked
+  // for, batching the sensors that are due together. Sleeps while no sensor
+  // is active.
+  void ReportContinuousSensors(SensorsMask continuous_sensors);
+  void ResetGuestState();
+  // Makes the request and report loops return.
+  void Stop();
   void ReportToGuest(SensorsMask mask);
+  Result<void> SendBatch();
+  Result<void> SendTextReports();
 
   std::thread req_responder_thread_;
   std::thread data_reporter_thread_;
@@ -49,7 +68,18 @@ class SensorsHalProxy {
   SensorsSimulator& sensors_simulator_;
   std::atomic<bool> hal_activated_ = false;
   std::atomic<bool> running_ = true;
+
+  // Guarded by schedule_mtx_, which the reporter thread waits on. So is
+  // setting running_ to false.
+  std::mutex schedule_mtx_;
+  std::condition_variable schedule_cv_;
+  ReportSchedule schedule_;
+
+  // Guarded by report_mtx_.
   std::mutex report_mtx_;
+  bool batch_reports_ = false;
+  std::vector<SensorReport> reports_;
+  std::string payload_;
 };
 
 }  // namespace sensors
@@ -18,6 +18,7 @@
 
 #include <cmath>
 #include <utility>
+#include <vector>
 
 namespace cuttlefish {
 namespace sensors {
@@ -33,12 +34,6 @@ constexpr double kG = 9.80665;          // meter per second^2
 const Eigen::Vector3d kMagneticField{0, 5.9, -48.4};
 inline double ToRadians(double x) { return x * M_PI / 180; }
 
-// Check if a given sensor id provides scalar data
-static bool IsScalarSensor(int id) {
-  return (id == kTemperatureId) || (id == kProximityId) || (id == kLightId) ||
-         (id == kPressureId) || (id == kHumidityId) || (id == kHingeAngle0Id);
-}
-
 // Calculate the rotation matrix of the pitch, roll, and yaw angles.
 static Eigen::Matrix3d GetRotationMatrix(double x, double y, double z) {
   x = ToRadians(-x);
@@ -182,5 +177,26 @@ std::string SensorsSimulator::GetSensorsData(const SensorsMask mask) {
   return sensors_msg.str();
 }
 
+void SensorsSimulator::GetSensorReports(const SensorsMask mask,
+                                        std::vector<SensorReport>& reports) {
+  reports.clear();
+  std::lock_guard<std::mutex> lock(sensors_data_mtx_);
+  for (int id = 0; id <= kMaxSensorId; id++) {
+    if (mask & (1 << id)) {
+      SensorReport& report = reports.emplace_back();
+      report.id = id;
+      if (IsScalarSensor(id)) {
+        report.values[0] = sensors_data_[id].f;
+        report.values[1] = report.values[2] = 0;
+      } else {
+        const Eigen::Vector3d& v = sensors_data_[id].v;
+        report.values[0] = v(0);
+        report.values[1] = v(1);
+        report.values[2] = v(2);
+      }
+    }
+  }
+}
+
 }  // namespace sensors
 }  // namespace cuttlefish
@@ -20,6 +20,7 @@
 #include <functional>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "Eigen/Dense"
 
@@ -56,6 +57,12 @@ class SensorsSimulator {
   // formatted as "<acc.x>:<acc.y>:<acc.z> <gyro.x>:<gyro.y>:<gyro.z>".
   std::string GetSensorsData(const SensorsMask mask);
 
+  // Same as GetSensorsData, but fills |reports| with the raw values so that
+  // high rate callers don't pay for text formatting. |reports| is cleared
+  // first and its capacity reused.
+  void GetSensorReports(const SensorsMask mask,
+                        std::vector<SensorReport>& reports);
+
  private:
   void NotifySensorsChanged(SensorsMask changed);
 
@@ -30,6 +30,7 @@
 #include "cuttlefish/common/libs/utils/tee_logging.h"
 #include "cuttlefish/flag_parser/flag.h"
 #include "cuttlefish/flag_parser/gflags_compat.h"
+#include "cuttlefish/host/libs/cgroup/instance_cgroup.h"
 #include "cuttlefish/host/libs/command_util/runner/defs.h"
 #include "cuttlefish/host/libs/command_util/util.h"
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
@@ -85,6 +86,22 @@ std::string CalcWebAccessUrl(const WebAccessUrlParam& web_access_url_param) {
          web_access_url_param.webrtc_device_id + "/files" + "/client.html";
 }
 
+Json::Value CgroupInfo(const std::string& path) {
+  Json::Value cgroup;
+  cgroup["path"] = path;
+  Result<CgroupUsage> usage = ReadCgroupUsage(path);
+  if (!usage.ok()) {
+    LOG(WARNING) << "Failed to read the instance's resource usage: "
+                 << usage.error();
+    return cgroup;
+  }
+  cgroup["cpu_usage_usec"] = Json::UInt64(usage->cpu_usage_usec);
+  cgroup["memory_current_bytes"] = Json::UInt64(usage->memory_current_bytes);
+  cgroup["io_read_bytes"] = Json::UInt64(usage->io_read_bytes);
+  cgroup["io_write_bytes"] = Json::UInt64(usage->io_write_bytes);
+  return cgroup;
+}
+
 Json::Value PopulateDevicesInfoFromInstance(
     const CuttlefishConfig& config,
     const CuttlefishConfig::InstanceSpecific& instance_config) {
@@ -108,6 +125,9 @@ Json::Value PopulateDevicesInfoFromInstance(
         std::to_string(instance_config.display_configs()[i].dpi) + " )";
   }
   device_info["status"] = "Running";
+  if (!instance_config.cgroup_path().empty()) {
+    device_info["cgroup"] = CgroupInfo(instance_config.cgroup_path());
+  }
   return device_info;
 }
 
@@ -14,19 +14,24 @@
  * limitations under the License.
  */
 
+#include <stdint.h>
+#include <sys/epoll.h>
+
 #include <chrono>
 #include <fstream>
+#include <memory>
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "fmt/format.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
-#include "cuttlefish/common/libs/fs/shared_select.h"
 #include "cuttlefish/flag_parser/flag.h"
 #include "cuttlefish/flag_parser/gflags_compat.h"
 #include "cuttlefish/flag_parser/shared_fd_flag.h"
 #include "cuttlefish/host/libs/config/logging.h"
+#include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
 
@@ -53,6 +58,85 @@ static std::string next_tombstone_path(const std::string& dir) {
 static constexpr size_t CHUNK_RECV_MAX_LEN = 1024;
 static constexpr size_t TIMEOUT_SEC = 3;
 
+// A tombstone being received. It is complete once the guest closes the
+// connection or stops sending for TIMEOUT_SEC.
+struct IncomingTombstone {
+  SharedFD conn;
+  std::ofstream file;
+  size_t acc = 0;
+  size_t cnt = 0;
+  Reactor::TimerId timeout = 0;
+};
+
+static void FinishTombstone(Reactor& reactor, IncomingTombstone& tombstone) {
+  reactor.Cancel(tombstone.timeout);
+  Result<void> unwatched = reactor.Unwatch(tombstone.conn);
+  if (!unwatched.ok()) {
+    LOG(ERROR) << unwatched.error();
+  }
+  tombstone.conn->Close();
+  tombstone.file.close();
+  VLOG(0) << "done: " << tombstone.acc << " bytes via " << tombstone.cnt;
+}
+
+static void RestartTimeout(Reactor& reactor,
+                           std::shared_ptr<IncomingTombstone> tombstone) {
+  reactor.Cancel(tombstone->timeout);
+  tombstone->timeout = reactor.ScheduleAfter(
+      std::chrono::seconds(TIMEOUT_SEC), [&reactor, tombstone]() {
+        VLOG(0) << "timeout";
+        FinishTombstone(reactor, *tombstone);
+      });
+}
+
+static void ReadTombstoneChunk(Reactor& reactor, IncomingTombstone& tombstone,
+                               uint32_t events) {
+  if (!(events & EPOLLIN)) {
+    VLOG(0) << "error";
+    FinishTombstone(reactor, tombstone);
+    return;
+  }
+  char buff[CHUNK_RECV_MAX_LEN];
+  auto bytes_read = tombstone.conn->Recv(buff, sizeof(buff), 0);
+  if (bytes_read <= 0) {
+    FinishTombstone(reactor, tombstone);
+    return;
+  }
+  tombstone.acc += bytes_read;
+  tombstone.file.write(buff, bytes_read);
+  tombstone.cnt++;
+}
+
+static void AcceptTombstone(Reactor& reactor, SharedFD server_fd,
+                            const std::string& tombstone_dir) {
+  auto tombstone = std::make_shared<IncomingTombstone>();
+  tombstone->conn = SharedFD::Accept(*server_fd);
+  if (!tombstone->conn->IsOpen()) {
+    LOG(ERROR) << "Failed to accept connection: "
+               << tombstone->conn->StrError();
+    return;
+  }
+  tombstone->file.open(next_tombstone_path(tombstone_dir),
+                       std::ofstream::out | std::ofstream::binary);
+  if (!tombstone->file.is_open()) {
+    LOG(ERROR) << "Failed to open tombstone file";
+    return;
+  }
+
+  Result<void> watched = reactor.Watch(
+      tombstone->conn, EPOLLIN, [&reactor, tombstone](uint32_t events) {
+        ReadTombstoneChunk(reactor, *tombstone, events);
+        if (tombstone->conn->IsOpen()) {
+          RestartTimeout(reactor, tombstone);
+        }
+      });
+  if (!watched.ok()) {
+    LOG(ERROR) << watched.error();
+    return;
+  }
+  RestartTimeout(reactor, tombstone);
+}
+
 int TombstoneReceiverMain(int argc, char** argv) {
   DefaultSubprocessLogging(argv);
 
@@ -79,46 +163,18 @@ int TombstoneReceiverMain(int argc, char** argv) {
 
   VLOG(0) << "Host is starting server on port " << server_fd->VsockServerPort();
 
-  // Server loop
-  while (true) {
-    auto conn = SharedFD::Accept(*server_fd);
-    std::ofstream file(next_tombstone_path(tombstone_dir),
-                       std::ofstream::out | std::ofstream::binary);
-    auto acc = 0;
-    auto cnt = 0;
-
-    SharedFDSet read_set;
-    read_set.Set(conn);
-
-    SharedFDSet error_set;
-    error_set.Set(conn);
-    while (file.is_open()) {
-      struct timeval timeout = {TIMEOUT_SEC, 0};
-      auto val = Select(&read_set, nullptr, &error_set, &timeout);
-      if (val == 0) {
-        VLOG(0) << "timeout";
-        break;
-      }
-      if (read_set.IsSet(conn)) {
-        char buff[CHUNK_RECV_MAX_LEN];
-        auto bytes_read = conn->Recv(buff, sizeof(buff), 0);
-        acc += bytes_read;
-        if (bytes_read <= 0) {
-          // reset the other side if it's still connected
-          break;
-        } else {
-          file.write(buff, bytes_read);
-          cnt++;
-        }
-      }
-
-      if (error_set.IsSet(conn)) {
-        VLOG(0) << "error";
-        break;
-      }
-    }
-    VLOG(0) << "done: " << acc << " bytes via " << cnt;
-  }
+  Result<std::unique_ptr<Reactor>> reactor = Reactor::Create();
+  CHECK(reactor.ok()) << reactor.error();
+
+  // Tombstones from several crashing processes can arrive concurrently.
+  Result<void> watched = (*reactor)->Watch(
+      server_fd, EPOLLIN, [&reactor, server_fd, &tombstone_dir](uint32_t) {
+        AcceptTombstone(**reactor, server_fd, tombstone_dir);
+      });
+  CHECK(watched.ok()) << watched.error();
+
+  Result<void> run = (*reactor)->Run();
+  CHECK(run.ok()) << run.error();
 
   return 0;
 }
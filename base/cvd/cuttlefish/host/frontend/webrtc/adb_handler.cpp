@@ -21,12 +21,16 @@
 #include <unistd.h>
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/log/log.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
-#include "cuttlefish/common/libs/fs/shared_select.h"
+#include "cuttlefish/host/frontend/webrtc/byte_stream_forwarder.h"
+#include "cuttlefish/result/result.h"
 
 using namespace android;
 
@@ -63,51 +67,25 @@ SharedFD SetupAdbSocket(const std::string &adb_host_and_port) {
 }  // namespace
 
 AdbHandler::AdbHandler(
-    const std::string &adb_host_and_port,
-    std::function<void(const uint8_t *, size_t)> send_to_client)
-    : send_to_client_(send_to_client),
-      adb_socket_(SetupAdbSocket(adb_host_and_port)),
-      shutdown_(SharedFD::Event(0,0))
-{
-    std::thread loop([this]() { ReadLoop(); });
-    read_thread_.swap(loop);
+    const std::string &adb_host_and_port, Reactor &reactor,
+    ByteStreamForwarder::Sender send_to_client,
+    ByteStreamForwarder::BufferedAmount client_buffered_amount)
+    : adb_socket_(SetupAdbSocket(adb_host_and_port)) {
+  Result<std::unique_ptr<ByteStreamForwarder>> forwarder =
+      ByteStreamForwarder::Create("adb", reactor, adb_socket_,
+                                  std::move(send_to_client),
+                                  std::move(client_buffered_amount));
+  if (forwarder.ok()) {
+    forwarder_ = std::move(*forwarder);
+  } else {
+    LOG(ERROR) << "Not forwarding data from adb: " << forwarder.error();
+  }
 }
 
-
 AdbHandler::~AdbHandler() {
-    // Send a message to the looper to shut down.
-    uint64_t v = 1;
-    shutdown_->Write(&v, sizeof(v));
-    // Shut down the socket as well.  Not srictly necessary.
-    adb_socket_->Shutdown(SHUT_RDWR);
-    read_thread_.join();
-}
-
-void AdbHandler::ReadLoop() {
-  while (1) {
-    uint8_t buffer[4096];
-
-    read_set_.Set(shutdown_);
-    read_set_.Set(adb_socket_);
-    Select(&read_set_, nullptr, nullptr, nullptr);
-
-    if (read_set_.IsSet(adb_socket_)) {
-        auto read = adb_socket_->Read(buffer, sizeof(buffer));
-        if (read < 0) {
-          LOG(ERROR) << "Error on reading from ADB socket: "
-                     << adb_socket_->StrError();
-          break;
-        }
-        if (read) {
-            send_to_client_(buffer, read);
-        }
-    }
-
-    if (read_set_.IsSet(shutdown_)) {
-        LOG(INFO) << "AdbHandler is shutting down.";
-        break;
-    }
-  }
+  forwarder_.reset();
+  // Shut down the socket as well.  Not srictly necessary.
+  adb_socket_->Shutdown(SHUT_RDWR);
 }
 
 void AdbHandler::handleMessage(const uint8_t *msg, size_t len) {
@@ -20,33 +20,29 @@
 #include <stdint.h>
 
 #include <functional>
-#include <thread>
+#include <memory>
+#include <string>
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
-#include "cuttlefish/common/libs/fs/shared_select.h"
+#include "cuttlefish/host/frontend/webrtc/byte_stream_forwarder.h"
 
 namespace cuttlefish {
 namespace webrtc_streaming {
 
 struct AdbHandler {
-  explicit AdbHandler(const std::string
-          &adb_host_and_port,
-      std::function<void(const uint8_t *, size_t)> send_to_client);
+  // Data from adb is read on the thread running `reactor`.
+  AdbHandler(const std::string &adb_host_and_port, Reactor &reactor,
+             ByteStreamForwarder::Sender send_to_client,
+             ByteStreamForwarder::BufferedAmount client_buffered_amount);
 
   ~AdbHandler();
 
   void handleMessage(const uint8_t *msg, size_t len);
 
  private:
-
-  std::function<void(const uint8_t *, size_t)> send_to_client_;
-
-  void ReadLoop();
-
   SharedFD adb_socket_;
-  SharedFD shutdown_;
-  SharedFDSet read_set_;
-  std::thread read_thread_;
+  std::unique_ptr<ByteStreamForwarder> forwarder_;
 };
 
 }  // namespace webrtc_streaming
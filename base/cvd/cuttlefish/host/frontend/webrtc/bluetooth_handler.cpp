@@ -18,57 +18,42 @@
 
 #include <unistd.h>
 
+#include <memory>
+#include <utility>
+
 #include "absl/log/log.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/host/frontend/webrtc/byte_stream_forwarder.h"
+#include "cuttlefish/result/result.h"
+
 using namespace android;
 
 namespace cuttlefish {
 namespace webrtc_streaming {
 
 BluetoothHandler::BluetoothHandler(
-    const int rootCanalTestPort,
-    std::function<void(const uint8_t *, size_t)> send_to_client)
-    : send_to_client_(send_to_client),
-      rootcanal_socket_(
-          SharedFD::SocketLocalClient(rootCanalTestPort, SOCK_STREAM)),
-      shutdown_(SharedFD::Event(0, 0)) {
-  std::thread loop([this]() { ReadLoop(); });
-  read_thread_.swap(loop);
+    const int rootCanalTestPort, Reactor &reactor,
+    ByteStreamForwarder::Sender send_to_client,
+    ByteStreamForwarder::BufferedAmount client_buffered_amount)
+    : rootcanal_socket_(
+          SharedFD::SocketLocalClient(rootCanalTestPort, SOCK_STREAM)) {
+  Result<std::unique_ptr<ByteStreamForwarder>> forwarder =
+      ByteStreamForwarder::Create("RootCanal", reactor, rootcanal_socket_,
+                                  std::move(send_to_client),
+                                  std::move(client_buffered_amount));
+  if (forwarder.ok()) {
+    forwarder_ = std::move(*forwarder);
+  } else {
+    LOG(ERROR) << "Not forwarding data from RootCanal: " << forwarder.error();
+  }
 }
 
 BluetoothHandler::~BluetoothHandler() {
-  // Send a message to the looper to shut down.
-  uint64_t v = 1;
-  shutdown_->Write(&v, sizeof(v));
+  forwarder_.reset();
   // Shut down the socket as well.  Not strictly necessary.
   rootcanal_socket_->Shutdown(SHUT_RDWR);
-  read_thread_.join();
-}
-
-void BluetoothHandler::ReadLoop() {
-  while (1) {
-    uint8_t buffer[4096];
-
-    read_set_.Set(shutdown_);
-    read_set_.Set(rootcanal_socket_);
-    Select(&read_set_, nullptr, nullptr, nullptr);
-
-    if (read_set_.IsSet(rootcanal_socket_)) {
-      auto read = rootcanal_socket_->Read(buffer, sizeof(buffer));
-      if (read < 0) {
-        PLOG(ERROR) << "Error on reading from RootCanal socket.";
-        break;
-      }
-      if (read) {
-        send_to_client_(buffer, read);
-      }
-    }
-
-    if (read_set_.IsSet(shutdown_)) {
-      LOG(INFO) << "BluetoothHandler is shutting down.";
-      break;
-    }
-  }
 }
 
 void BluetoothHandler::handleMessage(const uint8_t *msg, size_t len) {
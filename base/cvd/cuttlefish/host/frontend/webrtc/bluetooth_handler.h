@@ -20,32 +20,29 @@
 #include <stdint.h>
 
 #include <functional>
-#include <thread>
+#include <memory>
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
-#include "cuttlefish/common/libs/fs/shared_select.h"
+#include "cuttlefish/host/frontend/webrtc/byte_stream_forwarder.h"
 
 namespace cuttlefish {
 namespace webrtc_streaming {
 
 struct BluetoothHandler {
-  explicit BluetoothHandler(
-      int rootCanalTestPort,
-      std::function<void(const uint8_t*, size_t)> send_to_client);
+  // Data from RootCanal is read on the thread running `reactor`.
+  BluetoothHandler(
+      int rootCanalTestPort, Reactor &reactor,
+      ByteStreamForwarder::Sender send_to_client,
+      ByteStreamForwarder::BufferedAmount client_buffered_amount);
 
   ~BluetoothHandler();
 
   void handleMessage(const uint8_t *msg, size_t len);
 
  private:
-  std::function<void(const uint8_t *, size_t)> send_to_client_;
-
-  void ReadLoop();
-
   SharedFD rootcanal_socket_;
-  SharedFD shutdown_;
-  SharedFDSet read_set_;
-  std::thread read_thread_;
+  std::unique_ptr<ByteStreamForwarder> forwarder_;
 };
 
 }  // namespace webrtc_streaming
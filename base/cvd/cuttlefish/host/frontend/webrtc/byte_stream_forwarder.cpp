@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/frontend/webrtc/byte_stream_forwarder.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace webrtc_streaming {
+
+struct ByteStreamForwarder::State
+    : public std::enable_shared_from_this<State> {
+  State(std::string name, Reactor& reactor, SharedFD socket, Sender sender,
+        BufferedAmount buffered_amount)
+      : name(std::move(name)),
+        reactor(reactor),
+        socket(std::move(socket)),
+        sender(std::move(sender)),
+        buffered_amount(std::move(buffered_amount)),
+        buffer(kMinReadSize) {}
+
+  Result<void> Watch() {
+    std::weak_ptr<State> weak_self = weak_from_this();
+    CF_EXPECT(reactor.Watch(socket, EPOLLIN, [weak_self](uint32_t) {
+      if (std::shared_ptr<State> self = weak_self.lock()) {
+        self->OnReadable();
+      }
+    }));
+    return {};
+  }
+
+  void OnReadable() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (closed) {
+      return;
+    }
+    ssize_t read = socket->Read(buffer.data(), buffer.size());
+    if (read <= 0) {
+      if (read < 0) {
+        LOG(ERROR) << "Error reading from " << name << ": "
+                   << socket->StrError();
+      } else {
+        LOG(INFO) << name << " closed the connection";
+      }
+      // A socket at EOF stays readable, it would be reported forever.
+      StopLocked();
+      return;
+    }
+    size_t size = read;
+    sender(buffer.data(), size);
+
+    // A full buffer means more was likely waiting.
+    if (size == buffer.size() && buffer.size() < kMaxMessageSize) {
+      buffer.resize(buffer.size() * 2);
+    } else if (size < buffer.size() / 4 && buffer.size() > kMinReadSize) {
+      buffer.resize(buffer.size() / 2);
+      buffer.shrink_to_fit();
+    }
+
+    if (buffered_amount() > kPauseBufferedAmount) {
+      VLOG(1) << "Pausing " << name << " while the data channel drains";
+      LogIfError(reactor.Unwatch(socket));
+      ScheduleDrainCheck();
+    }
+  }
+
+  // WebRTC reports buffered amount changes on its own threads, only to the
+  // data channel's single observer. Polling while paused is simpler and
+  // only happens under load.
+  void ScheduleDrainCheck() {
+    std::weak_ptr<State> weak_self = weak_from_this();
+    drain_timer = reactor.ScheduleAfter(kDrainPollInterval, [weak_self]() {
+      if (std::shared_ptr<State> self = weak_self.lock()) {
+        self->CheckDrained();
+      }
+    });
+  }
+
+  void CheckDrained() {
+    std::lock_guard<std::mutex> lock(mutex);
+    drain_timer.reset();
+    if (closed) {
+      return;
+    }
+    if (buffered_amount() > kResumeBufferedAmount) {
+      ScheduleDrainCheck();
+      return;
+    }
+    VLOG(1) << "Resuming " << name;
+    LogIfError(Watch());
+  }
+
+  // Requires `mutex` to be held.
+  void StopLocked() {
+    closed = true;
+    LogIfError(reactor.Unwatch(socket));
+    if (drain_timer) {
+      reactor.Cancel(*drain_timer);
+      drain_timer.reset();
+    }
+  }
+
+  void LogIfError(Result<void> result) {
+    if (!result.ok()) {
+      LOG(ERROR) << name << ": " << result.error();
+    }
+  }
+
+  const std::string name;
+  Reactor& reactor;
+  const SharedFD socket;
+  const Sender sender;
+  const BufferedAmount buffered_amount;
+
+  std::mutex mutex;
+  bool closed = false;
+  // Its size is the current read size.
+  std::vector<uint8_t> buffer;
+  std::optional<Reactor::TimerId> drain_timer;
+};
+
+Result<std::unique_ptr<ByteStreamForwarder>> ByteStreamForwarder::Create(
+    std::string name, Reactor& reactor, SharedFD socket, Sender sender,
+    BufferedAmount buffered_amount) {
+  CF_EXPECTF(socket->IsOpen(), "{} socket is not open: {}", name,
+             socket->StrError());
+  auto state =
+      std::make_shared<State>(std::move(name), reactor, std::move(socket),
+                              std::move(sender), std::move(buffered_amount));
+  CF_EXPECT(state->Watch());
+  return std::unique_ptr<ByteStreamForwarder>(
+      new ByteStreamForwarder(std::move(state)));
+}
+
+ByteStreamForwarder::ByteStreamForwarder(std::shared_ptr<State> state)
+    : state_(std::move(state)) {}
+
+ByteStreamForwarder::~ByteStreamForwarder() {
+  // Waits for a callback that is forwarding data to finish.
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  if (!state_->closed) {
+    state_->StopLocked();
+  }
+}
+
+}  // namespace webrtc_streaming
+}  // namespace cuttlefish
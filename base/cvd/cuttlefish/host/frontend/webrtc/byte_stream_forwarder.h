@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace webrtc_streaming {
+
+// Forwards what is read from a byte stream socket to a data channel. All
+// forwarders share the thread running the reactor instead of having one each.
+//
+// Reads grow up to the largest message a data channel takes while the socket
+// keeps filling them, and shrink back when traffic is sparse, so bulk
+// transfers go out in few large messages. Reading pauses while the data
+// channel has too much queued, WebRTC closes a channel whose send buffer
+// overflows.
+class ByteStreamForwarder {
+ public:
+  using Sender = std::function<bool(const uint8_t*, size_t)>;
+  // Bytes passed to the sender that weren't sent to the peer yet.
+  using BufferedAmount = std::function<uint64_t()>;
+
+  // Larger messages aren't accepted by all browsers.
+  static constexpr size_t kMaxMessageSize = 64 * 1024;
+  static constexpr size_t kMinReadSize = 4 * 1024;
+  // Well below the 16MB that WebRTC buffers before closing the channel.
+  static constexpr uint64_t kPauseBufferedAmount = 1024 * 1024;
+  static constexpr uint64_t kResumeBufferedAmount = 256 * 1024;
+  static constexpr std::chrono::milliseconds kDrainPollInterval{5};
+
+  static Result<std::unique_ptr<ByteStreamForwarder>> Create(
+      std::string name, Reactor& reactor, SharedFD socket, Sender sender,
+      BufferedAmount buffered_amount);
+  // Nothing is sent once this returns.
+  ~ByteStreamForwarder();
+
+  ByteStreamForwarder(const ByteStreamForwarder&) = delete;
+  ByteStreamForwarder& operator=(const ByteStreamForwarder&) = delete;
+
+ private:
+  // Reactor callbacks only hold weak references, one may be running while
+  // the forwarder is destroyed.
+  struct State;
+
+  explicit ByteStreamForwarder(std::shared_ptr<State> state);
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace webrtc_streaming
+}  // namespace cuttlefish
@@ -0,0 +1,129 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how fast ByteStreamForwarder moves an adb pull sized transfer from
+// a socket to a loopback peer. The peer queues messages the way a data
+// channel's send buffer does and consumes them from another thread, so flow
+// control is exercised too. The argument is the size of the writes on the
+// device side of the socket.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/host/frontend/webrtc/byte_stream_forwarder.h"
+
+namespace cuttlefish::webrtc_streaming {
+namespace {
+
+constexpr size_t kTransferSize = 16 * 1024 * 1024;
+
+class LoopbackPeer {
+ public:
+  bool Send(const uint8_t* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.emplace_back(data, data + size);
+    buffered_amount_ += size;
+    cv_.notify_one();
+    return true;
+  }
+
+  uint64_t BufferedAmount() { return buffered_amount_; }
+
+  // Returns the number of messages it took.
+  size_t Receive(size_t size) {
+    size_t messages = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (size > 0) {
+      cv_.wait(lock, [this]() { return !queue_.empty(); });
+      std::vector<uint8_t> message = std::move(queue_.front());
+      queue_.pop_front();
+      buffered_amount_ -= message.size();
+      size -= message.size();
+      messages++;
+    }
+    return messages;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::vector<uint8_t>> queue_;
+  std::atomic<uint64_t> buffered_amount_ = 0;
+};
+
+void BM_Forward(benchmark::State& state) {
+  auto reactor = Reactor::Create();
+  if (!reactor.ok()) {
+    state.SkipWithError("Failed to create reactor");
+    return;
+  }
+  SharedFD device_end;
+  SharedFD forwarded_end;
+  SharedFD::SocketPair(AF_UNIX, SOCK_STREAM, 0, &device_end, &forwarded_end);
+  LoopbackPeer peer;
+  auto forwarder = ByteStreamForwarder::Create(
+      "benchmark", **reactor, forwarded_end,
+      [&peer](const uint8_t* data, size_t size) {
+        return peer.Send(data, size);
+      },
+      [&peer]() { return peer.BufferedAmount(); });
+  if (!forwarder.ok()) {
+    state.SkipWithError("Failed to create forwarder");
+    return;
+  }
+  std::thread reactor_thread([&reactor]() { (void)(*reactor)->Run(); });
+
+  std::string chunk(state.range(0), 'a');
+  size_t messages = 0;
+  for (auto _ : state) {
+    std::thread device([&device_end, &chunk]() {
+      for (size_t sent = 0; sent < kTransferSize; sent += chunk.size()) {
+        WriteAll(device_end, chunk);
+      }
+    });
+    messages += peer.Receive(kTransferSize);
+    device.join();
+  }
+
+  forwarder->reset();
+  (*reactor)->Stop();
+  reactor_thread.join();
+  state.SetBytesProcessed(state.iterations() * kTransferSize);
+  state.counters["messages"] =
+      benchmark::Counter(messages, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_Forward)
+    ->Arg(4096)
+    ->Arg(64 * 1024)
+    ->Arg(256 * 1024)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace cuttlefish::webrtc_streaming
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/frontend/webrtc/byte_stream_forwarder.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/fs/reactor.h"
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace webrtc_streaming {
+namespace {
+
+class ByteStreamForwarderTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    Result<std::unique_ptr<Reactor>> reactor = Reactor::Create();
+    ASSERT_TRUE(reactor.ok()) << reactor.error();
+    reactor_ = std::move(*reactor);
+    reactor_thread_ = std::thread([this]() { (void)reactor_->Run(); });
+    ASSERT_TRUE(SharedFD::SocketPair(AF_UNIX, SOCK_STREAM, 0, &device_end_,
+                                     &forwarded_end_));
+  }
+
+  void TearDown() override {
+    forwarder_.reset();
+    reactor_->Stop();
+    reactor_thread_.join();
+  }
+
+  void StartForwarder() {
+    Result<std::unique_ptr<ByteStreamForwarder>> forwarder =
+        ByteStreamForwarder::Create(
+            "test", *reactor_, forwarded_end_,
+            [this](const uint8_t* data, size_t size) {
+              std::lock_guard<std::mutex> lock(mutex_);
+              received_.append(reinterpret_cast<const char*>(data), size);
+              messages_++;
+              largest_message_ = std::max(largest_message_, size);
+              cv_.notify_all();
+              return true;
+            },
+            [this]() { return buffered_amount_.load(); });
+    ASSERT_TRUE(forwarder.ok()) << forwarder.error();
+    forwarder_ = std::move(*forwarder);
+  }
+
+  void WaitForBytes(size_t size) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ASSERT_TRUE(cv_.wait_for(lock, std::chrono::seconds(10), [this, size]() {
+      return received_.size() >= size;
+    }));
+  }
+
+  std::unique_ptr<Reactor> reactor_;
+  std::thread reactor_thread_;
+  SharedFD device_end_;
+  SharedFD forwarded_end_;
+  std::unique_ptr<ByteStreamForwarder> forwarder_;
+  std::atomic<uint64_t> buffered_amount_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::string received_;
+  size_t messages_ = 0;
+  size_t largest_message_ = 0;
+};
+
+TEST_F(ByteStreamForwarderTest, GrowsReadsWhileDataIsWaiting) {
+  // Fits in the socket buffer, so it's all waiting when forwarding starts.
+  std::string data(128 * 1024, '\0');
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i * 7);
+  }
+  ASSERT_EQ(WriteAll(device_end_, data), data.size());
+
+  StartForwarder();
+  WaitForBytes(data.size());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  EXPECT_EQ(received_, data);
+  EXPECT_EQ(largest_message_, ByteStreamForwarder::kMaxMessageSize);
+  // 4 + 8 + 16 + 32 + 64 KiB, then what's left.
+  EXPECT_EQ(messages_, 6);
+}
+
+TEST_F(ByteStreamForwarderTest, PausesWhileDataChannelIsFull) {
+  buffered_amount_ = ByteStreamForwarder::kPauseBufferedAmount + 1;
+  std::string data(3 * ByteStreamForwarder::kMinReadSize, 'x');
+  ASSERT_EQ(WriteAll(device_end_, data), data.size());
+
+  StartForwarder();
+  WaitForBytes(ByteStreamForwarder::kMinReadSize);
+  std::this_thread::sleep_for(10 * ByteStreamForwarder::kDrainPollInterval);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EXPECT_EQ(received_.size(), ByteStreamForwarder::kMinReadSize);
+  }
+
+  buffered_amount_ = ByteStreamForwarder::kResumeBufferedAmount;
+  WaitForBytes(data.size());
+  std::lock_guard<std::mutex> lock(mutex_);
+  EXPECT_EQ(received_, data);
+}
+
+TEST_F(ByteStreamForwarderTest, NothingIsSentAfterDestruction) {
+  StartForwarder();
+  forwarder_.reset();
+
+  ASSERT_EQ(WriteAll(device_end_, std::string("late")), 4);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  std::lock_guard<std::mutex> lock(mutex_);
+  EXPECT_EQ(messages_, 0);
+}
+
+}  // namespace
+}  // namespace webrtc_streaming
+}  // namespace cuttlefish
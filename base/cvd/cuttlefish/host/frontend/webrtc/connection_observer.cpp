@@ -35,6 +35,7 @@
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_split.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_buf.h"
 #include "cuttlefish/common/libs/utils/json.h"
 #include "cuttlefish/host/frontend/webrtc/adb_handler.h"
@@ -66,14 +67,16 @@ class ConnectionObserverImpl : public webrtc_streaming::ConnectionObserver {
       std::weak_ptr<DisplayHandler> display_handler,
       CameraController *camera_controller,
       webrtc_streaming::SensorsHandler &sensors_handler,
-      std::shared_ptr<webrtc_streaming::LightsObserver> lights_observer)
+      std::shared_ptr<webrtc_streaming::LightsObserver> lights_observer,
+      Reactor &byte_stream_reactor)
       : input_events_sink_(std::move(input_events_sink)),
         kernel_log_events_handler_(kernel_log_events_handler),
         commands_to_custom_action_servers_(commands_to_custom_action_servers),
         weak_display_handler_(display_handler),
         camera_controller_(camera_controller),
         sensors_handler_(sensors_handler),
-        lights_observer_(lights_observer) {}
+        lights_observer_(lights_observer),
+        byte_stream_reactor_(byte_stream_reactor) {}
   virtual ~ConnectionObserverImpl() {
     auto display_handler = weak_display_handler_.lock();
     if (display_handler) {
@@ -147,17 +150,23 @@ class ConnectionObserverImpl : public webrtc_streaming::ConnectionObserver {
     return {};
   }
 
+  Result<void> OnInputEvents(const std::vector<InputEvent> &events) override {
+    CF_EXPECT(input_events_sink_->SendEvents(events));
+    return {};
+  }
+
   Result<void> OnSwitchEvent(uint16_t code, bool state) {
     CF_EXPECT(input_events_sink_->SendSwitchesEvent(code, state));
     return {};
   }
 
-  void OnAdbChannelOpen(std::function<bool(const uint8_t *, size_t)>
-                            adb_message_sender) override {
+  void OnAdbChannelOpen(
+      std::function<bool(const uint8_t *, size_t)> adb_message_sender,
+      std::function<uint64_t()> adb_buffered_amount) override {
     VLOG(1) << "Adb Channel open";
     adb_handler_.reset(new webrtc_streaming::AdbHandler(
         CuttlefishConfig::Get()->ForDefaultInstance().adb_ip_and_port(),
-        adb_message_sender));
+        byte_stream_reactor_, adb_message_sender, adb_buffered_amount));
   }
   void OnAdbMessage(const uint8_t *msg, size_t size) override {
     adb_handler_->handleMessage(msg, size);
@@ -225,13 +234,15 @@ class ConnectionObserverImpl : public webrtc_streaming::ConnectionObserver {
     }
   }
 
-  void OnBluetoothChannelOpen(std::function<bool(const uint8_t *, size_t)>
-                                  bluetooth_message_sender) override {
+  void OnBluetoothChannelOpen(
+      std::function<bool(const uint8_t *, size_t)> bluetooth_message_sender,
+      std::function<uint64_t()> bluetooth_buffered_amount) override {
     VLOG(1) << "Bluetooth channel open";
     auto config = CuttlefishConfig::Get();
     CHECK(config) << "Failed to get config";
     bluetooth_handler_.reset(new webrtc_streaming::BluetoothHandler(
-        config->rootcanal_test_port(), bluetooth_message_sender));
+        config->rootcanal_test_port(), byte_stream_reactor_,
+        bluetooth_message_sender, bluetooth_buffered_amount));
   }
 
   void OnBluetoothMessage(const uint8_t *msg, size_t size) override {
@@ -457,17 +468,20 @@ class ConnectionObserverImpl : public webrtc_streaming::ConnectionObserver {
   std::shared_ptr<webrtc_streaming::LightsObserver> lights_observer_;
   int sensors_subscription_id = -1;
   int lights_subscription_id_ = -1;
+  Reactor &byte_stream_reactor_;
 };
 
 CfConnectionObserverFactory::CfConnectionObserverFactory(
     InputConnector &input_connector,
     KernelLogEventsHandler &kernel_log_events_handler,
     webrtc_streaming::SensorsHandler &sensors_handler,
-    std::shared_ptr<webrtc_streaming::LightsObserver> lights_observer)
+    std::shared_ptr<webrtc_streaming::LightsObserver> lights_observer,
+    Reactor &byte_stream_reactor)
     : input_connector_(input_connector),
       kernel_log_events_handler_(kernel_log_events_handler),
       sensors_handler_(sensors_handler),
-      lights_observer_(lights_observer) {}
+      lights_observer_(lights_observer),
+      byte_stream_reactor_(byte_stream_reactor) {}
 
 std::shared_ptr<webrtc_streaming::ConnectionObserver>
 CfConnectionObserverFactory::CreateObserver() {
@@ -475,7 +489,8 @@ CfConnectionObserverFactory::CreateObserver() {
       new ConnectionObserverImpl(
           input_connector_.CreateSink(), kernel_log_events_handler_,
           commands_to_custom_action_servers_, weak_display_handler_,
-          camera_controller_, sensors_handler_, lights_observer_));
+          camera_controller_, sensors_handler_, lights_observer_,
+          byte_stream_reactor_));
 }
 
 void CfConnectionObserverFactory::AddCustomActionServer(
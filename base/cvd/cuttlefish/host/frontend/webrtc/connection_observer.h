@@ -19,6 +19,7 @@
 #include <map>
 #include <memory>
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/host/frontend/webrtc/display_handler.h"
 #include "cuttlefish/host/frontend/webrtc/kernel_log_events_handler.h"
@@ -38,7 +39,9 @@ class CfConnectionObserverFactory
       InputConnector& input_connector,
       KernelLogEventsHandler& kernel_log_events_handler,
       webrtc_streaming::SensorsHandler& sensors_handler,
-      std::shared_ptr<webrtc_streaming::LightsObserver> lights_observer);
+      std::shared_ptr<webrtc_streaming::LightsObserver> lights_observer,
+      // Runs the adb and bluetooth forwarding of all connections.
+      Reactor& byte_stream_reactor);
   ~CfConnectionObserverFactory() override = default;
 
   std::shared_ptr<webrtc_streaming::ConnectionObserver> CreateObserver()
@@ -60,6 +63,7 @@ class CfConnectionObserverFactory
   cuttlefish::CameraController* camera_controller_ = nullptr;
   webrtc_streaming::SensorsHandler& sensors_handler_;
   std::shared_ptr<webrtc_streaming::LightsObserver> lights_observer_;
+  Reactor& byte_stream_reactor_;
 };
 
 }  // namespace cuttlefish
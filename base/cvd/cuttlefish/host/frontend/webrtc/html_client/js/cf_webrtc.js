@@ -82,6 +82,84 @@ function awaitDataChannel(pc, label, onMessage) {
   };
 }
 
+// Sends input events in binary batches, see libdevice/binary_input.h for the
+// format. Motion events wait for the next animation frame so that all the
+// motion of a display refresh travels in one message, other events are sent as
+// soon as the current task finishes.
+class InputBatcher {
+  static #VERSION = 1;
+  static MOUSE_MOVE = 1;
+  static MOUSE_BUTTON = 2;
+  static MOUSE_WHEEL = 3;
+  static MULTI_TOUCH = 4;
+  static KEYBOARD = 5;
+  static ROTARY = 6;
+  static GAMEPAD_KEY = 7;
+  static GAMEPAD_MOTION = 8;
+
+  #channel;
+  #bytes = [];
+  #flushQueued = false;
+  #frameRequested = false;
+
+  constructor(channel) {
+    this.#channel = channel;
+  }
+
+  u8(value) {
+    this.#bytes.push(value & 0xff);
+    return this;
+  }
+
+  i32(value) {
+    value = Math.trunc(value) | 0;
+    for (let i = 0; i < 4; i++) {
+      this.#bytes.push((value >> (8 * i)) & 0xff);
+    }
+    return this;
+  }
+
+  str(value) {
+    const encoded = new TextEncoder().encode(value);
+    if (encoded.length > 255) {
+      throw new Error(`Input event string too long: ${value}`);
+    }
+    this.u8(encoded.length);
+    this.#bytes.push(...encoded);
+    return this;
+  }
+
+  // Must be called after each complete event.
+  commit(isMotion) {
+    if (isMotion) {
+      if (!this.#frameRequested) {
+        this.#frameRequested = true;
+        requestAnimationFrame(() => {
+          this.#frameRequested = false;
+          this.#flush();
+        });
+      }
+    } else if (!this.#flushQueued) {
+      this.#flushQueued = true;
+      queueMicrotask(() => {
+        this.#flushQueued = false;
+        this.#flush();
+      });
+    }
+  }
+
+  #flush() {
+    if (this.#bytes.length == 0) {
+      return;
+    }
+    const msg = new Uint8Array(1 + this.#bytes.length);
+    msg[0] = InputBatcher.#VERSION;
+    msg.set(this.#bytes, 1);
+    this.#bytes = [];
+    this.#channel.send(msg.buffer);
+  }
+}
+
 class DeviceConnection {
   #pc;
   #control;
@@ -91,6 +169,7 @@ class DeviceConnection {
   #cameraInputQueue;
   #controlChannel;
   #inputChannel;
+  #inputBatcher;
   #adbChannel;
   #bluetoothChannel;
   #lightsChannel;
@@ -132,6 +211,7 @@ class DeviceConnection {
       }
     };
     this.#inputChannel = createDataChannel(pc, 'input-channel');
+    this.#inputBatcher = new InputBatcher(this.#inputChannel);
     this.#sensorsChannel = createDataChannel(pc, 'sensors-channel', (msg) => {
       if (!this.#onSensorsMessage) {
         console.error('Received unexpected Sensors message');
@@ -272,75 +352,61 @@ class DeviceConnection {
     this.#control.expectMessagesSoon(5000);
   }
 
-  #sendJsonInput(evt) {
-    this.#inputChannel.send(JSON.stringify(evt));
-  }
-
   sendMouseMove({x, y}) {
-    this.#sendJsonInput({
-      type: 'mouseMove',
-      x,
-      y,
-    });
+    this.#inputBatcher.u8(InputBatcher.MOUSE_MOVE).i32(x).i32(y).commit(true);
   }
 
   sendMouseButton({button, down}) {
-    this.#sendJsonInput({
-      type: 'mouseButton',
-      button: button,
-      down: down ? 1 : 0,
-    });
+    this.#inputBatcher.u8(InputBatcher.MOUSE_BUTTON)
+        .u8(button)
+        .u8(down ? 1 : 0)
+        .commit(false);
   }
 
   sendGamepadKey({id, button, down}) {
-    this.#sendJsonInput({
-      type: 'gamepadKey',
-      id: id,
-      button: button,
-      down: down ? 1 : 0,
-    });
+    this.#inputBatcher.u8(InputBatcher.GAMEPAD_KEY)
+        .u8(button)
+        .u8(down ? 1 : 0)
+        .commit(false);
   }
 
   sendGamepadMotion({button, value}) {
-    this.#sendJsonInput({
-      type: 'gamepadMotion',
-      button: button,
-      value: value,
-    });
+    // The gamepad is polled once per frame already.
+    this.#inputBatcher.u8(InputBatcher.GAMEPAD_MOTION)
+        .u8(button)
+        .i32(value)
+        .commit(true);
   }
 
   // TODO (b/124121375): This should probably be an array of pointer events and
   // have different properties.
   sendMultiTouch({idArr, xArr, yArr, down, device_label}) {
-    let events = {
-            type: 'multi-touch',
-            id: idArr,
-            x: xArr,
-            y: yArr,
-            down: down ? 1 : 0,
-            device_label: device_label,
-          };
-    this.#sendJsonInput(events);
+    this.#inputBatcher.u8(InputBatcher.MULTI_TOUCH)
+        .u8(down ? 1 : 0)
+        .str(device_label)
+        .u8(idArr.length);
+    for (let i = 0; i < idArr.length; i++) {
+      this.#inputBatcher.i32(idArr[i]).i32(xArr[i]).i32(yArr[i]);
+    }
+    // Lifting a finger ends a gesture, don't wait for the next frame.
+    this.#inputBatcher.commit(down);
   }
 
   sendKeyEvent(code, type) {
-    this.#sendJsonInput({type: 'keyboard', keycode: code, event_type: type});
+    this.#inputBatcher.u8(InputBatcher.KEYBOARD)
+        .u8(type == 'keydown' ? 1 : 0)
+        .str(code)
+        .commit(false);
   }
 
   sendWheelEvent(pixels) {
-    this.#sendJsonInput({
-      type: 'wheel',
-      // convert double to int, forcing a base 10 conversion. pixels can be fractional.
-      pixels: parseInt(pixels, 10),
-    });
+    // pixels can be fractional, it's truncated to an int.
+    this.#inputBatcher.u8(InputBatcher.ROTARY).i32(pixels).commit(false);
   }
 
   sendMouseWheelEvent(pixels) {
-    this.#sendJsonInput({
-      type: 'mouseWheel',
-      // convert double to int, forcing a base 10 conversion. pixels can be fractional.
-      pixels: parseInt(pixels, 10),
-    });
+    // pixels can be fractional, it's truncated to an int.
+    this.#inputBatcher.u8(InputBatcher.MOUSE_WHEEL).i32(pixels).commit(false);
   }
 
   disconnect() {
@@ -17,16 +17,22 @@
 'use strict';
 
 function trackMouseEvents(dc, mouseElement) {
+  // Moves report the button state too, only send it when it changes so that
+  // the moves of a frame can be batched together.
+  let buttonDown = false;
+
   function onMouseDown(evt) {
     if (!document.pointerLockElement) {
       mouseElement.requestPointerLock({});
       return;
     }
+    buttonDown = true;
     dc.sendMouseButton({button: evt.button, down: true});
   }
 
   function onMouseUp(evt) {
     if (document.pointerLockElement) {
+      buttonDown = evt.buttons > 0;
       dc.sendMouseButton({button: evt.button, down: false});
     }
   }
@@ -34,7 +40,10 @@ function trackMouseEvents(dc, mouseElement) {
   function onMouseMove(evt) {
     if (document.pointerLockElement) {
       dc.sendMouseMove({x: evt.movementX, y: evt.movementY});
-      dc.sendMouseButton({button: evt.button, down: evt.buttons > 0});
+      if (buttonDown != evt.buttons > 0) {
+        buttonDown = evt.buttons > 0;
+        dc.sendMouseButton({button: evt.button, down: buttonDown});
+      }
     }
   }
   mouseElement.addEventListener('mousedown', onMouseDown);
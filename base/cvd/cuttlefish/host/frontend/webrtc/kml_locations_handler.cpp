@@ -21,7 +21,9 @@
 #include <unistd.h>
 
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include "absl/log/log.h"
 #include "fmt/format.h"
@@ -29,7 +31,9 @@
 
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
 #include "cuttlefish/host/libs/location/GnssClient.h"
+#include "cuttlefish/host/libs/location/GpsFix.h"
 #include "cuttlefish/host/libs/location/KmlParser.h"
+#include "cuttlefish/result/result.h"
 
 namespace cuttlefish::webrtc_streaming {
 
@@ -40,15 +44,6 @@ KmlLocationsHandler::~KmlLocationsHandler() {}
 
 void KmlLocationsHandler::HandleMessage(const uint8_t *msg, size_t len) {
   VLOG(0) << "ENTER KmlLocationsHandler handleMessage , size: " << len;
-  std::string error;
-  GpsFixArray coordinates;
-  if (!KmlParser::parseString((const char *)&msg[0], len, &coordinates,
-                              &error)) {
-    LOG(ERROR) << " Parsing Error: " << error << std::endl;
-    return;
-  }
-
-  VLOG(0) << "Number of parsed points: " << coordinates.size() << std::endl;
   auto config = CuttlefishConfig::Get();
   if (!config) {
     LOG(ERROR) << "Failed to obtain config object";
@@ -61,7 +56,24 @@ void KmlLocationsHandler::HandleMessage(const uint8_t *msg, size_t len) {
   GnssClient gpsclient(
       grpc::CreateChannel(socket_name, grpc::InsecureChannelCredentials()));
 
-  Result<void> reply = gpsclient.SendGpsLocations(1000, coordinates);
+  // Fixes are sent while the rest of the document is parsed.
+  std::unique_ptr<GpsLocationStream> stream =
+      gpsclient.StreamGpsLocations(1000);
+  size_t count = 0;
+  Result<void> parsed = KmlParser::streamString(
+      std::string_view((const char *)msg, len),
+      [&stream, &count](const GpsFix &fix) -> Result<void> {
+        CF_EXPECT(stream->Send(fix));
+        count++;
+        return {};
+      });
+  if (!parsed.ok()) {
+    LOG(ERROR) << " Parsing Error: " << parsed.error();
+    return;
+  }
+
+  VLOG(0) << "Number of parsed points: " << count << std::endl;
+  Result<void> reply = stream->Finish();
   if (!reply.ok()) {
     LOG(ERROR) << reply.error();
   }
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/frontend/webrtc/libdevice/binary_input.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cuttlefish/host/frontend/webrtc/libdevice/gamepad.h"
+#include "cuttlefish/host/libs/input_connector/input_events.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace webrtc_streaming {
+namespace {
+
+class BinaryInputReader {
+ public:
+  BinaryInputReader(const uint8_t* data, size_t size)
+      : data_(data), size_(size) {}
+
+  bool AtEnd() const { return offset_ == size_; }
+
+  Result<uint8_t> U8() {
+    CF_EXPECT(Available(1), "Truncated binary input message");
+    return data_[offset_++];
+  }
+
+  Result<int32_t> I32() {
+    CF_EXPECT(Available(4), "Truncated binary input message");
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+      value |= uint32_t{data_[offset_++]} << (8 * i);
+    }
+    return static_cast<int32_t>(value);
+  }
+
+  Result<std::string> String() {
+    size_t len = CF_EXPECT(U8());
+    CF_EXPECT(Available(len), "Truncated binary input message");
+    std::string str(reinterpret_cast<const char*>(data_ + offset_), len);
+    offset_ += len;
+    return str;
+  }
+
+ private:
+  bool Available(size_t len) const { return size_ - offset_ >= len; }
+
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+}  // namespace
+
+Result<std::vector<InputEvent>> DecodeBinaryInput(
+    const uint8_t* data, size_t size, const KeyboardCodeMapper& keyboard_code) {
+  BinaryInputReader reader(data, size);
+  uint8_t version = CF_EXPECT(reader.U8());
+  CF_EXPECTF(version == kBinaryInputVersion,
+             "Unsupported binary input version: {}", version);
+
+  std::vector<InputEvent> events;
+  while (!reader.AtEnd()) {
+    uint8_t type = CF_EXPECT(reader.U8());
+    switch (type) {
+      case kMouseMove: {
+        int32_t x = CF_EXPECT(reader.I32());
+        int32_t y = CF_EXPECT(reader.I32());
+        events.emplace_back(MouseMoveEvent{.x = x, .y = y});
+        break;
+      }
+      case kMouseButton: {
+        int32_t button = CF_EXPECT(reader.U8());
+        bool down = CF_EXPECT(reader.U8());
+        events.emplace_back(MouseButtonEvent{.button = button, .down = down});
+        break;
+      }
+      case kMouseWheel:
+        events.emplace_back(MouseWheelEvent{.pixels = CF_EXPECT(reader.I32())});
+        break;
+      case kMultiTouch: {
+        MultiTouchEvent touch;
+        touch.down = CF_EXPECT(reader.U8());
+        touch.device_label = CF_EXPECT(reader.String());
+        touch.slots.resize(CF_EXPECT(reader.U8()));
+        for (MultitouchSlot& slot : touch.slots) {
+          slot.id = CF_EXPECT(reader.I32());
+          slot.x = CF_EXPECT(reader.I32());
+          slot.y = CF_EXPECT(reader.I32());
+        }
+        events.emplace_back(std::move(touch));
+        break;
+      }
+      case kKeyboard: {
+        bool down = CF_EXPECT(reader.U8());
+        uint16_t code = CF_EXPECT(keyboard_code(CF_EXPECT(reader.String())));
+        events.emplace_back(KeyboardEvent{.code = code, .down = down});
+        break;
+      }
+      case kRotary:
+        events.emplace_back(RotaryEvent{.pixels = CF_EXPECT(reader.I32())});
+        break;
+      case kGamepadKey: {
+        int32_t code = JsIndexToLinux(CF_EXPECT(reader.U8()));
+        bool down = CF_EXPECT(reader.U8());
+        events.emplace_back(GamepadKeyEvent{.code = code, .down = down});
+        break;
+      }
+      case kGamepadMotion: {
+        int32_t code = CF_EXPECT(reader.U8());
+        int32_t value = CF_EXPECT(reader.I32());
+        events.emplace_back(GamepadMotionEvent{.code = code, .value = value});
+        break;
+      }
+      default:
+        return CF_ERRF("Unknown binary input event type: {}", type);
+    }
+  }
+  return events;
+}
+
+}  // namespace webrtc_streaming
+}  // namespace cuttlefish
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "cuttlefish/host/libs/input_connector/input_events.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace webrtc_streaming {
+
+// Binary input messages carry the events the client collected during one
+// display refresh. Integers are little endian.
+//   message := version:u8 record*
+//   record  := type:u8 payload
+// with payloads:
+//   kMouseMove:     x:i32 y:i32 (relative motion)
+//   kMouseButton:   button:u8 down:u8
+//   kMouseWheel:    pixels:i32
+//   kMultiTouch:    down:u8 label_len:u8 label count:u8 (id:i32 x:i32 y:i32)*
+//   kKeyboard:      down:u8 code_len:u8 dom_key_code
+//   kRotary:        pixels:i32
+//   kGamepadKey:    js_button_index:u8 down:u8
+//   kGamepadMotion: abs_code:u8 value:i32
+inline constexpr uint8_t kBinaryInputVersion = 1;
+enum BinaryInputType : uint8_t {
+  kMouseMove = 1,
+  kMouseButton = 2,
+  kMouseWheel = 3,
+  kMultiTouch = 4,
+  kKeyboard = 5,
+  kRotary = 6,
+  kGamepadKey = 7,
+  kGamepadMotion = 8,
+};
+
+// Maps a DOM KeyboardEvent.code to a linux key code.
+using KeyboardCodeMapper =
+    std::function<Result<uint16_t>(const std::string& dom_key_code)>;
+
+Result<std::vector<InputEvent>> DecodeBinaryInput(
+    const uint8_t* data, size_t size, const KeyboardCodeMapper& keyboard_code);
+
+}  // namespace webrtc_streaming
+}  // namespace cuttlefish
@@ -0,0 +1,167 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/frontend/webrtc/libdevice/binary_input.h"
+
+#include <linux/input.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/host/libs/input_connector/input_events.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace webrtc_streaming {
+namespace {
+
+class Message {
+ public:
+  Message() { bytes_.push_back(kBinaryInputVersion); }
+
+  Message& U8(uint8_t value) {
+    bytes_.push_back(value);
+    return *this;
+  }
+  Message& I32(int32_t value) {
+    for (int i = 0; i < 4; i++) {
+      bytes_.push_back(static_cast<uint32_t>(value) >> (8 * i));
+    }
+    return *this;
+  }
+  Message& Str(const std::string& value) {
+    U8(value.size());
+    bytes_.insert(bytes_.end(), value.begin(), value.end());
+    return *this;
+  }
+
+  std::vector<uint8_t>& Bytes() { return bytes_; }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+Result<uint16_t> FakeKeyboardCode(const std::string& dom_key_code) {
+  CF_EXPECT_EQ(dom_key_code, "KeyA");
+  return KEY_A;
+}
+
+Result<std::vector<InputEvent>> Decode(const std::vector<uint8_t>& bytes) {
+  return DecodeBinaryInput(bytes.data(), bytes.size(), FakeKeyboardCode);
+}
+
+TEST(DecodeBinaryInputTest, DecodesEveryRecordType) {
+  Message msg;
+  msg.U8(kMouseMove).I32(-3).I32(70000);
+  msg.U8(kMouseButton).U8(2).U8(1);
+  msg.U8(kMouseWheel).I32(-120);
+  msg.U8(kMultiTouch).U8(1).Str("display_0").U8(2);
+  msg.I32(0).I32(10).I32(20).I32(1).I32(30).I32(40);
+  msg.U8(kKeyboard).U8(0).Str("KeyA");
+  msg.U8(kRotary).I32(5);
+  msg.U8(kGamepadKey).U8(0).U8(1);
+  msg.U8(kGamepadMotion).U8(ABS_Z).I32(-32768);
+
+  Result<std::vector<InputEvent>> events = Decode(msg.Bytes());
+  ASSERT_THAT(events, IsOk());
+  ASSERT_EQ(events->size(), 8);
+
+  auto& move = std::get<MouseMoveEvent>((*events)[0]);
+  EXPECT_EQ(move.x, -3);
+  EXPECT_EQ(move.y, 70000);
+  auto& button = std::get<MouseButtonEvent>((*events)[1]);
+  EXPECT_EQ(button.button, 2);
+  EXPECT_TRUE(button.down);
+  EXPECT_EQ(std::get<MouseWheelEvent>((*events)[2]).pixels, -120);
+  auto& touch = std::get<MultiTouchEvent>((*events)[3]);
+  EXPECT_TRUE(touch.down);
+  EXPECT_EQ(touch.device_label, "display_0");
+  ASSERT_EQ(touch.slots.size(), 2);
+  EXPECT_EQ(touch.slots[1].id, 1);
+  EXPECT_EQ(touch.slots[1].x, 30);
+  EXPECT_EQ(touch.slots[1].y, 40);
+  auto& key = std::get<KeyboardEvent>((*events)[4]);
+  EXPECT_EQ(key.code, KEY_A);
+  EXPECT_FALSE(key.down);
+  EXPECT_EQ(std::get<RotaryEvent>((*events)[5]).pixels, 5);
+  // JS button index 0 is the bottom face button.
+  auto& gamepad_key = std::get<GamepadKeyEvent>((*events)[6]);
+  EXPECT_EQ(gamepad_key.code, BTN_SOUTH);
+  EXPECT_TRUE(gamepad_key.down);
+  auto& gamepad_motion = std::get<GamepadMotionEvent>((*events)[7]);
+  EXPECT_EQ(gamepad_motion.code, ABS_Z);
+  EXPECT_EQ(gamepad_motion.value, -32768);
+}
+
+TEST(DecodeBinaryInputTest, EmptyBatch) {
+  Result<std::vector<InputEvent>> events = Decode(Message().Bytes());
+  ASSERT_THAT(events, IsOk());
+  EXPECT_TRUE(events->empty());
+}
+
+TEST(DecodeBinaryInputTest, RejectsEmptyMessage) {
+  EXPECT_THAT(Decode({}), IsError());
+}
+
+TEST(DecodeBinaryInputTest, RejectsUnknownVersion) {
+  Message msg;
+  msg.Bytes()[0] = kBinaryInputVersion + 1;
+  msg.U8(kRotary).I32(1);
+
+  EXPECT_THAT(Decode(msg.Bytes()), IsError());
+}
+
+TEST(DecodeBinaryInputTest, RejectsUnknownRecordType) {
+  Message msg;
+  msg.U8(kRotary).I32(1).U8(0xff);
+
+  EXPECT_THAT(Decode(msg.Bytes()), IsError());
+}
+
+TEST(DecodeBinaryInputTest, RejectsEveryTruncation) {
+  Message msg;
+  msg.U8(kMouseMove).I32(1).I32(2);
+  msg.U8(kMultiTouch).U8(1).Str("display_0").U8(1).I32(0).I32(1).I32(2);
+  msg.U8(kKeyboard).U8(1).Str("KeyA");
+  msg.U8(kGamepadMotion).U8(ABS_X).I32(7);
+  const std::vector<uint8_t>& bytes = msg.Bytes();
+  ASSERT_THAT(Decode(bytes), IsOk());
+
+  // Every proper prefix either ends at a record boundary or is rejected.
+  const std::vector<size_t> boundaries = {1, 10, 35, 42};
+  for (size_t size = 0; size < bytes.size(); size++) {
+    std::vector<uint8_t> prefix(bytes.begin(), bytes.begin() + size);
+    bool boundary = std::find(boundaries.begin(), boundaries.end(), size) !=
+                    boundaries.end();
+    EXPECT_EQ(Decode(prefix).ok(), boundary) << "size " << size;
+  }
+}
+
+TEST(DecodeBinaryInputTest, PropagatesKeyboardMappingErrors) {
+  Message msg;
+  msg.U8(kKeyboard).U8(1).Str("NotAKey");
+
+  EXPECT_THAT(Decode(msg.Bytes()), IsError());
+}
+
+}  // namespace
+}  // namespace webrtc_streaming
+}  // namespace cuttlefish
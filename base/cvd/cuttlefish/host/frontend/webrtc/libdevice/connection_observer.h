@@ -16,10 +16,14 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <functional>
+#include <vector>
 
 #include "json/json.h"
 
+#include "cuttlefish/host/libs/input_connector/input_events.h"
 #include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
@@ -60,8 +64,14 @@ class ConnectionObserver {
 
   virtual Result<void> OnRotaryWheelEvent(int pixels) = 0;
 
+  // Events received together in a binary input message, in order.
+  virtual Result<void> OnInputEvents(const std::vector<InputEvent>& events) = 0;
+
+  // The second function returns how many bytes sent on the channel are still
+  // queued, for flow control.
   virtual void OnAdbChannelOpen(
-      std::function<bool(const uint8_t*, size_t)> adb_message_sender) = 0;
+      std::function<bool(const uint8_t*, size_t)> adb_message_sender,
+      std::function<uint64_t()> adb_buffered_amount) = 0;
   virtual void OnAdbMessage(const uint8_t* msg, size_t size) = 0;
 
   virtual void OnControlChannelOpen(
@@ -83,7 +93,8 @@ class ConnectionObserver {
   virtual void OnDisplayRemoveMsg(const Json::Value& msg) = 0;
 
   virtual void OnBluetoothChannelOpen(
-      std::function<bool(const uint8_t*, size_t)> bluetooth_message_sender) = 0;
+      std::function<bool(const uint8_t*, size_t)> bluetooth_message_sender,
+      std::function<uint64_t()> bluetooth_buffered_amount) = 0;
   virtual void OnBluetoothMessage(const uint8_t* msg, size_t size) = 0;
   virtual void OnSensorsChannelOpen(
       std::function<bool(const uint8_t*, size_t)> sensors_message_sender) = 0;
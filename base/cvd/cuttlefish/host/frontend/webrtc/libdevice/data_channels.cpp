@@ -16,13 +16,21 @@
 
 #include "cuttlefish/host/frontend/webrtc/libdevice/data_channels.h"
 
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "absl/log/log.h"
 
 #include "cuttlefish/common/libs/utils/json.h"
 #include "cuttlefish/host/frontend/webrtc/libcommon/utils.h"
+#include "cuttlefish/host/frontend/webrtc/libdevice/binary_input.h"
 #include "cuttlefish/host/frontend/webrtc/libdevice/gamepad.h"
 #include "cuttlefish/host/frontend/webrtc/libdevice/keyboard.h"
+#include "cuttlefish/host/frontend/webrtc/libdevice/latency_histogram.h"
 #include "cuttlefish/host/libs/config/cuttlefish_config.h"
+#include "cuttlefish/host/libs/input_connector/input_events.h"
 
 namespace cuttlefish {
 namespace webrtc_streaming {
@@ -58,6 +66,9 @@ class DataChannelHandler : public webrtc::DataChannelObserver {
   std::function<bool(const Json::Value &)> GetJSONSender() {
     return [this](const Json::Value &msg) { return Send(msg); };
   }
+  std::function<uint64_t()> GetBufferedAmount() {
+    return [this]() { return channel()->buffered_amount(); };
+  }
 
  private:
   bool first_msg_received_ = false;
@@ -76,15 +87,62 @@ static constexpr auto kKmlLocationsDataChannelLabel = "kml-locations-channel";
 static constexpr auto kGpxLocationsDataChannelLabel = "gpx-locations-channel";
 static constexpr auto kCameraDataEof = "EOF";
 
+// Log the latency histograms every this many messages.
+static constexpr uint64_t kLatencyLogInterval = 1000;
+
+Result<uint16_t> KeyboardCode(const std::string &dom_key_code) {
+  auto cvd_config =
+      CF_EXPECT(CuttlefishConfig::Get(), "CuttlefishConfig is null!");
+  auto instance = cvd_config->ForDefaultInstance();
+  Json::Value domkey_mapping_config_json = instance.domkey_mapping_config();
+  if (domkey_mapping_config_json.isMember("mappings") &&
+      domkey_mapping_config_json["mappings"].isMember(dom_key_code)) {
+    return domkey_mapping_config_json["mappings"][dom_key_code].asUInt();
+  }
+  return DomKeyCodeToLinux(dom_key_code);
+}
+
 // These classes use the Template pattern to minimize code repetition between
 // data channel handlers.
 
 class InputChannelHandler : public DataChannelHandler {
  public:
   Result<void> OnMessageInner(const webrtc::DataBuffer &msg) override {
-    // TODO: jemoreira - consider binary protocol to avoid JSON parsing
-    // overhead
-    CF_EXPECT(!msg.binary, "Received invalid (binary) data on input channel");
+    // Measures the time spent on the host, from the message being received to
+    // the events being written to the input devices.
+    auto start = std::chrono::steady_clock::now();
+    if (msg.binary) {
+      std::vector<InputEvent> events = CF_EXPECT(
+          DecodeBinaryInput(msg.data.cdata(), msg.size(), KeyboardCode));
+      CoalesceMotionEvents(events);
+      CF_EXPECT(observer()->OnInputEvents(events));
+      binary_latency_.Record(std::chrono::steady_clock::now() - start);
+    } else {
+      CF_EXPECT(OnJsonMessage(msg));
+      json_latency_.Record(std::chrono::steady_clock::now() - start);
+    }
+    if ((binary_latency_.Count() + json_latency_.Count()) %
+            kLatencyLogInterval ==
+        0) {
+      VLOG(1) << LatencySummary();
+    }
+    return {};
+  }
+
+  void OnStateChangeInner(
+      webrtc::DataChannelInterface::DataState state) override {
+    if (state == webrtc::DataChannelInterface::kClosed) {
+      LOG(INFO) << LatencySummary();
+    }
+  }
+
+ private:
+  std::string LatencySummary() const {
+    return "Input latency, binary: " + binary_latency_.Summary() +
+           ", json: " + json_latency_.Summary();
+  }
+
+  Result<void> OnJsonMessage(const webrtc::DataBuffer &msg) {
     auto size = msg.size();
 
     Json::Value evt;
@@ -156,17 +214,8 @@ class InputChannelHandler : public DataChannelHandler {
       CF_EXPECT(
           observer()->OnMultiTouchEvent(label, idArr, xArr, yArr, down, size));
     } else if (event_type == "keyboard") {
-      auto cvd_config =
-          CF_EXPECT(CuttlefishConfig::Get(), "CuttlefishConfig is null!");
-      auto instance = cvd_config->ForDefaultInstance();
-      Json::Value domkey_mapping_config_json = instance.domkey_mapping_config();
       bool down = CF_EXPECT(get_str("event_type")) == std::string("keydown");
-      std::string keycode = CF_EXPECT(get_str("keycode"));
-      uint16_t code = DomKeyCodeToLinux(keycode);
-      if (domkey_mapping_config_json.isMember("mappings") &&
-          domkey_mapping_config_json["mappings"].isMember(keycode)) {
-        code = domkey_mapping_config_json["mappings"][keycode].asUInt();
-      }
+      uint16_t code = CF_EXPECT(KeyboardCode(CF_EXPECT(get_str("keycode"))));
 
       CF_EXPECT(observer()->OnKeyboardEvent(code, down));
     } else if (event_type == "wheel") {
@@ -178,6 +227,9 @@ class InputChannelHandler : public DataChannelHandler {
     }
     return {};
   }
+
+  LatencyHistogram binary_latency_;
+  LatencyHistogram json_latency_;
 };
 
 class ControlChannelHandler : public DataChannelHandler {
@@ -262,7 +314,7 @@ class AdbChannelHandler : public DataChannelHandler {
     // Report the adb channel as open on the first message received instead of
     // at channel open, this avoids unnecessarily connecting to the adb daemon
     // for clients that don't use ADB.
-    observer()->OnAdbChannelOpen(GetBinarySender());
+    observer()->OnAdbChannelOpen(GetBinarySender(), GetBufferedAmount());
   }
 };
 
@@ -276,7 +328,8 @@ class BluetoothChannelHandler : public DataChannelHandler {
     // Notify bluetooth channel opening when actually using the channel,
     // it has the same reason with AdbChannelHandler::OnMessageInner,
     // to avoid unnecessary connection for Rootcanal.
-    observer()->OnBluetoothChannelOpen(GetBinarySender());
+    observer()->OnBluetoothChannelOpen(GetBinarySender(),
+                                       GetBufferedAmount());
   }
 };
 
@@ -413,10 +466,9 @@ class DataChannelHandlerImpl : public H {
 
 bool DataChannelHandler::Send(const uint8_t *msg, size_t size, bool binary) {
   webrtc::DataBuffer buffer(rtc::CopyOnWriteBuffer(msg, size), binary);
-  // TODO (b/185832105): When the SCTP channel is congested data channel
-  // messages are buffered up to 16MB, when the buffer is full the channel
-  // is abruptly closed. Keep track of the buffered data to avoid losing the
-  // adb data channel.
+  // When the SCTP channel is congested data channel messages are buffered up
+  // to 16MB, when the buffer is full the channel is abruptly closed. Senders
+  // of bulk data, like adb, watch GetBufferedAmount() to avoid that.
   return channel()->Send(buffer);
 }
 
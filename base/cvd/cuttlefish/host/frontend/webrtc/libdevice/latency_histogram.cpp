@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/frontend/webrtc/libdevice/latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "fmt/format.h"
+
+namespace cuttlefish {
+namespace webrtc_streaming {
+
+void LatencyHistogram::Record(std::chrono::steady_clock::duration latency) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency);
+  uint64_t value = std::max<int64_t>(us.count(), 0);
+  // Bucket i holds values in [2^(i-1), 2^i).
+  size_t bucket = std::min<size_t>(std::bit_width(value), buckets_.size() - 1);
+  buckets_[bucket]++;
+  count_++;
+  max_ = std::max(max_, us);
+}
+
+std::chrono::microseconds LatencyHistogram::Percentile(
+    double percentile) const {
+  if (count_ == 0) {
+    return std::chrono::microseconds(0);
+  }
+  uint64_t rank = std::max<uint64_t>(percentile / 100 * count_, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return std::min(std::chrono::microseconds(uint64_t{1} << i), max_);
+    }
+  }
+  return max_;
+}
+
+std::string LatencyHistogram::Summary() const {
+  return fmt::format("count={} p50<={}us p90<={}us p99<={}us max={}us", count_,
+                     Percentile(50).count(), Percentile(90).count(),
+                     Percentile(99).count(), max_.count());
+}
+
+}  // namespace webrtc_streaming
+}  // namespace cuttlefish
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace cuttlefish {
+namespace webrtc_streaming {
+
+// Counts latencies in power of two microsecond buckets. Cheap enough to record
+// every input event, percentiles are reported as the upper bound of the bucket
+// they fall in. Not thread safe.
+class LatencyHistogram {
+ public:
+  void Record(std::chrono::steady_clock::duration latency);
+
+  uint64_t Count() const { return count_; }
+  std::chrono::microseconds Percentile(double percentile) const;
+  // e.g. "count=120 p50<=64us p90<=128us p99<=512us max=401us"
+  std::string Summary() const;
+
+ private:
+  // The last bucket holds everything from ~18 minutes up.
+  std::array<uint64_t, 32> buckets_{};
+  uint64_t count_ = 0;
+  std::chrono::microseconds max_{0};
+};
+
+}  // namespace webrtc_streaming
+}  // namespace cuttlefish
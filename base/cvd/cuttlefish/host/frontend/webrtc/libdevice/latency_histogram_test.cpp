@@ -0,0 +1,97 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/frontend/webrtc/libdevice/latency_histogram.h"
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+namespace cuttlefish {
+namespace webrtc_streaming {
+namespace {
+
+using std::chrono::hours;
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+  LatencyHistogram histogram;
+
+  EXPECT_EQ(histogram.Count(), 0);
+  EXPECT_EQ(histogram.Percentile(50), microseconds(0));
+  EXPECT_EQ(histogram.Summary(),
+            "count=0 p50<=0us p90<=0us p99<=0us max=0us");
+}
+
+TEST(LatencyHistogramTest, PercentilesAreBucketUpperBounds) {
+  LatencyHistogram histogram;
+  // 90 samples in [64, 128) and 10 in [512, 1024).
+  for (int i = 0; i < 90; i++) {
+    histogram.Record(microseconds(100));
+  }
+  for (int i = 0; i < 10; i++) {
+    histogram.Record(microseconds(1000));
+  }
+
+  EXPECT_EQ(histogram.Count(), 100);
+  EXPECT_EQ(histogram.Percentile(50), microseconds(128));
+  EXPECT_EQ(histogram.Percentile(90), microseconds(128));
+  // Clamped to the largest recorded value rather than the bucket bound.
+  EXPECT_EQ(histogram.Percentile(91), microseconds(1000));
+  EXPECT_EQ(histogram.Summary(),
+            "count=100 p50<=128us p90<=128us p99<=1000us max=1000us");
+}
+
+TEST(LatencyHistogramTest, BucketBoundaries) {
+  LatencyHistogram histogram;
+  // 2^6 is the first value of the [64, 128) bucket.
+  histogram.Record(microseconds(64));
+  histogram.Record(microseconds(200));
+  EXPECT_EQ(histogram.Percentile(50), microseconds(128));
+
+  LatencyHistogram below;
+  below.Record(microseconds(63));
+  below.Record(microseconds(200));
+  EXPECT_EQ(below.Percentile(50), microseconds(64));
+}
+
+TEST(LatencyHistogramTest, TinyPercentilesUseTheFirstSample) {
+  LatencyHistogram histogram;
+  histogram.Record(microseconds(3));
+  histogram.Record(microseconds(300));
+
+  EXPECT_EQ(histogram.Percentile(0), microseconds(4));
+}
+
+TEST(LatencyHistogramTest, SubMicrosecondAndNegativeLatencies) {
+  LatencyHistogram histogram;
+  histogram.Record(nanoseconds(500));
+  histogram.Record(nanoseconds(-500));
+
+  EXPECT_EQ(histogram.Count(), 2);
+  EXPECT_EQ(histogram.Percentile(100), microseconds(0));
+}
+
+TEST(LatencyHistogramTest, HugeLatenciesGoToTheLastBucket) {
+  LatencyHistogram histogram;
+  histogram.Record(hours(10));
+
+  EXPECT_EQ(histogram.Percentile(100), microseconds(uint64_t{1} << 31));
+}
+
+}  // namespace
+}  // namespace webrtc_streaming
+}  // namespace cuttlefish
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string_view>
+#include <thread>
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -30,6 +31,7 @@
 #include "google/rpc/status.pb.h"
 #include "rtc_base/logging.h"
 
+#include "cuttlefish/common/libs/fs/reactor.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/common/libs/utils/files.h"
 #include "cuttlefish/host/commands/assemble_cvd/proto/guest_config.pb.h"
@@ -55,6 +57,7 @@
 #include "cuttlefish/host/libs/input_connector/input_connector.h"
 #include "cuttlefish/host/libs/screen_connector/composition_manager.h"
 #include "cuttlefish/host/libs/screen_connector/screen_connector.h"
+#include "cuttlefish/result/result.h"
 
 DEFINE_bool(multitouch, true,
             "Whether to send multi-touch or single-touch events");
@@ -422,9 +425,19 @@ int CuttlefishMain() {
 
   webrtc_streaming::SensorsHandler sensors_handler(sensors_fd);
 
+  // Data from adb and bluetooth is forwarded to every client from this one
+  // thread.
+  Result<std::unique_ptr<Reactor>> byte_stream_reactor = Reactor::Create();
+  CHECK(byte_stream_reactor.ok())
+      << "Failed to create reactor: " << byte_stream_reactor.error();
+  std::thread byte_stream_thread([&reactor = **byte_stream_reactor]() {
+    Result<void> run = reactor.Run();
+    CHECK(run.ok()) << "Byte stream reactor failed: " << run.error();
+  });
+
   auto observer_factory = std::make_shared<CfConnectionObserverFactory>(
       confui_virtual_input, kernel_logs_event_handler, sensors_handler,
-      lights_observer);
+      lights_observer, **byte_stream_reactor);
 
   RecordingManager recording_manager;
 
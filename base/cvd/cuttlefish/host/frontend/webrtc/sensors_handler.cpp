@@ -16,8 +16,6 @@
 
 #include "cuttlefish/host/frontend/webrtc/sensors_handler.h"
 
-#include <string.h>
-
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -37,19 +35,14 @@ static constexpr sensors::SensorsMask kMotionSensors =
 }  // namespace
 
 SensorsHandler::SensorsHandler(SharedFD sensors_fd)
-    : channel_(transport::SharedFdChannel(sensors_fd, sensors_fd)) {}
+    : channel_(transport::SharedFdChannel(sensors_fd, sensors_fd,
+                                          /* read_ahead */ true)) {}
 
 SensorsHandler::~SensorsHandler() {}
 
 Result<void> SensorsHandler::SendCommand(uint32_t cmd,
                                          std::string_view payload) {
-  size_t size = payload.size();
-  transport::ManagedMessage request = CF_EXPECT(
-      transport::CreateMessage(cmd, size),
-      "Failed to allocate message for cmd: " << cmd << " with size: " << size
-                                             << " bytes. ");
-  memcpy(request->payload, payload.data(), size);
-  CF_EXPECT(channel_.SendRequest(*request),
+  CF_EXPECT(channel_.SendRequest(cmd, payload),
             "Can't send request for cmd: " << cmd);
   return {};
 }
@@ -18,12 +18,27 @@
 #include "cuttlefish/host/libs/avb/avb.h"
 
 #include <fcntl.h>
+#include <openssl/rand.h>
+#include <stdint.h>
+#include <sys/mman.h>
 
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/log/log.h"
+#include "absl/strings/numbers.h"
+#include "android-base/hex.h"
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/host/libs/avb/hashtree.h"
+#include "cuttlefish/host/libs/avb/vbmeta.h"
+#include "cuttlefish/host/libs/config/config_utils.h"
 #include "cuttlefish/host/libs/config/known_paths.h"
 #include "cuttlefish/process/command.h"
 #include "cuttlefish/result/result.h"
@@ -31,12 +46,170 @@
 namespace cuttlefish {
 namespace {
 
-constexpr char kAddHashFooter[] = "add_hash_footer";
 constexpr char kDefaultAlgorithm[] = "SHA256_RSA4096";
 constexpr char kMakeVbmetaImage[] = "make_vbmeta_image";
 // Taken from external/avb/libavb/avb_slot_verify.c; this define is not in the
 // headers
 constexpr size_t kVbMetaMaxSize = 65536ul;
+// avbtool's default for add_hashtree_footer
+constexpr uint32_t kFecNumRoots = 2;
+
+uint64_t RoundUp(uint64_t value, uint64_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+// Read-only view of the first `size` bytes of an image.
+class MappedImage {
+ public:
+  static Result<MappedImage> Map(SharedFD image, uint64_t size) {
+    if (size == 0) {
+      return MappedImage(ScopedMMap(), 0);
+    }
+    ScopedMMap mapping = image->MMap(nullptr, size, PROT_READ, MAP_SHARED, 0);
+    CF_EXPECTF(static_cast<bool>(mapping), "Failed to mmap image: {}",
+               image->StrError());
+    return MappedImage(std::move(mapping), size);
+  }
+
+  std::span<const uint8_t> Data() const {
+    if (size_ == 0) {
+      return {};
+    }
+    return {static_cast<const uint8_t*>(mapping_.get()), size_};
+  }
+
+ private:
+  MappedImage(ScopedMMap mapping, uint64_t size)
+      : mapping_(std::move(mapping)), size_(size) {}
+
+  ScopedMMap mapping_;
+  uint64_t size_;
+};
+
+Result<void> WriteAt(SharedFD image, std::span<const uint8_t> data,
+                     uint64_t offset) {
+  while (!data.empty()) {
+    ssize_t written = image->PWrite(data.data(), data.size(), offset);
+    CF_EXPECTF(written > 0, "Failed to write at offset {}: {}", offset,
+               image->StrError());
+    data = data.subspan(written);
+    offset += written;
+  }
+  return {};
+}
+
+// Strips a footer left by a previous signing, returning the unsigned size.
+Result<uint64_t> TruncateExistingFooter(SharedFD image) {
+  std::optional<uint64_t> original_size =
+      CF_EXPECT(AvbOriginalImageSize(image));
+  if (original_size) {
+    CF_EXPECTF(image->Truncate(*original_size) == 0,
+               "Failed to remove existing footer: {}", image->StrError());
+    return *original_size;
+  }
+  off_t size = image->LSeek(0, SEEK_END);
+  CF_EXPECT_GE(size, 0, image->StrError());
+  return size;
+}
+
+Result<std::vector<uint8_t>> MakeSalt(const std::string& salt_hex) {
+  std::vector<uint8_t> salt;
+  if (!salt_hex.empty()) {
+    CF_EXPECTF(android::base::HexToBytes(salt_hex, &salt),
+               "Invalid salt '{}'", salt_hex);
+    return salt;
+  }
+  salt.resize(kSha256DigestSize);
+  CF_EXPECT(RAND_bytes(salt.data(), salt.size()) == 1);
+  return salt;
+}
+
+// Reed-Solomon data over the image and its hashtree, produced by the same
+// `fec` host binary avbtool would invoke.
+Result<std::vector<uint8_t>> GenerateFec(const std::string& image_path) {
+  const std::string fec_path = image_path + ".fec";
+  Command fec_cmd(HostBinaryPath("fec"));
+  fec_cmd.AddParameter("--encode")
+      .AddParameter("--roots")
+      .AddParameter(kFecNumRoots)
+      .AddParameter(image_path)
+      .AddParameter(fec_path);
+  int exit_code = fec_cmd.Start().Wait();
+  CF_EXPECTF(exit_code == 0, "Failure running {}. Exited with status {}",
+             fec_cmd.Executable(), exit_code);
+  std::string fec = CF_EXPECT(ReadFileContents(fec_path));
+  CF_EXPECT(RemoveFile(fec_path));
+  return std::vector<uint8_t>(fec.begin(), fec.end());
+}
+
+// Writes `vbmeta` at `vbmeta_offset` followed by a footer block, which ends
+// the image at `partition_size` or right after the vbmeta when that is zero.
+Result<void> AppendVbMetaAndFooter(SharedFD image, uint64_t original_size,
+                                   uint64_t vbmeta_offset,
+                                   std::vector<uint8_t> vbmeta,
+                                   uint64_t partition_size) {
+  const uint64_t vbmeta_size = vbmeta.size();
+  vbmeta.resize(RoundUp(vbmeta_size, kAvbBlockSize), 0);
+  const uint64_t vbmeta_end = vbmeta_offset + vbmeta.size();
+  const uint64_t footer_offset =
+      partition_size > 0 ? partition_size - kAvbBlockSize : vbmeta_end;
+  CF_EXPECT_GE(footer_offset, vbmeta_end, "Partition size is too small");
+
+  // Zero fills any gap between the image data and the vbmeta.
+  CF_EXPECTF(image->Truncate(vbmeta_offset) == 0, "Failed to resize: {}",
+             image->StrError());
+  CF_EXPECT(WriteAt(image, vbmeta, vbmeta_offset));
+
+  std::vector<uint8_t> footer(kAvbBlockSize - kAvbFooterSize, 0);
+  std::vector<uint8_t> encoded =
+      EncodeAvbFooter(original_size, vbmeta_offset, vbmeta_size);
+  footer.insert(footer.end(), encoded.begin(), encoded.end());
+  CF_EXPECT(WriteAt(image, footer, footer_offset));
+  return {};
+}
+
+struct VbMetaImageOptions {
+  uint64_t padding_size = 0;
+  uint64_t rollback_index = 0;
+  uint32_t rollback_index_location = 0;
+  uint32_t flags = 0;
+};
+
+Result<bool> ParseVbMetaImageOption(const std::string& name,
+                                    const std::string& value,
+                                    VbMetaImageOptions& options) {
+  if (name == "--padding_size") {
+    return absl::SimpleAtoi(value, &options.padding_size);
+  } else if (name == "--rollback_index") {
+    return absl::SimpleAtoi(value, &options.rollback_index);
+  } else if (name == "--rollback_index_location") {
+    return absl::SimpleAtoi(value, &options.rollback_index_location);
+  } else if (name == "--flags") {
+    return absl::SimpleAtoi(value, &options.flags);
+  }
+  return CF_ERRF("Unsupported argument '{}'", name);
+}
+
+// Accepts the subset of `avbtool make_vbmeta_image` arguments that the native
+// implementation understands, in either `--flag value` or `--flag=value` form.
+Result<VbMetaImageOptions> ParseVbMetaImageOptions(
+    const std::vector<std::string>& arguments) {
+  VbMetaImageOptions options;
+  for (size_t i = 0; i < arguments.size(); i++) {
+    std::string name = arguments[i];
+    std::string value;
+    if (auto equals = name.find('='); equals != std::string::npos) {
+      value = name.substr(equals + 1);
+      name = name.substr(0, equals);
+    } else {
+      CF_EXPECTF(i + 1 < arguments.size(), "Missing value for '{}'", name);
+      value = arguments[++i];
+    }
+    CF_EXPECTF(CF_EXPECT(ParseVbMetaImageOption(name, value, options)),
+               "Invalid value '{}' for '{}'", value, name);
+  }
+  return options;
+}
 
 }  // namespace
 
@@ -50,40 +223,85 @@ Avb::Avb(std::string avbtool_path, std::string algorithm, std::string key)
       algorithm_(std::move(algorithm)),
       key_(std::move(key)) {}
 
-Command Avb::GenerateAddHashFooter(const std::string& image_path,
-                                   const std::string& partition_name,
-                                   const off_t partition_size_bytes) const {
-  Command command(avbtool_path_);
-  command.AddParameter(kAddHashFooter);
-  if (!algorithm_.empty()) {
-    command.AddParameter("--algorithm");
-    command.AddParameter(algorithm_);
-  }
-  if (!key_.empty()) {
-    command.AddParameter("--key");
-    command.AddParameter(key_);
-  }
-  command.AddParameter("--image");
-  command.AddParameter(image_path);
-  command.AddParameter("--partition_name");
-  command.AddParameter(partition_name);
-  if (partition_size_bytes > 0) {
-    command.AddParameter("--partition_size");
-    command.AddParameter(partition_size_bytes);
-  } else {
-    command.AddParameter("--dynamic_partition_size");
-  }
-  return command;
-}
-
 Result<void> Avb::AddHashFooter(const std::string& image_path,
                                 const std::string& partition_name,
                                 const off_t partition_size_bytes) const {
-  auto command =
-      GenerateAddHashFooter(image_path, partition_name, partition_size_bytes);
-  int exit_code = command.Start().Wait();
-  CF_EXPECTF(exit_code == 0, "Failure running {} {}. Exited with status {}",
-             command.Executable(), kAddHashFooter, exit_code);
+  SharedFD image = SharedFD::Open(image_path, O_RDWR);
+  CF_EXPECTF(image->IsOpen(), "Failed to open '{}': {}", image_path,
+             image->StrError());
+  const uint64_t image_size = CF_EXPECT(TruncateExistingFooter(image));
+  const uint64_t partition_size =
+      partition_size_bytes > 0
+          ? partition_size_bytes
+          : RoundUp(image_size + kMaxAvbMetadataSize, kAvbBlockSize);
+  CF_EXPECTF(partition_size % kAvbBlockSize == 0,
+             "Partition size {} is not a multiple of {}", partition_size,
+             kAvbBlockSize);
+  CF_EXPECTF(image_size + kMaxAvbMetadataSize <= partition_size,
+             "'{}' of size {} does not fit in a partition of size {}",
+             image_path, image_size, partition_size);
+
+  AvbHashDescriptorSpec descriptor{
+      .image_size = image_size,
+      .partition_name = partition_name,
+      .salt = CF_EXPECT(MakeSalt("")),
+  };
+  {
+    MappedImage mapped = CF_EXPECT(MappedImage::Map(image, image_size));
+    descriptor.digest = SaltedSha256(mapped.Data(), descriptor.salt);
+  }
+
+  VbMetaBuilder vbmeta;
+  vbmeta.SetAlgorithm(algorithm_, key_).AddDescriptor(
+      EncodeDescriptor(descriptor));
+  CF_EXPECT(AppendVbMetaAndFooter(image, image_size,
+                                  RoundUp(image_size, kAvbBlockSize),
+                                  CF_EXPECT(vbmeta.Build()), partition_size));
+  return {};
+}
+
+Result<void> Avb::AddHashtreeFooter(const std::string& image_path,
+                                    const std::string& partition_name,
+                                    const std::string& salt_hex) const {
+  SharedFD image = SharedFD::Open(image_path, O_RDWR);
+  CF_EXPECTF(image->IsOpen(), "Failed to open '{}': {}", image_path,
+             image->StrError());
+  const uint64_t original_size = CF_EXPECT(TruncateExistingFooter(image));
+  const uint64_t image_size = RoundUp(original_size, kAvbBlockSize);
+  CF_EXPECTF(image->Truncate(image_size) == 0, "Failed to grow '{}': {}",
+             image_path, image->StrError());
+
+  AvbHashtreeDescriptorSpec descriptor{
+      .image_size = image_size,
+      .tree_offset = image_size,
+      .data_block_size = kAvbBlockSize,
+      .hash_block_size = kAvbBlockSize,
+      .partition_name = partition_name,
+      .salt = CF_EXPECT(MakeSalt(salt_hex)),
+  };
+  {
+    MappedImage mapped = CF_EXPECT(MappedImage::Map(image, image_size));
+    Hashtree hashtree =
+        CF_EXPECT(CalculateHashtree(mapped.Data(), descriptor.salt));
+    descriptor.tree_size = hashtree.tree.size();
+    descriptor.root_digest = std::move(hashtree.root_digest);
+    CF_EXPECT(WriteAt(image, hashtree.tree, image_size));
+  }
+  uint64_t end = image_size + descriptor.tree_size;
+
+  std::vector<uint8_t> fec = CF_EXPECT(GenerateFec(image_path));
+  descriptor.fec_num_roots = kFecNumRoots;
+  descriptor.fec_offset = end;
+  descriptor.fec_size = fec.size();
+  fec.resize(RoundUp(fec.size(), kAvbBlockSize), 0);
+  CF_EXPECT(WriteAt(image, fec, end));
+  end += fec.size();
+
+  VbMetaBuilder vbmeta;
+  vbmeta.SetAlgorithm(algorithm_, key_).AddDescriptor(
+      EncodeDescriptor(descriptor));
+  CF_EXPECT(AppendVbMetaAndFooter(image, original_size, end,
+                                  CF_EXPECT(vbmeta.Build()), 0));
   return {};
 }
 
@@ -123,11 +341,51 @@ Result<void> Avb::MakeVbMetaImage(
     const std::vector<ChainPartition>& chained_partitions,
     const std::vector<std::string>& included_partitions,
     const std::vector<std::string>& extra_arguments) {
-  auto command = GenerateMakeVbMetaImage(output_path, chained_partitions,
-                                         included_partitions, extra_arguments);
-  int exit_code = command.Start().Wait();
-  CF_EXPECTF(exit_code == 0, "Failure running {} {}. Exited with status {}",
-             command.Executable(), kMakeVbmetaImage, exit_code);
+  Result<VbMetaImageOptions> options = ParseVbMetaImageOptions(extra_arguments);
+  if (!options.ok()) {
+    VLOG(0) << "Using avbtool for vbmeta image: " << options.error().Message();
+    auto command =
+        GenerateMakeVbMetaImage(output_path, chained_partitions,
+                                included_partitions, extra_arguments);
+    int exit_code = command.Start().Wait();
+    CF_EXPECTF(exit_code == 0, "Failure running {} {}. Exited with status {}",
+               command.Executable(), kMakeVbmetaImage, exit_code);
+    CF_EXPECT(EnforceVbMetaSize(output_path));
+    return {};
+  }
+
+  VbMetaBuilder vbmeta;
+  vbmeta.SetAlgorithm(algorithm_, key_)
+      .SetRollbackIndex(options->rollback_index)
+      .SetRollbackIndexLocation(options->rollback_index_location)
+      .SetFlags(options->flags);
+  for (const auto& partition : chained_partitions) {
+    AvbChainPartitionDescriptorSpec descriptor{
+        .partition_name = partition.name,
+    };
+    CF_EXPECTF(absl::SimpleAtoi(partition.rollback_index,
+                                &descriptor.rollback_index_location),
+               "Invalid rollback index location '{}' for '{}'",
+               partition.rollback_index, partition.name);
+    std::string public_key = CF_EXPECT(ReadFileContents(partition.key_path));
+    descriptor.public_key.assign(public_key.begin(), public_key.end());
+    vbmeta.AddDescriptor(EncodeDescriptor(descriptor));
+  }
+  for (const auto& partition : included_partitions) {
+    CF_EXPECT(vbmeta.IncludeDescriptorsFromImage(partition));
+  }
+  std::vector<uint8_t> blob = CF_EXPECT(vbmeta.Build());
+  if (options->padding_size > 0) {
+    blob.resize(RoundUp(blob.size(), options->padding_size), 0);
+  }
+
+  SharedFD output =
+      SharedFD::Open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  CF_EXPECTF(output->IsOpen(), "Failed to open '{}': {}", output_path,
+             output->StrError());
+  CF_EXPECT_EQ(WriteAll(output, reinterpret_cast<const char*>(blob.data()),
+                        blob.size()),
+               blob.size(), output->StrError());
   CF_EXPECT(EnforceVbMetaSize(output_path));
   return {};
 }
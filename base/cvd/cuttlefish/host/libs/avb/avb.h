@@ -53,6 +53,19 @@ class Avb {
   Result<void> AddHashFooter(const std::string& image_path,
                              const std::string& partition_name,
                              off_t partition_size_bytes) const;
+  /**
+   * AddHashtreeFooter - add a dm-verity hashtree, FEC data and a footer to the
+   * image, growing it only as much as needed
+   *
+   * @image_path: path to image to sign
+   * @partition_name: partition name (without A/B suffix)
+   * @salt_hex: hex encoded salt, random if empty
+   */
+  Result<void> AddHashtreeFooter(const std::string& image_path,
+                                 const std::string& partition_name,
+                                 const std::string& salt_hex) const;
+  // Falls back to avbtool when `extra_arguments` contains options that are
+  // not implemented natively.
   Result<void> MakeVbMetaImage(
       const std::string& output_path,
       const std::vector<ChainPartition>& chained_partitions,
@@ -60,9 +73,6 @@ class Avb {
       const std::vector<std::string>& extra_arguments);
 
  private:
-  Command GenerateAddHashFooter(const std::string& image_path,
-                                const std::string& partition_name,
-                                off_t partition_size_bytes) const;
   Command GenerateInfoImage(const std::string& image_path,
                             const SharedFD& output_path) const;
   Command GenerateMakeVbMetaImage(
@@ -0,0 +1,153 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/avb/hashtree.h"
+
+#include <openssl/sha.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "cuttlefish/result/expect.h"
+#include "cuttlefish/result/result_type.h"
+
+namespace cuttlefish {
+namespace {
+
+// Below this many blocks per level it is cheaper to hash on the calling thread
+// than to hand work out to other threads.
+constexpr size_t kMinBlocksPerThread = 256;
+
+uint64_t RoundUp(uint64_t value, uint64_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+// Sizes of every level of the tree, starting from the level that hashes the
+// image data.
+std::vector<uint64_t> LevelSizes(uint64_t image_size, size_t block_size) {
+  std::vector<uint64_t> sizes;
+  uint64_t size = image_size;
+  while (size > block_size) {
+    uint64_t num_blocks = (size + block_size - 1) / block_size;
+    size = RoundUp(num_blocks * kSha256DigestSize, block_size);
+    sizes.push_back(size);
+  }
+  return sizes;
+}
+
+// Hashes blocks [first, last) of `src` into consecutive digests in `out`. The
+// salt has already been fed into `salted`, which is copied for every block.
+void HashBlockRange(const SHA256_CTX& salted, std::span<const uint8_t> src,
+                    size_t block_size, size_t first, size_t last,
+                    uint8_t* out) {
+  std::vector<uint8_t> padding(block_size, 0);
+  for (size_t block = first; block < last; block++) {
+    size_t offset = block * block_size;
+    size_t len = std::min(block_size, src.size() - offset);
+    SHA256_CTX ctx = salted;
+    SHA256_Update(&ctx, src.data() + offset, len);
+    if (len < block_size) {
+      SHA256_Update(&ctx, padding.data(), block_size - len);
+    }
+    SHA256_Final(out + block * kSha256DigestSize, &ctx);
+  }
+}
+
+void HashLevel(const SHA256_CTX& salted, std::span<const uint8_t> src,
+               size_t block_size, size_t num_threads, uint8_t* out) {
+  size_t num_blocks = (src.size() + block_size - 1) / block_size;
+  size_t workers = std::clamp<size_t>(num_blocks / kMinBlocksPerThread, 1,
+                                      num_threads);
+  if (workers == 1) {
+    HashBlockRange(salted, src, block_size, 0, num_blocks, out);
+    return;
+  }
+  size_t per_worker = (num_blocks + workers - 1) / workers;
+  std::vector<std::future<void>> pending;
+  for (size_t first = per_worker; first < num_blocks; first += per_worker) {
+    size_t last = std::min(first + per_worker, num_blocks);
+    pending.emplace_back(std::async(std::launch::async, HashBlockRange,
+                                    std::cref(salted), src, block_size, first,
+                                    last, out));
+  }
+  HashBlockRange(salted, src, block_size, 0, std::min(per_worker, num_blocks),
+                 out);
+  for (auto& worker : pending) {
+    worker.get();
+  }
+}
+
+}  // namespace
+
+uint64_t HashtreeSize(uint64_t image_size, size_t block_size) {
+  uint64_t total = 0;
+  for (uint64_t level_size : LevelSizes(image_size, block_size)) {
+    total += level_size;
+  }
+  return total;
+}
+
+Result<Hashtree> CalculateHashtree(std::span<const uint8_t> image,
+                                   std::span<const uint8_t> salt,
+                                   size_t block_size, size_t num_threads) {
+  CF_EXPECT_GE(block_size, kSha256DigestSize);
+  CF_EXPECT_EQ(block_size % kSha256DigestSize, 0);
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  SHA256_CTX salted;
+  SHA256_Init(&salted);
+  SHA256_Update(&salted, salt.data(), salt.size());
+
+  std::vector<uint64_t> level_sizes = LevelSizes(image.size(), block_size);
+  Hashtree hashtree;
+  hashtree.tree.resize(HashtreeSize(image.size(), block_size), 0);
+
+  // Levels are stored highest first, so the first level computed goes last.
+  uint64_t level_offset = hashtree.tree.size();
+  std::span<const uint8_t> src = image;
+  for (uint64_t level_size : level_sizes) {
+    level_offset -= level_size;
+    uint8_t* level = hashtree.tree.data() + level_offset;
+    HashLevel(salted, src, block_size, num_threads, level);
+    src = std::span<const uint8_t>(level, level_size);
+  }
+
+  // The remaining level fits in a single block, which is zero padded if the
+  // image itself was smaller than a block.
+  hashtree.root_digest.resize(kSha256DigestSize);
+  HashBlockRange(salted, src, block_size, 0, 1, hashtree.root_digest.data());
+  return hashtree;
+}
+
+std::vector<uint8_t> SaltedSha256(std::span<const uint8_t> data,
+                                  std::span<const uint8_t> salt) {
+  SHA256_CTX ctx;
+  SHA256_Init(&ctx);
+  SHA256_Update(&ctx, salt.data(), salt.size());
+  SHA256_Update(&ctx, data.data(), data.size());
+  std::vector<uint8_t> digest(kSha256DigestSize);
+  SHA256_Final(digest.data(), &ctx);
+  return digest;
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,55 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <span>
+#include <vector>
+
+#include "cuttlefish/result/result_type.h"
+
+namespace cuttlefish {
+
+inline constexpr size_t kAvbBlockSize = 4096;
+inline constexpr size_t kSha256DigestSize = 32;
+
+struct Hashtree {
+  // All levels except the root, highest level first, as laid out on disk by
+  // avbtool. Each level is padded to a multiple of the block size.
+  std::vector<uint8_t> tree;
+  std::vector<uint8_t> root_digest;
+};
+
+// Size of the tree (excluding the root digest) that `CalculateHashtree` will
+// produce for an image of `image_size` bytes.
+uint64_t HashtreeSize(uint64_t image_size, size_t block_size = kAvbBlockSize);
+
+// Computes the dm-verity SHA-256 Merkle tree of `image` in the layout used by
+// `avbtool add_hashtree_footer`. Every hash is `SHA256(salt || block)`, with
+// the last block of each level zero-padded. Each level is hashed in parallel
+// across `num_threads` workers, with 0 meaning one per available core.
+Result<Hashtree> CalculateHashtree(std::span<const uint8_t> image,
+                                   std::span<const uint8_t> salt,
+                                   size_t block_size = kAvbBlockSize,
+                                   size_t num_threads = 0);
+
+// `SHA256(salt || data)`, as used for `avbtool add_hash_footer`.
+std::vector<uint8_t> SaltedSha256(std::span<const uint8_t> data,
+                                  std::span<const uint8_t> salt);
+
+}  // namespace cuttlefish
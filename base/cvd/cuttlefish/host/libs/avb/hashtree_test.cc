@@ -0,0 +1,96 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/avb/hashtree.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr size_t kBlock = 4096;
+
+std::vector<uint8_t> Pattern(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; i++) {
+    data[i] = static_cast<uint8_t>(i * 31 + i / kBlock);
+  }
+  return data;
+}
+
+TEST(HashtreeTest, SizeMatchesAvbtoolLevels) {
+  EXPECT_EQ(HashtreeSize(kBlock), 0);
+  EXPECT_EQ(HashtreeSize(2 * kBlock), kBlock);
+  // 129 data blocks need two blocks of digests, which need one more level.
+  EXPECT_EQ(HashtreeSize(129 * kBlock), 3 * kBlock);
+}
+
+TEST(HashtreeTest, TwoBlockImage) {
+  std::vector<uint8_t> image = Pattern(2 * kBlock);
+  std::vector<uint8_t> salt = {1, 2, 3, 4};
+
+  Result<Hashtree> hashtree = CalculateHashtree(image, salt);
+  ASSERT_THAT(hashtree, IsOk());
+
+  std::vector<uint8_t> level(kBlock, 0);
+  std::vector<uint8_t> first = SaltedSha256(
+      std::span<const uint8_t>(image).subspan(0, kBlock), salt);
+  std::vector<uint8_t> second = SaltedSha256(
+      std::span<const uint8_t>(image).subspan(kBlock, kBlock), salt);
+  std::copy(first.begin(), first.end(), level.begin());
+  std::copy(second.begin(), second.end(), level.begin() + first.size());
+
+  EXPECT_EQ(hashtree->tree, level);
+  EXPECT_EQ(hashtree->root_digest, SaltedSha256(level, salt));
+}
+
+TEST(HashtreeTest, PartialLastBlockIsZeroPadded) {
+  std::vector<uint8_t> image = Pattern(kBlock + 10);
+  std::vector<uint8_t> padded = image;
+  padded.resize(2 * kBlock, 0);
+
+  Result<Hashtree> partial = CalculateHashtree(image, {});
+  Result<Hashtree> full = CalculateHashtree(padded, {});
+  ASSERT_THAT(partial, IsOk());
+  ASSERT_THAT(full, IsOk());
+
+  EXPECT_EQ(partial->tree, full->tree);
+  EXPECT_EQ(partial->root_digest, full->root_digest);
+}
+
+TEST(HashtreeTest, ParallelMatchesSingleThreaded) {
+  std::vector<uint8_t> image = Pattern(1000 * kBlock + 123);
+  std::vector<uint8_t> salt(32, 0xab);
+
+  Result<Hashtree> serial = CalculateHashtree(image, salt, kBlock, 1);
+  Result<Hashtree> parallel = CalculateHashtree(image, salt, kBlock, 7);
+  ASSERT_THAT(serial, IsOk());
+  ASSERT_THAT(parallel, IsOk());
+
+  EXPECT_EQ(serial->tree.size(), HashtreeSize(image.size()));
+  EXPECT_EQ(serial->tree, parallel->tree);
+  EXPECT_EQ(serial->root_digest, parallel->root_digest);
+}
+
+}  // namespace
+}  // namespace cuttlefish
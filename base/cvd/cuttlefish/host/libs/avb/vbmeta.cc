@@ -0,0 +1,512 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/avb/vbmeta.h"
+
+#include <fcntl.h>
+#include <openssl/bio.h>
+#include <openssl/bn.h>
+#include <openssl/nid.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+#include <openssl/sha.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fmt/format.h"
+#include "libavb/libavb.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/result/expect.h"
+#include "cuttlefish/result/result_type.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr size_t kVbMetaHeaderSize = 256;
+constexpr size_t kReleaseStringSize = 48;
+constexpr size_t kDescriptorHeaderSize = 16;
+
+constexpr uint64_t kDescriptorTagHashtree = 1;
+constexpr uint64_t kDescriptorTagHash = 2;
+constexpr uint64_t kDescriptorTagChainPartition = 4;
+
+struct AlgorithmInfo {
+  std::string_view name;
+  uint32_t type;
+  size_t hash_size;
+  size_t signature_size;
+  int hash_nid;
+};
+
+// Mirrors `ALGORITHMS` in avbtool.py and `AvbAlgorithmType` in libavb.
+constexpr AlgorithmInfo kAlgorithms[] = {
+    {"NONE", 0, 0, 0, 0},
+    {"SHA256_RSA2048", 1, 32, 256, NID_sha256},
+    {"SHA256_RSA4096", 2, 32, 512, NID_sha256},
+    {"SHA256_RSA8192", 3, 32, 1024, NID_sha256},
+    {"SHA512_RSA2048", 4, 64, 256, NID_sha512},
+    {"SHA512_RSA4096", 5, 64, 512, NID_sha512},
+    {"SHA512_RSA8192", 6, 64, 1024, NID_sha512},
+};
+
+Result<const AlgorithmInfo*> LookupAlgorithm(std::string_view name) {
+  for (const AlgorithmInfo& algorithm : kAlgorithms) {
+    if (algorithm.name == name) {
+      return &algorithm;
+    }
+  }
+  return CF_ERRF("Unknown AVB algorithm '{}'", name);
+}
+
+uint64_t RoundUp(uint64_t value, uint64_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+// Big-endian serialization matching python's `struct.pack('!...')`.
+class Encoder {
+ public:
+  Encoder& U32(uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      bytes_.push_back(static_cast<uint8_t>(value >> shift));
+    }
+    return *this;
+  }
+  Encoder& U64(uint64_t value) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      bytes_.push_back(static_cast<uint8_t>(value >> shift));
+    }
+    return *this;
+  }
+  // Fixed width field, truncated or zero padded to `width`.
+  Encoder& Fixed(std::string_view value, size_t width) {
+    size_t len = std::min(value.size(), width);
+    bytes_.insert(bytes_.end(), value.begin(), value.begin() + len);
+    return Zeros(width - len);
+  }
+  Encoder& Zeros(size_t count) {
+    bytes_.insert(bytes_.end(), count, 0);
+    return *this;
+  }
+  Encoder& Bytes(const std::vector<uint8_t>& value) {
+    bytes_.insert(bytes_.end(), value.begin(), value.end());
+    return *this;
+  }
+  Encoder& Bytes(std::string_view value) {
+    bytes_.insert(bytes_.end(), value.begin(), value.end());
+    return *this;
+  }
+
+  std::vector<uint8_t> Finish() { return std::move(bytes_); }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+uint32_t ReadU32(const uint8_t* data) {
+  return (uint32_t{data[0]} << 24) | (uint32_t{data[1]} << 16) |
+         (uint32_t{data[2]} << 8) | uint32_t{data[3]};
+}
+
+uint64_t ReadU64(const uint8_t* data) {
+  return (uint64_t{ReadU32(data)} << 32) | ReadU32(data + 4);
+}
+
+// Prepends the generic descriptor header and pads the whole descriptor to a
+// multiple of 8 bytes.
+std::vector<uint8_t> FinishDescriptor(uint64_t tag, std::vector<uint8_t> body) {
+  size_t padded = RoundUp(body.size(), 8);
+  body.resize(padded, 0);
+  std::vector<uint8_t> descriptor = Encoder().U64(tag).U64(padded).Finish();
+  descriptor.insert(descriptor.end(), body.begin(), body.end());
+  return descriptor;
+}
+
+// Encodes the public half of `rsa` as an `AvbRSAPublicKeyHeader` followed by
+// the modulus and the Montgomery constant R^2 mod n, as avbtool does.
+Result<std::vector<uint8_t>> EncodePublicKey(const RSA* rsa) {
+  const BIGNUM* n = RSA_get0_n(rsa);
+  const size_t num_bits = BN_num_bits(n);
+  CF_EXPECT_EQ(num_bits % 8, 0);
+  const size_t num_bytes = num_bits / 8;
+
+  uint32_t n0 = static_cast<uint32_t>(BN_mod_word(n, 1ull << 32));
+  // Newton iteration for the inverse of an odd number modulo 2^32.
+  uint32_t inverse = n0;
+  for (int i = 0; i < 5; i++) {
+    inverse *= 2 - n0 * inverse;
+  }
+  uint32_t n0inv = 0u - inverse;
+
+  std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)> ctx(BN_CTX_new(),
+                                                      BN_CTX_free);
+  std::unique_ptr<BIGNUM, decltype(&BN_free)> rr(BN_new(), BN_free);
+  std::unique_ptr<BIGNUM, decltype(&BN_free)> r(BN_new(), BN_free);
+  CF_EXPECT(ctx && rr && r);
+  CF_EXPECT(BN_set_bit(r.get(), 2 * num_bits));
+  CF_EXPECT(BN_mod(rr.get(), r.get(), n, ctx.get()));
+
+  std::vector<uint8_t> encoded =
+      Encoder().U32(num_bits).U32(n0inv).Zeros(2 * num_bytes).Finish();
+  uint8_t* n_end = encoded.data() + 8 + num_bytes;
+  BN_bn2bin(n, n_end - BN_num_bytes(n));
+  uint8_t* rr_end = n_end + num_bytes;
+  BN_bn2bin(rr.get(), rr_end - BN_num_bytes(rr.get()));
+  return encoded;
+}
+
+Result<std::unique_ptr<RSA, decltype(&RSA_free)>> LoadPrivateKey(
+    const std::string& key_path) {
+  std::string pem = CF_EXPECT(ReadFileContents(key_path));
+  std::unique_ptr<BIO, decltype(&BIO_free)> bio(
+      BIO_new_mem_buf(pem.data(), pem.size()), BIO_free);
+  CF_EXPECT(bio.get() != nullptr);
+  std::unique_ptr<RSA, decltype(&RSA_free)> rsa(
+      PEM_read_bio_RSAPrivateKey(bio.get(), nullptr, nullptr, nullptr),
+      RSA_free);
+  CF_EXPECTF(rsa.get() != nullptr, "Failed to parse RSA key '{}'", key_path);
+  return rsa;
+}
+
+std::vector<uint8_t> Digest(int nid, const std::vector<uint8_t>& header,
+                            const std::vector<uint8_t>& aux) {
+  std::vector<uint8_t> digest;
+  if (nid == NID_sha256) {
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, header.data(), header.size());
+    SHA256_Update(&ctx, aux.data(), aux.size());
+    digest.resize(SHA256_DIGEST_LENGTH);
+    SHA256_Final(digest.data(), &ctx);
+  } else {
+    SHA512_CTX ctx;
+    SHA512_Init(&ctx);
+    SHA512_Update(&ctx, header.data(), header.size());
+    SHA512_Update(&ctx, aux.data(), aux.size());
+    digest.resize(SHA512_DIGEST_LENGTH);
+    SHA512_Final(digest.data(), &ctx);
+  }
+  return digest;
+}
+
+// Locates the vbmeta struct of an image that is either a bare vbmeta image or
+// has an AVB footer.
+Result<std::vector<uint8_t>> ReadVbMeta(const std::string& image_path) {
+  SharedFD image = SharedFD::Open(image_path, O_RDONLY);
+  CF_EXPECTF(image->IsOpen(), "Failed to open '{}': {}", image_path,
+             image->StrError());
+  std::optional<uint64_t> original_size =
+      CF_EXPECT(AvbOriginalImageSize(image));
+
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  if (original_size) {
+    std::vector<uint8_t> footer(kAvbFooterSize);
+    off_t file_size = image->LSeek(0, SEEK_END);
+    CF_EXPECT_EQ(image->PRead(footer.data(), footer.size(),
+                              file_size - kAvbFooterSize),
+                 kAvbFooterSize, image->StrError());
+    offset = ReadU64(footer.data() + 20);
+    size = ReadU64(footer.data() + 28);
+  } else {
+    std::vector<uint8_t> header(kVbMetaHeaderSize);
+    CF_EXPECT_EQ(image->PRead(header.data(), header.size(), 0),
+                 kVbMetaHeaderSize, image->StrError());
+    CF_EXPECTF(memcmp(header.data(), "AVB0", 4) == 0,
+               "'{}' is neither a vbmeta image nor has an AVB footer",
+               image_path);
+    size = kVbMetaHeaderSize + ReadU64(header.data() + 12) +
+           ReadU64(header.data() + 20);
+  }
+
+  std::vector<uint8_t> vbmeta(size);
+  CF_EXPECT_EQ(image->PRead(vbmeta.data(), size, offset), size,
+               image->StrError());
+  AvbVBMetaVerifyResult verify =
+      avb_vbmeta_image_verify(vbmeta.data(), vbmeta.size(), nullptr, nullptr);
+  CF_EXPECTF(verify == AVB_VBMETA_VERIFY_RESULT_OK ||
+                 verify == AVB_VBMETA_VERIFY_RESULT_OK_NOT_SIGNED,
+             "Invalid vbmeta in '{}': {}", image_path,
+             avb_vbmeta_verify_result_to_string(verify));
+  return vbmeta;
+}
+
+// Name avbtool uses to deduplicate included descriptors, or empty if the
+// descriptor type has no partition name.
+std::string PartitionKey(const uint8_t* descriptor, size_t size) {
+  uint64_t tag = ReadU64(descriptor);
+  size_t len_offset, name_offset;
+  std::string_view type;
+  switch (tag) {
+    case kDescriptorTagHash:
+      type = "AvbHashDescriptor";
+      len_offset = 56;
+      name_offset = 132;
+      break;
+    case kDescriptorTagHashtree:
+      type = "AvbHashtreeDescriptor";
+      len_offset = 104;
+      name_offset = 180;
+      break;
+    case kDescriptorTagChainPartition:
+      type = "AvbChainPartitionDescriptor";
+      len_offset = 20;
+      name_offset = 92;
+      break;
+    default:
+      return "";
+  }
+  if (size < name_offset) {
+    return "";
+  }
+  size_t name_len = std::min<size_t>(ReadU32(descriptor + len_offset),
+                                     size - name_offset);
+  std::string_view name(reinterpret_cast<const char*>(descriptor) + name_offset,
+                        name_len);
+  return fmt::format("{}_{}", type, name);
+}
+
+}  // namespace
+
+std::vector<uint8_t> EncodeDescriptor(const AvbHashDescriptorSpec& spec) {
+  std::vector<uint8_t> body = Encoder()
+                                  .U64(spec.image_size)
+                                  .Fixed(spec.hash_algorithm, 32)
+                                  .U32(spec.partition_name.size())
+                                  .U32(spec.salt.size())
+                                  .U32(spec.digest.size())
+                                  .U32(spec.flags)
+                                  .Zeros(60)
+                                  .Bytes(spec.partition_name)
+                                  .Bytes(spec.salt)
+                                  .Bytes(spec.digest)
+                                  .Finish();
+  return FinishDescriptor(kDescriptorTagHash, std::move(body));
+}
+
+std::vector<uint8_t> EncodeDescriptor(const AvbHashtreeDescriptorSpec& spec) {
+  constexpr uint32_t kDmVerityVersion = 1;
+  std::vector<uint8_t> body = Encoder()
+                                  .U32(kDmVerityVersion)
+                                  .U64(spec.image_size)
+                                  .U64(spec.tree_offset)
+                                  .U64(spec.tree_size)
+                                  .U32(spec.data_block_size)
+                                  .U32(spec.hash_block_size)
+                                  .U32(spec.fec_num_roots)
+                                  .U64(spec.fec_offset)
+                                  .U64(spec.fec_size)
+                                  .Fixed(spec.hash_algorithm, 32)
+                                  .U32(spec.partition_name.size())
+                                  .U32(spec.salt.size())
+                                  .U32(spec.root_digest.size())
+                                  .U32(spec.flags)
+                                  .Zeros(60)
+                                  .Bytes(spec.partition_name)
+                                  .Bytes(spec.salt)
+                                  .Bytes(spec.root_digest)
+                                  .Finish();
+  return FinishDescriptor(kDescriptorTagHashtree, std::move(body));
+}
+
+std::vector<uint8_t> EncodeDescriptor(
+    const AvbChainPartitionDescriptorSpec& spec) {
+  std::vector<uint8_t> body = Encoder()
+                                  .U32(spec.rollback_index_location)
+                                  .U32(spec.partition_name.size())
+                                  .U32(spec.public_key.size())
+                                  .U32(0)  // flags
+                                  .Zeros(60)
+                                  .Bytes(spec.partition_name)
+                                  .Bytes(spec.public_key)
+                                  .Finish();
+  return FinishDescriptor(kDescriptorTagChainPartition, std::move(body));
+}
+
+std::vector<uint8_t> EncodeAvbFooter(uint64_t original_image_size,
+                                     uint64_t vbmeta_offset,
+                                     uint64_t vbmeta_size) {
+  return Encoder()
+      .Bytes(std::string_view("AVBf"))
+      .U32(1)  // AVB_FOOTER_VERSION_MAJOR
+      .U32(0)  // AVB_FOOTER_VERSION_MINOR
+      .U64(original_image_size)
+      .U64(vbmeta_offset)
+      .U64(vbmeta_size)
+      .Zeros(28)
+      .Finish();
+}
+
+Result<std::optional<uint64_t>> AvbOriginalImageSize(SharedFD image) {
+  off_t size = image->LSeek(0, SEEK_END);
+  CF_EXPECT_GE(size, 0, image->StrError());
+  if (size < static_cast<off_t>(kAvbFooterSize)) {
+    return std::nullopt;
+  }
+  std::vector<uint8_t> footer(kAvbFooterSize);
+  CF_EXPECT_EQ(
+      image->PRead(footer.data(), footer.size(), size - kAvbFooterSize),
+      kAvbFooterSize, image->StrError());
+  if (memcmp(footer.data(), "AVBf", 4) != 0) {
+    return std::nullopt;
+  }
+  return ReadU64(footer.data() + 12);
+}
+
+VbMetaBuilder& VbMetaBuilder::SetAlgorithm(std::string algorithm,
+                                           std::string key_path) {
+  algorithm_ = algorithm.empty() ? "NONE" : std::move(algorithm);
+  key_path_ = std::move(key_path);
+  return *this;
+}
+
+VbMetaBuilder& VbMetaBuilder::SetRollbackIndex(uint64_t rollback_index) {
+  rollback_index_ = rollback_index;
+  return *this;
+}
+
+VbMetaBuilder& VbMetaBuilder::SetRollbackIndexLocation(uint32_t location) {
+  rollback_index_location_ = location;
+  return *this;
+}
+
+VbMetaBuilder& VbMetaBuilder::SetFlags(uint32_t flags) {
+  flags_ = flags;
+  return *this;
+}
+
+VbMetaBuilder& VbMetaBuilder::AddDescriptor(std::vector<uint8_t> encoded) {
+  descriptors_.insert(descriptors_.end(), encoded.begin(), encoded.end());
+  return *this;
+}
+
+Result<void> VbMetaBuilder::IncludeDescriptorsFromImage(
+    const std::string& image_path) {
+  std::vector<uint8_t> vbmeta = CF_EXPECT(ReadVbMeta(image_path));
+  required_minor_version_ =
+      std::max(required_minor_version_, ReadU32(vbmeta.data() + 8));
+
+  uint64_t aux_offset = kVbMetaHeaderSize + ReadU64(vbmeta.data() + 12);
+  uint64_t begin = aux_offset + ReadU64(vbmeta.data() + 96);
+  uint64_t end = begin + ReadU64(vbmeta.data() + 104);
+  CF_EXPECT_LE(end, vbmeta.size());
+
+  for (uint64_t pos = begin; pos < end;) {
+    CF_EXPECT_LE(pos + kDescriptorHeaderSize, end);
+    uint64_t size = kDescriptorHeaderSize + ReadU64(vbmeta.data() + pos + 8);
+    CF_EXPECT_LE(pos + size, end);
+    const uint8_t* descriptor = vbmeta.data() + pos;
+    std::string key = PartitionKey(descriptor, size);
+    if (key.empty()) {
+      included_other_.insert(included_other_.end(), descriptor,
+                             descriptor + size);
+    } else {
+      included_by_partition_[key].assign(descriptor, descriptor + size);
+    }
+    pos += size;
+  }
+  return {};
+}
+
+Result<std::vector<uint8_t>> VbMetaBuilder::Build() const {
+  const AlgorithmInfo& algorithm = *CF_EXPECT(LookupAlgorithm(algorithm_));
+
+  std::unique_ptr<RSA, decltype(&RSA_free)> key(nullptr, RSA_free);
+  std::vector<uint8_t> public_key;
+  if (algorithm.signature_size > 0) {
+    key = CF_EXPECT(LoadPrivateKey(key_path_));
+    CF_EXPECT_EQ(RSA_size(key.get()), algorithm.signature_size,
+                 "Key size does not match algorithm " << algorithm.name);
+    public_key = CF_EXPECT(EncodePublicKey(key.get()));
+  }
+
+  std::vector<uint8_t> descriptors = descriptors_;
+  descriptors.insert(descriptors.end(), included_other_.begin(),
+                     included_other_.end());
+  for (const auto& [_, descriptor] : included_by_partition_) {
+    descriptors.insert(descriptors.end(), descriptor.begin(), descriptor.end());
+  }
+
+  const uint64_t aux_size = RoundUp(descriptors.size() + public_key.size(), 64);
+  const uint64_t auth_size =
+      RoundUp(algorithm.hash_size + algorithm.signature_size, 64);
+  const std::string release =
+      fmt::format("avbtool {}.{}.{}", AVB_VERSION_MAJOR, AVB_VERSION_MINOR,
+                  AVB_VERSION_SUB);
+  // Like avbtool, require a libavb that knows about rollback index locations
+  // when one is used.
+  uint32_t required_minor_version = required_minor_version_;
+  if (rollback_index_location_ > 0) {
+    required_minor_version = std::max(required_minor_version, uint32_t{2});
+  }
+
+  std::vector<uint8_t> header =
+      Encoder()
+          .Bytes(std::string_view("AVB0"))
+          .U32(AVB_VERSION_MAJOR)
+          .U32(required_minor_version)
+          .U64(auth_size)
+          .U64(aux_size)
+          .U32(algorithm.type)
+          .U64(0)  // hash_offset
+          .U64(algorithm.hash_size)
+          .U64(algorithm.hash_size)  // signature_offset
+          .U64(algorithm.signature_size)
+          .U64(descriptors.size())  // public_key_offset
+          .U64(public_key.size())
+          .U64(descriptors.size() + public_key.size())  // metadata offset
+          .U64(0)                                      // metadata size
+          .U64(0)                                      // descriptors_offset
+          .U64(descriptors.size())
+          .U64(rollback_index_)
+          .U32(flags_)
+          .U32(rollback_index_location_)
+          .Fixed(release, kReleaseStringSize)
+          .Zeros(kVbMetaHeaderSize - 176)
+          .Finish();
+
+  std::vector<uint8_t> aux = std::move(descriptors);
+  aux.insert(aux.end(), public_key.begin(), public_key.end());
+  aux.resize(aux_size, 0);
+
+  std::vector<uint8_t> auth;
+  if (algorithm.signature_size > 0) {
+    auth = Digest(algorithm.hash_nid, header, aux);
+    std::vector<uint8_t> signature(algorithm.signature_size);
+    unsigned int signature_len = 0;
+    CF_EXPECT(RSA_sign(algorithm.hash_nid, auth.data(), auth.size(),
+                       signature.data(), &signature_len, key.get()),
+              "Failed to sign vbmeta with " << key_path_);
+    CF_EXPECT_EQ(signature_len, signature.size());
+    auth.insert(auth.end(), signature.begin(), signature.end());
+  }
+  auth.resize(auth_size, 0);
+
+  std::vector<uint8_t> vbmeta = std::move(header);
+  vbmeta.insert(vbmeta.end(), auth.begin(), auth.end());
+  vbmeta.insert(vbmeta.end(), aux.begin(), aux.end());
+  return vbmeta;
+}
+
+}  // namespace cuttlefish
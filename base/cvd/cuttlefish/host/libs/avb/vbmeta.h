@@ -0,0 +1,108 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result_type.h"
+
+namespace cuttlefish {
+
+// Native equivalents of the structures `avbtool` serializes. The encodings
+// follow external/avb/avbtool.py byte for byte so that images produced here
+// and by avbtool are interchangeable.
+
+inline constexpr size_t kAvbFooterSize = 64;
+
+struct AvbHashDescriptorSpec {
+  uint64_t image_size = 0;
+  std::string hash_algorithm = "sha256";
+  std::string partition_name;
+  std::vector<uint8_t> salt;
+  std::vector<uint8_t> digest;
+  uint32_t flags = 0;
+};
+
+struct AvbHashtreeDescriptorSpec {
+  uint64_t image_size = 0;
+  uint64_t tree_offset = 0;
+  uint64_t tree_size = 0;
+  uint32_t data_block_size = 4096;
+  uint32_t hash_block_size = 4096;
+  uint32_t fec_num_roots = 0;
+  uint64_t fec_offset = 0;
+  uint64_t fec_size = 0;
+  std::string hash_algorithm = "sha256";
+  std::string partition_name;
+  std::vector<uint8_t> salt;
+  std::vector<uint8_t> root_digest;
+  uint32_t flags = 0;
+};
+
+struct AvbChainPartitionDescriptorSpec {
+  uint32_t rollback_index_location = 0;
+  std::string partition_name;
+  // Contents of an `avbtool extract_public_key` output file.
+  std::vector<uint8_t> public_key;
+};
+
+std::vector<uint8_t> EncodeDescriptor(const AvbHashDescriptorSpec&);
+std::vector<uint8_t> EncodeDescriptor(const AvbHashtreeDescriptorSpec&);
+std::vector<uint8_t> EncodeDescriptor(const AvbChainPartitionDescriptorSpec&);
+
+std::vector<uint8_t> EncodeAvbFooter(uint64_t original_image_size,
+                                     uint64_t vbmeta_offset,
+                                     uint64_t vbmeta_size);
+
+// Returns the size of the image before the footer was added, or nullopt if the
+// file does not end in an AVB footer.
+Result<std::optional<uint64_t>> AvbOriginalImageSize(SharedFD image);
+
+class VbMetaBuilder {
+ public:
+  VbMetaBuilder& SetAlgorithm(std::string algorithm, std::string key_path);
+  VbMetaBuilder& SetRollbackIndex(uint64_t rollback_index);
+  VbMetaBuilder& SetRollbackIndexLocation(uint32_t location);
+  VbMetaBuilder& SetFlags(uint32_t flags);
+  VbMetaBuilder& AddDescriptor(std::vector<uint8_t> encoded);
+
+  // Same semantics as `avbtool --include_descriptors_from_image`: a later
+  // image's descriptor replaces an earlier one for the same partition.
+  Result<void> IncludeDescriptorsFromImage(const std::string& image_path);
+
+  // Produces the header, authentication and auxiliary blocks, signed with the
+  // configured key.
+  Result<std::vector<uint8_t>> Build() const;
+
+ private:
+  std::string algorithm_ = "NONE";
+  std::string key_path_;
+  uint64_t rollback_index_ = 0;
+  uint32_t rollback_index_location_ = 0;
+  uint32_t flags_ = 0;
+  uint32_t required_minor_version_ = 0;
+  std::vector<uint8_t> descriptors_;
+  std::map<std::string, std::vector<uint8_t>> included_by_partition_;
+  std::vector<uint8_t> included_other_;
+};
+
+}  // namespace cuttlefish
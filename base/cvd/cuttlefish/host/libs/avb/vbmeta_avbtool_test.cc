@@ -0,0 +1,251 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <openssl/bio.h>
+#include <openssl/bn.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+#include <openssl/sha.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "android-base/file.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "libavb/libavb.h"
+
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/host/libs/avb/hashtree.h"
+#include "cuttlefish/host/libs/avb/vbmeta.h"
+#include "cuttlefish/process/execute.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+// Golden tests: the native encoders and hashtree must produce the same bytes
+// as avbtool.
+// The test target passes the in-tree avbtool.py through `AVBTOOL`. Running it
+// needs python3 and openssl on the host, as avbtool does during a build.
+
+constexpr uint64_t kImageSize = 8192;
+constexpr uint64_t kPartitionSize = 65536;
+constexpr uint8_t kSalt[] = {0x00, 0x11, 0x22, 0x33};
+
+std::vector<uint8_t> ToBytes(const std::string& data) {
+  return std::vector<uint8_t>(data.begin(), data.end());
+}
+
+class VbMetaAvbtoolTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    const char* avbtool = getenv("AVBTOOL");
+    if (avbtool == nullptr) {
+      GTEST_SKIP() << "AVBTOOL is not set";
+    }
+    avbtool_ = avbtool;
+  }
+
+  void Avbtool(std::vector<std::string> args) {
+    args.insert(args.begin(), {"python3", avbtool_});
+    ASSERT_EQ(Execute(args), 0);
+  }
+
+  std::string Path(const std::string& name) {
+    return std::string(dir_.path) + "/" + name;
+  }
+
+  // RSA4096 keys take a while to generate, so all tests share one.
+  static std::string KeyPem() {
+    static const std::string* pem = [] {
+      std::unique_ptr<RSA, decltype(&RSA_free)> rsa(RSA_new(), RSA_free);
+      std::unique_ptr<BIGNUM, decltype(&BN_free)> e(BN_new(), BN_free);
+      BN_set_word(e.get(), RSA_F4);
+      RSA_generate_key_ex(rsa.get(), 4096, e.get(), nullptr);
+      std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new(BIO_s_mem()),
+                                                    BIO_free);
+      PEM_write_bio_RSAPrivateKey(bio.get(), rsa.get(), nullptr, nullptr, 0,
+                                  nullptr, nullptr);
+      const uint8_t* data = nullptr;
+      size_t len = 0;
+      BIO_mem_contents(bio.get(), &data, &len);
+      return new std::string(reinterpret_cast<const char*>(data), len);
+    }();
+    return *pem;
+  }
+
+  TemporaryDir dir_;
+  std::string avbtool_;
+};
+
+TEST_F(VbMetaAvbtoolTest, HashFooterMatchesAvbtool) {
+  std::string image(kImageSize, '\0');
+  for (size_t i = 0; i < image.size(); i++) {
+    image[i] = static_cast<char>(i * 13 + i / 256);
+  }
+  ASSERT_TRUE(android::base::WriteStringToFile(image, Path("boot.img")));
+  ASSERT_NO_FATAL_FAILURE(Avbtool(
+      {"add_hash_footer", "--image", Path("boot.img"), "--partition_name",
+       "boot", "--partition_size", std::to_string(kPartitionSize), "--salt",
+       "00112233", "--algorithm", "NONE"}));
+  Result<std::string> avbtool_image = ReadFileContents(Path("boot.img"));
+  ASSERT_THAT(avbtool_image, IsOk());
+  ASSERT_EQ(avbtool_image->size(), kPartitionSize);
+
+  AvbHashDescriptorSpec spec{
+      .image_size = kImageSize,
+      .partition_name = "boot",
+      .salt = std::vector<uint8_t>(std::begin(kSalt), std::end(kSalt)),
+      .digest = std::vector<uint8_t>(SHA256_DIGEST_LENGTH),
+  };
+  SHA256_CTX ctx;
+  SHA256_Init(&ctx);
+  SHA256_Update(&ctx, kSalt, sizeof(kSalt));
+  SHA256_Update(&ctx, image.data(), image.size());
+  SHA256_Final(spec.digest.data(), &ctx);
+  Result<std::vector<uint8_t>> vbmeta =
+      VbMetaBuilder().AddDescriptor(EncodeDescriptor(spec)).Build();
+  ASSERT_THAT(vbmeta, IsOk());
+
+  EXPECT_EQ(ToBytes(avbtool_image->substr(kImageSize, vbmeta->size())),
+            *vbmeta);
+  EXPECT_EQ(ToBytes(avbtool_image->substr(kPartitionSize - kAvbFooterSize)),
+            EncodeAvbFooter(kImageSize, kImageSize, vbmeta->size()));
+}
+
+TEST_F(VbMetaAvbtoolTest, HashtreeFooterMatchesAvbtool) {
+  // Enough blocks for a two level tree, and a partial last block that both
+  // sides pad before hashing.
+  constexpr uint64_t kOriginalSize = 129 * kAvbBlockSize + 100;
+  constexpr uint64_t kPaddedSize = 130 * kAvbBlockSize;
+  std::string image(kOriginalSize, '\0');
+  for (size_t i = 0; i < image.size(); i++) {
+    image[i] = static_cast<char>(i * 31 + i / kAvbBlockSize);
+  }
+  ASSERT_TRUE(android::base::WriteStringToFile(image, Path("system_dlkm.img")));
+  // The fec binary is not available to the test, so both sides leave out the
+  // FEC data.
+  ASSERT_NO_FATAL_FAILURE(Avbtool(
+      {"add_hashtree_footer", "--image", Path("system_dlkm.img"),
+       "--partition_name", "system_dlkm", "--salt", "00112233",
+       "--hash_algorithm", "sha256", "--algorithm", "NONE",
+       "--do_not_generate_fec"}));
+  Result<std::string> avbtool_image = ReadFileContents(Path("system_dlkm.img"));
+  ASSERT_THAT(avbtool_image, IsOk());
+
+  std::vector<uint8_t> padded = ToBytes(image);
+  padded.resize(kPaddedSize, 0);
+  std::vector<uint8_t> salt(std::begin(kSalt), std::end(kSalt));
+  Result<Hashtree> hashtree = CalculateHashtree(padded, salt);
+  ASSERT_THAT(hashtree, IsOk());
+  AvbHashtreeDescriptorSpec spec{
+      .image_size = kPaddedSize,
+      .tree_offset = kPaddedSize,
+      .tree_size = hashtree->tree.size(),
+      .partition_name = "system_dlkm",
+      .salt = salt,
+      .root_digest = hashtree->root_digest,
+  };
+  Result<std::vector<uint8_t>> vbmeta =
+      VbMetaBuilder().AddDescriptor(EncodeDescriptor(spec)).Build();
+  ASSERT_THAT(vbmeta, IsOk());
+
+  const uint64_t vbmeta_offset = kPaddedSize + hashtree->tree.size();
+  const uint64_t vbmeta_blocks =
+      (vbmeta->size() + kAvbBlockSize - 1) / kAvbBlockSize;
+  ASSERT_EQ(avbtool_image->size(),
+            vbmeta_offset + (vbmeta_blocks + 1) * kAvbBlockSize);
+  EXPECT_EQ(ToBytes(avbtool_image->substr(0, kPaddedSize)), padded);
+  EXPECT_EQ(
+      ToBytes(avbtool_image->substr(kPaddedSize, hashtree->tree.size())),
+      hashtree->tree);
+  EXPECT_EQ(ToBytes(avbtool_image->substr(vbmeta_offset, vbmeta->size())),
+            *vbmeta);
+  EXPECT_EQ(ToBytes(avbtool_image->substr(avbtool_image->size() -
+                                          kAvbFooterSize)),
+            EncodeAvbFooter(kOriginalSize, vbmeta_offset, vbmeta->size()));
+}
+
+TEST_F(VbMetaAvbtoolTest, RollbackIndexLocationMatchesAvbtool) {
+  ASSERT_NO_FATAL_FAILURE(Avbtool({"make_vbmeta_image", "--output",
+                                   Path("vbmeta.img"), "--algorithm", "NONE",
+                                   "--rollback_index_location", "2"}));
+  Result<std::string> expected = ReadFileContents(Path("vbmeta.img"));
+  ASSERT_THAT(expected, IsOk());
+
+  Result<std::vector<uint8_t>> vbmeta =
+      VbMetaBuilder().SetRollbackIndexLocation(2).Build();
+  ASSERT_THAT(vbmeta, IsOk());
+
+  EXPECT_EQ(*vbmeta, ToBytes(*expected));
+}
+
+class VbMetaImageAvbtoolTest
+    : public VbMetaAvbtoolTest,
+      public testing::WithParamInterface<std::string> {};
+
+TEST_P(VbMetaImageAvbtoolTest, MatchesAvbtool) {
+  const std::string& algorithm = GetParam();
+  ASSERT_TRUE(android::base::WriteStringToFile(KeyPem(), Path("key.pem")));
+  ASSERT_NO_FATAL_FAILURE(Avbtool({"extract_public_key", "--key",
+                                   Path("key.pem"), "--output",
+                                   Path("key.avbpubkey")}));
+  std::vector<std::string> args = {
+      "make_vbmeta_image",
+      "--output",
+      Path("vbmeta.img"),
+      "--algorithm",
+      algorithm,
+      "--rollback_index",
+      "7",
+      "--chain_partition",
+      "vbmeta_system:1:" + Path("key.avbpubkey"),
+  };
+  if (algorithm != "NONE") {
+    args.insert(args.end(), {"--key", Path("key.pem")});
+  }
+  ASSERT_NO_FATAL_FAILURE(Avbtool(args));
+  Result<std::string> expected = ReadFileContents(Path("vbmeta.img"));
+  ASSERT_THAT(expected, IsOk());
+  Result<std::string> public_key = ReadFileContents(Path("key.avbpubkey"));
+  ASSERT_THAT(public_key, IsOk());
+
+  AvbChainPartitionDescriptorSpec chain{
+      .rollback_index_location = 1,
+      .partition_name = "vbmeta_system",
+      .public_key = ToBytes(*public_key),
+  };
+  Result<std::vector<uint8_t>> vbmeta =
+      VbMetaBuilder()
+          .SetAlgorithm(algorithm, Path("key.pem"))
+          .SetRollbackIndex(7)
+          .AddDescriptor(EncodeDescriptor(chain))
+          .Build();
+  ASSERT_THAT(vbmeta, IsOk());
+
+  EXPECT_EQ(*vbmeta, ToBytes(*expected));
+}
+
+INSTANTIATE_TEST_SUITE_P(Algorithms, VbMetaImageAvbtoolTest,
+                         testing::Values("NONE", "SHA256_RSA4096"));
+
+}  // namespace
+}  // namespace cuttlefish
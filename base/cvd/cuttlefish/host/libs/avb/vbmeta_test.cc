@@ -0,0 +1,146 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/avb/vbmeta.h"
+
+#include <openssl/bn.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "android-base/file.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "libavb/libavb.h"
+
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+// The native encoders are checked against libavb, which is what the
+// bootloader uses to parse these structures.
+
+TEST(VbMetaTest, FooterParsesWithLibavb) {
+  std::vector<uint8_t> encoded = EncodeAvbFooter(1234, 8192, 320);
+  ASSERT_EQ(encoded.size(), sizeof(AvbFooter));
+
+  AvbFooter footer;
+  ASSERT_TRUE(avb_footer_validate_and_byteswap(
+      reinterpret_cast<const AvbFooter*>(encoded.data()), &footer));
+  EXPECT_EQ(footer.original_image_size, 1234);
+  EXPECT_EQ(footer.vbmeta_offset, 8192);
+  EXPECT_EQ(footer.vbmeta_size, 320);
+}
+
+TEST(VbMetaTest, UnsignedHashDescriptorRoundTrip) {
+  AvbHashDescriptorSpec spec{
+      .image_size = 4096,
+      .partition_name = "boot",
+      .salt = {1, 2, 3},
+      .digest = std::vector<uint8_t>(32, 0x5a),
+  };
+  Result<std::vector<uint8_t>> vbmeta =
+      VbMetaBuilder().AddDescriptor(EncodeDescriptor(spec)).Build();
+  ASSERT_THAT(vbmeta, IsOk());
+
+  EXPECT_EQ(
+      avb_vbmeta_image_verify(vbmeta->data(), vbmeta->size(), nullptr, nullptr),
+      AVB_VBMETA_VERIFY_RESULT_OK_NOT_SIGNED);
+
+  size_t num_descriptors = 0;
+  const AvbDescriptor** descriptors =
+      avb_descriptor_get_all(vbmeta->data(), vbmeta->size(), &num_descriptors);
+  ASSERT_EQ(num_descriptors, 1);
+
+  AvbHashDescriptor descriptor;
+  ASSERT_TRUE(avb_hash_descriptor_validate_and_byteswap(
+      reinterpret_cast<const AvbHashDescriptor*>(descriptors[0]),
+      &descriptor));
+  avb_free(descriptors);
+  EXPECT_EQ(descriptor.image_size, spec.image_size);
+  EXPECT_EQ(descriptor.partition_name_len, spec.partition_name.size());
+  EXPECT_EQ(descriptor.salt_len, spec.salt.size());
+  EXPECT_EQ(descriptor.digest_len, spec.digest.size());
+  EXPECT_EQ(strncmp(reinterpret_cast<const char*>(descriptor.hash_algorithm),
+                    "sha256", sizeof(descriptor.hash_algorithm)),
+            0);
+}
+
+TEST(VbMetaTest, SignedImageVerifiesWithLibavb) {
+  std::unique_ptr<RSA, decltype(&RSA_free)> rsa(RSA_new(), RSA_free);
+  std::unique_ptr<BIGNUM, decltype(&BN_free)> e(BN_new(), BN_free);
+  ASSERT_TRUE(BN_set_word(e.get(), RSA_F4));
+  ASSERT_TRUE(RSA_generate_key_ex(rsa.get(), 4096, e.get(), nullptr));
+  TemporaryFile key;
+  FILE* key_file = fdopen(key.release(), "w");
+  ASSERT_NE(key_file, nullptr);
+  ASSERT_TRUE(PEM_write_RSAPrivateKey(key_file, rsa.get(), nullptr, nullptr, 0,
+                                      nullptr, nullptr));
+  fclose(key_file);
+
+  AvbChainPartitionDescriptorSpec spec{
+      .rollback_index_location = 1,
+      .partition_name = "vbmeta_system",
+      .public_key = {1, 2, 3, 4},
+  };
+  Result<std::vector<uint8_t>> vbmeta =
+      VbMetaBuilder()
+          .SetAlgorithm("SHA256_RSA4096", key.path)
+          .AddDescriptor(EncodeDescriptor(spec))
+          .Build();
+  ASSERT_THAT(vbmeta, IsOk());
+
+  // libavb checks the signature with the embedded public key, which only
+  // works if its n0inv and R^2 mod n were encoded correctly.
+  const uint8_t* public_key = nullptr;
+  size_t public_key_size = 0;
+  EXPECT_EQ(avb_vbmeta_image_verify(vbmeta->data(), vbmeta->size(),
+                                    &public_key, &public_key_size),
+            AVB_VBMETA_VERIFY_RESULT_OK);
+  EXPECT_EQ(public_key_size, 8 + 2 * 512);
+
+  (*vbmeta)[vbmeta->size() - 1] ^= 1;
+  EXPECT_EQ(
+      avb_vbmeta_image_verify(vbmeta->data(), vbmeta->size(), nullptr, nullptr),
+      AVB_VBMETA_VERIFY_RESULT_HASH_MISMATCH);
+}
+
+TEST(VbMetaTest, RollbackIndexLocationRequiresLibavbMinorVersion2) {
+  Result<std::vector<uint8_t>> vbmeta =
+      VbMetaBuilder().SetRollbackIndexLocation(3).Build();
+  ASSERT_THAT(vbmeta, IsOk());
+
+  AvbVBMetaImageHeader header;
+  avb_vbmeta_image_header_to_host_byte_order(
+      reinterpret_cast<const AvbVBMetaImageHeader*>(vbmeta->data()), &header);
+  EXPECT_EQ(header.rollback_index_location, 3);
+  EXPECT_EQ(header.required_libavb_version_minor, 2);
+}
+
+TEST(VbMetaTest, UnknownAlgorithmFails) {
+  EXPECT_THAT(VbMetaBuilder().SetAlgorithm("SHA1_RSA1024", "").Build(),
+              IsError());
+}
+
+}  // namespace
+}  // namespace cuttlefish
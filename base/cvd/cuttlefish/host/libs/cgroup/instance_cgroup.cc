@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/libs/cgroup/instance_cgroup.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+#include "fmt/format.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/contains.h"
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/files/file_exists.h"
+#include "cuttlefish/posix/strerror.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr char kNodesDir[] = "/sys/devices/system/node";
+
+// Interface files take a value per write(2), so it can't be split up.
+Result<void> WriteInterfaceFile(const std::string& cgroup,
+                                const std::string& file,
+                                std::string_view value) {
+  std::string path = cgroup + "/" + file;
+  SharedFD fd = SharedFD::Open(path, O_WRONLY);
+  CF_EXPECTF(fd->IsOpen(), "Failed to open '{}': {}", path, fd->StrError());
+  ssize_t written = fd->Write(value.data(), value.size());
+  CF_EXPECTF(written == static_cast<ssize_t>(value.size()),
+             "Failed to write '{}' to '{}': {}", value, path, fd->StrError());
+  return {};
+}
+
+// Empty values reset limits a previous launch may have left behind, as long
+// as the controller providing them is enabled.
+Result<void> SetLimit(const std::string& cgroup, const std::string& file,
+                      const std::string& value, std::string_view unlimited) {
+  if (value.empty()) {
+    if (!FileExists(cgroup + "/" + file)) {
+      return {};
+    }
+    CF_EXPECT(WriteInterfaceFile(cgroup, file, unlimited));
+    return {};
+  }
+  CF_EXPECT(WriteInterfaceFile(cgroup, file, value));
+  return {};
+}
+
+Result<void> MakeCgroup(const std::string& path) {
+  if (mkdir(path.c_str(), 0755) < 0 && errno != EEXIST) {
+    return CF_ERRF("Failed to create cgroup '{}': {}", path, StrError(errno));
+  }
+  return {};
+}
+
+// Lets the children of `cgroup` use the `required` controllers, plus the
+// memory and io controllers when available for their usage counters.
+Result<void> EnableControllers(const std::string& cgroup,
+                               std::set<std::string> required) {
+  std::string controllers_path = cgroup + "/cgroup.controllers";
+  std::string contents = CF_EXPECTF(ReadFileContents(controllers_path),
+                                    "'{}' is not a cgroup v2 directory",
+                                    cgroup);
+  std::vector<std::string> available =
+      absl::StrSplit(contents, absl::ByAnyChar(" \n"), absl::SkipEmpty());
+  for (const std::string& controller : required) {
+    CF_EXPECTF(Contains(available, controller),
+               "The {} controller isn't available in '{}', it has to be "
+               "delegated to it",
+               controller, cgroup);
+  }
+  for (const char* optional : {"memory", "io"}) {
+    if (Contains(available, optional)) {
+      required.insert(optional);
+    }
+  }
+  for (const std::string& controller : required) {
+    CF_EXPECT(
+        WriteInterfaceFile(cgroup, "cgroup.subtree_control", "+" + controller));
+  }
+  return {};
+}
+
+// Returns the value of `key` in a flat keyed file like cpu.stat.
+std::optional<uint64_t> FindKeyedValue(std::string_view contents,
+                                       std::string_view key) {
+  for (std::string_view line : absl::StrSplit(contents, '\n')) {
+    if (absl::ConsumePrefix(&line, key) && absl::ConsumePrefix(&line, " ")) {
+      uint64_t value;
+      if (absl::SimpleAtoi(line, &value)) {
+        return value;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+InstanceCgroup::InstanceCgroup(std::string path) : path_(std::move(path)) {}
+
+Result<InstanceCgroup> InstanceCgroup::Create(const std::string& path,
+                                              const CgroupLimits& limits,
+                                              int vmm_numa_node) {
+  std::string parent = path.substr(0, path.find_last_of('/'));
+  std::set<std::string> required;
+  if (!limits.cpu_max.empty()) {
+    required.insert("cpu");
+  }
+  if (!limits.memory_high.empty()) {
+    required.insert("memory");
+  }
+  if (!limits.cpuset_cpus.empty() || vmm_numa_node >= 0) {
+    required.insert("cpuset");
+  }
+  CF_EXPECT(EnableControllers(parent, required));
+
+  InstanceCgroup cgroup(path);
+  CF_EXPECT(MakeCgroup(cgroup.Path()));
+  CF_EXPECT(SetLimit(cgroup.Path(), "cpu.max", limits.cpu_max, "max"));
+  CF_EXPECT(
+      SetLimit(cgroup.Path(), "memory.high", limits.memory_high, "max"));
+  CF_EXPECT(
+      SetLimit(cgroup.Path(), "cpuset.cpus", limits.cpuset_cpus, "\n"));
+  CF_EXPECT(EnableControllers(cgroup.Path(), required));
+
+  CF_EXPECT(MakeCgroup(cgroup.DaemonsPath()));
+  CF_EXPECT(MakeCgroup(cgroup.VmmPath()));
+  std::string node_cpus;
+  std::string node_mems;
+  if (vmm_numa_node >= 0) {
+    std::string cpulist =
+        fmt::format("{}/node{}/cpulist", kNodesDir, vmm_numa_node);
+    std::string contents = CF_EXPECTF(ReadFileContents(cpulist),
+                                      "NUMA node {} not found", vmm_numa_node);
+    node_cpus = absl::StripAsciiWhitespace(contents);
+    node_mems = std::to_string(vmm_numa_node);
+  }
+  // Should the node's CPUs all be outside of the instance's cpuset, the
+  // kernel keeps the VMM on the instance's.
+  CF_EXPECT(SetLimit(cgroup.VmmPath(), "cpuset.cpus", node_cpus, "\n"));
+  CF_EXPECT(SetLimit(cgroup.VmmPath(), "cpuset.mems", node_mems, "\n"));
+  return cgroup;
+}
+
+std::string InstanceCgroup::DaemonsPath() const { return path_ + "/daemons"; }
+
+std::string InstanceCgroup::VmmPath() const { return path_ + "/vmm"; }
+
+Result<void> InstanceCgroup::JoinDaemons() const {
+  // "0" stands for the writing process.
+  CF_EXPECT(WriteInterfaceFile(DaemonsPath(), "cgroup.procs", "0"));
+  return {};
+}
+
+Result<CgroupUsage> ReadCgroupUsage(const std::string& path) {
+  CgroupUsage usage;
+  std::string cpu_stat = CF_EXPECT(ReadFileContents(path + "/cpu.stat"));
+  usage.cpu_usage_usec = FindKeyedValue(cpu_stat, "usage_usec").value_or(0);
+
+  // Only present with the memory and io controllers enabled.
+  std::string memory_current_path = path + "/memory.current";
+  if (FileExists(memory_current_path)) {
+    std::string memory_current =
+        CF_EXPECT(ReadFileContents(memory_current_path));
+    CF_EXPECTF(absl::SimpleAtoi(absl::StripAsciiWhitespace(memory_current),
+                                &usage.memory_current_bytes),
+               "Unexpected contents in '{}': '{}'", memory_current_path,
+               memory_current);
+  }
+  std::string io_stat_path = path + "/io.stat";
+  if (FileExists(io_stat_path)) {
+    // One line per device, e.g. "8:0 rbytes=1 wbytes=2 rios=3 wios=4 ..."
+    std::string io_stat = CF_EXPECT(ReadFileContents(io_stat_path));
+    for (std::string_view field :
+         absl::StrSplit(io_stat, absl::ByAnyChar(" \n"), absl::SkipEmpty())) {
+      uint64_t bytes;
+      if (absl::ConsumePrefix(&field, "rbytes=") &&
+          absl::SimpleAtoi(field, &bytes)) {
+        usage.io_read_bytes += bytes;
+      } else if (absl::ConsumePrefix(&field, "wbytes=") &&
+                 absl::SimpleAtoi(field, &bytes)) {
+        usage.io_write_bytes += bytes;
+      }
+    }
+  }
+  return usage;
+}
+
+int NumaNodeCount() {
+  Result<std::vector<std::string>> entries = DirectoryContents(kNodesDir);
+  if (!entries.ok()) {
+    return 1;
+  }
+  int nodes = 0;
+  for (std::string_view entry : *entries) {
+    int node;
+    if (absl::ConsumePrefix(&entry, "node") && absl::SimpleAtoi(entry, &node)) {
+      nodes++;
+    }
+  }
+  return nodes > 0 ? nodes : 1;
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+// Limits for everything an instance runs, in the syntax of the cgroup v2
+// interface files. Empty values keep the kernel defaults.
+struct CgroupLimits {
+  // cpu.max, e.g. "200000 100000" for at most two CPUs.
+  std::string cpu_max;
+  // memory.high, in bytes or "max". The instance is throttled and reclaimed
+  // above it rather than killed.
+  std::string memory_high;
+  // cpuset.cpus, e.g. "0-3,8-11".
+  std::string cpuset_cpus;
+};
+
+// Resource usage of a cgroup and its descendants.
+struct CgroupUsage {
+  uint64_t cpu_usage_usec = 0;
+  uint64_t memory_current_bytes = 0;
+  uint64_t io_read_bytes = 0;
+  uint64_t io_write_bytes = 0;
+};
+
+// The cgroup v2 hierarchy of one instance:
+//
+//   <path>/          limits for everything the instance runs
+//   <path>/daemons/  run_cvd and the host daemons
+//   <path>/vmm/      the VMM, optionally pinned to a NUMA node
+//
+// Processes only live in the leaves, cgroup v2 doesn't allow them next to
+// child cgroups with controllers enabled. For the same reason the parent of
+// `path` must not contain processes itself. It also has to be writable by
+// the user, e.g. a slice delegated by systemd.
+class InstanceCgroup {
+ public:
+  // Reuses the hierarchy left behind by a previous launch, if any.
+  // `vmm_numa_node` restricts the VMM to the CPUs and memory of that node,
+  // -1 leaves it unrestricted.
+  static Result<InstanceCgroup> Create(const std::string& path,
+                                       const CgroupLimits& limits,
+                                       int vmm_numa_node);
+
+  const std::string& Path() const { return path_; }
+  std::string DaemonsPath() const;
+  std::string VmmPath() const;
+
+  // Moves the calling process into DaemonsPath(). Its future children start
+  // there as well.
+  Result<void> JoinDaemons() const;
+
+ private:
+  explicit InstanceCgroup(std::string path);
+
+  std::string path_;
+};
+
+Result<CgroupUsage> ReadCgroupUsage(const std::string& path);
+
+// Number of NUMA nodes on the host, 1 when NUMA isn't supported.
+int NumaNodeCount();
+
+}  // namespace cuttlefish
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/libs/cgroup/instance_cgroup.h"
+
+#include <stdlib.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+class ReadCgroupUsageTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    cgroup_ = testing::TempDir() + "/cgroup_XXXXXX";
+    ASSERT_NE(mkdtemp(cgroup_.data()), nullptr);
+  }
+
+  void WriteInterfaceFile(const std::string& name,
+                          const std::string& contents) {
+    ASSERT_THAT(WriteNewFile(cgroup_ + "/" + name, contents), IsOk());
+  }
+
+  std::string cgroup_;
+};
+
+TEST_F(ReadCgroupUsageTest, AllControllers) {
+  WriteInterfaceFile("cpu.stat",
+                     "usage_usec 123456\n"
+                     "user_usec 100000\n"
+                     "system_usec 23456\n");
+  WriteInterfaceFile("memory.current", "4096\n");
+  WriteInterfaceFile("io.stat",
+                     "8:0 rbytes=100 wbytes=200 rios=1 wios=2 dbytes=0 dios=0\n"
+                     "259:0 rbytes=1000 wbytes=2000 rios=3 wios=4\n");
+
+  Result<CgroupUsage> usage = ReadCgroupUsage(cgroup_);
+
+  ASSERT_THAT(usage, IsOk());
+  EXPECT_EQ(usage->cpu_usage_usec, 123456);
+  EXPECT_EQ(usage->memory_current_bytes, 4096);
+  EXPECT_EQ(usage->io_read_bytes, 1100);
+  EXPECT_EQ(usage->io_write_bytes, 2200);
+}
+
+TEST_F(ReadCgroupUsageTest, OnlyCpuStat) {
+  WriteInterfaceFile("cpu.stat", "usage_usec 42\n");
+
+  Result<CgroupUsage> usage = ReadCgroupUsage(cgroup_);
+
+  ASSERT_THAT(usage, IsOk());
+  EXPECT_EQ(usage->cpu_usage_usec, 42);
+  EXPECT_EQ(usage->memory_current_bytes, 0);
+  EXPECT_EQ(usage->io_read_bytes, 0);
+}
+
+TEST_F(ReadCgroupUsageTest, NotACgroup) {
+  EXPECT_THAT(ReadCgroupUsage(cgroup_), IsError());
+}
+
+TEST(NumaNodeCountTest, AtLeastOne) { EXPECT_GE(NumaNodeCount(), 1); }
+
+}  // namespace
+}  // namespace cuttlefish
@@ -284,6 +284,7 @@ class CuttlefishConfig {
     std::string adb_device_name() const;
     std::string gnss_file_path() const;
     std::string fixed_location_file_path() const;
+    double gnss_replay_speed() const;
     std::string mobile_bridge_name() const;
     std::string mobile_tap_name() const;
     std::string mobile_mac() const;
@@ -519,6 +520,18 @@ class CuttlefishConfig {
 
     bool restart_subprocesses() const;
 
+    // Cgroup v2 directory the instance's cgroup is created under, empty when
+    // the instance isn't placed in a cgroup.
+    std::string cgroup_parent() const;
+    // The instance's cgroup, empty without cgroup_parent().
+    std::string cgroup_path() const;
+    // Limits in cgroup interface file syntax, empty for no limit.
+    std::string cgroup_cpu_max() const;
+    std::string cgroup_memory_high() const;
+    std::string cgroup_cpuset() const;
+    // NUMA node to keep the VMM's CPUs and memory on, -1 for none.
+    int vmm_numa_node() const;
+
     // android artifacts
     std::string images_dir() const;
     std::string init_boot_image() const;
@@ -578,6 +591,9 @@ class CuttlefishConfig {
 
     bool enable_tap_devices() const;
 
+    // Whether the log tee writes an index of the lines it logs.
+    bool log_index() const;
+
     std::vector<MediaConfig> media_configs() const;
   };
 
@@ -648,6 +664,7 @@ class CuttlefishConfig {
     void set_gnss_file_path(const std::string& gnss_file_path);
     void set_fixed_location_file_path(
         const std::string& fixed_location_file_path);
+    void set_gnss_replay_speed(double gnss_replay_speed);
     void set_gem5_binary_dir(const std::string& gem5_binary_dir);
     void set_gem5_checkpoint_dir(const std::string& gem5_checkpoint_dir);
     // Serial console
@@ -753,6 +770,12 @@ class CuttlefishConfig {
 
     void set_restart_subprocesses(bool restart_subprocesses);
 
+    void set_cgroup_parent(const std::string& cgroup_parent);
+    void set_cgroup_cpu_max(const std::string& cpu_max);
+    void set_cgroup_memory_high(const std::string& memory_high);
+    void set_cgroup_cpuset(const std::string& cpuset);
+    void set_vmm_numa_node(int node);
+
     // system image files
     void set_images_dir(const std::string& dir);
     void set_init_boot_image(const std::string& init_boot_image);
@@ -807,6 +830,8 @@ class CuttlefishConfig {
 
     void set_enable_tap_devices(bool);
 
+    void set_log_index(bool);
+
     void set_media_configs(const std::vector<MediaConfig>& configs);
 
    private:
@@ -496,6 +496,15 @@ void CuttlefishConfig::MutableInstanceSpecific::set_fixed_location_file_path(
   (*Dictionary())[kFixedLocationFilePath] = fixed_location_file_path;
 }
 
+static constexpr char kGnssReplaySpeed[] = "gnss_replay_speed";
+double CuttlefishConfig::InstanceSpecific::gnss_replay_speed() const {
+  return (*Dictionary())[kGnssReplaySpeed].asDouble();
+}
+void CuttlefishConfig::MutableInstanceSpecific::set_gnss_replay_speed(
+    double gnss_replay_speed) {
+  (*Dictionary())[kGnssReplaySpeed] = gnss_replay_speed;
+}
+
 static constexpr char kGem5BinaryDir[] = "gem5_binary_dir";
 std::string CuttlefishConfig::InstanceSpecific::gem5_binary_dir() const {
   return (*Dictionary())[kGem5BinaryDir].asString();
@@ -829,6 +838,55 @@ void CuttlefishConfig::MutableInstanceSpecific::set_restart_subprocesses(
   (*Dictionary())[kRestartSubprocesses] = restart_subprocesses;
 }
 
+static constexpr char kCgroupParent[] = "cgroup_parent";
+std::string CuttlefishConfig::InstanceSpecific::cgroup_parent() const {
+  return (*Dictionary())[kCgroupParent].asString();
+}
+void CuttlefishConfig::MutableInstanceSpecific::set_cgroup_parent(
+    const std::string& cgroup_parent) {
+  (*Dictionary())[kCgroupParent] = cgroup_parent;
+}
+std::string CuttlefishConfig::InstanceSpecific::cgroup_path() const {
+  std::string parent = cgroup_parent();
+  return parent.empty() ? "" : parent + "/cvd-" + id();
+}
+
+static constexpr char kCgroupCpuMax[] = "cgroup_cpu_max";
+std::string CuttlefishConfig::InstanceSpecific::cgroup_cpu_max() const {
+  return (*Dictionary())[kCgroupCpuMax].asString();
+}
+void CuttlefishConfig::MutableInstanceSpecific::set_cgroup_cpu_max(
+    const std::string& cpu_max) {
+  (*Dictionary())[kCgroupCpuMax] = cpu_max;
+}
+
+static constexpr char kCgroupMemoryHigh[] = "cgroup_memory_high";
+std::string CuttlefishConfig::InstanceSpecific::cgroup_memory_high() const {
+  return (*Dictionary())[kCgroupMemoryHigh].asString();
+}
+void CuttlefishConfig::MutableInstanceSpecific::set_cgroup_memory_high(
+    const std::string& memory_high) {
+  (*Dictionary())[kCgroupMemoryHigh] = memory_high;
+}
+
+static constexpr char kCgroupCpuset[] = "cgroup_cpuset";
+std::string CuttlefishConfig::InstanceSpecific::cgroup_cpuset() const {
+  return (*Dictionary())[kCgroupCpuset].asString();
+}
+void CuttlefishConfig::MutableInstanceSpecific::set_cgroup_cpuset(
+    const std::string& cpuset) {
+  (*Dictionary())[kCgroupCpuset] = cpuset;
+}
+
+static constexpr char kVmmNumaNode[] = "vmm_numa_node";
+int CuttlefishConfig::InstanceSpecific::vmm_numa_node() const {
+  const Json::Value& node = (*Dictionary())[kVmmNumaNode];
+  return node.isInt() ? node.asInt() : -1;
+}
+void CuttlefishConfig::MutableInstanceSpecific::set_vmm_numa_node(int node) {
+  (*Dictionary())[kVmmNumaNode] = node;
+}
+
 static constexpr char kHWComposer[] = "hwcomposer";
 std::string CuttlefishConfig::InstanceSpecific::hwcomposer() const {
   return (*Dictionary())[kHWComposer].asString();
@@ -1882,6 +1940,15 @@ bool CuttlefishConfig::InstanceSpecific::enable_tap_devices() const {
   return (*Dictionary())[kEnableTapDevices].asBool();
 }
 
+static constexpr char kLogIndex[] = "log_index";
+void CuttlefishConfig::MutableInstanceSpecific::set_log_index(
+    const bool log_index) {
+  (*Dictionary())[kLogIndex] = log_index;
+}
+bool CuttlefishConfig::InstanceSpecific::log_index() const {
+  return (*Dictionary())[kLogIndex].asBool();
+}
+
 std::string CuttlefishConfig::InstanceSpecific::touch_socket_path(
     int touch_dev_idx) const {
   std::string name = absl::StrCat("touch_", touch_dev_idx, ".sock");
@@ -15,6 +15,7 @@
 
 #include "cuttlefish/host/libs/config/logging.h"
 
+#include <optional>
 #include <string>
 
 #include "absl/log/check.h"
@@ -36,10 +37,13 @@ void DefaultSubprocessLogging(char* argv[], MetadataLevel stderr_level) {
     prefix = instance.instance_name() + ": ";
   }
 
+  // Subprocesses log from their serving threads, which shouldn't wait on the
+  // launcher log or a slow terminal.
   if (instance.run_as_daemon()) {
-    LogToFiles({instance.launcher_log_path()});
+    LogToFiles({instance.launcher_log_path()}, "", LogDelivery::Asynchronous);
   } else {
-    LogToStderrAndFiles({instance.launcher_log_path()}, prefix, stderr_level);
+    LogToStderrAndFiles({instance.launcher_log_path()}, prefix, stderr_level,
+                        std::nullopt, LogDelivery::Asynchronous);
   }
 }
 
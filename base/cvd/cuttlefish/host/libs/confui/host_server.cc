@@ -21,7 +21,6 @@
 #include <optional>
 #include <tuple>
 
-#include "cuttlefish/common/libs/concurrency/thread_safe_queue.h"
 #include "cuttlefish/common/libs/confui/protocol.h"
 #include "cuttlefish/common/libs/confui/utils.h"
 #include "cuttlefish/common/libs/fs/shared_buf.h"
@@ -72,16 +71,12 @@ HostServer::HostServer(HostModeCtrl& host_mode_ctrl,
       host_mode_ctrl_(host_mode_ctrl),
       from_guest_fifo_fd_(fd_pair.from_guest_),
       to_guest_fifo_fd_(fd_pair.to_guest_) {
+  // When a queue is full, new items are discarded.
   const size_t max_elements = 20;
-  auto ignore_new =
-      [](ThreadSafeQueue<std::unique_ptr<ConfUiMessage>>::QueueImpl*) {
-        // no op, so the queue is still full, and the new item will be discarded
-        return;
-      };
   hal_cmd_q_id_ = input_multiplexer_.RegisterQueue(
-      HostServer::Multiplexer::CreateQueue(max_elements, ignore_new));
+      HostServer::Multiplexer::CreateQueue(max_elements));
   user_input_evt_q_id_ = input_multiplexer_.RegisterQueue(
-      HostServer::Multiplexer::CreateQueue(max_elements, ignore_new));
+      HostServer::Multiplexer::CreateQueue(max_elements));
 }
 
 bool HostServer::IsVirtioConsoleOpen() const {
@@ -31,8 +31,8 @@
 #include "teeui/utils.h"
 
 #include "cuttlefish/common/libs/concurrency/multiplexer.h"
+#include "cuttlefish/common/libs/concurrency/ring_queue.h"
 #include "cuttlefish/common/libs/concurrency/semaphore.h"
-#include "cuttlefish/common/libs/concurrency/thread_safe_queue.h"
 #include "cuttlefish/common/libs/confui/protocol.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/host/commands/kernel_log_monitor/utils.h"
@@ -144,9 +144,8 @@ class HostServer {
   SharedFD from_guest_fifo_fd_;
   SharedFD to_guest_fifo_fd_;
 
-  using Multiplexer =
-      Multiplexer<std::unique_ptr<ConfUiMessage>,
-                  ThreadSafeQueue<std::unique_ptr<ConfUiMessage>>>;
+  using Multiplexer = Multiplexer<std::unique_ptr<ConfUiMessage>,
+                                  MpmcQueue<std::unique_ptr<ConfUiMessage>>>;
   /*
    * Multiplexer has N queues. When pop(), it is going to sleep until
    * there's at least one item in at least one queue. The lower the Q
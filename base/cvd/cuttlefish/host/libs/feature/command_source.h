@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <functional>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -29,6 +31,18 @@ namespace cuttlefish {
 struct MonitorCommand {
   Command command;
   bool is_critical;
+  // Blocks until the subprocess is ready to be used. Commands that list this
+  // one in their `dependencies` are only started once it passed.
+  std::function<Result<void>()> readiness_probe;
+  // Names this command in the `dependencies` of others. Unique when set.
+  std::string id;
+  // Ids of the commands that have to be started, and past their readiness
+  // probes, before this one is started.
+  std::vector<std::string> dependencies;
+  // Part of the virtual machine monitor, i.e. the VMM itself or one of its
+  // vhost-user device backends, which may be placed apart from the host
+  // daemons. Set by the VmManager that builds the command.
+  bool is_vmm = false;
 
   MonitorCommand(Command command, bool is_critical = true)
       : command(std::move(command)), is_critical(is_critical) {}
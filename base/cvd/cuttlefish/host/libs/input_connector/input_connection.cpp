@@ -16,8 +16,15 @@
 
 #include "cuttlefish/host/libs/input_connector/input_connection.h"
 
+#include <limits.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "cuttlefish/common/libs/fs/shared_buf.h"
 #include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/host/libs/input_connector/event_buffer.h"
 #include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
@@ -32,4 +39,34 @@ Result<void> InputConnection::WriteEvents(const void* data, size_t len) {
   return {};
 }
 
+Result<void> InputConnection::WriteEvents(
+    const std::vector<EventBuffer>& buffers) {
+  std::vector<iovec> iov;
+  iov.reserve(std::min<size_t>(buffers.size(), IOV_MAX));
+  for (size_t start = 0; start < buffers.size(); start += IOV_MAX) {
+    iov.clear();
+    for (size_t i = start; i < std::min(start + IOV_MAX, buffers.size());
+         i++) {
+      iov.push_back(iovec{
+          .iov_base = const_cast<void*>(buffers[i].data()),
+          .iov_len = buffers[i].size(),
+      });
+    }
+    ssize_t written = conn_->Writev(iov.data(), iov.size());
+    CF_EXPECTF(written >= 0, "Failed to write events: {}", conn_->StrError());
+    // Short writes are rare on these sockets, finish them one buffer at a
+    // time.
+    for (const iovec& buffer : iov) {
+      if (written >= (ssize_t)buffer.iov_len) {
+        written -= buffer.iov_len;
+        continue;
+      }
+      const char* data = reinterpret_cast<const char*>(buffer.iov_base);
+      CF_EXPECT(WriteEvents(data + written, buffer.iov_len - written));
+      written = 0;
+    }
+  }
+  return {};
+}
+
 }  // namespace cuttlefish
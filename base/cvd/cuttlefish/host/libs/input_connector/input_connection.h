@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include <vector>
+
 #include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/host/libs/input_connector/event_buffer.h"
 #include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
@@ -29,6 +32,8 @@ class InputConnection {
   ~InputConnection() = default;
 
   Result<void> WriteEvents(const void* data, size_t len);
+  // Writes all buffers with as few system calls as possible.
+  Result<void> WriteEvents(const std::vector<EventBuffer>& buffers);
 
  private:
   SharedFD conn_;
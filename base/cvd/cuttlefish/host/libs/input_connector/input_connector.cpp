@@ -19,13 +19,16 @@
 #include <memory>
 #include <optional>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "absl/log/check.h"
 
 #include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/host/libs/input_connector/event_buffer.h"
 #include "cuttlefish/host/libs/input_connector/input_connection.h"
 #include "cuttlefish/host/libs/input_connector/input_devices.h"
+#include "cuttlefish/host/libs/input_connector/input_events.h"
 #include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
@@ -43,6 +46,129 @@ struct InputDevices {
   std::optional<GamepadDevice> gamepad;
 };
 
+// Sends each event through the corresponding EventSink method.
+struct SendEvent {
+  InputConnector::EventSink& sink;
+
+  Result<void> operator()(const MouseMoveEvent& event) {
+    return sink.SendMouseMoveEvent(event.x, event.y);
+  }
+  Result<void> operator()(const MouseButtonEvent& event) {
+    return sink.SendMouseButtonEvent(event.button, event.down);
+  }
+  Result<void> operator()(const MouseWheelEvent& event) {
+    return sink.SendMouseWheelEvent(event.pixels);
+  }
+  Result<void> operator()(const MultiTouchEvent& event) {
+    return sink.SendMultiTouchEvent(event.device_label, event.slots,
+                                    event.down);
+  }
+  Result<void> operator()(const KeyboardEvent& event) {
+    return sink.SendKeyboardEvent(event.code, event.down);
+  }
+  Result<void> operator()(const RotaryEvent& event) {
+    return sink.SendRotaryEvent(event.pixels);
+  }
+  Result<void> operator()(const GamepadKeyEvent& event) {
+    return sink.SendGamepadKeyEvent(event.code, event.down);
+  }
+  Result<void> operator()(const GamepadMotionEvent& event) {
+    return sink.SendGamepadMotionEvent(event.code, event.value);
+  }
+};
+
+// Collects the events of a batch by device, so that each device gets a single
+// write no matter how many events it received.
+class EventBatch {
+ public:
+  EventBatch(InputDevices& devices) : devices_(devices) {}
+
+  Result<void> operator()(const MouseMoveEvent& event) {
+    CF_EXPECT(devices_.mouse.has_value(), "No mouse device setup");
+    Add(*devices_.mouse, devices_.mouse->MoveEvents(event.x, event.y));
+    return {};
+  }
+  Result<void> operator()(const MouseButtonEvent& event) {
+    CF_EXPECT(devices_.mouse.has_value(), "No mouse device setup");
+    Add(*devices_.mouse,
+        CF_EXPECT(devices_.mouse->ButtonEvents(event.button, event.down)));
+    return {};
+  }
+  Result<void> operator()(const MouseWheelEvent& event) {
+    CF_EXPECT(devices_.mouse.has_value(), "No mouse device setup");
+    Add(*devices_.mouse, devices_.mouse->WheelEvents(event.pixels));
+    return {};
+  }
+  Result<void> operator()(const MultiTouchEvent& event) {
+    auto mt_it = devices_.multitouch_devices.find(event.device_label);
+    if (mt_it != devices_.multitouch_devices.end()) {
+      Add(mt_it->second,
+          mt_it->second.MultiTouchEvents(event.slots, event.down));
+      return {};
+    }
+    auto ts_it = devices_.touch_devices.find(event.device_label);
+    CF_EXPECT(ts_it != devices_.touch_devices.end(),
+              "Unknown touch device: " << event.device_label);
+    for (const auto& slot : event.slots) {
+      Add(ts_it->second, ts_it->second.TouchEvents(slot.x, slot.y, event.down));
+    }
+    return {};
+  }
+  Result<void> operator()(const KeyboardEvent& event) {
+    CF_EXPECT(devices_.keyboard.has_value(), "No keyboard device setup");
+    Add(*devices_.keyboard, devices_.keyboard->Events(event.code, event.down));
+    return {};
+  }
+  Result<void> operator()(const RotaryEvent& event) {
+    CF_EXPECT(devices_.rotary.has_value(), "No rotary device setup");
+    Add(*devices_.rotary, devices_.rotary->Events(event.pixels));
+    return {};
+  }
+  Result<void> operator()(const GamepadKeyEvent& event) {
+    CF_EXPECT(devices_.gamepad.has_value(), "No gamepad device setup");
+    Add(*devices_.gamepad, devices_.gamepad->KeyEvents(event.code, event.down));
+    return {};
+  }
+  Result<void> operator()(const GamepadMotionEvent& event) {
+    CF_EXPECT(devices_.gamepad.has_value(), "No gamepad device setup");
+    Add(*devices_.gamepad,
+        devices_.gamepad->MotionEvents(event.code, event.value));
+    return {};
+  }
+
+  Result<void> Write() {
+    for (auto& [device, buffers] : buffers_) {
+      CF_EXPECT(device->WriteEvents(buffers));
+    }
+    return {};
+  }
+
+ private:
+  void Add(InputDevice& device, EventBuffer buffer) {
+    // Only a handful of devices exist, a linear search keeps them in the order
+    // they were first used.
+    for (auto& [batch_device, buffers] : buffers_) {
+      if (batch_device == &device) {
+        buffers.emplace_back(std::move(buffer));
+        return;
+      }
+    }
+    buffers_.emplace_back(&device, std::vector<EventBuffer>{});
+    buffers_.back().second.emplace_back(std::move(buffer));
+  }
+
+  InputDevices& devices_;
+  std::vector<std::pair<InputDevice*, std::vector<EventBuffer>>> buffers_;
+};
+
+Result<void> InputConnector::EventSink::SendEvents(
+    const std::vector<InputEvent>& events) {
+  for (const InputEvent& event : events) {
+    CF_EXPECT(std::visit(SendEvent{.sink = *this}, event));
+  }
+  return {};
+}
+
 class EventSinkImpl : public InputConnector::EventSink {
  public:
   EventSinkImpl(InputDevices&, std::atomic<int>&);
@@ -61,6 +187,7 @@ class EventSinkImpl : public InputConnector::EventSink {
   Result<void> SendKeyboardEvent(uint16_t code, bool down) override;
   Result<void> SendRotaryEvent(int pixels) override;
   Result<void> SendSwitchesEvent(uint16_t code, bool state) override;
+  Result<void> SendEvents(const std::vector<InputEvent>& events) override;
 
  private:
   InputDevices& input_devices_;
@@ -155,6 +282,22 @@ Result<void> EventSinkImpl::SendSwitchesEvent(uint16_t code, bool state) {
   return {};
 }
 
+Result<void> EventSinkImpl::SendEvents(const std::vector<InputEvent>& events) {
+  EventBatch batch(input_devices_);
+  // Write the events that could be built even if others failed, the touch
+  // devices already updated their contact slots for them.
+  Result<void> res;
+  for (const InputEvent& event : events) {
+    Result<void> event_res = std::visit(batch, event);
+    if (!event_res.ok() && res.ok()) {
+      res = std::move(event_res);
+    }
+  }
+  CF_EXPECT(batch.Write());
+  CF_EXPECT(std::move(res));
+  return {};
+}
+
 class InputConnectorImpl : public InputConnector {
  public:
   InputConnectorImpl() = default;
@@ -20,16 +20,11 @@
 #include <vector>
 
 #include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/host/libs/input_connector/input_events.h"
 #include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
 
-struct MultitouchSlot {
-  int32_t id;
-  int32_t x;
-  int32_t y;
-};
-
 // The InputConnector encapsulates the components required to interact with the
 // Android VM. In order to send input events to the guest an EventSink must be
 // instantiated. The event sink should be destroyed when it is known no more
@@ -53,6 +48,9 @@ class InputConnector {
     virtual Result<void> SendKeyboardEvent(uint16_t code, bool down) = 0;
     virtual Result<void> SendRotaryEvent(int pixels) = 0;
     virtual Result<void> SendSwitchesEvent(uint16_t code, bool state) = 0;
+    // Sends the events in order. Implementations may write all events for the
+    // same device at once, the default sends them one by one.
+    virtual Result<void> SendEvents(const std::vector<InputEvent>& events);
   };
 
   virtual ~InputConnector() = default;
@@ -27,18 +27,33 @@ Result<void> InputDevice::WriteEvents(const EventBuffer& buffer) {
   return {};
 }
 
+Result<void> InputDevice::WriteEvents(const std::vector<EventBuffer>& buffers) {
+  CF_EXPECT(conn_.WriteEvents(buffers));
+  return {};
+}
+
 Result<void> TouchDevice::SendTouchEvent(int x, int y, bool down) {
+  CF_EXPECT(WriteEvents(TouchEvents(x, y, down)));
+  return {};
+}
+
+EventBuffer TouchDevice::TouchEvents(int x, int y, bool down) {
   EventBuffer buffer(4);
   buffer.AddEvent(EV_ABS, ABS_X, x);
   buffer.AddEvent(EV_ABS, ABS_Y, y);
   buffer.AddEvent(EV_KEY, BTN_TOUCH, down);
   buffer.AddEvent(EV_SYN, SYN_REPORT, 0);
-  CF_EXPECT(WriteEvents(buffer));
-  return {};
+  return buffer;
 }
 
 Result<void> TouchDevice::SendMultiTouchEvent(
     const std::vector<MultitouchSlot>& slots, bool down) {
+  CF_EXPECT(WriteEvents(MultiTouchEvents(slots, down)));
+  return {};
+}
+
+EventBuffer TouchDevice::MultiTouchEvents(
+    const std::vector<MultitouchSlot>& slots, bool down) {
   EventBuffer buffer(1 + 7 * slots.size());
 
   for (auto& f : slots) {
@@ -74,8 +89,7 @@ Result<void> TouchDevice::SendMultiTouchEvent(
   }
 
   buffer.AddEvent(EV_SYN, SYN_REPORT, 0);
-  CF_EXPECT(WriteEvents(buffer));
-  return {};
+  return buffer;
 }
 
 bool TouchDevice::HasSlot(void* source, int32_t id) {
@@ -132,14 +146,29 @@ int32_t TouchDevice::UseNewSlot() {
 }
 
 Result<void> MouseDevice::SendMoveEvent(int x, int y) {
+  CF_EXPECT(WriteEvents(MoveEvents(x, y)));
+  return {};
+}
+
+Result<void> MouseDevice::SendButtonEvent(int button, bool down) {
+  EventBuffer buffer = CF_EXPECT(ButtonEvents(button, down));
+  CF_EXPECT(WriteEvents(buffer));
+  return {};
+}
+
+Result<void> MouseDevice::SendWheelEvent(int pixels) {
+  CF_EXPECT(WriteEvents(WheelEvents(pixels)));
+  return {};
+}
+
+EventBuffer MouseDevice::MoveEvents(int x, int y) {
   EventBuffer buffer(2);
   buffer.AddEvent(EV_REL, REL_X, x);
   buffer.AddEvent(EV_REL, REL_Y, y);
-  CF_EXPECT(WriteEvents(buffer));
-  return {};
+  return buffer;
 }
 
-Result<void> MouseDevice::SendButtonEvent(int button, bool down) {
+Result<EventBuffer> MouseDevice::ButtonEvents(int button, bool down) {
   EventBuffer buffer(2);
   std::vector<int> buttons = {BTN_LEFT, BTN_MIDDLE, BTN_RIGHT, BTN_BACK,
                               BTN_FORWARD};
@@ -147,48 +176,62 @@ Result<void> MouseDevice::SendButtonEvent(int button, bool down) {
             "Unknown mouse event button: " << button);
   buffer.AddEvent(EV_KEY, buttons[button], down);
   buffer.AddEvent(EV_SYN, SYN_REPORT, 0);
-  CF_EXPECT(WriteEvents(buffer));
-  return {};
+  return buffer;
 }
 
-Result<void> MouseDevice::SendWheelEvent(int pixels) {
+EventBuffer MouseDevice::WheelEvents(int pixels) {
   EventBuffer buffer(2);
   buffer.AddEvent(EV_REL, REL_WHEEL, pixels);
   buffer.AddEvent(EV_SYN, SYN_REPORT, 0);
-  CF_EXPECT(WriteEvents(buffer));
-  return {};
+  return buffer;
 }
 
 Result<void> GamepadDevice::SendKeyEvent(int code, bool down) {
+  CF_EXPECT(WriteEvents(KeyEvents(code, down)));
+  return {};
+}
+
+EventBuffer GamepadDevice::KeyEvents(int code, bool down) {
   EventBuffer buffer(2);
   buffer.AddEvent(EV_KEY, code, down);
   buffer.AddEvent(EV_SYN, SYN_REPORT, 0);
-  CF_EXPECT(WriteEvents(buffer));
-  return {};
+  return buffer;
 }
 
 Result<void> GamepadDevice::SendMotionEvent(int code, int value) {
+  CF_EXPECT(WriteEvents(MotionEvents(code, value)));
+  return {};
+}
+
+EventBuffer GamepadDevice::MotionEvents(int code, int value) {
   EventBuffer buffer(2);
   buffer.AddEvent(EV_ABS, code, value);
   buffer.AddEvent(EV_SYN, SYN_REPORT, 0);
-  CF_EXPECT(WriteEvents(buffer));
-  return {};
+  return buffer;
 }
 
 Result<void> KeyboardDevice::SendEvent(uint16_t code, bool down) {
+  CF_EXPECT(WriteEvents(Events(code, down)));
+  return {};
+}
+
+EventBuffer KeyboardDevice::Events(uint16_t code, bool down) {
   EventBuffer buffer(2);
   buffer.AddEvent(EV_KEY, code, down);
   buffer.AddEvent(EV_SYN, SYN_REPORT, 0);
-  CF_EXPECT(WriteEvents(buffer));
-  return {};
+  return buffer;
 }
 
 Result<void> RotaryDevice::SendEvent(int pixels) {
+  CF_EXPECT(WriteEvents(Events(pixels)));
+  return {};
+}
+
+EventBuffer RotaryDevice::Events(int pixels) {
   EventBuffer buffer(2);
   buffer.AddEvent(EV_REL, REL_WHEEL, pixels);
   buffer.AddEvent(EV_SYN, SYN_REPORT, 0);
-  CF_EXPECT(WriteEvents(buffer));
-  return {};
+  return buffer;
 }
 
 Result<void> SwitchesDevice::SendEvent(uint16_t code, bool state) {
@@ -36,6 +36,9 @@ class InputDevice {
   InputDevice(InputConnection conn) : conn_(conn) {}
   virtual ~InputDevice() = default;
 
+  // Writes buffers produced by the *Events() methods of the subclasses.
+  Result<void> WriteEvents(const std::vector<EventBuffer>& buffers);
+
  protected:
   Result<void> WriteEvents(const EventBuffer& buffer);
 
@@ -48,9 +51,13 @@ class TouchDevice : public InputDevice {
   TouchDevice(InputConnection conn) : InputDevice(conn) {}
 
   Result<void> SendTouchEvent(int x, int y, bool down);
+  EventBuffer TouchEvents(int x, int y, bool down);
 
   Result<void> SendMultiTouchEvent(const std::vector<MultitouchSlot>& slots,
                                    bool down);
+  // Updates the contact slots as if the events were already sent.
+  EventBuffer MultiTouchEvents(const std::vector<MultitouchSlot>& slots,
+                               bool down);
 
   // The InputConnector holds state of on-going touch contacts. Event sources
   // that can't produce multi touch events should call this function when it's
@@ -89,6 +96,10 @@ class MouseDevice : public InputDevice {
   Result<void> SendMoveEvent(int x, int y);
   Result<void> SendButtonEvent(int button, bool down);
   Result<void> SendWheelEvent(int pixels);
+
+  EventBuffer MoveEvents(int x, int y);
+  Result<EventBuffer> ButtonEvents(int button, bool down);
+  EventBuffer WheelEvents(int pixels);
 };
 
 class GamepadDevice : public InputDevice {
@@ -97,6 +108,9 @@ class GamepadDevice : public InputDevice {
 
   Result<void> SendKeyEvent(int code, bool down);
   Result<void> SendMotionEvent(int code, int value);
+
+  EventBuffer KeyEvents(int code, bool down);
+  EventBuffer MotionEvents(int code, int value);
 };
 
 class KeyboardDevice : public InputDevice {
@@ -104,6 +118,7 @@ class KeyboardDevice : public InputDevice {
   KeyboardDevice(InputConnection conn) : InputDevice(conn) {}
 
   Result<void> SendEvent(uint16_t code, bool down);
+  EventBuffer Events(uint16_t code, bool down);
 };
 
 class RotaryDevice : public InputDevice {
@@ -111,6 +126,7 @@ class RotaryDevice : public InputDevice {
   RotaryDevice(InputConnection conn) : InputDevice(conn) {}
 
   Result<void> SendEvent(int pixels);
+  EventBuffer Events(int pixels);
 };
 
 class SwitchesDevice : public InputDevice {
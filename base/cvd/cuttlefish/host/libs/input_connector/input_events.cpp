@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/libs/input_connector/input_events.h"
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace cuttlefish {
+namespace {
+
+bool SameContacts(const MultiTouchEvent& a, const MultiTouchEvent& b) {
+  if (a.device_label != b.device_label || a.slots.size() != b.slots.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.slots.size(); i++) {
+    if (a.slots[i].id != b.slots[i].id) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+void CoalesceMotionEvents(std::vector<InputEvent>& events) {
+  std::vector<InputEvent> coalesced;
+  coalesced.reserve(events.size());
+  // Contacts that were down before the last event in `coalesced`.
+  std::set<std::pair<std::string, int32_t>> down_contacts;
+  bool last_is_touch_move = false;
+
+  for (InputEvent& event : events) {
+    if (auto* move = std::get_if<MouseMoveEvent>(&event)) {
+      if (!coalesced.empty()) {
+        if (auto* last = std::get_if<MouseMoveEvent>(&coalesced.back())) {
+          last->x += move->x;
+          last->y += move->y;
+          continue;
+        }
+      }
+    } else if (auto* touch = std::get_if<MultiTouchEvent>(&event)) {
+      if (touch->down && last_is_touch_move) {
+        auto& last = std::get<MultiTouchEvent>(coalesced.back());
+        if (SameContacts(last, *touch)) {
+          last.slots = std::move(touch->slots);
+          continue;
+        }
+      }
+      bool is_move = touch->down;
+      for (const MultitouchSlot& slot : touch->slots) {
+        auto contact = std::make_pair(touch->device_label, slot.id);
+        if (touch->down) {
+          is_move &= !down_contacts.insert(contact).second;
+        } else {
+          down_contacts.erase(contact);
+        }
+      }
+      coalesced.emplace_back(std::move(event));
+      last_is_touch_move = is_move;
+      continue;
+    }
+    coalesced.emplace_back(std::move(event));
+    last_is_touch_move = false;
+  }
+  events = std::move(coalesced);
+}
+
+}  // namespace cuttlefish
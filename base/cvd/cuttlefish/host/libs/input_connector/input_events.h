@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace cuttlefish {
+
+struct MultitouchSlot {
+  int32_t id;
+  int32_t x;
+  int32_t y;
+};
+
+// Relative motion, like the one reported by a mouse in pointer lock mode.
+struct MouseMoveEvent {
+  int32_t x;
+  int32_t y;
+};
+
+struct MouseButtonEvent {
+  int32_t button;
+  bool down;
+};
+
+struct MouseWheelEvent {
+  int32_t pixels;
+};
+
+struct MultiTouchEvent {
+  std::string device_label;
+  std::vector<MultitouchSlot> slots;
+  bool down;
+};
+
+struct KeyboardEvent {
+  uint16_t code;
+  bool down;
+};
+
+struct RotaryEvent {
+  int32_t pixels;
+};
+
+struct GamepadKeyEvent {
+  int32_t code;
+  bool down;
+};
+
+struct GamepadMotionEvent {
+  int32_t code;
+  int32_t value;
+};
+
+using InputEvent =
+    std::variant<MouseMoveEvent, MouseButtonEvent, MouseWheelEvent,
+                 MultiTouchEvent, KeyboardEvent, RotaryEvent, GamepadKeyEvent,
+                 GamepadMotionEvent>;
+
+// Merges motion events that would be overwritten by a later event before the
+// guest could observe them, keeping the order of everything else:
+// - Consecutive mouse moves are added together.
+// - A multi touch move is replaced by an immediately following move of the
+//   same contacts. The first event of each contact in the batch is kept, since
+//   it may be the one starting the contact.
+void CoalesceMotionEvents(std::vector<InputEvent>& events);
+
+}  // namespace cuttlefish
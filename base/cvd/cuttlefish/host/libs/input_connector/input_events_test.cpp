@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/libs/input_connector/input_events.h"
+
+#include <variant>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace cuttlefish {
+namespace {
+
+MultiTouchEvent Touch(int32_t id, int32_t x, bool down) {
+  return MultiTouchEvent{
+      .device_label = "display_0",
+      .slots = {MultitouchSlot{.id = id, .x = x, .y = 0}},
+      .down = down,
+  };
+}
+
+int32_t TouchX(const InputEvent& event) {
+  return std::get<MultiTouchEvent>(event).slots[0].x;
+}
+
+TEST(CoalesceMotionEventsTest, AddsConsecutiveMouseMoves) {
+  std::vector<InputEvent> events = {
+      MouseMoveEvent{.x = 1, .y = 2},
+      MouseMoveEvent{.x = 3, .y = -1},
+      MouseButtonEvent{.button = 0, .down = true},
+      MouseMoveEvent{.x = 5, .y = 5},
+  };
+
+  CoalesceMotionEvents(events);
+
+  ASSERT_EQ(events.size(), 3);
+  EXPECT_EQ(std::get<MouseMoveEvent>(events[0]).x, 4);
+  EXPECT_EQ(std::get<MouseMoveEvent>(events[0]).y, 1);
+  EXPECT_TRUE(std::holds_alternative<MouseButtonEvent>(events[1]));
+  EXPECT_EQ(std::get<MouseMoveEvent>(events[2]).x, 5);
+}
+
+TEST(CoalesceMotionEventsTest, KeepsTouchStartAndLastMove) {
+  std::vector<InputEvent> events = {
+      Touch(1, 10, true), Touch(1, 20, true), Touch(1, 30, true),
+      Touch(1, 40, true), Touch(1, 40, false),
+  };
+
+  CoalesceMotionEvents(events);
+
+  ASSERT_EQ(events.size(), 3);
+  EXPECT_EQ(TouchX(events[0]), 10);
+  EXPECT_EQ(TouchX(events[1]), 40);
+  EXPECT_TRUE(std::get<MultiTouchEvent>(events[1]).down);
+  EXPECT_FALSE(std::get<MultiTouchEvent>(events[2]).down);
+}
+
+TEST(CoalesceMotionEventsTest, DoesNotMergeDifferentContacts) {
+  std::vector<InputEvent> events = {
+      Touch(1, 10, true), Touch(2, 10, true),
+      Touch(1, 20, true), Touch(2, 20, true),
+  };
+
+  CoalesceMotionEvents(events);
+
+  EXPECT_EQ(events.size(), 4);
+}
+
+}  // namespace
+}  // namespace cuttlefish
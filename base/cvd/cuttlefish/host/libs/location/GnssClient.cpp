@@ -23,6 +23,7 @@
 #include "absl/log/log.h"
 #include "grpcpp/channel.h"
 #include "grpcpp/support/status.h"
+#include "grpcpp/support/sync_stream.h"
 
 #include "cuttlefish/result/result.h"
 
@@ -33,6 +34,66 @@ using gnss_grpc_proxy::SendGpsCoordinatesRequest;
 using grpc::ClientContext;
 
 namespace cuttlefish {
+namespace {
+
+// About 16 bytes per coordinate on the wire.
+constexpr int kBatchSize = 1024;
+
+}  // namespace
+
+GpsLocationStream::GpsLocationStream(GnssGrpcProxy::Stub& stub, int delay)
+    : writer_(stub.StreamGpsVector(&context_, &reply_)) {
+  batch_.set_delay(delay);
+}
+
+GpsLocationStream::~GpsLocationStream() {
+  if (!finished_) {
+    context_.TryCancel();
+  }
+}
+
+Result<void> GpsLocationStream::Send(const GpsFix& fix) {
+  CF_EXPECT(!finished_, "The stream is already finished");
+  GpsCoordinates* curr = batch_.add_coordinates();
+  curr->set_longitude(fix.longitude);
+  curr->set_latitude(fix.latitude);
+  curr->set_elevation(fix.elevation);
+  if (batch_.coordinates_size() >= kBatchSize) {
+    CF_EXPECT(Flush());
+  }
+  return {};
+}
+
+Result<void> GpsLocationStream::Flush() {
+  // An empty first batch still clears the proxy's queue.
+  if (batch_.coordinates_size() > 0 || !sent_) {
+    if (!writer_->Write(batch_)) {
+      finished_ = true;
+      grpc::Status status = writer_->Finish();
+      return CF_ERRF("GPS data sending failed: {} ({})",
+                     status.error_message(),
+                     static_cast<uint32_t>(status.error_code()));
+    }
+    batch_.clear_coordinates();
+    sent_ = true;
+  }
+  return {};
+}
+
+Result<void> GpsLocationStream::Finish() {
+  CF_EXPECT(!finished_, "The stream is already finished");
+  CF_EXPECT(Flush());
+  finished_ = true;
+  writer_->WritesDone();
+  grpc::Status status = writer_->Finish();
+  CF_EXPECTF(status.ok(), "GPS data sending failed: {} ({})",
+             status.error_message(),
+             static_cast<uint32_t>(status.error_code()));
+
+  VLOG(0) << reply_.status();
+
+  return {};
+}
 
 GnssClient::GnssClient(const std::shared_ptr<grpc::Channel>& channel)
     : stub_(GnssGrpcProxy::NewStub(channel)) {}
@@ -66,4 +127,9 @@ Result<void> GnssClient::SendGpsLocations(int delay,
   return {};
 }
 
+std::unique_ptr<GpsLocationStream> GnssClient::StreamGpsLocations(int delay) {
+  return std::unique_ptr<GpsLocationStream>(
+      new GpsLocationStream(*stub_, delay));
+}
+
 }  // namespace cuttlefish
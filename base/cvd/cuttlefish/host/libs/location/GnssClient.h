@@ -19,6 +19,7 @@
 
 #include "grpcpp/channel.h"
 #include "grpcpp/client_context.h"
+#include "grpcpp/support/sync_stream.h"
 
 #include "cuttlefish/host/commands/gnss_grpc_proxy/gnss_grpc_proxy.grpc.pb.h"
 #include "cuttlefish/host/libs/location/GpsFix.h"
@@ -26,11 +27,40 @@
 
 namespace cuttlefish {
 
+// Sends fixes to the proxy in batches as they are produced, over a single
+// call. The proxy starts replaying the first batch while later ones are still
+// being read. Destroying an unfinished stream cancels it.
+class GpsLocationStream {
+ public:
+  ~GpsLocationStream();
+
+  Result<void> Send(const GpsFix& fix);
+  // Sends the last batch and waits for the proxy to accept the stream.
+  Result<void> Finish();
+
+ private:
+  friend class GnssClient;
+
+  GpsLocationStream(gnss_grpc_proxy::GnssGrpcProxy::Stub& stub, int delay);
+
+  Result<void> Flush();
+
+  grpc::ClientContext context_;
+  gnss_grpc_proxy::SendGpsCoordinatesReply reply_;
+  std::unique_ptr<
+      grpc::ClientWriter<gnss_grpc_proxy::SendGpsCoordinatesRequest>>
+      writer_;
+  gnss_grpc_proxy::SendGpsCoordinatesRequest batch_;
+  bool sent_ = false;
+  bool finished_ = false;
+};
+
 class GnssClient {
  public:
   GnssClient(const std::shared_ptr<grpc::Channel>& channel);
 
   Result<void> SendGpsLocations(int delay, const GpsFixArray& coordinates);
+  std::unique_ptr<GpsLocationStream> StreamGpsLocations(int delay);
 
  private:
   std::unique_ptr<gnss_grpc_proxy::GnssGrpcProxy::Stub> stub_;
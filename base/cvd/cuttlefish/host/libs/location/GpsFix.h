@@ -18,9 +18,12 @@
 
 #include <time.h>
 
+#include <functional>
 #include <string>
 #include <vector>
 
+#include "cuttlefish/result/result.h"
+
 // A struct representing a location on a map
 struct GpsFix {
   std::string name;
@@ -34,3 +37,7 @@ struct GpsFix {
 };
 
 typedef std::vector<GpsFix> GpsFixArray;
+
+// Receives fixes one at a time while a document is parsed. Returning an error
+// stops parsing.
+using GpsFixCallback = std::function<cuttlefish::Result<void>(const GpsFix&)>;
@@ -0,0 +1,212 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/location/GpsTrack.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "cuttlefish/host/libs/location/GpsFix.h"
+#include "cuttlefish/host/libs/location/MappedFile.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+// File layout: the header, then the columns
+//   int64_t time[count]
+//   float latitude[count], longitude[count], elevation[count]
+//   uint32_t text_end[2 * count], the end of each name and description
+// and finally the names and descriptions.
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t count;
+  uint64_t text_size;
+};
+static_assert(sizeof(Header) == 32);
+
+constexpr char kMagic[8] = {'C', 'F', 'G', 'P', 'S', 'T', 'R', 'K'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kBytesPerFix =
+    sizeof(int64_t) + 3 * sizeof(float) + 2 * sizeof(uint32_t);
+
+// Column offsets for a track of `count` fixes.
+constexpr size_t TimeColumn() { return sizeof(Header); }
+constexpr size_t LatitudeColumn(size_t count) {
+  return TimeColumn() + count * sizeof(int64_t);
+}
+constexpr size_t LongitudeColumn(size_t count) {
+  return LatitudeColumn(count) + count * sizeof(float);
+}
+constexpr size_t ElevationColumn(size_t count) {
+  return LongitudeColumn(count) + count * sizeof(float);
+}
+constexpr size_t TextEndColumn(size_t count) {
+  return ElevationColumn(count) + count * sizeof(float);
+}
+constexpr size_t TextStart(size_t count) {
+  return sizeof(Header) + count * kBytesPerFix;
+}
+
+// The columns are naturally aligned in the file, but a copy read from
+// elsewhere might not be.
+template <typename T>
+T Load(std::string_view bytes, size_t offset) {
+  T value;
+  memcpy(&value, bytes.data() + offset, sizeof(value));
+  return value;
+}
+
+template <typename T>
+void Append(std::string& out, const std::vector<T>& column) {
+  out.append(reinterpret_cast<const char*>(column.data()),
+             column.size() * sizeof(T));
+}
+
+}  // namespace
+
+void GpsTrackWriter::Add(const GpsFix& fix) {
+  times_.push_back(fix.time);
+  latitudes_.push_back(fix.latitude);
+  longitudes_.push_back(fix.longitude);
+  elevations_.push_back(fix.elevation);
+  text_.append(fix.name);
+  text_ends_.push_back(text_.size());
+  text_.append(fix.description);
+  text_ends_.push_back(text_.size());
+}
+
+Result<std::string> GpsTrackWriter::Serialize() const {
+  CF_EXPECT_LE(text_.size(), std::numeric_limits<uint32_t>::max(),
+               "Too much text in the track");
+  Header header = {};
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.count = times_.size();
+  header.text_size = text_.size();
+
+  std::string out;
+  out.reserve(TextStart(times_.size()) + text_.size());
+  out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  Append(out, times_);
+  Append(out, latitudes_);
+  Append(out, longitudes_);
+  Append(out, elevations_);
+  Append(out, text_ends_);
+  out.append(text_);
+  return out;
+}
+
+Result<void> GpsTrackWriter::WriteToFile(const std::string& path) const {
+  CF_EXPECT(WriteMappedFile(path, CF_EXPECT(Serialize())));
+  return {};
+}
+
+GpsTrack::GpsTrack(MappedFile file)
+    : file_(std::move(file)), bytes_(file_.bytes()) {}
+
+Result<std::unique_ptr<GpsTrack>> GpsTrack::FromBytes(std::string bytes) {
+  std::unique_ptr<GpsTrack> track(
+      new GpsTrack(MappedFile(std::move(bytes))));
+  CF_EXPECT(track->Validate());
+  return track;
+}
+
+Result<std::unique_ptr<GpsTrack>> GpsTrack::Map(const std::string& path) {
+  std::unique_ptr<GpsTrack> track(
+      new GpsTrack(CF_EXPECT(MappedFile::Map(path))));
+  CF_EXPECTF(track->Validate(), "Invalid track '{}'", path);
+  return track;
+}
+
+Result<void> GpsTrack::Validate() {
+  CF_EXPECT(ValidateMappedFileHeader(bytes_, sizeof(Header),
+                                     std::string_view(kMagic, sizeof(kMagic)),
+                                     kVersion),
+            "Not a GPS track");
+  Header header = Load<Header>(bytes_, 0);
+  CF_EXPECT_LE(header.count, (bytes_.size() - sizeof(Header)) / kBytesPerFix,
+               "Truncated columns");
+  size_ = header.count;
+  CF_EXPECT_EQ(header.text_size, bytes_.size() - TextStart(size_),
+               "Wrong text size");
+
+  uint32_t previous_end = 0;
+  for (size_t i = 0; i < 2 * size_; i++) {
+    uint32_t end = TextEnd(i);
+    CF_EXPECTF(end >= previous_end && end <= header.text_size,
+               "Text of fix {} is out of bounds", i / 2);
+    previous_end = end;
+  }
+  return {};
+}
+
+uint32_t GpsTrack::TextEnd(size_t index) const {
+  return Load<uint32_t>(bytes_,
+                        TextEndColumn(size_) + index * sizeof(uint32_t));
+}
+
+std::string_view GpsTrack::Text(size_t index) const {
+  uint32_t start = index == 0 ? 0 : TextEnd(index - 1);
+  return bytes_.substr(TextStart(size_) + start, TextEnd(index) - start);
+}
+
+time_t GpsTrack::Time(size_t index) const {
+  return Load<int64_t>(bytes_, TimeColumn() + index * sizeof(int64_t));
+}
+
+float GpsTrack::Latitude(size_t index) const {
+  return Load<float>(bytes_, LatitudeColumn(size_) + index * sizeof(float));
+}
+
+float GpsTrack::Longitude(size_t index) const {
+  return Load<float>(bytes_, LongitudeColumn(size_) + index * sizeof(float));
+}
+
+float GpsTrack::Elevation(size_t index) const {
+  return Load<float>(bytes_, ElevationColumn(size_) + index * sizeof(float));
+}
+
+std::string_view GpsTrack::Name(size_t index) const {
+  return Text(2 * index);
+}
+
+std::string_view GpsTrack::Description(size_t index) const {
+  return Text(2 * index + 1);
+}
+
+GpsFix GpsTrack::At(size_t index) const {
+  GpsFix fix;
+  fix.name = Name(index);
+  fix.description = Description(index);
+  fix.latitude = Latitude(index);
+  fix.longitude = Longitude(index);
+  fix.elevation = Elevation(index);
+  fix.time = Time(index);
+  return fix;
+}
+
+}  // namespace cuttlefish
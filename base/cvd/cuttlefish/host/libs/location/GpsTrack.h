@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cuttlefish/host/libs/location/GpsFix.h"
+#include "cuttlefish/host/libs/location/MappedFile.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+// Collects fixes into the columnar track format read by GpsTrack, which takes
+// 28 bytes per fix plus its name and description.
+class GpsTrackWriter {
+ public:
+  void Add(const GpsFix& fix);
+  size_t size() const { return times_.size(); }
+
+  Result<std::string> Serialize() const;
+  // Replaces `path` atomically, so readers never map a partial track.
+  Result<void> WriteToFile(const std::string& path) const;
+
+ private:
+  std::vector<int64_t> times_;
+  std::vector<float> latitudes_;
+  std::vector<float> longitudes_;
+  std::vector<float> elevations_;
+  // The end of each fix's name and then description in `text_`.
+  std::vector<uint32_t> text_ends_;
+  std::string text_;
+};
+
+// A read-only sequence of fixes stored column by column. When mapped from a
+// file, reading a column only touches that column's pages.
+class GpsTrack {
+ public:
+  static Result<std::unique_ptr<GpsTrack>> FromBytes(std::string bytes);
+  static Result<std::unique_ptr<GpsTrack>> Map(const std::string& path);
+
+  size_t size() const { return size_; }
+  time_t Time(size_t index) const;
+  float Latitude(size_t index) const;
+  float Longitude(size_t index) const;
+  float Elevation(size_t index) const;
+  std::string_view Name(size_t index) const;
+  std::string_view Description(size_t index) const;
+
+  GpsFix At(size_t index) const;
+
+ private:
+  explicit GpsTrack(MappedFile file);
+
+  Result<void> Validate();
+  uint32_t TextEnd(size_t index) const;
+  std::string_view Text(size_t index) const;
+
+  MappedFile file_;
+  std::string_view bytes_;
+  size_t size_ = 0;
+};
+
+}  // namespace cuttlefish
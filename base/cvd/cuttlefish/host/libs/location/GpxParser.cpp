@@ -16,212 +16,245 @@
 
 #include "cuttlefish/host/libs/location/GpxParser.h"
 
-#include <string.h>
+#include <stdio.h>
 #include <time.h>
 
 #include <algorithm>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
-#include "libxml/parser.h"
+#include "absl/strings/numbers.h"
+#include "fmt/format.h"
 
-#include "cuttlefish/host/libs/location/StringParse.h"
+#include "cuttlefish/host/libs/location/XmlStreamParser.h"
+#include "cuttlefish/result/result.h"
 
-// format an error message
-template <class... Args>
-static std::string formatError(const char* format, Args&&... args) {
-  char buf[100] = {};
-  snprintf(buf, sizeof(buf) - 1, format, std::forward<Args>(args)...);
-  return buf;
-}
+namespace cuttlefish {
+namespace {
+
+enum class PointField { kNone, kTime, kElevation, kName, kDescription };
 
-static void cleanupXmlDoc(xmlDoc* doc) {
-  xmlFreeDoc(doc);
-  xmlCleanupParser();
+PointField fieldNamed(std::string_view name) {
+  if (name == "time") {
+    return PointField::kTime;
+  } else if (name == "ele") {
+    return PointField::kElevation;
+  } else if (name == "name") {
+    return PointField::kName;
+  } else if (name == "desc") {
+    return PointField::kDescription;
+  }
+  return PointField::kNone;
 }
 
-static bool parseLocation(xmlNode* ptNode, xmlDoc* doc, GpsFix* result,
-                          std::string* error) {
-  float latitude;
-  float longitude;
-
-  xmlAttrPtr attr;
-  xmlChar* tmpStr;
-
-  // Check for and get the latitude attribute
-  attr = xmlHasProp(ptNode, (const xmlChar*)"lat");
-  if (!attr || !(tmpStr = xmlGetProp(ptNode, (const xmlChar*)"lat"))) {
-    *error = formatError("Point missing a latitude on line %d.", ptNode->line);
-    return false;  // Return error since a point *must* have a latitude
-  } else {
-    int read = SscanfWithCLocale(reinterpret_cast<const char*>(tmpStr), "%f",
-                                 &latitude);
-    xmlFree(tmpStr);  // Caller-freed
-    if (read != 1) {
-      return false;
+// Reads <wpt> elements under the root, <rtept> elements under <rte> and
+// <trkpt> elements under <trk><trkseg>. Only the point being read is kept.
+class GpxHandler : public XmlHandler {
+ public:
+  explicit GpxHandler(const GpsFixCallback& onFix) : onFix_(onFix) {}
+
+  // Describes the invalid point that stopped parsing, if any.
+  const std::string& error() const { return error_; }
+
+  Result<void> StartElement(const XmlElement& element) override {
+    if (inPoint_) {
+      if (path_.size() == pointDepth_ + 1) {
+        field_ = fieldNamed(element.name);
+        text_.clear();
+      }
+    } else if (isPoint(element.name)) {
+      CF_EXPECT(startPoint(element));
+    }
+    path_.emplace_back(element.name);
+    return {};
+  }
+
+  Result<void> EndElement(const XmlElement&) override {
+    path_.pop_back();
+    if (!inPoint_) {
+      return {};
+    }
+    if (path_.size() == pointDepth_ + 1 && field_ != PointField::kNone) {
+      CF_EXPECT(endField());
+      field_ = PointField::kNone;
+    } else if (path_.size() == pointDepth_) {
+      inPoint_ = false;
+      CF_EXPECT(onFix_(fix_));
+    }
+    return {};
+  }
+
+  Result<void> Text(std::string_view text) override {
+    // Text of elements nested in a field is not part of it.
+    if (field_ != PointField::kNone && path_.size() == pointDepth_ + 2) {
+      text_.append(text);
     }
+    return {};
   }
 
-  // Check for and get the longitude attribute
-  attr = xmlHasProp(ptNode, (const xmlChar*)"lon");
-  if (!attr || !(tmpStr = xmlGetProp(ptNode, (const xmlChar*)"lon"))) {
-    *error = formatError("Point missing a longitude on line %d.", ptNode->line);
-    return false;  // Return error since a point *must* have a longitude
-  } else {
-    int read = SscanfWithCLocale(reinterpret_cast<const char*>(tmpStr), "%f",
-                                 &longitude);
-    xmlFree(tmpStr);  // Caller-freed
-    if (read != 1) {
-      return false;
+ private:
+  bool isPoint(std::string_view name) const {
+    switch (path_.size()) {
+      case 1:
+        return name == "wpt";
+      case 2:
+        return path_[1] == "rte" && name == "rtept";
+      case 3:
+        return path_[1] == "trk" && path_[2] == "trkseg" && name == "trkpt";
+      default:
+        return false;
     }
   }
 
-  // The result will be valid if this point is reached
-  result->latitude = latitude;
-  result->longitude = longitude;
+  Result<void> startPoint(const XmlElement& element) {
+    // Fields are optional, so they must not leak from the previous point.
+    fix_ = GpsFix();
+    // A point *must* have a latitude and a longitude.
+    fix_.latitude = CF_EXPECT(coordinate(element, "lat", "latitude"));
+    fix_.longitude = CF_EXPECT(coordinate(element, "lon", "longitude"));
+    inPoint_ = true;
+    pointDepth_ = path_.size();
+    pointLine_ = element.line;
+    field_ = PointField::kNone;
+    return {};
+  }
 
-  // Check for potential children nodes (including time, elevation, name, and
-  // description) Note that none are actually required according to the GPX
-  // format.
-  int childCount = 0;
-  for (xmlNode* field = ptNode->children; field; field = field->next) {
-    tmpStr = nullptr;
+  Result<float> coordinate(const XmlElement& element,
+                           std::string_view attribute, std::string_view what) {
+    std::optional<std::string_view> value = element.Attribute(attribute);
+    if (!value) {
+      return fail(
+          fmt::format("Point missing a {} on line {}.", what, element.line));
+    }
+    float result;
+    if (!absl::SimpleAtof(*value, &result)) {
+      return fail(
+          fmt::format("Invalid {} on line {}.", what, element.line));
+    }
+    return result;
+  }
 
-    if (!strcmp((const char*)field->name, "time")) {
-      if ((tmpStr = xmlNodeListGetString(doc, field->children, 1))) {
-        // Convert to a number
+  Result<void> endField() {
+    // Empty elements leave the field unset.
+    if (text_.empty()) {
+      return {};
+    }
+    switch (field_) {
+      case PointField::kTime: {
         struct tm time = {};
-        time.tm_isdst = -1;
-        int results = sscanf((const char*)tmpStr, "%u-%u-%uT%u:%u:%u",
+        int results = sscanf(text_.c_str(), "%u-%u-%uT%u:%u:%u",
                              &time.tm_year, &time.tm_mon, &time.tm_mday,
                              &time.tm_hour, &time.tm_min, &time.tm_sec);
         if (results != 6) {
-          *error = formatError(
-              "Improperly formatted time on line %d.<br/>"
+          return fail(fmt::format(
+              "Improperly formatted time on line {}.<br/>"
               "Times must be in ISO format.",
-              ptNode->line);
-          return false;
+              pointLine_));
         }
-
         // Correct according to the struct tm specification
         time.tm_year -= 1900;  // Years since 1900
         time.tm_mon -= 1;      // Months since January, 0-11
-
-        result->time = mktime(&time);
-        xmlFree(tmpStr);  // Caller-freed
-        childCount++;
+        // GPX times are UTC, and local time would misorder fixes around
+        // daylight saving changes.
+        fix_.time = timegm(&time);
+        break;
       }
-    } else if (!strcmp((const char*)field->name, "ele")) {
-      if ((tmpStr = xmlNodeListGetString(doc, field->children, 1))) {
-        int read = SscanfWithCLocale(reinterpret_cast<const char*>(tmpStr),
-                                     "%f", &result->elevation);
-        xmlFree(tmpStr);  // Caller-freed
-        if (read != 1) {
-          return false;
+      case PointField::kElevation:
+        if (!absl::SimpleAtof(text_, &fix_.elevation)) {
+          return fail(fmt::format("Invalid elevation on line {}.", pointLine_));
         }
-        childCount++;
-      }
-    } else if (!strcmp((const char*)field->name, "name")) {
-      if ((tmpStr = xmlNodeListGetString(doc, field->children, 1))) {
-        result->name = reinterpret_cast<const char*>(tmpStr);
-        xmlFree(tmpStr);  // Caller-freed
-        childCount++;
-      }
-    } else if (!strcmp((const char*)field->name, "desc")) {
-      if ((tmpStr = xmlNodeListGetString(doc, field->children, 1))) {
-        result->description = reinterpret_cast<const char*>(tmpStr);
-        xmlFree(tmpStr);  // Caller-freed
-        childCount++;
-      }
-    }
-
-    // We only care about 4 potential child fields, so quit after finding those
-    if (childCount == 4) {
-      break;
+        break;
+      case PointField::kName:
+        fix_.name = std::move(text_);
+        break;
+      case PointField::kDescription:
+        fix_.description = std::move(text_);
+        break;
+      case PointField::kNone:
+        break;
     }
+    text_.clear();
+    return {};
   }
 
-  return true;
-}
-
-static bool parse(xmlDoc* doc, GpsFixArray* fixes, std::string* error) {
-  xmlNode* root = xmlDocGetRootElement(doc);
-  GpsFix location;
-  bool isOk;
-
-  for (xmlNode* child = root->children; child; child = child->next) {
-    // Individual <wpt> elements are parsed on their own
-    if (!strcmp((const char*)child->name, "wpt")) {
-      isOk = parseLocation(child, doc, &location, error);
-      if (!isOk) {
-        cleanupXmlDoc(doc);
-        return false;
-      }
-      fixes->push_back(location);
-    }
+  StackTraceError fail(std::string message) {
+    error_ = message;
+    return CF_ERR(message);
+  }
 
-    // <rte> elements require an additional depth of parsing
-    else if (!strcmp((const char*)child->name, "rte")) {
-      for (xmlNode* rtept = child->children; rtept; rtept = rtept->next) {
-        // <rtept> elements are parsed just like <wpt> elements
-        if (!strcmp((const char*)rtept->name, "rtept")) {
-          isOk = parseLocation(rtept, doc, &location, error);
-          if (!isOk) {
-            cleanupXmlDoc(doc);
-            return false;
-          }
-          fixes->push_back(location);
-        }
-      }
-    }
+  const GpsFixCallback& onFix_;
+  std::vector<std::string> path_;
+  bool inPoint_ = false;
+  size_t pointDepth_ = 0;
+  int pointLine_ = 0;
+  PointField field_ = PointField::kNone;
+  std::string text_;
+  GpsFix fix_;
+  std::string error_;
+};
 
-    // <trk> elements require two additional depths of parsing
-    else if (!strcmp((const char*)child->name, "trk")) {
-      for (xmlNode* trkseg = child->children; trkseg; trkseg = trkseg->next) {
-        // Skip non <trkseg> elements
-        if (!strcmp((const char*)trkseg->name, "trkseg")) {
-          // <trkseg> elements an additional depth of parsing
-          for (xmlNode* trkpt = trkseg->children; trkpt; trkpt = trkpt->next) {
-            // <trkpt> elements are parsed just like <wpt> elements
-            if (!strcmp((const char*)trkpt->name, "trkpt")) {
-              isOk = parseLocation(trkpt, doc, &location, error);
-              if (!isOk) {
-                cleanupXmlDoc(doc);
-                return false;
-              }
-              fixes->push_back(location);
-            }
-          }
-        }
-      }
-    }
+template <typename ParseFn>
+bool parseGpx(ParseFn parseFn, GpsFixArray* fixes, std::string* error) {
+  GpsFixCallback collect = [fixes](const GpsFix& fix) -> Result<void> {
+    fixes->push_back(fix);
+    return {};
+  };
+  GpxHandler handler(collect);
+  if (Result<void> result = parseFn(handler); !result.ok()) {
+    *error = handler.error().empty() ? "GPX document not parsed successfully."
+                                     : handler.error();
+    return false;
   }
 
   // Sort the values by timestamp
-  std::sort(fixes->begin(), fixes->end());
-
-  cleanupXmlDoc(doc);
+  std::stable_sort(fixes->begin(), fixes->end());
   return true;
 }
 
+Result<void> streamGpxFile(const std::string& path,
+                           const GpsFixCallback& onFix) {
+  GpxHandler handler(onFix);
+  CF_EXPECT(ParseXmlFile(path, handler));
+  return {};
+}
+
+Result<void> streamGpxString(std::string_view str,
+                             const GpsFixCallback& onFix) {
+  GpxHandler handler(onFix);
+  CF_EXPECT(ParseXmlString(str, handler));
+  return {};
+}
+
+}  // namespace
+}  // namespace cuttlefish
+
 bool GpxParser::parseFile(const char* filePath, GpsFixArray* fixes,
                           std::string* error) {
-  xmlDocPtr doc = xmlReadFile(filePath, nullptr, 0);
-  if (doc == nullptr) {
-    cleanupXmlDoc(doc);
-    *error = "GPX document not parsed successfully.";
-    return false;
-  }
-  return parse(doc, fixes, error);
+  return cuttlefish::parseGpx(
+      [filePath](cuttlefish::GpxHandler& handler) {
+        return cuttlefish::ParseXmlFile(filePath, handler);
+      },
+      fixes, error);
 }
 
 bool GpxParser::parseString(const char* str, int len, GpsFixArray* fixes,
                             std::string* error) {
-  xmlDocPtr doc = xmlReadMemory(str, len, NULL, NULL, 0);
-  if (doc == nullptr) {
-    cleanupXmlDoc(doc);
-    *error = "GPX document not parsed successfully.";
-    return false;
-  }
-  return parse(doc, fixes, error);
+  return cuttlefish::parseGpx(
+      [str, len](cuttlefish::GpxHandler& handler) {
+        return cuttlefish::ParseXmlString(std::string_view(str, len), handler);
+      },
+      fixes, error);
+}
+
+cuttlefish::Result<void> GpxParser::streamFile(
+    const std::string& filePath, const GpsFixCallback& onFix) {
+  return cuttlefish::streamGpxFile(filePath, onFix);
+}
+
+cuttlefish::Result<void> GpxParser::streamString(
+    std::string_view str, const GpsFixCallback& onFix) {
+  return cuttlefish::streamGpxString(str, onFix);
 }
@@ -17,8 +17,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "cuttlefish/host/libs/location/GpsFix.h"
+#include "cuttlefish/result/result.h"
 
 class GpxParser {
  public:
@@ -33,4 +35,14 @@ class GpxParser {
 
   static bool parseString(const char* str, int len, GpsFixArray* fixes,
                           std::string* error);
+
+  /* Calls |onFix| with every GPS fix of the .gpx document, in document order
+   * rather than sorted by time, as soon as the point is read. The document is
+   * never held in memory as a whole.
+   */
+  static cuttlefish::Result<void> streamFile(const std::string& filePath,
+                                             const GpsFixCallback& onFix);
+
+  static cuttlefish::Result<void> streamString(std::string_view str,
+                                               const GpsFixCallback& onFix);
 };
@@ -16,201 +16,336 @@
 
 #include "cuttlefish/host/libs/location/KmlParser.h"
 
-#include <string.h>
-#include <unistd.h>
+#include <stddef.h>
 
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 
-#include "libxml/parser.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
 
 #include "cuttlefish/host/libs/location/StringParse.h"
+#include "cuttlefish/host/libs/location/XmlStreamParser.h"
+#include "cuttlefish/result/result.h"
 
-// Coordinates can be nested arbitrarily deep within a Placemark, depending
-// on the type of object (Point, LineString, Polygon) the Placemark contains
-static xmlNode* findCoordinates(xmlNode* current) {
-  for (; current != nullptr; current = current->next) {
-    if (!strcmp((const char*)current->name, "coordinates")) {
-      return current;
+namespace cuttlefish {
+namespace {
+
+constexpr char kMalformedLocation[] =
+    "Location found with missing or malformed coordinates";
+constexpr std::string_view kCoordinateDelimiters = ", \t\n\v\f\r";
+
+enum class Geometry { kNone, kCoordinates, kTrack };
+enum class TextTarget { kNone, kName, kDescription, kCoordinates, kTrackCoord };
+
+// Placemarks (aka locations) can be nested arbitrarily deep. Their fixes come
+// from <coordinates> inside a Point, LineString or Polygon, or from the
+// <gx:coord> elements of a <gx:Track>.
+//
+// Only the first fix of a placemark gets its name and description, to avoid
+// needless repetition. That fix is held back until the placemark ends or a
+// second fix is read, so a <name> after a <Point> still applies.
+class KmlHandler : public XmlHandler {
+ public:
+  explicit KmlHandler(const GpsFixCallback& onFix) : onFix_(onFix) {}
+
+  // The message of an invalid placemark that stopped parsing, if any.
+  const std::string& error() const { return error_; }
+
+  // not worried about case-sensitivity since .kml files
+  // are expected to be machine-generated
+  Result<void> StartElement(const XmlElement& element) override {
+    size_t depth = depth_++;
+    if (!placemarkDepth_) {
+      if (element.name == "Placemark") {
+        startPlacemark(depth);
+      }
+    } else if (depth == *placemarkDepth_ + 1) {
+      startPlacemarkChild(element, depth);
+    } else if (geometry_ == Geometry::kCoordinates && !coordinatesRead_ &&
+               target_ == TextTarget::kNone &&
+               element.name == "coordinates") {
+      // Coordinates can be nested arbitrarily deep within the geometry, and
+      // only the first element is read.
+      startText(TextTarget::kCoordinates, element, depth);
+      next_ = 0;
+    } else if (geometry_ == Geometry::kTrack && depth == geometryDepth_ + 1 &&
+               element.prefix == "gx" && element.name == "coord") {
+      startText(TextTarget::kTrackCoord, element, depth);
     }
-    xmlNode* children = findCoordinates(current->xmlChildrenNode);
-    if (children != nullptr) {
-      return children;
+    return {};
+  }
+
+  Result<void> EndElement(const XmlElement& element) override {
+    size_t depth = --depth_;
+    if (target_ != TextTarget::kNone && depth == textDepth_) {
+      CF_EXPECT(endText());
+    }
+    if (geometry_ != Geometry::kNone && depth == geometryDepth_) {
+      if (geometry_ == Geometry::kCoordinates && !coordinatesRead_) {
+        return fail(element.line);
+      }
+      geometry_ = Geometry::kNone;
     }
+    if (placemarkDepth_ && depth == *placemarkDepth_) {
+      placemarkDepth_.reset();
+      if (!pending_ && fixesInPlacemark_ == 0) {
+        return fail(element.line);
+      }
+      CF_EXPECT(flushPending());
+    }
+    return {};
   }
-  return nullptr;
-}
 
-// Coordinates have the following format:
-//        <coordinates> -112.265654928602,36.09447672602546,2357
-//                ...
-//                -112.2657374587321,36.08646312301303,2357
-//        </coordinates>
-// often entirely contained in a single string, necessitating regex
-static bool parseCoordinates(xmlNode* current, GpsFixArray* fixes) {
-  xmlNode* coordinates_node = findCoordinates(current);
-  bool result = true;
-  if (coordinates_node == nullptr ||
-      coordinates_node->xmlChildrenNode == nullptr ||
-      coordinates_node->xmlChildrenNode->content == nullptr) {
-    return false;
+  Result<void> Text(std::string_view text) override {
+    if (target_ == TextTarget::kNone || depth_ != textDepth_ + 1) {
+      return {};
+    }
+    if (target_ == TextTarget::kCoordinates) {
+      return readCoordinates(text);
+    }
+    text_.append(text);
+    return {};
   }
 
-  const char* coordinates =
-      (const char*)(coordinates_node->xmlChildrenNode->content);
-  int coordinates_len = strlen(coordinates);
-  int offset = 0, n = 0;
-  GpsFix new_fix;
-  while (3 == SscanfWithCLocale(coordinates + offset, "%f , %f , %f%n",
-                                &new_fix.longitude, &new_fix.latitude,
-                                &new_fix.elevation, &n)) {
-    fixes->push_back(new_fix);
-    offset += n;
+ private:
+  void startPlacemark(size_t depth) {
+    placemarkDepth_ = depth;
+    name_.clear();
+    description_.clear();
+    fixesInPlacemark_ = 0;
   }
 
-  // Only allow whitespace at the end of the string to remain unconsumed.
-  for (int i = offset; i < coordinates_len && result; ++i) {
-    result = isspace(coordinates[i]);
+  void startPlacemarkChild(const XmlElement& element, size_t depth) {
+    if (element.name == "name") {
+      startText(TextTarget::kName, element, depth);
+    } else if (element.name == "description") {
+      startText(TextTarget::kDescription, element, depth);
+    } else if (element.name == "Point" || element.name == "LineString" ||
+               element.name == "Polygon") {
+      geometry_ = Geometry::kCoordinates;
+      geometryDepth_ = depth;
+      coordinatesRead_ = false;
+    } else if (element.prefix == "gx" && element.name == "Track") {
+      geometry_ = Geometry::kTrack;
+      geometryDepth_ = depth;
+    }
   }
 
-  return result;
-}
+  void startText(TextTarget target, const XmlElement& element, size_t depth) {
+    target_ = target;
+    textDepth_ = depth;
+    textLine_ = element.line;
+    text_.clear();
+    token_.clear();
+  }
 
-static bool parseGxTrack(xmlNode* children, GpsFixArray* fixes) {
-  bool result = true;
-  for (xmlNode* current = children; result && current != nullptr;
-       current = current->next) {
-    if (current->ns && current->ns->prefix &&
-        !strcmp((const char*)current->ns->prefix, "gx") &&
-        !strcmp((const char*)current->name, "coord")) {
-      std::string coordinates{(const char*)current->xmlChildrenNode->content};
-      GpsFix new_fix;
-      result = (3 == SscanfWithCLocale(coordinates.c_str(), "%f %f %f",
-                                       &new_fix.longitude, &new_fix.latitude,
-                                       &new_fix.elevation));
-      fixes->push_back(new_fix);
+  Result<void> endText() {
+    TextTarget target = std::exchange(target_, TextTarget::kNone);
+    switch (target) {
+      case TextTarget::kName:
+        name_ = std::move(text_);
+        break;
+      case TextTarget::kDescription:
+        description_ = std::move(text_);
+        break;
+      case TextTarget::kCoordinates:
+        // Only whitespace may follow the last complete tuple.
+        if (!token_.empty()) {
+          CF_EXPECT(endToken());
+        }
+        if (next_ != 0) {
+          return fail(textLine_);
+        }
+        coordinatesRead_ = true;
+        break;
+      case TextTarget::kTrackCoord: {
+        float lon, lat, alt;
+        if (SscanfWithCLocale(text_.c_str(), "%f %f %f", &lon, &lat, &alt) !=
+            3) {
+          return fail(textLine_);
+        }
+        CF_EXPECT(addFix(lon, lat, alt));
+        break;
+      }
+      case TextTarget::kNone:
+        break;
     }
+    return {};
   }
-  return result;
-}
 
-static bool parsePlacemark(xmlNode* current, GpsFixArray* fixes) {
-  std::string description;
-  std::string name;
-  size_t ind = std::string::npos;
-  // not worried about case-sensitivity since .kml files
-  // are expected to be machine-generated
-  for (; current != nullptr; current = current->next) {
-    const bool hasContent =
-        current->xmlChildrenNode && current->xmlChildrenNode->content;
-
-    if (hasContent && !strcmp((const char*)current->name, "description")) {
-      description = (const char*)current->xmlChildrenNode->content;
-    } else if (hasContent && !strcmp((const char*)current->name, "name")) {
-      name = (const char*)current->xmlChildrenNode->content;
-    } else if (!strcmp((const char*)current->name, "Point") ||
-               !strcmp((const char*)current->name, "LineString") ||
-               !strcmp((const char*)current->name, "Polygon")) {
-      ind = (ind != std::string::npos ? ind : fixes->size());
-      if (!parseCoordinates(current->xmlChildrenNode, fixes)) {
-        return false;
+  // Coordinates have the following format:
+  //        <coordinates> -112.265654928602,36.09447672602546,2357
+  //                ...
+  //                -112.2657374587321,36.08646312301303,2357
+  //        </coordinates>
+  // with optional whitespace around the commas. A whole track is often in a
+  // single element, so tuples are read as the text arrives, keeping only a
+  // number split between two pieces.
+  Result<void> readCoordinates(std::string_view text) {
+    size_t i = 0;
+    while (i < text.size()) {
+      char c = text[i];
+      if (c == ',') {
+        if (!token_.empty()) {
+          CF_EXPECT(endToken());
+        }
+        // Commas only go between the numbers of a tuple.
+        if (next_ % 2 == 0) {
+          return fail(textLine_);
+        }
+        next_++;
+        i++;
+        continue;
+      }
+      if (absl::ascii_isspace(static_cast<unsigned char>(c))) {
+        if (!token_.empty()) {
+          CF_EXPECT(endToken());
+        }
+        i++;
+        continue;
       }
-    } else if (current->ns && current->ns->prefix &&
-               !strcmp((const char*)current->ns->prefix, "gx") &&
-               !strcmp((const char*)current->name, "Track")) {
-      ind = (ind != std::string::npos ? ind : fixes->size());
-      if (!parseGxTrack(current->xmlChildrenNode, fixes)) {
-        return false;
+      size_t end = text.find_first_of(kCoordinateDelimiters, i);
+      if (end == std::string_view::npos) {
+        token_.append(text.substr(i));
+        break;
       }
+      token_.append(text.substr(i, end - i));
+      i = end;
     }
+    return {};
   }
 
-  if (ind == std::string::npos || ind >= fixes->size()) {
-    return false;
+  // `next_` counts through longitude, comma, latitude, comma, altitude.
+  Result<void> endToken() {
+    float value;
+    if (next_ % 2 == 1 || !absl::SimpleAtof(token_, &value)) {
+      return fail(textLine_);
+    }
+    token_.clear();
+    tuple_[next_ / 2] = value;
+    if (next_ < 4) {
+      next_++;
+      return {};
+    }
+    next_ = 0;
+    CF_EXPECT(addFix(tuple_[0], tuple_[1], tuple_[2]));
+    return {};
   }
 
-  // only assign name and description to the first of the
-  // points to avoid needless repetition
-  (*fixes)[ind].description = std::move(description);
-  (*fixes)[ind].name = std::move(name);
-
-  return true;
-}
+  Result<void> addFix(float longitude, float latitude, float elevation) {
+    GpsFix fix;
+    fix.longitude = longitude;
+    fix.latitude = latitude;
+    fix.elevation = elevation;
+    if (fixesInPlacemark_++ == 0) {
+      pending_ = std::move(fix);
+      return {};
+    }
+    CF_EXPECT(flushPending());
+    CF_EXPECT(onFix_(fix));
+    return {};
+  }
 
-// Placemarks (aka locations) can be nested arbitrarily deep
-static bool traverseSubtree(xmlNode* current, GpsFixArray* fixes,
-                            std::string* error) {
-  for (; current; current = current->next) {
-    if (current->name != nullptr &&
-        !strcmp((const char*)current->name, "Placemark")) {
-      if (!parsePlacemark(current->xmlChildrenNode, fixes)) {
-        *error = "Location found with missing or malformed coordinates";
-        return false;
-      }
-    } else if (current->name != nullptr &&
-               strcmp((const char*)current->name, "text") != 0) {
-      // if it's not a Placemark we must go deeper
-      if (!traverseSubtree(current->xmlChildrenNode, fixes, error)) {
-        return false;
-      }
+  Result<void> flushPending() {
+    if (!pending_) {
+      return {};
     }
+    pending_->name = name_;
+    pending_->description = description_;
+    GpsFix fix = std::move(*pending_);
+    pending_.reset();
+    CF_EXPECT(onFix_(fix));
+    return {};
   }
-  error->clear();
-  return true;
-}
 
-bool KmlParser::parseFile(const char* filePath, GpsFixArray* fixes,
-                          std::string* error) {
-  // This initializes the library and checks potential ABI mismatches between
-  // the version it was compiled for and the actual shared library used.
-  LIBXML_TEST_VERSION
-
-  xmlDocPtr doc = xmlReadFile(filePath, nullptr, 0);
-  if (doc == nullptr) {
-    *error = "KML document not parsed successfully.";
-    xmlFreeDoc(doc);
-    return false;
+  StackTraceError fail(int line) {
+    error_ = kMalformedLocation;
+    return CF_ERRF("{} on line {}", kMalformedLocation, line);
   }
 
-  xmlNodePtr cur = xmlDocGetRootElement(doc);
-  if (cur == nullptr) {
-    *error = "Could not get root element of parsed KML file.";
-    xmlFreeDoc(doc);
-    xmlCleanupParser();
+  const GpsFixCallback& onFix_;
+  size_t depth_ = 0;
+  std::optional<size_t> placemarkDepth_;
+  std::string name_;
+  std::string description_;
+  size_t fixesInPlacemark_ = 0;
+  std::optional<GpsFix> pending_;
+
+  Geometry geometry_ = Geometry::kNone;
+  size_t geometryDepth_ = 0;
+  bool coordinatesRead_ = false;
+
+  TextTarget target_ = TextTarget::kNone;
+  size_t textDepth_ = 0;
+  int textLine_ = 0;
+  std::string text_;
+  std::string token_;
+  int next_ = 0;
+  float tuple_[3] = {};
+
+  std::string error_;
+};
+
+template <typename ParseFn>
+bool parseKml(ParseFn parseFn, GpsFixArray* fixes, std::string* error) {
+  GpsFixCallback collect = [fixes](const GpsFix& fix) -> Result<void> {
+    fixes->push_back(fix);
+    return {};
+  };
+  KmlHandler handler(collect);
+  if (Result<void> result = parseFn(handler); !result.ok()) {
+    *error = handler.error().empty() ? "KML document not parsed successfully."
+                                     : handler.error();
     return false;
   }
-  bool isWellFormed = traverseSubtree(cur, fixes, error);
+  error->clear();
+  return true;
+}
+
+Result<void> streamKmlFile(const std::string& path,
+                           const GpsFixCallback& onFix) {
+  KmlHandler handler(onFix);
+  CF_EXPECT(ParseXmlFile(path, handler));
+  return {};
+}
 
-  xmlFreeDoc(doc);
-  xmlCleanupParser();
+Result<void> streamKmlString(std::string_view str,
+                             const GpsFixCallback& onFix) {
+  KmlHandler handler(onFix);
+  CF_EXPECT(ParseXmlString(str, handler));
+  return {};
+}
+
+}  // namespace
+}  // namespace cuttlefish
 
-  return isWellFormed;
+bool KmlParser::parseFile(const char* filePath, GpsFixArray* fixes,
+                          std::string* error) {
+  return cuttlefish::parseKml(
+      [filePath](cuttlefish::KmlHandler& handler) {
+        return cuttlefish::ParseXmlFile(filePath, handler);
+      },
+      fixes, error);
 }
 
 bool KmlParser::parseString(const char* str, int len, GpsFixArray* fixes,
                             std::string* error) {
-  // This initializes the library and checks potential ABI mismatches between
-  // the version it was compiled for and the actual shared library used.
-  LIBXML_TEST_VERSION
-
-  xmlDocPtr doc = xmlReadMemory(str, len, NULL, NULL, 0);
-  if (doc == nullptr) {
-    *error = "KML document not parsed successfully.";
-    xmlFreeDoc(doc);
-    return false;
-  }
-
-  xmlNodePtr cur = xmlDocGetRootElement(doc);
-  if (cur == nullptr) {
-    *error = "Could not get root element of parsed KML file.";
-    xmlFreeDoc(doc);
-    xmlCleanupParser();
-    return false;
-  }
-  bool isWellFormed = traverseSubtree(cur, fixes, error);
+  return cuttlefish::parseKml(
+      [str, len](cuttlefish::KmlHandler& handler) {
+        return cuttlefish::ParseXmlString(std::string_view(str, len), handler);
+      },
+      fixes, error);
+}
 
-  xmlFreeDoc(doc);
-  xmlCleanupParser();
+cuttlefish::Result<void> KmlParser::streamFile(
+    const std::string& filePath, const GpsFixCallback& onFix) {
+  return cuttlefish::streamKmlFile(filePath, onFix);
+}
 
-  return isWellFormed;
+cuttlefish::Result<void> KmlParser::streamString(
+    std::string_view str, const GpsFixCallback& onFix) {
+  return cuttlefish::streamKmlString(str, onFix);
 }
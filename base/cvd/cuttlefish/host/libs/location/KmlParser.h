@@ -17,8 +17,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "cuttlefish/host/libs/location/GpsFix.h"
+#include "cuttlefish/result/result.h"
 
 class KmlParser {
  public:
@@ -30,4 +32,12 @@ class KmlParser {
                         std::string* error);
   static bool parseString(const char* str, int len, GpsFixArray* fixes,
                           std::string* error);
-};
\ No newline at end of file
+
+  // Calls |onFix| with every GPS fix of the .kml document as soon as it is
+  // read, without holding the whole document in memory. Coordinates are read
+  // incrementally, so a single huge <coordinates> element is fine too.
+  static cuttlefish::Result<void> streamFile(const std::string& filePath,
+                                             const GpsFixCallback& onFix);
+  static cuttlefish::Result<void> streamString(std::string_view str,
+                                               const GpsFixCallback& onFix);
+};
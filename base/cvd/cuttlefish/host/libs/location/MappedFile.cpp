@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/location/MappedFile.h"
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "fmt/format.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/files/file_exists.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+constexpr size_t kMagicSize = 8;
+
+MappedFile::MappedFile(std::string bytes) : storage_(std::move(bytes)) {}
+
+MappedFile::MappedFile(ScopedMMap map) : map_(std::move(map)) {}
+
+Result<MappedFile> MappedFile::Map(const std::string& path) {
+  SharedFD fd = SharedFD::Open(path, O_RDONLY);
+  CF_EXPECTF(fd->IsOpen(), "Failed to open '{}': {}", path, fd->StrError());
+  off_t size = fd->LSeek(0, SEEK_END);
+  CF_EXPECTF(size > 0, "Failed to get the size of '{}': {}", path,
+             fd->StrError());
+  ScopedMMap map = fd->MMap(nullptr, size, PROT_READ, MAP_SHARED, 0);
+  CF_EXPECTF(static_cast<bool>(map), "Failed to map '{}': {}", path,
+             fd->StrError());
+  return MappedFile(std::move(map));
+}
+
+std::string_view MappedFile::bytes() const {
+  if (map_) {
+    return std::string_view(static_cast<const char*>(map_.get()), map_.len());
+  }
+  return storage_;
+}
+
+Result<void> ValidateMappedFileHeader(std::string_view bytes,
+                                      size_t header_size,
+                                      std::string_view magic,
+                                      uint32_t version) {
+  CF_EXPECT_EQ(magic.size(), kMagicSize);
+  CF_EXPECT_GE(header_size, kMagicSize + sizeof(version));
+  CF_EXPECT_GE(bytes.size(), header_size, "Truncated header");
+  CF_EXPECT(bytes.substr(0, kMagicSize) == magic, "Wrong magic");
+  uint32_t file_version;
+  memcpy(&file_version, bytes.data() + kMagicSize, sizeof(file_version));
+  CF_EXPECT_EQ(file_version, version, "Unsupported version");
+  return {};
+}
+
+Result<void> WriteMappedFile(const std::string& path, std::string_view bytes) {
+  std::string temp_path = fmt::format("{}.{}", path, getpid());
+  if (FileExists(temp_path)) {
+    CF_EXPECT(RemoveFile(temp_path));
+  }
+  CF_EXPECT(WriteNewFile(temp_path, bytes, 0644));
+  CF_EXPECT(RenameFile(temp_path, path));
+  return {};
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,58 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+// The read-only contents of a precompiled location file, either held in
+// memory or mapped from the file so that processes reading the same file share
+// its pages.
+class MappedFile {
+ public:
+  explicit MappedFile(std::string bytes);
+  static Result<MappedFile> Map(const std::string& path);
+
+  std::string_view bytes() const;
+
+ private:
+  explicit MappedFile(ScopedMMap map);
+
+  std::string storage_;
+  ScopedMMap map_;
+};
+
+// Checks the common start of the precompiled formats: an 8 byte `magic`
+// followed by a uint32_t `version`, within a header of `header_size` bytes.
+Result<void> ValidateMappedFileHeader(std::string_view bytes,
+                                      size_t header_size,
+                                      std::string_view magic,
+                                      uint32_t version);
+
+// Replaces `path` with `bytes` through a rename, so readers never map a
+// partial file. Processes writing the same file at once each rename a complete
+// copy into place.
+Result<void> WriteMappedFile(const std::string& path, std::string_view bytes);
+
+}  // namespace cuttlefish
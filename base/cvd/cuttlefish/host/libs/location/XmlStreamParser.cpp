@@ -0,0 +1,184 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/location/XmlStreamParser.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "libxml/SAX2.h"
+#include "libxml/parser.h"
+#include "libxml/xmlerror.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+// libxml2 copies every chunk into its input buffer, so feeding bounded chunks
+// also bounds that buffer.
+constexpr size_t kChunkSize = 64 * 1024;
+
+std::string_view View(const xmlChar* str) {
+  return str ? std::string_view(reinterpret_cast<const char*>(str))
+             : std::string_view();
+}
+
+class SaxParser {
+ public:
+  SaxParser(XmlHandler& handler, const char* filename) : handler_(handler) {
+    xmlSAXHandler sax;
+    memset(&sax, 0, sizeof(sax));
+    sax.initialized = XML_SAX2_MAGIC;
+    sax.startElementNs = &SaxParser::OnStartElement;
+    sax.endElementNs = &SaxParser::OnEndElement;
+    sax.characters = &SaxParser::OnText;
+    sax.cdataBlock = &SaxParser::OnText;
+    context_ = xmlCreatePushParserCtxt(&sax, this, nullptr, 0, filename);
+    if (context_) {
+      xmlCtxtUseOptions(context_,
+                        XML_PARSE_NONET | XML_PARSE_NOERROR |
+                            XML_PARSE_NOWARNING);
+    }
+  }
+  ~SaxParser() {
+    if (context_) {
+      xmlFreeParserCtxt(context_);
+    }
+  }
+
+  Result<void> Feed(std::string_view chunk, bool last) {
+    CF_EXPECT(context_ != nullptr, "Failed to create the XML parser");
+    xmlParseChunk(context_, chunk.data(), static_cast<int>(chunk.size()),
+                  last ? 1 : 0);
+    if (!handler_result_.ok()) {
+      return std::move(handler_result_.error());
+    }
+    // Namespace errors, like an undeclared "gx:" prefix, are not fatal.
+    if (!context_->wellFormed) {
+      const xmlError* error = xmlCtxtGetLastError(context_);
+      std::string message =
+          error && error->message ? error->message : "Unknown error";
+      return CF_ERRF("Malformed XML on line {}: {}",
+                     error ? error->line : 0,
+                     absl::StripTrailingAsciiWhitespace(message));
+    }
+    return {};
+  }
+
+ private:
+  static void OnStartElement(void* data, const xmlChar* localname,
+                             const xmlChar* prefix, const xmlChar*, int,
+                             const xmlChar**, int num_attributes, int,
+                             const xmlChar** attributes) {
+    SaxParser& parser = *static_cast<SaxParser*>(data);
+    XmlElement& element = parser.element_;
+    parser.SetElement(localname, prefix);
+    // Each attribute is (localname, prefix, URI, value, end).
+    for (int i = 0; i < num_attributes; i++) {
+      const xmlChar** attribute = attributes + 5 * i;
+      element.attributes.emplace_back(
+          View(attribute[0]),
+          std::string_view(reinterpret_cast<const char*>(attribute[3]),
+                           attribute[4] - attribute[3]));
+    }
+    parser.Deliver(parser.handler_.StartElement(element));
+  }
+
+  static void OnEndElement(void* data, const xmlChar* localname,
+                           const xmlChar* prefix, const xmlChar*) {
+    SaxParser& parser = *static_cast<SaxParser*>(data);
+    parser.SetElement(localname, prefix);
+    parser.Deliver(parser.handler_.EndElement(parser.element_));
+  }
+
+  static void OnText(void* data, const xmlChar* text, int size) {
+    SaxParser& parser = *static_cast<SaxParser*>(data);
+    parser.Deliver(parser.handler_.Text(
+        std::string_view(reinterpret_cast<const char*>(text), size)));
+  }
+
+  void SetElement(const xmlChar* localname, const xmlChar* prefix) {
+    element_.name = View(localname);
+    element_.prefix = View(prefix);
+    element_.line = xmlSAX2GetLineNumber(context_);
+    element_.attributes.clear();
+  }
+
+  // Keeps the first error and stops the parser on it, which also stops the
+  // callbacks.
+  void Deliver(Result<void> result) {
+    if (!result.ok() && handler_result_.ok()) {
+      handler_result_ = std::move(result);
+      xmlStopParser(context_);
+    }
+  }
+
+  XmlHandler& handler_;
+  xmlParserCtxtPtr context_ = nullptr;
+  XmlElement element_;
+  Result<void> handler_result_;
+};
+
+}  // namespace
+
+std::optional<std::string_view> XmlElement::Attribute(
+    std::string_view name) const {
+  auto it = std::find_if(attributes.begin(), attributes.end(),
+                         [name](const auto& attribute) {
+                           return attribute.first == name;
+                         });
+  if (it == attributes.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+Result<void> ParseXmlFile(const std::string& path, XmlHandler& handler) {
+  SharedFD fd = SharedFD::Open(path, O_RDONLY);
+  CF_EXPECTF(fd->IsOpen(), "Failed to open '{}': {}", path, fd->StrError());
+  SaxParser parser(handler, path.c_str());
+  std::vector<char> buffer(kChunkSize);
+  while (true) {
+    ssize_t bytes = fd->Read(buffer.data(), buffer.size());
+    CF_EXPECTF(bytes >= 0, "Failed to read '{}': {}", path, fd->StrError());
+    CF_EXPECT(parser.Feed(std::string_view(buffer.data(), bytes), bytes == 0));
+    if (bytes == 0) {
+      return {};
+    }
+  }
+}
+
+Result<void> ParseXmlString(std::string_view xml, XmlHandler& handler) {
+  SaxParser parser(handler, nullptr);
+  do {
+    std::string_view chunk = xml.substr(0, kChunkSize);
+    xml.remove_prefix(chunk.size());
+    CF_EXPECT(parser.Feed(chunk, xml.empty()));
+  } while (!xml.empty());
+  return {};
+}
+
+}  // namespace cuttlefish
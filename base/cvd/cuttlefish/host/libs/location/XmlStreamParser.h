@@ -0,0 +1,56 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+struct XmlElement {
+  // The local name, without the namespace prefix.
+  std::string_view name;
+  std::string_view prefix;
+  int line = 0;
+  // Names and values of the attributes. Only set on element starts.
+  std::vector<std::pair<std::string_view, std::string_view>> attributes;
+
+  std::optional<std::string_view> Attribute(std::string_view name) const;
+};
+
+// Receives the contents of a document while it is parsed. Returning an error
+// from any method stops parsing with that error.
+class XmlHandler {
+ public:
+  virtual ~XmlHandler() = default;
+
+  virtual Result<void> StartElement(const XmlElement& element) = 0;
+  virtual Result<void> EndElement(const XmlElement& element) = 0;
+  // Character data and CDATA sections, split in pieces of any size.
+  virtual Result<void> Text(std::string_view text) = 0;
+};
+
+// Parse the document without building a tree, so memory use does not grow
+// with its size.
+Result<void> ParseXmlFile(const std::string& path, XmlHandler& handler);
+Result<void> ParseXmlString(std::string_view xml, XmlHandler& handler);
+
+}  // namespace cuttlefish
@@ -42,7 +42,7 @@
 #include "cuttlefish/common/libs/utils/contains.h"
 #include "cuttlefish/host/libs/command_util/util.h"
 #include "cuttlefish/host/libs/config/known_paths.h"
-#include "cuttlefish/posix/strerror.h"
+#include "cuttlefish/host/libs/process_monitor/process_supervisor.h"
 #include "cuttlefish/process/subprocess.h"
 #include "cuttlefish/result/result.h"
 
@@ -77,106 +77,6 @@ Result<void> SendEmptyResponse(Channel& channel, uint32_t type) {
   return {};
 }
 
-void LogSubprocessExit(const std::string& name, pid_t pid, int wstatus) {
-  LOG(INFO) << "Detected unexpected exit of monitored subprocess " << name;
-  if (WIFEXITED(wstatus)) {
-    LOG(INFO) << "Subprocess " << name << " (" << pid
-              << ") has exited with exit code " << WEXITSTATUS(wstatus);
-  } else if (WIFSIGNALED(wstatus)) {
-    int sig_num = WTERMSIG(wstatus);
-    LOG(ERROR) << "Subprocess " << name << " (" << pid
-               << ") was interrupted by a signal '" << strsignal(sig_num)
-               << "' (" << sig_num << ")";
-  } else {
-    LOG(INFO) << "subprocess " << name << " (" << pid
-              << ") has exited for unknown reasons";
-  }
-}
-
-void LogSubprocessExit(const std::string& name, const siginfo_t& infop) {
-  LOG(INFO) << "Detected unexpected exit of monitored subprocess " << name;
-  if (infop.si_code == CLD_EXITED) {
-    LOG(INFO) << "Subprocess " << name << " (" << infop.si_pid
-              << ") has exited with exit code " << infop.si_status;
-  } else if (infop.si_code == CLD_KILLED) {
-    LOG(ERROR) << "Subprocess " << name << " (" << infop.si_pid
-               << ") was interrupted by a signal '"
-               << strsignal(infop.si_status) << "' (" << infop.si_status << ")";
-  } else {
-    LOG(INFO) << "subprocess " << name << " (" << infop.si_pid
-              << ") has exited for unknown reasons (code = " << infop.si_code
-              << ", status = " << infop.si_status << ")";
-  }
-}
-
-Result<void> MonitorLoop(std::atomic_bool& running,
-                         std::mutex& properties_mutex,
-                         const bool restart_subprocesses,
-                         std::vector<MonitorEntry>& monitored) {
-  while (running.load()) {
-    int wstatus;
-    pid_t pid = wait(&wstatus);
-    CF_EXPECTF(pid != -1, "Wait failed: {}", StrError(errno));
-    if (!WIFSIGNALED(wstatus) && !WIFEXITED(wstatus)) {
-      VLOG(0) << "Unexpected status from wait: " << wstatus << " for pid "
-              << pid;
-      continue;
-    }
-    if (!running.load()) {  // Avoid extra restarts near the end
-      break;
-    }
-    auto matches = [pid](const auto& it) { return it.proc->pid() == pid; };
-    std::unique_lock lock(properties_mutex);
-    auto it = std::find_if(monitored.begin(), monitored.end(), matches);
-    if (it == monitored.end()) {
-      LogSubprocessExit("(unknown)", pid, wstatus);
-    } else {
-      LogSubprocessExit(it->cmd->GetShortName(), it->proc->pid(), wstatus);
-      if (restart_subprocesses) {
-        auto options = SubprocessOptions().InGroup(true);
-        // in the future, cmd->Start might not run exec()
-        it->proc.reset(new Subprocess(it->cmd->Start(std::move(options))));
-      } else {
-        bool is_critical = it->is_critical;
-        monitored.erase(it);
-        if (running.load() && is_critical) {
-          LOG(ERROR) << "Stopping all monitored processes due to unexpected "
-                        "exit of critical process";
-          running.store(false);
-          break;
-        }
-      }
-    }
-  }
-  return {};
-}
-
-Result<void> StopSubprocesses(std::vector<MonitorEntry>& monitored) {
-  VLOG(0) << "Stopping monitored subprocesses";
-  auto stop = [](const auto& it) {
-    auto stop_result = it.proc->Stop();
-    if (stop_result == StopperResult::kFailure) {
-      LOG(WARNING) << "Error in stopping \"" << it.cmd->GetShortName() << "\"";
-      return false;
-    }
-    siginfo_t infop;
-    auto success = it.proc->Wait(&infop, WEXITED);
-    if (success < 0) {
-      LOG(WARNING) << "Failed to wait for process " << it.cmd->GetShortName();
-      return false;
-    }
-    if (stop_result == StopperResult::kCrash) {
-      LogSubprocessExit(it.cmd->GetShortName(), infop);
-    }
-    return true;
-  };
-  // Processes were started in the order they appear in the vector, stop them in
-  // reverse order for symmetry.
-  size_t stopped = std::count_if(monitored.rbegin(), monitored.rend(), stop);
-  CF_EXPECT(stopped == monitored.size(), "Didn't stop all subprocesses");
-  return {};
-}
-
 Result<void> SuspendResumeImpl(std::vector<MonitorEntry>& monitor_entries,
                                std::mutex& properties_mutex,
                                const SharedFD& channel_to_secure_env,
@@ -207,7 +107,7 @@ Result<void> SuspendResumeImpl(std::vector<MonitorEntry>& monitor_entries,
       continue;
     }
     if (!entry.proc) {
-      LOG(ERROR) << "Monitor Entry has a nullptr for proc.";
+      // Not running, e.g. waiting to be restarted.
       continue;
     }
     auto prog_name = android::base::Basename(entry.cmd->Executable());
@@ -253,29 +153,29 @@ Result<void> SuspendResumeImpl(std::vector<MonitorEntry>& monitor_entries,
 
 }  // namespace
 
-Result<void> ProcessMonitor::StartSubprocesses(
-    ProcessMonitor::Properties& properties) {
-  VLOG(0) << "Starting monitored subprocesses";
-  for (auto& monitored : properties.entries_) {
-    LOG(INFO) << "Starting monitored subprocess: "
-              << monitored.cmd->GetShortName();
+std::vector<SubprocessOptions> ProcessMonitor::StartOptions(
+    const ProcessMonitor::Properties& properties) {
+  std::vector<SubprocessOptions> start_options;
+  for (const auto& monitored : properties.entries_) {
     auto options = SubprocessOptions().InGroup(true);
     std::string short_name = monitored.cmd->GetShortName();
     auto last_slash = short_name.find_last_of('/');
     if (last_slash != std::string::npos) {
       short_name = short_name.substr(last_slash + 1);
     }
-    if (Contains(properties_.strace_commands_, short_name)) {
+    if (Contains(properties.strace_commands_, short_name)) {
       options.Strace(properties.strace_log_dir_ + "/strace-" + short_name);
     }
-    monitored.proc.reset(
-        new Subprocess(monitored.cmd->Start(std::move(options))));
-    CF_EXPECT(monitored.proc->Started(), "Failed to start subprocess");
+    if (monitored.is_vmm && !properties.vmm_cgroup_.empty()) {
+      options.Cgroup(properties.vmm_cgroup_);
+    }
+    start_options.emplace_back(std::move(options));
   }
-  return {};
+  return start_options;
 }
 
-Result<void> ProcessMonitor::ReadMonitorSocketLoop(std::atomic_bool& running) {
+Result<void> ProcessMonitor::ReadMonitorSocketLoop(
+    std::atomic_bool& running, ProcessSupervisor& supervisor) {
   VLOG(0) << "Waiting for a `stop` message from the parent";
   while (running.load()) {
     auto message_res = child_channel_->ReceiveMessage();
@@ -289,10 +189,7 @@ Result<void> ProcessMonitor::ReadMonitorSocketLoop(std::atomic_bool& running) {
     auto message = std::move(*message_res);
     if (message->command == ParentToChildMessageType::kStop) {
       running.store(false);
-      // Wake up the wait() loop by giving it an exited child process
-      if (fork() == 0) {
-        std::exit(0);
-      }
+      supervisor.Wake();
       // will break the for-loop as running is now false
       continue;
     }
@@ -334,7 +231,7 @@ ProcessMonitor::Properties& ProcessMonitor::Properties::RestartSubprocesses(
 
 ProcessMonitor::Properties& ProcessMonitor::Properties::AddCommand(
     MonitorCommand cmd) & {
-  entries_.emplace_back(std::move(cmd.command), cmd.is_critical);
+  entries_.emplace_back(std::move(cmd));
   return *this;
 }
 
@@ -350,6 +247,18 @@ ProcessMonitor::Properties& ProcessMonitor::Properties::StraceLogDir(
   return *this;
 }
 
+ProcessMonitor::Properties& ProcessMonitor::Properties::StartupReportPath(
+    std::string path) & {
+  startup_report_path_ = std::move(path);
+  return *this;
+}
+
+ProcessMonitor::Properties& ProcessMonitor::Properties::VmmCgroup(
+    std::string cgroup) & {
+  vmm_cgroup_ = std::move(cgroup);
+  return *this;
+}
+
 ProcessMonitor::ProcessMonitor(ProcessMonitor::Properties&& properties,
                                const SharedFD& secure_env_fd)
     : properties_(std::move(properties)),
@@ -438,27 +347,34 @@ Result<void> ProcessMonitor::MonitorRoutine() {
 #endif
 
   VLOG(0) << "Monitoring subprocesses";
-  CF_EXPECT(StartSubprocesses(properties_));
+  std::unique_ptr<ProcessSupervisor> supervisor =
+      CF_EXPECT(ProcessSupervisor::Create(
+          properties_.entries_, properties_mutex_,
+          properties_.restart_subprocesses_, properties_.startup_report_path_));
+  supervisor->Launch(StartOptions(properties_));
 
   std::atomic_bool running(true);
 
   auto read_monitor_socket_loop =
-      [this](std::atomic_bool& running) -> Result<void> {
-    CF_EXPECT(this->ReadMonitorSocketLoop(running));
+      [this, &supervisor](std::atomic_bool& running) -> Result<void> {
+    CF_EXPECT(this->ReadMonitorSocketLoop(running, *supervisor));
     return {};
   };
   auto parent_comms = std::async(std::launch::async, read_monitor_socket_loop,
                                  std::ref(running));
 
-  CF_EXPECT(MonitorLoop(running, properties_mutex_,
-                        properties_.restart_subprocesses_,
-                        properties_.entries_));
+  Result<void> monitor_result = supervisor->Run(running);
+  running.store(false);
   if (child_sock_->IsOpen()) {
     child_sock_->Shutdown(SHUT_RDWR);
   }
   CF_EXPECT(parent_comms.get(), "Should have exited if monitoring stopped");
+  // Waits for subprocesses that are still being started.
+  supervisor->WaitForLaunches();
 
-  CF_EXPECT(StopSubprocesses(properties_.entries_));
+  CF_EXPECT(supervisor->Stop());
+  supervisor.reset();
+  CF_EXPECT(std::move(monitor_result));
   VLOG(0) << "Done monitoring subprocesses";
   return {};
 }
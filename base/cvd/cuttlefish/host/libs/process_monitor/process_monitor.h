@@ -16,6 +16,7 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -26,17 +27,30 @@
 #include "cuttlefish/common/libs/transport/channel_sharedfd.h"
 #include "cuttlefish/host/libs/feature/command_source.h"
 #include "cuttlefish/process/command.h"
+#include "cuttlefish/process/subprocess_options.h"
 #include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
 
+class ProcessSupervisor;
+
 struct MonitorEntry {
   std::unique_ptr<Command> cmd;
+  // Null while the subprocess is not running.
   std::unique_ptr<Subprocess> proc;
   bool is_critical;
+  std::function<Result<void>()> readiness_probe;
+  bool is_vmm;
+  std::string id;
+  std::vector<std::string> dependencies;
 
-  MonitorEntry(Command command, bool is_critical)
-      : cmd(new Command(std::move(command))), is_critical(is_critical) {}
+  explicit MonitorEntry(MonitorCommand command)
+      : cmd(new Command(std::move(command.command))),
+        is_critical(command.is_critical),
+        readiness_probe(std::move(command.readiness_probe)),
+        is_vmm(command.is_vmm),
+        id(std::move(command.id)),
+        dependencies(std::move(command.dependencies)) {}
 };
 
 // Launches and keeps track of subprocesses, decides response if they
@@ -49,12 +63,19 @@ class ProcessMonitor {
     Properties& AddCommand(MonitorCommand) &;
     Properties& StraceCommands(std::set<std::string>) &;
     Properties& StraceLogDir(std::string) &;
+    // Where to write how long each subprocess took to start and become ready.
+    Properties& StartupReportPath(std::string) &;
+    // Cgroup v2 directory to start the VMM in, the other subprocesses stay in
+    // the monitor's.
+    Properties& VmmCgroup(std::string) &;
 
    private:
     bool restart_subprocesses_;
     std::vector<MonitorEntry> entries_;
     std::set<std::string> strace_commands_;
     std::string strace_log_dir_;
+    std::string startup_report_path_;
+    std::string vmm_cgroup_;
 
     friend class ProcessMonitor;
   };
@@ -76,9 +97,9 @@ class ProcessMonitor {
   SharedFD status() { return status_; };
 
  private:
-  Result<void> StartSubprocesses(Properties& properties);
+  std::vector<SubprocessOptions> StartOptions(const Properties& properties);
   Result<void> MonitorRoutine();
-  Result<void> ReadMonitorSocketLoop(std::atomic_bool&);
+  Result<void> ReadMonitorSocketLoop(std::atomic_bool&, ProcessSupervisor&);
   /*
    * The child run_cvd process suspends the host processes
    */
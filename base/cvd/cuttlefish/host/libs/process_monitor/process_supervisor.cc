@@ -0,0 +1,597 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuttlefish/host/libs/process_monitor/process_supervisor.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "android-base/file.h"
+#include "android-base/unique_fd.h"
+#include "json/json.h"
+
+#include "cuttlefish/host/libs/process_monitor/process_monitor.h"
+#include "cuttlefish/posix/strerror.h"
+#include "cuttlefish/process/subprocess.h"
+#include "cuttlefish/process/subprocess_options.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+// epoll user data of the wake eventfd, pidfds use the index of their entry.
+constexpr uint64_t kWakeEvent = std::numeric_limits<uint64_t>::max();
+
+// A subprocess that ran at least this long before exiting is restarted
+// immediately, otherwise the delay before restarting it doubles every time.
+constexpr auto kStableRunTime = std::chrono::seconds(30);
+constexpr milliseconds kInitialRestartDelay(500);
+constexpr milliseconds kMaxRestartDelay(60000);
+
+// How often exited subprocesses that were reparented to this process are
+// reaped, when nothing else wakes it up.
+constexpr milliseconds kReapInterval(5000);
+
+int PidfdOpen(pid_t pid) {
+  // There is no glibc wrapper for pidfd_open.
+#ifndef SYS_pidfd_open
+  constexpr int SYS_pidfd_open = 434;
+#endif
+  return syscall(SYS_pidfd_open, pid, /*flags=*/0);
+}
+
+milliseconds Since(steady_clock::time_point start) {
+  return std::chrono::duration_cast<milliseconds>(steady_clock::now() - start);
+}
+
+void LogSubprocessExit(const std::string& name, pid_t pid, int wstatus) {
+  LOG(INFO) << "Detected unexpected exit of monitored subprocess " << name;
+  if (WIFEXITED(wstatus)) {
+    LOG(INFO) << "Subprocess " << name << " (" << pid
+              << ") has exited with exit code " << WEXITSTATUS(wstatus);
+  } else if (WIFSIGNALED(wstatus)) {
+    int sig_num = WTERMSIG(wstatus);
+    LOG(ERROR) << "Subprocess " << name << " (" << pid
+               << ") was interrupted by a signal '" << strsignal(sig_num)
+               << "' (" << sig_num << ")";
+  } else {
+    LOG(INFO) << "subprocess " << name << " (" << pid
+              << ") has exited for unknown reasons";
+  }
+}
+
+void LogSubprocessExit(const std::string& name, const siginfo_t& infop) {
+  LOG(INFO) << "Detected unexpected exit of monitored subprocess " << name;
+  if (infop.si_code == CLD_EXITED) {
+    LOG(INFO) << "Subprocess " << name << " (" << infop.si_pid
+              << ") has exited with exit code " << infop.si_status;
+  } else if (infop.si_code == CLD_KILLED) {
+    LOG(ERROR) << "Subprocess " << name << " (" << infop.si_pid
+               << ") was interrupted by a signal '"
+               << strsignal(infop.si_status) << "' (" << infop.si_status << ")";
+  } else {
+    LOG(INFO) << "subprocess " << name << " (" << infop.si_pid
+              << ") has exited for unknown reasons (code = " << infop.si_code
+              << ", status = " << infop.si_status << ")";
+  }
+}
+
+Result<void> WriteStartupReport(const std::string& path,
+                                const std::vector<StartupTime>& times) {
+  Json::Value report(Json::arrayValue);
+  for (const StartupTime& time : times) {
+    Json::Value process;
+    process["name"] = time.name;
+    process["started_ms"] = static_cast<Json::Int64>(time.started.count());
+    if (time.ready) {
+      process["ready_ms"] = static_cast<Json::Int64>(time.ready->count());
+    }
+    report.append(process);
+  }
+  Json::StreamWriterBuilder factory;
+  std::string contents = Json::writeString(factory, report);
+  CF_EXPECTF(android::base::WriteStringToFile(contents, path),
+             "Failed to write '{}': {}", path, StrError(errno));
+  return {};
+}
+
+}  // namespace
+
+milliseconds RestartDelay(milliseconds previous,
+                          steady_clock::duration ran_for) {
+  if (ran_for >= kStableRunTime) {
+    return milliseconds(0);
+  }
+  if (previous == milliseconds(0)) {
+    return kInitialRestartDelay;
+  }
+  return std::min(previous * 2, kMaxRestartDelay);
+}
+
+Result<std::unique_ptr<ProcessSupervisor>> ProcessSupervisor::Create(
+    std::vector<MonitorEntry>& monitored, std::mutex& properties_mutex,
+    bool restart_subprocesses, std::string startup_report_path) {
+  android::base::unique_fd epoll(epoll_create1(EPOLL_CLOEXEC));
+  CF_EXPECTF(epoll.ok(), "Failed to create epoll: {}", StrError(errno));
+  android::base::unique_fd wake(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+  CF_EXPECTF(wake.ok(), "Failed to create eventfd: {}", StrError(errno));
+
+  epoll_event event{.events = EPOLLIN, .data = {.u64 = kWakeEvent}};
+  CF_EXPECTF(epoll_ctl(epoll.get(), EPOLL_CTL_ADD, wake.get(), &event) == 0,
+             "Failed to watch eventfd: {}", StrError(errno));
+
+  return std::unique_ptr<ProcessSupervisor>(new ProcessSupervisor(
+      monitored, properties_mutex, restart_subprocesses,
+      std::move(startup_report_path), std::move(epoll), std::move(wake)));
+}
+
+ProcessSupervisor::ProcessSupervisor(std::vector<MonitorEntry>& monitored,
+                                     std::mutex& properties_mutex,
+                                     bool restart_subprocesses,
+                                     std::string startup_report_path,
+                                     android::base::unique_fd epoll,
+                                     android::base::unique_fd wake)
+    : monitored_(monitored),
+      properties_mutex_(properties_mutex),
+      restart_subprocesses_(restart_subprocesses),
+      startup_report_path_(std::move(startup_report_path)),
+      epoll_(std::move(epoll)),
+      wake_(std::move(wake)),
+      states_(monitored.size()) {}
+
+ProcessSupervisor::~ProcessSupervisor() {
+  {
+    std::lock_guard lock(launcher_mutex_);
+    releasing_launcher_ = true;
+  }
+  launcher_cv_.notify_all();
+  if (launcher_.joinable()) {
+    launcher_.join();
+  }
+  for (std::thread& probe : probes_) {
+    probe.join();
+  }
+}
+
+void ProcessSupervisor::Launch(std::vector<SubprocessOptions> options) {
+  VLOG(0) << "Starting monitored subprocesses";
+  launch_start_ = steady_clock::now();
+  launches_pending_ = monitored_.size();
+  readiness_.assign(monitored_.size(), Readiness::kPending);
+  dependencies_.resize(monitored_.size());
+  std::unordered_map<std::string, size_t> index_by_id;
+  for (size_t i = 0; i < monitored_.size(); i++) {
+    if (!monitored_[i].id.empty()) {
+      index_by_id[monitored_[i].id] = i;
+    }
+  }
+  for (size_t i = 0; i < monitored_.size(); i++) {
+    states_[i].cgroup = options[i].Cgroup();
+    for (const std::string& id : monitored_[i].dependencies) {
+      auto it = index_by_id.find(id);
+      if (it == index_by_id.end()) {
+        // Can't become ready, so neither the entry nor its dependents start.
+        LOG(ERROR) << monitored_[i].cmd->GetShortName()
+                   << " depends on unknown command " << id;
+        readiness_[i] = Readiness::kFailed;
+        continue;
+      }
+      dependencies_[i].push_back(it->second);
+    }
+  }
+  if (monitored_.empty()) {
+    Wake();
+    return;
+  }
+  launcher_ = std::thread(&ProcessSupervisor::LauncherLoop, this,
+                          std::move(options));
+}
+
+void ProcessSupervisor::LauncherLoop(std::vector<SubprocessOptions> options) {
+  std::vector<bool> launched(monitored_.size(), false);
+  for (size_t remaining = monitored_.size(); remaining > 0; remaining--) {
+    std::optional<size_t> next;
+    bool dependencies_ready = true;
+    {
+      std::unique_lock lock(launcher_mutex_);
+      launcher_cv_.wait(lock, [this, &launched, &next]() {
+        next = NextLaunch(launched);
+        return next || probes_running_ == 0 || releasing_launcher_;
+      });
+      if (releasing_launcher_) {
+        return;
+      }
+      if (!next) {
+        // The remaining entries wait on each other.
+        next = std::find(launched.begin(), launched.end(), false) -
+               launched.begin();
+        dependencies_ready = false;
+      }
+      dependencies_ready &= readiness_[*next] == Readiness::kPending;
+      for (size_t dependency : dependencies_[*next]) {
+        dependencies_ready &= readiness_[dependency] == Readiness::kReady;
+      }
+    }
+    launched[*next] = true;
+    LaunchEntry(*next, std::move(options[*next]), dependencies_ready);
+  }
+  std::unique_lock lock(launcher_mutex_);
+  launcher_cv_.wait(lock, [this]() { return releasing_launcher_; });
+}
+
+std::optional<size_t> ProcessSupervisor::NextLaunch(
+    const std::vector<bool>& launched) const {
+  for (size_t i = 0; i < monitored_.size(); i++) {
+    if (launched[i]) {
+      continue;
+    }
+    bool settled = std::none_of(
+        dependencies_[i].begin(), dependencies_[i].end(),
+        [this](size_t dependency) {
+          return readiness_[dependency] == Readiness::kPending;
+        });
+    if (settled) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+void ProcessSupervisor::LaunchEntry(size_t index, SubprocessOptions options,
+                                    bool dependencies_ready) {
+  // Only the launcher touches the entry until it is watched, and `cmd` is
+  // never modified once monitoring started.
+  MonitorEntry& entry = monitored_[index];
+  const std::string name = entry.cmd->GetShortName();
+  bool started = false;
+  if (!dependencies_ready) {
+    LOG(ERROR) << "Not starting " << name
+               << " as one of its dependencies never became ready";
+    std::lock_guard lock(properties_mutex_);
+    if (!launch_error_) {
+      launch_error_ = "Dependencies of " + name + " never became ready";
+    }
+  } else {
+    LOG(INFO) << "Starting monitored subprocess: " << name;
+    // Blocks while the command's prerequisites are not met.
+    Subprocess proc = entry.cmd->Start(std::move(options));
+    started = proc.Started();
+    std::lock_guard lock(properties_mutex_);
+    if (started) {
+      entry.proc.reset(new Subprocess(std::move(proc)));
+      Result<void> watched = Watch(index);
+      if (!watched.ok()) {
+        launch_error_ = watched.error().Message();
+        started = false;
+      }
+    } else if (!launch_error_) {
+      launch_error_ = "Failed to start subprocess " + name;
+    }
+  }
+  StartupTime time{.name = name, .started = Since(launch_start_)};
+
+  if (started && entry.readiness_probe) {
+    {
+      std::lock_guard lock(launcher_mutex_);
+      probes_running_++;
+    }
+    probes_.emplace_back(&ProcessSupervisor::ProbeEntry, this, index,
+                         std::move(time));
+    return;
+  }
+  FinishEntry(index, std::move(time),
+              started ? Readiness::kReady : Readiness::kFailed);
+}
+
+void ProcessSupervisor::ProbeEntry(size_t index, StartupTime time) {
+  const MonitorEntry& entry = monitored_[index];
+  Result<void> probed = entry.readiness_probe();
+  if (probed.ok()) {
+    time.ready = Since(launch_start_);
+    LOG(INFO) << time.name << " was ready "
+              << (*time.ready - time.started).count() << " ms after it started";
+  } else {
+    LOG(ERROR) << time.name << " never reported being ready: "
+               << probed.error();
+    std::lock_guard lock(properties_mutex_);
+    if (!launch_error_) {
+      launch_error_ = time.name + " never reported being ready";
+    }
+  }
+  FinishEntry(index, std::move(time),
+              probed.ok() ? Readiness::kReady : Readiness::kFailed);
+  // Only once the readiness is recorded, the launcher takes no running probes
+  // to mean that the remaining entries can't start.
+  std::lock_guard lock(launcher_mutex_);
+  probes_running_--;
+  launcher_cv_.notify_all();
+}
+
+void ProcessSupervisor::FinishEntry(size_t index, StartupTime time,
+                                    Readiness readiness) {
+  {
+    std::lock_guard lock(properties_mutex_);
+    startup_times_.emplace_back(std::move(time));
+  }
+  std::lock_guard lock(launcher_mutex_);
+  readiness_[index] = readiness;
+  if (--launches_pending_ == 0) {
+    Wake();
+  }
+  launcher_cv_.notify_all();
+}
+
+void ProcessSupervisor::WaitForLaunches() {
+  std::unique_lock lock(launcher_mutex_);
+  launcher_cv_.wait(lock, [this]() { return launches_pending_ == 0; });
+}
+
+Result<void> ProcessSupervisor::FinishLaunch() {
+  launch_finished_ = true;
+
+  std::lock_guard lock(properties_mutex_);
+  CF_EXPECT(!launch_error_.has_value(), *launch_error_);
+  std::sort(startup_times_.begin(), startup_times_.end(),
+            [](const StartupTime& a, const StartupTime& b) {
+              return a.started < b.started;
+            });
+  LOG(INFO) << "Started " << startup_times_.size() << " subprocesses in "
+            << Since(launch_start_).count() << " ms";
+  if (!startup_report_path_.empty()) {
+    Result<void> written =
+        WriteStartupReport(startup_report_path_, startup_times_);
+    if (!written.ok()) {
+      LOG(WARNING) << written.error();
+    }
+  }
+  return {};
+}
+
+void ProcessSupervisor::Wake() {
+  // Can only fail if the counter overflows, in which case it is readable
+  // anyway.
+  eventfd_write(wake_.get(), 1);
+}
+
+Result<void> ProcessSupervisor::Run(std::atomic_bool& running) {
+  std::array<epoll_event, 16> events;
+  while (running.load()) {
+    int timeout_ms;
+    {
+      std::lock_guard lock(properties_mutex_);
+      timeout_ms = NextTimeoutMs();
+    }
+    int num_events = TEMP_FAILURE_RETRY(
+        epoll_wait(epoll_.get(), events.data(), events.size(), timeout_ms));
+    CF_EXPECTF(num_events >= 0, "epoll_wait failed: {}", StrError(errno));
+    if (!launch_finished_ && launches_pending_ == 0) {
+      CF_EXPECT(FinishLaunch());
+    }
+    if (!running.load()) {  // Avoid extra restarts near the end
+      break;
+    }
+
+    std::lock_guard lock(properties_mutex_);
+    for (int i = 0; i < num_events; i++) {
+      if (events[i].data.u64 == kWakeEvent) {
+        eventfd_t value;
+        eventfd_read(wake_.get(), &value);
+        continue;
+      }
+      size_t index = events[i].data.u64;
+      // Set to null if an earlier event led to reaping this subprocess.
+      if (!monitored_[index].proc) {
+        continue;
+      }
+      pid_t pid = monitored_[index].proc->pid();
+      int wstatus;
+      pid_t reaped = TEMP_FAILURE_RETRY(waitpid(pid, &wstatus, WNOHANG));
+      CF_EXPECTF(reaped >= 0, "waitpid({}) failed: {}", pid, StrError(errno));
+      if (reaped == pid && !HandleExit(index, wstatus)) {
+        running.store(false);
+        return {};
+      }
+    }
+    // Until then the launcher might still be waiting for its own children,
+    // e.g. in prerequisites.
+    if (launch_finished_ && !ReapAll()) {
+      running.store(false);
+      return {};
+    }
+    CF_EXPECT(RestartDue());
+  }
+  return {};
+}
+
+Result<void> ProcessSupervisor::Watch(size_t index) {
+  EntryState& state = states_[index];
+  pid_t pid = monitored_[index].proc->pid();
+  state.pid = pid;
+  state.started = steady_clock::now();
+  index_by_pid_[pid] = index;
+
+  // Our own copy, the Subprocess drops its pidfd once waited for.
+  int pidfd = monitored_[index].proc->pidfd();
+  state.pidfd.reset(pidfd >= 0 ? fcntl(pidfd, F_DUPFD_CLOEXEC, 0)
+                               : PidfdOpen(pid));
+  if (!state.pidfd.ok()) {
+    // Without pidfds exits are only noticed by the periodic reaping.
+    CF_EXPECTF(errno == ENOSYS, "pidfd_open({}) failed: {}", pid,
+               StrError(errno));
+    return {};
+  }
+  epoll_event event{.events = EPOLLIN, .data = {.u64 = index}};
+  CF_EXPECTF(epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, state.pidfd.get(),
+                       &event) == 0,
+             "Failed to watch pidfd of {}: {}", pid, StrError(errno));
+  return {};
+}
+
+void ProcessSupervisor::Forget(size_t index) {
+  EntryState& state = states_[index];
+  // Closing the pidfd also removes it from the epoll set.
+  state.pidfd.reset();
+  index_by_pid_.erase(state.pid);
+  monitored_[index].proc.reset();
+}
+
+bool ProcessSupervisor::ReapAll() {
+  int wstatus;
+  pid_t pid;
+  while ((pid = waitpid(-1, &wstatus, WNOHANG)) > 0) {
+    auto it = index_by_pid_.find(pid);
+    if (it == index_by_pid_.end()) {
+      LogSubprocessExit("(unknown)", pid, wstatus);
+    } else if (!HandleExit(it->second, wstatus)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ProcessSupervisor::HandleExit(size_t index, int wstatus) {
+  if (!WIFSIGNALED(wstatus) && !WIFEXITED(wstatus)) {
+    VLOG(0) << "Unexpected status from wait: " << wstatus;
+    return true;
+  }
+  MonitorEntry& entry = monitored_[index];
+  EntryState& state = states_[index];
+  LogSubprocessExit(entry.cmd->GetShortName(), entry.proc->pid(), wstatus);
+  Forget(index);
+
+  if (!restart_subprocesses_) {
+    if (entry.is_critical) {
+      LOG(ERROR) << "Stopping all monitored processes due to unexpected "
+                    "exit of critical process";
+      return false;
+    }
+    return true;
+  }
+
+  state.restart_delay =
+      RestartDelay(state.restart_delay, steady_clock::now() - state.started);
+  state.restart_at = steady_clock::now() + state.restart_delay;
+  if (state.restart_delay > milliseconds(0)) {
+    LOG(INFO) << "Restarting " << entry.cmd->GetShortName() << " in "
+              << state.restart_delay.count() << " ms";
+  }
+  return true;
+}
+
+Result<void> ProcessSupervisor::RestartDue() {
+  auto now = steady_clock::now();
+  for (size_t i = 0; i < monitored_.size(); i++) {
+    EntryState& state = states_[i];
+    if (!state.restart_at || *state.restart_at > now) {
+      continue;
+    }
+    state.restart_at.reset();
+    MonitorEntry& entry = monitored_[i];
+    auto options = SubprocessOptions().InGroup(true).Cgroup(state.cgroup);
+    // in the future, cmd->Start might not run exec()
+    Subprocess proc = entry.cmd->Start(std::move(options));
+    if (!proc.Started()) {
+      LOG(ERROR) << "Failed to restart " << entry.cmd->GetShortName();
+      state.restart_delay =
+          RestartDelay(state.restart_delay, steady_clock::duration::zero());
+      state.restart_at = steady_clock::now() + state.restart_delay;
+      continue;
+    }
+    entry.proc.reset(new Subprocess(std::move(proc)));
+    CF_EXPECT(Watch(i));
+  }
+  return {};
+}
+
+Result<void> ProcessSupervisor::Stop() {
+  VLOG(0) << "Stopping monitored subprocesses";
+  std::lock_guard lock(properties_mutex_);
+  auto stop = [this](size_t index) {
+    const MonitorEntry& it = monitored_[index];
+    if (!it.proc) {
+      return true;  // Already exited and wasn't restarted.
+    }
+    auto stop_result = it.proc->Stop();
+    if (stop_result == StopperResult::kFailure) {
+      LOG(WARNING) << "Error in stopping \"" << it.cmd->GetShortName() << "\"";
+      return false;
+    }
+    siginfo_t infop;
+    auto success = it.proc->Wait(&infop, WEXITED);
+    if (success < 0) {
+      LOG(WARNING) << "Failed to wait for process " << it.cmd->GetShortName();
+      return false;
+    }
+    if (stop_result == StopperResult::kCrash) {
+      LogSubprocessExit(it.cmd->GetShortName(), infop);
+    }
+    Forget(index);
+    return true;
+  };
+  // Processes were started in the order they appear in the vector, stop them in
+  // reverse order for symmetry.
+  size_t stopped = 0;
+  for (size_t i = monitored_.size(); i > 0; i--) {
+    stopped += stop(i - 1);
+  }
+  CF_EXPECT(stopped == monitored_.size(), "Didn't stop all subprocesses");
+  return {};
+}
+
+int ProcessSupervisor::NextTimeoutMs() const {
+  std::optional<steady_clock::time_point> next;
+  if (launch_finished_) {
+    next = steady_clock::now() + kReapInterval;
+  }
+  for (const EntryState& state : states_) {
+    if (state.restart_at && (!next || *state.restart_at < *next)) {
+      next = state.restart_at;
+    }
+  }
+  if (!next) {
+    return -1;
+  }
+  auto timeout = std::chrono::ceil<milliseconds>(*next - steady_clock::now());
+  return std::max<int>(timeout.count(), 0);
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "android-base/unique_fd.h"
+
+#include "cuttlefish/host/libs/process_monitor/process_monitor.h"
+#include "cuttlefish/process/subprocess_options.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+struct StartupTime {
+  std::string name;
+  // Measured from the start of `ProcessSupervisor::Launch`.
+  std::chrono::milliseconds started;
+  // Unset for processes without a readiness probe.
+  std::optional<std::chrono::milliseconds> ready;
+};
+
+// How long to wait before restarting a subprocess that exited after running
+// for `ran_for`, given the delay before its previous restart.
+std::chrono::milliseconds RestartDelay(
+    std::chrono::milliseconds previous,
+    std::chrono::steady_clock::duration ran_for);
+
+/*
+ * Starts the monitored subprocesses and waits for them to exit.
+ *
+ * All subprocesses are started from one launcher thread, in the order of the
+ * entries except that an entry is held back until the entries named in its
+ * `dependencies` are ready. Readiness probes run on threads of their own, so
+ * later entries are started while a probe waits. Exits are detected through a
+ * pidfd per subprocess registered with an epoll instance, and crashing
+ * subprocesses are restarted with exponential backoff.
+ */
+class ProcessSupervisor {
+ public:
+  // Unless `startup_report_path` is empty, the start-up times of all
+  // subprocesses are written there as JSON once they have all been launched.
+  static Result<std::unique_ptr<ProcessSupervisor>> Create(
+      std::vector<MonitorEntry>& monitored, std::mutex& properties_mutex,
+      bool restart_subprocesses, std::string startup_report_path);
+
+  ~ProcessSupervisor();
+
+  // Starts all entries, `options[i]` applies to the first start of entry `i`.
+  void Launch(std::vector<SubprocessOptions> options);
+  // Blocks until the first start of every entry was attempted.
+  void WaitForLaunches();
+  // Returns once `running` is false or a critical subprocess exited without
+  // being restarted, in which case `running` is set to false.
+  Result<void> Run(std::atomic_bool& running);
+  // Makes `Run` check `running` again. Safe to call from any thread.
+  void Wake();
+  // Stops the running subprocesses, in the reverse of the order they were
+  // declared in. Only call once `Run` returned and all launches finished.
+  Result<void> Stop();
+
+ private:
+  struct EntryState {
+    // `Subprocess::pid` is reset once the subprocess is waited for.
+    pid_t pid = -1;
+    android::base::unique_fd pidfd;
+    std::chrono::steady_clock::time_point started;
+    std::chrono::milliseconds restart_delay{0};
+    std::optional<std::chrono::steady_clock::time_point> restart_at;
+    // Restarts go to the same cgroup as the first start.
+    std::string cgroup;
+  };
+
+  ProcessSupervisor(std::vector<MonitorEntry>& monitored,
+                    std::mutex& properties_mutex, bool restart_subprocesses,
+                    std::string startup_report_path,
+                    android::base::unique_fd epoll,
+                    android::base::unique_fd wake);
+
+  enum class Readiness { kPending, kReady, kFailed };
+
+  void LauncherLoop(std::vector<SubprocessOptions> options);
+  // Requires `launcher_mutex_`. Returns the first entry that was not launched
+  // yet and whose dependencies are no longer pending.
+  std::optional<size_t> NextLaunch(const std::vector<bool>& launched) const;
+  void LaunchEntry(size_t index, SubprocessOptions options,
+                   bool dependencies_ready);
+  void ProbeEntry(size_t index, StartupTime time);
+  void FinishEntry(size_t index, StartupTime time, Readiness readiness);
+  Result<void> FinishLaunch();
+
+  // The methods below require `properties_mutex_` to be held.
+  Result<void> Watch(size_t index);
+  void Forget(size_t index);
+  // These return false if monitoring should stop.
+  bool ReapAll();
+  bool HandleExit(size_t index, int wstatus);
+  Result<void> RestartDue();
+  int NextTimeoutMs() const;
+
+  std::vector<MonitorEntry>& monitored_;
+  std::mutex& properties_mutex_;
+  bool restart_subprocesses_;
+  std::string startup_report_path_;
+  android::base::unique_fd epoll_;
+  android::base::unique_fd wake_;
+
+  std::chrono::steady_clock::time_point launch_start_;
+  // The parent death signal is sent when the thread that started a subprocess
+  // exits, so the launcher stays alive until destruction.
+  std::thread launcher_;
+  // Only touched by `launcher_` until it is joined.
+  std::vector<std::thread> probes_;
+  // Indices of the entries each entry depends on, fixed once launched.
+  std::vector<std::vector<size_t>> dependencies_;
+  std::atomic_size_t launches_pending_ = 0;
+  // Only used by `Run`.
+  bool launch_finished_ = false;
+  std::mutex launcher_mutex_;
+  std::condition_variable launcher_cv_;
+  // Guarded by `launcher_mutex_`.
+  bool releasing_launcher_ = false;
+  std::vector<Readiness> readiness_;
+  size_t probes_running_ = 0;
+
+  // Guarded by `properties_mutex_`.
+  std::vector<StartupTime> startup_times_;
+  std::optional<std::string> launch_error_;
+  std::vector<EntryState> states_;
+  std::unordered_map<pid_t, size_t> index_by_pid_;
+};
+
+}  // namespace cuttlefish
@@ -0,0 +1,246 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/process_monitor/process_supervisor.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "android-base/file.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/host/libs/process_monitor/process_monitor.h"
+#include "cuttlefish/process/command.h"
+#include "cuttlefish/process/subprocess.h"
+#include "cuttlefish/process/subprocess_options.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using testing::Each;
+using testing::ElementsAre;
+using testing::IsNull;
+using testing::NotNull;
+
+Command Sleep() { return Command("/bin/sleep").AddParameter("100"); }
+
+class ProcessSupervisorTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    if (supervisor_) {
+      supervisor_->WaitForLaunches();
+      EXPECT_THAT(supervisor_->Stop(), IsOk());
+    }
+  }
+
+  void Add(Command command, std::function<Result<void>()> probe = nullptr,
+           std::string id = "", std::vector<std::string> dependencies = {}) {
+    MonitorCommand monitored(std::move(command));
+    monitored.readiness_probe = std::move(probe);
+    monitored.id = std::move(id);
+    monitored.dependencies = std::move(dependencies);
+    entries_.emplace_back(std::move(monitored));
+  }
+
+  void Launch(bool restart_subprocesses = false) {
+    Result<std::unique_ptr<ProcessSupervisor>> supervisor =
+        ProcessSupervisor::Create(entries_, mutex_, restart_subprocesses, "");
+    ASSERT_THAT(supervisor, IsOk());
+    supervisor_ = std::move(*supervisor);
+    supervisor_->Launch(
+        std::vector<SubprocessOptions>(entries_.size(), SubprocessOptions()));
+  }
+
+  std::vector<MonitorEntry> entries_;
+  std::mutex mutex_;
+  std::unique_ptr<ProcessSupervisor> supervisor_;
+};
+
+TEST(RestartDelayTest, DoublesUpToTheLimit) {
+  milliseconds delay(0);
+  std::vector<milliseconds> delays;
+  for (int i = 0; i < 10; i++) {
+    delay = RestartDelay(delay, seconds(1));
+    delays.push_back(delay);
+  }
+  EXPECT_THAT(delays, ElementsAre(milliseconds(500), milliseconds(1000),
+                                  milliseconds(2000), milliseconds(4000),
+                                  milliseconds(8000), milliseconds(16000),
+                                  milliseconds(32000), milliseconds(60000),
+                                  milliseconds(60000), milliseconds(60000)));
+}
+
+TEST(RestartDelayTest, StableProcessesRestartImmediately) {
+  EXPECT_EQ(RestartDelay(milliseconds(60000), seconds(30)), milliseconds(0));
+  EXPECT_EQ(RestartDelay(milliseconds(0), seconds(29)), milliseconds(500));
+}
+
+TEST_F(ProcessSupervisorTest, StopsInReverseOrder) {
+  std::vector<std::string> stopped;
+  for (const std::string name : {"first", "second", "third"}) {
+    Add(Sleep().SetStopper([name, &stopped](Subprocess* proc) {
+      stopped.push_back(name);
+      return KillSubprocess(proc);
+    }));
+  }
+  ASSERT_NO_FATAL_FAILURE(Launch());
+  supervisor_->WaitForLaunches();
+
+  EXPECT_THAT(supervisor_->Stop(), IsOk());
+
+  EXPECT_THAT(stopped, ElementsAre("third", "second", "first"));
+  for (const MonitorEntry& entry : entries_) {
+    EXPECT_THAT(entry.proc, IsNull());
+  }
+}
+
+TEST_F(ProcessSupervisorTest, DependentsWaitForReadiness) {
+  std::atomic_bool ready = false;
+  bool ready_at_dependent_start = false;
+  Add(
+      Sleep(),
+      [&ready]() -> Result<void> {
+        std::this_thread::sleep_for(milliseconds(200));
+        ready = true;
+        return {};
+      },
+      "daemon");
+  Add(Sleep().AddPrerequisite([&]() -> Result<void> {
+    ready_at_dependent_start = ready;
+    return {};
+  }),
+      nullptr, "", {"daemon"});
+  ASSERT_NO_FATAL_FAILURE(Launch());
+  supervisor_->WaitForLaunches();
+
+  EXPECT_THAT(entries_[1].proc, NotNull());
+  EXPECT_TRUE(ready_at_dependent_start);
+}
+
+TEST_F(ProcessSupervisorTest, LaterEntriesStartWhileADependentWaits) {
+  std::vector<std::string> started;
+  auto record = [&started](std::string name) {
+    return [&started, name]() -> Result<void> {
+      started.push_back(name);
+      return {};
+    };
+  };
+  Add(
+      Sleep(),
+      []() -> Result<void> {
+        std::this_thread::sleep_for(milliseconds(200));
+        return {};
+      },
+      "daemon");
+  Add(Sleep().AddPrerequisite(record("dependent")), nullptr, "", {"daemon"});
+  Add(Sleep().AddPrerequisite(record("independent")));
+  ASSERT_NO_FATAL_FAILURE(Launch());
+  supervisor_->WaitForLaunches();
+
+  EXPECT_THAT(started, ElementsAre("independent", "dependent"));
+}
+
+TEST_F(ProcessSupervisorTest, StartsEverythingFromOneThread) {
+  std::vector<std::thread::id> threads;
+  auto record = [&threads]() -> Result<void> {
+    threads.push_back(std::this_thread::get_id());
+    return {};
+  };
+  Add(Sleep().AddPrerequisite(record), []() -> Result<void> { return {}; },
+      "first");
+  Add(Sleep().AddPrerequisite(record), nullptr, "", {"first"});
+  Add(Sleep().AddPrerequisite(record));
+  ASSERT_NO_FATAL_FAILURE(Launch());
+  supervisor_->WaitForLaunches();
+
+  ASSERT_EQ(threads.size(), 3);
+  EXPECT_THAT(threads, Each(threads[0]));
+  EXPECT_NE(threads[0], std::this_thread::get_id());
+}
+
+TEST_F(ProcessSupervisorTest, FailingReadinessProbeStopsTheLaunch) {
+  Add(Sleep(), []() -> Result<void> { return CF_ERR("not ready"); }, "daemon");
+  Add(Sleep(), nullptr, "", {"daemon"});
+  Add(Sleep());
+  ASSERT_NO_FATAL_FAILURE(Launch());
+
+  std::atomic_bool running = true;
+  EXPECT_THAT(supervisor_->Run(running), IsError());
+  supervisor_->WaitForLaunches();
+
+  EXPECT_THAT(entries_[0].proc, NotNull());
+  EXPECT_THAT(entries_[1].proc, IsNull());
+  EXPECT_THAT(entries_[2].proc, NotNull());
+}
+
+TEST_F(ProcessSupervisorTest, UnknownDependencyStopsTheLaunch) {
+  Add(Sleep(), nullptr, "", {"missing"});
+  ASSERT_NO_FATAL_FAILURE(Launch());
+
+  std::atomic_bool running = true;
+  EXPECT_THAT(supervisor_->Run(running), IsError());
+  supervisor_->WaitForLaunches();
+
+  EXPECT_THAT(entries_[0].proc, IsNull());
+}
+
+TEST_F(ProcessSupervisorTest, DependencyCycleStopsTheLaunch) {
+  Add(Sleep(), nullptr, "a", {"b"});
+  Add(Sleep(), nullptr, "b", {"a"});
+  ASSERT_NO_FATAL_FAILURE(Launch());
+
+  std::atomic_bool running = true;
+  EXPECT_THAT(supervisor_->Run(running), IsError());
+  supervisor_->WaitForLaunches();
+
+  EXPECT_THAT(entries_[0].proc, IsNull());
+  EXPECT_THAT(entries_[1].proc, IsNull());
+}
+
+TEST_F(ProcessSupervisorTest, CrashingProcessIsRestartedWithBackoff) {
+  TemporaryDir dir;
+  std::string starts = std::string(dir.path) + "/starts";
+  Add(Command("/bin/sh").AddParameter("-c").AddParameter("echo >> " + starts));
+  ASSERT_NO_FATAL_FAILURE(Launch(/* restart_subprocesses */ true));
+
+  // Restarts at 500 ms, then 1500 ms, and the next one would be at 3500 ms.
+  std::atomic_bool running = true;
+  std::thread stopper([this, &running]() {
+    std::this_thread::sleep_for(milliseconds(2500));
+    running = false;
+    supervisor_->Wake();
+  });
+  EXPECT_THAT(supervisor_->Run(running), IsOk());
+  stopper.join();
+
+  std::string contents;
+  ASSERT_TRUE(android::base::ReadFileToString(starts, &contents));
+  EXPECT_EQ(contents, "\n\n\n");
+}
+
+}  // namespace
+}  // namespace cuttlefish
@@ -16,13 +16,7 @@
 
 #pragma once
 
-#include <condition_variable>
-#include <deque>
-#include <memory>
-#include <mutex>
-#include <thread>
-
-#include "cuttlefish/common/libs/concurrency/semaphore.h"
+#include "cuttlefish/common/libs/concurrency/ring_queue.h"
 #include "cuttlefish/host/libs/screen_connector/screen_connector_common.h"
 
 namespace cuttlefish {
@@ -33,28 +27,15 @@ class ScreenConnectorQueue {
   static_assert(is_movable<T>::value,
                 "Items in ScreenConnectorQueue should be std::mov-able");
 
-  ScreenConnectorQueue(const int q_max_size = 2)
-      : q_mutex_(std::make_unique<std::mutex>()), q_max_size_{q_max_size} {}
+  ScreenConnectorQueue(const int q_max_size = 2) : queue_(q_max_size) {}
   ScreenConnectorQueue(ScreenConnectorQueue&& cq) = delete;
   ScreenConnectorQueue(const ScreenConnectorQueue& cq) = delete;
   ScreenConnectorQueue& operator=(const ScreenConnectorQueue& cq) = delete;
   ScreenConnectorQueue& operator=(ScreenConnectorQueue&& cq) = delete;
 
-  bool IsEmpty() const {
-    const std::lock_guard<std::mutex> lock(*q_mutex_);
-    return buffer_.empty();
-  }
+  bool IsEmpty() const { return queue_.IsEmpty(); }
 
-  auto Size() const {
-    const std::lock_guard<std::mutex> lock(*q_mutex_);
-    return buffer_.size();
-  }
-
-  void WaitEmpty() {
-    auto is_empty = [this](void) { return buffer_.empty(); };
-    std::unique_lock<std::mutex> lock(*q_mutex_);
-    q_empty_.wait(lock, is_empty);
-  }
+  auto Size() const { return queue_.Stats().size; }
 
   /*
    * Push( std::move(src) );
@@ -72,38 +53,20 @@ class ScreenConnectorQueue {
    * WebRTC would not call OnNextFrame --, the producer
    * should stop adding items to the queue.
    *
+   * Always returns true: the frame is never dropped.
    */
-  void Push(T&& item) {
-    std::unique_lock<std::mutex> lock(*q_mutex_);
-    if (Full()) {
-      auto is_empty = [this](void) { return buffer_.empty(); };
-      q_empty_.wait(lock, is_empty);
-    }
-    buffer_.push_back(std::move(item));
+  bool Push(T&& item) {
+    queue_.PushWait(std::move(item));
+    return true;
   }
   void Push(T& item) = delete;
   void Push(const T& item) = delete;
 
-  T Pop() {
-    const std::lock_guard<std::mutex> lock(*q_mutex_);
-    auto item = std::move(buffer_.front());
-    buffer_.pop_front();
-    if (buffer_.empty()) {
-      q_empty_.notify_all();
-    }
-    return item;
-  }
+  T Pop() { return queue_.Pop(); }
 
  private:
-  bool Full() const {
-    // call this in a critical section
-    // after acquiring q_mutex_
-    return q_max_size_ == buffer_.size();
-  }
-  std::deque<T> buffer_;
-  std::unique_ptr<std::mutex> q_mutex_;
-  std::condition_variable q_empty_;
-  const int q_max_size_;
+  // Frames come from the display threads and the Confirmation UI.
+  MpmcQueue<T> queue_;
 };
 
 }  // namespace cuttlefish
@@ -520,16 +520,6 @@ Result<std::vector<MonitorCommand>> CrosvmManager::StartCommands(
   std::vector<MonitorCommand> commands;
 
   CrosvmBuilder crosvm_cmd;
-  crosvm_cmd.Cmd().AddPrerequisite([&dependencyCommands]() -> Result<void> {
-    for (auto dependencyCommand : dependencyCommands) {
-      if (!dependencyCommand->Enabled()) {
-        continue;
-      }
-      CF_EXPECT(dependencyCommand->WaitForAvailability());
-    }
-
-    return {};
-  });
 
   // Add "--restore_path=<guest snapshot directory>" if there is a snapshot
   // path supplied.
@@ -647,7 +637,7 @@ Result<std::vector<MonitorCommand>> CrosvmManager::StartCommands(
     if (instance.vhost_user_block() && disk_i == 2) {
       // TODO: b/346855591 - Run on all devices
       auto block = CF_EXPECT(VhostUserBlockDevice(config, disk_i, disk));
-      commands.emplace_back(std::move(block.device_cmd));
+      commands.emplace_back(std::move(block.device_cmd)).is_vmm = true;
       commands.emplace_back(std::move(block.device_logs_cmd));
       auto socket_path = std::move(block.socket_path);
       crosvm_cmd.Cmd().AddPrerequisite([socket_path]() -> Result<void> {
@@ -978,7 +968,7 @@ Result<std::vector<MonitorCommand>> CrosvmManager::StartCommands(
     // The vhost user gpu crosvm command should be added before the main
     // crosvm command so that the main crosvm command can use a prerequisite
     // to wait for the communication socket to be ready.
-    commands.emplace_back(std::move(vhost_user_gpu->device_cmd));
+    commands.emplace_back(std::move(vhost_user_gpu->device_cmd)).is_vmm = true;
     commands.emplace_back(std::move(vhost_user_gpu->device_logs_cmd));
   }
 
@@ -1031,11 +1021,17 @@ Result<std::vector<MonitorCommand>> CrosvmManager::StartCommands(
                                       gpu_capture_logs);
 
     commands.emplace_back(std::move(gpu_capture_log_tee_cmd));
-    commands.emplace_back(std::move(gpu_capture_command));
+    // crosvm runs as a child of the capture tool and inherits its placement.
+    MonitorCommand& vmm = commands.emplace_back(std::move(gpu_capture_command));
+    vmm.is_vmm = true;
+    AddVmmDependencies(dependencyCommands, vmm);
   } else {
     crosvm_cmd.Cmd().RedirectStdIO(Command::StdIoChannel::kStdOut, crosvm_logs);
     crosvm_cmd.Cmd().RedirectStdIO(Command::StdIoChannel::kStdErr, crosvm_logs);
-    commands.emplace_back(std::move(crosvm_cmd.Cmd()), true);
+    MonitorCommand& vmm =
+        commands.emplace_back(std::move(crosvm_cmd.Cmd()), true);
+    vmm.is_vmm = true;
+    AddVmmDependencies(dependencyCommands, vmm);
   }
 
   return commands;
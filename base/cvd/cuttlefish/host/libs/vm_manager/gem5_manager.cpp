@@ -356,7 +356,7 @@ Result<std::vector<MonitorCommand>> Gem5Manager::StartCommands(
   gem5_cmd.AddEnvironmentVariable("M5_PATH", config.assembly_dir());
 
   std::vector<MonitorCommand> commands;
-  commands.emplace_back(std::move(gem5_cmd), true);
+  commands.emplace_back(std::move(gem5_cmd), true).is_vmm = true;
   return commands;
 }
 
@@ -246,17 +246,6 @@ Result<std::vector<MonitorCommand>> QemuManager::StartCommands(
   auto qemu_version = CF_EXPECT(GetQemuVersion(qemu_binary));
   Command qemu_cmd(qemu_binary, KillSubprocessFallback(Stop));
 
-  qemu_cmd.AddPrerequisite([&dependency_commands]() -> Result<void> {
-    for (auto dependencyCommand : dependency_commands) {
-      if (!dependencyCommand->Enabled()) {
-        continue;
-      }
-      CF_EXPECT(dependencyCommand->WaitForAvailability());
-    }
-
-    return {};
-  });
-
   int hvc_num = 0;
   int serial_num = 0;
   auto add_hvc_sink = [&qemu_cmd, &hvc_num]() {
@@ -678,7 +667,7 @@ Result<std::vector<MonitorCommand>> QemuManager::StartCommands(
   for (const auto& disk : instance.virtual_disk_paths()) {
     if (instance.vhost_user_block()) {
       auto block = CF_EXPECT(VhostUserBlockDevice(config, i, disk));
-      commands.emplace_back(std::move(block.device_cmd));
+      commands.emplace_back(std::move(block.device_cmd)).is_vmm = true;
       commands.emplace_back(std::move(block.device_logs_cmd));
       auto socket_path = std::move(block.socket_path);
       qemu_cmd.AddPrerequisite([socket_path]() -> Result<void> {
@@ -907,7 +896,9 @@ Result<std::vector<MonitorCommand>> QemuManager::StartCommands(
     add_hvc_sink();
   }
 
-  commands.emplace_back(std::move(qemu_cmd), true);
+  MonitorCommand& vmm = commands.emplace_back(std::move(qemu_cmd), true);
+  vmm.is_vmm = true;
+  AddVmmDependencies(dependency_commands, vmm);
   return commands;
 }
 
@@ -80,6 +80,23 @@ ConfigureMultipleBootDevices(const std::string& pci_path, int pci_offset,
   return {{{"androidboot.boot_devices", boot_devices_prop_val}}};
 }
 
+void AddVmmDependencies(
+    const std::vector<VmmDependencyCommand*>& dependency_commands,
+    MonitorCommand& vmm) {
+  for (VmmDependencyCommand* dependency_command : dependency_commands) {
+    if (!dependency_command->Enabled()) {
+      continue;
+    }
+    if (dependency_command->StartsDaemon()) {
+      vmm.dependencies.push_back(dependency_command->Name());
+      continue;
+    }
+    vmm.command.AddPrerequisite([dependency_command]() -> Result<void> {
+      return dependency_command->WaitForAvailability();
+    });
+  }
+}
+
 class VmmCommands : public CommandSource, public LateInjected {
  public:
   INJECT(VmmCommands(const CuttlefishConfig& config, VmManager& vmm))
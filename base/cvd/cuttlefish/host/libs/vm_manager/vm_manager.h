@@ -32,8 +32,14 @@ namespace cuttlefish {
 namespace vm_manager {
 
 // Class for tagging that the CommandSource is a dependency command for the
-// VmManager.
-class VmmDependencyCommand : public virtual StatusCheckCommandSource {};
+// VmManager. Its daemon carries a readiness probe and its Name() as id, the VMM
+// lists it in its dependencies.
+class VmmDependencyCommand : public virtual StatusCheckCommandSource {
+ public:
+  // Whether this instance starts the daemon. Otherwise another instance does
+  // and the VMM waits for it with WaitForAvailability before starting.
+  virtual bool StartsDaemon() const { return true; }
+};
 
 // Superclass of every guest VM manager.
 class VmManager {
@@ -132,5 +138,10 @@ Result<std::unordered_map<std::string, std::string>>
 ConfigureMultipleBootDevices(const std::string& pci_path, int pci_offset,
                              int num_disks);
 
+// Makes the VMM command wait for the enabled dependency commands.
+void AddVmmDependencies(
+    const std::vector<VmmDependencyCommand*>& dependency_commands,
+    MonitorCommand& vmm);
+
 }  // namespace vm_manager
 }  // namespace cuttlefish
@@ -21,8 +21,10 @@
 
 #include <algorithm>
 #include <chrono>
+#include <future>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ranges>
 #include <set>
@@ -50,6 +52,7 @@
 #include "cuttlefish/host/libs/web/android_build_api_key.h"
 #include "cuttlefish/host/libs/web/android_build_string.h"
 #include "cuttlefish/host/libs/web/android_build_url.h"
+#include "cuttlefish/host/libs/web/build_metadata_cache.h"
 #include "cuttlefish/host/libs/web/cas/cas_downloader.h"
 #include "cuttlefish/host/libs/web/credential_source.h"
 #include "cuttlefish/host/libs/web/http_client/http_client.h"
@@ -64,6 +67,17 @@
 namespace cuttlefish {
 namespace {
 
+// Branches move on with every submitted build, so the latest build ids are
+// only reused for a short while before being revalidated.
+constexpr std::chrono::seconds kLatestBuildIdTtl = std::chrono::minutes(1);
+// Builds that reached a terminal status only change when they are signed or
+// reattempted.
+constexpr std::chrono::seconds kFinishedBuildTtl = std::chrono::hours(1);
+
+BuildMetadataCache::Ttl FixedTtl(const std::chrono::seconds ttl) {
+  return [ttl](const Json::Value&) { return ttl; };
+}
+
 bool StatusIsTerminal(const std::string& status) {
   const static std::set<std::string> terminal_statuses = {
       "abandoned", "complete", "error", "ABANDONED", "COMPLETE", "ERROR",
@@ -107,12 +121,14 @@ AndroidBuildApi::AndroidBuildApi(HttpClient& http_client,
                                  AndroidBuildUrl& android_build_url,
                                  CredentialSource* credential_source,
                                  const std::chrono::seconds retry_period,
-                                 CasDownloader* cas_downloader)
+                                 CasDownloader* cas_downloader,
+                                 BuildMetadataCache* metadata_cache)
     : http_client_(http_client),
       android_build_url_(android_build_url),
       credential_source_(credential_source),
       retry_period_(retry_period),
-      cas_downloader_(cas_downloader) {}
+      cas_downloader_(cas_downloader),
+      metadata_cache_(metadata_cache) {}
 
 Result<Build> AndroidBuildApi::GetBuild(const DeviceBuildString& build_string) {
   CF_EXPECT(
@@ -132,7 +148,7 @@ Result<Build> AndroidBuildApi::GetBuild(const DeviceBuildString& build_string) {
       CF_EXPECT(GetBuildInfo(proposed_build_id, *build_string.target));
   const bool blocked_on_status = CF_EXPECT(BlockUntilTerminalStatus(
       build_info.status, proposed_build_id, build_info.target));
-  return DeviceBuild{
+  DeviceBuild build{
       .id = proposed_build_id,
       .branch = build_info.branch,
       .target = build_info.target,
@@ -141,6 +157,13 @@ Result<Build> AndroidBuildApi::GetBuild(const DeviceBuildString& build_string) {
       .status_blocked = blocked_on_status,
       .filepath = build_string.filepath,
   };
+  // Blocking only returns once the status is terminal.
+  if (blocked_on_status || StatusIsTerminal(build_info.status)) {
+    std::lock_guard lock(artifact_listings_mutex_);
+    finished_builds_.emplace(build.id, build.target);
+  }
+  PrefetchArtifacts(build);
+  return build;
 }
 
 Result<Build> AndroidBuildApi::GetBuild(
@@ -158,9 +181,8 @@ Result<Build> AndroidBuildApi::GetBuild(const BuildString& build_string) {
 Result<std::string> AndroidBuildApi::DownloadFile(
     const Build& build, const std::string& target_directory,
     const std::string& artifact_name) {
-  std::unordered_set<std::string> artifacts =
-      CF_EXPECT(Artifacts(build, {artifact_name}));
-  CF_EXPECT(Contains(artifacts, artifact_name),
+  bool has_artifact = CF_EXPECT(HasArtifact(build, artifact_name));
+  CF_EXPECT(std::move(has_artifact),
             "Target " << build << " did not contain " << artifact_name);
   return DownloadTargetFile(build, target_directory, artifact_name);
 }
@@ -195,8 +217,13 @@ Result<SeekableZipSource> AndroidBuildApi::FileReader(
 Result<AndroidBuildApi::BuildInfo> AndroidBuildApi::GetBuildInfo(
     std::string_view build_id, std::string_view target) {
   const std::string url = android_build_url_.GetBuildUrl(build_id, target);
-  auto response =
-      CF_EXPECT(HttpGetToJson(http_client_, url, CF_EXPECT(Headers())));
+  auto ttl = [](const Json::Value& json) {
+    const Json::Value& status = json["build"]["buildAttemptStatus"];
+    return status.isString() && StatusIsTerminal(status.asString())
+               ? kFinishedBuildTtl
+               : std::chrono::seconds::zero();
+  };
+  auto response = CF_EXPECT(GetJson(url, ttl));
 
   std::string no_auth_error_message;
   if (credential_source_ == nullptr && response.http_code == 404) {
@@ -278,22 +305,36 @@ Result<std::vector<std::string>> AndroidBuildApi::Headers() {
   return headers;
 }
 
+Result<HttpResponse<Json::Value>> AndroidBuildApi::GetJson(
+    const std::string& url, const BuildMetadataCache::Ttl& ttl) {
+  if (metadata_cache_ == nullptr) {
+    return CF_EXPECT(HttpGetToJson(http_client_, url, CF_EXPECT(Headers())));
+  }
+  return CF_EXPECT(
+      metadata_cache_->Get(http_client_, url, CF_EXPECT(Headers()), ttl));
+}
+
 Result<std::optional<std::string>> AndroidBuildApi::LatestBuildId(
     const std::string& branch, const std::string& target) {
   struct CandidateBuild {
     std::string build_id;
     std::chrono::system_clock::time_point creation_time;
   };
-  // Find the latest build at every safe level
-  std::vector<CandidateBuild> candidates;
+  // Find the latest build at every safe level, querying them all at once
+  std::vector<std::future<Result<HttpResponse<Json::Value>>>> responses;
   for (const SafeLevel safe_level : kAllSafeLevels) {
     VLOG(0) << "Attempting to download build at safe level '" << safe_level
             << "' for branch '" << branch << "' and target '" << target << "'";
     const std::string url =
         android_build_url_.GetLatestBuildIdUrl(branch, target, safe_level);
-    const std::vector<std::string> headers = CF_EXPECT(Headers());
+    responses.emplace_back(std::async(std::launch::async, [this, url]() {
+      return GetJson(url, FixedTtl(kLatestBuildIdTtl));
+    }));
+  }
+  std::vector<CandidateBuild> candidates;
+  for (auto& response_future : responses) {
     const HttpResponse<Json::Value> response =
-        CF_EXPECT(HttpGetToJson(http_client_, url, headers));
+        CF_EXPECT(response_future.get());
 
     Result<Json::Value> json_res = GetResponseJson(response);
     if (!json_res.ok()) {
@@ -340,12 +381,20 @@ Result<std::unordered_set<std::string>> AndroidBuildApi::Artifacts(
     const std::vector<std::string>& artifact_filenames) {
   std::string page_token = "";
   std::unordered_set<std::string> artifacts;
+  // A build that is still running can gain artifacts at any time.
+  bool finished;
+  {
+    std::lock_guard lock(artifact_listings_mutex_);
+    finished =
+        finished_builds_.count(std::make_pair(build.id, build.target)) > 0;
+  }
+  const BuildMetadataCache::Ttl ttl =
+      FixedTtl(finished ? kFinishedBuildTtl : std::chrono::seconds::zero());
 
   do {
     const std::string url = android_build_url_.GetArtifactUrl(
         build.id, build.target, artifact_filenames, page_token);
-    auto response =
-        CF_EXPECT(HttpGetToJson(http_client_, url, CF_EXPECT(Headers())));
+    auto response = CF_EXPECT(GetJson(url, ttl));
 
     const Json::Value json = CF_EXPECT(GetResponseJson(response),
                                        "Error fetching artifacts list for:\n"
@@ -388,11 +437,47 @@ Result<std::unordered_set<std::string>> AndroidBuildApi::Artifacts(
   return CF_EXPECT(std::move(res));
 }
 
+void AndroidBuildApi::PrefetchArtifacts(const DeviceBuild& build) {
+  std::lock_guard lock(artifact_listings_mutex_);
+  auto key = std::make_pair(build.id, build.target);
+  if (artifact_listings_.count(key) > 0) {
+    return;
+  }
+  artifact_listings_[key] =
+      std::async(std::launch::async, [this, build]() {
+        return Artifacts(build, {});
+      }).share();
+}
+
+Result<bool> AndroidBuildApi::HasArtifact(const Build& build,
+                                          const std::string& artifact) {
+  if (const DeviceBuild* device_build = std::get_if<DeviceBuild>(&build)) {
+    std::optional<ArtifactListing> listing;
+    {
+      std::lock_guard lock(artifact_listings_mutex_);
+      auto it = artifact_listings_.find(
+          std::make_pair(device_build->id, device_build->target));
+      if (it != artifact_listings_.end()) {
+        listing = it->second;
+      }
+    }
+    if (listing && listing->get().ok()) {
+      return Contains(*listing->get(), artifact);
+    } else if (listing) {
+      VLOG(0) << "Listing the artifacts of " << build
+              << " failed, checking for '" << artifact << "' directly";
+    }
+  }
+  return Contains(CF_EXPECT(Artifacts(build, {artifact})), artifact);
+}
+
 Result<std::string> AndroidBuildApi::GetArtifactDownloadUrl(
     const DeviceBuild& build, const std::string& artifact) {
   const std::string download_url_endpoint =
       android_build_url_.GetArtifactDownloadUrl(build.id, build.target,
                                                 artifact);
+  // Not kept in the metadata cache, the signed url grants access to the
+  // artifact to anyone who reads it.
   auto response = CF_EXPECT(
       HttpGetToJson(http_client_, download_url_endpoint, CF_EXPECT(Headers())));
   const Json::Value json =
@@ -16,17 +16,25 @@
 #pragma once
 
 #include <chrono>
+#include <future>
+#include <map>
+#include <mutex>
 #include <optional>
+#include <set>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "json/value.h"
+
 #include "cuttlefish/host/libs/web/android_build.h"
 #include "cuttlefish/host/libs/web/android_build_string.h"
 #include "cuttlefish/host/libs/web/android_build_url.h"
 #include "cuttlefish/host/libs/web/build_api.h"
+#include "cuttlefish/host/libs/web/build_metadata_cache.h"
 #include "cuttlefish/host/libs/web/cas/cas_downloader.h"
 #include "cuttlefish/host/libs/web/credential_source.h"
 #include "cuttlefish/host/libs/web/http_client/http_client.h"
@@ -44,7 +52,8 @@ class AndroidBuildApi : public BuildApi {
       HttpClient& http_client, AndroidBuildUrl& android_build_url,
       CredentialSource* credential_source = nullptr,
       std::chrono::seconds retry_period = std::chrono::seconds::zero(),
-      CasDownloader* cas_downloader = nullptr);
+      CasDownloader* cas_downloader = nullptr,
+      BuildMetadataCache* metadata_cache = nullptr);
 
   Result<Build> GetBuild(const BuildString& build_string) override;
 
@@ -69,6 +78,8 @@ class AndroidBuildApi : public BuildApi {
                                         std::string_view build_id,
                                         std::string_view target);
   Result<std::vector<std::string>> Headers();
+  Result<HttpResponse<Json::Value>> GetJson(
+      const std::string& url, const BuildMetadataCache::Ttl& ttl);
 
   Result<std::optional<std::string>> LatestBuildId(const std::string& branch,
                                                    const std::string& target);
@@ -84,6 +95,11 @@ class AndroidBuildApi : public BuildApi {
   Result<std::unordered_set<std::string>> Artifacts(
       const Build& build, const std::vector<std::string>& artifact_filenames);
 
+  // Starts listing all artifacts of `build` in the background, so that
+  // DownloadFile doesn't need a request of its own to check for an artifact.
+  void PrefetchArtifacts(const DeviceBuild& build);
+  Result<bool> HasArtifact(const Build& build, const std::string& artifact);
+
   Result<std::string> GetArtifactDownloadUrl(const DeviceBuild& build,
                                              const std::string& artifact);
   Result<void> ArtifactToFile(const DeviceBuild& build,
@@ -117,6 +133,17 @@ class AndroidBuildApi : public BuildApi {
   CredentialSource* credential_source_;
   std::chrono::seconds retry_period_;
   CasDownloader* cas_downloader_;
+  BuildMetadataCache* metadata_cache_;
+
+  using ArtifactListing =
+      std::shared_future<Result<std::unordered_set<std::string>>>;
+  std::mutex artifact_listings_mutex_;
+  // Keyed by build id and target. Destroying the listings waits for them.
+  std::map<std::pair<std::string, std::string>, ArtifactListing>
+      artifact_listings_;
+  // Builds that had reached a terminal status when GetBuild returned them,
+  // keyed by build id and target. Only their artifact listings are cached.
+  std::set<std::pair<std::string, std::string>> finished_builds_;
 };
 
 std::tuple<std::string, std::string> GetBuildIdAndTarget(const Build& build);
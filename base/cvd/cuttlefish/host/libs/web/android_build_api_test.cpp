@@ -15,13 +15,18 @@
 
 #include "cuttlefish/host/libs/web/android_build_api.h"
 
+#include <atomic>
+#include <chrono>
 #include <string>
 
+#include "android-base/file.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 #include "cuttlefish/host/libs/web/android_build.h"
+#include "cuttlefish/host/libs/web/android_build_string.h"
 #include "cuttlefish/host/libs/web/android_build_url.h"
+#include "cuttlefish/host/libs/web/build_metadata_cache.h"
 #include "cuttlefish/host/libs/web/http_client/fake_http_client.h"
 #include "cuttlefish/host/libs/web/http_client/http_client.h"
 #include "cuttlefish/host/libs/zip/libzip_cc/seekable_source.h"
@@ -66,5 +71,115 @@ TEST(AndroidBuildApiTest, FileReader) {
       "latest/artifacts/a.zip/url"));
 }
 
+TEST(AndroidBuildApiTest, DownloadFileUsesPrefetchedArtifacts) {
+  FakeHttpClient http_client;
+  AndroidBuildUrl build_url("https://androidbuild-pa.googleapis.com/v4", "",
+                            "");
+  AndroidBuildApi api(http_client, build_url);
+
+  http_client.SetResponse("{}", "/builds?");
+  http_client.SetResponse(
+      R"({"build": {"branch": "main", "buildAttemptStatus": "complete",
+          "target": {"name": "test", "product": "test"}}})",
+      "/builds/123/test");
+  std::atomic<int> listings = 0;
+  http_client.SetResponse(
+      [&listings](const HttpRequest& request) {
+        listings++;
+        EXPECT_EQ(request.url.find("nameRegexp"), std::string::npos);
+        return HttpResponse<std::string>{
+            .data = R"({"artifacts": [{"name": "a.zip"}, {"name": "b.zip"}]})",
+            .http_code = 200,
+        };
+      },
+      "/attempts/latest/artifacts?");
+  http_client.SetResponse("{\"signedUrl\": \"http://zip-url\"}",
+                          "/attempts/latest/artifacts/a.zip/url");
+  http_client.SetResponse("{\"signedUrl\": \"http://zip-url\"}",
+                          "/attempts/latest/artifacts/b.zip/url");
+  http_client.SetResponse("abc", "http://zip-url");
+
+  BuildString build_string =
+      DeviceBuildString{.branch_or_id = "123", .target = "test"};
+  Result<Build> build = api.GetBuild(build_string);
+  ASSERT_THAT(build, IsOk());
+  TemporaryDir dir;
+
+  EXPECT_THAT(api.DownloadFile(*build, dir.path, "a.zip"), IsOk());
+  EXPECT_THAT(api.DownloadFile(*build, dir.path, "b.zip"), IsOk());
+  EXPECT_THAT(api.DownloadFile(*build, dir.path, "c.zip"), IsError());
+  EXPECT_EQ(listings, 1);
+}
+
+struct FetchRequests {
+  int listings;
+  int download_urls;
+};
+
+// Downloads an artifact of a build with `status` twice, through two
+// AndroidBuildApi instances sharing a metadata cache like two `cvd fetch`
+// runs would, and counts the requests that reached the server.
+FetchRequests FetchTwiceWithCache(const std::string& status) {
+  FakeHttpClient http_client;
+  AndroidBuildUrl build_url("https://androidbuild-pa.googleapis.com/v4", "",
+                            "");
+  TemporaryDir cache_dir;
+  BuildMetadataCache cache(cache_dir.path);
+
+  http_client.SetResponse("{}", "/builds?");
+  http_client.SetResponse(
+      R"({"build": {"branch": "main", "buildAttemptStatus": ")" + status +
+          R"(", "target": {"name": "test", "product": "test"}}})",
+      "/builds/123/test");
+  std::atomic<int> listings = 0;
+  http_client.SetResponse(
+      [&listings](const HttpRequest&) {
+        listings++;
+        return HttpResponse<std::string>{
+            .data = R"({"artifacts": [{"name": "a.zip"}]})",
+            .http_code = 200,
+        };
+      },
+      "/attempts/latest/artifacts?");
+  std::atomic<int> download_urls = 0;
+  http_client.SetResponse(
+      [&download_urls](const HttpRequest&) {
+        download_urls++;
+        return HttpResponse<std::string>{
+            .data = R"({"signedUrl": "http://zip-url"})",
+            .http_code = 200,
+        };
+      },
+      "/attempts/latest/artifacts/a.zip/url");
+  http_client.SetResponse("abc", "http://zip-url");
+
+  for (int i = 0; i < 2; i++) {
+    AndroidBuildApi api(http_client, build_url, nullptr,
+                        std::chrono::seconds::zero(), nullptr, &cache);
+    BuildString build_string =
+        DeviceBuildString{.branch_or_id = "123", .target = "test"};
+    Result<Build> build = api.GetBuild(build_string);
+    EXPECT_THAT(build, IsOk());
+    if (build.ok()) {
+      TemporaryDir dir;
+      EXPECT_THAT(api.DownloadFile(*build, dir.path, "a.zip"), IsOk());
+    }
+  }
+  return FetchRequests{.listings = listings, .download_urls = download_urls};
+}
+
+TEST(AndroidBuildApiTest, CachesTheArtifactListingOfAFinishedBuild) {
+  FetchRequests requests = FetchTwiceWithCache("complete");
+  EXPECT_EQ(requests.listings, 1);
+  // Signed urls are never kept on disk.
+  EXPECT_EQ(requests.download_urls, 2);
+}
+
+TEST(AndroidBuildApiTest, RefetchesTheArtifactListingOfARunningBuild) {
+  FetchRequests requests = FetchTwiceWithCache("building");
+  EXPECT_EQ(requests.listings, 2);
+  EXPECT_EQ(requests.download_urls, 2);
+}
+
 }  // namespace
 }  // namespace cuttlefish
@@ -0,0 +1,169 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/web/build_metadata_cache.h"
+
+#include <openssl/sha.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+#include "json/value.h"
+#include "json/writer.h"
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/common/libs/utils/json.h"
+#include "cuttlefish/files/file_exists.h"
+#include "cuttlefish/host/libs/web/http_client/http_client.h"
+#include "cuttlefish/host/libs/web/http_client/http_json.h"
+#include "cuttlefish/host/libs/web/http_client/http_string.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr long kHttpNotModified = 304;
+
+struct Entry {
+  std::chrono::system_clock::time_point expires;
+  std::string etag;
+  Json::Value data;
+};
+
+// Urls can carry an api key, so they are only stored hashed.
+std::string EntryPath(const std::string& directory, std::string_view url) {
+  uint8_t digest[SHA256_DIGEST_LENGTH];
+  SHA256(reinterpret_cast<const uint8_t*>(url.data()), url.size(), digest);
+  return fmt::format("{}/{:02x}.json", directory, fmt::join(digest, ""));
+}
+
+std::optional<Entry> ReadEntry(const std::string& path) {
+  if (!FileExists(path)) {
+    return std::nullopt;
+  }
+  Result<Json::Value> json = LoadFromFile(path);
+  if (!json.ok() || !json->isObject() || !(*json)["expires"].isInt64() ||
+      !(*json)["etag"].isString() || !json->isMember("data")) {
+    LOG(WARNING) << "Ignoring malformed build metadata cache entry \"" << path
+                 << "\"";
+    return std::nullopt;
+  }
+  return Entry{
+      .expires = std::chrono::system_clock::time_point(
+          std::chrono::seconds((*json)["expires"].asInt64())),
+      .etag = (*json)["etag"].asString(),
+      .data = std::move((*json)["data"]),
+  };
+}
+
+// Concurrent fetches may store the same entry, so each one is written to its
+// own file and renamed over the previous version.
+Result<void> WriteEntry(const std::string& directory, const std::string& path,
+                        const Entry& entry) {
+  CF_EXPECT(EnsureDirectoryExists(directory));
+  const auto expires = std::chrono::duration_cast<std::chrono::seconds>(
+      entry.expires.time_since_epoch());
+  Json::Value json;
+  json["expires"] = Json::Int64(expires.count());
+  json["etag"] = entry.etag;
+  json["data"] = entry.data;
+  Json::StreamWriterBuilder factory;
+  factory["indentation"] = "";
+  std::string serialized = Json::writeString(factory, json);
+
+  std::string temp_path = path + ".XXXXXX";
+  SharedFD fd = SharedFD::Mkstemp(&temp_path);
+  CF_EXPECTF(fd->IsOpen(), "Failed to create \"{}\": {}", temp_path,
+             fd->StrError());
+  if (WriteAll(fd, serialized) != static_cast<ssize_t>(serialized.size())) {
+    std::string error = fd->StrError();
+    unlink(temp_path.c_str());
+    return CF_ERRF("Failed to write \"{}\": {}", temp_path, error);
+  }
+  fd->Close();
+  CF_EXPECT(RenameFile(temp_path, path));
+  return {};
+}
+
+}  // namespace
+
+BuildMetadataCache::BuildMetadataCache(std::string directory)
+    : directory_(std::move(directory)) {}
+
+Result<HttpResponse<Json::Value>> BuildMetadataCache::Get(
+    HttpClient& http_client, const std::string& url,
+    std::vector<std::string> headers, const Ttl& ttl) {
+  const std::string path = EntryPath(directory_, url);
+  std::optional<Entry> entry = ReadEntry(path);
+  const auto now = std::chrono::system_clock::now();
+  if (entry && now < entry->expires) {
+    VLOG(1) << "Using build metadata from \"" << path << "\"";
+    return HttpResponse<Json::Value>{
+        .data = std::move(entry->data),
+        .http_code = 200,
+    };
+  }
+  if (entry && !entry->etag.empty()) {
+    headers.push_back("If-None-Match: " + entry->etag);
+  }
+
+  HttpResponse<std::string> raw_response =
+      CF_EXPECT(HttpGetToString(http_client, url, headers));
+  HttpResponse<Json::Value> response;
+  std::string etag;
+  if (entry && raw_response.http_code == kHttpNotModified) {
+    VLOG(1) << "Revalidated build metadata in \"" << path << "\"";
+    etag = HeaderValue(raw_response.headers, "ETag").value_or(entry->etag);
+    response = HttpResponse<Json::Value>{
+        .data = std::move(entry->data),
+        .http_code = 200,
+        .headers = std::move(raw_response.headers),
+    };
+  } else {
+    etag = HeaderValue(raw_response.headers, "ETag").value_or("");
+    response = HttpResponseToJson(std::move(raw_response));
+    if (!response.HttpSuccess() || response.data.isMember("error")) {
+      return response;
+    }
+  }
+
+  const std::chrono::seconds fresh_for = ttl(response.data);
+  if (fresh_for == std::chrono::seconds::zero() && etag.empty()) {
+    return response;
+  }
+  Entry updated{
+      .expires = now + fresh_for,
+      .etag = std::move(etag),
+      .data = response.data,
+  };
+  Result<void> written = WriteEntry(directory_, path, updated);
+  if (!written.ok()) {
+    LOG(WARNING) << "Failed to cache build metadata: " << written.error();
+  }
+  return response;
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,52 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "json/value.h"
+
+#include "cuttlefish/host/libs/web/http_client/http_client.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+// Keeps json responses from the build API on disk across `cvd fetch` runs.
+//
+// A stored response is returned without contacting the server until its time
+// to live runs out. After that it is revalidated with the ETag the server sent
+// along with it, so an unchanged response costs a round trip but no body.
+class BuildMetadataCache {
+ public:
+  // How long a response may be used without revalidation, given its contents.
+  using Ttl = std::function<std::chrono::seconds(const Json::Value&)>;
+
+  explicit BuildMetadataCache(std::string directory);
+
+  // Behaves like `HttpGetToJson`. Only successful responses are stored.
+  Result<HttpResponse<Json::Value>> Get(HttpClient& http_client,
+                                        const std::string& url,
+                                        std::vector<std::string> headers,
+                                        const Ttl& ttl);
+
+ private:
+  std::string directory_;
+};
+
+}  // namespace cuttlefish
@@ -0,0 +1,135 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/web/build_metadata_cache.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "android-base/file.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "json/value.h"
+
+#include "cuttlefish/host/libs/web/http_client/fake_http_client.h"
+#include "cuttlefish/host/libs/web/http_client/http_client.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+using testing::Contains;
+using testing::Not;
+
+constexpr char kUrl[] = "https://build.test/builds/123/target";
+
+BuildMetadataCache::Ttl FixedTtl(std::chrono::seconds ttl) {
+  return [ttl](const Json::Value&) { return ttl; };
+}
+
+class BuildMetadataCacheTest : public testing::Test {
+ protected:
+  Result<HttpResponse<Json::Value>> Get(std::chrono::seconds ttl) {
+    return cache_.Get(http_client_, kUrl, {}, FixedTtl(ttl));
+  }
+
+  // Responds with `body` and `etag`, or with 304 if the request already has
+  // that ETag.
+  void Serve(std::string body, std::string etag) {
+    http_client_.SetResponse(
+        [this, body, etag](const HttpRequest& request) {
+          requests_.push_back(request);
+          if (!etag.empty() &&
+              absl::c_linear_search(request.headers,
+                                    "If-None-Match: " + etag)) {
+            return HttpResponse<std::string>{.http_code = 304};
+          }
+          return HttpResponse<std::string>{
+              .data = body,
+              .http_code = 200,
+              .headers = {{"ETag", etag}},
+          };
+        },
+        kUrl);
+  }
+
+  TemporaryDir dir_;
+  FakeHttpClient http_client_;
+  BuildMetadataCache cache_{dir_.path};
+  std::vector<HttpRequest> requests_;
+};
+
+TEST_F(BuildMetadataCacheTest, ReusesFreshResponses) {
+  Serve(R"({"status": "complete"})", "");
+
+  ASSERT_THAT(Get(std::chrono::hours(1)), IsOk());
+  Result<HttpResponse<Json::Value>> response = Get(std::chrono::hours(1));
+
+  ASSERT_THAT(response, IsOk());
+  EXPECT_EQ(response->http_code, 200);
+  EXPECT_EQ(response->data["status"], "complete");
+  EXPECT_EQ(requests_.size(), 1);
+}
+
+TEST_F(BuildMetadataCacheTest, RevalidatesStaleResponses) {
+  Serve(R"({"status": "complete"})", "\"v1\"");
+
+  ASSERT_THAT(Get(std::chrono::seconds::zero()), IsOk());
+  Result<HttpResponse<Json::Value>> response =
+      Get(std::chrono::seconds::zero());
+
+  ASSERT_THAT(response, IsOk());
+  EXPECT_EQ(response->http_code, 200);
+  EXPECT_EQ(response->data["status"], "complete");
+  ASSERT_EQ(requests_.size(), 2);
+  EXPECT_THAT(requests_[0].headers, Not(Contains("If-None-Match: \"v1\"")));
+  EXPECT_THAT(requests_[1].headers, Contains("If-None-Match: \"v1\""));
+}
+
+TEST_F(BuildMetadataCacheTest, ReplacesChangedResponses) {
+  Serve(R"({"status": "building"})", "\"v1\"");
+  ASSERT_THAT(Get(std::chrono::seconds::zero()), IsOk());
+
+  Serve(R"({"status": "complete"})", "\"v2\"");
+  Result<HttpResponse<Json::Value>> response =
+      Get(std::chrono::seconds::zero());
+
+  ASSERT_THAT(response, IsOk());
+  EXPECT_EQ(response->data["status"], "complete");
+  ASSERT_THAT(Get(std::chrono::seconds::zero()), IsOk());
+  EXPECT_THAT(requests_.back().headers, Contains("If-None-Match: \"v2\""));
+}
+
+TEST_F(BuildMetadataCacheTest, DoesNotStoreErrors) {
+  http_client_.SetResponse(
+      [this](const HttpRequest& request) {
+        requests_.push_back(request);
+        return HttpResponse<std::string>{.data = "{}", .http_code = 404};
+      },
+      kUrl);
+
+  Result<HttpResponse<Json::Value>> response = Get(std::chrono::hours(1));
+  ASSERT_THAT(response, IsOk());
+  EXPECT_EQ(response->http_code, 404);
+  ASSERT_THAT(Get(std::chrono::hours(1)), IsOk());
+
+  EXPECT_EQ(requests_.size(), 2);
+}
+
+}  // namespace
+}  // namespace cuttlefish
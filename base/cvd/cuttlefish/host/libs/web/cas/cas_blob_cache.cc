@@ -0,0 +1,196 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/web/cas/cas_blob_cache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "fmt/format.h"
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/files/copy.h"
+#include "cuttlefish/files/file_exists.h"
+#include "cuttlefish/host/libs/web/cas/cas_digest.h"
+#include "cuttlefish/posix/strerror.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr char kTempDirectory[] = "tmp";
+
+}  // namespace
+
+Result<std::unique_ptr<CasBlobCache>> CasBlobCache::Create(
+    std::string directory, int64_t max_size, bool use_hardlink) {
+  CF_EXPECT(EnsureDirectoryExists(directory, 0755));
+  CF_EXPECT(EnsureDirectoryExists(directory + "/" + kTempDirectory, 0755));
+  return std::unique_ptr<CasBlobCache>(
+      new CasBlobCache(std::move(directory), max_size, use_hardlink));
+}
+
+CasBlobCache::CasBlobCache(std::string directory, int64_t max_size,
+                           bool use_hardlink)
+    : directory_(std::move(directory)),
+      max_size_(max_size),
+      use_hardlink_(use_hardlink) {}
+
+std::string CasBlobCache::BlobPath(const CasDigest& digest) const {
+  return fmt::format("{}/{}/{}_{}", directory_, digest.hash.substr(0, 2),
+                     digest.hash, digest.size);
+}
+
+std::optional<std::string> CasBlobCache::Find(const CasDigest& digest) {
+  std::string path = BlobPath(digest);
+  // Refreshing the modification time is what keeps the blob from being
+  // trimmed, and doubles as the existence check.
+  if (utimensat(AT_FDCWD, path.c_str(), nullptr, 0) != 0) {
+    return std::nullopt;
+  }
+  return path;
+}
+
+Result<bool> CasBlobCache::Materialize(const CasDigest& digest,
+                                       const std::string& destination) {
+  std::optional<std::string> path = Find(digest);
+  if (!path) {
+    return false;
+  }
+  if (use_hardlink_) {
+    CF_EXPECT(LinkOrCopy(*path, destination, /* overwrite_existing= */ true));
+    return true;
+  }
+  if (FileExists(destination)) {
+    CF_EXPECT(RemoveFile(destination));
+  }
+  CF_EXPECTF(Copy(*path, destination), "Failed to copy '{}' to '{}'", *path,
+             destination);
+  return true;
+}
+
+Result<void> CasBlobCache::Add(const CasDigest& digest,
+                               std::string_view data) {
+  auto [fd, temp_path] = CF_EXPECT(
+      SharedFD::Mkostemp(fmt::format("{}/{}/blob", directory_, kTempDirectory)));
+  if (WriteAll(fd, data) != static_cast<ssize_t>(data.size())) {
+    unlink(temp_path.c_str());
+    return CF_ERRF("Failed to write '{}': {}", temp_path, fd->StrError());
+  }
+  fd->Close();
+  CF_EXPECT(Commit(temp_path, digest));
+  return {};
+}
+
+Result<void> CasBlobCache::AddFile(const CasDigest& digest,
+                                   const std::string& path) {
+  std::string blob_path = BlobPath(digest);
+  if (use_hardlink_) {
+    CF_EXPECT(EnsureDirectoryExists(blob_path.substr(0, blob_path.rfind('/')),
+                                    0755));
+    if (link(path.c_str(), blob_path.c_str()) == 0 || errno == EEXIST) {
+      return {};
+    }
+  }
+  auto [fd, temp_path] = CF_EXPECT(
+      SharedFD::Mkostemp(fmt::format("{}/{}/blob", directory_, kTempDirectory)));
+  fd->Close();
+  if (!Copy(path, temp_path)) {
+    unlink(temp_path.c_str());
+    return CF_ERRF("Failed to copy '{}' to '{}'", path, temp_path);
+  }
+  CF_EXPECT(Commit(temp_path, digest));
+  return {};
+}
+
+Result<void> CasBlobCache::Commit(const std::string& temp_path,
+                                  const CasDigest& digest) {
+  std::string blob_path = BlobPath(digest);
+  CF_EXPECT(
+      EnsureDirectoryExists(blob_path.substr(0, blob_path.rfind('/')), 0755));
+  if (rename(temp_path.c_str(), blob_path.c_str()) != 0) {
+    int error = errno;
+    unlink(temp_path.c_str());
+    return CF_ERRF("Failed to rename '{}' to '{}': {}", temp_path, blob_path,
+                   StrError(error));
+  }
+  return {};
+}
+
+Result<void> CasBlobCache::Trim() {
+  if (max_size_ <= 0) {
+    return {};
+  }
+  struct Entry {
+    std::string path;
+    struct timespec mtime;
+    int64_t size;
+  };
+  std::vector<Entry> entries;
+  int64_t total = 0;
+  for (const std::string& prefix : CF_EXPECT(DirectoryContents(directory_))) {
+    if (prefix == kTempDirectory) {
+      continue;
+    }
+    std::string prefix_path = directory_ + "/" + prefix;
+    for (const std::string& blob : CF_EXPECT(DirectoryContents(prefix_path))) {
+      std::string path = prefix_path + "/" + blob;
+      struct stat st;
+      if (stat(path.c_str(), &st) != 0) {
+        continue;  // Removed by another process.
+      }
+      entries.push_back(Entry{path, st.st_mtim, st.st_size});
+      total += st.st_size;
+    }
+  }
+  if (total <= max_size_) {
+    return {};
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) {
+              return std::make_pair(a.mtime.tv_sec, a.mtime.tv_nsec) <
+                     std::make_pair(b.mtime.tv_sec, b.mtime.tv_nsec);
+            });
+  size_t removed = 0;
+  for (const Entry& entry : entries) {
+    if (total <= max_size_) {
+      break;
+    }
+    if (unlink(entry.path.c_str()) == 0 || errno == ENOENT) {
+      total -= entry.size;
+      removed++;
+    }
+  }
+  VLOG(0) << "Removed " << removed << " blobs from the CAS cache at '"
+          << directory_ << "'";
+  return {};
+}
+
+}  // namespace cuttlefish
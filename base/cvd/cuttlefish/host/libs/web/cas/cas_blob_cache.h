@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "cuttlefish/host/libs/web/cas/cas_digest.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+// A local store of CAS blobs keyed by digest, shared by every download that
+// uses the same directory, including downloads from other processes. Blobs
+// are written to a temporary file and renamed into place, so readers never
+// see partial content. The least recently used blobs are removed once the
+// store grows beyond its size limit.
+class CasBlobCache {
+ public:
+  static Result<std::unique_ptr<CasBlobCache>> Create(std::string directory,
+                                                      int64_t max_size,
+                                                      bool use_hardlink);
+
+  // Returns the path of the blob if it is present and marks it as recently
+  // used. The file must not be modified.
+  std::optional<std::string> Find(const CasDigest& digest);
+
+  // Places a copy of the blob at `destination`, hard linking it when allowed.
+  // Returns false if the blob is not present.
+  Result<bool> Materialize(const CasDigest& digest,
+                           const std::string& destination);
+
+  // `data` must already have been verified against `digest`.
+  Result<void> Add(const CasDigest& digest, std::string_view data);
+  // Adds the content of the file at `path`, which must already have been
+  // verified against `digest`.
+  Result<void> AddFile(const CasDigest& digest, const std::string& path);
+
+  // Removes the least recently used blobs until the store fits in its size
+  // limit.
+  Result<void> Trim();
+
+ private:
+  CasBlobCache(std::string directory, int64_t max_size, bool use_hardlink);
+
+  std::string BlobPath(const CasDigest& digest) const;
+  Result<void> Commit(const std::string& temp_path, const CasDigest& digest);
+
+  const std::string directory_;
+  const int64_t max_size_;
+  const bool use_hardlink_;
+};
+
+}  // namespace cuttlefish
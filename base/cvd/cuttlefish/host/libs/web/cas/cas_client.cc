@@ -0,0 +1,194 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/web/cas/cas_client.h"
+
+#include <stdint.h>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fmt/format.h"
+#include "google/bytestream/bytestream.grpc.pb.h"
+#include "grpcpp/channel.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/status.h"
+
+#include "cuttlefish/host/libs/web/cas/cas_digest.h"
+#include "cuttlefish/host/libs/web/cas/remote_execution.grpc.pb.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+using build::bazel::remote::execution::v2::BatchReadBlobsRequest;
+using build::bazel::remote::execution::v2::BatchReadBlobsResponse;
+using build::bazel::remote::execution::v2::ContentAddressableStorage;
+using build::bazel::remote::execution::v2::Digest;
+using build::bazel::remote::execution::v2::Directory;
+using build::bazel::remote::execution::v2::GetTreeRequest;
+using build::bazel::remote::execution::v2::GetTreeResponse;
+using build::bazel::remote::execution::v2::SplitBlobRequest;
+using build::bazel::remote::execution::v2::SplitBlobResponse;
+using google::bytestream::ByteStream;
+using google::bytestream::ReadRequest;
+using google::bytestream::ReadResponse;
+
+void SetDigest(const CasDigest& from, Digest* to) {
+  to->set_hash(from.hash);
+  to->set_size_bytes(from.size);
+}
+
+CasDigest FromProto(const Digest& digest) {
+  return CasDigest{.hash = digest.hash(), .size = digest.size_bytes()};
+}
+
+Result<void> CheckStatus(const grpc::Status& status, std::string_view rpc) {
+  CF_EXPECTF(status.ok(), "{} failed with code {}: {}", rpc,
+             static_cast<int>(status.error_code()), status.error_message());
+  return {};
+}
+
+}  // namespace
+
+CasClient::CasClient(std::shared_ptr<grpc::Channel> channel,
+                     std::string instance, CasClientTimeouts timeouts)
+    : cas_(ContentAddressableStorage::NewStub(channel)),
+      bytestream_(ByteStream::NewStub(channel)),
+      instance_(std::move(instance)),
+      timeouts_(timeouts) {}
+
+std::unique_ptr<grpc::ClientContext> CasClient::Context(
+    std::chrono::seconds timeout) {
+  auto context = std::make_unique<grpc::ClientContext>();
+  context->set_deadline(std::chrono::system_clock::now() + timeout);
+  return context;
+}
+
+Result<std::vector<Directory>> CasClient::GetTree(const CasDigest& root) {
+  std::vector<Directory> directories;
+  GetTreeRequest request;
+  request.set_instance_name(instance_);
+  SetDigest(root, request.mutable_root_digest());
+  do {
+    std::unique_ptr<grpc::ClientContext> context = Context(timeouts_.get_tree);
+    auto reader = cas_->GetTree(context.get(), request);
+    GetTreeResponse response;
+    request.clear_page_token();
+    while (reader->Read(&response)) {
+      for (Directory& directory : *response.mutable_directories()) {
+        directories.emplace_back(std::move(directory));
+      }
+      request.set_page_token(response.next_page_token());
+    }
+    CF_EXPECT(CheckStatus(reader->Finish(), "GetTree"));
+  } while (!request.page_token().empty());
+  return directories;
+}
+
+Result<std::vector<std::string>> CasClient::BatchReadBlobs(
+    const std::vector<CasDigest>& digests) {
+  BatchReadBlobsRequest request;
+  request.set_instance_name(instance_);
+  for (const CasDigest& digest : digests) {
+    SetDigest(digest, request.add_digests());
+  }
+  BatchReadBlobsResponse response;
+  std::unique_ptr<grpc::ClientContext> context =
+      Context(timeouts_.batch_read_blobs);
+  CF_EXPECT(CheckStatus(
+      cas_->BatchReadBlobs(context.get(), request, &response),
+      "BatchReadBlobs"));
+
+  // The server may answer in any order.
+  std::map<CasDigest, std::string*> blobs;
+  for (auto& blob : *response.mutable_responses()) {
+    CasDigest digest = FromProto(blob.digest());
+    CF_EXPECTF(blob.status().code() == 0, "Reading blob {} failed: {}",
+               digest.ToString(), blob.status().message());
+    CF_EXPECTF(ComputeCasDigest(blob.data()) == digest,
+               "Blob {} does not match its digest", digest.ToString());
+    blobs[digest] = blob.mutable_data();
+  }
+  std::vector<std::string> data;
+  data.reserve(digests.size());
+  for (const CasDigest& digest : digests) {
+    auto it = blobs.find(digest);
+    CF_EXPECTF(it != blobs.end(), "Blob {} missing from BatchReadBlobs",
+               digest.ToString());
+    data.emplace_back(*it->second);
+  }
+  return data;
+}
+
+Result<void> CasClient::ReadBlob(
+    const CasDigest& digest,
+    const std::function<Result<void>(std::string_view)>& callback) {
+  ReadRequest request;
+  request.set_resource_name(
+      instance_.empty()
+          ? fmt::format("blobs/{}/{}", digest.hash, digest.size)
+          : fmt::format("{}/blobs/{}/{}", instance_, digest.hash, digest.size));
+  std::unique_ptr<grpc::ClientContext> context = Context(timeouts_.rpc);
+  auto reader = bytestream_->Read(context.get(), request);
+  CasHasher hasher;
+  ReadResponse response;
+  while (reader->Read(&response)) {
+    hasher.Update(response.data());
+    Result<void> result = callback(response.data());
+    if (!result.ok()) {
+      context->TryCancel();
+      reader->Finish();
+      CF_EXPECT(std::move(result));
+    }
+  }
+  CF_EXPECT(CheckStatus(reader->Finish(), "ByteStream.Read"));
+  CF_EXPECTF(hasher.Finish() == digest, "Blob {} does not match its digest",
+             digest.ToString());
+  return {};
+}
+
+Result<std::optional<std::vector<CasDigest>>> CasClient::SplitBlob(
+    const CasDigest& digest) {
+  SplitBlobRequest request;
+  request.set_instance_name(instance_);
+  SetDigest(digest, request.mutable_blob_digest());
+  SplitBlobResponse response;
+  std::unique_ptr<grpc::ClientContext> context = Context(timeouts_.rpc);
+  grpc::Status status = cas_->SplitBlob(context.get(), request, &response);
+  if (status.error_code() == grpc::StatusCode::UNIMPLEMENTED) {
+    return std::nullopt;
+  }
+  CF_EXPECT(CheckStatus(status, "SplitBlob"));
+  std::vector<CasDigest> chunks;
+  int64_t total = 0;
+  for (const Digest& chunk : response.chunk_digests()) {
+    chunks.emplace_back(FromProto(chunk));
+    total += chunk.size_bytes();
+  }
+  CF_EXPECTF(total == digest.size,
+             "Chunks of blob {} add up to {} bytes instead of {}",
+             digest.ToString(), total, digest.size);
+  return chunks;
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,80 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "google/bytestream/bytestream.grpc.pb.h"
+#include "grpcpp/channel.h"
+
+#include "cuttlefish/host/libs/web/cas/cas_digest.h"
+#include "cuttlefish/host/libs/web/cas/remote_execution.grpc.pb.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+struct CasClientTimeouts {
+  std::chrono::seconds rpc{120};
+  std::chrono::seconds get_tree{5};
+  std::chrono::seconds batch_read_blobs{180};
+};
+
+// Reads from one instance of a Remote Execution API content addressable
+// storage, through the ContentAddressableStorage service for directories and
+// small blobs and the ByteStream service for large blobs. Thread safe; calls
+// from different threads share the channel's connections.
+class CasClient {
+ public:
+  CasClient(std::shared_ptr<grpc::Channel> channel, std::string instance,
+            CasClientTimeouts timeouts = {});
+
+  // Returns every directory in the tree rooted at `root`.
+  Result<std::vector<build::bazel::remote::execution::v2::Directory>> GetTree(
+      const CasDigest& root);
+
+  // Returns the content of each blob, in the order of `digests`. The total
+  // size should stay within what the server accepts in one message.
+  Result<std::vector<std::string>> BatchReadBlobs(
+      const std::vector<CasDigest>& digests);
+
+  // Passes the content of the blob to `callback` as it arrives.
+  Result<void> ReadBlob(
+      const CasDigest& digest,
+      const std::function<Result<void>(std::string_view)>& callback);
+
+  // Returns the digests of the chunks the server stores the blob as, or
+  // nullopt if the server does not support splitting blobs.
+  Result<std::optional<std::vector<CasDigest>>> SplitBlob(
+      const CasDigest& digest);
+
+ private:
+  std::unique_ptr<grpc::ClientContext> Context(std::chrono::seconds timeout);
+
+  std::unique_ptr<
+      build::bazel::remote::execution::v2::ContentAddressableStorage::Stub>
+      cas_;
+  std::unique_ptr<google::bytestream::ByteStream::Stub> bytestream_;
+  const std::string instance_;
+  const CasClientTimeouts timeouts_;
+};
+
+}  // namespace cuttlefish
@@ -0,0 +1,79 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/web/cas/cas_digest.h"
+
+#include <openssl/sha.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "fmt/format.h"
+
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+std::string CasDigest::ToString() const {
+  return fmt::format("{}/{}", hash, size);
+}
+
+Result<CasDigest> ParseCasDigest(std::string_view digest) {
+  std::vector<std::string_view> parts = absl::StrSplit(digest, '/');
+  CF_EXPECTF(parts.size() == 2, "'{}' is not of the form <hash>/<size>",
+             digest);
+  CasDigest parsed;
+  parsed.hash = absl::AsciiStrToLower(parts[0]);
+  CF_EXPECTF(parsed.hash.size() == 2 * SHA256_DIGEST_LENGTH,
+             "'{}' is not a SHA-256 hash", parts[0]);
+  for (char c : parsed.hash) {
+    CF_EXPECTF(absl::ascii_isxdigit(c), "'{}' is not a SHA-256 hash",
+               parts[0]);
+  }
+  CF_EXPECTF(absl::SimpleAtoi(parts[1], &parsed.size) && parsed.size >= 0,
+             "'{}' is not a valid size", parts[1]);
+  return parsed;
+}
+
+CasHasher::CasHasher() { SHA256_Init(&ctx_); }
+
+void CasHasher::Update(std::string_view data) {
+  SHA256_Update(&ctx_, data.data(), data.size());
+  size_ += data.size();
+}
+
+CasDigest CasHasher::Finish() {
+  uint8_t hash[SHA256_DIGEST_LENGTH];
+  SHA256_Final(hash, &ctx_);
+  CasDigest digest{.size = size_};
+  digest.hash.reserve(2 * SHA256_DIGEST_LENGTH);
+  for (uint8_t byte : hash) {
+    digest.hash += fmt::format("{:02x}", byte);
+  }
+  return digest;
+}
+
+CasDigest ComputeCasDigest(std::string_view data) {
+  CasHasher hasher;
+  hasher.Update(data);
+  return hasher.Finish();
+}
+
+}  // namespace cuttlefish
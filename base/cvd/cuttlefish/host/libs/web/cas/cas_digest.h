@@ -0,0 +1,57 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <openssl/sha.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+// Identifies a blob in CAS by the SHA-256 of its content and its size.
+struct CasDigest {
+  std::string hash;  // lowercase hex
+  int64_t size = 0;
+
+  // The "<hash>/<size>" form used in cas_digests.json and resource names.
+  std::string ToString() const;
+
+  bool operator==(const CasDigest&) const = default;
+  auto operator<=>(const CasDigest&) const = default;
+};
+
+Result<CasDigest> ParseCasDigest(std::string_view digest);
+
+// Computes the digest of data that arrives in pieces.
+class CasHasher {
+ public:
+  CasHasher();
+
+  void Update(std::string_view data);
+  CasDigest Finish();
+
+ private:
+  SHA256_CTX ctx_;
+  int64_t size_ = 0;
+};
+
+CasDigest ComputeCasDigest(std::string_view data);
+
+}  // namespace cuttlefish
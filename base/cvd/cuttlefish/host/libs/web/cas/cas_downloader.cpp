@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdio>
 #include <map>
@@ -30,8 +31,10 @@
 
 #include "absl/log/log.h"
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
 #include "android-base/expected.h"
 #include "json/value.h"
 
@@ -39,6 +42,7 @@
 #include "cuttlefish/common/libs/utils/json.h"
 #include "cuttlefish/files/file_exists.h"
 #include "cuttlefish/host/libs/web/android_build.h"
+#include "cuttlefish/host/libs/web/cas/cas_fetcher.h"
 #include "cuttlefish/host/libs/web/cas/cas_flags.h"
 #include "cuttlefish/process/command.h"
 #include "cuttlefish/process/managed_stdio.h"
@@ -286,6 +290,66 @@ Result<bool> HasConfigFile(const FlagValue<std::string>& config_filepath_flag) {
   return false;  // Path was a default, but file doesn't exist.
 }
 
+std::chrono::seconds ParseTimeout(const Json::Value& value,
+                                  int default_seconds) {
+  int seconds = default_seconds;
+  if (value.isIntegral()) {
+    seconds = value.asInt();
+  } else if (value.isString()) {
+    std::string_view text = value.asString();
+    absl::ConsumeSuffix(&text, "s");
+    if (!absl::SimpleAtoi(text, &seconds)) {
+      seconds = default_seconds;
+    }
+  }
+  return std::chrono::seconds(seconds);
+}
+
+// The in-process fetcher takes the same flags as the downloader binary. Its
+// blobs live next to, not inside, the binary's own cache layout.
+Result<std::unique_ptr<CasFetcher>> CreateNativeFetcher(
+    const Json::Value& config_flags,
+    const std::string& service_account_filepath) {
+  CasFetcherOptions options;
+  std::string cache_dir = config_flags["cache-dir"].asString();
+  if (!cache_dir.empty()) {
+    options.cache_dir = cache_dir + "/" + kNativeCacheSubdirectory;
+  }
+  options.cache_max_size =
+      config_flags.get("cache-max-size", kMinCacheMaxSize).asInt64();
+  options.use_hardlink = config_flags.get("use-hardlink", true).asBool();
+  options.concurrency =
+      config_flags.get("cas-concurrency", kDefaultCasConcurrency).asInt();
+  options.timeouts = CasClientTimeouts{
+      .rpc = ParseTimeout(config_flags["rpc-timeout"], kDefaultRpcTimeout),
+      .get_tree = ParseTimeout(config_flags["get-tree-timeout"],
+                               kDefaultGetTreeTimeout),
+      .batch_read_blobs = ParseTimeout(config_flags["batch-read-blobs-timeout"],
+                                       kDefaultBatchReadBlobsTimeout),
+  };
+  std::string key_filepath;
+  if (!service_account_filepath.empty() &&
+      FileExists(service_account_filepath)) {
+    key_filepath = service_account_filepath;
+  }
+  return CF_EXPECT(CasFetcher::Create(std::move(options),
+                                      GoogleCasChannelFactory(key_filepath)));
+}
+
+Result<void> WriteFetchStats(const CasFetchStats& stats,
+                             const std::string& filepath) {
+  Json::Value json;
+  json["blobs_downloaded"] = Json::Int64(stats.blobs_downloaded);
+  json["bytes_downloaded"] = Json::Int64(stats.bytes_downloaded);
+  json["blobs_from_cache"] = Json::Int64(stats.blobs_from_cache);
+  json["bytes_from_cache"] = Json::Int64(stats.bytes_from_cache);
+  if (FileExists(filepath)) {
+    CF_EXPECT(RemoveFile(filepath));
+  }
+  CF_EXPECT(WriteNewFile(filepath, json.toStyledString()));
+  return {};
+}
+
 }  // namespace
 
 Result<std::unique_ptr<CasDownloader>> CasDownloader::Create(
@@ -310,6 +374,7 @@ Result<std::unique_ptr<CasDownloader>> CasDownloader::CreateImpl(
   // and reflect any CLI-provided values via .user_provided()).
   std::string downloader_path = cas_downloader_flags.downloader_path.value();
   bool prefer_uncompressed = cas_downloader_flags.prefer_uncompressed.value();
+  bool native_client = cas_downloader_flags.native_client.value();
   std::vector<std::string> cas_flags;
 
   Json::Value config_flags;
@@ -344,6 +409,11 @@ Result<std::unique_ptr<CasDownloader>> CasDownloader::CreateImpl(
         prefer_uncompressed = config["prefer-uncompressed"].asBool();
       }
     }
+    if (!cas_downloader_flags.native_client.user_provided()) {
+      if (config.isMember(kKeyNativeClient)) {
+        native_client = config[kKeyNativeClient].asBool();
+      }
+    }
 
     // For each supported flag key we merge CLI values (if provided) on top of
     // the config file values so CLI wins. Use the same keys as
@@ -379,8 +449,21 @@ Result<std::unique_ptr<CasDownloader>> CasDownloader::CreateImpl(
     cas_flags.push_back("-" + std::string(kFlagUseAdc));
   }
 
+  std::unique_ptr<CasFetcher> native_fetcher;
+  if (native_client) {
+    Result<std::unique_ptr<CasFetcher>> fetcher =
+        CreateNativeFetcher(config_flags, service_account_filepath);
+    if (fetcher.ok()) {
+      native_fetcher = std::move(*fetcher);
+    } else {
+      LOG(WARNING) << "In-process CAS downloading disabled: "
+                   << fetcher.error();
+    }
+  }
+
   return std::unique_ptr<CasDownloader>(
-      new CasDownloader{downloader_path, cas_flags, prefer_uncompressed});
+      new CasDownloader{downloader_path, cas_flags, prefer_uncompressed,
+                        std::move(native_fetcher)});
 }
 
 void AppendBuildInfoToInvocationId(const DeviceBuild& build,
@@ -407,10 +490,12 @@ void AppendBuildInfoToInvocationId(const DeviceBuild& build,
 
 CasDownloader::CasDownloader(std::string downloader_path,
                              std::vector<std::string> flags,
-                             bool prefer_uncompressed)
+                             bool prefer_uncompressed,
+                             std::unique_ptr<CasFetcher> native_fetcher)
     : downloader_path_(std::move(downloader_path)),
       flags_(std::move(flags)),
-      prefer_uncompressed_(prefer_uncompressed) {}
+      prefer_uncompressed_(prefer_uncompressed),
+      native_fetcher_(std::move(native_fetcher)) {}
 
 Result<void> CasDownloader::DownloadFile(
     const DeviceBuild& build, const std::string& artifact_name,
@@ -427,6 +512,26 @@ Result<void> CasDownloader::DownloadFile(
   if (filename.find("_chunked_dir_") == 0) {
     download_directory += "/" + artifact_name;
   }
+  if (native_fetcher_) {
+    Result<CasFetchStats> stats = native_fetcher_->Fetch(
+        cas_identifier.cas_addr, cas_identifier.cas_instance,
+        cas_identifier.digest, download_directory);
+    if (stats.ok() && FileExists(target_directory + "/" + artifact_name)) {
+      VLOG(0) << "Downloaded " << stats->bytes_downloaded << " bytes from CAS, "
+              << stats->bytes_from_cache << " bytes from the local cache";
+      if (stats_filepath.has_value()) {
+        CF_EXPECT(WriteFetchStats(*stats, *stats_filepath));
+      }
+      return {};
+    }
+    if (stats.ok()) {
+      LOG(WARNING) << "'" << artifact_name << "' missing from the CAS tree, "
+                   << "retrying with the CAS downloader binary.";
+    } else {
+      LOG(WARNING) << "In-process CAS download failed, retrying with the CAS "
+                   << "downloader binary: " << stats.error();
+    }
+  }
   AppendBuildInfoToInvocationId(build, flags_);
   Command cmd = GetCommand(downloader_path_, flags_, cas_identifier,
                            download_directory, stats_filepath);
@@ -24,6 +24,7 @@
 #include "json/value.h"
 
 #include "cuttlefish/host/libs/web/android_build.h"
+#include "cuttlefish/host/libs/web/cas/cas_fetcher.h"
 #include "cuttlefish/host/libs/web/cas/cas_flags.h"
 #include "cuttlefish/result/result.h"
 
@@ -31,6 +32,10 @@ namespace cuttlefish {
 
 inline constexpr char kKeyDownloaderPath[] = "downloader-path";
 inline constexpr char kKeyFlags[] = "flags";
+inline constexpr char kKeyNativeClient[] = "native-client";
+
+// Subdirectory of the cache directory holding the in-process fetcher's blobs.
+inline constexpr char kNativeCacheSubdirectory[] = "blobs";
 
 inline constexpr char kFlagDigest[] = "digest";
 inline constexpr char kFlagDir[] = "dir";
@@ -60,7 +65,8 @@ struct CasIdentifier {
 // downloaded file.
 using DigestsFetcher = std::function<Result<std::string>(std::string)>;
 
-// A c++ wrapper for the CAS downloader binary.
+// Downloads artifacts from CAS, in process through CasFetcher when enabled
+// and with the CAS downloader binary otherwise or if that fails.
 // Example:
 //   std::unique_ptr<CasDownloader> casdownloader =
 //       CF_EXPECT(CasDownloader::Create(cas_downloader_flags,
@@ -73,7 +79,8 @@ using DigestsFetcher = std::function<Result<std::string>(std::string)>;
 class CasDownloader {
  public:
   CasDownloader(std::string downloader_path, std::vector<std::string> flags,
-                bool prefer_uncompressed = false);
+                bool prefer_uncompressed = false,
+                std::unique_ptr<CasFetcher> native_fetcher = nullptr);
   static Result<std::unique_ptr<CasDownloader>> Create(
       const CasDownloaderFlags& cas_downloader_flags,
       const std::string& service_account_filepath);
@@ -97,6 +104,7 @@ class CasDownloader {
   std::string downloader_path_;
   std::vector<std::string> flags_;
   bool prefer_uncompressed_;
+  std::unique_ptr<CasFetcher> native_fetcher_;
   std::string build_desc_;  // e.g. "build_id:build_target"
   Json::Value cas_digests_;
 };
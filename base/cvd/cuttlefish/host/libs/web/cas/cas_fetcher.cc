@@ -0,0 +1,440 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/web/cas/cas_fetcher.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "grpcpp/channel.h"
+#include "grpcpp/create_channel.h"
+#include "grpcpp/security/credentials.h"
+#include "grpcpp/support/channel_arguments.h"
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/host/libs/web/cas/cas_blob_cache.h"
+#include "cuttlefish/host/libs/web/cas/cas_client.h"
+#include "cuttlefish/host/libs/web/cas/cas_digest.h"
+#include "cuttlefish/host/libs/web/cas/remote_execution.pb.h"
+#include "cuttlefish/posix/strerror.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+using build::bazel::remote::execution::v2::Directory;
+using build::bazel::remote::execution::v2::DirectoryNode;
+using build::bazel::remote::execution::v2::FileNode;
+using build::bazel::remote::execution::v2::SymlinkNode;
+
+// Servers commonly limit messages to 4 MiB, which bounds batch reads.
+constexpr int64_t kMaxBatchBlobSize = 1 << 20;
+constexpr int64_t kMaxBatchSize = 3 << 20;
+// Smaller files are read whole rather than asking the server for chunks.
+constexpr int64_t kMinSplitSize = 4 << 20;
+// Each thread holds at most one batch in memory.
+constexpr int kMaxThreads = 32;
+
+Result<void> PWriteAll(SharedFD& fd, std::string_view data, int64_t offset) {
+  while (!data.empty()) {
+    ssize_t written = fd->PWrite(data.data(), data.size(), offset);
+    CF_EXPECTF(written > 0, "Write failed: {}", fd->StrError());
+    data.remove_prefix(written);
+    offset += written;
+  }
+  return {};
+}
+
+Result<void> CheckName(std::string_view name) {
+  CF_EXPECTF(!name.empty() && name != "." && name != ".." &&
+                 name.find('/') == std::string_view::npos,
+             "Invalid file name in CAS tree: '{}'", name);
+  return {};
+}
+
+struct Placement {
+  SharedFD fd;
+  int64_t offset;
+};
+
+// A blob that has to be read from the server, and everywhere it goes.
+struct PendingBlob {
+  std::vector<Placement> placements;
+  // Set when the blob is the whole content of a file rather than a chunk, so
+  // the file can be added to the cache as it is.
+  std::string file_path;
+};
+
+// The state of a single Fetch call.
+class TreeDownload {
+ public:
+  TreeDownload(CasClient& client, CasBlobCache* cache)
+      : client_(client), cache_(cache) {}
+
+  Result<void> AddTree(const CasDigest& root,
+                       const std::vector<Directory>& directories,
+                       const std::string& target_directory);
+
+  Result<CasFetchStats> Run(int concurrency);
+
+ private:
+  Result<void> AddFile(const std::string& path, const CasDigest& digest,
+                       bool executable);
+  Result<void> ReadBatch(const std::vector<CasDigest>& digests);
+  Result<void> ReadStream(const CasDigest& digest);
+  Result<void> CopyFromCache(const CasDigest& chunk,
+                             const std::vector<Placement>& placements);
+  Result<void> Deliver(const CasDigest& digest, std::string_view data);
+
+  CasClient& client_;
+  CasBlobCache* cache_;
+  bool split_supported_ = true;
+
+  std::map<CasDigest, PendingBlob> pending_;
+  // Chunks that are in the cache but belong to files that are not.
+  std::map<CasDigest, std::vector<Placement>> cached_chunks_;
+
+  std::atomic<int64_t> blobs_downloaded_ = 0;
+  std::atomic<int64_t> bytes_downloaded_ = 0;
+  std::atomic<int64_t> blobs_from_cache_ = 0;
+  std::atomic<int64_t> bytes_from_cache_ = 0;
+};
+
+Result<void> TreeDownload::AddTree(const CasDigest& root,
+                                   const std::vector<Directory>& directories,
+                                   const std::string& target_directory) {
+  std::map<CasDigest, const Directory*> by_digest;
+  for (const Directory& directory : directories) {
+    by_digest[ComputeCasDigest(directory.SerializeAsString())] = &directory;
+  }
+  std::vector<std::pair<CasDigest, std::string>> stack = {
+      {root, target_directory}};
+  while (!stack.empty()) {
+    auto [digest, path] = std::move(stack.back());
+    stack.pop_back();
+    auto it = by_digest.find(digest);
+    CF_EXPECTF(it != by_digest.end(), "Directory {} missing from the tree",
+               digest.ToString());
+    const Directory& directory = *it->second;
+    CF_EXPECT(EnsureDirectoryExists(path, 0755));
+    for (const FileNode& file : directory.files()) {
+      CF_EXPECT(CheckName(file.name()));
+      CasDigest file_digest{.hash = file.digest().hash(),
+                            .size = file.digest().size_bytes()};
+      CF_EXPECT(AddFile(path + "/" + file.name(), file_digest,
+                        file.is_executable()));
+    }
+    for (const SymlinkNode& symlink : directory.symlinks()) {
+      CF_EXPECT(CheckName(symlink.name()));
+      std::string link_path = path + "/" + symlink.name();
+      unlink(link_path.c_str());
+      CF_EXPECTF(::symlink(symlink.target().c_str(), link_path.c_str()) == 0,
+                 "Failed to create symlink '{}': {}", link_path,
+                 StrError(errno));
+    }
+    for (const DirectoryNode& child : directory.directories()) {
+      CF_EXPECT(CheckName(child.name()));
+      stack.emplace_back(CasDigest{.hash = child.digest().hash(),
+                                   .size = child.digest().size_bytes()},
+                         path + "/" + child.name());
+    }
+  }
+  return {};
+}
+
+Result<void> TreeDownload::AddFile(const std::string& path,
+                                   const CasDigest& digest, bool executable) {
+  mode_t mode = executable ? 0755 : 0644;
+  if (cache_ && digest.size > 0 &&
+      CF_EXPECT(cache_->Materialize(digest, path))) {
+    CF_EXPECTF(chmod(path.c_str(), mode) == 0, "chmod '{}' failed: {}", path,
+               StrError(errno));
+    blobs_from_cache_++;
+    bytes_from_cache_ += digest.size;
+    return {};
+  }
+
+  unlink(path.c_str());  // Don't write through a hard link to the cache.
+  SharedFD fd = SharedFD::Open(path, O_CREAT | O_TRUNC | O_WRONLY, mode);
+  CF_EXPECTF(fd->IsOpen(), "Failed to open '{}': {}", path, fd->StrError());
+  CF_EXPECTF(fd->Chmod(mode), "chmod '{}' failed: {}", path, fd->StrError());
+  if (digest.size == 0) {
+    return {};
+  }
+  CF_EXPECTF(fd->Truncate(digest.size) == 0, "Failed to resize '{}': {}", path,
+             fd->StrError());
+
+  std::optional<std::vector<CasDigest>> chunks;
+  if (split_supported_ && digest.size >= kMinSplitSize &&
+      !pending_.contains(digest)) {
+    chunks = CF_EXPECT(client_.SplitBlob(digest));
+    split_supported_ = chunks.has_value();
+  }
+  if (!chunks) {
+    PendingBlob& blob = pending_[digest];
+    blob.placements.push_back(Placement{fd, 0});
+    if (blob.file_path.empty()) {
+      blob.file_path = path;
+    }
+    return {};
+  }
+  int64_t offset = 0;
+  for (const CasDigest& chunk : *chunks) {
+    if (cache_ && cache_->Find(chunk)) {
+      cached_chunks_[chunk].push_back(Placement{fd, offset});
+    } else {
+      pending_[chunk].placements.push_back(Placement{fd, offset});
+    }
+    offset += chunk.size;
+  }
+  return {};
+}
+
+Result<void> TreeDownload::Deliver(const CasDigest& digest,
+                                   std::string_view data) {
+  const PendingBlob& blob = pending_.at(digest);
+  for (const Placement& placement : blob.placements) {
+    SharedFD fd = placement.fd;
+    CF_EXPECT(PWriteAll(fd, data, placement.offset));
+  }
+  blobs_downloaded_++;
+  bytes_downloaded_ += digest.size;
+  if (cache_) {
+    CF_EXPECT(cache_->Add(digest, data));
+  }
+  return {};
+}
+
+Result<void> TreeDownload::ReadBatch(const std::vector<CasDigest>& digests) {
+  std::vector<std::string> blobs = CF_EXPECT(client_.BatchReadBlobs(digests));
+  for (size_t i = 0; i < digests.size(); i++) {
+    CF_EXPECT(Deliver(digests[i], blobs[i]));
+  }
+  return {};
+}
+
+Result<void> TreeDownload::ReadStream(const CasDigest& digest) {
+  const PendingBlob& blob = pending_.at(digest);
+  if (!blob.file_path.empty()) {
+    // Whole files are written to their place only, and the file is added to
+    // the cache once complete.
+    int64_t written = 0;
+    CF_EXPECT(client_.ReadBlob(
+        digest, [&blob, &written](std::string_view data) -> Result<void> {
+          for (const Placement& placement : blob.placements) {
+            SharedFD fd = placement.fd;
+            CF_EXPECT(PWriteAll(fd, data, placement.offset + written));
+          }
+          written += data.size();
+          return {};
+        }));
+    blobs_downloaded_++;
+    bytes_downloaded_ += digest.size;
+    if (cache_) {
+      CF_EXPECT(cache_->AddFile(digest, blob.file_path));
+    }
+    return {};
+  }
+  // Chunks are bounded by the server's chunking, so buffering is fine.
+  std::string data;
+  data.reserve(digest.size);
+  CF_EXPECT(client_.ReadBlob(digest, [&data](std::string_view piece) {
+    data.append(piece);
+    return Result<void>{};
+  }));
+  CF_EXPECT(Deliver(digest, data));
+  return {};
+}
+
+Result<void> TreeDownload::CopyFromCache(
+    const CasDigest& chunk, const std::vector<Placement>& placements) {
+  std::optional<std::string> path = cache_->Find(chunk);
+  CF_EXPECTF(path.has_value(), "Chunk {} was removed from the cache",
+             chunk.ToString());
+  std::string data = CF_EXPECT(ReadFileContents(*path));
+  CF_EXPECTF(static_cast<int64_t>(data.size()) == chunk.size,
+             "Cached chunk {} is truncated", chunk.ToString());
+  for (const Placement& placement : placements) {
+    SharedFD fd = placement.fd;
+    CF_EXPECT(PWriteAll(fd, data, placement.offset));
+  }
+  blobs_from_cache_++;
+  bytes_from_cache_ += chunk.size;
+  return {};
+}
+
+Result<CasFetchStats> TreeDownload::Run(int concurrency) {
+  // Large reads go first so they overlap with everything else.
+  std::vector<std::pair<int64_t, std::function<Result<void>()>>> tasks;
+  std::vector<CasDigest> batch;
+  int64_t batch_size = 0;
+  auto flush_batch = [this, &tasks, &batch, &batch_size]() {
+    if (!batch.empty()) {
+      tasks.emplace_back(batch_size, [this, batch = std::move(batch)]() {
+        return ReadBatch(batch);
+      });
+    }
+    batch.clear();
+    batch_size = 0;
+  };
+  for (const auto& [digest, blob] : pending_) {
+    if (digest.size > kMaxBatchBlobSize) {
+      tasks.emplace_back(digest.size, [this, &digest]() {
+        return ReadStream(digest);
+      });
+      continue;
+    }
+    if (batch_size + digest.size > kMaxBatchSize) {
+      flush_batch();
+    }
+    batch.push_back(digest);
+    batch_size += digest.size;
+  }
+  flush_batch();
+  for (const auto& [chunk, placements] : cached_chunks_) {
+    tasks.emplace_back(0, [this, &chunk, &placements]() {
+      return CopyFromCache(chunk, placements);
+    });
+  }
+  std::stable_sort(tasks.begin(), tasks.end(),
+                   [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  std::atomic<size_t> next_task = 0;
+  std::mutex error_mutex;
+  std::optional<Result<void>> error;
+  auto worker = [&]() {
+    for (size_t i = next_task++; i < tasks.size(); i = next_task++) {
+      Result<void> result = tasks[i].second();
+      if (!result.ok()) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::move(result);
+        }
+        next_task = tasks.size();  // Abandon the remaining tasks.
+      }
+    }
+  };
+  int num_threads = std::clamp<int>(concurrency, 1, kMaxThreads);
+  num_threads = std::min<int>(num_threads, tasks.size());
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back(worker);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    CF_EXPECT(std::move(*error));
+  }
+  return CasFetchStats{
+      .blobs_downloaded = blobs_downloaded_,
+      .bytes_downloaded = bytes_downloaded_,
+      .blobs_from_cache = blobs_from_cache_,
+      .bytes_from_cache = bytes_from_cache_,
+  };
+}
+
+}  // namespace
+
+CasChannelFactory GoogleCasChannelFactory(
+    std::string service_account_filepath) {
+  return [service_account_filepath = std::move(service_account_filepath)](
+             const std::string& address)
+             -> Result<std::shared_ptr<grpc::Channel>> {
+    std::shared_ptr<grpc::ChannelCredentials> credentials;
+    if (service_account_filepath.empty()) {
+      credentials = grpc::GoogleDefaultCredentials();
+    } else {
+      std::string key = CF_EXPECT(ReadFileContents(service_account_filepath));
+      credentials = grpc::CompositeChannelCredentials(
+          grpc::SslCredentials(grpc::SslCredentialsOptions()),
+          grpc::ServiceAccountJWTAccessCredentials(key));
+    }
+    CF_EXPECT(credentials != nullptr, "No credentials available for CAS");
+    grpc::ChannelArguments arguments;
+    arguments.SetMaxReceiveMessageSize(kMaxBatchSize + (1 << 20));
+    return grpc::CreateCustomChannel(address, credentials, arguments);
+  };
+}
+
+Result<std::unique_ptr<CasFetcher>> CasFetcher::Create(
+    CasFetcherOptions options, CasChannelFactory channel_factory) {
+  std::unique_ptr<CasBlobCache> cache;
+  if (!options.cache_dir.empty()) {
+    cache = CF_EXPECT(CasBlobCache::Create(
+        options.cache_dir, options.cache_max_size, options.use_hardlink));
+  }
+  return std::unique_ptr<CasFetcher>(new CasFetcher(
+      std::move(options), std::move(channel_factory), std::move(cache)));
+}
+
+CasFetcher::CasFetcher(CasFetcherOptions options,
+                       CasChannelFactory channel_factory,
+                       std::unique_ptr<CasBlobCache> cache)
+    : options_(std::move(options)),
+      channel_factory_(std::move(channel_factory)),
+      cache_(std::move(cache)) {}
+
+Result<CasClient*> CasFetcher::Client(const std::string& cas_addr,
+                                      const std::string& cas_instance) {
+  std::lock_guard<std::mutex> lock(clients_mutex_);
+  std::unique_ptr<CasClient>& client = clients_[{cas_addr, cas_instance}];
+  if (!client) {
+    std::shared_ptr<grpc::Channel> channel =
+        CF_EXPECT(channel_factory_(cas_addr));
+    client = std::make_unique<CasClient>(std::move(channel), cas_instance,
+                                         options_.timeouts);
+  }
+  return client.get();
+}
+
+Result<CasFetchStats> CasFetcher::Fetch(const std::string& cas_addr,
+                                        const std::string& cas_instance,
+                                        const std::string& digest,
+                                        const std::string& target_directory) {
+  CasDigest root = CF_EXPECT(ParseCasDigest(digest));
+  CasClient* client = CF_EXPECT(Client(cas_addr, cas_instance));
+  std::vector<Directory> directories = CF_EXPECT(client->GetTree(root));
+
+  TreeDownload download(*client, cache_.get());
+  CF_EXPECT(download.AddTree(root, directories, target_directory));
+  CasFetchStats stats = CF_EXPECT(download.Run(options_.concurrency));
+
+  if (cache_) {
+    if (Result<void> trimmed = cache_->Trim(); !trimmed.ok()) {
+      LOG(WARNING) << "Failed to trim the CAS cache: " << trimmed.error();
+    }
+  }
+  return stats;
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,95 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "grpcpp/channel.h"
+
+#include "cuttlefish/host/libs/web/cas/cas_blob_cache.h"
+#include "cuttlefish/host/libs/web/cas/cas_client.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+struct CasFetcherOptions {
+  // Where blobs are kept between downloads. Nothing is kept if empty.
+  std::string cache_dir;
+  int64_t cache_max_size = 0;
+  bool use_hardlink = true;
+  // The number of blob reads in flight at once.
+  int concurrency = 16;
+  CasClientTimeouts timeouts;
+};
+
+struct CasFetchStats {
+  int64_t blobs_downloaded = 0;
+  int64_t bytes_downloaded = 0;
+  int64_t blobs_from_cache = 0;
+  int64_t bytes_from_cache = 0;
+};
+
+using CasChannelFactory =
+    std::function<Result<std::shared_ptr<grpc::Channel>>(const std::string&)>;
+
+// Connects with the key of the service account at `service_account_filepath`,
+// or with the application default credentials if it is empty.
+CasChannelFactory GoogleCasChannelFactory(std::string service_account_filepath);
+
+// Downloads directory trees from CAS in process, as an alternative to the
+// casdownloader binary.
+//
+// Blobs missing from the local cache are read concurrently, small ones in
+// batches and large ones streamed, and written straight to their place in the
+// target files. When the server can split large blobs into chunks, files are
+// assembled from chunks so that a file that changed between builds only
+// downloads the chunks that are not already in the cache.
+class CasFetcher {
+ public:
+  static Result<std::unique_ptr<CasFetcher>> Create(
+      CasFetcherOptions options, CasChannelFactory channel_factory);
+
+  // Downloads the tree with root directory `digest` ("<hash>/<size>") into
+  // `target_directory`.
+  Result<CasFetchStats> Fetch(const std::string& cas_addr,
+                              const std::string& cas_instance,
+                              const std::string& digest,
+                              const std::string& target_directory);
+
+ private:
+  CasFetcher(CasFetcherOptions options, CasChannelFactory channel_factory,
+             std::unique_ptr<CasBlobCache> cache);
+
+  Result<CasClient*> Client(const std::string& cas_addr,
+                            const std::string& cas_instance);
+
+  const CasFetcherOptions options_;
+  const CasChannelFactory channel_factory_;
+  std::unique_ptr<CasBlobCache> cache_;
+
+  std::mutex clients_mutex_;
+  std::map<std::pair<std::string, std::string>, std::unique_ptr<CasClient>>
+      clients_;
+};
+
+}  // namespace cuttlefish
@@ -0,0 +1,224 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/web/cas/cas_fetcher.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "android-base/file.h"
+#include "grpcpp/create_channel.h"
+#include "grpcpp/security/credentials.h"
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/utils/files.h"
+#include "cuttlefish/host/libs/web/cas/cas_digest.h"
+#include "cuttlefish/host/libs/web/cas/fake_cas_server.h"
+#include "cuttlefish/host/libs/web/cas/remote_execution.pb.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+using build::bazel::remote::execution::v2::Directory;
+using build::bazel::remote::execution::v2::DirectoryNode;
+using build::bazel::remote::execution::v2::FileNode;
+
+constexpr size_t kChunkSize = 1024 * 1024;
+
+// Every chunk of the result is different.
+std::string Pattern(size_t size, char seed) {
+  std::string data(size, '\0');
+  for (size_t i = 0; i < size; i++) {
+    data[i] = static_cast<char>(seed + i * 7 + i / kChunkSize);
+  }
+  return data;
+}
+
+void AddFile(Directory& directory, const std::string& name,
+             const CasDigest& digest, bool executable = false) {
+  FileNode* file = directory.add_files();
+  file->set_name(name);
+  file->mutable_digest()->set_hash(digest.hash);
+  file->mutable_digest()->set_size_bytes(digest.size);
+  file->set_is_executable(executable);
+}
+
+class CasFetcherTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    Result<std::unique_ptr<FakeCasServer>> server = FakeCasServer::Start();
+    ASSERT_THAT(server, IsOk());
+    server_ = std::move(*server);
+  }
+
+  std::unique_ptr<CasFetcher> Fetcher(bool with_cache = true) {
+    CasFetcherOptions options;
+    if (with_cache) {
+      options.cache_dir = std::string(temp_dir_.path) + "/cache";
+    }
+    Result<std::unique_ptr<CasFetcher>> fetcher = CasFetcher::Create(
+        options,
+        [](const std::string& address)
+            -> Result<std::shared_ptr<grpc::Channel>> {
+          return grpc::CreateChannel(address,
+                                     grpc::InsecureChannelCredentials());
+        });
+    EXPECT_THAT(fetcher, IsOk());
+    return fetcher.ok() ? std::move(*fetcher) : nullptr;
+  }
+
+  // Returns the root digest of a tree with `image` in a subdirectory.
+  std::string ImageTree(const CasDigest& image) {
+    Directory images;
+    AddFile(images, "super.img", image);
+    CasDigest images_digest = server_->AddDirectory(images);
+    Directory root;
+    DirectoryNode* child = root.add_directories();
+    child->set_name("images");
+    child->mutable_digest()->set_hash(images_digest.hash);
+    child->mutable_digest()->set_size_bytes(images_digest.size);
+    return server_->AddDirectory(root).ToString();
+  }
+
+  Result<CasFetchStats> Fetch(CasFetcher& fetcher, const std::string& digest,
+                              const std::string& directory) {
+    return fetcher.Fetch(server_->Address(), "instance", digest,
+                         std::string(temp_dir_.path) + "/" + directory);
+  }
+
+  std::string Contents(const std::string& path) {
+    return ReadFile(std::string(temp_dir_.path) + "/" + path);
+  }
+
+  TemporaryDir temp_dir_;
+  std::unique_ptr<FakeCasServer> server_;
+};
+
+TEST_F(CasFetcherTest, DownloadsTree) {
+  std::string small = "small file";
+  std::string large = Pattern(3 * kChunkSize + 5, 'a');
+  Directory bin;
+  AddFile(bin, "tool", server_->AddBlob(small), /* executable= */ true);
+  CasDigest bin_digest = server_->AddDirectory(bin);
+  Directory root;
+  AddFile(root, "large.img", server_->AddBlob(large));
+  AddFile(root, "copy.img", ComputeCasDigest(large));
+  AddFile(root, "empty", ComputeCasDigest(""));
+  DirectoryNode* child = root.add_directories();
+  child->set_name("bin");
+  child->mutable_digest()->set_hash(bin_digest.hash);
+  child->mutable_digest()->set_size_bytes(bin_digest.size);
+  auto* symlink = root.add_symlinks();
+  symlink->set_name("link");
+  symlink->set_target("bin/tool");
+  std::string root_digest = server_->AddDirectory(root).ToString();
+
+  std::unique_ptr<CasFetcher> fetcher = Fetcher(/* with_cache= */ false);
+  Result<CasFetchStats> stats = Fetch(*fetcher, root_digest, "out");
+
+  ASSERT_THAT(stats, IsOk());
+  EXPECT_EQ(Contents("out/bin/tool"), small);
+  EXPECT_EQ(Contents("out/large.img"), large);
+  EXPECT_EQ(Contents("out/copy.img"), large);
+  EXPECT_EQ(Contents("out/empty"), "");
+  EXPECT_EQ(Contents("out/link"), small);
+  EXPECT_EQ(access((std::string(temp_dir_.path) + "/out/bin/tool").c_str(),
+                   X_OK),
+            0);
+  // The large blob is read once for both files.
+  EXPECT_EQ(server_->BytesServed(), large.size() + small.size());
+  EXPECT_EQ(stats->blobs_downloaded, 2);
+}
+
+TEST_F(CasFetcherTest, SecondFetchComesFromCache) {
+  std::string image = Pattern(5 * kChunkSize, 'b');
+  std::string root = ImageTree(server_->AddChunkedBlob(image, kChunkSize));
+  std::unique_ptr<CasFetcher> fetcher = Fetcher();
+
+  ASSERT_THAT(Fetch(*fetcher, root, "first"), IsOk());
+  int64_t served = server_->BytesServed();
+  Result<CasFetchStats> stats = Fetch(*Fetcher(), root, "second");
+
+  ASSERT_THAT(stats, IsOk());
+  EXPECT_EQ(Contents("second/images/super.img"), image);
+  EXPECT_EQ(server_->BytesServed(), served);
+  EXPECT_EQ(stats->bytes_downloaded, 0);
+  EXPECT_EQ(stats->bytes_from_cache, image.size());
+}
+
+TEST_F(CasFetcherTest, ChangedFileOnlyDownloadsNewChunks) {
+  std::string old_image = Pattern(6 * kChunkSize, 'c');
+  std::string new_image = old_image;
+  new_image[2 * kChunkSize + 10] ^= 0xff;
+  std::string old_root =
+      ImageTree(server_->AddChunkedBlob(old_image, kChunkSize));
+  std::string new_root =
+      ImageTree(server_->AddChunkedBlob(new_image, kChunkSize));
+  std::unique_ptr<CasFetcher> fetcher = Fetcher();
+
+  ASSERT_THAT(Fetch(*fetcher, old_root, "old"), IsOk());
+  int64_t served = server_->BytesServed();
+  Result<CasFetchStats> stats = Fetch(*fetcher, new_root, "new");
+
+  ASSERT_THAT(stats, IsOk());
+  EXPECT_EQ(Contents("new/images/super.img"), new_image);
+  EXPECT_EQ(server_->BytesServed() - served, kChunkSize);
+  EXPECT_EQ(stats->blobs_downloaded, 1);
+  EXPECT_EQ(stats->blobs_from_cache, 5);
+}
+
+TEST_F(CasFetcherTest, ReadsWholeFilesWithoutSplitBlob) {
+  server_->DisableSplitBlob();
+  std::string image = Pattern(6 * kChunkSize, 'd');
+  std::string root = ImageTree(server_->AddChunkedBlob(image, kChunkSize));
+  std::unique_ptr<CasFetcher> fetcher = Fetcher();
+
+  Result<CasFetchStats> stats = Fetch(*fetcher, root, "out");
+
+  ASSERT_THAT(stats, IsOk());
+  EXPECT_EQ(Contents("out/images/super.img"), image);
+  EXPECT_EQ(stats->blobs_downloaded, 1);
+}
+
+TEST_F(CasFetcherTest, RejectsCorruptBlob) {
+  std::string data = "expected";
+  CasDigest digest = ComputeCasDigest(data);
+  server_->AddCorruptBlob(digest, "received");
+  Directory root;
+  AddFile(root, "file", digest);
+  std::string root_digest = server_->AddDirectory(root).ToString();
+
+  std::unique_ptr<CasFetcher> fetcher = Fetcher();
+
+  EXPECT_THAT(Fetch(*fetcher, root_digest, "out"), IsError());
+}
+
+TEST_F(CasFetcherTest, RejectsPathsOutsideTarget) {
+  Directory root;
+  AddFile(root, "../escape", server_->AddBlob("data"));
+  std::string root_digest = server_->AddDirectory(root).ToString();
+
+  std::unique_ptr<CasFetcher> fetcher = Fetcher();
+
+  EXPECT_THAT(Fetch(*fetcher, root_digest, "out"), IsError());
+}
+
+}  // namespace
+}  // namespace cuttlefish
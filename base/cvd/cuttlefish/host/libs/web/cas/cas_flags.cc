@@ -44,6 +44,7 @@ CasDownloaderFlags::CasDownloaderFlags()
     : cas_config_filepath(GetDefaultCasConfigFilePath()),
       downloader_path(GetDefaultDownloaderPath()),
       prefer_uncompressed(false),
+      native_client(true),
       cache_dir(""),
       invocation_id(""),
       cache_max_size(kMinCacheMaxSize),
@@ -70,6 +71,10 @@ std::vector<Flag> CasDownloaderFlags::Flags() {
   flags.emplace_back(
       prefer_uncompressed.Flag("cas_prefer_uncompressed")
           .Help("Download uncompressed artifacts if available."));
+  flags.emplace_back(
+      native_client.Flag("cas_native_client")
+          .Help("Download from CAS in process, falling back to the CAS "
+                "downloader binary on failure."));
   flags.emplace_back(
       cache_dir.Flag("cas_cache_dir")
           .Help("Cache directory to store downloaded files (casdownloader "
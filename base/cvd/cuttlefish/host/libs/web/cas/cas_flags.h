@@ -73,6 +73,7 @@ struct CasDownloaderFlags {
   FlagValue<std::string> cas_config_filepath;
   FlagValue<std::string> downloader_path;
   FlagValue<bool> prefer_uncompressed;
+  FlagValue<bool> native_client;
   FlagValue<std::string> cache_dir;
   FlagValue<std::string> invocation_id;
   FlagValue<int64_t> cache_max_size;
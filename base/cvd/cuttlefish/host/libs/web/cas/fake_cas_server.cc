@@ -0,0 +1,228 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/web/cas/fake_cas_server.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fmt/format.h"
+#include "google/bytestream/bytestream.grpc.pb.h"
+#include "grpcpp/security/server_credentials.h"
+#include "grpcpp/server_builder.h"
+
+#include "cuttlefish/host/libs/web/cas/cas_digest.h"
+#include "cuttlefish/host/libs/web/cas/remote_execution.grpc.pb.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+using build::bazel::remote::execution::v2::BatchReadBlobsRequest;
+using build::bazel::remote::execution::v2::BatchReadBlobsResponse;
+using build::bazel::remote::execution::v2::Digest;
+using build::bazel::remote::execution::v2::Directory;
+using build::bazel::remote::execution::v2::DirectoryNode;
+using build::bazel::remote::execution::v2::GetTreeRequest;
+using build::bazel::remote::execution::v2::GetTreeResponse;
+using build::bazel::remote::execution::v2::SplitBlobRequest;
+using build::bazel::remote::execution::v2::SplitBlobResponse;
+using google::bytestream::ReadRequest;
+using google::bytestream::ReadResponse;
+
+constexpr size_t kReadResponseSize = 64 * 1024;
+
+CasDigest FromProto(const Digest& digest) {
+  return CasDigest{.hash = digest.hash(), .size = digest.size_bytes()};
+}
+
+void SetDigest(const CasDigest& from, Digest* to) {
+  to->set_hash(from.hash);
+  to->set_size_bytes(from.size);
+}
+
+}  // namespace
+
+Result<std::unique_ptr<FakeCasServer>> FakeCasServer::Start() {
+  std::unique_ptr<FakeCasServer> fake(new FakeCasServer());
+  grpc::ServerBuilder builder;
+  builder.AddListeningPort("localhost:0", grpc::InsecureServerCredentials(),
+                           &fake->port_);
+  builder.RegisterService(
+      static_cast<
+          build::bazel::remote::execution::v2::ContentAddressableStorage::
+              Service*>(fake.get()));
+  builder.RegisterService(
+      static_cast<google::bytestream::ByteStream::Service*>(fake.get()));
+  fake->server_ = builder.BuildAndStart();
+  CF_EXPECT(fake->server_ != nullptr, "Failed to start the fake CAS server");
+  return fake;
+}
+
+FakeCasServer::~FakeCasServer() {
+  if (server_) {
+    server_->Shutdown();
+  }
+}
+
+std::string FakeCasServer::Address() const {
+  return fmt::format("localhost:{}", port_);
+}
+
+CasDigest FakeCasServer::AddBlob(const std::string& data) {
+  CasDigest digest = ComputeCasDigest(data);
+  std::lock_guard<std::mutex> lock(mutex_);
+  blobs_[digest] = data;
+  return digest;
+}
+
+CasDigest FakeCasServer::AddChunkedBlob(const std::string& data,
+                                        size_t chunk_size) {
+  std::vector<CasDigest> chunks;
+  for (size_t offset = 0; offset < data.size(); offset += chunk_size) {
+    chunks.push_back(AddBlob(data.substr(offset, chunk_size)));
+  }
+  CasDigest digest = AddBlob(data);
+  std::lock_guard<std::mutex> lock(mutex_);
+  chunks_[digest] = std::move(chunks);
+  return digest;
+}
+
+CasDigest FakeCasServer::AddDirectory(const Directory& directory) {
+  CasDigest digest = AddBlob(directory.SerializeAsString());
+  std::lock_guard<std::mutex> lock(mutex_);
+  directories_[digest] = directory;
+  return digest;
+}
+
+void FakeCasServer::AddCorruptBlob(const CasDigest& digest,
+                                   const std::string& data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  blobs_[digest] = data;
+}
+
+void FakeCasServer::DisableSplitBlob() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  split_blob_enabled_ = false;
+}
+
+int64_t FakeCasServer::BytesServed() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_served_;
+}
+
+grpc::Status FakeCasServer::BatchReadBlobs(grpc::ServerContext*,
+                                           const BatchReadBlobsRequest* request,
+                                           BatchReadBlobsResponse* response) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const Digest& digest : request->digests()) {
+    auto* blob = response->add_responses();
+    *blob->mutable_digest() = digest;
+    auto it = blobs_.find(FromProto(digest));
+    if (it == blobs_.end()) {
+      blob->mutable_status()->set_code(grpc::StatusCode::NOT_FOUND);
+      continue;
+    }
+    blob->set_data(it->second);
+    bytes_served_ += it->second.size();
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status FakeCasServer::GetTree(
+    grpc::ServerContext*, const GetTreeRequest* request,
+    grpc::ServerWriter<GetTreeResponse>* writer) {
+  GetTreeResponse response;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<CasDigest> queue = {FromProto(request->root_digest())};
+    while (!queue.empty()) {
+      CasDigest digest = queue.back();
+      queue.pop_back();
+      auto it = directories_.find(digest);
+      if (it == directories_.end()) {
+        return grpc::Status(grpc::StatusCode::NOT_FOUND, digest.ToString());
+      }
+      *response.add_directories() = it->second;
+      for (const DirectoryNode& child : it->second.directories()) {
+        queue.push_back(FromProto(child.digest()));
+      }
+    }
+  }
+  writer->Write(response);
+  return grpc::Status::OK;
+}
+
+grpc::Status FakeCasServer::SplitBlob(grpc::ServerContext*,
+                                      const SplitBlobRequest* request,
+                                      SplitBlobResponse* response) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!split_blob_enabled_) {
+    return grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "SplitBlob");
+  }
+  CasDigest digest = FromProto(request->blob_digest());
+  auto it = chunks_.find(digest);
+  if (it != chunks_.end()) {
+    for (const CasDigest& chunk : it->second) {
+      SetDigest(chunk, response->add_chunk_digests());
+    }
+  } else if (blobs_.contains(digest)) {
+    SetDigest(digest, response->add_chunk_digests());
+  } else {
+    return grpc::Status(grpc::StatusCode::NOT_FOUND, digest.ToString());
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status FakeCasServer::Read(grpc::ServerContext*,
+                                 const ReadRequest* request,
+                                 grpc::ServerWriter<ReadResponse>* writer) {
+  std::string_view name = request->resource_name();
+  size_t blobs = name.find("blobs/");
+  if (blobs == std::string_view::npos) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, std::string(name));
+  }
+  Result<CasDigest> digest = ParseCasDigest(name.substr(blobs + 6));
+  if (!digest.ok()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, std::string(name));
+  }
+  std::string data;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = blobs_.find(*digest);
+    if (it == blobs_.end()) {
+      return grpc::Status(grpc::StatusCode::NOT_FOUND, std::string(name));
+    }
+    data = it->second;
+    bytes_served_ += data.size();
+  }
+  for (size_t offset = 0; offset < data.size(); offset += kReadResponseSize) {
+    ReadResponse response;
+    response.set_data(data.substr(offset, kReadResponseSize));
+    if (!writer->Write(response)) {
+      break;
+    }
+  }
+  return grpc::Status::OK;
+}
+
+}  // namespace cuttlefish
@@ -0,0 +1,96 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "google/bytestream/bytestream.grpc.pb.h"
+#include "grpcpp/server.h"
+
+#include "cuttlefish/host/libs/web/cas/cas_digest.h"
+#include "cuttlefish/host/libs/web/cas/remote_execution.grpc.pb.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+// An in-process CAS server on a loopback port, serving the blobs added to it
+// through the same services a remote CAS uses.
+class FakeCasServer
+    : public build::bazel::remote::execution::v2::ContentAddressableStorage::
+          Service,
+      public google::bytestream::ByteStream::Service {
+ public:
+  static Result<std::unique_ptr<FakeCasServer>> Start();
+  ~FakeCasServer() override;
+
+  std::string Address() const;
+
+  CasDigest AddBlob(const std::string& data);
+  // The blob is also reported by SplitBlob as chunks of `chunk_size` bytes.
+  CasDigest AddChunkedBlob(const std::string& data, size_t chunk_size);
+  CasDigest AddDirectory(
+      const build::bazel::remote::execution::v2::Directory& directory);
+  // Serves `data` for `digest` even though they do not match.
+  void AddCorruptBlob(const CasDigest& digest, const std::string& data);
+  // Makes SplitBlob fail as it does on servers that don't implement it.
+  void DisableSplitBlob();
+
+  // Blob content bytes sent, excluding directories sent by GetTree.
+  int64_t BytesServed();
+
+  grpc::Status BatchReadBlobs(
+      grpc::ServerContext* context,
+      const build::bazel::remote::execution::v2::BatchReadBlobsRequest* request,
+      build::bazel::remote::execution::v2::BatchReadBlobsResponse* response)
+      override;
+  grpc::Status GetTree(
+      grpc::ServerContext* context,
+      const build::bazel::remote::execution::v2::GetTreeRequest* request,
+      grpc::ServerWriter<build::bazel::remote::execution::v2::GetTreeResponse>*
+          writer) override;
+  grpc::Status SplitBlob(
+      grpc::ServerContext* context,
+      const build::bazel::remote::execution::v2::SplitBlobRequest* request,
+      build::bazel::remote::execution::v2::SplitBlobResponse* response)
+      override;
+  grpc::Status Read(
+      grpc::ServerContext* context,
+      const google::bytestream::ReadRequest* request,
+      grpc::ServerWriter<google::bytestream::ReadResponse>* writer) override;
+
+ private:
+  FakeCasServer() = default;
+
+  std::unique_ptr<grpc::Server> server_;
+  int port_ = 0;
+
+  std::mutex mutex_;
+  std::map<CasDigest, std::string> blobs_;
+  std::map<CasDigest, std::vector<CasDigest>> chunks_;
+  std::map<CasDigest, build::bazel::remote::execution::v2::Directory>
+      directories_;
+  bool split_blob_enabled_ = true;
+  int64_t bytes_served_ = 0;
+};
+
+}  // namespace cuttlefish
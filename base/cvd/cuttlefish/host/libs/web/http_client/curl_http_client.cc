@@ -17,11 +17,17 @@
 
 #include <stdio.h>
 
+#include <array>
+#include <deque>
 #include <functional>
+#include <future>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -30,6 +36,8 @@
 #include "curl/curl.h"
 #include "curl/easy.h"
 #include "curl/header.h"
+#include "curl/multi.h"
+#include "curl/urlapi.h"
 
 #include "cuttlefish/host/libs/web/http_client/http_client.h"
 #include "cuttlefish/host/libs/web/http_client/scrub_secrets.h"
@@ -101,6 +109,72 @@ Result<ManagedCurlSlist> SlistFromStrings(
   return curl_headers;
 }
 
+// Configures `curl` for `request`. The other arguments have to outlive the
+// transfer.
+void SetupTransfer(CURL* curl, const HttpRequest& request,
+                   curl_slist* headers, HttpClient::DataCallback* callback,
+                   char* error_buf, bool verbose) {
+  switch (request.method) {
+    case HttpMethod::kDelete:
+      curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
+      break;
+    case HttpMethod::kPost:
+      curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE,
+                       request.data_to_write.size());
+      curl_easy_setopt(curl, CURLOPT_POSTFIELDS,
+                       request.data_to_write.c_str());
+      break;
+    case HttpMethod::kHead:
+      curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+      break;
+    default:
+      break;
+  }
+  curl_easy_setopt(curl, CURLOPT_CAINFO, "/etc/ssl/certs/ca-certificates.crt");
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_to_function_cb);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, callback);
+  error_buf[0] = '\0';
+  curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, error_buf);
+  if (verbose) {
+    // CURLOPT_VERBOSE must be set for CURLOPT_DEBUGFUNCTION be utilized
+    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
+    curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, LoggingCurlDebugFunction);
+  }
+}
+
+Result<HttpResponse<void>> TransferResponse(CURL* curl, CURLcode res,
+                                            const char* error_buf) {
+  CF_EXPECT(res == CURLE_OK,
+            "curl transfer failed. "
+                << "Code was \"" << res << "\". "
+                << "Strerror was \"" << curl_easy_strerror(res) << "\". "
+                << "Error buffer was \"" << error_buf << "\".");
+  long http_code = 0;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+  std::vector<HttpHeader> headers;
+  curl_header* raw_header = nullptr;
+  while ((raw_header = curl_easy_nextheader(curl, CURLH_HEADER, 0,
+                                            raw_header)) != nullptr) {
+    headers.emplace_back(HttpHeader{
+        .name = raw_header->name,
+        .value = raw_header->value,
+    });
+  }
+
+  return HttpResponse<void>{
+      .data = {}, .http_code = http_code, .headers = std::move(headers)};
+}
+
+Result<void> CheckRequest(const HttpRequest& request) {
+  CF_EXPECT(
+      request.data_to_write.empty() || request.method == HttpMethod::kPost,
+      "data must be empty for non POST requests");
+  return {};
+}
+
 class CurlClient : public HttpClient {
  public:
   CurlClient(const bool use_logging_debug_function)
@@ -117,65 +191,18 @@ class CurlClient : public HttpClient {
       HttpRequest request, DataCallback callback) override {
     std::lock_guard<std::mutex> lock(mutex_);
     VLOG(0) << "Downloading '" << request.url << "'";
-    CF_EXPECT(
-        request.data_to_write.empty() || request.method == HttpMethod::kPost,
-        "data must be empty for non POST requests");
+    CF_EXPECT(CheckRequest(request));
     CF_EXPECT(curl_ != nullptr, "curl was not initialized");
     CF_EXPECT(callback(nullptr, 0) /* Signal start of data */,
               "callback failure");
     auto curl_headers = CF_EXPECT(SlistFromStrings(request.headers));
 
     curl_easy_reset(curl_);
-    switch (request.method) {
-      case HttpMethod::kDelete:
-        curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, "DELETE");
-        break;
-      case HttpMethod::kPost:
-        curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE,
-                         request.data_to_write.size());
-        curl_easy_setopt(curl_, CURLOPT_POSTFIELDS,
-                         request.data_to_write.c_str());
-        break;
-      case HttpMethod::kHead:
-        curl_easy_setopt(curl_, CURLOPT_NOBODY, 1L);
-        break;
-      default:
-        break;
-    }
-    curl_easy_setopt(curl_, CURLOPT_CAINFO,
-                     "/etc/ssl/certs/ca-certificates.crt");
-    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, curl_headers.get());
-    curl_easy_setopt(curl_, CURLOPT_URL, request.url.c_str());
-    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, curl_to_function_cb);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &callback);
     char error_buf[CURL_ERROR_SIZE];
-    curl_easy_setopt(curl_, CURLOPT_ERRORBUFFER, error_buf);
-    curl_easy_setopt(curl_, CURLOPT_VERBOSE, 1L);
-    // CURLOPT_VERBOSE must be set for CURLOPT_DEBUGFUNCTION be utilized
-    if (use_logging_debug_function_) {
-      curl_easy_setopt(curl_, CURLOPT_DEBUGFUNCTION, LoggingCurlDebugFunction);
-    }
+    SetupTransfer(curl_, request, curl_headers.get(), &callback, error_buf,
+                  use_logging_debug_function_);
     CURLcode res = curl_easy_perform(curl_);
-    CF_EXPECT(res == CURLE_OK,
-              "curl_easy_perform() failed. "
-                  << "Code was \"" << res << "\". "
-                  << "Strerror was \"" << curl_easy_strerror(res) << "\". "
-                  << "Error buffer was \"" << error_buf << "\".");
-    long http_code = 0;
-    curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &http_code);
-
-    std::vector<HttpHeader> headers;
-    curl_header* raw_header = nullptr;
-    while ((raw_header = curl_easy_nextheader(curl_, CURLH_HEADER, 0,
-                                              raw_header)) != nullptr) {
-      headers.emplace_back(HttpHeader{
-          .name = raw_header->name,
-          .value = raw_header->value,
-      });
-    }
-
-    return HttpResponse<void>{
-        .data = {}, .http_code = http_code, .headers = std::move(headers)};
+    return CF_EXPECT(TransferResponse(curl_, res, error_buf));
   }
 
  private:
@@ -184,10 +211,238 @@ class CurlClient : public HttpClient {
   bool use_logging_debug_function_;
 };
 
+// Runs all transfers on one multi handle from a dedicated thread. Callers
+// block in DownloadToCallback as with CurlClient, but their transfers
+// proceed concurrently and reuse connections, resolved names and TLS
+// sessions.
+class CurlMultiClient : public HttpClient {
+ public:
+  CurlMultiClient(const CurlMultiHttpClientOptions& options)
+      : options_(options) {
+    multi_ = curl_multi_init();
+    share_ = curl_share_init();
+    if (!multi_ || !share_) {
+      LOG(ERROR) << "failed to initialize curl";
+      return;
+    }
+    // Easy handles in a multi handle already share connections and resolved
+    // names, TLS sessions are only shared through a share handle. Callers
+    // attach and clean up their easy handles on their own threads while the
+    // loop thread uses the share handle, so it needs locking.
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, LockShare);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, UnlockShare);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    // By default idle connections are only kept for the transfers in
+    // progress, which are none between bursts of requests.
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, kMaxIdleConnections);
+    if (options_.max_total_connections > 0) {
+      curl_multi_setopt(multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS,
+                        options_.max_total_connections);
+    }
+    loop_ = std::thread([this]() { Loop(); });
+  }
+
+  ~CurlMultiClient() {
+    if (loop_.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+      }
+      curl_multi_wakeup(multi_);
+      loop_.join();
+    }
+    curl_multi_cleanup(multi_);
+    curl_share_cleanup(share_);
+  }
+
+  Result<HttpResponse<void>> DownloadToCallback(
+      HttpRequest request, DataCallback callback) override {
+    VLOG(0) << "Downloading '" << request.url << "'";
+    CF_EXPECT(CheckRequest(request));
+    CF_EXPECT(loop_.joinable(), "curl was not initialized");
+    CF_EXPECT(callback(nullptr, 0) /* Signal start of data */,
+              "callback failure");
+
+    auto curl_headers = CF_EXPECT(SlistFromStrings(request.headers));
+    std::string host = CF_EXPECT(HostOf(request.url));
+    Transfer transfer{
+        .request = std::move(request),
+        .callback = std::move(callback),
+        .headers = std::move(curl_headers),
+        .host = std::move(host),
+    };
+    transfer.curl = curl_easy_init();
+    CF_EXPECT(transfer.curl != nullptr, "failed to initialize curl");
+    SetupTransfer(transfer.curl, transfer.request, transfer.headers.get(),
+                  &transfer.callback, transfer.error_buf, options_.verbose);
+    curl_easy_setopt(transfer.curl, CURLOPT_SHARE, share_);
+    curl_easy_setopt(transfer.curl, CURLOPT_PRIVATE, &transfer);
+    curl_easy_setopt(transfer.curl, CURLOPT_HTTP_VERSION,
+                     CURL_HTTP_VERSION_2TLS);
+    // Wait for a connection that can multiplex rather than opening another.
+    // Only TLS connections negotiate HTTP/2, over plain HTTP/1.1 waiting would
+    // serialize transfers on one connection.
+    if (transfer.request.url.starts_with("https://")) {
+      curl_easy_setopt(transfer.curl, CURLOPT_PIPEWAIT, 1L);
+    }
+
+    std::future<CURLcode> done = transfer.done.get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_) {
+        curl_easy_cleanup(transfer.curl);
+        return CF_ERR("HTTP client is shutting down");
+      }
+      submitted_.push_back(&transfer);
+    }
+    curl_multi_wakeup(multi_);
+
+    CURLcode res = done.get();
+    Result<HttpResponse<void>> response =
+        TransferResponse(transfer.curl, res, transfer.error_buf);
+    curl_easy_cleanup(transfer.curl);
+    return CF_EXPECT(std::move(response));
+  }
+
+ private:
+  struct Transfer {
+    HttpRequest request;
+    DataCallback callback;
+    ManagedCurlSlist headers;
+    std::string host;
+    CURL* curl = nullptr;
+    char error_buf[CURL_ERROR_SIZE];
+    std::promise<CURLcode> done;
+  };
+
+  static void LockShare(CURL*, curl_lock_data data, curl_lock_access,
+                        void* client) {
+    static_cast<CurlMultiClient*>(client)->share_mutexes_[data].lock();
+  }
+
+  static void UnlockShare(CURL*, curl_lock_data data, void* client) {
+    static_cast<CurlMultiClient*>(client)->share_mutexes_[data].unlock();
+  }
+
+  static Result<std::string> HostOf(const std::string& url) {
+    std::unique_ptr<CURLU, decltype(&curl_url_cleanup)> parsed(
+        curl_url(), curl_url_cleanup);
+    CF_EXPECT(parsed != nullptr);
+    CF_EXPECTF(curl_url_set(parsed.get(), CURLUPART_URL, url.c_str(), 0) ==
+                   CURLUE_OK,
+               "Failed to parse URL '{}'", ScrubSecrets(url));
+    char* host = nullptr;
+    CF_EXPECTF(curl_url_get(parsed.get(), CURLUPART_HOST, &host, 0) ==
+                   CURLUE_OK,
+               "No host in URL '{}'", ScrubSecrets(url));
+    std::string host_str = host;
+    curl_free(host);
+    return host_str;
+  }
+
+  void Loop() {
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Transfer* transfer : submitted_) {
+          waiting_[transfer->host].push_back(transfer);
+        }
+        submitted_.clear();
+        // Callers are blocked on their transfers, so none are left behind.
+        if (stopping_ && active_ == 0 && waiting_.empty()) {
+          return;
+        }
+      }
+      StartWaitingTransfers();
+
+      int running = 0;
+      CURLMcode mres = curl_multi_perform(multi_, &running);
+      if (mres != CURLM_OK) {
+        LOG(ERROR) << "curl_multi_perform failed: "
+                   << curl_multi_strerror(mres);
+      }
+      CURLMsg* msg = nullptr;
+      int left = 0;
+      bool finished = false;
+      while ((msg = curl_multi_info_read(multi_, &left)) != nullptr) {
+        if (msg->msg == CURLMSG_DONE) {
+          FinishTransfer(msg->easy_handle, msg->data.result);
+          finished = true;
+        }
+      }
+      // Waiting transfers may start in the slots that were freed.
+      if (!finished) {
+        curl_multi_poll(multi_, nullptr, 0, kPollTimeoutMs, nullptr);
+      }
+    }
+  }
+
+  void StartWaitingTransfers() {
+    for (auto it = waiting_.begin(); it != waiting_.end();) {
+      auto& [host, transfers] = *it;
+      while (!transfers.empty() &&
+             (options_.max_transfers_per_host <= 0 ||
+              active_per_host_[host] < options_.max_transfers_per_host)) {
+        Transfer* transfer = transfers.front();
+        transfers.pop_front();
+        CURLMcode res = curl_multi_add_handle(multi_, transfer->curl);
+        if (res != CURLM_OK) {
+          LOG(ERROR) << "curl_multi_add_handle failed: "
+                     << curl_multi_strerror(res);
+          transfer->done.set_value(CURLE_FAILED_INIT);
+          continue;
+        }
+        active_per_host_[host]++;
+        active_++;
+      }
+      it = transfers.empty() ? waiting_.erase(it) : std::next(it);
+    }
+  }
+
+  void FinishTransfer(CURL* curl, CURLcode res) {
+    Transfer* transfer = nullptr;
+    curl_easy_getinfo(curl, CURLINFO_PRIVATE, &transfer);
+    curl_multi_remove_handle(multi_, curl);
+    if (--active_per_host_[transfer->host] == 0) {
+      active_per_host_.erase(transfer->host);
+    }
+    active_--;
+    // The caller may free the transfer as soon as this returns.
+    transfer->done.set_value(res);
+  }
+
+  // Upper bound, curl_multi_wakeup interrupts the wait for new transfers.
+  static constexpr int kPollTimeoutMs = 1000;
+  static constexpr long kMaxIdleConnections = 32;
+
+  const CurlMultiHttpClientOptions options_;
+  CURLM* multi_ = nullptr;
+  CURLSH* share_ = nullptr;
+  // One per kind of data in `share_`, indexed by curl_lock_data.
+  std::array<std::mutex, CURL_LOCK_DATA_LAST> share_mutexes_;
+  std::thread loop_;
+
+  std::mutex mutex_;
+  std::vector<Transfer*> submitted_;
+  bool stopping_ = false;
+
+  // Only used on the loop thread.
+  std::map<std::string, std::deque<Transfer*>> waiting_;
+  std::map<std::string, int> active_per_host_;
+  int active_ = 0;
+};
+
 }  // namespace
 
 std::unique_ptr<HttpClient> CurlHttpClient(bool use_logging_debug_function) {
   return std::make_unique<CurlClient>(use_logging_debug_function);
 }
 
+std::unique_ptr<HttpClient> CurlMultiHttpClient(
+    const CurlMultiHttpClientOptions& options) {
+  return std::make_unique<CurlMultiClient>(options);
+}
+
 }  // namespace cuttlefish
@@ -21,7 +21,25 @@
 
 namespace cuttlefish {
 
+// Performs one request at a time. Requests and responses are only traced,
+// with secrets scrubbed, when `use_logging_debug_function` is set.
 std::unique_ptr<HttpClient> CurlHttpClient(
     bool use_logging_debug_function = false);
 
+struct CurlMultiHttpClientOptions {
+  // Transfers to one host that run at the same time, later ones wait for one
+  // of them to finish. Over HTTP/2 they share a connection. 0 is unlimited.
+  int max_transfers_per_host = 8;
+  // 0 is unlimited.
+  long max_total_connections = 0;
+  // Traces requests and responses, with secrets scrubbed.
+  bool verbose = false;
+};
+
+// Performs requests from any number of threads concurrently on a single
+// background thread, which also calls the data callbacks. Connections,
+// resolved names and TLS sessions are reused across requests.
+std::unique_ptr<HttpClient> CurlMultiHttpClient(
+    const CurlMultiHttpClientOptions& options = {});
+
 }  // namespace cuttlefish
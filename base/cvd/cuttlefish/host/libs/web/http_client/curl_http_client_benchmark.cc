@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares CurlHttpClient, which performs one request at a time, with
+// CurlMultiHttpClient when several threads make requests at once, as fetching
+// artifacts and the host package does. The local server answers after a
+// delay standing in for the round trip to a remote server.
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cuttlefish/host/libs/web/http_client/curl_global_init.h"
+#include "cuttlefish/host/libs/web/http_client/curl_http_client.h"
+#include "cuttlefish/host/libs/web/http_client/fake_http_server.h"
+#include "cuttlefish/host/libs/web/http_client/http_client.h"
+#include "cuttlefish/host/libs/web/http_client/http_string.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr std::chrono::milliseconds kServerDelay(5);
+constexpr size_t kBodySize = 64 * 1024;
+
+void RunRequests(benchmark::State& state, HttpClient& client) {
+  auto server = FakeHttpServer::Start(std::string(kBodySize, 'b'), kServerDelay);
+  if (!server.ok()) {
+    state.SkipWithError("Failed to start server");
+    return;
+  }
+  const int threads = state.range(0);
+  for (auto _ : state) {
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+      workers.emplace_back([&server, &client, &state]() {
+        auto response = HttpGetToString(client, (*server)->Url("/artifact"));
+        if (!response.ok() || response->data.size() != kBodySize) {
+          state.SkipWithError("Request failed");
+        }
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * threads);
+  state.counters["connections"] = (*server)->Connections();
+}
+
+void BM_EasyClient(benchmark::State& state) {
+  CurlGlobalInit curl_init;
+  std::unique_ptr<HttpClient> client = CurlHttpClient();
+  RunRequests(state, *client);
+}
+BENCHMARK(BM_EasyClient)->Arg(1)->Arg(8)->Arg(32)->UseRealTime();
+
+void BM_MultiClient(benchmark::State& state) {
+  CurlGlobalInit curl_init;
+  std::unique_ptr<HttpClient> client =
+      CurlMultiHttpClient({.max_transfers_per_host = 8});
+  RunRequests(state, *client);
+}
+BENCHMARK(BM_MultiClient)->Arg(1)->Arg(8)->Arg(32)->UseRealTime();
+
+}  // namespace
+}  // namespace cuttlefish
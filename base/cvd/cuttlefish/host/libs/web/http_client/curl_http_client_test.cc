@@ -0,0 +1,121 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/web/http_client/curl_http_client.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/host/libs/web/http_client/curl_global_init.h"
+#include "cuttlefish/host/libs/web/http_client/fake_http_server.h"
+#include "cuttlefish/host/libs/web/http_client/http_client.h"
+#include "cuttlefish/host/libs/web/http_client/http_string.h"
+#include "cuttlefish/result/result.h"
+#include "cuttlefish/result/result_matchers.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr std::chrono::milliseconds kDelay(200);
+
+class CurlMultiHttpClientTest : public testing::Test {
+ protected:
+  void StartServer(std::chrono::milliseconds delay) {
+    Result<std::unique_ptr<FakeHttpServer>> server =
+        FakeHttpServer::Start("response body", delay);
+    ASSERT_THAT(server, IsOk());
+    server_ = std::move(*server);
+  }
+
+  // Makes `count` requests from as many threads.
+  void GetConcurrently(HttpClient& client, int count) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < count; i++) {
+      threads.emplace_back([this, &client, i]() {
+        Result<HttpResponse<std::string>> response =
+            HttpGetToString(client, server_->Url("/" + std::to_string(i)));
+        ASSERT_THAT(response, IsOk());
+        EXPECT_EQ(response->data, "response body");
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+
+  CurlGlobalInit curl_init_;
+  std::unique_ptr<FakeHttpServer> server_;
+};
+
+TEST_F(CurlMultiHttpClientTest, RunsRequestsConcurrently) {
+  StartServer(kDelay);
+  std::unique_ptr<HttpClient> client = CurlMultiHttpClient();
+
+  auto start = std::chrono::steady_clock::now();
+  GetConcurrently(*client, 4);
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 4 * kDelay);
+  EXPECT_EQ(server_->MaxConcurrentRequests(), 4);
+}
+
+TEST_F(CurlMultiHttpClientTest, LimitsTransfersPerHost) {
+  StartServer(kDelay / 4);
+  std::unique_ptr<HttpClient> client =
+      CurlMultiHttpClient({.max_transfers_per_host = 2});
+
+  GetConcurrently(*client, 6);
+
+  EXPECT_EQ(server_->Requests(), 6);
+  EXPECT_EQ(server_->MaxConcurrentRequests(), 2);
+}
+
+TEST_F(CurlMultiHttpClientTest, ReusesConnections) {
+  StartServer(std::chrono::milliseconds(0));
+  std::unique_ptr<HttpClient> client = CurlMultiHttpClient();
+
+  for (int i = 0; i < 5; i++) {
+    Result<HttpResponse<std::string>> response =
+        HttpGetToString(*client, server_->Url("/"));
+    ASSERT_THAT(response, IsOk());
+    EXPECT_TRUE(response->HttpSuccess());
+  }
+
+  EXPECT_EQ(server_->Connections(), 1);
+}
+
+TEST_F(CurlMultiHttpClientTest, CallbackFailureFailsRequest) {
+  StartServer(std::chrono::milliseconds(0));
+  std::unique_ptr<HttpClient> client = CurlMultiHttpClient();
+
+  Result<HttpResponse<void>> response = client->DownloadToCallback(
+      HttpRequest{.method = HttpMethod::kGet, .url = server_->Url("/")},
+      [](char* data, size_t) { return data == nullptr; });
+
+  EXPECT_THAT(response, IsError());
+}
+
+TEST_F(CurlMultiHttpClientTest, RejectsUrlWithoutHost) {
+  std::unique_ptr<HttpClient> client = CurlMultiHttpClient();
+
+  EXPECT_THAT(HttpGetToString(*client, "not a url"), IsError());
+}
+
+}  // namespace
+}  // namespace cuttlefish
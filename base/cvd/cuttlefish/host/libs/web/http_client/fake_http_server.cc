@@ -0,0 +1,195 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/host/libs/web/http_client/fake_http_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "fmt/format.h"
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+namespace {
+
+constexpr std::string_view kEndOfHeaders = "\r\n\r\n";
+
+// Requests with a body carry a Content-Length header.
+size_t ContentLength(std::string_view headers) {
+  std::string lower = absl::AsciiStrToLower(headers);
+  constexpr std::string_view kHeader = "\r\ncontent-length:";
+  size_t pos = lower.find(kHeader);
+  if (pos == std::string::npos) {
+    return 0;
+  }
+  size_t end = lower.find("\r\n", pos + kHeader.size());
+  size_t length = 0;
+  if (!absl::SimpleAtoi(
+          std::string_view(lower).substr(pos + kHeader.size(),
+                                         end - pos - kHeader.size()),
+          &length)) {
+    return 0;
+  }
+  return length;
+}
+
+}  // namespace
+
+Result<std::unique_ptr<FakeHttpServer>> FakeHttpServer::Start(
+    std::string body, std::chrono::milliseconds delay) {
+  SharedFD listener = SharedFD::Socket(AF_INET, SOCK_STREAM, 0);
+  CF_EXPECT(listener->IsOpen(), listener->StrError());
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  CF_EXPECT(listener->Bind(reinterpret_cast<sockaddr*>(&addr),
+                           sizeof(addr)) == 0,
+            listener->StrError());
+  CF_EXPECT(listener->Listen(64) == 0, listener->StrError());
+  socklen_t addr_len = sizeof(addr);
+  CF_EXPECT(listener->GetSockName(reinterpret_cast<sockaddr*>(&addr),
+                                  &addr_len) == 0,
+            listener->StrError());
+  return std::unique_ptr<FakeHttpServer>(new FakeHttpServer(
+      std::move(listener), ntohs(addr.sin_port), std::move(body), delay));
+}
+
+FakeHttpServer::FakeHttpServer(SharedFD listener, int port, std::string body,
+                               std::chrono::milliseconds delay)
+    : listener_(std::move(listener)),
+      port_(port),
+      body_(std::move(body)),
+      delay_(delay),
+      shutdown_(SharedFD::Event(0, 0)) {
+  accept_thread_ = std::thread([this]() { AcceptLoop(); });
+}
+
+FakeHttpServer::~FakeHttpServer() {
+  uint64_t v = 1;
+  shutdown_->Write(&v, sizeof(v));
+  accept_thread_.join();
+  std::vector<std::thread> client_threads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (SharedFD& client : clients_) {
+      client->Shutdown(SHUT_RDWR);
+    }
+    client_threads = std::move(client_threads_);
+  }
+  for (std::thread& thread : client_threads) {
+    thread.join();
+  }
+}
+
+std::string FakeHttpServer::Url(std::string_view path) const {
+  return fmt::format("http://127.0.0.1:{}{}", port_, path);
+}
+
+int FakeHttpServer::Connections() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return clients_.size();
+}
+
+int FakeHttpServer::Requests() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return requests_;
+}
+
+int FakeHttpServer::MaxConcurrentRequests() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_concurrent_requests_;
+}
+
+void FakeHttpServer::AcceptLoop() {
+  while (true) {
+    PollSharedFd fds[] = {
+        {.fd = listener_, .events = POLLIN, .revents = 0},
+        {.fd = shutdown_, .events = POLLIN, .revents = 0},
+    };
+    if (SharedFD::Poll(fds, 2, -1) < 0 || fds[1].revents) {
+      return;
+    }
+    SharedFD client = SharedFD::Accept(*listener_);
+    if (!client->IsOpen()) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    clients_.push_back(client);
+    client_threads_.emplace_back([this, client]() { Serve(client); });
+  }
+}
+
+void FakeHttpServer::Serve(SharedFD client) {
+  std::string buffer;
+  char chunk[4096];
+  while (true) {
+    size_t headers_end = buffer.find(kEndOfHeaders);
+    if (headers_end != std::string::npos) {
+      size_t request_size = headers_end + kEndOfHeaders.size() +
+                            ContentLength(buffer.substr(0, headers_end));
+      if (buffer.size() >= request_size) {
+        if (!Respond(client, buffer.substr(0, headers_end))) {
+          return;
+        }
+        buffer.erase(0, request_size);
+        continue;
+      }
+    }
+    ssize_t read = client->Read(chunk, sizeof(chunk));
+    if (read <= 0) {
+      return;
+    }
+    buffer.append(chunk, read);
+  }
+}
+
+bool FakeHttpServer::Respond(SharedFD& client, std::string_view request) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_++;
+    concurrent_requests_++;
+    max_concurrent_requests_ =
+        std::max(max_concurrent_requests_, concurrent_requests_);
+  }
+  std::this_thread::sleep_for(delay_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    concurrent_requests_--;
+  }
+  bool head = request.starts_with("HEAD ");
+  std::string response = fmt::format(
+      "HTTP/1.1 200 OK\r\nContent-Length: {}\r\n\r\n{}", body_.size(),
+      head ? std::string_view() : std::string_view(body_));
+  return WriteAll(client, response) == static_cast<ssize_t>(response.size());
+}
+
+}  // namespace cuttlefish
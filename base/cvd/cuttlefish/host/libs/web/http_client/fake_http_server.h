@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/result/result.h"
+
+namespace cuttlefish {
+
+// A plain HTTP/1.1 server on a loopback port that answers every request with
+// the same body after the same delay, standing in for a remote server in
+// tests and benchmarks of HTTP clients. Connections are kept alive.
+class FakeHttpServer {
+ public:
+  static Result<std::unique_ptr<FakeHttpServer>> Start(
+      std::string body, std::chrono::milliseconds delay);
+  ~FakeHttpServer();
+
+  std::string Url(std::string_view path) const;
+
+  int Connections();
+  int Requests();
+  // The most requests that were being answered at the same time.
+  int MaxConcurrentRequests();
+
+ private:
+  FakeHttpServer(SharedFD listener, int port, std::string body,
+                 std::chrono::milliseconds delay);
+
+  void AcceptLoop();
+  void Serve(SharedFD client);
+  bool Respond(SharedFD& client, std::string_view request);
+
+  const SharedFD listener_;
+  const int port_;
+  const std::string body_;
+  const std::chrono::milliseconds delay_;
+  SharedFD shutdown_;
+
+  std::mutex mutex_;
+  std::vector<SharedFD> clients_;
+  std::vector<std::thread> client_threads_;
+  int requests_ = 0;
+  int concurrent_requests_ = 0;
+  int max_concurrent_requests_ = 0;
+
+  std::thread accept_thread_;
+};
+
+}  // namespace cuttlefish
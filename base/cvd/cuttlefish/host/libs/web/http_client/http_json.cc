@@ -29,9 +29,9 @@
 #include "cuttlefish/result/result.h"
 
 namespace cuttlefish {
-namespace {
 
-HttpResponse<Json::Value> Parse(HttpResponse<std::string> response) {
+HttpResponse<Json::Value> HttpResponseToJson(
+    HttpResponse<std::string> response) {
   Result<Json::Value> result = ParseJson(response.data);
   if (!result.ok()) {
     Json::Value error_json;
@@ -47,12 +47,11 @@ HttpResponse<Json::Value> Parse(HttpResponse<std::string> response) {
                                    .headers = std::move(response.headers)};
 }
 
-}  // namespace
-
 Result<HttpResponse<Json::Value>> HttpPostToJson(
     HttpClient& http_client, const std::string& url, const std::string& data,
     const std::vector<std::string>& headers) {
-  return Parse(CF_EXPECT(HttpPostToString(http_client, url, data, headers)));
+  return HttpResponseToJson(
+      CF_EXPECT(HttpPostToString(http_client, url, data, headers)));
 }
 
 Result<HttpResponse<Json::Value>> HttpPostToJson(
@@ -60,14 +59,15 @@ Result<HttpResponse<Json::Value>> HttpPostToJson(
     const std::vector<std::string>& headers) {
   std::stringstream json_str;
   json_str << data;
-  return Parse(
+  return HttpResponseToJson(
       CF_EXPECT(HttpPostToString(http_client, url, json_str.str(), headers)));
 }
 
 Result<HttpResponse<Json::Value>> HttpGetToJson(
     HttpClient& http_client, const std::string& url,
     const std::vector<std::string>& headers) {
-  return Parse(CF_EXPECT(HttpGetToString(http_client, url, headers)));
+  return HttpResponseToJson(
+      CF_EXPECT(HttpGetToString(http_client, url, headers)));
 }
 
 }  // namespace cuttlefish
@@ -33,6 +33,8 @@ namespace cuttlefish {
 //   "error": "Failed to parse json",
 //   "response: "<THE RESPONSE BODY>"
 // }
+HttpResponse<Json::Value> HttpResponseToJson(
+    HttpResponse<std::string> response);
 Result<HttpResponse<Json::Value>> HttpPostToJson(
     HttpClient&, const std::string& url, const std::string& data,
     const std::vector<std::string>& headers = {});
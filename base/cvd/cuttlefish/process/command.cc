@@ -28,6 +28,7 @@
 #include <cstring>
 #include <functional>
 #include <map>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <set>
@@ -44,6 +45,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "android-base/unique_fd.h"
 
 #include "cuttlefish/common/libs/fs/shared_fd.h"
 #include "cuttlefish/common/libs/utils/contains.h"
@@ -54,7 +56,14 @@
 
 #ifdef __linux__
 #include <linux/prctl.h>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/prctl.h>
+#include <sys/syscall.h>
+
+#ifndef CLONE_PIDFD
+#define CLONE_PIDFD 0x00001000
+#endif
 #endif
 
 extern char** environ;
@@ -84,14 +93,144 @@ bool validate_redirects(const std::map<Command::StdIoChannel, int>& redirects,
   return true;
 }
 
-void do_redirects(const std::map<Command::StdIoChannel, int>& redirects) {
-  for (const auto& entry : redirects) {
-    auto std_channel = static_cast<int>(entry.first);
-    auto fd = entry.second;
-    TEMP_FAILURE_RETRY(dup2(fd, std_channel));
+// One step of the setup a child process does between fork and exec.
+struct ChildAction {
+  enum Kind {
+    kDeathSignal,      // Get SIGHUP when the parent dies.
+    kDup2,             // dup2(fd, target), failures are ignored.
+    kSetProcessGroup,  // Become the head of a new process group.
+    kClearCloexec,     // Let `fd` be inherited across exec.
+    kFchdir,           // Change the working directory to `fd`.
+    kJoinCgroup,       // Write "0" to `fd`, an open cgroup.procs file.
+  };
+  Kind kind;
+  int fd = -1;
+  int target = -1;
+};
+
+struct ChildArgs {
+  const char* executable;
+  char* const* argv;
+  char* const* envp;
+  const ChildAction* actions;
+  size_t num_actions;
+  // Written by the child if it fails to start the executable.
+  int error = 0;
+#ifdef __linux__
+  // Signal mask to restore after clone, see SpawnSharingMemory.
+  sigset_t signal_mask;
+#endif
+};
+
+// Runs in the child process, which may share the parent's address space. Only
+// async-signal-safe functions can be called and no memory can be allocated.
+// LOG(...) can't be used either because it may block waiting for other threads
+// which don't exist in the child process.
+[[noreturn]] void RunChild(ChildArgs& args) {
+  for (size_t i = 0; i < args.num_actions; i++) {
+    const ChildAction& action = args.actions[i];
+    bool ok = true;
+    switch (action.kind) {
+      case ChildAction::kDeathSignal:
+#ifdef __linux__
+        prctl(PR_SET_PDEATHSIG, SIGHUP);
+#endif
+        break;
+      case ChildAction::kDup2:
+        TEMP_FAILURE_RETRY(dup2(action.fd, action.target));
+        break;
+      case ChildAction::kSetProcessGroup:
+        // This call should never fail (see SETPGID(2))
+        ok = setpgid(0, 0) == 0;
+        break;
+      case ChildAction::kClearCloexec:
+        ok = fcntl(action.fd, F_SETFD, 0) == 0;
+        break;
+      case ChildAction::kFchdir:
+        ok = TEMP_FAILURE_RETRY(fchdir(action.fd)) == 0;
+        break;
+      case ChildAction::kJoinCgroup:
+        // "0" stands for the writing process.
+        ok = TEMP_FAILURE_RETRY(write(action.fd, "0", 1)) == 1;
+        break;
+    }
+    if (!ok) {
+      args.error = errno;
+      _exit(-errno);
+    }
   }
+#ifdef __linux__
+  execvpe(args.executable, args.argv, args.envp);
+#elif defined(__APPLE__)
+  execve(args.executable, args.argv, args.envp);
+#else
+#error "Unsupported architecture"
+#endif
+  // execvpe/execve only return on failure.
+  args.error = errno;
+  _exit(-1);
+}
+
+#ifdef __linux__
+// The child's stack while it shares the parent's address space. Nothing in
+// RunChild or exec uses much of it.
+constexpr size_t kChildStackSize = 64 * 1024;
+
+int ChildEntryPoint(void* arg) {
+  ChildArgs& args = *static_cast<ChildArgs*>(arg);
+  // Signal handlers would run on the parent's memory, reset them before
+  // accepting signals again. exec resets them anyway.
+  for (int sig = 1; sig < NSIG; sig++) {
+    struct sigaction action;
+    if (sigaction(sig, nullptr, &action) == 0 &&
+        action.sa_handler != SIG_IGN && action.sa_handler != SIG_DFL) {
+      action.sa_handler = SIG_DFL;
+      sigaction(sig, &action, nullptr);
+    }
+  }
+  sigprocmask(SIG_SETMASK, &args.signal_mask, nullptr);
+  RunChild(args);
 }
 
+int PidfdOpen(pid_t pid) {
+  // There is no glibc wrapper for pidfd_open.
+#ifndef SYS_pidfd_open
+  constexpr int SYS_pidfd_open = 434;
+#endif
+  return syscall(SYS_pidfd_open, pid, /*flags=*/0);
+}
+
+// Like vfork(2): the child shares the parent's memory, so no page tables are
+// copied, and the calling thread is suspended until the child calls exec or
+// exits. Also returns a pidfd for the child, if the kernel supports it.
+pid_t SpawnSharingMemory(ChildArgs& args, android::base::unique_fd& pidfd) {
+  std::unique_ptr<char[]> stack(new char[kChildStackSize]);
+  void* stack_top = stack.get() + kChildStackSize;
+
+  // No signal handler may run in the child before it resets them.
+  sigset_t all_signals;
+  sigfillset(&all_signals);
+  pthread_sigmask(SIG_SETMASK, &all_signals, &args.signal_mask);
+
+  int raw_pidfd = -1;
+  const int flags = CLONE_VM | CLONE_VFORK | SIGCHLD;
+  pid_t pid = clone(ChildEntryPoint, stack_top, flags | CLONE_PIDFD, &args,
+                    &raw_pidfd);
+  if (pid == -1 && errno == EINVAL) {
+    // Kernels before 5.2 don't know CLONE_PIDFD.
+    pid = clone(ChildEntryPoint, stack_top, flags, &args);
+  }
+  int clone_errno = errno;
+  pthread_sigmask(SIG_SETMASK, &args.signal_mask, nullptr);
+  errno = clone_errno;
+
+  if (pid > 0) {
+    pidfd.reset(raw_pidfd);
+  }
+  return pid;
+}
+#endif
+
 std::vector<const char*> ToCharPointers(const std::vector<std::string>& vect) {
   std::vector<const char*> ret = {};
   for (const auto& str : vect) {
@@ -270,50 +409,83 @@ Subprocess Command::Start(SubprocessOptions options) const {
 
   // ToCharPointers allocates memory so it can't be called in the child process.
   auto envp = ToCharPointers(env_);
-  pid_t pid = fork();
-  if (!pid) {
-    // LOG(...) can't be used in the child process because it may block waiting
-    // for other threads which don't exist in the child process.
+
+  // Likewise, everything the child does before exec is decided here.
+  std::vector<ChildAction> actions;
 #ifdef __linux__
-    if (options.ExitWithParent()) {
-      prctl(PR_SET_PDEATHSIG, SIGHUP);  // Die when parent dies
-    }
+  if (options.ExitWithParent()) {
+    actions.push_back({.kind = ChildAction::kDeathSignal});
+  }
 #endif
-
-    do_redirects(redirects_);
-
-    if (options.InGroup()) {
-      // This call should never fail (see SETPGID(2))
-      if (setpgid(0, 0) != 0) {
-        exit(-errno);
-      }
+  // Joined before exec, so nothing the program does is accounted elsewhere.
+  android::base::unique_fd cgroup_procs;
+  if (!options.Cgroup().empty()) {
+    std::string procs_path = options.Cgroup() + "/cgroup.procs";
+    cgroup_procs.reset(open(procs_path.c_str(), O_WRONLY | O_CLOEXEC));
+    if (cgroup_procs.get() < 0) {
+      LOG(ERROR) << "Failed to open " << procs_path << ": " << strerror(errno);
+      return Subprocess(-1, {});
     }
-    for (const auto& entry : inherited_fds_) {
-      if (fcntl(entry.second, F_SETFD, 0)) {
-        exit(-errno);
-      }
+    actions.push_back(
+        {.kind = ChildAction::kJoinCgroup, .fd = cgroup_procs.get()});
+  }
+  for (const auto& [channel, fd] : redirects_) {
+    actions.push_back({.kind = ChildAction::kDup2,
+                       .fd = fd,
+                       .target = static_cast<int>(channel)});
+  }
+  if (options.InGroup()) {
+    actions.push_back({.kind = ChildAction::kSetProcessGroup});
+  }
+  for (const auto& entry : inherited_fds_) {
+    actions.push_back({.kind = ChildAction::kClearCloexec, .fd = entry.second});
+  }
+  int working_directory = -1;
+  if (working_directory_->IsOpen()) {
+    working_directory = working_directory_->Fcntl(F_DUPFD_CLOEXEC, 3);
+    if (working_directory < 0) {
+      LOG(ERROR) << "Failed to duplicate working directory fd: "
+                 << working_directory_->StrError();
+      return Subprocess(-1, {});
     }
-    if (working_directory_->IsOpen()) {
-      if (SharedFD::Fchdir(working_directory_) != 0) {
-        exit(-errno);
-      }
+    actions.push_back({.kind = ChildAction::kFchdir, .fd = working_directory});
+  }
+
+  ChildArgs child_args{
+      .executable = executable_ ? executable_->c_str() : cmd[0],
+      .argv = const_cast<char* const*>(cmd.data()),
+      .envp = const_cast<char* const*>(envp.data()),
+      .actions = actions.data(),
+      .num_actions = actions.size(),
+  };
+  android::base::unique_fd pidfd;
+  pid_t pid;
+#ifdef __linux__
+  if (!options.UseFork()) {
+    pid = SpawnSharingMemory(child_args, pidfd);
+  } else
+#endif
+  {
+    pid = fork();
+    if (!pid) {
+      RunChild(child_args);
     }
-    int rval;
-    const char* executable = executable_ ? executable_->c_str() : cmd[0];
 #ifdef __linux__
-    rval = execvpe(executable, const_cast<char* const*>(cmd.data()),
-                   const_cast<char* const*>(envp.data()));
-#elif defined(__APPLE__)
-    rval = execve(executable, const_cast<char* const*>(cmd.data()),
-                  const_cast<char* const*>(envp.data()));
-#else
-#error "Unsupported architecture"
+    if (pid > 0) {
+      pidfd.reset(PidfdOpen(pid));
+    }
 #endif
-    // No need to check for error, execvpe/execve don't return on success.
-    exit(rval);
+  }
+  if (working_directory >= 0) {
+    close(working_directory);
   }
   if (pid == -1) {
     LOG(ERROR) << "fork failed (" << strerror(errno) << ")";
+  } else if (child_args.error != 0) {
+    // Only reported when the child shared our memory. It has exited already,
+    // with the same status as a forked child would have.
+    LOG(ERROR) << "Failed to start " << child_args.executable << ": "
+               << strerror(child_args.error);
   }
   if (options.Verbose()) {  // "more verbose", and VLOG(0) > VLOG(1)
     VLOG(0) << "Started (pid: " << pid << "): " << cmd[0];
@@ -326,7 +498,7 @@ Subprocess Command::Start(SubprocessOptions options) const {
       VLOG(1) << cmd[i];
     }
   }
-  return Subprocess(pid, subprocess_stopper_);
+  return Subprocess(pid, subprocess_stopper_, std::move(pidfd));
 }
 
 std::ostream& operator<<(std::ostream& out, const Command& command) {
@@ -0,0 +1,64 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how long Command::Start takes to spawn a trivial subprocess with
+// fork(2) and with the default clone(2) that shares the address space, while
+// the parent has a given amount of memory mapped, like run_cvd or
+// assemble_cvd.
+
+#include <stddef.h>
+#include <string.h>
+
+#include <memory>
+
+#include "benchmark/benchmark.h"
+
+#include "cuttlefish/process/command.h"
+#include "cuttlefish/process/subprocess.h"
+#include "cuttlefish/process/subprocess_options.h"
+
+namespace cuttlefish {
+namespace {
+
+void SpawnWithResidentMemory(benchmark::State& state, bool use_fork) {
+  size_t resident_bytes = static_cast<size_t>(state.range(0)) << 20;
+  std::unique_ptr<char[]> memory(new char[resident_bytes]);
+  // Touch every page so fork has page tables to copy.
+  memset(memory.get(), 1, resident_bytes);
+  benchmark::DoNotOptimize(memory.get());
+
+  Command command("/bin/true");
+  auto options = SubprocessOptions().Verbose(false).UseFork(use_fork);
+  for (auto _ : state) {
+    Subprocess proc = command.Start(options);
+    if (proc.Wait() != 0) {
+      state.SkipWithError("/bin/true failed");
+      break;
+    }
+  }
+}
+
+void BM_StartFork(benchmark::State& state) {
+  SpawnWithResidentMemory(state, /* use_fork */ true);
+}
+BENCHMARK(BM_StartFork)->Arg(0)->Arg(256)->Arg(1024)->UseRealTime();
+
+void BM_StartSharedMemory(benchmark::State& state) {
+  SpawnWithResidentMemory(state, /* use_fork */ false);
+}
+BENCHMARK(BM_StartSharedMemory)->Arg(0)->Arg(256)->Arg(1024)->UseRealTime();
+
+}  // namespace
+}  // namespace cuttlefish
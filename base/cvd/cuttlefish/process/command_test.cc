@@ -0,0 +1,161 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/process/command.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/common/libs/fs/shared_buf.h"
+#include "cuttlefish/common/libs/fs/shared_fd.h"
+#include "cuttlefish/process/subprocess.h"
+#include "cuttlefish/process/subprocess_options.h"
+
+namespace cuttlefish {
+namespace {
+
+// Runs every test with both ways of starting a subprocess.
+class CommandTest : public testing::TestWithParam<bool> {
+ protected:
+  SubprocessOptions Options() {
+    return SubprocessOptions().InGroup(true).UseFork(GetParam());
+  }
+
+  // Runs `command` with its stdout redirected to a pipe, returns the output.
+  std::string Output(Command command) {
+    SharedFD read_end, write_end;
+    EXPECT_TRUE(SharedFD::Pipe(&read_end, &write_end));
+    command.RedirectStdIO(Command::StdIoChannel::kStdOut, write_end);
+    Subprocess proc = command.Start(Options());
+    EXPECT_TRUE(proc.Started());
+    // Drop the command's and our copies of the write end.
+    { Command discard = std::move(command); }
+    write_end->Close();
+    std::string output;
+    EXPECT_GE(ReadAll(read_end, &output), 0);
+    EXPECT_EQ(proc.Wait(), 0);
+    return output;
+  }
+};
+
+TEST_P(CommandTest, RedirectsStdout) {
+  Command command("/bin/echo");
+  command.AddParameter("hello");
+  EXPECT_EQ(Output(std::move(command)), "hello\n");
+}
+
+TEST_P(CommandTest, SetsEnvironment) {
+  Command command("/bin/sh");
+  command.AddParameter("-c");
+  command.AddParameter("echo $CF_COMMAND_TEST");
+  command.AddEnvironmentVariable("CF_COMMAND_TEST", "value");
+  EXPECT_EQ(Output(std::move(command)), "value\n");
+}
+
+TEST_P(CommandTest, ChangesWorkingDirectory) {
+  Command command("/bin/pwd");
+  command.SetWorkingDirectory("/");
+  EXPECT_EQ(Output(std::move(command)), "/\n");
+}
+
+TEST_P(CommandTest, InheritsFileDescriptors) {
+  SharedFD read_end, write_end;
+  ASSERT_TRUE(SharedFD::Pipe(&read_end, &write_end));
+  {
+    // Closes its copy of the write end when going out of scope.
+    Command command("/bin/sh");
+    command.AddParameter("-c");
+    command.AddParameter("echo inherited >&", write_end);
+    Subprocess proc = command.Start(Options());
+    ASSERT_TRUE(proc.Started());
+    EXPECT_EQ(proc.Wait(), 0);
+  }
+  write_end->Close();
+  std::string output;
+  EXPECT_GE(ReadAll(read_end, &output), 0);
+  EXPECT_EQ(output, "inherited\n");
+}
+
+TEST_P(CommandTest, StartsInOwnProcessGroup) {
+  Command command("/bin/sh");
+  command.AddParameter("-c");
+  // Fields 1 and 5 of the stat file are the pid and the process group id.
+  command.AddParameter(
+      "read pid comm state ppid pgid rest < /proc/self/stat; "
+      "[ $pid = $pgid ] && echo leader");
+  EXPECT_EQ(Output(std::move(command)), "leader\n");
+}
+
+TEST_P(CommandTest, MissingExecutableExits) {
+  Command command("/nonexistent/cf_command_test");
+  Subprocess proc = command.Start(Options());
+  ASSERT_TRUE(proc.Started());
+  EXPECT_NE(proc.Wait(), 0);
+}
+
+TEST_P(CommandTest, ProvidesPidfd) {
+  Command command("/bin/sleep");
+  command.AddParameter("10");
+  Subprocess proc = command.Start(Options());
+  ASSERT_TRUE(proc.Started());
+  if (proc.pidfd() < 0) {
+    GTEST_SKIP() << "No pidfd";
+  }
+  pollfd pfd{.fd = proc.pidfd(), .events = POLLIN};
+  EXPECT_EQ(poll(&pfd, 1, 0), 0);
+
+  EXPECT_TRUE(proc.SendSignal(SIGKILL).ok());
+  EXPECT_EQ(poll(&pfd, 1, 10000), 1);
+  proc.Wait();
+  EXPECT_EQ(proc.pidfd(), -1);
+}
+
+TEST_P(CommandTest, JoinsCgroup) {
+  // Stands in for a cgroup, the child writes to its cgroup.procs.
+  std::string cgroup = testing::TempDir() + "/cgroup_XXXXXX";
+  ASSERT_NE(mkdtemp(cgroup.data()), nullptr);
+  std::string procs = cgroup + "/cgroup.procs";
+  ASSERT_TRUE(SharedFD::Open(procs, O_CREAT | O_WRONLY, 0644)->IsOpen());
+
+  Subprocess proc = Command("/bin/true").Start(Options().Cgroup(cgroup));
+  ASSERT_TRUE(proc.Started());
+  EXPECT_EQ(proc.Wait(), 0);
+
+  std::string contents;
+  EXPECT_GE(ReadAll(SharedFD::Open(procs, O_RDONLY), &contents), 0);
+  EXPECT_EQ(contents, "0");
+}
+
+TEST_P(CommandTest, MissingCgroupFailsToStart) {
+  Command command("/bin/true");
+  Subprocess proc = command.Start(Options().Cgroup("/nonexistent/cgroup"));
+  EXPECT_FALSE(proc.Started());
+}
+
+INSTANTIATE_TEST_SUITE_P(SpawnMethods, CommandTest, testing::Bool(),
+                         [](const testing::TestParamInfo<bool>& info) {
+                           return info.param ? "Fork" : "SharedMemory";
+                         });
+
+}  // namespace
+}  // namespace cuttlefish
@@ -16,8 +16,15 @@
 
 #include "cuttlefish/process/managed_stdio.h"
 
+#include <poll.h>
+#include <sys/wait.h>
+
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cstring>
+#include <limits>
+#include <optional>
 #include <string>
 #include <thread>
 #include <utility>
@@ -50,11 +57,43 @@ class ThreadJoiner {
   }
 };
 
-}  // namespace
+// Waits for `subprocess` to exit without reaping it. Returns false if it is
+// still running at `deadline`.
+bool WaitForExit(Subprocess& subprocess,
+                 std::chrono::steady_clock::time_point deadline) {
+  while (true) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    remaining = std::max(remaining, std::chrono::milliseconds(0));
+    if (subprocess.pidfd() >= 0) {
+      struct pollfd pidfd_poll = {.fd = subprocess.pidfd(), .events = POLLIN};
+      int timeout_ms = std::min<int64_t>(remaining.count(),
+                                         std::numeric_limits<int>::max());
+      int ret = poll(&pidfd_poll, 1, timeout_ms);
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      // On errors let the caller block on the exit instead.
+      return ret != 0;
+    }
+    siginfo_t info;
+    if (subprocess.Wait(&info, WEXITED | WNOHANG | WNOWAIT) < 0 ||
+        info.si_pid != 0) {
+      return true;
+    }
+    if (remaining.count() == 0) {
+      return false;
+    }
+    std::this_thread::sleep_for(
+        std::min(remaining, std::chrono::milliseconds(10)));
+  }
+}
 
-int RunWithManagedStdio(Command cmd_tmp, const std::string* stdin_str,
-                        std::string* stdout_str, std::string* stderr_str,
-                        SubprocessOptions options) {
+int RunWithManagedStdioImpl(
+    Command cmd_tmp, const std::string* stdin_str, std::string* stdout_str,
+    std::string* stderr_str,
+    std::optional<std::chrono::steady_clock::time_point> deadline,
+    SubprocessOptions options) {
   /*
    * The order of these declarations is necessary for safety. If the function
    * returns at any point, the Command will be destroyed first, closing all
@@ -130,10 +169,18 @@ int RunWithManagedStdio(Command cmd_tmp, const std::string* stdin_str,
     Command forceDelete = std::move(cmd);
   }
 
+  bool timed_out = deadline && !WaitForExit(subprocess, *deadline);
+  if (timed_out) {
+    LOG(ERROR) << "\"" << cmd_short_name << "\" did not finish in time";
+    subprocess.Stop();
+  }
   int code = subprocess.Wait();
   {
     auto join_threads = std::move(thread_joiner);
   }
+  if (timed_out) {
+    return -1;
+  }
   if (io_error) {
     LOG(ERROR) << "IO error communicating with " << cmd_short_name;
     return -1;
@@ -141,6 +188,23 @@ int RunWithManagedStdio(Command cmd_tmp, const std::string* stdin_str,
   return code;
 }
 
+}  // namespace
+
+int RunWithManagedStdio(Command command, const std::string* stdin_str,
+                        std::string* stdout_str, std::string* stderr_str,
+                        SubprocessOptions options) {
+  return RunWithManagedStdioImpl(std::move(command), stdin_str, stdout_str,
+                                 stderr_str, std::nullopt, std::move(options));
+}
+
+int RunWithManagedStdio(Command command, const std::string* stdin_str,
+                        std::string* stdout_str, std::string* stderr_str,
+                        std::chrono::steady_clock::time_point deadline,
+                        SubprocessOptions options) {
+  return RunWithManagedStdioImpl(std::move(command), stdin_str, stdout_str,
+                                 stderr_str, deadline, std::move(options));
+}
+
 Result<std::string> RunAndCaptureStdout(Command command) {
   std::string standard_out;
   std::string standard_err;
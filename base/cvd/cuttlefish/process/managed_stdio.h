@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <string>
 
 #include "cuttlefish/process/command.h"
@@ -42,4 +43,13 @@ int RunWithManagedStdio(Command, const std::string* stdin, std::string* stdout,
                         std::string* stderr,
                         SubprocessOptions options = SubprocessOptions());
 
+/*
+ * Like the above, but kills `command` if it is still running at `deadline`.
+ * A killed command is reported with a negative return value.
+ */
+int RunWithManagedStdio(Command, const std::string* stdin, std::string* stdout,
+                        std::string* stderr,
+                        std::chrono::steady_clock::time_point deadline,
+                        SubprocessOptions options = SubprocessOptions());
+
 }  // namespace cuttlefish
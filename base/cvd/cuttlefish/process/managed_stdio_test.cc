@@ -0,0 +1,74 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cuttlefish/process/managed_stdio.h"
+
+#include <chrono>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "cuttlefish/process/command.h"
+
+namespace cuttlefish {
+namespace {
+
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+
+Command Shell(const std::string& script) {
+  return Command("/bin/sh").AddParameter("-c").AddParameter(script);
+}
+
+TEST(RunWithManagedStdioTest, CapturesOutput) {
+  std::string in = "input";
+  std::string out;
+  std::string err;
+
+  int code = RunWithManagedStdio(Shell("cat; echo error >&2; exit 3"), &in,
+                                 &out, &err);
+
+  EXPECT_EQ(code, 3);
+  EXPECT_EQ(out, "input");
+  EXPECT_EQ(err, "error\n");
+}
+
+TEST(RunWithManagedStdioTest, FinishesBeforeTheDeadline) {
+  std::string out;
+
+  int code = RunWithManagedStdio(Shell("echo done"), nullptr, &out, nullptr,
+                                 steady_clock::now() + seconds(30));
+
+  EXPECT_EQ(code, 0);
+  EXPECT_EQ(out, "done\n");
+}
+
+TEST(RunWithManagedStdioTest, KillsCommandAtTheDeadline) {
+  std::string out;
+  auto start = steady_clock::now();
+
+  int code = RunWithManagedStdio(Shell("echo started; exec sleep 100"),
+                                 nullptr, &out, nullptr,
+                                 start + milliseconds(200));
+
+  EXPECT_LT(code, 0);
+  EXPECT_EQ(out, "started\n");
+  EXPECT_GE(steady_clock::now() - start, milliseconds(200));
+  EXPECT_LT(steady_clock::now() - start, seconds(10));
+}
+
+}  // namespace
+}  // namespace cuttlefish
@@ -21,10 +21,11 @@
 #include <sys/types.h>
 #include <unistd.h>
 
-#include <regex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "absl/log/log.h"
@@ -61,41 +62,59 @@ struct ProcStatusUids {
   uid_t filesystem_;
 };
 
-// /proc/<pid>/status has Uid: <uid> <uid> <uid> <uid> line
-// It normally is separated by a tab or more but that's not guaranteed forever
-static Result<ProcStatusUids> OwnerUids(const pid_t pid) {
-  // parse from /proc/<pid>/status
-  std::regex uid_pattern(R"(Uid:\s+([0-9]+)\s+([0-9]+)\s+([0-9]+)\s+([0-9]+))");
+struct ProcStatus {
+  std::string name;
+  pid_t ppid;
+  ProcStatusUids uids;
+};
+
+// Parses the Name:, PPid: and Uid: lines of /proc/<pid>/status. The fields are
+// normally separated by a tab or more but that's not guaranteed forever.
+static Result<ProcStatus> ReadProcStatus(const pid_t pid) {
   std::string status_path = fmt::format("/proc/{}/status", pid);
   std::string status_content = CF_EXPECT(ReadFileContents(status_path));
-  std::vector<uid_t> uids;
+  std::optional<std::string> name;
+  std::optional<pid_t> ppid;
+  std::optional<ProcStatusUids> uids;
   for (std::string_view line :
        absl::StrSplit(status_content, '\n', absl::SkipEmpty())) {
-    std::smatch matches;
-    std::string line_str(line);
-    if (!std::regex_match(line_str, matches, uid_pattern)) {
-      continue;
-    }
-    // the line, then 4 uids
-    CF_EXPECT_EQ(matches.size(), 5,
-                 fmt::format("Error in the Uid line: \"{}\"", line));
-    uids.reserve(4);
-    for (int i = 1; i < 5; i++) {
-      unsigned uid = 0;
-      CF_EXPECT(absl::SimpleAtoi(matches[i].str(), &uid));
-      uids.push_back(uid);
+    if (absl::ConsumePrefix(&line, "Name:")) {
+      name = std::string(absl::StripAsciiWhitespace(line));
+    } else if (absl::ConsumePrefix(&line, "PPid:")) {
+      pid_t value;
+      CF_EXPECTF(absl::SimpleAtoi(line, &value),
+                 "Error in the PPid line: \"{}\"", line);
+      ppid = value;
+    } else if (absl::ConsumePrefix(&line, "Uid:")) {
+      std::vector<std::string_view> fields =
+          absl::StrSplit(line, absl::ByAnyChar(" \t"), absl::SkipEmpty());
+      CF_EXPECT_EQ(fields.size(), 4,
+                   fmt::format("Error in the Uid line: \"{}\"", line));
+      ProcStatusUids value;
+      CF_EXPECT(absl::SimpleAtoi(fields[0], &value.real_));
+      CF_EXPECT(absl::SimpleAtoi(fields[1], &value.effective_));
+      CF_EXPECT(absl::SimpleAtoi(fields[2], &value.saved_set_));
+      CF_EXPECT(absl::SimpleAtoi(fields[3], &value.filesystem_));
+      uids = value;
     }
-    break;
   }
-  CF_EXPECT(!uids.empty(), "The \"Uid:\" line was not found");
-  return ProcStatusUids{
-      .real_ = uids.at(0),
-      .effective_ = uids.at(1),
-      .saved_set_ = uids.at(2),
-      .filesystem_ = uids.at(3),
+  return ProcStatus{
+      .name = CF_EXPECTF(std::move(name),
+                         "The \"Name:\" line was not found in \"{}\"",
+                         status_path),
+      .ppid = CF_EXPECTF(std::move(ppid),
+                         "The \"PPid:\" line was not found in \"{}\"",
+                         status_path),
+      .uids = CF_EXPECTF(std::move(uids),
+                         "The \"Uid:\" line was not found in \"{}\"",
+                         status_path),
   };
 }
 
+static Result<ProcStatusUids> OwnerUids(const pid_t pid) {
+  return CF_EXPECT(ReadProcStatus(pid)).uids;
+}
+
 static std::string PidDirPath(const pid_t pid) {
   return fmt::format("{}/{}", kProcDir, pid);
 }
@@ -122,24 +141,7 @@ static Result<std::string> ReadAll(const std::string& file_path) {
 }
 
 Result<std::vector<pid_t>> CollectPids(const uid_t uid) {
-  CF_EXPECT(DirectoryExists(kProcDir));
-  auto subdirs = CF_EXPECT(DirectoryContents(kProcDir));
-  std::regex pid_dir_pattern("[0-9]+");
-  std::vector<pid_t> pids;
-  for (const auto& subdir : subdirs) {
-    if (!std::regex_match(subdir, pid_dir_pattern)) {
-      continue;
-    }
-    int pid;
-    // Shouldn't fail here. If failed, either regex or
-    // absl::SimpleAtoi needs serious fixes
-    CF_EXPECT(absl::SimpleAtoi(subdir, &pid));
-    auto owner_uid_result = OwnerUids(pid);
-    if (owner_uid_result.ok() && owner_uid_result->real_ == uid) {
-      pids.push_back(pid);
-    }
-  }
-  return pids;
+  return CF_EXPECT(ProcessTable::Scan()).Pids(uid);
 }
 
 Result<std::vector<std::string>> GetCmdArgs(const pid_t pid) {
@@ -161,43 +163,10 @@ Result<std::string> GetExecutablePath(const pid_t pid) {
   return exec_target_path;
 }
 
-static Result<void> CheckExecNameFromStatus(const std::string& exec_name,
-                                            const pid_t pid) {
-  std::string status_path = fmt::format("/proc/{}/status", pid);
-  std::string status_content = CF_EXPECT(ReadFileContents(status_path));
-  bool found = false;
-  for (std::string_view line :
-       absl::StrSplit(status_content, '\n', absl::SkipEmpty())) {
-    if (!absl::ConsumePrefix(&line, "Name:")) {
-      continue;
-    }
-    if (absl::StripAsciiWhitespace(line) == exec_name) {
-      found = true;
-      break;
-    }
-  }
-  CF_EXPECTF(found == true,
-             "\"Name:  [name]\" line is not found in the status file: \"{}\"",
-             status_path);
-  return {};
-}
-
 Result<std::vector<pid_t>> CollectPidsByExecName(const std::string& exec_name,
                                                  const uid_t uid) {
   CF_EXPECT_EQ(android::base::Basename(exec_name), exec_name);
-  auto input_pids = CF_EXPECT(CollectPids(uid));
-  std::vector<pid_t> output_pids;
-  for (const auto pid : input_pids) {
-    auto owner_uids_result = OwnerUids(pid);
-    if (!owner_uids_result.ok() || owner_uids_result->real_ != uid) {
-      VLOG(1) << "Process #" << pid << " does not belong to " << uid;
-      continue;
-    }
-    if (CheckExecNameFromStatus(exec_name, pid).ok()) {
-      output_pids.push_back(pid);
-    }
-  }
-  return output_pids;
+  return CF_EXPECT(ProcessTable::Scan()).PidsByExecName(exec_name, uid);
 }
 
 Result<std::vector<pid_t>> CollectPidsByExecPath(const std::string& exec_path,
@@ -271,22 +240,62 @@ Result<ProcInfo> ExtractProcInfo(const pid_t pid) {
 }
 
 Result<pid_t> Ppid(const pid_t pid) {
-  // parse from /proc/<pid>/status
-  std::regex uid_pattern(R"(PPid:\s*([0-9]+))");
-  std::string status_path = fmt::format("/proc/{}/status", pid);
-  std::string status_content = CF_EXPECT(ReadFileContents(status_path));
-  for (std::string_view line :
-       absl::StrSplit(status_content, '\n', absl::SkipEmpty())) {
-    std::smatch matches;
-    std::string line_str(line);
-    if (!std::regex_match(line_str, matches, uid_pattern)) {
+  return CF_EXPECT(ReadProcStatus(pid)).ppid;
+}
+
+Result<ProcessTable> ProcessTable::Scan() {
+  CF_EXPECT(DirectoryExists(kProcDir));
+  ProcessTable table;
+  for (const auto& subdir : CF_EXPECT(DirectoryContents(kProcDir))) {
+    pid_t pid;
+    if (!absl::SimpleAtoi(subdir, &pid)) {
       continue;
     }
-    unsigned ppid;
-    CF_EXPECT(absl::SimpleAtoi(matches[1].str(), &ppid));
-    return static_cast<pid_t>(ppid);
+    // The process may have exited since the directory was listed.
+    Result<ProcStatus> status = ReadProcStatus(pid);
+    if (!status.ok()) {
+      continue;
+    }
+    table.processes_[pid] = Process{
+        .name = std::move(status->name),
+        .ppid = status->ppid,
+        .real_owner = status->uids.real_,
+    };
+  }
+  return table;
+}
+
+std::vector<pid_t> ProcessTable::Pids(const uid_t uid) const {
+  std::vector<pid_t> pids;
+  for (const auto& [pid, process] : processes_) {
+    if (process.real_owner == uid) {
+      pids.push_back(pid);
+    }
+  }
+  return pids;
+}
+
+std::vector<pid_t> ProcessTable::PidsByExecName(const std::string& exec_name,
+                                                const uid_t uid) const {
+  std::vector<pid_t> pids;
+  for (const auto& [pid, process] : processes_) {
+    if (process.real_owner == uid && process.name == exec_name) {
+      pids.push_back(pid);
+    }
   }
-  return CF_ERR("Status file does not have PPid: line in the right format");
+  return pids;
+}
+
+Result<uid_t> ProcessTable::OwnerUid(const pid_t pid) const {
+  auto it = processes_.find(pid);
+  CF_EXPECTF(it != processes_.end(), "Process {} is not in the table", pid);
+  return it->second.real_owner;
+}
+
+Result<pid_t> ProcessTable::Ppid(const pid_t pid) const {
+  auto it = processes_.find(pid);
+  CF_EXPECTF(it != processes_.end(), "Process {} is not in the table", pid);
+  return it->second.ppid;
 }
 
 }  // namespace cuttlefish
@@ -19,6 +19,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -86,4 +87,35 @@ Result<std::unordered_map<std::string, std::string>> GetEnvs(pid_t pid);
 
 Result<pid_t> Ppid(pid_t pid);
 
+/**
+ * A snapshot of the processes in /proc, taken by reading every
+ * /proc/<pid>/status file once.
+ *
+ * Commands that look at many processes, e.g. to find all run_cvd processes and
+ * their parents, should scan once and query the table instead of calling the
+ * functions above, each of which rescans /proc or rereads the status files.
+ */
+class ProcessTable {
+ public:
+  static Result<ProcessTable> Scan();
+
+  // Same as the free functions, but restricted to the snapshot.
+  std::vector<pid_t> Pids(uid_t uid = getuid()) const;
+  std::vector<pid_t> PidsByExecName(const std::string& exec_name,
+                                    uid_t uid = getuid()) const;
+  Result<uid_t> OwnerUid(pid_t pid) const;
+  Result<pid_t> Ppid(pid_t pid) const;
+
+ private:
+  struct Process {
+    // As in the "Name:" line of /proc/<pid>/status, which is truncated to 15
+    // characters.
+    std::string name;
+    pid_t ppid;
+    uid_t real_owner;
+  };
+
+  std::map<pid_t, Process> processes_;
+};
+
 }  // namespace cuttlefish
@@ -40,4 +40,17 @@ TEST(ProcFilePid, CurrentPidCollected) {
   ASSERT_TRUE(Contains(*pids_result, this_pid));
 }
 
+TEST(ProcessTable, CurrentProcessScanned) {
+  auto table = ProcessTable::Scan();
+  ASSERT_TRUE(table.ok()) << table.error().Trace();
+
+  ASSERT_TRUE(Contains(table->Pids(), getpid()));
+  auto ppid = table->Ppid(getpid());
+  ASSERT_TRUE(ppid.ok()) << ppid.error().Trace();
+  ASSERT_EQ(*ppid, getppid());
+  auto owner = table->OwnerUid(getpid());
+  ASSERT_TRUE(owner.ok()) << owner.error().Trace();
+  ASSERT_EQ(*owner, getuid());
+}
+
 }  // namespace cuttlefish
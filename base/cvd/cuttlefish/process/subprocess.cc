@@ -19,17 +19,23 @@
 #include <errno.h>
 #include <signal.h>
 #include <string.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
 #include <functional>
+#include <utility>
 
 #include "absl/log/log.h"
 
 #include "cuttlefish/result/expect.h"
 #include "cuttlefish/result/result_type.h"
 
+#if defined(__linux__) && !defined(SYS_pidfd_send_signal)
+#define SYS_pidfd_send_signal 424
+#endif
+
 extern char** environ;
 
 namespace cuttlefish {
@@ -37,7 +43,8 @@ namespace cuttlefish {
 Subprocess::Subprocess(Subprocess&& subprocess)
     : pid_(subprocess.pid_.load()),
       started_(subprocess.started_),
-      stopper_(subprocess.stopper_) {
+      stopper_(subprocess.stopper_),
+      pidfd_(std::move(subprocess.pidfd_)) {
   // Make sure the moved object no longer controls this subprocess
   subprocess.pid_ = -1;
   subprocess.started_ = false;
@@ -47,6 +54,7 @@ Subprocess& Subprocess::operator=(Subprocess&& other) {
   pid_ = other.pid_.load();
   started_ = other.started_;
   stopper_ = other.stopper_;
+  pidfd_ = std::move(other.pidfd_);
 
   other.pid_ = -1;
   other.started_ = false;
@@ -71,12 +79,14 @@ int Subprocess::Wait() {
   int retval = 0;
   if (WIFEXITED(wstatus)) {
     pid_ = -1;
+    pidfd_.reset();
     retval = WEXITSTATUS(wstatus);
     if (retval) {
       VLOG(0) << "Subprocess " << pid << " exited with error code: " << retval;
     }
   } else if (WIFSIGNALED(wstatus)) {
     pid_ = -1;
+    pidfd_.reset();
     int sig_num = WTERMSIG(wstatus);
     LOG(ERROR) << "Subprocess " << pid << " was interrupted by a signal '"
                << strsignal(sig_num) << "' (" << sig_num << ")";
@@ -100,12 +110,14 @@ int Subprocess::Wait(siginfo_t* infop, int options) {
   bool reaped = !(options & WNOWAIT);
   if (exited && reaped) {
     pid_ = -1;
+    pidfd_.reset();
   }
   return retval;
 }
 
 static Result<void> SendSignalImpl(const int signal, const pid_t pid,
-                                   bool to_group, const bool started) {
+                                   const int pidfd, bool to_group,
+                                   const bool started) {
   if (pid == -1) {
     return CF_ERR(strerror(ESRCH));
   }
@@ -116,6 +128,11 @@ static Result<void> SendSignalImpl(const int signal, const pid_t pid,
   int ret_code = 0;
   if (to_group) {
     ret_code = killpg(getpgid(pid), signal);
+#ifdef __linux__
+  } else if (pidfd >= 0) {
+    // Can't hit a different process that reused the pid.
+    ret_code = syscall(SYS_pidfd_send_signal, pidfd, signal, nullptr, 0);
+#endif
   } else {
     ret_code = kill(pid, signal);
   }
@@ -125,12 +142,14 @@ static Result<void> SendSignalImpl(const int signal, const pid_t pid,
 }
 
 Result<void> Subprocess::SendSignal(const int signal) {
-  CF_EXPECT(SendSignalImpl(signal, pid_, /* to_group */ false, started_));
+  CF_EXPECT(SendSignalImpl(signal, pid_, pidfd_.get(), /* to_group */ false,
+                           started_));
   return {};
 }
 
 Result<void> Subprocess::SendSignalToGroup(const int signal) {
-  CF_EXPECT(SendSignalImpl(signal, pid_, /* to_group */ true, started_));
+  CF_EXPECT(SendSignalImpl(signal, pid_, pidfd_.get(), /* to_group */ true,
+                           started_));
   return {};
 }
 
@@ -20,6 +20,9 @@
 
 #include <atomic>
 #include <functional>
+#include <utility>
+
+#include "android-base/unique_fd.h"
 
 #include "cuttlefish/result/result_type.h"
 
@@ -44,8 +47,12 @@ SubprocessStopper KillSubprocessFallback(SubprocessStopper nice_stopper);
 // It's an error to wait twice for the same subprocess.
 class Subprocess {
  public:
-  Subprocess(pid_t pid, SubprocessStopper stopper = KillSubprocess)
-      : pid_(pid), started_(pid > 0), stopper_(stopper) {}
+  Subprocess(pid_t pid, SubprocessStopper stopper = KillSubprocess,
+             android::base::unique_fd pidfd = {})
+      : pid_(pid),
+        started_(pid > 0),
+        stopper_(stopper),
+        pidfd_(std::move(pidfd)) {}
   // The default implementation won't do because we need to reset the pid of the
   // moved object.
   Subprocess(Subprocess&&);
@@ -61,6 +68,9 @@ class Subprocess {
   // completion of the command, that's what Wait is for.
   bool Started() const { return started_; }
   pid_t pid() const { return pid_; }
+  // A pidfd referring to the subprocess, or -1 if it has been waited for or
+  // the kernel doesn't support pidfds.
+  int pidfd() const { return pidfd_.get(); }
   StopperResult Stop() { return stopper_(this); }
 
   Result<void> SendSignal(int signal);
@@ -75,6 +85,7 @@ class Subprocess {
   std::atomic<pid_t> pid_ = -1;
   bool started_ = false;
   SubprocessStopper stopper_;
+  android::base::unique_fd pidfd_;
 };
 
 }  // namespace cuttlefish
@@ -59,4 +59,22 @@ SubprocessOptions SubprocessOptions::Strace(std::string s) && {
   return std::move(*this);
 }
 
+SubprocessOptions& SubprocessOptions::UseFork(bool use_fork) & {
+  use_fork_ = use_fork;
+  return *this;
+}
+SubprocessOptions SubprocessOptions::UseFork(bool use_fork) && {
+  use_fork_ = use_fork;
+  return std::move(*this);
+}
+
+SubprocessOptions& SubprocessOptions::Cgroup(std::string cgroup) & {
+  cgroup_ = std::move(cgroup);
+  return *this;
+}
+SubprocessOptions SubprocessOptions::Cgroup(std::string cgroup) && {
+  cgroup_ = std::move(cgroup);
+  return std::move(*this);
+}
+
 }  // namespace cuttlefish
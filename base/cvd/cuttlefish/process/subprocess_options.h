@@ -22,7 +22,10 @@ namespace cuttlefish {
 class SubprocessOptions {
  public:
   SubprocessOptions()
-      : verbose_(true), exit_with_parent_(true), in_group_(false) {}
+      : verbose_(true),
+        exit_with_parent_(true),
+        in_group_(false),
+        use_fork_(false) {}
   SubprocessOptions& Verbose(bool verbose) &;
   SubprocessOptions Verbose(bool verbose) &&;
 #ifdef __linux__
@@ -36,16 +39,30 @@ class SubprocessOptions {
   SubprocessOptions& Strace(std::string strace_output_path) &;
   SubprocessOptions Strace(std::string strace_output_path) &&;
 
+  // Starts the subprocess with a plain fork(2) rather than a clone(2) that
+  // shares the parent's address space until exec. Slower in large processes.
+  SubprocessOptions& UseFork(bool use_fork) &;
+  SubprocessOptions UseFork(bool use_fork) &&;
+
+  // Moves the subprocess into the cgroup v2 directory `cgroup` before it
+  // executes anything, so all of its descendants are accounted there too.
+  SubprocessOptions& Cgroup(std::string cgroup) &;
+  SubprocessOptions Cgroup(std::string cgroup) &&;
+
   bool Verbose() const { return verbose_; }
   bool ExitWithParent() const { return exit_with_parent_; }
   bool InGroup() const { return in_group_; }
   const std::string& Strace() const { return strace_; }
+  bool UseFork() const { return use_fork_; }
+  const std::string& Cgroup() const { return cgroup_; }
 
  private:
   bool verbose_;
   bool exit_with_parent_;
   bool in_group_;
   std::string strace_;
+  bool use_fork_;
+  std::string cgroup_;
 };
 
 }  // namespace cuttlefish
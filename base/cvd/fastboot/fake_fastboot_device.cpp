@@ -0,0 +1,134 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "fake_fastboot_device.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+#include <android-base/parseint.h>
+#include <android-base/stringprintf.h>
+#include <android-base/strings.h>
+
+using android::base::StringPrintf;
+
+namespace fastboot {
+namespace {
+
+// The TCP transport frames every message with its big-endian 8-byte length.
+bool ReadMessage(int fd, std::string* message) {
+    uint8_t header[8];
+    if (!android::base::ReadFully(fd, header, sizeof(header))) {
+        return false;
+    }
+    uint64_t length = 0;
+    for (uint8_t byte : header) {
+        length = (length << 8) | byte;
+    }
+    message->resize(length);
+    return android::base::ReadFully(fd, message->data(), length);
+}
+
+bool WriteMessage(int fd, const std::string& message) {
+    uint8_t header[8];
+    for (int i = 0; i < 8; ++i) {
+        header[i] = static_cast<uint64_t>(message.size()) >> (56 - i * 8);
+    }
+    return android::base::WriteFully(fd, header, sizeof(header)) &&
+           android::base::WriteFully(fd, message.data(), message.size());
+}
+
+}  // namespace
+
+bool FakeDevice::Handshake() {
+    char buffer[4];
+    if (!android::base::ReadFully(fd_, buffer, sizeof(buffer)) || memcmp(buffer, "FB", 2) != 0) {
+        LOG(ERROR) << "Bad handshake";
+        return false;
+    }
+    return android::base::WriteFully(fd_, "FB01", 4);
+}
+
+void FakeDevice::Serve() {
+    std::string message;
+    while (ReadMessage(fd_, &message)) {
+        if (download_left_ > 0) {
+            ReceiveData(message.size());
+            continue;
+        }
+        if (!HandleCommand(message)) {
+            return;
+        }
+    }
+}
+
+void FakeDevice::ReceiveData(size_t size) {
+    if (size > download_left_) {
+        LOG(ERROR) << "Received " << size - download_left_ << " bytes past the download";
+        size = download_left_;
+    }
+    download_left_ -= size;
+    if (download_left_ == 0) {
+        auto elapsed = std::chrono::steady_clock::now() - download_start_;
+        LOG(INFO) << "Downloaded " << downloaded_ / 1024 << " KB in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+                  << " ms";
+        log_.push_back(StringPrintf("<data %" PRIu64 ">", downloaded_));
+        WriteMessage(fd_, "OKAY");
+    }
+}
+
+bool FakeDevice::HandleCommand(const std::string& command) {
+    LOG(VERBOSE) << "Command: " << command;
+    log_.push_back(command);
+    if (command == "getvar:max-download-size") {
+        return WriteMessage(fd_, StringPrintf("OKAY0x%08x", options_.max_download_size));
+    }
+    if (android::base::StartsWith(command, "getvar:")) {
+        return WriteMessage(fd_, "FAILunknown variable");
+    }
+    if (android::base::StartsWith(command, "download:")) {
+        uint32_t size = 0;
+        if (!android::base::ParseUint("0x" + command.substr(strlen("download:")), &size) ||
+            size == 0 || size > options_.max_download_size) {
+            return WriteMessage(fd_, "FAILinvalid download size");
+        }
+        download_left_ = size;
+        downloaded_ = size;
+        download_start_ = std::chrono::steady_clock::now();
+        return WriteMessage(fd_, StringPrintf("DATA%08x", size));
+    }
+    if (android::base::StartsWith(command, "flash:")) {
+        if (options_.flash_mbps > 0) {
+            std::this_thread::sleep_for(
+                    std::chrono::microseconds(downloaded_ / options_.flash_mbps));
+        }
+        LOG(INFO) << "Flashed " << downloaded_ / 1024 << " KB to "
+                  << command.substr(strlen("flash:"));
+        return WriteMessage(fd_, "OKAY");
+    }
+    // Everything else, including reboots, trivially succeeds.
+    return WriteMessage(fd_, "OKAY");
+}
+
+}  // namespace fastboot
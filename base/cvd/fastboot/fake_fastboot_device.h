@@ -0,0 +1,58 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fastboot {
+
+// A fastboot device over TCP that throws away everything it is sent, for benchmarking and testing
+// the host side of flashing. Flashing is simulated by sleeping for as long as writing the last
+// download would take at |flash_mbps|.
+class FakeDevice {
+  public:
+    struct Options {
+        uint32_t max_download_size = 256 * 1024 * 1024;
+        uint64_t flash_mbps = 0;  // 0 flashes instantly
+    };
+
+    FakeDevice(const Options& options, int fd) : options_(options), fd_(fd) {}
+
+    // Answers the host's handshake, returns false if it is not a fastboot host.
+    bool Handshake();
+    // Handles commands until the host disconnects.
+    void Serve();
+
+    // Every command received so far, with each completed download recorded as "<data N>".
+    const std::vector<std::string>& log() const { return log_; }
+
+  private:
+    void ReceiveData(size_t size);
+    bool HandleCommand(const std::string& command);
+
+    const Options options_;
+    int fd_;
+    uint64_t download_left_ = 0;
+    uint64_t downloaded_ = 0;
+    std::chrono::steady_clock::time_point download_start_;
+    std::vector<std::string> log_;
+};
+
+}  // namespace fastboot
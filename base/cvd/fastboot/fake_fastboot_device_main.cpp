@@ -0,0 +1,104 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Serves a fake fastboot device on a local port, for benchmarking the host side of flashing.
+// See fake_fastboot_device.h. Usage:
+//
+//   fake_fastboot_device --port 5554 --flash-mbps 200 &
+//   fastboot -s tcp:localhost:5554 flash super super.img
+
+#include <getopt.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <android-base/logging.h>
+#include <android-base/parseint.h>
+#include <android-base/unique_fd.h>
+
+#include "fake_fastboot_device.h"
+
+using android::base::unique_fd;
+using fastboot::FakeDevice;
+
+namespace {
+
+bool ParseOptions(int argc, char* argv[], int* port, FakeDevice::Options* options) {
+    const struct option longopts[] = {{"port", required_argument, 0, 'p'},
+                                      {"max-download-size", required_argument, 0, 'm'},
+                                      {"flash-mbps", required_argument, 0, 'f'},
+                                      {0, 0, 0, 0}};
+    int c;
+    while ((c = getopt_long(argc, argv, "", longopts, nullptr)) != -1) {
+        switch (c) {
+            case 'p':
+                if (!android::base::ParseInt(optarg, port, 1, 65535)) return false;
+                break;
+            case 'm':
+                if (!android::base::ParseByteCount(optarg, &options->max_download_size)) {
+                    return false;
+                }
+                break;
+            case 'f':
+                if (!android::base::ParseUint(optarg, &options->flash_mbps)) return false;
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    android::base::InitLogging(argv, android::base::StderrLogger);
+
+    int port = 5554;
+    FakeDevice::Options options;
+    if (!ParseOptions(argc, argv, &port, &options)) {
+        fprintf(stderr,
+                "usage: %s [--port PORT] [--max-download-size SIZE[K|M|G]] [--flash-mbps MBPS]\n",
+                argv[0]);
+        return 1;
+    }
+
+    unique_fd server(socket(AF_INET, SOCK_STREAM, 0));
+    int reuse = 1;
+    setsockopt(server.get(), SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(server.get(), reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(server.get(), 1) < 0) {
+        PLOG(FATAL) << "Failed to listen on port " << port;
+    }
+    LOG(INFO) << "Listening on localhost:" << port;
+
+    while (true) {
+        unique_fd client(TEMP_FAILURE_RETRY(accept(server.get(), nullptr, nullptr)));
+        if (client.get() < 0) {
+            PLOG(ERROR) << "accept failed";
+            continue;
+        }
+        FakeDevice device(options, client.get());
+        if (device.Handshake()) {
+            device.Serve();
+        }
+    }
+}
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <iostream>
@@ -101,6 +102,9 @@ static bool g_long_listing = false;
 // let's keep it at 1GB to avoid memory pressure on the host.
 static constexpr int64_t RESPARSE_LIMIT = 1 * 1024 * 1024 * 1024;
 static int64_t target_sparse_limit = -1;
+// Memory allowed for sparse files serialized ahead of the one being sent.
+static constexpr int64_t SPARSE_PIPELINE_BUFFER_LIMIT = 512 * 1024 * 1024;
+static bool g_sparse_pipeline = true;
 
 static unsigned g_base_addr = 0x10000000;
 static boot_img_hdr_v2 g_boot_img_hdr = {};
@@ -638,6 +642,8 @@ static int show_help() {
             " --disable-verification     Sets disable-verification when flashing vbmeta.\n"
             " --disable-super-optimization\n"
             "                            Disables optimizations on flashing super partition.\n"
+            " --disable-sparse-pipeline  Don't prepare the next sparse chunk while the\n"
+            "                            current one is sent and flashed.\n"
             " --exclude-dynamic-partitions\n"
             "                            Excludes flashing of dynamic partitions.\n"
             " --disable-fastboot-info    Will collects tasks from image list rather than \n"
@@ -1298,6 +1304,19 @@ static void copy_avb_footer(const ImageSource* source, const std::string& partit
 }
 
 void flash_partition_files(const std::string& partition, const std::vector<SparsePtr>& files) {
+    // Pipelining only pays off if a file can be serialized while the previous one is sent.
+    std::vector<sparse_file*> pipelined_files;
+    int64_t largest_file = 0;
+    for (const auto& file : files) {
+        pipelined_files.push_back(file.get());
+        largest_file = std::max(largest_file, sparse_file_len(file.get(), true, false));
+    }
+    if (g_sparse_pipeline && files.size() > 1 &&
+        largest_file * 2 <= SPARSE_PIPELINE_BUFFER_LIMIT) {
+        fb->FlashPartitionPipelined(partition, pipelined_files, SPARSE_PIPELINE_BUFFER_LIMIT);
+        return;
+    }
+
     for (size_t i = 0; i < files.size(); i++) {
         sparse_file* s = files[i].get();
         int64_t sz = sparse_file_len(s, true, false);
@@ -2291,6 +2310,7 @@ int FastBootTool::Main(int argc, char* argv[]) {
                                       {"disable-verification", no_argument, 0, 0},
                                       {"disable-verity", no_argument, 0, 0},
                                       {"disable-super-optimization", no_argument, 0, 0},
+                                      {"disable-sparse-pipeline", no_argument, 0, 0},
                                       {"exclude-dynamic-partitions", no_argument, 0, 0},
                                       {"disable-fastboot-info", no_argument, 0, 0},
                                       {"force", no_argument, 0, 0},
@@ -2333,6 +2353,8 @@ int FastBootTool::Main(int argc, char* argv[]) {
                 g_disable_verity = true;
             } else if (name == "disable-super-optimization") {
                 fp->should_optimize_flash_super = false;
+            } else if (name == "disable-sparse-pipeline") {
+                g_sparse_pipeline = false;
             } else if (name == "exclude-dynamic-partitions") {
                 fp->exclude_dynamic_partitions = true;
                 fp->should_optimize_flash_super = false;
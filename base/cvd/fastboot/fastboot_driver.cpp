@@ -36,9 +36,13 @@
 #include <string.h>
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <regex>
+#include <thread>
 #include <vector>
 
 #include <android-base/file.h>
@@ -164,6 +168,123 @@ RetCode FastBootDriver::FlashPartition(const std::string& partition, sparse_file
     return Flash(partition);
 }
 
+RetCode FastBootDriver::FlashPartitionPipelined(const std::string& partition,
+                                                const std::vector<sparse_file*>& files,
+                                                size_t max_buffered_bytes) {
+    struct SerializedFile {
+        std::vector<char> data;
+        size_t reserved = 0;
+        // Set along with |error| if |data| could not be produced.
+        RetCode status = SUCCESS;
+        std::string error;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<SerializedFile> ready;
+    // Bytes of every file that is being serialized, waiting or being sent.
+    size_t buffered_bytes = 0;
+    bool cancelled = false;
+
+    std::thread serializer([&]() {
+        for (sparse_file* s : files) {
+            int64_t len = sparse_file_len(s, true, false);
+            SerializedFile file;
+            if (len <= 0) {
+                file.status = IO_ERROR;
+                file.error = "Error reading sparse file";
+            } else if (len > MAX_DOWNLOAD_SIZE && !disable_checks_) {
+                file.status = BAD_ARG;
+                file.error = StringPrintf("Sparse file is %" PRId64
+                                          " bytes, more than the %" PRIu32 " byte download limit",
+                                          len, MAX_DOWNLOAD_SIZE);
+            } else {
+                file.reserved = len;
+            }
+            {
+                // A file that doesn't fit on its own is still let through once nothing else is
+                // buffered, otherwise it could never be sent.
+                std::unique_lock lock(mutex);
+                cv.wait(lock, [&]() {
+                    return cancelled || buffered_bytes == 0 ||
+                           buffered_bytes + file.reserved <= max_buffered_bytes;
+                });
+                if (cancelled) return;
+                buffered_bytes += file.reserved;
+            }
+            if (file.error.empty()) {
+                file.data.reserve(len);
+                auto append = [](void* priv, const void* buf, size_t size) -> int {
+                    auto out = static_cast<std::vector<char>*>(priv);
+                    const char* cbuf = static_cast<const char*>(buf);
+                    out->insert(out->end(), cbuf, cbuf + size);
+                    return 0;
+                };
+                if (sparse_file_callback(s, true, false, append, &file.data) < 0) {
+                    file.status = IO_ERROR;
+                    file.error = "Error reading sparse file";
+                }
+            }
+            bool ok = file.error.empty();
+            {
+                std::lock_guard lock(mutex);
+                ready.emplace_back(std::move(file));
+            }
+            cv.notify_all();
+            if (!ok) return;
+        }
+    });
+
+    // The epilog of a failed step is only reported once the serializer is stopped, as it may
+    // exit the process.
+    RetCode ret = SUCCESS;
+    for (size_t i = 0; i < files.size(); i++) {
+        SerializedFile file;
+        {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [&]() { return !ready.empty(); });
+            file = std::move(ready.front());
+            ready.pop_front();
+        }
+        prolog_(StringPrintf("Sending sparse '%s' %zu/%zu (%zu KB)", partition.c_str(), i + 1,
+                             files.size(), file.reserved / 1024));
+        if (file.error.empty()) {
+            ret = Download(file.data);
+        } else {
+            error_ = file.error;
+            ret = file.status;
+        }
+        if (ret) {
+            break;
+        }
+        epilog_(ret);
+        // The device may take a while to flash, let the next files be serialized meanwhile.
+        file.data = std::vector<char>();
+        {
+            std::lock_guard lock(mutex);
+            buffered_bytes -= file.reserved;
+        }
+        cv.notify_all();
+
+        prolog_("Writing '" + partition + "'");
+        if ((ret = RawCommand(FB_CMD_FLASH ":" + partition, nullptr, nullptr))) {
+            break;
+        }
+        epilog_(ret);
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        cancelled = true;
+    }
+    cv.notify_all();
+    serializer.join();
+    if (ret) {
+        epilog_(ret);
+    }
+    return ret;
+}
+
 RetCode FastBootDriver::Partitions(std::vector<std::tuple<std::string, uint64_t>>* partitions) {
     std::vector<std::string> all;
     RetCode ret;
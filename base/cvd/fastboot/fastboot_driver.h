@@ -111,6 +111,12 @@ class FastBootDriver : public IFastBootDriver {
                            uint32_t sz) override;
     RetCode FlashPartition(const std::string& partition, sparse_file* s, uint32_t sz,
                            size_t current, size_t total);
+    // Same as calling the sparse FlashPartition() on each of |files| in order, but the next
+    // file is serialized on a worker thread while the current one is sent and flashed. At most
+    // |max_buffered_bytes| of serialized data are held at once.
+    RetCode FlashPartitionPipelined(const std::string& partition,
+                                    const std::vector<sparse_file*>& files,
+                                    size_t max_buffered_bytes);
 
     RetCode Partitions(std::vector<std::tuple<std::string, uint64_t>>* partitions);
     RetCode Require(const std::string& var, const std::vector<std::string>& allowed, bool* reqmet,
@@ -0,0 +1,176 @@
+//
+// Copyright (C) 2026 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "fastboot_driver.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <android-base/file.h>
+#include <android-base/stringprintf.h>
+#include <android-base/unique_fd.h>
+#include <sparse/sparse.h>
+
+#include "fake_fastboot_device.h"
+#include "tcp.h"
+
+using android::base::StringPrintf;
+using android::base::unique_fd;
+using testing::ElementsAre;
+using testing::ElementsAreArray;
+using testing::HasSubstr;
+
+namespace fastboot {
+namespace {
+
+constexpr unsigned int kBlockSize = 4096;
+
+struct SparseFileDeleter {
+    void operator()(sparse_file* s) const { sparse_file_destroy(s); }
+};
+using SparseFilePtr = std::unique_ptr<sparse_file, SparseFileDeleter>;
+
+// Runs a FakeDevice on a loopback port and connects a driver to it.
+class FastBootDriverTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        server_.reset(socket(AF_INET, SOCK_STREAM, 0));
+        ASSERT_GE(server_.get(), 0);
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addr_len = sizeof(addr);
+        ASSERT_EQ(bind(server_.get(), reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        ASSERT_EQ(listen(server_.get(), 1), 0);
+        ASSERT_EQ(getsockname(server_.get(), reinterpret_cast<sockaddr*>(&addr), &addr_len), 0);
+
+        device_thread_ = std::thread([this]() {
+            unique_fd client(TEMP_FAILURE_RETRY(accept(server_.get(), nullptr, nullptr)));
+            if (client.get() < 0) {
+                return;
+            }
+            FakeDevice device(FakeDevice::Options(), client.get());
+            if (device.Handshake()) {
+                device.Serve();
+            }
+            log_ = device.log();
+        });
+
+        std::string error;
+        std::unique_ptr<Transport> transport =
+                tcp::Connect("127.0.0.1", ntohs(addr.sin_port), &error);
+        ASSERT_NE(transport, nullptr) << error;
+        DriverCallbacks callbacks;
+        callbacks.epilog = [this](int status) { epilogs_.push_back(status); };
+        driver_ = std::make_unique<FastBootDriver>(std::move(transport), std::move(callbacks));
+    }
+
+    void TearDown() override {
+        driver_.reset();
+        // Unblocks the accept() if the driver never connected.
+        shutdown(server_.get(), SHUT_RDWR);
+        if (device_thread_.joinable()) {
+            device_thread_.join();
+        }
+    }
+
+    // Disconnects the driver and returns everything the device received.
+    std::vector<std::string> DeviceLog() {
+        TearDown();
+        return log_;
+    }
+
+    static SparseFilePtr DataFile(const std::string& data) {
+        SparseFilePtr s(sparse_file_new(kBlockSize, data.size()));
+        EXPECT_EQ(sparse_file_add_data(s.get(), const_cast<char*>(data.data()), data.size(), 0),
+                  0);
+        return s;
+    }
+
+    std::unique_ptr<FastBootDriver> driver_;
+    std::vector<int> epilogs_;
+
+  private:
+    unique_fd server_;
+    std::thread device_thread_;
+    std::vector<std::string> log_;
+};
+
+TEST_F(FastBootDriverTest, PipelinedFlashKeepsTheOrderOfTheFiles) {
+    std::vector<std::string> contents;
+    std::vector<SparseFilePtr> files;
+    std::vector<sparse_file*> pointers;
+    std::vector<std::string> expected;
+    for (size_t i = 1; i <= 4; i++) {
+        contents.emplace_back(i * kBlockSize, 'a' + i);
+    }
+    for (const std::string& data : contents) {
+        files.push_back(DataFile(data));
+        pointers.push_back(files.back().get());
+        int64_t len = sparse_file_len(files.back().get(), true, false);
+        ASSERT_GT(len, 0);
+        expected.push_back(StringPrintf("download:%08" PRIx64, len));
+        expected.push_back(StringPrintf("<data %" PRId64 ">", len));
+        expected.push_back("flash:system");
+    }
+
+    // Only holds two of the files at once.
+    size_t max_buffered_bytes = sparse_file_len(pointers[3], true, false) * 2;
+    EXPECT_EQ(driver_->FlashPartitionPipelined("system", pointers, max_buffered_bytes), SUCCESS)
+            << driver_->Error();
+
+    // A download and a flash per file.
+    EXPECT_THAT(epilogs_, ElementsAreArray(std::vector<int>(8, SUCCESS)));
+    EXPECT_THAT(DeviceLog(), ElementsAreArray(expected));
+}
+
+TEST_F(FastBootDriverTest, PipelinedFlashRejectsFilesTooLargeToDownload) {
+    // Two data chunks backed by the same sparse file add up to more than a download can hold,
+    // without the test writing that much.
+    TemporaryFile backing;
+    constexpr int64_t kChunkSize = 5LL << 29;  // 2.5 GiB
+    ASSERT_EQ(ftruncate(backing.fd, kChunkSize), 0);
+    SparseFilePtr large(sparse_file_new(kBlockSize, 2 * kChunkSize));
+    ASSERT_EQ(sparse_file_add_fd(large.get(), backing.fd, 0, kChunkSize, 0), 0);
+    ASSERT_EQ(sparse_file_add_fd(large.get(), backing.fd, 0, kChunkSize, kChunkSize / kBlockSize),
+              0);
+    std::string small_data(kBlockSize, 's');
+    SparseFilePtr small = DataFile(small_data);
+
+    EXPECT_EQ(driver_->FlashPartitionPipelined("system", {small.get(), large.get()}, 1 << 20),
+              BAD_ARG);
+    EXPECT_THAT(driver_->Error(), HasSubstr("byte download limit"));
+
+    // The file before the large one is flashed, the large one is never sent.
+    EXPECT_THAT(epilogs_, ElementsAre(SUCCESS, SUCCESS, BAD_ARG));
+    int64_t small_len = sparse_file_len(small.get(), true, false);
+    EXPECT_THAT(DeviceLog(), ElementsAre(StringPrintf("download:%08" PRIx64, small_len),
+                                         StringPrintf("<data %" PRId64 ">", small_len),
+                                         "flash:system"));
+}
+
+}  // namespace
+}  // namespace fastboot